@@ -0,0 +1,82 @@
+#pragma once
+
+// Minimal microbenchmark harness shared by the bench/ executables.
+//
+// run() calls a function in chunks until min_time has passed and reports
+// ns/op, ops/s and heap allocations per op. Allocations are counted by
+// the global operator new replacement in bench_alloc.cpp, linked into
+// every bench target.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace bench {
+
+// Heap allocations made so far by this process (bench_alloc.cpp)
+std::uint64_t allocation_count() noexcept;
+
+// Keep a value (and the work producing it) from being optimized away
+template <typename T>
+inline void do_not_optimize(const T& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    const char* name = "";
+    std::uint64_t ops = 0;
+    double ns_per_op = 0;
+    double ops_per_sec = 0;
+    double allocs_per_op = 0;
+};
+
+inline void print_header() {
+#ifndef NDEBUG
+    std::printf("warning: assertions enabled; configure with -DCMAKE_BUILD_TYPE=Release "
+                "for meaningful numbers\n");
+#endif
+    std::printf("%-44s %12s %14s %12s\n", "benchmark", "ns/op", "ops/s", "allocs/op");
+}
+
+inline void print(const Result& r) {
+    std::printf("%-44s %12.1f %14.0f %12.3f\n", r.name, r.ns_per_op, r.ops_per_sec, r.allocs_per_op);
+}
+
+// Time `op` (one operation per call). `op` may capture state; a warm-up
+// chunk runs first so caches, branch predictors and lazy setup settle.
+template <typename Op>
+Result run(const char* name, Op&& op,
+           std::chrono::milliseconds min_time = std::chrono::milliseconds(300)) {
+    constexpr std::uint64_t kChunk = 1024;
+    for (std::uint64_t i = 0; i < kChunk; ++i) {
+        op();
+    }
+
+    using clock = std::chrono::steady_clock;
+    const std::uint64_t allocs_before = allocation_count();
+    const auto start = clock::now();
+    auto now = start;
+    std::uint64_t ops = 0;
+    do {
+        for (std::uint64_t i = 0; i < kChunk; ++i) {
+            op();
+        }
+        ops += kChunk;
+        now = clock::now();
+    } while (now - start < min_time);
+    const std::uint64_t allocs = allocation_count() - allocs_before;
+
+    Result r;
+    r.name = name;
+    r.ops = ops;
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+    r.ns_per_op = ns / static_cast<double>(ops);
+    r.ops_per_sec = static_cast<double>(ops) * 1e9 / ns;
+    r.allocs_per_op = static_cast<double>(allocs) / static_cast<double>(ops);
+    print(r);
+    return r;
+}
+
+}  // namespace bench
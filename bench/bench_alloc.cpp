@@ -0,0 +1,39 @@
+// Counting replacement for the global allocation functions, so benches can
+// report heap allocations per operation. The array and nothrow forms
+// forward to these in libstdc++ and libc++; over-aligned allocations
+// (alignas > 16, e.g. PipelineStats) are not counted.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+namespace bench {
+
+std::uint64_t allocation_count() noexcept {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+}  // namespace bench
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,350 @@
+// Per-stage microbenchmarks: TB-1.5 through TB-5 on a synthetic corpus.
+//
+// Usage:
+//   ./bench_stages [filter]
+//
+// Runs every benchmark whose name contains `filter` (all by default) and
+// prints ns/op, ops/s and heap allocations per op. Build with
+// -DCMAKE_BUILD_TYPE=Release.
+
+#include "bench.hpp"
+#include "corpus.hpp"
+#include "gateway/agent_limiter.hpp"
+#include "gateway/aggregate.hpp"
+#include "gateway/columnar.hpp"
+
+#include "gateway/bounded_queue.hpp"
+#include "gateway/classify.hpp"
+#include "gateway/drr_queue.hpp"
+#include "gateway/forwarder.hpp"
+#include "gateway/parse_envelope.hpp"
+#include "gateway/parse_log.hpp"
+#include "gateway/parse_metrics.hpp"
+#include "gateway/serialize.hpp"
+#include "gateway/sink.hpp"
+#include "gateway/source_limiter.hpp"
+#include "gateway/validate_log.hpp"
+#include "gateway/validate_metrics.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kCorpusSize = 256;  // power of two: index with a mask
+
+std::uint64_t wall_ms() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+const char* g_filter = nullptr;
+
+bool selected(const char* name) {
+    return g_filter == nullptr || std::strstr(name, g_filter) != nullptr;
+}
+
+template <typename Op>
+void bench(const char* name, Op&& op) {
+    if (selected(name)) {
+        bench::run(name, op);
+    }
+}
+
+// Bodies (envelope stripped) of one kind from the corpus
+std::vector<std::span<const std::byte>> bodies(const std::vector<bench::CorpusEntry>& corpus,
+                                               bool metrics) {
+    std::vector<std::span<const std::byte>> out;
+    for (const auto& e : corpus) {
+        if (e.metrics == metrics) {
+            out.push_back(std::span<const std::byte>(e.datagram).subspan(2));
+        }
+    }
+    // Round down to a power of two for masked indexing
+    std::size_t n = 1;
+    while (n * 2 <= out.size()) n *= 2;
+    out.resize(n);
+    return out;
+}
+
+void bench_parse_stages(const std::vector<bench::CorpusEntry>& corpus, std::uint64_t now_ms) {
+    std::size_t i = 0;
+    bench("parse_envelope", [&] {
+        const auto& d = corpus[i++ & (kCorpusSize - 1)].datagram;
+        bench::do_not_optimize(gateway::parse_envelope(std::span<const std::byte>(d)));
+    });
+
+    const auto metrics = bodies(corpus, true);
+    const auto logs = bodies(corpus, false);
+    const std::size_t mmask = metrics.size() - 1;
+    const std::size_t lmask = logs.size() - 1;
+
+    bench("classify_message (metrics + logs)", [&] {
+        const auto body = i & 1 ? metrics[(i >> 1) & mmask] : logs[(i >> 1) & lmask];
+        ++i;
+        bench::do_not_optimize(gateway::classify_message(body));
+    });
+
+    auto parsed_metrics = std::make_unique<gateway::ParsedMetrics>();
+    bench("parse_metrics", [&] {
+        bench::do_not_optimize(gateway::parse_metrics(metrics[i++ & mmask], *parsed_metrics));
+    });
+
+    // validate_* over messages parsed up front
+    std::vector<std::unique_ptr<gateway::ParsedMetrics>> parsed_m;
+    for (const auto& body : metrics) {
+        parsed_m.push_back(std::make_unique<gateway::ParsedMetrics>());
+        (void)gateway::parse_metrics(body, *parsed_m.back());
+    }
+    const gateway::MetricsValidationConfig metrics_config;
+    bench("validate_metrics", [&] {
+        bench::do_not_optimize(gateway::validate_metrics(*parsed_m[i++ & mmask], metrics_config, now_ms));
+    });
+
+    bench("parse_and_validate_metrics (fused)", [&] {
+        bench::do_not_optimize(gateway::parse_and_validate_metrics(metrics[i++ & mmask], metrics_config,
+                                                                   now_ms, *parsed_metrics));
+    });
+
+    auto parsed_log = std::make_unique<gateway::ParsedLog>();
+    bench("parse_log", [&] {
+        bench::do_not_optimize(gateway::parse_log(logs[i++ & lmask], *parsed_log));
+    });
+
+    std::vector<std::unique_ptr<gateway::ParsedLog>> parsed_l;
+    for (const auto& body : logs) {
+        parsed_l.push_back(std::make_unique<gateway::ParsedLog>());
+        (void)gateway::parse_log(body, *parsed_l.back());
+    }
+    const gateway::LogValidationConfig log_config;
+    bench("validate_log", [&] {
+        bench::do_not_optimize(gateway::validate_log(*parsed_l[i++ & lmask], log_config, now_ms));
+    });
+
+    // TB-5 payload: canonical serialization of a validated message
+    auto validated = gateway::validate_metrics(*parsed_m[0], metrics_config, now_ms);
+    std::vector<std::byte> out(2048);
+    if (const auto* v = std::get_if<gateway::ValidatedMetrics>(&validated)) {
+        bench("serialize_event (metrics)", [&] {
+            bench::do_not_optimize(gateway::serialize_event(*v, out));
+        });
+    }
+
+    // Rollup fold of whole messages (flushed whenever the table fills)
+    std::vector<gateway::ValidatedMetrics> valid_m;
+    for (const auto& p : parsed_m) {
+        auto r = gateway::validate_metrics(*p, metrics_config, now_ms);
+        if (const auto* v = std::get_if<gateway::ValidatedMetrics>(&r)) {
+            valid_m.push_back(*v);
+        }
+    }
+    if (!valid_m.empty()) {
+        gateway::MetricsAggregator aggregator;
+        const gateway::MetricsAggregator::RollupSink discard = [](const gateway::RollupEvent&) {};
+        bench("MetricsAggregator::add (message)", [&] {
+            const auto& v = valid_m[i++ % valid_m.size()];
+            if (aggregator.add(v, now_ms) != 0) {
+                (void)aggregator.flush(now_ms, discard);
+            }
+        });
+
+        // Columnar egress: one canonical payload into the open block
+        // (closed whenever full, so finish() is amortized in)
+        std::vector<std::vector<std::byte>> payloads;
+        for (const auto& v : valid_m) {
+            std::vector<std::byte> p(2048);
+            p.resize(gateway::serialize_event(v, p));
+            payloads.push_back(std::move(p));
+        }
+        for (bool compress : {false, true}) {
+            gateway::ColumnarEncoder encoder(gateway::ColumnarConfig{.compress = compress});
+            bench(compress ? "ColumnarEncoder::add (metrics, lz4)" : "ColumnarEncoder::add (metrics)",
+                  [&] {
+                      const auto& p = payloads[i++ % payloads.size()];
+                      if (!encoder.add(p)) {
+                          bench::do_not_optimize(encoder.finish().size());
+                          (void)encoder.add(p);
+                      }
+                  });
+        }
+    }
+}
+
+// Source mixes: hot (one flooding source), cold (every packet a different
+// tracked source) and eviction-heavy (4x more sources than table slots)
+std::vector<gateway::SourceKey> source_mix(std::size_t distinct, std::size_t length) {
+    std::mt19937 rng(7);
+    std::vector<gateway::SourceKey> keys(length);
+    for (auto& k : keys) {
+        const auto id = static_cast<std::uint32_t>(rng() % distinct);
+        k = gateway::SourceKey{0x0A000000u + id, static_cast<std::uint16_t>(1024 + id % 5000)};
+    }
+    return keys;
+}
+
+template <typename Limiter>
+void bench_limiter(const char* prefix) {
+    gateway::SourceLimiterConfig config;
+    config.max_sources = 1024;
+    config.tokens_per_sec = 1'000'000'000;  // measure lookup/LRU cost, not drops
+    config.burst_tokens = 1'000'000'000;
+
+    struct Mix {
+        const char* name;
+        std::size_t distinct;
+    };
+    const Mix mixes[] = {{"hot", 1}, {"cold", 1000}, {"eviction", 4096}};
+    char name[96];
+    for (const Mix& mix : mixes) {
+        const auto keys = source_mix(mix.distinct, 65536);
+        Limiter limiter(config);
+        std::size_t i = 0;
+        std::snprintf(name, sizeof(name), "%s::admit (%s)", prefix, mix.name);
+        bench(name, [&] { bench::do_not_optimize(limiter.admit(keys[i++ & 65535])); });
+    }
+}
+
+void bench_batch_admit() {
+    gateway::SourceLimiterConfig config;
+    config.max_sources = 1024;
+    config.tokens_per_sec = 1'000'000'000;
+    config.burst_tokens = 1'000'000'000;
+    const auto keys = source_mix(1000, 65536);
+    gateway::FlatSourceLimiter limiter(config);
+    std::vector<gateway::Admit> out(32);
+    std::size_t i = 0;
+    // One op = one 32-packet batch
+    bench("FlatSourceLimiter::admit_batch (cold, x32)", [&] {
+        const std::span<const gateway::SourceKey> batch(keys.data() + (i++ & 2047) * 32, 32);
+        bench::do_not_optimize(limiter.admit_batch(batch, out));
+    });
+}
+
+void bench_agent_limiter() {
+    gateway::AgentLimiterConfig config;
+    config.tokens_per_sec = 1'000'000'000;  // measure sketch + table cost, not drops
+    config.burst_tokens = 1'000'000'000;
+    std::vector<std::string> ids(4096);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = "agent-" + std::to_string(i * 7919);
+    }
+    gateway::AgentLimiter limiter(config);
+    const auto now = std::chrono::steady_clock::now();
+    std::size_t i = 0;
+    bench("AgentLimiter::admit (4096 agents)",
+          [&] { bench::do_not_optimize(limiter.admit(ids[i++ & 4095], now)); });
+}
+
+struct Item {
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+};
+
+void bench_queues() {
+    gateway::BoundedQueue<Item> queue(4096);
+    bench("BoundedQueue push+pop", [&] {
+        (void)queue.try_push(Item{1, 2});
+        Item out;
+        bench::do_not_optimize(queue.try_pop(out));
+    });
+
+    // Steady backlog of 1024: push and pop at the same rate
+    for (int k = 0; k < 1024; ++k) {
+        (void)queue.try_push(Item{});
+    }
+    bench("BoundedQueue push+pop (backlog 1024)", [&] {
+        (void)queue.try_push(Item{1, 2});
+        Item out;
+        bench::do_not_optimize(queue.try_pop(out));
+    });
+
+    gateway::DrrQueue<Item> drr(4096, 64, 256);
+    for (std::uint32_t k = 0; k < 1024; ++k) {
+        (void)drr.try_push(Item{}, k % 64, 128);
+    }
+    std::uint32_t flow = 0;
+    bench("DrrQueue push+pop (64 flows, backlog 1024)", [&] {
+        (void)drr.try_push(Item{}, flow++ & 63, 128);
+        Item out;
+        bench::do_not_optimize(drr.try_pop(out));
+    });
+}
+
+void bench_forwarder(const std::vector<bench::CorpusEntry>& corpus) {
+    static const char* const kAgents[] = {"agent-0", "agent-1", "agent-2", "agent-3",
+                                          "agent-4", "agent-5", "agent-6", "agent-7"};
+    const auto payload = std::span<const std::byte>(corpus[0].datagram).subspan(2);
+
+    gateway::ForwarderConfig config;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+    std::size_t i = 0;
+    bench("BoundedForwarder try_forward+drain_one", [&] {
+        gateway::QueuedEvent event;
+        event.agent_id = kAgents[i++ & 7];
+        event.type = gateway::EventType::Metrics;
+        event.payload = payload;
+        bench::do_not_optimize(forwarder.try_forward(event));
+        bench::do_not_optimize(forwarder.drain_one());
+    });
+
+    bench("BoundedForwarder in place (payload_buffer)", [&] {
+        const auto buffer = forwarder.payload_buffer();
+        std::memcpy(buffer.data(), payload.data(), payload.size());
+        gateway::QueuedEvent event;
+        event.agent_id = kAgents[i++ & 7];
+        event.type = gateway::EventType::Metrics;
+        event.payload = buffer.first(payload.size());
+        bench::do_not_optimize(forwarder.try_forward(event));
+        bench::do_not_optimize(forwarder.drain_one());
+    });
+
+    // Drops are the cheap path under overload: full queue, nothing drains
+    gateway::ForwarderConfig full_config;
+    full_config.max_queue_depth = 64;
+    full_config.max_per_agent = 1024;
+    gateway::BoundedForwarder full(full_config, std::make_unique<gateway::NullSink>());
+    bench("BoundedForwarder try_forward (queue full)", [&] {
+        gateway::QueuedEvent event;
+        event.agent_id = kAgents[i++ & 7];
+        event.type = gateway::EventType::Metrics;
+        event.payload = payload;
+        bench::do_not_optimize(full.try_forward(event));
+    });
+
+    gateway::ForwarderConfig async_config;
+    async_config.async_sink = true;
+    async_config.max_per_agent = 4096;
+    gateway::BoundedForwarder async(async_config, std::make_unique<gateway::NullSink>());
+    bench("BoundedForwarder try_forward (async sink)", [&] {
+        gateway::QueuedEvent event;
+        event.agent_id = kAgents[i++ & 7];
+        event.type = gateway::EventType::Metrics;
+        event.payload = payload;
+        bench::do_not_optimize(async.try_forward(event));
+    });
+    async.stop();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    g_filter = argc > 1 ? argv[1] : nullptr;
+
+    const std::uint64_t now_ms = wall_ms();
+    const auto corpus = bench::make_corpus(kCorpusSize, 60, now_ms);
+
+    bench::print_header();
+    bench_parse_stages(corpus, now_ms);
+    bench_limiter<gateway::SourceLimiter>("SourceLimiter");
+    bench_limiter<gateway::FlatSourceLimiter>("FlatSourceLimiter");
+    bench_agent_limiter();
+    bench_batch_admit();
+    bench_queues();
+    bench_forwarder(corpus);
+    return 0;
+}
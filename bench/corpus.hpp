@@ -0,0 +1,105 @@
+#pragma once
+
+// Synthetic datagram corpus for the benches: envelope-framed metrics JSON
+// and logfmt logs shaped like demos/traffic_generator.cpp output, from a
+// fixed seed so runs are comparable.
+//
+// Every message carries a fixed-width sequence number that the loopback
+// harness overwrites in place per send (JSON: digits padded with spaces,
+// which the grammar allows before ','; logfmt: zero-padded digits), so the
+// sink can match each forwarded event to its send time.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+inline constexpr std::size_t kSeqWidth = 10;
+
+struct CorpusEntry {
+    std::vector<std::byte> datagram;  // 2-byte big-endian length + body
+    std::size_t seq_offset = 0;       // kSeqWidth bytes reserved for the seq
+    bool metrics = false;             // else a log
+    bool json_seq = false;            // pad with spaces (JSON) or zeros (logfmt)
+};
+
+// Overwrite an entry's sequence field
+inline void set_seq(CorpusEntry& entry, std::uint64_t seq) noexcept {
+    char digits[kSeqWidth + 1];
+    const int n = std::snprintf(digits, sizeof(digits), entry.json_seq ? "%-10llu" : "%010llu",
+                                static_cast<unsigned long long>(seq % 10'000'000'000ULL));
+    std::memcpy(entry.datagram.data() + entry.seq_offset, digits, static_cast<std::size_t>(n));
+}
+
+inline CorpusEntry make_entry(const std::string& body, std::size_t seq_pos, bool metrics) {
+    CorpusEntry e;
+    e.datagram.resize(2 + body.size());
+    e.datagram[0] = static_cast<std::byte>((body.size() >> 8) & 0xFF);
+    e.datagram[1] = static_cast<std::byte>(body.size() & 0xFF);
+    std::memcpy(e.datagram.data() + 2, body.data(), body.size());
+    e.seq_offset = 2 + seq_pos;
+    e.metrics = metrics;
+    e.json_seq = metrics;
+    set_seq(e, 0);
+    return e;
+}
+
+// `count` messages, `metrics_percent` of them metrics, timestamped `ts_ms`
+// and spread over `agents` agent ids
+inline std::vector<CorpusEntry> make_corpus(std::size_t count, unsigned metrics_percent,
+                                            std::uint64_t ts_ms, std::size_t agents = 16,
+                                            std::uint32_t seed = 22) {
+    static const char* const kNames[] = {"cpu.usage", "mem.used", "disk.io", "net.rx", "net.tx"};
+    static const char* const kLevels[] = {"trace", "debug", "info", "warn", "error"};
+    static const char* const kMessages[] = {"Request processed", "Cache miss", "Connection opened",
+                                            "Retrying upstream", "Permission denied"};
+    std::mt19937 rng(seed);
+    const std::string placeholder(kSeqWidth, '0');
+    std::vector<CorpusEntry> corpus;
+    corpus.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string agent = "agent-" + std::to_string(rng() % std::max<std::size_t>(agents, 1));
+        std::string body;
+        std::size_t seq_pos = 0;
+        if (rng() % 100 < metrics_percent) {
+            body = "{\"agent_id\":\"" + agent + "\",\"seq\":";
+            seq_pos = body.size();
+            body += placeholder + ",\"ts\":" + std::to_string(ts_ms) + ",\"metrics\":[";
+            const int n = 1 + static_cast<int>(rng() % 5);
+            for (int m = 0; m < n; ++m) {
+                body += m > 0 ? "," : "";
+                body += "{\"n\":\"" + std::string(kNames[rng() % 5]) + "\",\"v\":" +
+                        std::to_string(static_cast<double>(rng() % 100000) / 100.0);
+                if (rng() % 2 == 0) {
+                    body += ",\"u\":\"bytes\"";
+                }
+                if (rng() % 10 < 3) {
+                    body += ",\"t\":{\"env\":\"prod\",\"region\":\"us-east\"}";
+                }
+                body += "}";
+            }
+            body += "]}";
+            corpus.push_back(make_entry(body, seq_pos, true));
+        } else {
+            body = "ts=" + std::to_string(ts_ms) + " level=" + kLevels[rng() % 5] + " agent=" + agent +
+                   " msg=\"" + kMessages[rng() % 5] + "\"";
+            if (rng() % 2 == 0) {
+                body += " request_id=req-" + std::to_string(1000 + rng() % 9000);
+            }
+            body += " seq=";
+            seq_pos = body.size();
+            body += placeholder;
+            corpus.push_back(make_entry(body, seq_pos, false));
+        }
+    }
+    return corpus;
+}
+
+}  // namespace bench
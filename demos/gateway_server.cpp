@@ -3,80 +3,181 @@
 // Full end-to-end pipeline: UDP recv → TB-1 → TB-5 → Sink
 //
 // Usage:
-//   ./gateway_server [port] [--slow]
+//   ./gateway_server [port] [--slow] [--async] [--drr] [--lanes] [--io-uring]
+//                    [--busy-poll US] [--workers N] [--pin] [--config PATH]
+//                    [--state PATH] [--aggregate MS] [--numa] [--nic IFNAME]
+//                    [--sink-node] [--steer-rx]
 //
 // Options:
-//   port   - UDP port to listen on (default: 9999)
-//   --slow - Enable slow sink mode (100ms delay per write)
-
+//   port        - UDP port to listen on (default: 9999)
+//   --slow      - Enable slow sink mode (100ms delay per write)
+//   --async     - Run sink writes on a dedicated thread per worker
+//   --drr       - Dequeue per agent by deficit round robin instead of FIFO
+//   --lanes     - Queue per priority lane (error logs, metrics, info, debug)
+//   --io-uring  - Receive via io_uring multishot recvmsg (falls back to recvmmsg)
+//   --busy-poll US - SO_BUSY_POLL budget for idle waits (needs CAP_NET_ADMIN)
+//   --workers N - Run N sharded ingest workers on SO_REUSEPORT sockets
+//   --pin       - Pin worker i to CPU i
+//   --config PATH - Runtime settings (key = value lines), re-read on SIGHUP
+//   --state PATH  - Save source limiter buckets to PATH.<worker> on shutdown
+//                   and restore them on startup (warm restart)
+//   --aggregate MS - Fold metrics into per-series rollups, forwarded every MS
+//   --numa      - Pin workers to the NIC's RX queue CPUs, then its NUMA node,
+//                 and print which worker serves each RX queue
+//   --nic IFNAME - Interface whose RX queues and node guide --numa
+//   --sink-node - With --numa --async, keep each sink thread on its worker's node
+//   --steer-rx  - Deliver a datagram to the worker pinned on the CPU that
+//                 received it (SO_ATTACH_REUSEPORT_CBPF), not by 4-tuple hash
+//
+// Each worker owns its socket, RecvLoop, SourceLimiter shard, parse/validate
+// state and forwarder. The kernel hashes each source 4-tuple to one socket,
+// so per-source limiting stays exact within a shard; per-agent limiting
+// is per shard too (an agent spread over N sockets gets up to N times the
+// rate). Each worker registers and writes its own PipelineStats block; the
+// main thread prints the registry's merged snapshot.
+
+#include "gateway/aggregate.hpp"
+#include "gateway/agent_limiter.hpp"
+#include "gateway/classify.hpp"
 #include "gateway/config.hpp"
+#include "gateway/config_snapshot.hpp"
+#include "gateway/event_loop.hpp"
 #include "gateway/forwarder.hpp"
 #include "gateway/parse_envelope.hpp"
 #include "gateway/parse_log.hpp"
 #include "gateway/parse_metrics.hpp"
 #include "gateway/recv_loop.hpp"
+#include "gateway/seq_dedup.hpp"
+#include "gateway/serialize.hpp"
 #include "gateway/sink.hpp"
 #include "gateway/source_limiter.hpp"
+#include "gateway/stats.hpp"
+#include "gateway/topology.hpp"
 #include "gateway/validate_log.hpp"
 #include "gateway/validate_metrics.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>   // fcntl()
+#include <memory>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <unistd.h>  // close()
+#include <vector>
 
 namespace {
 
 // Global flag for graceful shutdown
 std::atomic<bool> g_running{true};
 
+// Set by SIGHUP: re-read the --config file and publish a new snapshot
+std::atomic<bool> g_reload{false};
+
 void signal_handler(int /*signum*/) {
     g_running = false;
 }
 
-// Statistics
-struct Stats {
-    std::uint64_t received = 0;
-    std::uint64_t source_limited = 0;
-    std::uint64_t envelope_drops = 0;
-    std::uint64_t parse_drops = 0;
-    std::uint64_t validation_drops = 0;
-    std::uint64_t forwarded = 0;
-    std::uint64_t queue_drops = 0;
-    std::uint64_t quota_drops = 0;
-};
-
-// Detect message type by looking at format
-// - Metrics: JSON with "metrics" array
-// - Log: logfmt with key=value pairs
-enum class MessageType { Metrics, Log, Unknown };
-
-MessageType detect_message_type(std::span<const std::byte> body) {
-    if (body.empty()) return MessageType::Unknown;
-
-    std::string_view text(reinterpret_cast<const char*>(body.data()), body.size());
-
-    // JSON starts with '{', logfmt starts with a key like 'ts='
-    if (!text.empty() && text[0] == '{') {
-        // It's JSON - check for metrics array
-        if (text.find("\"metrics\"") != std::string_view::npos) {
-            return MessageType::Metrics;
+void reload_handler(int /*signum*/) {
+    g_reload = true;
+}
+
+using RuntimeSnapshot = gateway::ConfigSnapshot<gateway::RuntimeConfig>;
+
+// Demo defaults: small limits so drops are visible
+gateway::RuntimeConfig default_runtime_config() {
+    gateway::RuntimeConfig config;
+    config.source_limiter.tokens_per_sec = 50;   // 50 packets/sec sustained
+    config.source_limiter.burst_tokens = 100;    // Allow bursts up to 100
+    config.max_per_agent = 16;                   // Per-agent quota
+    config.agent_limiter.tokens_per_sec = 200;   // Per-agent events/sec after validation
+    config.agent_limiter.burst_tokens = 400;
+    return config;
+}
+
+// Apply `key = value` lines (# comments) from `path` on top of `config`.
+// Keys: tokens_per_sec, burst_tokens, max_sources, max_per_agent,
+// agent_tokens_per_sec, agent_burst_tokens, max_age_ms, max_future_ms (timestamp window for metrics and logs).
+// Returns false, leaving `config` untouched, if the file can't be read or
+// has an unknown key or bad value.
+bool load_runtime_config(const char* path, gateway::RuntimeConfig& config) {
+    std::FILE* file = std::fopen(path, "r");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Config: cannot open %s\n", path);
+        return false;
+    }
+    gateway::RuntimeConfig next = config;
+    char line[256];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && std::fgets(line, sizeof(line), file) != nullptr) {
+        ++line_no;
+        char key[64];
+        long long value = 0;
+        const char* p = line + std::strspn(line, " \t");
+        if (*p == '#' || *p == '\n' || *p == '\0') {
+            continue;
         }
-    } else {
-        // Not JSON - assume logfmt if it has required log fields
-        if (text.find("ts=") != std::string_view::npos &&
-            text.find("level=") != std::string_view::npos &&
-            text.find("msg=") != std::string_view::npos) {
-            return MessageType::Log;
+        if (std::sscanf(p, "%63[a-z_] = %lld", key, &value) != 2 || value < 0) {
+            ok = false;
+        } else if (std::strcmp(key, "tokens_per_sec") == 0 && value <= UINT32_MAX) {
+            next.source_limiter.tokens_per_sec = static_cast<std::uint32_t>(value);
+        } else if (std::strcmp(key, "burst_tokens") == 0 && value <= UINT32_MAX) {
+            next.source_limiter.burst_tokens = static_cast<std::uint32_t>(value);
+        } else if (std::strcmp(key, "max_sources") == 0 && value > 0 && value <= (1 << 24)) {
+            next.source_limiter.max_sources = static_cast<std::size_t>(value);
+        } else if (std::strcmp(key, "max_per_agent") == 0) {
+            next.max_per_agent = static_cast<std::size_t>(value);
+        } else if (std::strcmp(key, "agent_tokens_per_sec") == 0 && value <= UINT32_MAX) {
+            next.agent_limiter.tokens_per_sec = static_cast<std::uint32_t>(value);
+        } else if (std::strcmp(key, "agent_burst_tokens") == 0 && value <= UINT32_MAX) {
+            next.agent_limiter.burst_tokens = static_cast<std::uint32_t>(value);
+        } else if (std::strcmp(key, "max_age_ms") == 0) {
+            next.metrics_validation.timestamp_window.max_age_ms = value;
+            next.log_validation.timestamp_window.max_age_ms = value;
+        } else if (std::strcmp(key, "max_future_ms") == 0) {
+            next.metrics_validation.timestamp_window.max_future_ms = value;
+            next.log_validation.timestamp_window.max_future_ms = value;
+        } else {
+            ok = false;
         }
+        if (!ok) {
+            std::fprintf(stderr, "Config: %s:%d: bad setting: %s", path, line_no, line);
+        }
+    }
+    std::fclose(file);
+    if (ok) {
+        config = next;
+    }
+    return ok;
+}
+
+// TB-5 for rollups: one event per agent, split over as many payload
+// slots as its series need
+void forward_rollup(gateway::BoundedForwarder& forwarder, const gateway::RollupEvent& rollup,
+                    gateway::PipelineStats& stats) {
+    gateway::RollupEvent rest = rollup;
+    while (!rest.series.empty()) {
+        const auto buffer = forwarder.payload_buffer();
+        std::size_t written = 0;
+        const std::size_t size = gateway::serialize_rollup(rest, buffer, written);
+        if (size == 0) {
+            stats.serialize_overflow.add();  // One series larger than a payload slot
+            written = 1;
+        } else {
+            gateway::QueuedEvent event;
+            event.agent_id = rest.agent_id;
+            event.type = gateway::EventType::Metrics;
+            event.payload = buffer.first(size);
+            stats.forward.add(forwarder.try_forward(std::move(event)));
+        }
+        rest.series = rest.series.subspan(written);
     }
-    return MessageType::Unknown;
 }
 
 // Get current time in milliseconds (for validation)
@@ -87,110 +188,238 @@ std::uint64_t current_time_ms() {
     return static_cast<std::uint64_t>(ms.count());
 }
 
-// Convert validated event to JSON bytes for forwarding
-std::vector<std::byte> serialize_event(const gateway::ValidatedMetrics& metrics) {
-    // For demo, just re-serialize a simplified JSON
-    std::string json = "{\"type\":\"metrics\",\"agent_id\":\"";
-    json += metrics.agent_id;
-    json += "\",\"seq\":";
-    json += std::to_string(metrics.seq);
-    json += ",\"ts\":";
-    json += std::to_string(metrics.ts);
-    json += ",\"metric_count\":";
-    json += std::to_string(metrics.metric_count);
-    json += "}";
-
-    std::vector<std::byte> result(json.size());
-    std::memcpy(result.data(), json.data(), json.size());
-    return result;
+// TB-5: Serialize the canonical event straight into a forwarder payload
+// slot and queue it there (no per-event allocation or copy). True if queued.
+template <typename Validated>
+bool forward_event(gateway::BoundedForwarder& forwarder, const Validated& validated,
+                   gateway::EventType type, gateway::LogLevel level,
+                   gateway::PipelineStats& stats) {
+    const auto buffer = forwarder.payload_buffer();
+    const std::size_t size = gateway::serialize_event(validated, buffer);
+    if (size == 0) {
+        stats.serialize_overflow.add();  // Larger than a payload slot
+        return false;
+    }
+
+    gateway::QueuedEvent event;
+    event.agent_id = validated.agent_id;  // view; interned by try_forward
+    event.type = type;
+    event.level = level;                  // with type, picks the lane
+    event.payload = buffer.first(size);
+
+    const auto result = forwarder.try_forward(std::move(event));
+    stats.forward.add(result);
+    return result == gateway::ForwardResult::Queued;
 }
 
-std::vector<std::byte> serialize_event(const gateway::ValidatedLog& log) {
-    std::string json = "{\"type\":\"log\",\"agent_id\":\"";
-    json += log.agent_id;
-    json += "\",\"ts\":";
-    json += std::to_string(log.ts);
-    json += ",\"level\":";
-    json += std::to_string(static_cast<int>(log.level));
-    json += ",\"msg\":\"";
-    // Escape any quotes in message (simplified)
-    for (char c : log.msg) {
-        if (c == '"') json += "\\\"";
-        else if (c == '\\') json += "\\\\";
-        else json += c;
-    }
-    json += "\"}";
-
-    std::vector<std::byte> result(json.size());
-    std::memcpy(result.data(), json.data(), json.size());
-    return result;
+// Publish worker-owned component state for the stats reader
+void publish_gauges(gateway::PipelineStats& stats, const gateway::BoundedForwarder& forwarder,
+                    const gateway::FlatSourceLimiter& limiter) {
+    stats.forwarded.set(forwarder.total_forwarded());
+    stats.queue_depth.set(forwarder.queue_depth());
+    stats.queue_capacity.set(forwarder.queue_capacity());
+    stats.tracked_agents.set(forwarder.quota_tracker().tracked_agents());
+    stats.tracked_sources.set(limiter.tracked_count());
 }
 
-void print_stats(const Stats& stats, const gateway::BoundedForwarder& forwarder,
-                 const gateway::SourceLimiter& limiter) {
-    std::fprintf(stderr, "\n--- Stats ---\n");
-    std::fprintf(stderr, "Received:        %lu\n", stats.received);
-    std::fprintf(stderr, "Source limited:  %lu\n", stats.source_limited);
-    std::fprintf(stderr, "Envelope drops:  %lu\n", stats.envelope_drops);
-    std::fprintf(stderr, "Parse drops:     %lu\n", stats.parse_drops);
-    std::fprintf(stderr, "Validation drops:%lu\n", stats.validation_drops);
-    std::fprintf(stderr, "Queue drops:     %lu (queue full)\n", stats.queue_drops);
-    std::fprintf(stderr, "Quota drops:     %lu (per-agent)\n", stats.quota_drops);
-    std::fprintf(stderr, "Forwarded:       %lu\n", forwarder.total_forwarded());
-    std::fprintf(stderr, "Queue depth:     %zu / %zu\n",
-                 forwarder.queue_depth(), forwarder.queue_capacity());
-    std::fprintf(stderr, "Tracked agents:  %zu\n",
-                 forwarder.quota_tracker().tracked_agents());
-    std::fprintf(stderr, "Source limiter:  %zu sources tracked\n",
-                 limiter.tracked_count());
-    std::fprintf(stderr, "-------------\n\n");
+std::uint64_t forward_count(const gateway::StatsSnapshot& s, gateway::ForwardResult result) {
+    return s.forward[static_cast<std::size_t>(result)];
 }
 
-}  // namespace
+void print_latency(const char* label, const gateway::HistogramSnapshot& h) {
+    std::fprintf(stderr, "%s p50 %lu ns, p99 %lu ns, max %lu ns (%lu sampled)\n", label,
+                 h.percentile(0.5), h.percentile(0.99), h.max, h.count());
+}
 
-int main(int argc, char* argv[]) {
-    // Parse arguments
-    std::uint16_t port = 9999;
-    bool slow_mode = false;
+// Print the merged view across all workers
+void print_stats(const gateway::StatsRegistry& registry) {
+    const gateway::StatsSnapshot s = registry.snapshot();
+    const std::uint64_t queue_drops =
+        forward_count(s, gateway::ForwardResult::DroppedQueueFull) +
+        forward_count(s, gateway::ForwardResult::DroppedPayloadStorageFull) +
+        forward_count(s, gateway::ForwardResult::DroppedPayloadTooLarge) + s.serialize_overflow;
+    const std::uint64_t quota_drops =
+        forward_count(s, gateway::ForwardResult::DroppedAgentQuotaExceeded) +
+        forward_count(s, gateway::ForwardResult::DroppedAgentTableFull);
 
-    for (int i = 1; i < argc; ++i) {
-        if (std::strcmp(argv[i], "--slow") == 0) {
-            slow_mode = true;
-        } else {
-            port = static_cast<std::uint16_t>(std::atoi(argv[i]));
+    std::fprintf(stderr, "\n--- Stats ---\n");
+    std::fprintf(stderr, "Received:        %lu\n", s.received);
+    std::fprintf(stderr, "Recv drops:      %lu truncated, %lu no buffer, %lu errors\n",
+                 s.recv_truncated, s.recv_no_buffer, s.recv_errors);
+    std::fprintf(stderr, "Source limited:  %lu\n", s.source_limited);
+    std::fprintf(stderr, "Envelope drops:  %lu\n", gateway::total(s.envelope));
+    std::fprintf(stderr, "Prefilter drops: %lu\n", gateway::total(s.prefilter));
+    std::fprintf(stderr, "Parse drops:     %lu\n", gateway::total(s.metrics_parse) + gateway::total(s.log_parse));
+    std::fprintf(stderr, "Validation drops:%lu\n",
+                 gateway::total(s.metrics_validation) + gateway::total(s.log_validation));
+    std::fprintf(stderr, "Duplicates:      %lu (replayed seq)\n", s.duplicates);
+    std::fprintf(stderr, "Agent limited:   %lu\n", s.agent_limited);
+    if (s.aggregated + s.aggregate_dropped > 0) {
+        std::fprintf(stderr, "Aggregated:      %lu values (%lu over rollup caps)\n", s.aggregated,
+                     s.aggregate_dropped);
+    }
+    std::fprintf(stderr, "Queue drops:     %lu (queue full)\n", queue_drops);
+    std::fprintf(stderr, "Quota drops:     %lu (per-agent)\n", quota_drops);
+    std::fprintf(stderr, "Forwarded:       %lu\n", s.forwarded);
+    std::fprintf(stderr, "Queue depth:     %lu / %lu\n", s.queue_depth, s.queue_capacity);
+    std::fprintf(stderr, "Tracked agents:  %lu\n", s.tracked_agents);
+    std::fprintf(stderr, "Source limiter:  %lu sources tracked\n", s.tracked_sources);
+    print_latency("Parse:          ", s.parse);
+    print_latency("Validate:       ", s.validate);
+    print_latency("Queue -> sink:  ", s.queue);
+    print_latency("Sink write:     ", s.sink_write);
+    if (registry.capacity() > 1) {
+        for (std::size_t i = 0; i < registry.capacity(); ++i) {
+            const gateway::StatsSnapshot w = registry.snapshot(i);
+            std::fprintf(stderr, "  worker %zu:     %lu received, %lu forwarded\n",
+                         i, w.received, w.forwarded);
         }
     }
+    std::fprintf(stderr, "-------------\n\n");
+}
 
-    std::fprintf(stderr, "Starting gateway server on port %u%s\n",
-                 port, slow_mode ? " (slow mode)" : "");
+// Plan worker CPUs from the NUMA topology: the NIC's RX queue CPUs first,
+// then the rest of its node. Prints which worker serves each RX queue so
+// cross-node paths show up at startup. False if no topology is readable.
+bool place_workers(const gateway::WorkerConfig& worker_config, std::vector<int>& cpus,
+                   std::vector<std::vector<int>>& sink_cpus) {
+    const gateway::CpuTopology topology = gateway::load_cpu_topology();
+    gateway::NicTopology nic;
+    if (!worker_config.nic.empty()) {
+        nic = gateway::load_nic_topology(worker_config.nic, topology);
+    }
+    std::vector<int> rx_cpus;
+    for (const auto& q : nic.rx_queues) {
+        if (!q.cpus.empty()) {
+            rx_cpus.push_back(q.cpus.front());
+        }
+    }
+    const std::vector<int> plan =
+        gateway::plan_worker_cpus(topology, cpus.size(), rx_cpus, nic.node);
+    if (plan.empty()) {
+        return false;
+    }
+    cpus = plan;
+    for (std::size_t i = 0; i < cpus.size(); ++i) {
+        if (worker_config.sink_on_worker_node) {
+            sink_cpus[i] = gateway::node_cpus_for(topology, cpus[i]);
+        }
+    }
 
-    // Set up signal handler
-    std::signal(SIGINT, signal_handler);
-    std::signal(SIGTERM, signal_handler);
+    std::fprintf(stderr, "NUMA: %zu node(s)", topology.node_count());
+    if (!worker_config.nic.empty()) {
+        std::fprintf(stderr, ", %s on node %d with %zu RX queue(s)", nic.name.c_str(), nic.node,
+                     nic.rx_queues.size());
+    }
+    std::fprintf(stderr, "\n");
+    const auto placement = gateway::map_rx_queues(nic, topology, cpus);
+    for (std::size_t q = 0; q < nic.rx_queues.size(); ++q) {
+        const auto& rx = nic.rx_queues[q];
+        std::fprintf(stderr, "  rx queue %d: irq %d, cpu %d, node %d -> ", rx.queue, rx.irq,
+                     rx.cpus.empty() ? -1 : rx.cpus.front(), rx.node);
+        if (placement[q].worker < 0) {
+            std::fprintf(stderr, "no worker on its node (cross-node)\n");
+        } else {
+            std::fprintf(stderr, "worker %d%s\n", placement[q].worker,
+                         placement[q].same_cpu ? " (same CPU)" : " (same node)");
+        }
+    }
+    for (std::size_t i = 0; i < cpus.size(); ++i) {
+        std::fprintf(stderr, "  worker %zu: cpu %d, node %d", i, cpus[i], topology.node_of(cpus[i]));
+        if (!sink_cpus[i].empty()) {
+            std::fprintf(stderr, ", sink on %zu node CPU(s)", sink_cpus[i].size());
+        }
+        std::fprintf(stderr, "\n");
+    }
+    return true;
+}
 
-    // Create UDP socket
-    int fd = gateway::create_udp_socket(port);
-    if (fd < 0) {
-        std::fprintf(stderr, "Failed to create UDP socket on port %u\n", port);
-        return EXIT_FAILURE;
+// One ingest worker: owns its own socket, pipeline shard and forwarder.
+// All pipeline state, including its stats block, is constructed on the
+// worker thread after pinning, so first touch places it on the worker's
+// node.
+void run_worker(std::size_t index, int fd, bool slow_mode, bool async_sink,
+                gateway::SchedulerMode scheduler, gateway::LanePolicy lanes,
+                const gateway::RecvConfig& recv_config, RuntimeSnapshot::Reader config_reader,
+                const char* state_path, std::uint32_t aggregate_ms,
+                const gateway::WorkerConfig& worker_config, int cpu, std::vector<int> sink_cpus,
+                gateway::StatsRegistry& registry) {
+    if (cpu >= 0) {
+        if (!gateway::pin_current_thread_to_cpu(cpu)) {
+            std::fprintf(stderr, "Worker %zu: failed to pin to CPU %d\n", index, cpu);
+        }
     }
+    if (worker_config.numa_placement) {
+        (void)gateway::set_local_memory_policy();
+    }
+    gateway::PipelineStats* stats_block = registry.register_thread(index);
+    if (stats_block == nullptr) {
+        std::fprintf(stderr, "Worker %zu: no stats block\n", index);
+        return;
+    }
+    gateway::PipelineStats& stats = *stats_block;
 
     // Initialize pipeline components
-    gateway::RecvConfig recv_config;
     gateway::RecvLoop recv_loop(fd, recv_config);
     if (!recv_loop.configure_socket()) {
-        std::fprintf(stderr, "Failed to configure socket\n");
-        return EXIT_FAILURE;
+        std::fprintf(stderr, "Worker %zu: failed to configure socket\n", index);
+        return;
+    }
+    if (recv_config.backend == gateway::RecvBackend::IoUring &&
+        recv_loop.backend() != gateway::RecvBackend::IoUring) {
+        std::fprintf(stderr, "Worker %zu: io_uring unavailable, using recvmmsg\n", index);
     }
 
-    gateway::SourceLimiterConfig limiter_config;
-    limiter_config.tokens_per_sec = 50;   // 50 packets/sec sustained
-    limiter_config.burst_tokens = 100;    // Allow bursts up to 100
-    gateway::SourceLimiter source_limiter(limiter_config);
+    // Runtime settings: re-read once per batch (one acquire load) and
+    // applied in place when a new version is published
+    const gateway::RuntimeConfig* runtime = &config_reader.read();
+    std::uint64_t applied_version = config_reader.version();
+
+    gateway::FlatSourceLimiter source_limiter(runtime->source_limiter);
+
+    // Warm restart: adopt the previous process's buckets, so a restart
+    // does not hand every known source a fresh burst
+    const std::string state_file =
+        state_path != nullptr ? std::string(state_path) + "." + std::to_string(index) : std::string();
+    if (!state_file.empty()) {
+        const auto status = source_limiter.restore_snapshot(state_file.c_str());
+        if (status == gateway::SnapshotStatus::Ok) {
+            std::fprintf(stderr, "Worker %zu: restored %zu sources from %s\n", index,
+                         source_limiter.tracked_count(), state_file.c_str());
+        } else if (status != gateway::SnapshotStatus::NotFound) {
+            std::fprintf(stderr, "Worker %zu: ignoring unreadable state file %s\n", index,
+                         state_file.c_str());
+        }
+    }
+
+    // Post-validation tier: rate per agent_id, fixed-size state
+    gateway::AgentLimiter agent_limiter(runtime->agent_limiter);
+
+    // Retried metrics (same agent_id and seq) are dropped before serializing
+    gateway::SeqDeduplicator dedup;
+
+    // Optional rollups: metrics fold into per-series windows; each flush
+    // forwards one event per agent instead of one per datagram
+    std::unique_ptr<gateway::MetricsAggregator> aggregator;
+    if (aggregate_ms > 0) {
+        aggregator = std::make_unique<gateway::MetricsAggregator>();
+    }
+
+    // Per-batch admission scratch: one admit_batch call per recvmmsg batch
+    std::vector<gateway::SourceKey> batch_sources;
+    std::vector<gateway::Admit> batch_admits(recv_loop.batch_size());
+    batch_sources.reserve(recv_loop.batch_size());
 
     gateway::ForwarderConfig forwarder_config;
     forwarder_config.max_queue_depth = 256;  // Small for demo visibility
-    forwarder_config.max_per_agent = 16;     // Per-agent quota
+    forwarder_config.max_per_agent = runtime->max_per_agent;
+    forwarder_config.async_sink = async_sink; // Slow sink no longer stalls recv
+    forwarder_config.scheduler = scheduler;   // DRR: bursty agents can't crowd out quiet ones
+    forwarder_config.lanes = lanes;           // Debug storms can't evict metrics
+    forwarder_config.lane_capacity = {64, 128, 48, 16};  // Same 256 in total
+    forwarder_config.queue_latency = &stats.queue;       // Written by the draining thread
+    forwarder_config.sink_write_latency = &stats.sink_write;
+    forwarder_config.sink_cpus = std::move(sink_cpus);  // Empty: shares the worker's CPU
 
     std::unique_ptr<gateway::Sink> sink;
     if (slow_mode) {
@@ -203,164 +432,396 @@ int main(int argc, char* argv[]) {
     }
 
     gateway::BoundedForwarder forwarder(forwarder_config, std::move(sink));
+    const gateway::MetricsAggregator::RollupSink emit_rollup =
+        [&](const gateway::RollupEvent& rollup) { forward_rollup(forwarder, rollup, stats); };
+
+    // Parse scratch, reused for every datagram of this worker
+    auto parsed_metrics = std::make_unique<gateway::ParsedMetrics>();
+    auto parsed_log = std::make_unique<gateway::ParsedLog>();
+
+    // Time parse/validate on one packet in 16: two clock reads amortized
+    // to a few ns per packet
+    gateway::LatencySampler sampler(4);
+
+    // Event loop: spin while traffic is flowing or a sync backlog is
+    // pending, otherwise wait in the kernel until data or the next timer.
+    // Forwarder drains and stats publication run on timers, independent
+    // of load.
+    gateway::EventLoop loop(recv_loop);
+    loop.on_idle([&] {
+        forwarder.drain_one();
+        return !async_sink && forwarder.queue_depth() > 0;
+    });
+    (void)loop.add_timer(std::chrono::milliseconds(1), [&] { forwarder.drain_one(); });
+    (void)loop.add_timer(std::chrono::milliseconds(100),
+                         [&] { publish_gauges(stats, forwarder, source_limiter); });
+    if (aggregator) {
+        (void)loop.add_timer(std::chrono::milliseconds(aggregate_ms),
+                             [&] { (void)aggregator->flush(current_time_ms(), emit_rollup); });
+    }
 
-    // Validation configs
-    gateway::MetricsValidationConfig metrics_validation;
-    gateway::LogValidationConfig log_validation;
-
-    Stats stats;
-    auto last_stats_time = std::chrono::steady_clock::now();
-
-    std::fprintf(stderr, "Gateway ready. Press Ctrl+C to stop.\n");
-    std::fprintf(stderr, "Forwarded events will be printed as JSON to stdout.\n\n");
-
-    // Main loop
-    while (g_running) {
-        // Receive datagram
-        auto result = recv_loop.recv_one();
-
-        if (result.status == gateway::RecvStatus::WouldBlock) {
-            // No data, drain forwarder and check stats
-            forwarder.drain_one();
-
-            // Print stats every second
-            auto now = std::chrono::steady_clock::now();
-            if (now - last_stats_time >= std::chrono::seconds(1)) {
-                print_stats(stats, forwarder, source_limiter);
-                last_stats_time = now;
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            continue;
+    loop.on_batch([&](std::span<gateway::RecvResult> batch) {
+        runtime = &config_reader.read();
+        if (config_reader.version() != applied_version) {
+            // Buckets, LRU order and queued events all survive the change
+            source_limiter.reconfigure(runtime->source_limiter);
+            forwarder.set_max_per_agent(runtime->max_per_agent);
+            agent_limiter.reconfigure(runtime->agent_limiter);
+            applied_version = config_reader.version();
         }
-
-        if (result.status == gateway::RecvStatus::Error) {
-            if (g_running) {
-                std::fprintf(stderr, "Recv error: %d\n", result.error_code);
+        const auto& metrics_validation = runtime->metrics_validation;
+        const auto& log_validation = runtime->log_validation;
+        const auto batch_now = std::chrono::steady_clock::now();
+
+        // TB-1.5: Source rate limiting, decided for the whole batch at once
+        batch_sources.clear();
+        for (const auto& result : batch) {
+            if (result.status == gateway::RecvStatus::Ok) {
+                batch_sources.push_back(result.datagram.source);
             }
-            continue;
-        }
-
-        if (result.status == gateway::RecvStatus::Truncated) {
-            // TB-1: Oversized datagram dropped
-            continue;
         }
+        source_limiter.admit_batch(batch_sources, batch_admits);
+        std::size_t next_admit = 0;
+
+        for (const auto& result : batch) {
+            if (result.status == gateway::RecvStatus::Error) {
+                stats.recv_errors.add();
+                if (g_running) {
+                    std::fprintf(stderr, "Recv error: %d\n", result.error_code);
+                }
+                continue;
+            }
 
-        ++stats.received;
+            if (result.status == gateway::RecvStatus::Truncated) {
+                // TB-1: Oversized datagram dropped
+                stats.recv_truncated.add();
+                continue;
+            }
 
-        // TB-1.5: Source rate limiting
-        if (source_limiter.admit(result.datagram.source) == gateway::Admit::Drop) {
-            ++stats.source_limited;
-            continue;
-        }
+            if (result.status == gateway::RecvStatus::NoBuffer) {
+                // Buffer pool exhausted; datagrams stay queued in the kernel
+                stats.recv_no_buffer.add();
+                continue;
+            }
 
-        // TB-2: Envelope parsing
-        auto envelope_result = gateway::parse_envelope(
-            std::span<const std::byte>(result.datagram.data));
+            stats.received.add();
 
-        if (std::holds_alternative<gateway::DropReason>(envelope_result)) {
-            ++stats.envelope_drops;
-            continue;
-        }
+            // TB-1.5: Decision from admit_batch above
+            if (batch_admits[next_admit++] == gateway::Admit::Drop) {
+                stats.source_limited.add();
+                continue;
+            }
 
-        auto& parsed_body = std::get<gateway::ParsedBody>(envelope_result);
+            // TB-2: Envelope parsing
+            auto envelope_result = gateway::parse_envelope(
+                std::span<const std::byte>(result.datagram.data));
 
-        // Detect message type
-        auto msg_type = detect_message_type(parsed_body.body);
+            if (const auto* drop = std::get_if<gateway::DropReason>(&envelope_result)) {
+                stats.envelope.add(*drop);
+                continue;
+            }
 
-        std::uint64_t now_ms = current_time_ms();
+            auto& parsed_body = std::get<gateway::ParsedBody>(envelope_result);
 
-        if (msg_type == MessageType::Metrics) {
-            // TB-3: Parse metrics
-            auto parse_result = gateway::parse_metrics(parsed_body.body);
-            if (std::holds_alternative<gateway::MetricsDropReason>(parse_result)) {
-                ++stats.parse_drops;
+            // Pre-filter: classify and check the header before TB-3
+            auto classify_result = gateway::classify_message(parsed_body.body);
+            if (const auto* drop = std::get_if<gateway::PrefilterDrop>(&classify_result)) {
+                stats.prefilter.add(*drop);
                 continue;
             }
+            const auto& header = std::get<gateway::MessageHeader>(classify_result);
 
-            auto& parsed = std::get<gateway::ParsedMetrics>(parse_result);
+            std::uint64_t now_ms = current_time_ms();
 
-            // TB-4: Validate metrics
-            auto validate_result = gateway::validate_metrics(
-                parsed, metrics_validation, now_ms);
-            if (std::holds_alternative<gateway::MetricsValidationDrop>(validate_result)) {
-                ++stats.validation_drops;
+            const bool is_metrics = header.format == gateway::MessageFormat::Metrics;
+            if (auto drop = gateway::check_header(header,
+                                                  is_metrics ? metrics_validation.timestamp_window
+                                                             : log_validation.timestamp_window,
+                                                  now_ms)) {
+                stats.prefilter.add(*drop);
                 continue;
             }
 
-            auto& validated = std::get<gateway::ValidatedMetrics>(validate_result);
-
-            // TB-5: Forward
-            gateway::QueuedEvent event;
-            event.agent_id = std::string(validated.agent_id);
-            event.type = gateway::EventType::Metrics;
-            event.payload = serialize_event(validated);
+            const bool timed = sampler.next();
+            std::uint64_t start_ns = timed ? gateway::monotonic_ns() : 0;
+
+            if (is_metrics) {
+                // TB-3 + TB-4: Parse and validate metrics in one pass
+                // (timed as parse)
+                auto validate_result = gateway::parse_and_validate_metrics(
+                    parsed_body.body, metrics_validation, now_ms, *parsed_metrics);
+                if (timed) {
+                    stats.parse.record(gateway::monotonic_ns() - start_ns);
+                }
+                if (const auto* drop = std::get_if<gateway::MetricsDropReason>(&validate_result)) {
+                    stats.metrics_parse.add(*drop);
+                    continue;
+                }
+                if (const auto* drop = std::get_if<gateway::MetricsValidationDrop>(&validate_result)) {
+                    stats.metrics_validation.add(*drop);
+                    continue;
+                }
+
+                auto& validated = std::get<gateway::ValidatedMetrics>(validate_result);
+
+                // Replay suppression: a duplicate spends no agent budget.
+                // The seq is committed only once the event is delivered,
+                // so a retry of a rate-limited or backpressured event passes.
+                if (dedup.check(validated.agent_id, validated.seq) == gateway::DedupResult::Duplicate) {
+                    stats.duplicates.add();
+                    continue;
+                }
+
+                // Per-agent rate limit
+                if (agent_limiter.admit(validated.agent_id, batch_now) == gateway::Admit::Drop) {
+                    stats.agent_limited.add();
+                    continue;
+                }
+
+                if (aggregator) {
+                    // Rollup: forwarded on the flush timer instead
+                    const std::size_t dropped = aggregator->add(validated, now_ms);
+                    stats.aggregated.add(validated.metric_count - dropped);
+                    stats.aggregate_dropped.add(dropped);
+                    // Anything folded would fold twice on a retry
+                    if (dropped < validated.metric_count || validated.metric_count == 0) {
+                        dedup.commit(validated.agent_id, validated.seq);
+                    }
+                    continue;
+                }
+
+                // TB-5: Forward
+                if (forward_event(forwarder, validated, gateway::EventType::Metrics,
+                                  gateway::LogLevel::Info, stats)) {
+                    dedup.commit(validated.agent_id, validated.seq);
+                }
+
+            } else {
+                // TB-3: Parse log
+                const auto parse_drop = gateway::parse_log(parsed_body.body, *parsed_log);
+                if (timed) {
+                    const std::uint64_t now_ns = gateway::monotonic_ns();
+                    stats.parse.record(now_ns - start_ns);
+                    start_ns = now_ns;
+                }
+                if (parse_drop) {
+                    stats.log_parse.add(*parse_drop);
+                    continue;
+                }
+
+                const auto& parsed = *parsed_log;
+
+                // TB-4: Validate log
+                auto validate_result = gateway::validate_log(
+                    parsed, log_validation, now_ms);
+                if (timed) {
+                    stats.validate.record(gateway::monotonic_ns() - start_ns);
+                }
+                if (const auto* drop = std::get_if<gateway::LogValidationDrop>(&validate_result)) {
+                    stats.log_validation.add(*drop);
+                    continue;
+                }
+
+                auto& validated = std::get<gateway::ValidatedLog>(validate_result);
+
+                // Per-agent rate limit (logs without an agent_id share one budget)
+                if (agent_limiter.admit(validated.agent_id, batch_now) == gateway::Admit::Drop) {
+                    stats.agent_limited.add();
+                    continue;
+                }
+
+                // TB-5: Forward
+                forward_event(forwarder, validated, gateway::EventType::Log, validated.level, stats);
 
-            auto forward_result = forwarder.try_forward(std::move(event));
-            if (forward_result == gateway::ForwardResult::DroppedQueueFull) {
-                ++stats.queue_drops;
-            } else if (forward_result == gateway::ForwardResult::DroppedAgentQuotaExceeded) {
-                ++stats.quota_drops;
             }
 
-        } else if (msg_type == MessageType::Log) {
-            // TB-3: Parse log
-            auto parse_result = gateway::parse_log(parsed_body.body);
-            if (std::holds_alternative<gateway::LogDropReason>(parse_result)) {
-                ++stats.parse_drops;
-                continue;
-            }
+            // Drain forwarder
+            forwarder.drain_one();
+        }
+    });
 
-            auto& parsed = std::get<gateway::ParsedLog>(parse_result);
+    loop.run(g_running);
 
-            // TB-4: Validate log
-            auto validate_result = gateway::validate_log(
-                parsed, log_validation, now_ms);
-            if (std::holds_alternative<gateway::LogValidationDrop>(validate_result)) {
-                ++stats.validation_drops;
-                continue;
-            }
+    // Final drain (the open rollup window first)
+    if (aggregator) {
+        (void)aggregator->flush(current_time_ms(), emit_rollup);
+    }
+    forwarder.drain_all();
+    publish_gauges(stats, forwarder, source_limiter);
 
-            auto& validated = std::get<gateway::ValidatedLog>(validate_result);
+    if (!state_file.empty() &&
+        source_limiter.save_snapshot(state_file.c_str()) != gateway::SnapshotStatus::Ok) {
+        std::fprintf(stderr, "Worker %zu: failed to save %s\n", index, state_file.c_str());
+    }
+}
 
-            // TB-5: Forward
-            gateway::QueuedEvent event;
-            event.agent_id = std::string(validated.agent_id);
-            event.type = gateway::EventType::Log;
-            event.payload = serialize_event(validated);
-
-            auto forward_result = forwarder.try_forward(std::move(event));
-            if (forward_result == gateway::ForwardResult::DroppedQueueFull) {
-                ++stats.queue_drops;
-            } else if (forward_result == gateway::ForwardResult::DroppedAgentQuotaExceeded) {
-                ++stats.quota_drops;
-            }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    // Parse arguments
+    std::uint16_t port = 9999;
+    bool slow_mode = false;
+    bool async_sink = false;
+    auto scheduler = gateway::SchedulerMode::Fifo;
+    auto lanes = gateway::LanePolicy::Single;
+    gateway::RecvConfig recv_config;
+    const char* config_path = nullptr;
+    const char* state_path = nullptr;
+    std::uint32_t aggregate_ms = 0;
+    gateway::WorkerConfig worker_config;
 
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--slow") == 0) {
+            slow_mode = true;
+        } else if (std::strcmp(argv[i], "--async") == 0) {
+            async_sink = true;
+        } else if (std::strcmp(argv[i], "--drr") == 0) {
+            scheduler = gateway::SchedulerMode::DeficitRoundRobin;
+        } else if (std::strcmp(argv[i], "--lanes") == 0) {
+            lanes = gateway::LanePolicy::StrictPriority;
+        } else if (std::strcmp(argv[i], "--io-uring") == 0) {
+            recv_config.backend = gateway::RecvBackend::IoUring;
+        } else if (std::strcmp(argv[i], "--busy-poll") == 0 && i + 1 < argc) {
+            recv_config.busy_poll_us = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--state") == 0 && i + 1 < argc) {
+            state_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--aggregate") == 0 && i + 1 < argc) {
+            aggregate_ms = static_cast<std::uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--pin") == 0) {
+            worker_config.pin_to_cpu = true;
+        } else if (std::strcmp(argv[i], "--numa") == 0) {
+            worker_config.numa_placement = true;
+        } else if (std::strcmp(argv[i], "--nic") == 0 && i + 1 < argc) {
+            worker_config.nic = argv[++i];
+        } else if (std::strcmp(argv[i], "--sink-node") == 0) {
+            worker_config.sink_on_worker_node = true;
+        } else if (std::strcmp(argv[i], "--steer-rx") == 0) {
+            worker_config.steer_by_rx_cpu = true;
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            int n = std::atoi(argv[++i]);
+            worker_config.worker_count = n > 0 ? static_cast<std::size_t>(n) : 1;
         } else {
-            // Unknown message type
-            ++stats.parse_drops;
-            continue;
+            port = static_cast<std::uint16_t>(std::atoi(argv[i]));
         }
+    }
 
-        // Drain forwarder
-        forwarder.drain_one();
+    std::fprintf(stderr, "Starting gateway server on port %u with %zu worker(s)%s%s%s%s%s\n",
+                 port, worker_config.worker_count, slow_mode ? " (slow mode)" : "",
+                 async_sink ? " (async sink)" : "",
+                 scheduler == gateway::SchedulerMode::DeficitRoundRobin ? " (DRR)" : "",
+                 lanes != gateway::LanePolicy::Single ? " (lanes)" : "",
+                 recv_config.backend == gateway::RecvBackend::IoUring ? " (io_uring)" : "");
+
+    // Set up signal handler
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+    std::signal(SIGHUP, reload_handler);
+
+    // Runtime settings shared by all workers as one swappable snapshot
+    gateway::RuntimeConfig initial = default_runtime_config();
+    if (config_path != nullptr && !load_runtime_config(config_path, initial)) {
+        return EXIT_FAILURE;
+    }
+    RuntimeSnapshot runtime_config(initial);
+
+    // Create UDP sockets: one per worker, sharing the port via SO_REUSEPORT
+    std::vector<int> fds;
+    if (worker_config.worker_count == 1) {
+        int fd = gateway::create_udp_socket(port);
+        if (fd >= 0) {
+            fds.push_back(fd);
+        }
+    } else {
+        fds = gateway::create_reuseport_sockets(port, worker_config.worker_count);
+    }
+    if (fds.empty()) {
+        std::fprintf(stderr, "Failed to create UDP socket(s) on port %u\n", port);
+        return EXIT_FAILURE;
+    }
+
+    // Non-blocking so workers observe shutdown between batches
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
 
-        // Print stats every second
+    // Worker CPUs (-1 = unpinned) and their sink threads' CPUs
+    std::vector<int> cpus(fds.size(), -1);
+    std::vector<std::vector<int>> sink_cpus(fds.size());
+    worker_config.sink_on_worker_node = worker_config.sink_on_worker_node && async_sink;
+    if (worker_config.numa_placement) {
+        if (!place_workers(worker_config, cpus, sink_cpus)) {
+            std::fprintf(stderr, "NUMA: no CPU topology found, workers unpinned\n");
+        }
+    } else if (worker_config.pin_to_cpu) {
+        for (std::size_t i = 0; i < cpus.size(); ++i) {
+            cpus[i] = worker_config.first_cpu + static_cast<int>(i);
+        }
+    }
+    if (worker_config.steer_by_rx_cpu && fds.size() > 1) {
+        if (cpus.front() < 0 || !gateway::attach_reuseport_cpu_steering(fds.front(), cpus)) {
+            std::fprintf(stderr, "Steering: unavailable (needs --pin or --numa), "
+                                 "using 4-tuple hash\n");
+        }
+    }
+
+    // One stats block per worker; worker i registers block i itself
+    gateway::StatsRegistry registry(fds.size());
+    std::vector<RuntimeSnapshot::Reader> readers;
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+        auto reader = runtime_config.make_reader();
+        if (!reader) {
+            std::fprintf(stderr, "At most %zu workers are supported\n", RuntimeSnapshot::kMaxReaders);
+            return EXIT_FAILURE;
+        }
+        readers.push_back(std::move(*reader));
+    }
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+        workers.emplace_back(run_worker, i, fds[i], slow_mode, async_sink, scheduler, lanes,
+                             std::cref(recv_config), std::move(readers[i]), state_path, aggregate_ms,
+                             std::cref(worker_config), cpus[i], std::move(sink_cpus[i]),
+                             std::ref(registry));
+    }
+
+    std::fprintf(stderr, "Gateway ready. Press Ctrl+C to stop.\n");
+    std::fprintf(stderr, "Forwarded events will be printed as JSON to stdout.\n\n");
+
+    // Print merged stats every second until shutdown
+    auto last_stats_time = std::chrono::steady_clock::now();
+    while (g_running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
         auto now = std::chrono::steady_clock::now();
         if (now - last_stats_time >= std::chrono::seconds(1)) {
-            print_stats(stats, forwarder, source_limiter);
+            print_stats(registry);
             last_stats_time = now;
         }
+        if (g_reload.exchange(false) && config_path != nullptr) {
+            // Start from the live snapshot so unlisted keys keep their values
+            gateway::RuntimeConfig next = runtime_config.load();
+            if (load_runtime_config(config_path, next)) {
+                std::fprintf(stderr, "Config: reloaded %s (version %lu)\n", config_path,
+                             runtime_config.publish(next));
+            } else {
+                std::fprintf(stderr, "Config: reload failed, keeping version %lu\n",
+                             runtime_config.version());
+            }
+        }
     }
 
-    // Final drain
+    // Workers drain their queues on the way out
     std::fprintf(stderr, "\nShutting down, draining queue...\n");
-    forwarder.drain_all();
+    for (auto& t : workers) {
+        t.join();
+    }
 
     // Final stats
-    print_stats(stats, forwarder, source_limiter);
+    print_stats(registry);
 
-    close(fd);
+    for (int fd : fds) {
+        close(fd);
+    }
     std::fprintf(stderr, "Goodbye.\n");
     return EXIT_SUCCESS;
 }
@@ -4,19 +4,40 @@
 //
 // Usage:
 //   ./traffic_generator [host] [port] [--chaos]
+//   ./traffic_generator [host] [port] --rate PPS [--threads N] [--batch N]
+//                       [--agents N] [--sources N] [--zipf S] [--spoof]
+//                       [--spoof-base A.B.C.D] [--seconds S] [--metrics-percent P]
 //
 // Options:
 //   host   - Target host (default: 127.0.0.1)
 //   port   - Target port (default: 9999)
-//   --chaos - Enable chaos mode (sends malformed data, bursts, etc.)
+//   --chaos - Enable chaos mode (sends malformed data, bursts, retry storms, etc.)
+//
+// High-rate mode (selected by --rate; any of the options below):
+//   --rate PPS          - Total packets/sec, paced per batch (0 = as fast as possible)
+//   --threads N         - Sender threads, each with its own sockets (default: 1)
+//   --batch N           - Datagrams per sendmmsg call (default: 32)
+//   --agents N          - Distinct agent ids agent-000000.. (default: 15)
+//   --sources N         - Distinct source address:port pairs (default: 1)
+//   --zipf S            - Zipf skew over agents and sources (default: 0, uniform)
+//   --spoof             - Raw socket, one spoofed source per packet (CAP_NET_RAW)
+//   --spoof-base ADDR   - First spoofed address (default: 127.1.0.0 for a
+//                         loopback target, else 10.0.0.0)
+//   --seconds S         - Stop after S seconds (default: until Ctrl+C)
+//   --metrics-percent P - Share of metrics vs logs (default: 70)
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
 #include <csignal>
 #include <cstdint>
 #include <cstdio>
@@ -143,7 +164,7 @@ std::string make_metrics_json(Random& rng, const std::string& agent_id, int seq)
 
         // Sometimes add tags
         if (rng.uniform() > 0.7) {
-            json += ",\"tags\":{\"env\":\"prod\",\"region\":\"us-east\"}";
+            json += ",\"t\":{\"env\":\"prod\",\"region\":\"us-east\"}";
         }
 
         json += "}";
@@ -239,6 +260,399 @@ void print_stats(const Stats& stats) {
     std::fprintf(stderr, "-----------------------\n");
 }
 
+// ============================================================================
+// High-rate mode: precomputed packets, sendmmsg, fixed-rate pacing
+//
+// Each sender thread builds a pool of packet templates once, then patches
+// the fixed-width agent id, seq and ts fields in place per send: no
+// per-packet allocation or formatting beyond a few digits. Packets go
+// out in sendmmsg batches, paced per batch against a fixed schedule.
+//
+// Sources: without --spoof, each thread sends from its own set of UDP
+// sockets (one ephemeral port each; one source per batch). With --spoof,
+// a raw socket writes the IPv4/UDP headers itself, so every packet can
+// carry a different source address (needs CAP_NET_RAW).
+// ============================================================================
+
+constexpr std::size_t kAgentDigits = 6;    // "agent-000042": up to 1M agents
+constexpr std::size_t kTsDigits = 13;      // ms since epoch (until year 2286)
+constexpr std::size_t kSeqDigits = 10;     // uint32 range
+constexpr std::size_t kTemplates = 256;    // per thread, power of two
+constexpr std::size_t kMaxAgents = 1'000'000;
+constexpr std::size_t kMaxSocketsPerThread = 1024;
+constexpr std::size_t kMaxSpoofSources = std::size_t{1} << 24;
+constexpr std::size_t kMaxZipfRanks = std::size_t{1} << 22;
+constexpr std::size_t kMaxBatch = 1024;
+
+struct FloodConfig {
+    std::uint64_t rate = 0;              // packets/sec over all threads, 0 = unpaced
+    std::size_t threads = 1;
+    std::size_t batch = 32;              // datagrams per sendmmsg
+    std::size_t agents = 15;
+    std::size_t sources = 1;             // distinct source address:port pairs
+    double zipf = 0.0;                   // skew for agents and sources, 0 = uniform
+    bool spoof = false;
+    std::uint32_t spoof_base = 0;        // first spoofed address (host order)
+    double seconds = 0.0;                // 0 = until interrupted
+    int metrics_percent = 70;
+};
+
+// A precomputed datagram (envelope + body) with the offsets of the fields
+// patched per send. Patches are fixed width, so the envelope length never
+// changes.
+struct PacketTemplate {
+    std::vector<std::byte> bytes;
+    std::size_t agent_offset = 0;        // kAgentDigits
+    std::size_t ts_offset = 0;           // kTsDigits
+    std::size_t seq_offset = 0;          // kSeqDigits (metrics only)
+    bool metrics = false;
+};
+
+// Write `value` as exactly `width` digits: zero-padded, or left-aligned
+// and space-padded (a JSON number may be followed by whitespace)
+void write_digits(std::byte* out, std::size_t width, std::uint64_t value, bool space_pad) {
+    char digits[20];
+    std::size_t n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0 && n < width);
+    if (space_pad) {
+        for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<std::byte>(digits[n - 1 - i]);
+        for (std::size_t i = n; i < width; ++i) out[i] = std::byte{' '};
+    } else {
+        for (std::size_t i = 0; i < width - n; ++i) out[i] = std::byte{'0'};
+        for (std::size_t i = 0; i < n; ++i) out[width - n + i] = static_cast<std::byte>(digits[n - 1 - i]);
+    }
+}
+
+PacketTemplate make_template(Random& rng, bool metrics) {
+    const std::string agent = "agent-" + std::string(kAgentDigits, '0');
+    const std::string ts(kTsDigits, '0');
+    PacketTemplate tpl;
+    tpl.metrics = metrics;
+
+    std::string body;
+    std::size_t agent_pos = 0;
+    std::size_t ts_pos = 0;
+    std::size_t seq_pos = 0;
+    if (metrics) {
+        body = "{\"agent_id\":\"";
+        agent_pos = body.size() + 6;
+        body += agent + "\",\"seq\":";
+        seq_pos = body.size();
+        body += std::string(kSeqDigits, ' ') + ",\"ts\":";
+        ts_pos = body.size();
+        body += ts + ",\"metrics\":[";
+        const int metric_count = rng.range(1, 5);
+        for (int i = 0; i < metric_count; ++i) {
+            if (i > 0) body += ",";
+            body += "{\"n\":\"" + rng.pick(METRIC_NAMES) + "\",\"v\":" + std::to_string(rng.uniform() * 1000);
+            if (rng.uniform() > 0.5) {
+                body += ",\"u\":\"bytes\"";
+            }
+            if (rng.uniform() > 0.7) {
+                body += ",\"t\":{\"env\":\"prod\",\"region\":\"us-east\"}";
+            }
+            body += "}";
+        }
+        body += "]}";
+    } else {
+        body = "ts=";
+        ts_pos = body.size();
+        body += ts + " level=" + rng.pick(LOG_LEVELS) + " agent=";
+        agent_pos = body.size() + 6;
+        body += agent + " msg=\"" + rng.pick(LOG_MESSAGES) + "\"";
+        if (rng.uniform() > 0.5) {
+            body += " request_id=req-" + std::to_string(rng.range(1000, 9999));
+        }
+    }
+
+    tpl.bytes = make_envelope(body);
+    tpl.agent_offset = 2 + agent_pos;
+    tpl.ts_offset = 2 + ts_pos;
+    tpl.seq_offset = 2 + seq_pos;
+    return tpl;
+}
+
+// Index distribution over [0, n), shared read-only by all threads.
+// Uniform: sequential spray (every index once per n draws, the worst case
+// for an LRU table) or uniformly random. Zipf(s): inverse CDF over at most
+// kMaxZipfRanks ranks, rank 0 hottest.
+class IndexDistribution {
+public:
+    IndexDistribution(std::size_t n, double zipf) : n_(std::max<std::size_t>(n, 1)) {
+        if (zipf > 0.0) {
+            cdf_.resize(std::min(n_, kMaxZipfRanks));
+            double sum = 0.0;
+            for (std::size_t k = 0; k < cdf_.size(); ++k) {
+                sum += 1.0 / std::pow(static_cast<double>(k + 1), zipf);
+                cdf_[k] = sum;
+            }
+            for (double& c : cdf_) c /= sum;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return n_; }
+
+    // `counter` drives the spray; `random` is a uniform 64-bit draw
+    [[nodiscard]] std::size_t pick(std::uint64_t counter, std::uint64_t random, bool spray) const noexcept {
+        if (cdf_.empty()) {
+            return static_cast<std::size_t>((spray ? counter : random) % n_);
+        }
+        const double u = static_cast<double>(random >> 11) * 0x1.0p-53;
+        const auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+        return std::min<std::size_t>(static_cast<std::size_t>(it - cdf_.begin()), cdf_.size() - 1);
+    }
+
+private:
+    std::size_t n_;
+    std::vector<double> cdf_;
+};
+
+// xorshift64*: a few ns per draw, enough for traffic shaping
+struct FastRandom {
+    std::uint64_t state;
+    std::uint64_t next() noexcept {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+};
+
+struct alignas(64) SenderCounters {
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> errors{0};
+};
+
+// Send msgs[0, count) on fd, retrying partial sends. Returns datagrams sent.
+std::size_t send_batch(int fd, mmsghdr* msgs, std::size_t count) {
+#if defined(__linux__)
+    std::size_t done = 0;
+    while (done < count) {
+        const int n = sendmmsg(fd, msgs + done, static_cast<unsigned int>(count - done), 0);
+        if (n <= 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    return done;
+#else
+    std::size_t done = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (sendmsg(fd, &msgs[i].msg_hdr, 0) >= 0) {
+            ++done;
+        }
+    }
+    return done;
+#endif
+}
+
+void run_flood_thread(std::size_t index, const FloodConfig& config, const sockaddr_in& dest,
+                      const IndexDistribution& agents, const IndexDistribution& sources,
+                      SenderCounters& counters) {
+    Random rng;
+    FastRandom fast{0x9E3779B97F4A7C15ULL * (index + 1)};
+
+    std::vector<PacketTemplate> templates;
+    templates.reserve(kTemplates);
+    for (std::size_t i = 0; i < kTemplates; ++i) {
+        templates.push_back(make_template(rng, rng.range(0, 99) < config.metrics_percent));
+    }
+    // Per-agent seq: thread t sends t, t + threads, ... so seqs never collide
+    std::vector<std::uint32_t> agent_seqs(agents.size(), 0);
+
+    // Sockets: one raw socket, or this thread's share of source ports
+    std::vector<int> fds;
+    if (config.spoof) {
+        const int fd = socket(AF_INET, SOCK_RAW, IPPROTO_RAW);  // implies IP_HDRINCL
+        if (fd < 0) {
+            std::fprintf(stderr, "Thread %zu: raw socket failed (--spoof needs CAP_NET_RAW): %s\n",
+                         index, std::strerror(errno));
+            return;
+        }
+        fds.push_back(fd);
+    } else {
+        const std::size_t share = (sources.size() + config.threads - 1) / config.threads;
+        for (std::size_t i = 0; i < std::min(share, kMaxSocketsPerThread); ++i) {
+            const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if (fd < 0) {
+                break;  // out of descriptors: fewer distinct sources
+            }
+            fds.push_back(fd);
+        }
+        if (fds.empty()) {
+            std::fprintf(stderr, "Thread %zu: failed to create socket\n", index);
+            return;
+        }
+    }
+
+    // Raw mode prepends a 28-byte IPv4 + UDP header per message
+    struct RawHeader {
+        ip iph;
+        udphdr udph;
+    };
+    static_assert(sizeof(RawHeader) == 28, "IPv4 + UDP header without padding");
+    std::vector<RawHeader> headers(config.batch);
+    std::vector<iovec> iovs(config.batch * 2);
+    std::vector<mmsghdr> msgs(config.batch);
+    sockaddr_in dest_copy = dest;
+    for (std::size_t i = 0; i < config.batch; ++i) {
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_name = &dest_copy;
+        msgs[i].msg_hdr.msg_namelen = sizeof(dest_copy);
+        if (config.spoof) {
+            RawHeader& h = headers[i];
+            h = RawHeader{};
+            h.iph.ip_v = 4;
+            h.iph.ip_hl = 5;
+            h.iph.ip_ttl = 64;
+            h.iph.ip_p = IPPROTO_UDP;
+            h.iph.ip_dst = dest.sin_addr;
+            h.udph.uh_dport = dest.sin_port;  // kernel fills ip_len, ip_id, ip_sum
+            iovs[2 * i].iov_base = &h;
+            iovs[2 * i].iov_len = sizeof(RawHeader);
+            msgs[i].msg_hdr.msg_iov = &iovs[2 * i];
+            msgs[i].msg_hdr.msg_iovlen = 2;
+        } else {
+            msgs[i].msg_hdr.msg_iov = &iovs[2 * i + 1];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    // This thread's share of the rate; pace whole batches against the schedule
+    const std::uint64_t thread_rate = config.rate / config.threads +
+        (index < config.rate % config.threads ? 1 : 0);
+    const double batch_interval_ns = thread_rate == 0 ? 0.0
+        : static_cast<double>(config.batch) * 1e9 / static_cast<double>(thread_rate);
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(config.seconds));
+
+    std::uint64_t next_template = 0;
+    std::uint64_t source_counter = index;
+    std::byte ts_digits[kTsDigits];
+
+    for (std::uint64_t batch_no = 0; g_running; ++batch_no) {
+        auto now = std::chrono::steady_clock::now();
+        if (config.seconds > 0 && now >= deadline) {
+            break;
+        }
+        if (batch_interval_ns > 0) {
+            const auto due = start + std::chrono::nanoseconds(
+                static_cast<std::int64_t>(static_cast<double>(batch_no) * batch_interval_ns));
+            if (due - now > std::chrono::microseconds(200)) {
+                std::this_thread::sleep_for(due - now - std::chrono::microseconds(100));
+            }
+            while (std::chrono::steady_clock::now() < due) {
+            }
+        }
+
+        // One timestamp per batch
+        write_digits(ts_digits, kTsDigits, now_ms(), false);
+
+        for (std::size_t i = 0; i < config.batch; ++i) {
+            PacketTemplate& tpl = templates[next_template++ & (kTemplates - 1)];
+            std::byte* bytes = tpl.bytes.data();
+            const std::size_t agent = agents.pick(fast.next(), fast.next(), false);
+            write_digits(bytes + tpl.agent_offset, kAgentDigits, agent, false);
+            std::memcpy(bytes + tpl.ts_offset, ts_digits, kTsDigits);
+            if (tpl.metrics) {
+                const std::uint32_t seq = agent_seqs[agent]++ * static_cast<std::uint32_t>(config.threads) +
+                                          static_cast<std::uint32_t>(index);
+                write_digits(bytes + tpl.seq_offset, kSeqDigits, seq, true);
+            }
+            iovs[2 * i + 1].iov_base = bytes;
+            iovs[2 * i + 1].iov_len = tpl.bytes.size();
+
+            if (config.spoof) {
+                const std::size_t source = sources.pick(source_counter, fast.next(), true);
+                source_counter += config.threads;
+                RawHeader& h = headers[i];
+                h.iph.ip_src.s_addr = htonl(config.spoof_base + static_cast<std::uint32_t>(source));
+                h.udph.uh_sport = htons(static_cast<std::uint16_t>(10000 + source % 50000));
+                h.udph.uh_ulen = htons(static_cast<std::uint16_t>(sizeof(udphdr) + tpl.bytes.size()));
+                h.udph.uh_sum = 0;  // optional over IPv4
+            }
+        }
+
+        int fd = fds[0];
+        if (!config.spoof) {
+            // Source indices t, t + threads, ... map onto this thread's sockets
+            fd = fds[sources.pick(source_counter, fast.next(), true) / config.threads % fds.size()];
+            source_counter += config.threads;
+        }
+        const std::size_t sent = send_batch(fd, msgs.data(), config.batch);
+        counters.sent.fetch_add(sent, std::memory_order_relaxed);
+        counters.errors.fetch_add(config.batch - sent, std::memory_order_relaxed);
+    }
+
+    for (int fd : fds) {
+        close(fd);
+    }
+}
+
+int run_flood(const FloodConfig& config, const sockaddr_in& dest) {
+    const IndexDistribution agents(config.agents, config.zipf);
+    const IndexDistribution sources(config.sources, config.zipf);
+
+    std::fprintf(stderr, "High-rate mode: %zu thread(s), batch %zu, %s, %zu agents, %zu sources%s%s\n",
+                 config.threads, config.batch,
+                 config.rate == 0 ? "unpaced" : (std::to_string(config.rate) + " pkt/s").c_str(),
+                 config.agents, config.sources, config.spoof ? " (spoofed)" : "",
+                 config.zipf > 0 ? (", zipf " + std::to_string(config.zipf)).c_str() : "");
+    if (!config.spoof && config.sources > config.threads * kMaxSocketsPerThread) {
+        std::fprintf(stderr, "Note: at most %zu sockets per thread without --spoof\n", kMaxSocketsPerThread);
+    }
+
+    std::vector<SenderCounters> counters(config.threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < config.threads; ++t) {
+        threads.emplace_back(run_flood_thread, t, std::cref(config), std::cref(dest), std::cref(agents),
+                             std::cref(sources), std::ref(counters[t]));
+    }
+
+    auto total = [&counters](auto field) {
+        std::uint64_t sum = 0;
+        for (const auto& c : counters) sum += (c.*field).load(std::memory_order_relaxed);
+        return sum;
+    };
+
+    // Report the achieved rate once per second until every sender exits
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t last_sent = 0;
+    std::atomic<std::size_t> running{config.threads};
+    std::thread joiner([&threads, &running] {
+        for (auto& t : threads) {
+            t.join();
+            --running;
+        }
+    });
+    auto last = start;
+    while (running.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last >= std::chrono::seconds(1)) {
+            const std::uint64_t sent = total(&SenderCounters::sent);
+            std::fprintf(stderr, "Sent %lu (%.0f pkt/s), errors %lu\n",
+                         static_cast<unsigned long>(sent),
+                         static_cast<double>(sent - last_sent) / std::chrono::duration<double>(now - last).count(),
+                         static_cast<unsigned long>(total(&SenderCounters::errors)));
+            last_sent = sent;
+            last = now;
+        }
+    }
+    joiner.join();
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const std::uint64_t sent = total(&SenderCounters::sent);
+    std::fprintf(stderr, "\nTotal: %lu packets in %.2fs (%.0f pkt/s), %lu send errors\n",
+                 static_cast<unsigned long>(sent), secs, static_cast<double>(sent) / secs,
+                 static_cast<unsigned long>(total(&SenderCounters::errors)));
+    return EXIT_SUCCESS;
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -246,14 +660,58 @@ int main(int argc, char* argv[]) {
     const char* host = "127.0.0.1";
     std::uint16_t port = 9999;
     bool chaos_mode = false;
+    bool flood_mode = false;
+    bool spoof_base_set = false;
+    FloodConfig flood;
 
+    int positional = 0;
     for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
         if (std::strcmp(argv[i], "--chaos") == 0) {
             chaos_mode = true;
-        } else if (i == 1 && argv[i][0] != '-') {
+        } else if (std::strcmp(argv[i], "--rate") == 0 && has_value) {
+            flood.rate = std::strtoull(argv[++i], nullptr, 10);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            flood.threads = std::max<std::size_t>(std::strtoull(argv[++i], nullptr, 10), 1);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--batch") == 0 && has_value) {
+            flood.batch = std::clamp<std::size_t>(std::strtoull(argv[++i], nullptr, 10), 1, kMaxBatch);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--agents") == 0 && has_value) {
+            flood.agents = std::clamp<std::size_t>(std::strtoull(argv[++i], nullptr, 10), 1, kMaxAgents);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--sources") == 0 && has_value) {
+            flood.sources = std::clamp<std::size_t>(std::strtoull(argv[++i], nullptr, 10), 1, kMaxSpoofSources);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--zipf") == 0 && has_value) {
+            flood.zipf = std::max(std::strtod(argv[++i], nullptr), 0.0);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--spoof") == 0) {
+            flood.spoof = true;
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--spoof-base") == 0 && has_value) {
+            in_addr base{};
+            if (inet_pton(AF_INET, argv[++i], &base) <= 0) {
+                std::fprintf(stderr, "Invalid address: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            flood.spoof_base = ntohl(base.s_addr);
+            spoof_base_set = true;
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && has_value) {
+            flood.seconds = std::strtod(argv[++i], nullptr);
+            flood_mode = true;
+        } else if (std::strcmp(argv[i], "--metrics-percent") == 0 && has_value) {
+            flood.metrics_percent = std::clamp(std::atoi(argv[++i]), 0, 100);
+        } else if (argv[i][0] != '-' && positional == 0) {
             host = argv[i];
-        } else if (i == 2 && argv[i][0] != '-') {
+            ++positional;
+        } else if (argv[i][0] != '-' && positional == 1) {
             port = static_cast<std::uint16_t>(std::atoi(argv[i]));
+            ++positional;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return EXIT_FAILURE;
         }
     }
 
@@ -281,9 +739,19 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+    if (flood_mode) {
+        close(fd);
+        if (flood.spoof && !spoof_base_set) {
+            const bool loopback = (ntohl(dest_addr.sin_addr.s_addr) >> 24) == 127;
+            flood.spoof_base = loopback ? 0x7F010000u : 0x0A000000u;
+        }
+        return run_flood(flood, dest_addr);
+    }
+
     Random rng;
     Stats stats;
     std::vector<int> agent_seqs(AGENTS.size(), 0);
+    std::vector<std::byte> last_metrics;  // replayed by chaos retry storms
 
     auto last_stats_time = std::chrono::steady_clock::now();
     int burst_counter = 0;
@@ -331,6 +799,7 @@ int main(int argc, char* argv[]) {
             if (rng.uniform() < 0.7) {
                 // 70% metrics
                 packet = make_envelope(make_metrics_json(rng, agent, seq++));
+                last_metrics = packet;
                 ++stats.metrics_sent;
             } else {
                 // 30% logs
@@ -364,6 +833,18 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        // In chaos mode, occasionally resend one datagram like an agent in
+        // a retry storm (same agent_id and seq; gateway drops the copies)
+        if (chaos_mode && !last_metrics.empty() && rng.uniform() < 0.02) {
+            std::fprintf(stderr, "[CHAOS] Replaying the last metrics datagram 20 times\n");
+            for (int i = 0; i < 20 && g_running; ++i) {
+                sendto(fd, last_metrics.data(), last_metrics.size(), 0,
+                       reinterpret_cast<struct sockaddr*>(&dest_addr),
+                       sizeof(dest_addr));
+                ++stats.chaos_sent;
+            }
+        }
+
         // Print stats every second
         auto now = std::chrono::steady_clock::now();
         if (now - last_stats_time >= std::chrono::seconds(1)) {
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "gateway/config.hpp"
+#include "gateway/hash_index.hpp"
+#include "gateway/source_limiter.hpp"  // Admit, Clock
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// AgentLimiter: per-agent rate limiting after validation (TB-4.5)
+//
+// SourceLimiter keys on (ip, port), which a sender evades by rotating
+// source ports; AgentQuotaTracker bounds queue share, not rate. This tier
+// keys on the validated agent_id with memory fixed at construction, so
+// inventing agent ids cannot grow state:
+//
+// - Count-min sketch (sketch_depth rows x sketch_width counters) of each
+//   agent's recent event count, updated conservatively (only the minimal
+//   rows are incremented). Counts decay lazily: each counter carries the
+//   epoch (decay_ms interval) it was last touched in and is halved once
+//   per elapsed epoch when next read, so there is no periodic sweep.
+// - Heavy-hitter table (heavy_hitters entries): an agent whose estimate
+//   exceeds burst_tokens is promoted into it and from then on gets an
+//   exact token bucket (tokens_per_sec, burst_tokens) with an empty
+//   start. Agents below the threshold are admitted without a bucket.
+//   When the table is full, promotion evicts the entry with the most
+//   tokens (the least constrained agent); an evicted agent that keeps
+//   flooding is re-promoted at once because its sketch count stays high.
+//
+// Agents are identified by a seeded 64-bit hash of the id, so colliding
+// ids cannot be chosen without the seed. Sketch over-estimates (never
+// under-estimates) counts: a quiet agent sharing counters with a flood
+// can be promoted early, after which its exact bucket still admits it at
+// tokens_per_sec.
+//
+// Cost per admit(): one hash of the id (<= 64 bytes), sketch_depth
+// counter updates and one heavy-table probe; a promotion into a full
+// table also scans heavy_hitters entries, at most once per burst_tokens
+// events of one agent. admit() never allocates.
+//
+// Thread safety: NOT thread-safe. One instance per worker.
+// ============================================================================
+
+class AgentLimiter {
+public:
+    static constexpr std::size_t kMaxDepth = 8;
+
+    explicit AgentLimiter(AgentLimiterConfig config = {}, Clock clock = default_clock);
+
+    // Count one event for the agent and decide it. Reads the clock once.
+    Admit admit(std::string_view agent_id);
+
+    // Same, with a caller-supplied timestamp (e.g., one read per batch)
+    Admit admit(std::string_view agent_id, std::chrono::steady_clock::time_point now) noexcept;
+
+    // Apply new rates in place (tokens_per_sec, burst_tokens, decay_ms);
+    // sketch and table sizes stay as constructed. Heavy buckets are kept
+    // (clamped to the new burst); a decay_ms change clears the sketch.
+    void reconfigure(const AgentLimiterConfig& config) noexcept;
+
+    [[nodiscard]] const AgentLimiterConfig& config() const noexcept { return config_; }
+
+    // Current (decayed) sketch estimate of the agent's event count
+    [[nodiscard]] std::uint32_t estimate(std::string_view agent_id,
+                                         std::chrono::steady_clock::time_point now) const noexcept;
+
+    // True if the agent currently has an exact bucket
+    [[nodiscard]] bool is_heavy(std::string_view agent_id) const noexcept;
+
+    [[nodiscard]] std::size_t heavy_count() const noexcept { return heavy_count_; }
+    [[nodiscard]] std::size_t heavy_capacity() const noexcept { return heavy_.size(); }
+
+    // Fixed state size: sketch + heavy table + its index
+    [[nodiscard]] std::size_t memory_bytes() const noexcept;
+
+    // Metrics
+    [[nodiscard]] std::uint64_t total_admits() const noexcept { return total_admits_; }
+    [[nodiscard]] std::uint64_t total_drops() const noexcept { return total_drops_; }
+    [[nodiscard]] std::uint64_t promotions() const noexcept { return promotions_; }
+    [[nodiscard]] std::uint64_t heavy_evictions() const noexcept { return heavy_evictions_; }
+
+private:
+    static constexpr std::uint32_t kNil = HashIndex::kNil;
+    static constexpr std::uint64_t kTokenScale = 1'000'000'000;  // nano-tokens
+
+    struct Counter {
+        std::uint32_t count = 0;
+        std::uint32_t epoch = 0;  // decay interval of the last update
+    };
+
+    struct Heavy {
+        std::uint64_t fingerprint = 0;  // hash of the agent id
+        std::uint64_t tokens = 0;       // nano-tokens
+        std::int64_t last_ns = 0;       // time of last refill
+    };
+
+    [[nodiscard]] std::uint64_t hash(std::string_view agent_id) const noexcept;
+    [[nodiscard]] std::uint32_t epoch_of(std::int64_t now_ns) const noexcept;
+    [[nodiscard]] std::size_t counter_index(std::uint64_t h, std::size_t row) const noexcept;
+    [[nodiscard]] static std::uint32_t decayed(const Counter& c, std::uint32_t epoch) noexcept;
+
+    // Conservative update; returns the new estimate
+    std::uint32_t sketch_add(std::uint64_t h, std::uint32_t epoch) noexcept;
+
+    // Heavy index slot holding `fingerprint`, or the empty slot for it
+    [[nodiscard]] std::size_t find_heavy(std::uint64_t fingerprint) const noexcept;
+    [[nodiscard]] std::size_t heavy_home(std::uint64_t fingerprint) const noexcept;
+    std::uint32_t promote(std::uint64_t fingerprint, std::int64_t now_ns) noexcept;
+    void refill(Heavy& heavy, std::int64_t now_ns) const noexcept;
+
+    AgentLimiterConfig config_;
+    Clock clock_;
+    std::uint64_t seed_;
+    std::uint64_t burst_;            // burst_tokens in nano-tokens
+    std::int64_t full_refill_ns_;    // time to refill an empty bucket
+    std::int64_t decay_ns_;
+
+    std::size_t width_mask_;
+    std::size_t depth_;
+    std::vector<Counter> sketch_;    // depth_ rows of width_mask_ + 1
+
+    std::vector<Heavy> heavy_;
+    HashIndex heavy_index_;          // heavy_ index or kNil
+    std::size_t heavy_count_ = 0;
+
+    // Metrics
+    std::uint64_t total_admits_ = 0;
+    std::uint64_t total_drops_ = 0;
+    std::uint64_t promotions_ = 0;
+    std::uint64_t heavy_evictions_ = 0;
+};
+
+}  // namespace gateway
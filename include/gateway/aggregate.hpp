@@ -0,0 +1,169 @@
+#pragma once
+
+#include "gateway/config.hpp"
+#include "gateway/hash_index.hpp"
+#include "gateway/parse_metrics.hpp"     // Metric, MetricTag
+#include "gateway/validate_metrics.hpp"  // ValidatedMetrics
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gateway {
+
+// One series of a flushed window. Views point into the aggregator's
+// arena and stay valid until the RollupSink returns.
+struct RollupSeries {
+    std::string_view name;
+    std::string_view unit;            // empty if absent
+    std::span<const MetricTag> tags;  // sorted by key, then value
+    std::uint64_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+    double p50 = 0;                   // quantiles: only with AggregatorConfig::quantiles
+    double p90 = 0;
+    double p99 = 0;
+};
+
+// All series of one agent in a flushed window (serialize_rollup())
+struct RollupEvent {
+    std::string_view agent_id;
+    std::uint64_t ts = 0;             // window start (wall clock ms)
+    std::uint64_t interval_ms = 0;    // window length
+    bool quantiles = false;           // p50/p90/p99 are set
+    std::span<const RollupSeries> series;
+};
+
+// ============================================================================
+// MetricsAggregator: windowed rollups of validated metrics (after TB-4)
+//
+// Folds each Metric into a per-series count/sum/min/max, keyed by
+// (agent_id, name, unit, tags sorted by key then value), so tag order in
+// the datagram does not split a series. flush() hands out one
+// RollupEvent per agent and starts a new window; the caller flushes on
+// its own interval.
+//
+// Storage is fixed at construction and reused every window:
+// - series table: dense array of at most max_series entries, indexed by
+//   a HashIndex, hashed with a per-process seed (names and tags are
+//   attacker-chosen)
+// - agent table: same layout, max_agents entries, with the per-agent
+//   series count for max_series_per_agent
+// - arena: bump allocator for the agent ids, names, units and tags of
+//   new series (copied once per window, since the input views die with
+//   the datagram); reset by flush()
+// - quantiles (optional): 193 log-spaced buckets per series, 4 per
+//   octave over (2^-10, 2^38], ~12% relative error; values <= 2^-10
+//   (including zero and negatives) share the lowest bucket, reported as
+//   the series min. Estimates are clamped to [min, max].
+// A metric whose new series would exceed a cap or the arena is dropped
+// and counted; existing series keep folding. Non-finite values fold per
+// IEEE rules and serialize as null.
+//
+// Cost: add() is O(tags) per metric (sort of <= kMaxTags tags, one hash,
+// one probe) and never allocates. flush() is O(max_series + max_agents),
+// plus O(buckets) per series with quantiles; it allocates nothing itself.
+//
+// Thread safety: NOT thread-safe. One instance per worker.
+// ============================================================================
+
+class MetricsAggregator {
+public:
+    static constexpr std::size_t kQuantileBuckets = 1 + 48 * 4;
+
+    using RollupSink = std::function<void(const RollupEvent&)>;
+
+    explicit MetricsAggregator(AggregatorConfig config = {});
+
+    // Fold every metric of one message. `now_ms` (wall clock) opens the
+    // window if it is empty. Returns the number of metrics dropped by caps.
+    std::size_t add(const ValidatedMetrics& metrics, std::uint64_t now_ms) noexcept;
+
+    // Emit the current window, one event per agent that has series, then
+    // clear it. Returns the number of series emitted.
+    std::size_t flush(std::uint64_t now_ms, const RollupSink& emit);
+
+    [[nodiscard]] std::size_t series_count() const noexcept { return series_count_; }
+    [[nodiscard]] std::size_t agent_count() const noexcept { return agent_count_; }
+    [[nodiscard]] std::size_t arena_used() const noexcept { return arena_used_; }
+    [[nodiscard]] const AggregatorConfig& config() const noexcept { return config_; }
+
+    // Metrics
+    [[nodiscard]] std::uint64_t folded() const noexcept { return folded_; }
+    [[nodiscard]] std::uint64_t dropped_cardinality() const noexcept { return dropped_cardinality_; }
+    [[nodiscard]] std::uint64_t dropped_arena() const noexcept { return dropped_arena_; }
+
+private:
+    static constexpr std::uint32_t kNil = HashIndex::kNil;
+
+    struct Series {
+        std::uint64_t hash = 0;
+        std::uint32_t agent = 0;          // agents_ index
+        std::uint32_t tag_count = 0;
+        std::string_view name;            // arena
+        std::string_view unit;            // arena
+        const MetricTag* tags = nullptr;  // arena, sorted
+        std::uint64_t count = 0;
+        double sum = 0;
+        double min = 0;
+        double max = 0;
+    };
+
+    struct Agent {
+        std::uint64_t hash = 0;
+        std::string_view id;              // arena
+        std::uint32_t series = 0;         // series in this window
+    };
+
+    // agents_ index for the id, interning it if new; kNil if the table
+    // (arena_full == false) or the arena (arena_full == true) is full
+    std::uint32_t intern_agent(std::string_view agent_id, bool& arena_full) noexcept;
+
+    // Fold one metric whose tags are already sorted
+    bool fold(std::uint32_t agent, const Metric& metric, std::span<const MetricTag* const> tags) noexcept;
+
+    [[nodiscard]] bool matches(const Series& s, std::uint32_t agent, const Metric& metric,
+                               std::span<const MetricTag* const> tags) const noexcept;
+
+    // Bump allocations; clear `ok` when the arena is full
+    std::string_view arena_copy(std::string_view s, bool& ok) noexcept;
+    MetricTag* arena_tags(std::size_t count, bool& ok) noexcept;
+
+    [[nodiscard]] static std::size_t bucket_of(double v) noexcept;
+    [[nodiscard]] double quantile(const std::uint32_t* buckets, const Series& s, double q) const noexcept;
+
+    void reset_window() noexcept;
+
+    AggregatorConfig config_;
+    std::uint64_t seed_;
+
+    std::vector<Series> series_;
+    HashIndex series_index_;                   // series_ index or kNil
+    std::size_t series_count_ = 0;
+
+    std::vector<Agent> agents_;
+    HashIndex agent_index_;                    // agents_ index or kNil
+    std::size_t agent_count_ = 0;
+
+    std::vector<std::byte> arena_;
+    std::size_t arena_used_ = 0;
+
+    std::vector<std::uint32_t> buckets_;       // max_series * kQuantileBuckets, if quantiles
+
+    // flush() scratch: series grouped by agent
+    std::vector<RollupSeries> scratch_;
+    std::vector<std::uint32_t> agent_offsets_;
+
+    std::uint64_t window_start_ms_ = 0;
+
+    // Metrics
+    std::uint64_t folded_ = 0;
+    std::uint64_t dropped_cardinality_ = 0;
+    std::uint64_t dropped_arena_ = 0;
+};
+
+}  // namespace gateway
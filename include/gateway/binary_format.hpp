@@ -0,0 +1,72 @@
+#pragma once
+
+#include "gateway/parse_log.hpp"
+#include "gateway/parse_metrics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace gateway {
+
+// ============================================================================
+// TB-3 Binary body format (v1), alongside JSON and logfmt.
+//
+// Selected by the first body byte: the magics are >= 0x80, which no text
+// body can start with ('{', whitespace or a logfmt key), so the envelope
+// is unchanged and parse_metrics()/parse_log() dispatch on that byte.
+//
+// Integers are big-endian like the envelope; "varint" is unsigned LEB128
+// (at most 5 bytes); strings are varint length + bytes.
+//
+// Metrics: 0xB1 version:u8 seq:u32 ts:u64 agent_id:str count:varint
+//          metric*
+//   metric: name_ref:varint [name bytes] value:f64 unit:str
+//           tag_count:varint (key:str value:str)*
+//   name_ref even: inline name of name_ref / 2 bytes follows
+//   name_ref odd:  same name as metric (name_ref / 2) earlier in this
+//                  message (no bytes follow)
+//   value: IEEE-754 binary64 bits, so no text round trip
+//
+// Log:     0xB2 version:u8 ts:u64 level:u8 agent:str msg:str
+//          field_count:varint (key:str value:str)*
+//   level: LogLevel value; agent: empty = absent
+//   fields: extra fields only (ts/level/msg/agent have their own slots),
+//   so ParsedLog::fields holds just these for a binary body
+//
+// Invariants: same drop taxonomy and limits as the text parsers
+// (MetricsLimits / LogLimits), every length is checked against both the
+// limit and the remaining bytes before use, counts are checked before the
+// loop they bound, and the body must end exactly after the last record.
+// ============================================================================
+
+struct BinaryFormat {
+    static constexpr std::uint8_t kMetricsMagic = 0xB1;
+    static constexpr std::uint8_t kLogMagic = 0xB2;
+    static constexpr std::uint8_t kVersion = 1;
+    static constexpr std::size_t kMaxVarintBytes = 5;
+};
+
+// True if the body starts with one of the binary magics
+constexpr bool is_binary_body(std::span<const std::byte> body) noexcept {
+    return !body.empty() && std::to_integer<std::uint8_t>(body[0]) >= 0x80;
+}
+
+// Decode a binary metrics / log body into the caller's scratch object.
+// Same contract as the text parse-into overloads; views point into input.
+std::optional<MetricsDropReason> parse_binary_metrics(std::span<const std::byte> input,
+                                                      ParsedMetrics& out) noexcept;
+std::optional<LogDropReason> parse_binary_log(std::span<const std::byte> input,
+                                              ParsedLog& out) noexcept;
+
+// Encode into `out` (for agents and tests). Returns the bytes written, or
+// 0 if `out` is too small or a length/count exceeds its limit. Metric
+// names repeated within the message are written as back-references; log
+// fields named ts/level/msg/agent are skipped (they are encoded from the
+// dedicated members).
+std::size_t encode_binary_metrics(const ParsedMetrics& metrics,
+                                  std::span<std::byte> out) noexcept;
+std::size_t encode_binary_log(const ParsedLog& log, std::span<std::byte> out) noexcept;
+
+}  // namespace gateway
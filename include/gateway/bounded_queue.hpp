@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace gateway {
@@ -18,7 +19,7 @@ enum class PushResult : std::uint8_t {
 // unbounded growth.
 //
 // Thread safety: NOT thread-safe. External synchronization required
-// for concurrent access.
+// for concurrent access. See ring_queue.hpp for SPSC/MPSC variants.
 //
 // Template parameter T must be movable.
 template <typename T>
@@ -56,6 +57,39 @@ public:
         return item;
     }
 
+    // Pop into `out` (no optional wrapper). Returns false if empty.
+    bool try_pop(T& out) noexcept {
+        if (size_ == 0) {
+            return false;
+        }
+        out = std::move(buffer_[head_]);
+        head_ = (head_ + 1) % capacity_;
+        --size_;
+        return true;
+    }
+
+    // Push as many items as fit, moving them out of `items` in order.
+    // Items that do not fit are dropped (counted in drop_count).
+    // Returns the number pushed.
+    std::size_t try_push_n(std::span<T> items) noexcept {
+        std::size_t pushed = 0;
+        for (auto& item : items) {
+            if (try_push(std::move(item)) == PushResult::Ok) {
+                ++pushed;
+            }
+        }
+        return pushed;
+    }
+
+    // Pop up to out.size() items in FIFO order. Returns the number popped.
+    std::size_t try_pop_n(std::span<T> out) noexcept {
+        std::size_t popped = 0;
+        while (popped < out.size() && try_pop(out[popped])) {
+            ++popped;
+        }
+        return popped;
+    }
+
     // Peek at the front item without removing it.
     // Returns nullptr if empty.
     const T* peek() const noexcept {
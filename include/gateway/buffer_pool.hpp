@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gateway {
+
+class BufferPool;
+
+// Index of one buffer in a BufferPool
+using BufferIndex = std::uint32_t;
+inline constexpr BufferIndex kNoBuffer = UINT32_MAX;
+
+// Move-only ownership of one fixed-size buffer from a BufferPool.
+// The buffer returns to its pool when the handle is reset or destroyed.
+//
+// Invariant: a handle never outlives the pool it came from.
+class BufferHandle {
+public:
+    BufferHandle() noexcept = default;
+    ~BufferHandle() { reset(); }
+
+    BufferHandle(BufferHandle&& other) noexcept
+        : pool_(other.pool_)
+        , index_(other.index_) {
+        other.pool_ = nullptr;
+    }
+
+    BufferHandle& operator=(BufferHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = other.pool_;
+            index_ = other.index_;
+            other.pool_ = nullptr;
+        }
+        return *this;
+    }
+
+    BufferHandle(const BufferHandle&) = delete;
+    BufferHandle& operator=(const BufferHandle&) = delete;
+
+    // Return the buffer to the pool (no-op if empty)
+    void reset() noexcept;
+
+    // True if this handle owns a buffer
+    explicit operator bool() const noexcept { return pool_ != nullptr; }
+
+    // Full writable extent of the owned buffer (empty if no buffer)
+    [[nodiscard]] std::span<std::byte> bytes() const noexcept;
+
+private:
+    friend class BufferPool;
+    BufferHandle(BufferPool* pool, BufferIndex index) noexcept
+        : pool_(pool)
+        , index_(index) {}
+
+    BufferPool* pool_ = nullptr;
+    BufferIndex index_ = 0;
+};
+
+// Fixed slab of equally sized buffers with an O(1) free list.
+//
+// All memory is allocated once at construction; acquire/release never
+// allocate. Used so datagram bytes stay where the kernel wrote them and
+// later stages work on views over the slab, and for the forwarder's
+// queued payloads.
+//
+// Buffers are handed out either as an owning BufferHandle, or by index
+// (like AgentHandle) for a holder that cannot keep a handle: an index can
+// travel with an event across threads and be released later, in any
+// order, by the pool's thread.
+//
+// Invariants enforced:
+// - Total memory bounded by buffer_count * buffer_bytes (fixed at startup)
+// - Exhaustion is reported (empty handle), never grows the pool
+//
+// Thread safety: NOT thread-safe. Acquire and release on one thread.
+class BufferPool {
+public:
+    BufferPool(std::size_t buffer_count, std::size_t buffer_bytes);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Take a buffer from the pool. Returns an empty handle if exhausted.
+    [[nodiscard]] BufferHandle acquire() noexcept;
+
+    // Same, by index. Returns kNoBuffer if exhausted; the caller must
+    // release() the index exactly once.
+    [[nodiscard]] BufferIndex acquire_index() noexcept;
+    void release(BufferIndex index) noexcept;
+
+    // Full writable extent of an acquired buffer
+    [[nodiscard]] std::span<std::byte> buffer(BufferIndex index) noexcept {
+        return {slab_.data() + static_cast<std::size_t>(index) * buffer_bytes_, buffer_bytes_};
+    }
+
+    // Number of buffers currently free
+    [[nodiscard]] std::size_t available() const noexcept { return free_count_; }
+
+    // Total number of buffers
+    [[nodiscard]] std::size_t capacity() const noexcept { return free_list_.size(); }
+
+    // Size of each buffer
+    [[nodiscard]] std::size_t buffer_bytes() const noexcept { return buffer_bytes_; }
+
+    // Metrics
+    [[nodiscard]] std::uint64_t exhausted_count() const noexcept { return exhausted_count_; }
+
+private:
+    std::size_t buffer_bytes_;
+    std::vector<std::byte> slab_;             // buffer_count * buffer_bytes
+    std::vector<BufferIndex> free_list_;      // stack of free indices
+    std::size_t free_count_;
+    std::uint64_t exhausted_count_ = 0;
+};
+
+inline void BufferHandle::reset() noexcept {
+    if (pool_ != nullptr) {
+        pool_->release(index_);
+        pool_ = nullptr;
+    }
+}
+
+inline std::span<std::byte> BufferHandle::bytes() const noexcept {
+    if (pool_ == nullptr) {
+        return {};
+    }
+    return pool_->buffer(index_);
+}
+
+}  // namespace gateway
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace gateway::chars {
+
+// ============================================================================
+// Shared 256-entry character-class table for the TB-3/TB-4 checks.
+//
+// One constexpr table replaces the per-call range comparisons in agent_id
+// validation, logfmt key validation and JSON digit/whitespace scanning.
+// Independent of locale (unlike <cctype>), and every check is one load
+// and one AND.
+// ============================================================================
+
+enum Class : std::uint8_t {
+    kDigit = 1u << 0,          // [0-9]
+    kAlpha = 1u << 1,          // [a-zA-Z]
+    kAgentIdChar = 1u << 2,    // [a-zA-Z0-9_-]   TB-4 agent_id (after first)
+    kJsonAgentIdChar = 1u << 3, // [a-zA-Z0-9_.-] TB-3 metrics agent_id
+    kLogKeyStart = 1u << 4,    // [a-z_]          logfmt key, first char
+    kLogKeyChar = 1u << 5,     // [a-z0-9_]       logfmt key, rest
+    kJsonSpace = 1u << 6,      // [ \t\n\r]
+    kLogBlank = 1u << 7,       // [ \t]           logfmt field separator
+};
+
+inline constexpr std::array<std::uint8_t, 256> kTable = [] {
+    std::array<std::uint8_t, 256> t{};
+    auto add = [&t](unsigned char c, std::uint8_t cls) { t[c] |= cls; };
+
+    for (unsigned char c = '0'; c <= '9'; ++c) {
+        add(c, kDigit | kAgentIdChar | kJsonAgentIdChar | kLogKeyChar);
+    }
+    for (unsigned char c = 'a'; c <= 'z'; ++c) {
+        add(c, kAlpha | kAgentIdChar | kJsonAgentIdChar | kLogKeyStart | kLogKeyChar);
+    }
+    for (unsigned char c = 'A'; c <= 'Z'; ++c) {
+        add(c, kAlpha | kAgentIdChar | kJsonAgentIdChar);
+    }
+    add('_', kAgentIdChar | kJsonAgentIdChar | kLogKeyStart | kLogKeyChar);
+    add('-', kAgentIdChar | kJsonAgentIdChar);
+    add('.', kJsonAgentIdChar);
+    add(' ', kJsonSpace | kLogBlank);
+    add('\t', kJsonSpace | kLogBlank);
+    add('\n', kJsonSpace);
+    add('\r', kJsonSpace);
+    return t;
+}();
+
+constexpr std::uint8_t classes(char c) noexcept {
+    return kTable[static_cast<unsigned char>(c)];
+}
+
+constexpr bool is(char c, Class cls) noexcept {
+    return (classes(c) & cls) != 0;
+}
+
+// True if every byte of [p, p + n) is in `cls` (vacuously true for n = 0).
+// Branch-free: ANDs the class bytes together and tests once at the end,
+// so it always reads all n bytes; meant for short, bounded fields.
+constexpr bool all_of(const char* p, std::size_t n, Class cls) noexcept {
+    std::uint8_t acc = 0xFF;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc &= classes(p[i]);
+    }
+    return (acc & cls) != 0;
+}
+
+// Length of the leading run of [p, p + n) whose bytes are in `cls`
+constexpr std::size_t span_of(const char* p, std::size_t n, Class cls) noexcept {
+    std::size_t i = 0;
+    while (i < n && is(p[i], cls)) {
+        ++i;
+    }
+    return i;
+}
+
+}  // namespace gateway::chars
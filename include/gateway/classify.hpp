@@ -0,0 +1,82 @@
+#pragma once
+
+#include "gateway/validate_config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+
+namespace gateway {
+
+// ============================================================================
+// Pre-filter: message classification ahead of TB-3
+//
+// One bounded scan decides the body format and picks up the header fields
+// (agent_id, ts), so the full parser only runs on plausible messages and
+// the TB-4 header rules can reject before it:
+// - Metrics: the root object is tokenized with the parser's own grammar
+//   up to the "metrics" key; the array itself is never scanned.
+// - Log: fields are tokenized with the parser's key/quote rules until ts,
+//   level and msg have all been seen.
+// - Binary (binary_format.hpp): magic + version, then ts and agent_id
+//   read from their fixed positions.
+//
+// Invariants:
+// 1. Sound: every PrefilterDrop is a message TB-3/TB-4 would also drop.
+//    Header fields are the last occurrence within the scanned prefix;
+//    TB-3 rejects a repeated JSON root key, so only a log line that
+//    repeats a header key after it can differ.
+// 2. Bounded: O(header bytes) for metrics, O(n) over at most the line
+//    for logs; no allocation. Garbage usually ends at the first byte.
+// 3. Not a substitute for TB-3: an accepted header is still fully parsed.
+// ============================================================================
+
+enum class MessageFormat : std::uint8_t {
+    Metrics,          // JSON object with a root "metrics" key, or binary
+    Log,              // logfmt line with ts, level and msg keys, or binary
+};
+
+// Pre-filter drop reasons (explicit enum, not attacker-controlled)
+enum class PrefilterDrop : std::uint8_t {
+    EmptyInput,             // nothing but whitespace
+    UnknownFormat,          // neither '{', a logfmt key start nor a binary magic
+    Malformed,              // header breaks the format's grammar / layout
+    MissingFormatKey,       // no "metrics" key / no ts+level+msg
+    AgentIdInvalidFormat,   // header agent_id fails ^[a-zA-Z][a-zA-Z0-9_-]*$
+    TimestampTooOld,        // header ts < current_time - max_age_ms
+    TimestampInFuture,      // header ts > current_time + max_future_ms
+};
+
+// Findings carried forward to the parser stage (views into the body)
+struct MessageHeader {
+    MessageFormat format;
+    bool binary = false;              // binary body rather than JSON / logfmt
+    std::string_view agent_id;        // empty if not seen or JSON-escaped
+    std::uint64_t ts = 0;
+    bool has_ts = false;              // ts seen and well-formed
+    std::size_t header_bytes = 0;     // bytes examined by the scan
+};
+
+using ClassifyResult = std::variant<MessageHeader, PrefilterDrop>;
+
+// Classify a message body and extract its header fields.
+//
+// Contract:
+// - Structural drops only (EmptyInput .. MissingFormatKey)
+// - Never throws, never reads past body
+ClassifyResult classify_message(std::span<const std::byte> body) noexcept;
+ClassifyResult classify_message(std::string_view body) noexcept;
+
+// Optional header-only reject: agent_id format (if present) and ts window
+// (if present and non-zero) against the TB-4 rules, before the body is
+// parsed. Missing fields are left to TB-3/TB-4.
+std::optional<PrefilterDrop> check_header(
+    const MessageHeader& header,
+    const TimestampWindow& window,
+    std::uint64_t current_time_ms
+) noexcept;
+
+}  // namespace gateway
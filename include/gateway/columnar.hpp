@@ -0,0 +1,303 @@
+#pragma once
+
+#include "gateway/hash_index.hpp"
+#include "gateway/sink.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// Columnar event blocks (TB-5 egress)
+//
+// Packs many canonical events (serialize_event(), serialize_rollup())
+// into one block, so downstream decodes columns instead of JSON rows.
+//
+// Block (v1):
+//   0xC1 version:u8 flags:u8 body_len:varint [raw_len:varint] body
+//   flags bit 0: body is one LZ4 block (raw_len: its decompressed size)
+//
+//   body: events:varint metric_rows:varint log_rows:varint raw_rows:varint
+//         then kColumnCount columns in Column order, each len:varint bytes
+//
+// "varint" is unsigned LEB128 (up to 10 bytes); "sym" is a varint index
+// into the symbols column, "sym+1" the same with 0 meaning absent; deltas
+// are zigzag varints against the previous row (the first against 0); f64
+// is IEEE-754 binary64, little-endian, so the column can be read in place.
+//
+// Strings are held exactly as they appear between the quotes of the
+// canonical JSON, i.e. JSON-escaped (the gateway bytes, unless they hold
+// '"', '\\' or control bytes). Short, repeated strings (agent ids, names,
+// units, tag keys and values, field keys) go to the per-block symbols
+// dictionary; log messages and field values go to string heaps.
+//
+// Events keep their order: the kind column has one entry per event. A
+// payload that is not a canonical metrics or log event (rollups, or
+// anything else) is carried unchanged as a raw row.
+// ============================================================================
+
+enum class Column : std::uint8_t {
+    Symbols,         // (len:varint bytes)*
+    Kind,            // events x u8 (EventKind)
+    MetricAgent,     // metric_rows x sym
+    MetricSeq,       // metric_rows x delta
+    MetricTs,        // metric_rows x delta
+    MetricCount,     // metric_rows x varint (metrics per row)
+    MetricName,      // M x sym (M = sum of MetricCount)
+    MetricUnit,      // M x sym+1
+    MetricValue,     // M x f64 (NaN for a null value)
+    MetricTagCount,  // M x varint
+    MetricTagKey,    // T x sym (T = sum of MetricTagCount)
+    MetricTagValue,  // T x sym
+    LogAgent,        // log_rows x sym+1
+    LogTs,           // log_rows x delta
+    LogLevel,        // log_rows x u8 (gateway::LogLevel)
+    LogMsgLen,       // log_rows x varint
+    LogMsgHeap,      // bytes
+    LogFieldCount,   // log_rows x varint
+    LogFieldKey,     // F x sym (F = sum of LogFieldCount)
+    LogFieldLen,     // F x varint
+    LogFieldHeap,    // bytes
+    RawLen,          // raw_rows x varint
+    RawHeap,         // bytes
+};
+
+inline constexpr std::size_t kColumnCount = static_cast<std::size_t>(Column::RawHeap) + 1;
+
+enum class EventKind : std::uint8_t { Metrics = 0, Log = 1, Raw = 2 };
+
+struct ColumnarFormat {
+    static constexpr std::uint8_t kMagic = 0xC1;
+    static constexpr std::uint8_t kVersion = 1;
+    static constexpr std::uint8_t kFlagLz4 = 0x01;
+};
+
+struct ColumnarConfig {
+    std::size_t max_block_events = 1024;             // Close a block at this many events
+    std::size_t max_block_bytes = 256 * 1024;        // ... or this many column bytes
+    std::size_t max_symbols = 4096;                  // ... or when the dictionary is full
+    std::chrono::milliseconds max_delay{10};         // ColumnarSink: or when the oldest is this old
+    bool compress = false;                           // LZ4 the body when that saves bytes
+};
+
+// ============================================================================
+// ColumnarEncoder: builds one block at a time
+//
+// add() decodes one canonical payload strictly (the exact key order and
+// number forms serialize_event() writes) into scratch views, then appends
+// to the columns; a payload that does not match is added as a raw row.
+// An event is never half-added: add() returns false, adding nothing, when
+// the block is full (full(), or the event's strings would not fit the
+// dictionary); finish() and add it again, which always succeeds. An event
+// with more strings than max_symbols is added as a raw row. A block can
+// exceed max_block_bytes by at most one event.
+//
+// Storage: column buffers and the dictionary index (a HashIndex with a
+// per-process hash seed) are reused
+// for every block, so encoding stops allocating once the buffers have
+// grown to the block size.
+//
+// Cost: add() is O(payload bytes) plus one hash probe per string;
+// finish() is O(block bytes), plus the compression pass if enabled.
+//
+// Thread safety: NOT thread-safe.
+// ============================================================================
+
+class ColumnarEncoder {
+public:
+    explicit ColumnarEncoder(ColumnarConfig config = {});
+
+    // Append one payload; false (nothing added) if the block is full
+    [[nodiscard]] bool add(std::span<const std::byte> payload);
+
+    // Close the block and start the next one. The view stays valid until
+    // the next add() or finish(); empty if no event was added.
+    [[nodiscard]] std::span<const std::byte> finish();
+
+    // Event or byte bound reached: add() refuses every payload
+    [[nodiscard]] bool full() const noexcept {
+        return events_ >= config_.max_block_events || column_bytes_ >= config_.max_block_bytes;
+    }
+    [[nodiscard]] bool empty() const noexcept { return events_ == 0; }
+    [[nodiscard]] std::size_t events() const noexcept { return events_; }
+    [[nodiscard]] std::size_t column_bytes() const noexcept { return column_bytes_; }
+    [[nodiscard]] std::size_t symbol_count() const noexcept { return symbol_count_; }
+    [[nodiscard]] const ColumnarConfig& config() const noexcept { return config_; }
+
+    // Metrics (all blocks)
+    [[nodiscard]] std::uint64_t metric_rows() const noexcept { return metric_rows_; }
+    [[nodiscard]] std::uint64_t log_rows() const noexcept { return log_rows_; }
+    [[nodiscard]] std::uint64_t raw_rows() const noexcept { return raw_rows_; }
+    [[nodiscard]] std::uint64_t compressed_blocks() const noexcept { return compressed_blocks_; }
+
+private:
+    static constexpr std::uint32_t kNil = HashIndex::kNil;
+
+    struct ScratchMetric {
+        std::string_view name;
+        std::string_view unit;
+        double value = 0;
+        std::uint32_t tag_begin = 0;      // into scratch_pairs_
+        std::uint32_t tag_count = 0;
+    };
+
+    struct StrPair {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    struct Symbol {
+        std::uint64_t hash = 0;
+        std::uint32_t offset = 0;         // bytes in the symbols column
+        std::uint32_t length = 0;
+    };
+
+    // Strict canonical decoders into the scratch members; false if the
+    // payload is not in canonical form
+    bool decode_metrics(std::string_view in);
+    bool decode_log(std::string_view in);
+
+    void add_metrics();
+    void add_log();
+    void add_raw(std::span<const std::byte> payload);
+
+    // Dictionary index of the string, interning it if new (room checked
+    // by add())
+    std::uint32_t intern(std::string_view s);
+
+    std::vector<std::byte>& column(Column c) noexcept {
+        return columns_[static_cast<std::size_t>(c)];
+    }
+
+    void reset_block() noexcept;
+
+    ColumnarConfig config_;
+    std::uint64_t seed_;
+
+    std::vector<std::byte> columns_[kColumnCount];
+    std::size_t column_bytes_ = 0;
+    std::size_t events_ = 0;
+    std::size_t block_metric_rows_ = 0;
+    std::size_t block_log_rows_ = 0;
+    std::size_t block_raw_rows_ = 0;
+
+    std::vector<Symbol> symbols_;
+    HashIndex symbol_index_;                   // symbols_ index or kNil
+    std::size_t symbol_count_ = 0;
+
+    // Previous row, for the delta columns
+    std::uint64_t prev_metric_seq_ = 0;
+    std::uint64_t prev_metric_ts_ = 0;
+    std::uint64_t prev_log_ts_ = 0;
+
+    // Decoded event (views into the payload)
+    std::string_view scratch_agent_;
+    bool scratch_has_agent_ = false;
+    std::uint64_t scratch_seq_ = 0;
+    std::uint64_t scratch_ts_ = 0;
+    std::uint8_t scratch_level_ = 0;
+    std::string_view scratch_msg_;
+    std::vector<ScratchMetric> scratch_metrics_;
+    std::vector<StrPair> scratch_pairs_;      // metric tags or log fields
+    std::size_t scratch_strings_ = 0;         // dictionary strings the event needs at most
+
+    std::vector<std::byte> body_;             // finish() scratch: uncompressed body
+    std::vector<std::byte> packed_;           // ... and its LZ4 form
+    std::vector<std::byte> block_;            // finish() output
+
+    // Metrics
+    std::uint64_t metric_rows_ = 0;
+    std::uint64_t log_rows_ = 0;
+    std::uint64_t raw_rows_ = 0;
+    std::uint64_t compressed_blocks_ = 0;
+};
+
+// Decode a block back into canonical payloads, in order, byte for byte
+// what was added. `scratch` holds the decompressed body. Returns false (after emitting a prefix, possibly empty)
+// if the block is malformed or truncated; every length and index is
+// checked before use.
+bool decode_columnar_block(std::span<const std::byte> block, std::vector<std::byte>& scratch,
+                           const std::function<void(std::span<const std::byte>)>& emit);
+
+// ============================================================================
+// LZ4 block format (no frame), as read by LZ4_decompress_safe()
+//
+// Greedy single-probe matcher over a 4096-entry hash table of 4-byte
+// sequences: fast and small, not the reference ratio. Cost O(n).
+// ============================================================================
+
+// Worst-case compressed size of n bytes
+constexpr std::size_t lz4_compress_bound(std::size_t n) noexcept {
+    return n + n / 255 + 16;
+}
+
+// Returns the bytes written, or 0 if `out` is too small (or `in` empty)
+std::size_t lz4_compress(std::span<const std::byte> in, std::span<std::byte> out) noexcept;
+
+// True if `in` decodes to exactly out.size() bytes; never reads or writes
+// out of bounds on malformed input
+bool lz4_decompress(std::span<const std::byte> in, std::span<std::byte> out) noexcept;
+
+// ============================================================================
+// ColumnarSink: ships whole blocks to an inner sink
+//
+// Encodes every payload with a ColumnarEncoder and passes each finished
+// block to the inner sink as one write(). A block is closed when the
+// encoder is full, when the oldest event is max_delay old (checked on
+// every write), on flush(), or on destruction. Wraps like BufferedSink
+// (takes ownership) and has the same result contract: events count as
+// written once encoded; events of a block the inner sink rejects are
+// counted in dropped_events().
+//
+// The inner sink must carry binary payloads as they are (a block is not
+// newline-safe; blocks are self-delimiting by their header).
+//
+// Thread safety: NOT thread-safe. Use from one thread.
+// ============================================================================
+
+class ColumnarSink final : public Sink {
+public:
+    explicit ColumnarSink(std::unique_ptr<Sink> inner, ColumnarConfig config = {});
+    ~ColumnarSink() override;
+
+    ColumnarSink(const ColumnarSink&) = delete;
+    ColumnarSink& operator=(const ColumnarSink&) = delete;
+
+    [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override;
+    [[nodiscard]] std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept override;
+
+    // Ships the open block, then flushes the inner sink
+    void flush() noexcept override;
+
+    [[nodiscard]] const ColumnarEncoder& encoder() const noexcept { return encoder_; }
+
+    // Metrics
+    [[nodiscard]] std::uint64_t blocks_written() const noexcept { return blocks_written_; }
+    [[nodiscard]] std::uint64_t dropped_events() const noexcept { return dropped_events_; }
+    [[nodiscard]] std::uint64_t bytes_in() const noexcept { return bytes_in_; }
+    [[nodiscard]] std::uint64_t bytes_out() const noexcept { return bytes_out_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void ship() noexcept;
+
+    std::unique_ptr<Sink> inner_;
+    ColumnarEncoder encoder_;
+    Clock::time_point oldest_{};
+
+    std::uint64_t blocks_written_ = 0;
+    std::uint64_t dropped_events_ = 0;
+    std::uint64_t bytes_in_ = 0;
+    std::uint64_t bytes_out_ = 0;
+};
+
+}  // namespace gateway
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace gateway {
 
@@ -13,17 +14,71 @@ struct SourceLimiterConfig {
     std::uint32_t burst_tokens = 200;      // max tokens (bucket size)
 };
 
+// Per-agent rate limiter configuration (AgentLimiter, after TB-4)
+// Memory is fixed by the sketch and heavy-hitter sizes, however many
+// distinct agent ids arrive
+struct AgentLimiterConfig {
+    std::uint32_t tokens_per_sec = 1000;   // sustained events per agent
+    std::uint32_t burst_tokens = 2000;     // sketch count at which an agent is rate-limited
+    std::size_t sketch_width = 4096;       // counters per sketch row (rounded to a power of two)
+    std::size_t sketch_depth = 4;          // sketch rows (independent hashes), 1..8
+    std::size_t heavy_hitters = 256;       // agents rate-limited exactly at once
+    std::uint32_t decay_ms = 1000;         // sketch counts halve this often
+};
+
+// Replay suppression configuration (SeqDeduplicator, after TB-4)
+struct DedupConfig {
+    std::size_t max_agents = 4096;         // agents remembered (least recently seen evicted)
+    std::size_t window = 128;              // recent seqs remembered per agent (power of two, >= 64)
+};
+
+// Metrics rollup configuration (MetricsAggregator, after TB-4)
+// All storage is sized from these at construction and reused per window
+struct AggregatorConfig {
+    std::size_t max_series = 8192;           // rollups per window, all agents
+    std::size_t max_series_per_agent = 512;  // cardinality cap per agent
+    std::size_t max_agents = 1024;           // agents per window
+    std::size_t arena_bytes = 1 << 20;       // interned names/units/tags per window
+    bool quantiles = false;                  // per-series histogram for p50/p90/p99
+};
+
 // Bounded work queue configuration
 // Controls total work bounding and drop behavior
 struct QueueConfig {
     std::size_t capacity = 1024;           // max queued datagrams
 };
 
+// Receive backend used by RecvLoop::recv_batch()
+enum class RecvBackend : std::uint8_t {
+    Recvmmsg,   // One recvmmsg syscall per batch (recv_one() loop off Linux)
+    IoUring     // Multishot recvmsg into a provided-buffer ring; falls back
+                // to Recvmmsg where the kernel lacks support
+};
+
 // Receive loop configuration
 // Controls TB-1 enforcement: size limits, socket buffers
 struct RecvConfig {
     std::size_t max_datagram_bytes = 1472; // MTU(1500) - IP(20) - UDP(8)
     std::size_t recv_buffer_bytes = 256 * 1024;  // SO_RCVBUF hint
+    std::size_t batch_size = 32;           // datagrams per recv_batch() call
+    std::size_t buffer_pool_size = 64;     // pooled datagram buffers (>= batch_size)
+    RecvBackend backend = RecvBackend::Recvmmsg;
+    int busy_poll_us = 0;                  // SO_BUSY_POLL budget for blocking waits (0 = off)
+};
+
+// Multi-worker ingest configuration
+// Each worker owns one SO_REUSEPORT socket and a full pipeline shard
+// (RecvLoop, SourceLimiter, parse/validate state). The kernel hashes each
+// source 4-tuple to one socket, so per-source limits stay exact per shard.
+struct WorkerConfig {
+    std::size_t worker_count = 1;          // number of ingest threads/sockets
+    bool pin_to_cpu = false;               // pin worker i to CPU (first_cpu + i)
+    int first_cpu = 0;                     // first CPU used when pinning
+    bool numa_placement = false;           // pin by NIC RX queue CPUs and NUMA node
+                                           // instead of first_cpu + i
+    std::string_view nic;                  // interface guiding placement (empty = none)
+    bool sink_on_worker_node = false;      // async sink thread on the worker's node
+    bool steer_by_rx_cpu = false;          // socket by receiving CPU, not 4-tuple hash
 };
 
 // Top-level gateway configuration
@@ -31,6 +86,7 @@ struct GatewayConfig {
     SourceLimiterConfig source_limiter;
     QueueConfig queue;
     RecvConfig recv;
+    WorkerConfig workers;
 };
 
 // Conservative defaults suitable for learning/testing
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "gateway/config.hpp"
+#include "gateway/ring_queue.hpp"  // kCacheLineSize
+#include "gateway/validate_log.hpp"
+#include "gateway/validate_metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// ConfigSnapshot: RCU-style hot-reloadable configuration
+//
+// Holds an immutable snapshot of T that a writer replaces wholesale with
+// publish(). Readers (ingest workers) pick up the current snapshot with
+// one acquire load per read(), typically once per batch, and never lock,
+// allocate or write shared state on the read path.
+//
+// Reclamation is quiescent-state based (QSBR): each Reader owns a slot,
+// on its own cache line, holding the version of the snapshot it last
+// read. Calling read() again is the reader's quiescent point: it gives up
+// every older snapshot. A replaced snapshot is freed once every attached
+// reader has read a newer version (checked on publish() and reclaim()).
+// A reader that stops calling read() only delays reclamation.
+//
+// Invariants:
+// - A reference returned by Reader::read() stays valid until that
+//   reader's next read() or destruction
+// - Versions start at 1 and increase by one per publish()
+// - At most kMaxReaders readers attached at once
+//
+// Thread safety: publish(), load(), reclaim() and make_reader() may be
+// called from any thread (serialized by a mutex). Each Reader is used by
+// one thread at a time.
+// ============================================================================
+
+template <typename T>
+class ConfigSnapshot {
+    struct Node {
+        T value;
+        std::uint64_t version;
+    };
+
+public:
+    static constexpr std::size_t kMaxReaders = 64;
+
+    class Reader {
+    public:
+        Reader() = default;  // detached
+
+        Reader(Reader&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr))
+            , slot_(other.slot_)
+            , node_(std::exchange(other.node_, nullptr)) {}
+
+        Reader& operator=(Reader&& other) noexcept {
+            if (this != &other) {
+                reset();
+                owner_ = std::exchange(other.owner_, nullptr);
+                slot_ = other.slot_;
+                node_ = std::exchange(other.node_, nullptr);
+            }
+            return *this;
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        ~Reader() { reset(); }
+
+        // Current snapshot. Releases whatever this reader read before.
+        // Requires attached().
+        const T& read() noexcept {
+            const Node* node = owner_->current_.load(std::memory_order_acquire);
+            if (node != node_) {
+                node_ = node;
+                // Release: our reads of the old snapshot happen before the
+                // writer sees this and frees it
+                owner_->slots_[slot_].seen.store(node->version, std::memory_order_release);
+            }
+            return node->value;
+        }
+
+        // Version of the snapshot returned by the last read() (or current
+        // at attach time before the first)
+        [[nodiscard]] std::uint64_t version() const noexcept { return node_ ? node_->version : 0; }
+
+        [[nodiscard]] bool attached() const noexcept { return owner_ != nullptr; }
+
+        // Detach: this reader no longer holds any snapshot
+        void reset() noexcept {
+            if (owner_ != nullptr) {
+                owner_->slots_[slot_].seen.store(kDetached, std::memory_order_release);
+                owner_ = nullptr;
+                node_ = nullptr;
+            }
+        }
+
+    private:
+        friend class ConfigSnapshot;
+
+        Reader(ConfigSnapshot* owner, std::size_t slot, const Node* node) noexcept
+            : owner_(owner), slot_(slot), node_(node) {}
+
+        ConfigSnapshot* owner_ = nullptr;
+        std::size_t slot_ = 0;
+        const Node* node_ = nullptr;
+    };
+
+    explicit ConfigSnapshot(T initial = {})
+        : current_(new Node{std::move(initial), 1}) {}
+
+    // Every Reader must be detached or destroyed first
+    ~ConfigSnapshot() { delete current_.load(std::memory_order_relaxed); }
+
+    ConfigSnapshot(const ConfigSnapshot&) = delete;
+    ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+    // Attach a reader, holding the current snapshot.
+    // Returns nullopt if kMaxReaders are attached.
+    [[nodiscard]] std::optional<Reader> make_reader() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < kMaxReaders; ++i) {
+            if (slots_[i].seen.load(std::memory_order_acquire) == kDetached) {
+                const Node* node = current_.load(std::memory_order_relaxed);
+                slots_[i].seen.store(node->version, std::memory_order_relaxed);
+                return Reader(this, i, node);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Replace the snapshot. Returns the new version. Readers see it on
+    // their next read(); the old one is freed once they all have.
+    std::uint64_t publish(T value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Node* old = current_.load(std::memory_order_relaxed);
+        const std::uint64_t version = old->version + 1;
+        // Reserve first so a failed allocation leaves the snapshot as is
+        retired_.reserve(retired_.size() + 1);
+        current_.store(new Node{std::move(value), version}, std::memory_order_release);
+        retired_.emplace_back(old);
+        reclaim_locked();
+        return version;
+    }
+
+    // Copy of the current snapshot (for writers building the next one)
+    [[nodiscard]] T load() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_.load(std::memory_order_relaxed)->value;
+    }
+
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return current_.load(std::memory_order_acquire)->version;
+    }
+
+    // Free replaced snapshots no reader can still hold.
+    // Returns the number still waiting on a reader.
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reclaim_locked();
+        return retired_.size();
+    }
+
+private:
+    static constexpr std::uint64_t kDetached = UINT64_MAX;
+
+    struct alignas(kCacheLineSize) Slot {
+        std::atomic<std::uint64_t> seen{kDetached};  // version last read
+    };
+
+    void reclaim_locked() noexcept {
+        std::uint64_t oldest = kDetached;
+        for (const Slot& slot : slots_) {
+            oldest = std::min(oldest, slot.seen.load(std::memory_order_acquire));
+        }
+        std::erase_if(retired_, [oldest](const std::unique_ptr<Node>& node) {
+            return node->version < oldest;
+        });
+    }
+
+    std::atomic<Node*> current_;
+    std::array<Slot, kMaxReaders> slots_{};
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Node>> retired_;
+};
+
+// Settings that can change without a restart, published as one snapshot
+// and applied by each worker between batches:
+// - source_limiter: FlatSourceLimiter::reconfigure() (buckets kept)
+// - max_per_agent: BoundedForwarder::set_max_per_agent() (queue kept)
+// - agent_limiter: AgentLimiter::reconfigure() (rates only; sizes fixed)
+// - metrics/log validation: read per datagram from the snapshot
+struct RuntimeConfig {
+    SourceLimiterConfig source_limiter;
+    std::size_t max_per_agent = 64;
+    AgentLimiterConfig agent_limiter;
+    MetricsValidationConfig metrics_validation;
+    LogValidationConfig log_validation;
+};
+
+}  // namespace gateway
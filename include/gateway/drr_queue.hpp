@@ -0,0 +1,202 @@
+#pragma once
+
+#include "gateway/bounded_queue.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// DrrQueue: bounded multi-flow queue served by deficit round robin
+//
+// Items are pushed with a flow id (e.g., an AgentHandle) and a cost (e.g.,
+// payload bytes). Each flow keeps its own FIFO sub-queue; flows with items
+// wait in an active ring. On each visit a flow's deficit grows by quantum x
+// weight, and the flow is served while its head item costs no more than
+// the deficit; then the next active flow gets its turn. A burst from one
+// flow therefore delays another flow by at most one round, not by the
+// burst.
+//
+// Storage is allocated once at construction:
+// - nodes_: pool of `capacity` item nodes with a free-index stack; each
+//   sub-queue is a singly linked list through the pool
+// - flows_: per-flow state indexed by flow id (< max_flows)
+// - active_: ring of active flow ids (each flow at most once)
+//
+// Invariants enforced:
+// - Total items bounded by capacity (tail-drop when full, like BoundedQueue)
+// - FIFO within a flow
+// - O(1) push; O(1) pop while quantum x weight >= the largest cost (every
+//   visit then serves an item, so a pop rotates past at most one flow)
+//
+// Thread safety: NOT thread-safe. External synchronization required.
+//
+// Template parameter T must be movable and default-constructible.
+// ============================================================================
+
+template <typename T>
+class DrrQueue {
+public:
+    using Flow = std::uint32_t;
+
+    DrrQueue(std::size_t capacity, std::size_t max_flows, std::uint32_t quantum)
+        : nodes_(capacity)
+        , free_(capacity)
+        , flows_(max_flows)
+        , active_(max_flows)
+        , quantum_(std::max<std::uint32_t>(quantum, 1)) {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            free_[i] = static_cast<std::uint32_t>(capacity - 1 - i);
+        }
+        free_count_ = capacity;
+    }
+
+    // Attempt to push an item onto `flow`'s sub-queue. Returns Dropped if
+    // the queue is full or the flow id is out of range. `weight` (>= 1)
+    // scales the flow's quantum; it is read when the flow becomes active.
+    PushResult try_push(T item, Flow flow, std::uint32_t cost,
+                        std::uint32_t weight = 1) noexcept {
+        if (free_count_ == 0 || flow >= flows_.size()) {
+            ++drop_count_;
+            return PushResult::Dropped;
+        }
+        const std::uint32_t index = free_[--free_count_];
+        Node& node = nodes_[index];
+        node.item = std::move(item);
+        node.cost = std::max<std::uint32_t>(cost, 1);
+        node.next = kNone;
+
+        FlowState& f = flows_[flow];
+        if (f.count == 0) {
+            f.head = index;
+            f.deficit = 0;
+            f.weight = std::max<std::uint32_t>(weight, 1);
+            f.fresh = true;
+            active_[(active_head_ + active_count_) % active_.size()] = flow;
+            ++active_count_;
+        } else {
+            nodes_[f.tail].next = index;
+        }
+        f.tail = index;
+        ++f.count;
+        ++size_;
+        return PushResult::Ok;
+    }
+
+    // Pop the next item in DRR order. Returns false if empty.
+    bool try_pop(T& out) noexcept {
+        if (size_ == 0) {
+            return false;
+        }
+        while (true) {
+            const Flow flow = active_[active_head_];
+            FlowState& f = flows_[flow];
+            if (f.fresh) {
+                // New visit: grant this round's quantum
+                f.deficit += static_cast<std::uint64_t>(quantum_) * f.weight;
+                f.fresh = false;
+            }
+
+            Node& node = nodes_[f.head];
+            if (node.cost > f.deficit) {
+                // Out of deficit: the flow goes to the back of the ring,
+                // keeping the remainder for its next visit
+                f.fresh = true;
+                active_head_ = (active_head_ + 1) % active_.size();
+                active_[(active_head_ + active_count_ - 1) % active_.size()] = flow;
+                continue;
+            }
+
+            f.deficit -= node.cost;
+            out = std::move(node.item);
+            const std::uint32_t index = f.head;
+            f.head = node.next;
+            free_[free_count_++] = index;
+            --f.count;
+            --size_;
+
+            if (f.count == 0) {
+                // Idle flows keep no credit
+                f.deficit = 0;
+                active_head_ = (active_head_ + 1) % active_.size();
+                --active_count_;
+            }
+            return true;
+        }
+    }
+
+    std::optional<T> try_pop() noexcept {
+        T item;
+        if (!try_pop(item)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // Pop up to out.size() items in DRR order. Returns the number popped.
+    std::size_t try_pop_n(std::span<T> out) noexcept {
+        std::size_t popped = 0;
+        while (popped < out.size() && try_pop(out[popped])) {
+            ++popped;
+        }
+        return popped;
+    }
+
+    // Current number of items
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    // Maximum capacity
+    [[nodiscard]] std::size_t capacity() const noexcept { return nodes_.size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] bool full() const noexcept { return free_count_ == 0; }
+
+    // Items queued for one flow (0 for unknown flows)
+    [[nodiscard]] std::size_t flow_size(Flow flow) const noexcept {
+        return flow < flows_.size() ? flows_[flow].count : 0;
+    }
+
+    // Flows with at least one queued item
+    [[nodiscard]] std::size_t active_flows() const noexcept { return active_count_; }
+
+    [[nodiscard]] std::uint32_t quantum() const noexcept { return quantum_; }
+
+    // Total items dropped due to full queue (or bad flow id)
+    [[nodiscard]] std::uint64_t drop_count() const noexcept { return drop_count_; }
+
+private:
+    static constexpr std::uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        T item{};
+        std::uint32_t next = kNone;
+        std::uint32_t cost = 0;
+    };
+
+    struct FlowState {
+        std::uint64_t deficit = 0;
+        std::uint32_t head = kNone;
+        std::uint32_t tail = kNone;
+        std::uint32_t count = 0;
+        std::uint32_t weight = 1;
+        bool fresh = true;      // quantum not yet granted for this visit
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_;       // stack of free node indices
+    std::size_t free_count_ = 0;
+    std::vector<FlowState> flows_;
+    std::vector<Flow> active_;              // ring of active flows
+    std::size_t active_head_ = 0;
+    std::size_t active_count_ = 0;
+    std::uint32_t quantum_;
+    std::size_t size_ = 0;
+    std::uint64_t drop_count_ = 0;
+};
+
+}  // namespace gateway
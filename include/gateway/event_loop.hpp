@@ -0,0 +1,111 @@
+#pragma once
+
+#include "gateway/recv_loop.hpp"
+#include "gateway/source_limiter.hpp"  // Clock
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace gateway {
+
+// ============================================================================
+// Ingest event loop: adaptive busy-poll / blocking wait around a RecvLoop
+//
+// Each iteration fires due timers, then calls recv_batch(wait) with a wait
+// chosen from recent traffic:
+//
+// - Spinning: within spin_window of the last datagram (or while the idle
+//   handler reports pending work) wait is 0, so bursts are picked up with
+//   no wake-up latency and the socket buffer is drained continuously
+// - Blocking: otherwise the loop waits in the kernel (ppoll or the
+//   io_uring completion wait; SO_BUSY_POLL applies there if configured
+//   via RecvConfig::busy_poll_us) until a datagram arrives, the next
+//   timer is due, or max_block passes. An idle loop wakes only for timers.
+//
+// Timers replace "every N iterations" bookkeeping: forwarder drains and
+// stats publication run on their own period regardless of load.
+//
+// Invariants:
+// - Bounded work per iteration: one recv_batch, at most kMaxTimers timers
+// - No allocation after setup (handlers are set before run())
+// - Timers never fire early; missed periods are skipped, not queued
+//
+// Thread safety: NOT thread-safe. Runs on the RecvLoop's thread.
+// ============================================================================
+
+struct EventLoopConfig {
+    std::chrono::microseconds spin_window{200};     // poll without blocking this long after data
+    std::chrono::microseconds max_block{100'000};   // longest single idle wait
+};
+
+struct EventLoopMetrics {
+    std::uint64_t batches = 0;       // non-empty batches handled
+    std::uint64_t polls = 0;         // non-blocking recv attempts that found nothing
+    std::uint64_t waits = 0;         // blocking waits entered
+    std::uint64_t idle_wakeups = 0;  // blocking waits that ended without data
+    std::uint64_t timer_fires = 0;
+};
+
+class EventLoop {
+public:
+    using BatchHandler = std::function<void(std::span<RecvResult>)>;
+    // Called after a recv that found nothing; returns true while work is
+    // still pending (e.g. a sync forwarder backlog) so the loop keeps spinning
+    using IdleHandler = std::function<bool()>;
+    using TimerHandler = std::function<void()>;
+
+    static constexpr std::size_t kMaxTimers = 8;
+
+    explicit EventLoop(RecvLoop& recv, EventLoopConfig config = {},
+                       Clock clock = std::chrono::steady_clock::now);
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    void on_batch(BatchHandler handler) { on_batch_ = std::move(handler); }
+    void on_idle(IdleHandler handler) { on_idle_ = std::move(handler); }
+
+    // Run `handler` every `interval`, first one interval from now.
+    // Returns false if interval is not positive or kMaxTimers are in use.
+    bool add_timer(std::chrono::microseconds interval, TimerHandler handler);
+
+    // One iteration. Returns the number of results handed to on_batch.
+    std::size_t run_once();
+
+    // Iterate until `running` is false (checked once per iteration, so
+    // shutdown latency is at most max_block or the shortest timer)
+    void run(const std::atomic<bool>& running);
+
+    // Wait the next iteration would pass to recv_batch()
+    [[nodiscard]] std::chrono::microseconds next_wait() const;
+
+    [[nodiscard]] const EventLoopMetrics& metrics() const noexcept { return metrics_; }
+
+private:
+    struct Timer {
+        std::chrono::steady_clock::duration interval{};
+        std::chrono::steady_clock::time_point next{};
+        TimerHandler handler;
+    };
+
+    void fire_timers(std::chrono::steady_clock::time_point now);
+    [[nodiscard]] std::chrono::microseconds wait_at(std::chrono::steady_clock::time_point now) const;
+
+    RecvLoop& recv_;
+    EventLoopConfig config_;
+    Clock clock_;
+    BatchHandler on_batch_;
+    IdleHandler on_idle_;
+    std::array<Timer, kMaxTimers> timers_;
+    std::size_t timer_count_ = 0;
+    std::chrono::steady_clock::time_point last_data_;
+    bool pending_ = false;           // idle handler reported work left
+    EventLoopMetrics metrics_;
+};
+
+}  // namespace gateway
@@ -1,13 +1,25 @@
 #pragma once
 
 #include "gateway/bounded_queue.hpp"
+#include "gateway/buffer_pool.hpp"
+#include "gateway/drr_queue.hpp"
+#include "gateway/hash_index.hpp"
+#include "gateway/histogram.hpp"
+#include "gateway/parse_log.hpp"
+#include "gateway/ring_queue.hpp"
 #include "gateway/sink.hpp"
+#include "gateway/validate_config.hpp"
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace gateway {
@@ -19,66 +31,176 @@ namespace gateway {
 // 1. Bounded backlog (fixed-capacity queue)
 // 2. Drop under outage (tail-drop when full)
 // 3. Per-agent fairness (quota enforcement)
+// 4. Bounded payload storage (queued payloads live in one BufferPool)
 //
 // Invariants enforced:
-// - Total queue depth bounded by max_queue_depth
+// - Total queue depth bounded by max_queue_depth (or, with lanes, each
+//   lane by its lane_capacity)
 // - Per-agent in-flight events bounded by max_per_agent
+// - Payload memory fixed at startup: one slot of max_payload_bytes per
+//   event that can be in flight
 // - Downstream slowness cannot cause unbounded backlog
 // - No single agent can starve others during degradation
 //
 // Thread safety: NOT thread-safe. External synchronization required.
+// In async mode the forwarder runs its own sink thread; the public API is
+// still meant for a single (producer) thread.
 // ============================================================================
 
+// Order in which queued events reach the sink
+enum class SchedulerMode : std::uint8_t {
+    Fifo,               // Arrival order (one queue)
+    DeficitRoundRobin,  // Per-agent sub-queues, served round robin by payload bytes
+};
+
+// Event types that can be forwarded
+enum class EventType : std::uint8_t {
+    Metrics,
+    Log,
+};
+
+// Priority lane of a queued event (ForwarderConfig::lanes). Lower lanes
+// are the ones worth keeping under overload and drain first.
+enum class Lane : std::uint8_t {
+    Critical,  // error and fatal logs
+    Metrics,
+    Logs,      // info and warn logs
+    Debug,     // trace and debug logs (shed first)
+};
+inline constexpr std::size_t kLaneCount = 4;
+
+// Lane an event is queued on: metrics, and logs by level
+constexpr Lane lane_for(EventType type, LogLevel level) noexcept {
+    if (type == EventType::Metrics) {
+        return Lane::Metrics;
+    }
+    if (level >= LogLevel::Error) {
+        return Lane::Critical;
+    }
+    return level >= LogLevel::Info ? Lane::Logs : Lane::Debug;
+}
+
+// How queued events are split into lanes and drained
+enum class LanePolicy : std::uint8_t {
+    Single,          // One queue of max_queue_depth for every event
+    StrictPriority,  // A lane drains only while all lower lanes are empty
+    Weighted,        // Lanes take turns, lane_weight events per turn
+};
+
+// DRR share of one agent: its quantum is drr_quantum x weight
+struct AgentWeight {
+    std::string agent_id;
+    std::uint32_t weight = 1;
+};
+
 // Configuration for the forwarder
 struct ForwarderConfig {
     std::size_t max_queue_depth = 4096;   // Total bounded capacity
     std::size_t max_per_agent = 64;       // Per-agent quota
+    bool async_sink = false;              // Sink writes on a dedicated thread
+    std::size_t sink_batch_size = 64;     // Max events per Sink::write_batch (async)
+    std::vector<int> sink_cpus;           // Sink thread affinity (async); empty =
+                                          // inherit the constructing thread's
+    std::size_t max_payload_bytes = 2048; // Largest queued payload (slot size)
+    SchedulerMode scheduler = SchedulerMode::Fifo;
+    std::size_t drr_quantum = 0;          // Bytes per agent per round; raised to
+                                          // max_payload_bytes (O(1) dequeue)
+    std::vector<AgentWeight> agent_weights; // DRR weights; unlisted agents get 1
+    LanePolicy lanes = LanePolicy::Single;
+    std::array<std::size_t, kLaneCount> lane_capacity = {1024, 2048, 768, 256};
+                                          // Per-lane bound, by Lane; with lanes
+                                          // their sum replaces max_queue_depth
+    std::array<std::uint32_t, kLaneCount> lane_weight = {8, 4, 2, 1};
+                                          // Events per turn (Weighted), by Lane
+    LatencyHistogram* queue_latency = nullptr;      // Enqueue to sink write (sampled events)
+    LatencyHistogram* sink_write_latency = nullptr; // Sink calls carrying a sampled event
+    unsigned latency_sample_shift = 4;    // Time one event in 2^shift
 };
 
 // Result of attempting to forward an event
 enum class ForwardResult : std::uint8_t {
     Queued,                    // Successfully queued for downstream
-    DroppedQueueFull,          // Global queue at capacity
+    DroppedQueueFull,          // Global queue (or the event's lane) at capacity
     DroppedAgentQuotaExceeded, // Agent using disproportionate share
+    DroppedAgentTableFull,     // No free agent slot (or id longer than kMaxLength)
+    DroppedPayloadStorageFull, // No free payload slot (defensive; see slab sizing)
+    DroppedPayloadTooLarge,    // Payload longer than max_payload_bytes
 };
 
-// Event types that can be forwarded
-enum class EventType : std::uint8_t {
-    Metrics,
-    Log,
-};
+// Compact id of an agent interned in an AgentQuotaTracker.
+// Valid while the agent has at least one slot reserved.
+using AgentHandle = std::uint32_t;
+inline constexpr AgentHandle kInvalidAgentHandle = UINT32_MAX;
 
 // An event queued for forwarding.
-// Contains copied data (not views) since original buffer may be reused.
+// Neither the payload nor the agent id is owned: try_forward() copies the
+// payload into a slot of the forwarder's payload BufferPool (or takes it in place
+// when it was written into payload_buffer()) and interns the id as a
+// handle. Once queued, payload points into that slot; there is no
+// separate payload arena, since lanes release slots out of order. Trivially copyable, so the queues' up-front slots cost one
+// allocation and no per-event heap traffic.
 struct QueuedEvent {
-    std::string agent_id;              // Copied for quota release on dequeue
-    EventType type;                    // Metrics or Log
-    std::vector<std::byte> payload;    // Serialized event data
+    std::string_view agent_id;              // Borrowed; read only by try_forward()
+    AgentHandle agent = kInvalidAgentHandle; // Set by try_forward(), for release
+    EventType type;                         // Metrics or Log
+    LogLevel level = LogLevel::Info;        // Log events: with type, picks the Lane
+    std::span<const std::byte> payload;     // Serialized event data
+    BufferIndex payload_slot = kNoBuffer;   // Set by try_forward(), for release
+    std::uint64_t enqueued_ns = 0;          // Set by try_forward() on sampled events
 };
 
+static_assert(std::is_trivially_copyable_v<QueuedEvent>);
+
 // ============================================================================
 // AgentQuotaTracker
 //
 // Tracks in-flight event count per agent for fairness enforcement.
 // Memory is naturally bounded by queue depth (Option C from design).
 //
+// Agent ids are interned into a fixed table when first reserved, so the
+// hot path does one hash + probe per event and release is an O(1) index
+// by handle. Storage is allocated once at construction:
+// - entries_: flat array of {id bytes, count}, indexed by AgentHandle
+// - index_: HashIndex of entry indices on a seeded hash of the id (ids
+//   are attacker-chosen); removal uses backward-shift deletion, which
+//   moves index slots only, so handles stay stable
+// An entry is freed (and its handle recycled) when its count reaches 0.
+//
 // Invariant: sum(all counts) == number of events in queue
+// Invariant: tracked_agents() <= max_agents
 // ============================================================================
 
+enum class ReserveResult : std::uint8_t {
+    Ok,
+    QuotaExceeded,  // Agent already at max_per_agent
+    TableFull,      // max_agents distinct agents in flight, or id too long
+};
+
 class AgentQuotaTracker {
 public:
-    explicit AgentQuotaTracker(std::size_t max_per_agent) noexcept;
+    static constexpr std::size_t kDefaultMaxAgents = 4096;
+
+    explicit AgentQuotaTracker(std::size_t max_per_agent,
+                               std::size_t max_agents = kDefaultMaxAgents);
 
-    // Attempt to reserve a slot for this agent.
-    // Returns false if agent already at quota (reject event).
-    [[nodiscard]] bool try_reserve(const std::string& agent_id) noexcept;
+    // Attempt to reserve a slot for this agent, interning it if new.
+    // On Ok, `handle` identifies the agent until the slot is released.
+    [[nodiscard]] ReserveResult try_reserve(std::string_view agent_id,
+                                            AgentHandle& handle) noexcept;
+
+    // Convenience: true if a slot was reserved (handle not needed).
+    [[nodiscard]] bool try_reserve(std::string_view agent_id) noexcept;
 
     // Release a slot when event is dequeued.
     // Must be called exactly once per successful try_reserve.
-    void release(const std::string& agent_id) noexcept;
+    void release(AgentHandle handle) noexcept;
+
+    // Convenience: release by id (one lookup). No-op for unknown agents.
+    void release(std::string_view agent_id) noexcept;
 
     // Current in-flight count for an agent (for testing/metrics)
-    [[nodiscard]] std::size_t in_flight_count(const std::string& agent_id) const noexcept;
+    [[nodiscard]] std::size_t in_flight_count(std::string_view agent_id) const noexcept;
+    [[nodiscard]] std::size_t in_flight_count(AgentHandle handle) const noexcept;
 
     // Number of distinct agents currently tracked
     [[nodiscard]] std::size_t tracked_agents() const noexcept;
@@ -86,20 +208,99 @@ public:
     // Total events across all agents (should equal queue size)
     [[nodiscard]] std::size_t total_in_flight() const noexcept;
 
+    // Maximum number of distinct agents in flight at once
+    [[nodiscard]] std::size_t max_agents() const noexcept { return entries_.size(); }
+
+    // Change the per-agent quota. Reserved slots are untouched: an agent
+    // above a lowered quota is refused until its count drops below it.
+    void set_max_per_agent(std::size_t max_per_agent) noexcept { max_per_agent_ = max_per_agent; }
+    [[nodiscard]] std::size_t max_per_agent() const noexcept { return max_per_agent_; }
+
     // Metrics
     [[nodiscard]] std::uint64_t quota_rejections() const noexcept { return quota_rejections_; }
+    [[nodiscard]] std::uint64_t table_full_rejections() const noexcept { return table_full_rejections_; }
 
 private:
-    std::unordered_map<std::string, std::size_t> in_flight_;
+    static constexpr std::uint32_t kEmptySlot = HashIndex::kNil;
+
+    struct Entry {
+        std::uint32_t hash = 0;     // low bits of the seeded id hash
+        std::uint32_t count = 0;    // in-flight events; 0 = free entry
+        std::uint8_t len = 0;
+        char id[AgentIdRules::kMaxLength];
+    };
+
+    [[nodiscard]] std::uint32_t hash_id(std::string_view agent_id) const noexcept;
+
+    // Index slot holding the entry for agent_id, or the empty slot where it
+    // would be inserted (index_[slot] == kEmptySlot).
+    std::size_t find_slot(std::string_view agent_id, std::uint32_t hash) const noexcept;
+
+    // Drop entry `handle` from index_ and the entry array
+    void remove(AgentHandle handle) noexcept;
+
+    std::uint64_t seed_;
+    std::vector<Entry> entries_;
+    std::vector<AgentHandle> free_handles_;   // stack of free entry indices
+    HashIndex index_;                         // entry index or kEmptySlot
     std::size_t max_per_agent_;
     std::size_t total_in_flight_ = 0;
     std::uint64_t quota_rejections_ = 0;
+    std::uint64_t table_full_rejections_ = 0;
 };
 
 // ============================================================================
 // BoundedForwarder
 //
 // Main forwarder component combining queue + quota tracker + sink.
+//
+// Sync mode (default): events wait in a BoundedQueue until the caller runs
+// drain_one()/drain_all(); sink writes happen on the caller's thread.
+//
+// Async mode (ForwarderConfig::async_sink): events go through an SpscRing
+// to a dedicated sink thread, which drains up to sink_batch_size events
+// per Sink::write_batch() call. A slow sink then backs up the ring (and
+// drops at max_queue_depth) instead of stalling the receive loop.
+//
+// DRR mode (ForwarderConfig::scheduler): queued events wait in per-agent
+// sub-queues (DrrQueue, keyed by AgentHandle) and are dequeued round robin
+// by payload bytes, so a bursty agent cannot push a quiet agent's events
+// behind its whole backlog. The queue-depth and quota bounds are the same
+// as in FIFO mode. In async mode the sink thread owns the DrrQueue and
+// moves events into it from the ring as they arrive; queue depth is then
+// counted as events pushed but not yet written.
+//
+// Lanes (ForwarderConfig::lanes): events are queued per Lane, each with
+// its own capacity, so a debug-log storm fills and drops from the Debug
+// lane only and cannot evict metrics or error logs. The lane comes from
+// QueuedEvent::type and ::level. StrictPriority always drains the lowest
+// non-empty lane; Weighted gives each lane lane_weight events per turn, so
+// low lanes are slowed, not starved. Either way the choice scans at most
+// kLaneCount lanes. Within a lane the scheduler (FIFO or DRR) applies as
+// above. Async mode then works as with DRR: the sink thread owns the lane
+// queues, and each lane's depth is its events pushed but not yet written.
+// Per-agent quotas still span all of an agent's lanes.
+//
+// Latency (ForwarderConfig::queue_latency, ::sink_write_latency): one
+// event in 2^latency_sample_shift is stamped at enqueue; when it is
+// written, its queueing time and the duration of the sink call carrying
+// it are recorded. The histograms are written by the draining thread (the
+// sink thread in async mode), which must be their only writer.
+//
+// Payload storage: each queued payload takes one slot (buffer index) of
+// a BufferPool and gives it back once written, in any order. The slab is sized for
+// every event that can be in flight (the queue bound, plus one sink batch
+// in async mode, plus the payload_buffer() slot), so it cannot run out
+// before the queue does, and memory stays flat under overload.
+// Serializing into payload_buffer() avoids the copy.
+//
+// Quota semantics are unchanged: a slot is released once the event has
+// left the queue, whether or not the sink write succeeded. The tracker and
+// the slab are owned by the producer thread; the sink thread hands agent
+// handles and payload slots back via a release ring, applied on the next
+// try_forward()/drain call. The sink
+// thread never dequeues more events than the release ring can take, so
+// no release is ever lost.
 // ============================================================================
 
 class BoundedForwarder {
@@ -108,25 +309,68 @@ public:
     // Takes ownership of the sink.
     explicit BoundedForwarder(ForwarderConfig config, std::unique_ptr<Sink> sink);
 
+    // Stops the sink thread (async mode) after draining the queue.
+    ~BoundedForwarder();
+
+    BoundedForwarder(const BoundedForwarder&) = delete;
+    BoundedForwarder& operator=(const BoundedForwarder&) = delete;
+
     // Attempt to forward an event.
     // Non-blocking: returns immediately with result.
     //
     // Order of checks:
     // 1. Agent quota (fairness)
     // 2. Queue capacity (backlog bound)
+    // 3. Payload size and storage (slot bound)
+    //
+    // event.agent_id only needs to stay valid for the duration of the call
+    // (e.g., a view into the datagram buffer); it is cleared on enqueue.
+    // event.payload is copied into a slot unless it lies at the start of
+    // payload_buffer(), in which case that slot is queued in place.
     [[nodiscard]] ForwardResult try_forward(QueuedEvent event) noexcept;
 
+    // A free payload slot (max_payload_bytes long) held for the next event.
+    // A payload written at its start and passed to try_forward() is queued
+    // without a copy; on any drop the slot is kept for the next call.
+    // Empty only if the slab is exhausted (not expected, see above).
+    [[nodiscard]] std::span<std::byte> payload_buffer() noexcept;
+
     // Process one event from the queue.
     // Pops from queue, releases agent quota, writes to sink.
     // Returns true if an event was processed, false if queue was empty.
     //
     // Call this from a drain loop or worker thread.
+    //
+    // Async mode: the sink thread does the draining; this only applies
+    // pending quota releases and returns false.
     bool drain_one() noexcept;
 
     // Process all available events in the queue.
     // Returns number of events processed.
+    //
+    // Async mode: blocks until the sink thread has written every event
+    // queued so far, applies their quota releases, and returns how many
+    // releases were applied.
     std::size_t drain_all() noexcept;
 
+    // Async mode: apply quota releases handed back by the sink thread.
+    // Returns number applied. Sync mode: no-op, returns 0.
+    std::size_t apply_pending_releases() noexcept;
+
+    // Async mode: drain the queue, flush the sink and join the sink thread.
+    // Idempotent; no further try_forward() calls may be made afterwards.
+    // Sync mode: no-op.
+    void stop() noexcept;
+
+    // Change the per-agent quota in place (producer thread), e.g. from a
+    // ConfigSnapshot. Nothing is drained or dropped: queued events keep
+    // their slots, and an agent above a lowered quota is refused until
+    // enough of its events have been written.
+    void set_max_per_agent(std::size_t max_per_agent) noexcept;
+
+    // True if sink writes run on a dedicated thread
+    [[nodiscard]] bool async() const noexcept { return config_.async_sink; }
+
     // Current queue depth
     [[nodiscard]] std::size_t queue_depth() const noexcept;
 
@@ -136,26 +380,122 @@ public:
     // Check if queue is empty
     [[nodiscard]] bool queue_empty() const noexcept;
 
-    // Access quota tracker (for metrics/testing)
+    // Events queued on one lane (0 with LanePolicy::Single)
+    [[nodiscard]] std::size_t lane_depth(Lane lane) const noexcept;
+
+    // Payload slots held by queued (or in-flight) events, and slab size
+    [[nodiscard]] std::size_t payload_slots_in_use() const noexcept;
+    [[nodiscard]] std::size_t payload_slot_capacity() const noexcept { return slab_.capacity(); }
+
+    // Access quota tracker (for metrics/testing).
+    // Async mode: reflects releases applied so far (see apply_pending_releases).
     [[nodiscard]] const AgentQuotaTracker& quota_tracker() const noexcept;
 
-    // Metrics
-    [[nodiscard]] std::uint64_t total_forwarded() const noexcept { return total_forwarded_; }
-    [[nodiscard]] std::uint64_t total_dropped_queue_full() const noexcept { return dropped_queue_full_; }
-    [[nodiscard]] std::uint64_t total_dropped_quota() const noexcept { return dropped_quota_; }
-    [[nodiscard]] std::uint64_t total_sink_failures() const noexcept { return sink_failures_; }
+    // Metrics (safe to read from the producer thread in async mode)
+    [[nodiscard]] std::uint64_t total_forwarded() const noexcept { return load(total_forwarded_); }
+    [[nodiscard]] std::uint64_t total_dropped_queue_full() const noexcept { return load(dropped_queue_full_); }
+    // Queue-full drops of events of one lane (counted under any LanePolicy)
+    [[nodiscard]] std::uint64_t total_dropped_queue_full(Lane lane) const noexcept {
+        return load(dropped_lane_full_[static_cast<std::size_t>(lane)]);
+    }
+    [[nodiscard]] std::uint64_t total_dropped_quota() const noexcept { return load(dropped_quota_); }
+    [[nodiscard]] std::uint64_t total_dropped_agent_table() const noexcept { return load(dropped_agent_table_); }
+    [[nodiscard]] std::uint64_t total_dropped_payload_storage() const noexcept { return load(dropped_payload_storage_); }
+    [[nodiscard]] std::uint64_t total_dropped_payload_too_large() const noexcept { return load(dropped_payload_too_large_); }
+    [[nodiscard]] std::uint64_t total_sink_failures() const noexcept { return load(sink_failures_); }
+    [[nodiscard]] std::uint64_t total_sink_batches() const noexcept { return load(sink_batches_); }
 
 private:
+    using Counter = std::atomic<std::uint64_t>;
+
+    static std::uint64_t load(const Counter& c) noexcept {
+        return c.load(std::memory_order_relaxed);
+    }
+    // Each counter has a single writer thread, so no locked RMW is needed
+    static void add(Counter& c, std::uint64_t n) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // What the sink thread hands back per written event
+    struct Completion {
+        AgentHandle agent;
+        BufferIndex payload_slot;
+    };
+
+    // Quota slot and payload slot of an event that has left the queue
+    void complete(AgentHandle agent, BufferIndex payload_slot) noexcept;
+
+    // DRR weight for an agent id (binary search of the sorted weight table)
+    std::uint32_t weight_for(std::string_view agent_id) const noexcept;
+
+    // One lane's queue: a BoundedQueue (FIFO) or a DrrQueue. Owned by the
+    // producer in sync mode and by the sink thread in async mode.
+    struct LaneQueue {
+        std::unique_ptr<BoundedQueue<QueuedEvent>> fifo;
+        std::unique_ptr<DrrQueue<QueuedEvent>> drr;
+        std::size_t capacity = 0;
+        std::uint32_t weight = 1;
+        std::uint64_t pushed = 0;               // async: producer only
+        std::atomic<std::uint64_t> written{0};  // async: sink thread
+    };
+
+    // Lane index of an event (0 with LanePolicy::Single)
+    std::size_t lane_index(const QueuedEvent& event) const noexcept;
+
+    // True if the event's lane (or the single queue) cannot take another
+    bool lane_full(std::size_t lane) const noexcept;
+
+    // Queue an event on a lane / pop the next one by LanePolicy
+    // (caller's thread owns the lane queues)
+    PushResult push_lane(QueuedEvent& event, std::size_t lane) noexcept;
+    bool pop_lane(QueuedEvent& out) noexcept;
+    bool lanes_empty() const noexcept;
+
+    // Record a sampled event's queueing time and its sink call's duration
+    // (either skipped when its enqueued_ns / write_end_ns is 0)
+    void record_latency(std::uint64_t enqueued_ns, std::uint64_t write_start_ns,
+                        std::uint64_t write_end_ns) const noexcept;
+
+    void sink_thread_main() noexcept;
+    void wake_sink() noexcept;
+
     ForwarderConfig config_;
     AgentQuotaTracker quota_tracker_;
-    BoundedQueue<QueuedEvent> queue_;
+    std::size_t lane_count_ = 1;        // kLaneCount with lanes, else 1
+    std::array<LaneQueue, kLaneCount> lanes_;
+    bool sink_schedules_ = false;       // async: sink thread owns lanes_
+    std::size_t turn_lane_ = 0;         // Weighted: lane holding the turn
+    std::uint32_t turn_left_ = 0;       // Weighted: events left in the turn
+    std::vector<AgentWeight> weights_;            // sorted by agent_id
+    std::vector<std::uint32_t> agent_weights_;    // DRR weight by AgentHandle
+    BufferPool slab_;                   // payload slots, producer thread only
+    BufferIndex reserved_slot_ = kNoBuffer;             // payload_buffer() slot
+    LatencySampler latency_sampler_;    // producer thread only
+    bool timed_ = false;                // any latency histogram configured
     std::unique_ptr<Sink> sink_;
 
+    // Async mode state (ring_ == nullptr in sync mode)
+    std::unique_ptr<SpscRing<QueuedEvent>> ring_;       // producer -> sink thread
+    std::unique_ptr<SpscRing<Completion>> releases_;    // sink thread -> producer
+    std::vector<QueuedEvent> batch_;                    // sink thread scratch
+    std::vector<std::span<const std::byte>> batch_payloads_;
+    std::uint64_t pushed_ = 0;                          // producer only
+    std::atomic<std::uint64_t> processed_{0};           // sink thread, notified
+    std::atomic<std::uint32_t> wake_seq_{0};
+    std::atomic<bool> sink_sleeping_{false};
+    std::atomic<bool> stopping_{false};
+    std::thread sink_thread_;
+
     // Metrics
-    std::uint64_t total_forwarded_ = 0;
-    std::uint64_t dropped_queue_full_ = 0;
-    std::uint64_t dropped_quota_ = 0;
-    std::uint64_t sink_failures_ = 0;
+    Counter total_forwarded_{0};
+    Counter dropped_queue_full_{0};
+    std::array<Counter, kLaneCount> dropped_lane_full_{};
+    Counter dropped_quota_{0};
+    Counter dropped_agent_table_{0};
+    Counter dropped_payload_storage_{0};
+    Counter dropped_payload_too_large_{0};
+    Counter sink_failures_{0};
+    Counter sink_batches_{0};
 };
 
 }  // namespace gateway
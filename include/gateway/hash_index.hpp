@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// Shared building blocks for the fixed-size id tables (AgentQuotaTracker,
+// SeqDeduplicator, AgentLimiter, MetricsAggregator, ColumnarEncoder).
+//
+// hash_mix / hash_bytes: murmur3's fmix64 finalizer, applied once per
+// 8-byte word of a string. Seeded per instance by the caller: ids are
+// attacker-chosen, so probe runs and collisions must not be buildable
+// from the id alone. hash_bytes chains (its result can seed the next
+// call), and the length is mixed first so ("ab", "c") and ("a", "bc")
+// differ.
+//
+// HashIndex: open-addressed index of entry numbers into a caller-owned
+// entry array. Linear probing over a power-of-two slot array sized for a
+// load factor <= 0.5, so an empty slot always ends a probe; deletion is
+// backward-shift, so lookups never need tombstones. The caller supplies
+// key matching and each entry's home slot, so entries keep whatever key
+// and hash they already store. Never allocates after construction.
+//
+// Thread safety: NOT thread-safe (owned by the table's thread).
+// ============================================================================
+
+inline std::uint64_t hash_mix(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline std::uint64_t hash_bytes(std::uint64_t seed, std::string_view s) noexcept {
+    std::uint64_t h = hash_mix(seed ^ (s.size() * 0x9e3779b97f4a7c15ULL));
+    std::size_t off = 0;
+    for (; off + 8 <= s.size(); off += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, s.data() + off, sizeof(word));
+        h = hash_mix(h ^ word);
+    }
+    if (off < s.size()) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, s.data() + off, s.size() - off);
+        h = hash_mix(h ^ word);
+    }
+    return h;
+}
+
+class HashIndex {
+public:
+    static constexpr std::uint32_t kNil = UINT32_MAX;
+
+    // Room for max_entries entries at load factor <= 0.5
+    explicit HashIndex(std::size_t max_entries)
+        : slots_(std::bit_ceil(std::max<std::size_t>(max_entries, 1) * 2), kNil)
+        , mask_(slots_.size() - 1) {}
+
+    // Home slot of a hash
+    [[nodiscard]] std::size_t home(std::uint64_t hash) const noexcept {
+        return static_cast<std::size_t>(hash) & mask_;
+    }
+
+    // Entry number in a slot, or kNil if the slot is empty
+    [[nodiscard]] std::uint32_t operator[](std::size_t slot) const noexcept { return slots_[slot]; }
+
+    void set(std::size_t slot, std::uint32_t entry) noexcept { slots_[slot] = entry; }
+
+    // Slot whose entry satisfies match(entry) along the probe run from
+    // `home`, or the empty slot where such an entry would be inserted
+    template <typename Match>
+    [[nodiscard]] std::size_t find(std::size_t home, Match&& match) const noexcept {
+        std::size_t slot = home;
+        while (slots_[slot] != kNil && !match(slots_[slot])) {
+            slot = (slot + 1) & mask_;
+        }
+        return slot;
+    }
+
+    // Slot holding `entry` (precondition: it is indexed from `home`)
+    [[nodiscard]] std::size_t slot_of(std::size_t home, std::uint32_t entry) const noexcept {
+        return find(home, [entry](std::uint32_t n) { return n == entry; });
+    }
+
+    // Empty `slot`, pulling later members of its probe run into the hole.
+    // home_of(entry) must give the home slot each entry was inserted at.
+    template <typename HomeOf>
+    void erase(std::size_t slot, HomeOf&& home_of) noexcept {
+        std::size_t hole = slot;
+        std::size_t next = (hole + 1) & mask_;
+        while (slots_[next] != kNil) {
+            const std::size_t home = home_of(slots_[next]);
+            // Move if `home` is not cyclically within (hole, next]
+            if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+                slots_[hole] = slots_[next];
+                hole = next;
+            }
+            next = (next + 1) & mask_;
+        }
+        slots_[hole] = kNil;
+    }
+
+    // Empty every slot
+    void clear() noexcept { std::fill(slots_.begin(), slots_.end(), kNil); }
+
+    [[nodiscard]] std::size_t slot_count() const noexcept { return slots_.size(); }
+    [[nodiscard]] std::size_t memory_bytes() const noexcept {
+        return slots_.size() * sizeof(std::uint32_t);
+    }
+
+private:
+    std::vector<std::uint32_t> slots_;
+    std::size_t mask_;
+};
+
+}  // namespace gateway
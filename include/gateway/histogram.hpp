@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace gateway {
+
+// Monotonic clock for latency measurement, in nanoseconds
+inline std::uint64_t monotonic_ns() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ============================================================================
+// Log-linear histogram buckets
+//
+// Values below kSubBuckets get one bucket each. Above that, every power of
+// two is split into kSubBuckets equal sub-buckets, so a bucket's width is
+// at most 1/kSubBuckets (12.5%) of its lower bound across the full 64-bit
+// range. Mapping a value is a count-leading-zeros and two shifts.
+// ============================================================================
+
+struct HistogramBuckets {
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+    static constexpr std::size_t kCount = kSubBuckets + (64 - kSubBucketBits) * kSubBuckets;
+
+    static constexpr std::size_t index(std::uint64_t value) noexcept {
+        if (value < kSubBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned exp = 63 - static_cast<unsigned>(std::countl_zero(value));
+        const std::size_t sub = (value >> (exp - kSubBucketBits)) & (kSubBuckets - 1);
+        return (exp - kSubBucketBits + 1) * kSubBuckets + sub;
+    }
+
+    // Smallest value mapped to bucket i
+    static constexpr std::uint64_t lower_bound(std::size_t i) noexcept {
+        if (i < kSubBuckets) {
+            return i;
+        }
+        const std::size_t exp = i / kSubBuckets + kSubBucketBits - 1;
+        return (kSubBuckets + i % kSubBuckets) << (exp - kSubBucketBits);
+    }
+
+    // Largest value mapped to bucket i
+    static constexpr std::uint64_t upper_bound(std::size_t i) noexcept {
+        return i + 1 < kCount ? lower_bound(i + 1) - 1 : UINT64_MAX;
+    }
+};
+
+static_assert(HistogramBuckets::index(UINT64_MAX) == HistogramBuckets::kCount - 1);
+static_assert(HistogramBuckets::lower_bound(HistogramBuckets::index(1000)) <= 1000);
+static_assert(HistogramBuckets::upper_bound(HistogramBuckets::index(1000)) >= 1000);
+
+// Plain copy of a histogram: mergeable, and where percentiles are read
+struct HistogramSnapshot {
+    std::array<std::uint64_t, HistogramBuckets::kCount> buckets{};
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+
+    [[nodiscard]] std::uint64_t count() const noexcept {
+        std::uint64_t n = 0;
+        for (std::uint64_t b : buckets) {
+            n += b;
+        }
+        return n;
+    }
+
+    [[nodiscard]] std::uint64_t mean() const noexcept {
+        const std::uint64_t n = count();
+        return n == 0 ? 0 : sum / n;
+    }
+
+    // Upper bound of the bucket holding the q-quantile (q in [0, 1]),
+    // capped at the largest value recorded. 0 if empty.
+    [[nodiscard]] std::uint64_t percentile(double q) const noexcept {
+        const std::uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+        q = q < 0 ? 0 : (q > 1 ? 1 : q);
+        // Nearest rank: the smallest value with at least q x n values <= it
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(n)));
+        rank = rank == 0 ? 1 : (rank > n ? n : rank);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                const std::uint64_t upper = HistogramBuckets::upper_bound(i);
+                return upper < max ? upper : max;
+            }
+        }
+        return max;
+    }
+
+    void merge(const HistogramSnapshot& other) noexcept {
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        sum += other.sum;
+        max = other.max > max ? other.max : max;
+    }
+};
+
+// ============================================================================
+// LatencyHistogram
+//
+// Log-linear histogram of durations (ns), recorded by one thread and read
+// by any. record() is a few relaxed loads and stores on memory the writer
+// owns: no locked RMW and no allocation.
+// A concurrent snapshot() sees each bucket at some recent value; it may
+// lag the sum by the records in flight, never tear a counter.
+//
+// Thread safety: single writer, any number of concurrent readers.
+// ============================================================================
+
+class LatencyHistogram {
+public:
+    void record(std::uint64_t value) noexcept {
+        bump(buckets_[HistogramBuckets::index(value)], 1);
+        bump(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot s;
+        for (std::size_t i = 0; i < buckets_.size(); ++i) {
+            s.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        s.sum = sum_.load(std::memory_order_relaxed);
+        s.max = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, HistogramBuckets::kCount> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Picks one call in 2^shift, so timing (two clock reads) is paid on a
+// fixed fraction of packets. shift 0 samples every call.
+class LatencySampler {
+public:
+    explicit LatencySampler(unsigned shift = 0) noexcept
+        : mask_(shift >= 32 ? UINT32_MAX : (std::uint32_t{1} << shift) - 1) {}
+
+    [[nodiscard]] bool next() noexcept { return (seq_++ & mask_) == 0; }
+
+private:
+    std::uint32_t mask_;
+    std::uint32_t seq_ = 0;
+};
+
+}  // namespace gateway
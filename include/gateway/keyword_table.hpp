@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace gateway {
+
+// ============================================================================
+// Compile-time perfect hash for small fixed keyword sets (schema keys,
+// level names).
+//
+// The hash mixes length, first byte and last byte with two multipliers;
+// the consteval constructor searches for multipliers that map every
+// keyword to its own slot, so a lookup is one hash, one slot load and one
+// string compare against the single candidate. A keyword set with no
+// perfect assignment fails to compile.
+//
+// Key is an enum whose first N enumerators name the keywords in order,
+// followed by Key::Unknown.
+// ============================================================================
+
+template <typename Key, std::size_t N>
+class KeywordTable {
+public:
+    static_assert(static_cast<std::size_t>(Key::Unknown) == N,
+                  "Key must list the N keywords in order, then Unknown");
+
+    // Sparse enough that short sets (e.g. one-letter keys) find a perfect
+    // assignment; one byte per slot
+    static constexpr std::size_t kSlots = std::bit_ceil(N * 4 < 16 ? std::size_t{16} : N * 4);
+
+    consteval explicit KeywordTable(const std::array<std::string_view, N>& words)
+        : words_(words) {
+        for (std::uint32_t a = 1; a < 64; ++a) {
+            for (std::uint32_t b = 1; b < 64; ++b) {
+                if (try_build(a, b)) {
+                    return;
+                }
+            }
+        }
+        // Not a constant expression: turns a failed search into a
+        // compile error at the table's definition
+        throw "KeywordTable: no perfect hash for this keyword set";
+    }
+
+    [[nodiscard]] constexpr Key find(std::string_view s) const noexcept {
+        if (s.empty()) {
+            return Key::Unknown;
+        }
+        const std::uint8_t i = slots_[slot(s, mul_len_, mul_last_)];
+        return (i != kEmpty && words_[i] == s) ? static_cast<Key>(i) : Key::Unknown;
+    }
+
+private:
+    static constexpr std::uint8_t kEmpty = 0xFF;
+
+    static constexpr std::size_t slot(std::string_view s, std::uint32_t a,
+                                      std::uint32_t b) noexcept {
+        const auto first = static_cast<unsigned char>(s.front());
+        const auto last = static_cast<unsigned char>(s.back());
+        return (static_cast<std::uint32_t>(s.size()) * a + first + last * b) & (kSlots - 1);
+    }
+
+    constexpr bool try_build(std::uint32_t a, std::uint32_t b) noexcept {
+        slots_.fill(kEmpty);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (words_[i].empty()) {
+                return false;
+            }
+            std::uint8_t& s = slots_[slot(words_[i], a, b)];
+            if (s != kEmpty) {
+                return false;
+            }
+            s = static_cast<std::uint8_t>(i);
+        }
+        mul_len_ = a;
+        mul_last_ = b;
+        return true;
+    }
+
+    std::array<std::string_view, N> words_;
+    std::array<std::uint8_t, kSlots> slots_{};
+    std::uint32_t mul_len_ = 0;
+    std::uint32_t mul_last_ = 0;
+};
+
+}  // namespace gateway
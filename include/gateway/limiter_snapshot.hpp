@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace gateway {
+
+// ============================================================================
+// FlatSourceLimiter snapshot file layout (warm restart)
+//
+// One header followed by `count` fixed-size records, most recently used
+// source first, all in host byte order (a byte-swapped magic is rejected).
+// The file is written through a shared mapping into `<path>.tmp` and
+// renamed over `path`, so a reader sees either the old or the new file.
+//
+// Bucket ages are stored relative to the save (idle_ns) plus the wall
+// clock at save time. Restoring rebases them on the new process's clock
+// and refills for the downtime, so the layout stays valid across
+// processes and reboots.
+// ============================================================================
+
+inline constexpr std::uint64_t kLimiterSnapshotMagic = 0x31544D4C57544147ULL;  // "GATWLMT1"
+inline constexpr std::uint32_t kLimiterSnapshotVersion = 1;
+
+struct LimiterSnapshotHeader {
+    std::uint64_t magic;            // kLimiterSnapshotMagic
+    std::uint32_t version;          // kLimiterSnapshotVersion
+    std::uint32_t record_size;      // sizeof(LimiterSnapshotRecord)
+    std::uint64_t count;            // records after the header
+    std::int64_t saved_wall_ns;     // system_clock at save
+    std::uint32_t tokens_per_sec;   // config at save (informational)
+    std::uint32_t burst_tokens;
+    std::uint64_t checksum;         // snapshot_checksum() of the records
+};
+
+struct LimiterSnapshotRecord {
+    std::uint32_t ip;               // host byte order, as SourceKey
+    std::uint16_t port;
+    std::uint16_t reserved;         // 0
+    std::uint64_t tokens;           // nano-tokens (1 token = 1e9)
+    std::int64_t idle_ns;           // time since the bucket's last refill
+};
+
+static_assert(sizeof(LimiterSnapshotHeader) == 48);
+static_assert(sizeof(LimiterSnapshotRecord) == 24);
+static_assert(std::is_trivially_copyable_v<LimiterSnapshotRecord>);
+
+// Outcome of FlatSourceLimiter::save_snapshot() / restore_snapshot()
+enum class SnapshotStatus : std::uint8_t {
+    Ok,
+    NotFound,    // No snapshot file (e.g. first start)
+    IoError,     // open/mmap/write/rename failed
+    BadFormat,   // Wrong magic, version, size or checksum
+};
+
+// Checksum of `count` records: word-wise multiply-xor, 3 words per record
+std::uint64_t snapshot_checksum(const LimiterSnapshotRecord* records, std::size_t count) noexcept;
+
+}  // namespace gateway
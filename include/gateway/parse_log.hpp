@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string_view>
 #include <variant>
@@ -53,6 +54,11 @@ enum class LogDropReason : std::uint8_t {
     MissingMessage,       // Required "msg" field missing
     InvalidTimestamp,     // "ts" is not a valid integer
     InvalidLevel,         // "level" is not a recognized level string
+
+    // Binary body (binary_format.hpp)
+    BinaryUnsupportedVersion, // version byte not understood
+    BinaryTruncated,          // body ends inside a field
+    BinaryMalformed,          // bad varint, reserved field key or trailing bytes
 };
 
 // Single log field (key-value pair, views into original input)
@@ -61,7 +67,11 @@ struct LogField {
     std::string_view value;
 };
 
-// Parsed log entry (views into original input, no allocation)
+// Parsed log entry (views into original input, no allocation).
+//
+// Intended as a caller-owned scratch object reused across messages: the
+// parse-into overload of parse_log() resets only field_count, so slots
+// beyond it are never touched per message.
 struct ParsedLog {
     std::uint64_t ts;                // parsed from "ts" field
     LogLevel level;                  // parsed from "level" field
@@ -76,20 +86,29 @@ struct ParsedLog {
 // Result type: success or explicit drop reason
 using LogResult = std::variant<ParsedLog, LogDropReason>;
 
-// TB-3: Parse and validate logfmt log message.
+// TB-3: Parse and validate logfmt log message into `out`.
 //
 // Precondition: input is the body from TB-2 envelope parsing.
 //
+// A body starting with the binary magic is decoded by parse_binary_log()
+// instead (binary_format.hpp).
+//
 // Contract:
 // - Parses logfmt syntax in single pass
-// - Memory: O(1) allocation (fixed-size ParsedLog struct)
+// - Memory: no allocation; fills the caller-owned `out`
 // - CPU: O(n) where n = input.size(), bounded by kMaxLineBytes
 // - No regex, no backtracking
 // - Never throws
-// - Returns views into original input (caller must keep input alive)
-LogResult parse_log(std::span<const std::byte> input) noexcept;
+// - Returns std::nullopt on success, otherwise the drop reason; on a
+//   drop the contents of `out` are unspecified
+// - `out` holds views into original input (caller must keep input alive)
+std::optional<LogDropReason> parse_log(std::span<const std::byte> input,
+                                       ParsedLog& out) noexcept;
+std::optional<LogDropReason> parse_log(std::string_view input, ParsedLog& out) noexcept;
 
-// Convenience overload for string_view
+// Convenience overloads returning the result by value (copies ParsedLog
+// into the variant; per-packet paths should reuse a scratch object)
+LogResult parse_log(std::span<const std::byte> input) noexcept;
 LogResult parse_log(std::string_view input) noexcept;
 
 // Convert LogLevel to string (for logging/metrics)
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string_view>
 #include <variant>
@@ -23,17 +24,24 @@ struct MetricsLimits {
     static constexpr std::size_t kMaxMetrics = 50;
     static constexpr std::size_t kMaxMetricNameLen = 128;
     static constexpr std::size_t kMaxUnitLen = 16;
-    static constexpr std::size_t kMaxTags = 8;
+    static constexpr std::size_t kMaxTags = 8;            // per metric
+    static constexpr std::size_t kMaxTotalTags = 128;     // per message (flat pool)
     static constexpr std::size_t kMaxTagKeyLen = 64;
     static constexpr std::size_t kMaxTagValueLen = 64;
     static constexpr std::size_t kMaxInputBytes = 65536;  // 64KB max input
     static constexpr std::size_t kMaxNestingDepth = 4;
+
+    // Unescaped JSON strings (ParsedMetrics::text): room for every stored
+    // string at its limit
+    static constexpr std::size_t kMaxTextBytes =
+        kMaxAgentIdLen + kMaxMetrics * (kMaxMetricNameLen + kMaxUnitLen) +
+        kMaxTotalTags * (kMaxTagKeyLen + kMaxTagValueLen);
 };
 
 // Drop reasons for metrics parsing (explicit enum, not attacker-controlled)
 enum class MetricsDropReason : std::uint8_t {
     InputTooLarge,        // Input exceeds kMaxInputBytes
-    InvalidJson,          // Malformed JSON syntax
+    InvalidJson,          // Malformed JSON syntax (incl. bad string escapes)
     NestingTooDeep,       // Exceeds kMaxNestingDepth
     MissingRequiredField, // agent_id, seq, or metrics missing
     AgentIdTooLong,       // agent_id exceeds kMaxAgentIdLen
@@ -44,54 +52,98 @@ enum class MetricsDropReason : std::uint8_t {
     MetricMissingValue,   // metric missing "v" field
     MetricValueNotNumber, // metric "v" is not a number
     UnitTooLong,          // unit exceeds kMaxUnitLen
-    TooManyTags,          // tags exceed kMaxTags
+    TooManyTags,          // tags exceed kMaxTags or kMaxTotalTags
     TagKeyTooLong,        // tag key exceeds kMaxTagKeyLen
     TagValueTooLong,      // tag value exceeds kMaxTagValueLen
     UnexpectedField,      // field not in schema (additionalProperties: false)
     InvalidFieldType,     // field has wrong type
+
+    // Binary body (binary_format.hpp)
+    BinaryUnsupportedVersion, // version byte not understood
+    BinaryTruncated,          // body ends inside a field
+    BinaryMalformed,          // bad varint, bad name ref or trailing bytes
+
+    // Appended so earlier values (and their stats slots) keep their numbers
+    DuplicateField,       // root key repeated in the same object
 };
 
-// Single tag (key-value pair, views into original input)
+// Single tag (key-value pair, views into original input or
+// ParsedMetrics::text)
 struct MetricTag {
     std::string_view key;
     std::string_view value;
 };
 
-// Single metric entry (views into original input)
+// Single metric entry (views into original input or ParsedMetrics::text).
+// Tags live in the message-wide pool: ParsedMetrics::tags[tag_offset,
+// tag_offset + tag_count). Use ParsedMetrics::tags_of() to access them.
 struct Metric {
     std::string_view name;           // "n" field
     double value;                    // "v" field
     std::string_view unit;           // "u" field (optional, empty if absent)
-    std::array<MetricTag, MetricsLimits::kMaxTags> tags;
-    std::size_t tag_count;           // actual number of tags
+    std::uint16_t tag_offset;        // first tag in the pool
+    std::uint16_t tag_count;         // actual number of tags
 };
 
-// Parsed metrics message (views into original input, no allocation)
+// Parsed metrics message (views into original input, no allocation).
+//
+// Strings hold the decoded bytes: a JSON string without escapes is a view
+// into the input, one with escapes ("\\", "\u00e9", surrogate pairs) is
+// decoded into `text` and viewed there. Length limits apply to the
+// decoded bytes. Copies rebase views into `text` onto their own.
+//
+// Intended as a caller-owned scratch object reused across messages: the
+// parse-into overload of parse_metrics() resets only the counts, so slots
+// beyond metric_count / tag_total are never touched per message.
 struct ParsedMetrics {
+    ParsedMetrics() noexcept = default;
+    ParsedMetrics(const ParsedMetrics& other) noexcept;
+    ParsedMetrics& operator=(const ParsedMetrics& other) noexcept;
+
     std::string_view agent_id;
-    std::uint32_t seq;
-    std::uint64_t ts;                // timestamp (optional, 0 if absent)
+    std::uint32_t seq = 0;
+    std::uint64_t ts = 0;            // timestamp (optional, 0 if absent)
     std::array<Metric, MetricsLimits::kMaxMetrics> metrics;
-    std::size_t metric_count;        // actual number of metrics
+    std::size_t metric_count = 0;    // actual number of metrics
+    std::array<MetricTag, MetricsLimits::kMaxTotalTags> tags;  // shared by all metrics
+    std::size_t tag_total = 0;       // tags used across all metrics
+    std::array<char, MetricsLimits::kMaxTextBytes> text;  // decoded escaped strings
+    std::size_t text_used = 0;       // bytes of `text` in use
+
+    [[nodiscard]] std::span<const MetricTag> tags_of(const Metric& m) const noexcept {
+        return {tags.data() + m.tag_offset, m.tag_count};
+    }
 };
 
 // Result type: success or explicit drop reason
 using MetricsResult = std::variant<ParsedMetrics, MetricsDropReason>;
 
-// TB-3: Parse and validate JSON metrics message.
+// TB-3: Parse and validate JSON metrics message into `out`.
 //
 // Precondition: input is the body from TB-2 envelope parsing.
 //
+// A body starting with the binary magic is decoded by
+// parse_binary_metrics() instead (binary_format.hpp).
+//
 // Contract:
 // - Validates JSON syntax and schema in single pass
-// - Memory: O(1) allocation (fixed-size ParsedMetrics struct)
+// - Memory: no allocation; fills the caller-owned `out`
 // - CPU: O(n) where n = input.size(), bounded by kMaxInputBytes
 // - Never allocates based on attacker-controlled lengths
 // - Never throws
-// - Returns views into original input (caller must keep input alive)
-MetricsResult parse_metrics(std::span<const std::byte> input) noexcept;
+// - Returns std::nullopt on success, otherwise the drop reason; on a
+//   drop the contents of `out` are unspecified
+// - `out` holds views into original input (caller must keep input alive)
+//   and into its own `text`
+std::optional<MetricsDropReason> parse_metrics(std::span<const std::byte> input,
+                                               ParsedMetrics& out) noexcept;
+std::optional<MetricsDropReason> parse_metrics(std::string_view input,
+                                               ParsedMetrics& out) noexcept;
 
-// Convenience overload for string_view
+// Convenience overloads returning the result by value. These copy the
+// whole ParsedMetrics into the variant; per-packet paths should reuse a
+// scratch object with the overloads above.
+MetricsResult parse_metrics(std::span<const std::byte> input) noexcept;
 MetricsResult parse_metrics(std::string_view input) noexcept;
 
 } // namespace gateway
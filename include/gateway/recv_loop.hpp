@@ -1,11 +1,14 @@
 #pragma once
 
+#include "gateway/buffer_pool.hpp"
 #include "gateway/config.hpp"
 #include "gateway/source_limiter.hpp"
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <variant>
 #include <vector>
@@ -17,13 +20,20 @@ enum class RecvStatus : std::uint8_t {
     Ok,                // Successfully received a datagram
     Truncated,         // Datagram exceeded max size (MSG_TRUNC)
     Error,             // System error during recv
-    WouldBlock         // No data available (non-blocking mode)
+    WouldBlock,        // No data available (non-blocking mode)
+    NoBuffer           // Buffer pool exhausted; datagram left in kernel queue
 };
 
-// A received datagram with source information
+// A received datagram with source information.
+//
+// `data` is a view into a pooled buffer owned by `buffer`; the bytes stay
+// where the kernel wrote them (no per-packet allocation or copy). The
+// buffer returns to the RecvLoop's pool when the Datagram is destroyed,
+// so a Datagram must not outlive the RecvLoop that produced it.
 struct Datagram {
-    std::vector<std::byte> data;
+    std::span<const std::byte> data;
     SourceKey source;
+    BufferHandle buffer;
 };
 
 // Result of a recv operation
@@ -38,14 +48,27 @@ struct RecvMetrics {
     std::uint64_t received = 0;       // Successfully received
     std::uint64_t truncated = 0;      // Dropped due to MSG_TRUNC
     std::uint64_t errors = 0;         // System errors
+    std::uint64_t no_buffer = 0;      // Recv skipped: buffer pool exhausted
 };
 
 // Low-level UDP receiver with TB-1 enforcement.
 //
 // Responsibilities:
-// - Configure socket options (SO_RCVBUF, IP_PMTUDISC_DO)
+// - Configure socket options (SO_RCVBUF, IP_PMTUDISC_DO, optional SO_BUSY_POLL)
 // - Enforce max datagram size at recv (MSG_TRUNC detection)
 // - Extract source IP:port for rate limiting
+// - Batch receive (recvmmsg) to amortize syscall cost under load
+// - Receive directly into a fixed BufferPool (zero allocations per packet)
+//
+// With RecvBackend::IoUring, recv_batch() arms one multishot recvmsg whose
+// datagrams land in pooled buffers lent to the kernel through a provided-
+// buffer ring. Completions are reaped from shared memory; a syscall is
+// made only when none are pending (or to re-arm). TB-1 rules, RecvMetrics
+// and buffer ownership are identical to the recvmmsg path. If io_uring,
+// provided-buffer rings or multishot recvmsg are unavailable (or the first
+// arm fails), the loop falls back to recvmmsg; backend() reports which is
+// in use. recv_one() always uses recvfrom: do not mix it with io_uring
+// batches on one socket, or datagram order between the two is undefined.
 //
 // Thread safety: NOT thread-safe. One RecvLoop per thread.
 class RecvLoop {
@@ -53,6 +76,10 @@ public:
     // Construct with an already-bound UDP socket fd.
     // Takes ownership: will NOT close fd on destruction (caller manages lifetime).
     explicit RecvLoop(int fd, RecvConfig config = {});
+    ~RecvLoop();
+
+    RecvLoop(const RecvLoop&) = delete;
+    RecvLoop& operator=(const RecvLoop&) = delete;
 
     // Configure socket options. Call once after construction.
     // Returns false if any setsockopt fails.
@@ -60,8 +87,32 @@ public:
 
     // Receive a single datagram.
     // Blocks until data available (unless socket is non-blocking).
+    // Returns NoBuffer without reading if every pooled buffer is in use.
     RecvResult recv_one();
 
+    // Receive up to config.batch_size datagrams in one syscall (recvmmsg).
+    // Falls back to repeated recv_one() where recvmmsg is unavailable.
+    //
+    // Each returned result has status Ok or Truncated; TB-1 size enforcement
+    // and RecvMetrics accounting are applied per message, exactly as in
+    // recv_one(). An empty span means no data was available (WouldBlock).
+    // A system error (or an exhausted buffer pool) is reported as a single
+    // result with status Error (or NoBuffer).
+    //
+    // The returned span is valid until the next call to recv_batch(), which
+    // returns any buffers still held by it to the pool. Callers may move a
+    // Datagram out of the span to keep its buffer longer.
+    std::span<RecvResult> recv_batch();
+
+    // As recv_batch(), but when nothing has arrived, wait up to max_wait
+    // for the first datagram (ppoll, or the io_uring completion wait)
+    // instead of having the caller sleep. Returns an empty span on timeout.
+    // max_wait of zero never blocks, even on a blocking socket.
+    std::span<RecvResult> recv_batch(std::chrono::microseconds max_wait);
+
+    // Backend actually in use (IoUring may have fallen back to Recvmmsg)
+    [[nodiscard]] RecvBackend backend() const noexcept { return backend_; }
+
     // Access metrics
     [[nodiscard]] const RecvMetrics& metrics() const noexcept { return metrics_; }
 
@@ -70,15 +121,54 @@ public:
         return config_.max_datagram_bytes;
     }
 
+    // Get configured batch size (slots per recv_batch call)
+    [[nodiscard]] std::size_t batch_size() const noexcept {
+        return config_.batch_size;
+    }
+
+    // Access the datagram buffer pool (for metrics/testing)
+    [[nodiscard]] const BufferPool& buffer_pool() const noexcept { return pool_; }
+
 private:
+    // Preallocated recvmmsg slots (platform types, defined in recv_loop.cpp)
+    struct BatchState;
+    // io_uring rings and the buffers lent to the kernel (recv_loop.cpp)
+    struct UringState;
+
+    // Return buffers still held by the previous batch
+    void release_batch() noexcept;
+    // Block up to wait_ns (< 0: indefinitely) until the socket is readable
+    bool wait_readable(std::int64_t wait_ns) noexcept;
+    std::span<RecvResult> recv_batch_mmsg();
+    std::span<RecvResult> recv_batch_uring(std::int64_t wait_ns);
+    void fall_back_to_recvmmsg() noexcept;
+
     int fd_;
     RecvConfig config_;
-    std::vector<std::byte> buffer_;  // Reusable recv buffer
+    RecvBackend backend_ = RecvBackend::Recvmmsg;
+    bool blocking_ = true;           // fd lacks O_NONBLOCK (recv_batch() waits)
+    BufferPool pool_;                // Datagram buffers (kernel writes here)
+    std::unique_ptr<BatchState> batch_;
+    std::vector<RecvResult> batch_results_;  // Reused across recv_batch calls
+    std::unique_ptr<UringState> uring_;      // Destroyed first: holds pool_ buffers
     RecvMetrics metrics_;
 };
 
 // Utility: Create and bind a UDP socket
 // Returns fd on success, -1 on failure
-int create_udp_socket(std::uint16_t port);
+// reuse_port: set SO_REUSEPORT so several sockets can share the port
+int create_udp_socket(std::uint16_t port, bool reuse_port = false);
+
+// Utility: Create `count` UDP sockets bound to the same port with
+// SO_REUSEPORT, one per ingest worker. The kernel spreads datagrams across
+// them by 4-tuple hash, so each source consistently lands on one socket.
+// If port is 0, all sockets share the port the first one was assigned.
+// Returns the fds on success; on failure closes any opened fds and returns
+// an empty vector.
+std::vector<int> create_reuseport_sockets(std::uint16_t port, std::size_t count);
+
+// Utility: Pin the calling thread to one CPU.
+// Returns false if pinning is unsupported or the CPU is unavailable.
+bool pin_current_thread_to_cpu(int cpu);
 
 }  // namespace gateway
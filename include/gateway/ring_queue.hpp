@@ -0,0 +1,387 @@
+#pragma once
+
+#include "gateway/bounded_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// Concurrent bounded rings (lock-free)
+//
+// Same drop-on-full semantics and drop_count() accounting as BoundedQueue,
+// for handing events between threads (e.g. ingest -> sink):
+// - SpscRing: one producer thread, one consumer thread
+// - MpscRing: any number of producer threads, one consumer thread
+//
+// Both round capacity up to a power of two (index masking, no modulo) and
+// keep producer and consumer state on separate cache lines.
+// ============================================================================
+
+// Cache line size used to pad producer/consumer state apart
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// Smallest power of two >= n (and >= 1)
+constexpr std::size_t round_up_pow2(std::size_t n) noexcept {
+    return std::bit_ceil(std::max<std::size_t>(n, 1));
+}
+
+// Single-producer single-consumer ring.
+//
+// Thread safety: try_push/try_push_n from exactly one producer thread;
+// try_pop/try_pop_n/peek from exactly one consumer thread. size()/empty()/
+// full()/drop_count() may be read from any thread (approximate while the
+// other side is active).
+//
+// Template parameter T must be default-constructible and movable.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : capacity_(round_up_pow2(capacity))
+        , mask_(capacity_ - 1)
+        , buffer_(capacity_) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: push an item. Returns Dropped if the ring is full.
+    PushResult try_push(T item) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                count_drops(1);
+                return PushResult::Dropped;
+            }
+        }
+        buffer_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return PushResult::Ok;
+    }
+
+    // Producer: push as many items as fit, moving them out of `items` in
+    // order. Items that do not fit are dropped (counted in drop_count).
+    // Returns the number pushed.
+    std::size_t try_push_n(std::span<T> items) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (capacity_ - (tail - cached_head_) < items.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        const std::size_t free_slots = capacity_ - (tail - cached_head_);
+        const std::size_t n = std::min(free_slots, items.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            buffer_[(tail + i) & mask_] = std::move(items[i]);
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+        }
+        if (n < items.size()) {
+            count_drops(items.size() - n);
+        }
+        return n;
+    }
+
+    // Consumer: pop an item. Returns nullopt if empty.
+    std::optional<T> try_pop() noexcept {
+        T item;
+        if (!try_pop(item)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // Consumer: pop into `out` (no optional wrapper). Returns false if empty.
+    bool try_pop(T& out) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: pop up to out.size() items in FIFO order.
+    // Returns the number popped.
+    std::size_t try_pop_n(std::span<T> out) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ - head < out.size()) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        const std::size_t n = std::min(cached_tail_ - head, out.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = std::move(buffer_[(head + i) & mask_]);
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer: peek at the front item without removing it.
+    // Returns nullptr if empty.
+    const T* peek() noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return nullptr;
+            }
+        }
+        return &buffer_[head & mask_];
+    }
+
+    // Current number of items (approximate under concurrency)
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    // Maximum capacity (power of two)
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] bool full() const noexcept { return size() >= capacity_; }
+
+    // Number of items dropped due to overflow (cumulative)
+    [[nodiscard]] std::uint64_t drop_count() const noexcept {
+        return drop_count_.load(std::memory_order_relaxed);
+    }
+
+    // Reset drop counter (call from the producer thread)
+    void reset_drop_count() noexcept { drop_count_.store(0, std::memory_order_relaxed); }
+
+private:
+    // Only the producer writes drop_count_, so no locked RMW is needed
+    void count_drops(std::size_t n) noexcept {
+        drop_count_.store(drop_count_.load(std::memory_order_relaxed) + n,
+                          std::memory_order_relaxed);
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::vector<T> buffer_;
+
+    // Consumer-owned line
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0;   // consumer's last view of tail_
+
+    // Producer-owned line
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;   // producer's last view of head_
+    std::atomic<std::uint64_t> drop_count_{0};
+};
+
+// Multi-producer single-consumer ring.
+//
+// Producers claim slots with a CAS on the shared tail; each slot carries a
+// sequence number so the consumer only reads fully written items.
+//
+// Thread safety: try_push/try_push_n from any number of threads;
+// try_pop/try_pop_n/peek from exactly one consumer thread.
+//
+// Template parameter T must be default-constructible and movable.
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(std::size_t capacity)
+        : capacity_(round_up_pow2(capacity))
+        , mask_(capacity_ - 1)
+        , cells_(capacity_) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Producer: push an item. Returns Dropped if the ring is full.
+    PushResult try_push(T item) noexcept {
+        std::size_t pos = 0;
+        if (claim(1, pos) == 0) {
+            drop_count_.fetch_add(1, std::memory_order_relaxed);
+            return PushResult::Dropped;
+        }
+        publish(pos, std::move(item));
+        return PushResult::Ok;
+    }
+
+    // Producer: push as many items as fit (one CAS for the whole run),
+    // moving them out of `items` in order. Items that do not fit are
+    // dropped (counted in drop_count). Returns the number pushed.
+    std::size_t try_push_n(std::span<T> items) noexcept {
+        if (items.empty()) {
+            return 0;
+        }
+        std::size_t pos = 0;
+        const std::size_t n = claim(items.size(), pos);
+        for (std::size_t i = 0; i < n; ++i) {
+            publish(pos + i, std::move(items[i]));
+        }
+        if (n < items.size()) {
+            drop_count_.fetch_add(items.size() - n, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // Consumer: pop an item. Returns nullopt if empty.
+    std::optional<T> try_pop() noexcept {
+        T item;
+        if (!try_pop(item)) {
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    // Consumer: pop into `out` (no optional wrapper). Returns false if empty.
+    bool try_pop(T& out) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[head & mask_];
+        if (cell.seq.load(std::memory_order_acquire) != head + 1) {
+            return false;  // empty, or producer still writing this slot
+        }
+        out = std::move(cell.value);
+        cell.seq.store(head + capacity_, std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: pop up to out.size() items in FIFO order. Stops at the first
+    // slot a producer has not finished writing. Returns the number popped.
+    std::size_t try_pop_n(std::span<T> out) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t n = 0;
+        while (n < out.size()) {
+            Cell& cell = cells_[(head + n) & mask_];
+            if (cell.seq.load(std::memory_order_acquire) != head + n + 1) {
+                break;
+            }
+            out[n] = std::move(cell.value);
+            cell.seq.store(head + n + capacity_, std::memory_order_relaxed);
+            ++n;
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer: peek at the front item without removing it.
+    // Returns nullptr if empty.
+    const T* peek() noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const Cell& cell = cells_[head & mask_];
+        if (cell.seq.load(std::memory_order_acquire) != head + 1) {
+            return nullptr;
+        }
+        return &cell.value;
+    }
+
+    // Current number of items, including slots still being written
+    // (approximate under concurrency)
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    // Maximum capacity (power of two)
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] bool full() const noexcept { return size() >= capacity_; }
+
+    // Number of items dropped due to overflow (cumulative, all producers)
+    [[nodiscard]] std::uint64_t drop_count() const noexcept {
+        return drop_count_.load(std::memory_order_relaxed);
+    }
+
+    // Reset drop counter (e.g., after reporting metrics)
+    void reset_drop_count() noexcept { drop_count_.store(0, std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq{0};  // == pos + 1 once slot pos is readable
+        T value{};
+    };
+
+    // Claim up to `want` consecutive slots. Returns the number claimed and
+    // the first position in `pos`. Slots below head_ + capacity_ are free:
+    // the consumer releases them (seq store) before advancing head_.
+    std::size_t claim(std::size_t want, std::size_t& pos) noexcept {
+        pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            const std::size_t used = pos - head;
+            if (used >= capacity_) {
+                // Re-check against a fresh tail: our pos may be stale
+                const std::size_t fresh = tail_.load(std::memory_order_relaxed);
+                if (fresh == pos) {
+                    return 0;
+                }
+                pos = fresh;
+                continue;
+            }
+            const std::size_t n = std::min(want, capacity_ - used);
+            if (tail_.compare_exchange_weak(pos, pos + n,
+                                            std::memory_order_relaxed,
+                                            std::memory_order_relaxed)) {
+                return n;
+            }
+            // pos reloaded by the failed CAS
+        }
+    }
+
+    void publish(std::size_t pos, T&& item) noexcept {
+        Cell& cell = cells_[pos & mask_];
+        cell.value = std::move(item);
+        cell.seq.store(pos + 1, std::memory_order_release);
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::vector<Cell> cells_;
+
+    // Consumer-owned line
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+
+    // Producer-shared line
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+    alignas(kCacheLineSize) std::atomic<std::uint64_t> drop_count_{0};
+};
+
+// Common interface of the drop-on-full queues, so components (e.g. the
+// forwarder) can be written against any of them.
+template <typename Q, typename T>
+concept DropOnFullQueue = requires(Q& q, T item, T& out, std::span<T> items) {
+    { q.try_push(std::move(item)) } -> std::same_as<PushResult>;
+    { q.try_pop() } -> std::same_as<std::optional<T>>;
+    { q.try_pop(out) } -> std::same_as<bool>;
+    { q.try_push_n(items) } -> std::same_as<std::size_t>;
+    { q.try_pop_n(items) } -> std::same_as<std::size_t>;
+    { q.size() } -> std::same_as<std::size_t>;
+    { q.capacity() } -> std::same_as<std::size_t>;
+    { q.empty() } -> std::same_as<bool>;
+    { q.drop_count() } -> std::same_as<std::uint64_t>;
+};
+
+static_assert(DropOnFullQueue<BoundedQueue<int>, int>);
+static_assert(DropOnFullQueue<SpscRing<int>, int>);
+static_assert(DropOnFullQueue<MpscRing<int>, int>);
+
+}  // namespace gateway
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "gateway/char_class.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GATEWAY_SCAN_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GATEWAY_SCAN_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GATEWAY_SCAN_NEON 1
+#endif
+
+namespace gateway::scan {
+
+// ============================================================================
+// Byte-class scanning for the TB-3 parsers.
+//
+// Each function scans [p, p + n) and returns the offset of the first byte
+// that stops the scan, or n if none does. They never read outside
+// [p, p + n): vector loops only run on full blocks and the tail goes
+// through the scalar loop, so no padding is required of the caller.
+//
+// delimiter_bitmaps() instead classifies a whole line in one pass into
+// bitmaps (bit i of word i / 64 describes byte i), so a tokenizer can
+// find every separator with bit scans rather than per-byte branches.
+//
+// The vector path is chosen at compile time (AVX2 > SSE2 > NEON > none).
+// The scalar namespace is the reference implementation: it is the fallback
+// on other targets and what the vector paths are differentially tested
+// against.
+// ============================================================================
+
+namespace scalar {
+
+// First '"' or '\\'
+inline std::size_t find_quote_or_escape(const char* p, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (p[i] == '"' || p[i] == '\\') {
+            return i;
+        }
+    }
+    return n;
+}
+
+// First byte that is not JSON whitespace (' ', '\t', '\n', '\r')
+inline std::size_t skip_whitespace(const char* p, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!chars::is(p[i], chars::kJsonSpace)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// First byte that is not an ASCII digit
+inline std::size_t skip_digits(const char* p, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!chars::is(p[i], chars::kDigit)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// logfmt delimiters over [p, p + n): blank = ' ' or '\t', equals = '=',
+// quote = '"'. Each output holds (n + 63) / 64 words; bits >= n are zero.
+inline void delimiter_bitmaps(const char* p, std::size_t n, std::uint64_t* blank,
+                              std::uint64_t* equals, std::uint64_t* quote) noexcept {
+    const std::size_t words = (n + 63) / 64;
+    for (std::size_t w = 0; w < words; ++w) {
+        blank[w] = equals[w] = quote[w] = 0;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t bit = std::uint64_t{1} << (i % 64);
+        const char c = p[i];
+        if (chars::is(c, chars::kLogBlank)) blank[i / 64] |= bit;
+        if (c == '=') equals[i / 64] |= bit;
+        if (c == '"') quote[i / 64] |= bit;
+    }
+}
+
+}  // namespace scalar
+
+#if defined(GATEWAY_SCAN_AVX2)
+
+inline constexpr std::size_t kBlockBytes = 32;
+inline constexpr const char* kPathName = "avx2";
+
+namespace detail {
+
+using Block = __m256i;
+
+inline Block load(const char* p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+inline Block eq(Block v, char c) noexcept {
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+inline Block any(Block a, Block b) noexcept { return _mm256_or_si256(a, b); }
+// Lanes where (unsigned)(v - '0') <= 9
+inline Block digit(Block v) noexcept {
+    const Block d = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+}
+// Offset of the first set lane, or kBlockBytes
+inline std::size_t first(Block m) noexcept {
+    const auto bits = static_cast<unsigned>(_mm256_movemask_epi8(m));
+    return bits == 0 ? kBlockBytes : static_cast<std::size_t>(std::countr_zero(bits));
+}
+inline std::size_t first_clear(Block m) noexcept {
+    const auto bits = ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+    return bits == 0 ? kBlockBytes : static_cast<std::size_t>(std::countr_zero(bits));
+}
+
+// Per-byte masks of a 64-byte chunk as bitmaps
+struct Masks64 {
+    std::uint64_t blank, equals, quote;
+};
+inline std::uint64_t bits32(Block m) noexcept {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(m));
+}
+inline Masks64 classify64(const char* p) noexcept {
+    const Block lo = load(p);
+    const Block hi = load(p + 32);
+    return {bits32(any(eq(lo, ' '), eq(lo, '\t'))) | bits32(any(eq(hi, ' '), eq(hi, '\t'))) << 32,
+            bits32(eq(lo, '=')) | bits32(eq(hi, '=')) << 32,
+            bits32(eq(lo, '"')) | bits32(eq(hi, '"')) << 32};
+}
+
+}  // namespace detail
+
+#elif defined(GATEWAY_SCAN_SSE2)
+
+inline constexpr std::size_t kBlockBytes = 16;
+inline constexpr const char* kPathName = "sse2";
+
+namespace detail {
+
+using Block = __m128i;
+
+inline Block load(const char* p) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+inline Block eq(Block v, char c) noexcept { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+inline Block any(Block a, Block b) noexcept { return _mm_or_si128(a, b); }
+inline Block digit(Block v) noexcept {
+    const Block d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+}
+inline std::size_t first(Block m) noexcept {
+    const auto bits = static_cast<unsigned>(_mm_movemask_epi8(m));
+    return bits == 0 ? kBlockBytes : static_cast<std::size_t>(std::countr_zero(bits));
+}
+inline std::size_t first_clear(Block m) noexcept {
+    const auto bits = ~static_cast<unsigned>(_mm_movemask_epi8(m)) & 0xFFFFu;
+    return bits == 0 ? kBlockBytes : static_cast<std::size_t>(std::countr_zero(bits));
+}
+
+struct Masks64 {
+    std::uint64_t blank, equals, quote;
+};
+inline Masks64 classify64(const char* p) noexcept {
+    Masks64 out{0, 0, 0};
+    for (unsigned k = 0; k < 4; ++k) {
+        const Block v = load(p + 16 * k);
+        const unsigned shift = 16 * k;
+        out.blank |= std::uint64_t(static_cast<std::uint32_t>(
+                         _mm_movemask_epi8(any(eq(v, ' '), eq(v, '\t'))))) << shift;
+        out.equals |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(eq(v, '='))))
+                      << shift;
+        out.quote |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(eq(v, '"'))))
+                     << shift;
+    }
+    return out;
+}
+
+}  // namespace detail
+
+#elif defined(GATEWAY_SCAN_NEON)
+
+inline constexpr std::size_t kBlockBytes = 16;
+inline constexpr const char* kPathName = "neon";
+
+namespace detail {
+
+using Block = uint8x16_t;
+
+inline Block load(const char* p) noexcept {
+    return vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+}
+inline Block eq(Block v, char c) noexcept {
+    return vceqq_u8(v, vdupq_n_u8(static_cast<std::uint8_t>(c)));
+}
+inline Block any(Block a, Block b) noexcept { return vorrq_u8(a, b); }
+inline Block digit(Block v) noexcept {
+    return vcleq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8(9));
+}
+// No movemask on NEON: narrow each 0x00/0xFF lane to a nibble, giving a
+// 64-bit mask with 4 bits per byte
+inline std::size_t first(Block m) noexcept {
+    const std::uint64_t bits =
+        vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+    return bits == 0 ? kBlockBytes : static_cast<std::size_t>(std::countr_zero(bits) >> 2);
+}
+inline std::size_t first_clear(Block m) noexcept { return first(vmvnq_u8(m)); }
+
+struct Masks64 {
+    std::uint64_t blank, equals, quote;
+};
+// Four 0x00/0xFF masks -> one bit per byte: weight lanes by bit position,
+// then fold with pairwise adds
+inline std::uint64_t bits64(Block m0, Block m1, Block m2, Block m3) noexcept {
+    const uint8x16_t w = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t s0 = vpaddq_u8(vandq_u8(m0, w), vandq_u8(m1, w));
+    uint8x16_t s1 = vpaddq_u8(vandq_u8(m2, w), vandq_u8(m3, w));
+    s0 = vpaddq_u8(s0, s1);
+    s0 = vpaddq_u8(s0, s0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(s0), 0);
+}
+inline Masks64 classify64(const char* p) noexcept {
+    const Block v0 = load(p), v1 = load(p + 16), v2 = load(p + 32), v3 = load(p + 48);
+    auto blank = [](Block v) { return any(eq(v, ' '), eq(v, '\t')); };
+    return {bits64(blank(v0), blank(v1), blank(v2), blank(v3)),
+            bits64(eq(v0, '='), eq(v1, '='), eq(v2, '='), eq(v3, '=')),
+            bits64(eq(v0, '"'), eq(v1, '"'), eq(v2, '"'), eq(v3, '"'))};
+}
+
+}  // namespace detail
+
+#else
+
+inline constexpr std::size_t kBlockBytes = 0;
+inline constexpr const char* kPathName = "scalar";
+
+#endif
+
+#if defined(GATEWAY_SCAN_AVX2) || defined(GATEWAY_SCAN_SSE2) || defined(GATEWAY_SCAN_NEON)
+
+inline std::size_t find_quote_or_escape(const char* p, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + kBlockBytes <= n; i += kBlockBytes) {
+        const detail::Block v = detail::load(p + i);
+        const std::size_t hit = detail::first(detail::any(detail::eq(v, '"'), detail::eq(v, '\\')));
+        if (hit != kBlockBytes) {
+            return i + hit;
+        }
+    }
+    return i + scalar::find_quote_or_escape(p + i, n - i);
+}
+
+inline std::size_t skip_whitespace(const char* p, std::size_t n) noexcept {
+    // Compact JSON has no whitespace run at all: answer that without a load
+    if (n == 0 || scalar::skip_whitespace(p, 1) == 0) {
+        return 0;
+    }
+    std::size_t i = 0;
+    for (; i + kBlockBytes <= n; i += kBlockBytes) {
+        const detail::Block v = detail::load(p + i);
+        const detail::Block ws = detail::any(detail::any(detail::eq(v, ' '), detail::eq(v, '\t')),
+                                             detail::any(detail::eq(v, '\n'), detail::eq(v, '\r')));
+        const std::size_t stop = detail::first_clear(ws);
+        if (stop != kBlockBytes) {
+            return i + stop;
+        }
+    }
+    return i + scalar::skip_whitespace(p + i, n - i);
+}
+
+inline std::size_t skip_digits(const char* p, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + kBlockBytes <= n; i += kBlockBytes) {
+        const std::size_t stop = detail::first_clear(detail::digit(detail::load(p + i)));
+        if (stop != kBlockBytes) {
+            return i + stop;
+        }
+    }
+    return i + scalar::skip_digits(p + i, n - i);
+}
+
+inline void delimiter_bitmaps(const char* p, std::size_t n, std::uint64_t* blank,
+                              std::uint64_t* equals, std::uint64_t* quote) noexcept {
+    const std::size_t full = n / 64;
+    for (std::size_t w = 0; w < full; ++w) {
+        const detail::Masks64 m = detail::classify64(p + 64 * w);
+        blank[w] = m.blank;
+        equals[w] = m.equals;
+        quote[w] = m.quote;
+    }
+    if (n % 64 != 0) {
+        // Partial last word: classify a zero-padded copy of the tail, so
+        // nothing past n is read (NUL is not a delimiter, so bits >= n
+        // come out zero)
+        char tail[64] = {};
+        std::memcpy(tail, p + 64 * full, n % 64);
+        const detail::Masks64 m = detail::classify64(tail);
+        blank[full] = m.blank;
+        equals[full] = m.equals;
+        quote[full] = m.quote;
+    }
+}
+
+#else
+
+inline std::size_t find_quote_or_escape(const char* p, std::size_t n) noexcept {
+    return scalar::find_quote_or_escape(p, n);
+}
+inline std::size_t skip_whitespace(const char* p, std::size_t n) noexcept {
+    return scalar::skip_whitespace(p, n);
+}
+inline std::size_t skip_digits(const char* p, std::size_t n) noexcept {
+    return scalar::skip_digits(p, n);
+}
+inline void delimiter_bitmaps(const char* p, std::size_t n, std::uint64_t* blank,
+                              std::uint64_t* equals, std::uint64_t* quote) noexcept {
+    scalar::delimiter_bitmaps(p, n, blank, equals, quote);
+}
+
+#endif
+
+}  // namespace gateway::scan
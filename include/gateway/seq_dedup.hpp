@@ -0,0 +1,119 @@
+#pragma once
+
+#include "gateway/config.hpp"
+#include "gateway/hash_index.hpp"
+#include "gateway/validate_config.hpp"  // AgentIdRules
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// SeqDeduplicator: drop replayed (agent_id, seq) pairs after TB-4
+//
+// Agents in retry storms resend the same seq; without this stage every
+// copy is serialized and forwarded. Each agent gets a sliding window of
+// the last `window` seqs as a bitmap (bit seq % window), anchored at the
+// highest seq seen, as in IPsec anti-replay:
+// - seq ahead of the highest: window slides forward (bits in between
+//   cleared), New
+// - seq within the window: Duplicate if its bit is set, else New
+//   (reordered datagram)
+// - seq further behind than the window: taken as an agent restart (seq
+//   counter reset); window re-anchored at seq, New
+// Seq comparisons use serial arithmetic, so wraparound at 2^32 is a step
+// forward. A fresh or evicted agent's first seq is always New.
+//
+// Storage is allocated once: a fixed table of max_agents entries holding
+// the interned id bytes, found through a HashIndex on a seeded hash of the
+// id, plus one flat bitmap array. When the table is full, the least recently seen agent is
+// evicted, so invented agent ids only cost other agents their window.
+//
+// check() is a read-only probe; commit() records the seq. The caller
+// commits only once the event is delivered (queued or folded), so an
+// event dropped by a later stage (agent limiter, aggregator caps,
+// forwarder backpressure) can still be retried by the agent.
+//
+// Cost: check() is one hash + probe and a bit test; commit() adds an O(1)
+// LRU touch and at most window / 64 word writes. Never allocates.
+//
+// Thread safety: NOT thread-safe. One instance per worker.
+// ============================================================================
+
+enum class DedupResult : std::uint8_t {
+    New,        // First time this (agent_id, seq) is seen in the window
+    Duplicate,  // Replay: drop
+};
+
+class SeqDeduplicator {
+public:
+    static constexpr std::size_t kMaxWindow = 4096;
+
+    explicit SeqDeduplicator(DedupConfig config = {});
+
+    // Report whether (agent_id, seq) was already committed; the window is
+    // not changed. Ids longer than AgentIdRules::kMaxLength are not
+    // tracked (New).
+    [[nodiscard]] DedupResult check(std::string_view agent_id, std::uint32_t seq) noexcept;
+
+    // Record (agent_id, seq) as delivered: slides, re-anchors or creates
+    // the agent's window as described above. Idempotent.
+    void commit(std::string_view agent_id, std::uint32_t seq) noexcept;
+
+    // True if seq is currently marked for the agent (no update)
+    [[nodiscard]] bool seen(std::string_view agent_id, std::uint32_t seq) const noexcept;
+
+    [[nodiscard]] std::size_t tracked_agents() const noexcept { return size_; }
+    [[nodiscard]] std::size_t max_agents() const noexcept { return entries_.size(); }
+    [[nodiscard]] std::size_t window() const noexcept { return words_ * 64; }
+
+    // Metrics
+    [[nodiscard]] std::uint64_t duplicates() const noexcept { return duplicates_; }
+    [[nodiscard]] std::uint64_t evictions() const noexcept { return evictions_; }
+    [[nodiscard]] std::uint64_t resets() const noexcept { return resets_; }
+
+private:
+    static constexpr std::uint32_t kNil = HashIndex::kNil;
+
+    struct Entry {
+        std::uint64_t hash = 0;     // seeded id hash
+        std::uint32_t highest = 0;  // highest seq seen (window anchor)
+        std::uint32_t prev = kNil;  // LRU list: head = most recently seen
+        std::uint32_t next = kNil;
+        std::uint8_t len = 0;
+        char id[AgentIdRules::kMaxLength];
+    };
+
+    // Index slot holding agent_id, or the empty slot where it would go
+    [[nodiscard]] std::size_t find_slot(std::string_view agent_id, std::uint64_t hash) const noexcept;
+
+    [[nodiscard]] std::uint64_t* bitmap(std::uint32_t n) noexcept { return &bits_[n * words_]; }
+    [[nodiscard]] const std::uint64_t* bitmap(std::uint32_t n) const noexcept {
+        return &bits_[n * words_];
+    }
+    // Clear `count` (< window) bits starting at seq `from`, modulo window
+    void clear_range(std::uint64_t* words, std::uint32_t from, std::uint32_t count) const noexcept;
+    void reset_window(std::uint32_t n, std::uint32_t seq) noexcept;
+
+    void lru_unlink(std::uint32_t n) noexcept;
+    void lru_push_front(std::uint32_t n) noexcept;
+
+    std::uint64_t seed_;
+    std::size_t words_;                     // uint64 words per agent bitmap
+    std::vector<Entry> entries_;
+    std::vector<std::uint64_t> bits_;       // max_agents * words_
+    HashIndex index_;                       // entry index or kNil
+    std::size_t size_ = 0;
+    std::uint32_t lru_head_ = kNil;
+    std::uint32_t lru_tail_ = kNil;
+
+    // Metrics
+    std::uint64_t duplicates_ = 0;
+    std::uint64_t evictions_ = 0;
+    std::uint64_t resets_ = 0;
+};
+
+}  // namespace gateway
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "gateway/validate_log.hpp"
+#include "gateway/validate_metrics.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace gateway {
+
+struct RollupEvent;  // aggregate.hpp
+
+// ============================================================================
+// Canonical event serializer (TB-4 -> TB-5)
+//
+// Writes a validated event as one compact JSON object, the form queued for
+// the sink:
+//
+//   {"type":"metrics","agent_id":"a","seq":1,"ts":1700000000000,
+//    "metrics":[{"n":"cpu","v":0.5,"u":"pct","t":{"host":"h1"}}]}
+//
+//   {"type":"log","agent_id":"a","ts":1700000000000,"level":"error",
+//    "msg":"disk full","fields":{"disk":"sda"}}
+//
+// Canonical rules:
+// - Keys in the order above; "u", "t", "agent_id" (logs) and "fields"
+//   are omitted when empty
+// - Integers and doubles via std::to_chars (shortest round-trip form);
+//   a non-finite value (only if the rules allow it) is written as null
+// - Strings are the decoded bytes the gateway holds (parse_metrics()
+//   decodes JSON escapes; logfmt and binary views are raw already),
+//   escaped once through one 256-entry table: '"', '\\' and control
+//   bytes; bytes >= 0x80 pass through unchanged
+// - Log "fields" holds only the extra fields (ts, level, msg and agent
+//   have their own keys)
+//
+// Contract: no allocation, never throws, O(output bytes). Returns the
+// number of bytes written, or 0 if the event does not fit in `out` (the
+// contents of `out` are then unspecified).
+// ============================================================================
+
+std::size_t serialize_event(const ValidatedMetrics& metrics, std::span<std::byte> out) noexcept;
+std::size_t serialize_event(const ValidatedLog& log, std::span<std::byte> out) noexcept;
+
+// Rollup event (MetricsAggregator::flush()), same rules:
+//
+//   {"type":"rollup","agent_id":"a","ts":1700000000000,"interval_ms":1000,
+//    "metrics":[{"n":"cpu","u":"pct","t":{"host":"h1"},
+//                "count":3,"sum":1.5,"min":0.2,"max":0.9}]}
+//
+// with "p50", "p90" and "p99" after "max" when the event has quantiles.
+// Writes as many leading series as fit in `out` and sets `written` to
+// their number; returns 0 (written == 0) if not even the first one fits.
+std::size_t serialize_rollup(const RollupEvent& rollup, std::span<std::byte> out,
+                             std::size_t& written) noexcept;
+
+}  // namespace gateway
@@ -7,6 +7,9 @@
 #include <memory>
 #include <span>
 #include <thread>
+#include <vector>
+
+struct iovec;
 
 namespace gateway {
 
@@ -29,8 +32,24 @@ public:
     // Contract:
     // - May block (e.g., slow filesystem, network)
     // - Should not throw
+    // - payload is only valid for the duration of the call (the forwarder
+    //   reuses its storage); copy it to keep it
     [[nodiscard]] virtual bool write(std::span<const std::byte> payload) noexcept = 0;
 
+    // Write several payloads in order (e.g., to coalesce into one syscall).
+    // Returns the number written successfully.
+    // Default implementation calls write() once per payload.
+    [[nodiscard]] virtual std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept {
+        std::size_t ok = 0;
+        for (const auto& payload : payloads) {
+            if (write(payload)) {
+                ++ok;
+            }
+        }
+        return ok;
+    }
+
     // Flush any buffered data (optional operation).
     // Default implementation does nothing.
     virtual void flush() noexcept {}
@@ -73,19 +92,39 @@ private:
 
 // ============================================================================
 // StdoutJsonSink: Prints JSON payloads to stdout (for demos)
+//
+// Thread safety: several instances (one per worker) may share stdout; each
+// line is written under the stdio stream lock so lines never interleave.
+// A single instance is NOT thread-safe (write_count_).
 // ============================================================================
 
 class StdoutJsonSink final : public Sink {
 public:
     [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override {
         // Convert bytes to string and print
+        flockfile(stdout);
         std::fwrite(payload.data(), 1, payload.size(), stdout);
         std::fputc('\n', stdout);
         std::fflush(stdout);
+        funlockfile(stdout);
         ++write_count_;
         return true;
     }
 
+    // One lock and one flush for the whole batch
+    [[nodiscard]] std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept override {
+        flockfile(stdout);
+        for (const auto& payload : payloads) {
+            std::fwrite(payload.data(), 1, payload.size(), stdout);
+            std::fputc('\n', stdout);
+        }
+        std::fflush(stdout);
+        funlockfile(stdout);
+        write_count_ += payloads.size();
+        return payloads.size();
+    }
+
     void flush() noexcept override {
         std::fflush(stdout);
     }
@@ -123,4 +162,107 @@ private:
     std::chrono::milliseconds delay_;
 };
 
+// ============================================================================
+// Buffered sinks
+//
+// Coalesce many small events into few downstream operations. Events are
+// held until one of the BufferedSinkConfig thresholds is crossed (checked
+// on every write), on flush(), or on destruction. Buffer memory is fixed
+// at construction; an event larger than the buffer bypasses it.
+//
+// Result contract: write()/write_batch() report events as written once
+// they are accepted into the buffer. Events lost when a later flush fails
+// are counted in dropped_events(), not reported per call.
+//
+// Thread safety: NOT thread-safe. Use from one thread (e.g., the
+// forwarder's sink thread).
+// ============================================================================
+
+struct BufferedSinkConfig {
+    std::size_t max_buffered_bytes = 64 * 1024;        // Flush at this many bytes
+    std::size_t max_buffered_events = 256;             // ... or this many events
+    std::chrono::milliseconds max_delay{10};           // ... or when the oldest is this old
+};
+
+// BufferedFdSink: newline-delimited events to a file descriptor (stdout,
+// a file, a pipe) with one writev() per flush.
+//
+// Large batches are written straight from the callers' payloads (buffered
+// bytes + payload/newline iovecs in one writev), without copying.
+// The fd must be blocking; it is not owned (never closed).
+class BufferedFdSink final : public Sink {
+public:
+    explicit BufferedFdSink(int fd, BufferedSinkConfig config = {});
+    ~BufferedFdSink() override;
+
+    BufferedFdSink(const BufferedFdSink&) = delete;
+    BufferedFdSink& operator=(const BufferedFdSink&) = delete;
+
+    [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override;
+    [[nodiscard]] std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept override;
+    void flush() noexcept override;
+
+    // Metrics
+    [[nodiscard]] std::uint64_t write_count() const noexcept { return write_count_; }
+    [[nodiscard]] std::uint64_t syscall_count() const noexcept { return syscall_count_; }
+    [[nodiscard]] std::uint64_t dropped_events() const noexcept { return dropped_events_; }
+    [[nodiscard]] std::size_t buffered_bytes() const noexcept { return used_; }
+
+private:
+    void append(std::span<const std::byte> payload) noexcept;
+    void write_through(std::span<const std::span<const std::byte>> payloads) noexcept;
+    bool write_iov(std::size_t count) noexcept;
+
+    int fd_;
+    BufferedSinkConfig config_;
+    std::vector<std::byte> buffer_;     // fixed capacity, [0, used_) pending
+    std::size_t used_ = 0;
+    std::size_t buffered_events_ = 0;
+    std::chrono::steady_clock::time_point oldest_{};
+    std::vector<iovec> iov_;            // scratch, kMaxIov entries
+
+    std::uint64_t write_count_ = 0;
+    std::uint64_t syscall_count_ = 0;
+    std::uint64_t dropped_events_ = 0;
+};
+
+// BufferedSink: adds coalescing to any inner sink.
+//
+// Copies events into a fixed arena and hands them to the inner sink as one
+// write_batch() per flush. Wraps like SlowSink (takes ownership).
+class BufferedSink final : public Sink {
+public:
+    explicit BufferedSink(std::unique_ptr<Sink> inner, BufferedSinkConfig config = {});
+    ~BufferedSink() override;
+
+    BufferedSink(const BufferedSink&) = delete;
+    BufferedSink& operator=(const BufferedSink&) = delete;
+
+    [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override;
+    [[nodiscard]] std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept override;
+
+    // Hands pending events to the inner sink, then flushes it
+    void flush() noexcept override;
+
+    // Metrics
+    [[nodiscard]] std::uint64_t batches_flushed() const noexcept { return batches_flushed_; }
+    [[nodiscard]] std::uint64_t dropped_events() const noexcept { return dropped_events_; }
+    [[nodiscard]] std::size_t buffered_events() const noexcept { return pending_.size(); }
+
+private:
+    void flush_pending() noexcept;
+
+    std::unique_ptr<Sink> inner_;
+    BufferedSinkConfig config_;
+    std::vector<std::byte> arena_;                  // fixed capacity
+    std::size_t used_ = 0;
+    std::vector<std::span<const std::byte>> pending_;  // views into arena_
+    std::chrono::steady_clock::time_point oldest_{};
+
+    std::uint64_t batches_flushed_ = 0;
+    std::uint64_t dropped_events_ = 0;
+};
+
 }  // namespace gateway
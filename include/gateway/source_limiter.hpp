@@ -1,12 +1,15 @@
 #pragma once
 
 #include "gateway/config.hpp"
+#include "gateway/limiter_snapshot.hpp"
 
 #include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 namespace gateway {
 
@@ -65,6 +68,22 @@ public:
     // Consumes one token if allowed.
     Admit admit(const SourceKey& source);
 
+    // Same, with a caller-supplied timestamp
+    Admit admit(const SourceKey& source, std::chrono::steady_clock::time_point now);
+
+    // Admit a batch (e.g., one recvmmsg batch) with one clock read.
+    // Writes one decision per source into out[0, sources.size()) and
+    // returns the number allowed. Requires out.size() >= sources.size().
+    // Decisions equal calling admit() once per source at the same instant.
+    std::size_t admit_batch(std::span<const SourceKey> sources, std::span<Admit> out);
+
+    // Apply a new config in place. Tracked sources keep their buckets
+    // (clamped to the new burst); shrinking max_sources evicts LRU sources
+    // down to the new capacity.
+    void reconfigure(const SourceLimiterConfig& config);
+
+    [[nodiscard]] const SourceLimiterConfig& config() const noexcept { return config_; }
+
     // Current number of tracked sources
     [[nodiscard]] std::size_t tracked_count() const noexcept;
 
@@ -94,8 +113,8 @@ private:
     };
     using SourceMap = std::unordered_map<SourceKey, Entry>;
 
-    // Refill tokens based on elapsed time
-    void refill_bucket(Bucket& bucket);
+    // Refill tokens based on time elapsed up to `now`
+    void refill_bucket(Bucket& bucket, std::chrono::steady_clock::time_point now);
 
     // Evict least recently used entry
     void evict_lru();
@@ -111,4 +130,136 @@ private:
     std::uint64_t eviction_count_ = 0;
 };
 
+// ============================================================================
+// FlatSourceLimiter
+//
+// Drop-in alternative to SourceLimiter (same config, Admit semantics and
+// metrics) built for the per-packet hot path:
+// - All state preallocated from max_sources; admit() never allocates
+// - Open-addressed table (linear probing, load factor <= 0.5, seeded hash)
+//   of node indices; backward-shift deletion, no tombstones
+// - Intrusive LRU: prev/next are node indices, a touch is a few stores
+// - Fixed-point tokens in nano-token units (1 token = 1e9): refill is one
+//   integer multiply (elapsed_ns * tokens_per_sec), exact, no division
+// - One clock read per admit(), or none with admit(source, now)
+//
+// Invariants enforced:
+// - Bounds per-source share of processing capacity (token bucket)
+// - Bounds total state growth (LRU eviction at max_sources)
+//
+// Thread safety: NOT thread-safe. External synchronization required.
+// ============================================================================
+
+class FlatSourceLimiter {
+public:
+    explicit FlatSourceLimiter(SourceLimiterConfig config = {},
+                               Clock clock = default_clock);
+
+    // Check if a packet from this source should be admitted.
+    // Consumes one token if allowed. Reads the clock once.
+    Admit admit(const SourceKey& source);
+
+    // Same, with a caller-supplied timestamp (e.g., one read per batch)
+    Admit admit(const SourceKey& source, std::chrono::steady_clock::time_point now) noexcept;
+
+    // Admit a batch (e.g., one recvmmsg batch) with one clock read.
+    // Writes one decision per source into out[0, sources.size()) and
+    // returns the number allowed. Requires out.size() >= sources.size().
+    // Decisions equal calling admit() once per source at the same instant.
+    //
+    // A run of consecutive packets from one source (typical of a flood)
+    // costs one lookup, LRU touch and refill. Index slots and nodes for
+    // upcoming packets are prefetched while earlier ones are processed.
+    std::size_t admit_batch(std::span<const SourceKey> sources, std::span<Admit> out) noexcept;
+
+    // Apply a new config in place, e.g. from a ConfigSnapshot between
+    // batches. Tracked sources keep their buckets and LRU order (tokens
+    // clamped to the new burst); the hash seed is kept. A max_sources
+    // change rebuilds the table at the new capacity, keeping the most
+    // recently used sources (shrinking evicts the rest). Allocates only
+    // when max_sources changes; O(tracked sources).
+    void reconfigure(const SourceLimiterConfig& config);
+
+    [[nodiscard]] const SourceLimiterConfig& config() const noexcept { return config_; }
+
+    // Warm restart (layout in limiter_snapshot.hpp). save_snapshot() writes
+    // every tracked bucket, in LRU order, to `path` via a temporary file
+    // that is renamed over it. restore_snapshot() replaces the current
+    // state with the file's: buckets are refilled for the time since the
+    // save and clamped to this limiter's burst; if the file holds more
+    // sources than max_sources, the most recently used are kept. On any
+    // status other than Ok the limiter is left unchanged.
+    // Both are O(tracked sources) and reuse the preallocated table.
+    [[nodiscard]] SnapshotStatus save_snapshot(const char* path) const;
+    [[nodiscard]] SnapshotStatus restore_snapshot(const char* path);
+
+    // Current number of tracked sources
+    [[nodiscard]] std::size_t tracked_count() const noexcept { return size_; }
+
+    // Maximum number of tracked sources
+    [[nodiscard]] std::size_t capacity() const noexcept { return nodes_.size(); }
+
+    // Check if a source is currently tracked (for testing)
+    [[nodiscard]] bool is_tracked(const SourceKey& source) const noexcept;
+
+    // Metrics
+    [[nodiscard]] std::uint64_t total_admits() const noexcept { return total_admits_; }
+    [[nodiscard]] std::uint64_t total_drops() const noexcept { return total_drops_; }
+    [[nodiscard]] std::uint64_t eviction_count() const noexcept { return eviction_count_; }
+
+private:
+    static constexpr std::uint32_t kNil = UINT32_MAX;
+    static constexpr std::uint64_t kTokenScale = 1'000'000'000;  // nano-tokens
+
+    struct Node {
+        SourceKey key;
+        std::uint32_t prev;     // LRU neighbour towards head (MRU)
+        std::uint32_t next;     // LRU neighbour towards tail; free-list link
+        std::uint64_t tokens;   // nano-tokens
+        std::int64_t last_ns;   // time of last refill
+    };
+
+    [[nodiscard]] std::uint64_t hash(const SourceKey& key) const noexcept;
+
+    // Index slot holding `key`, or the empty slot where it would go.
+    // `home` is hash(key) & index_mask_.
+    [[nodiscard]] std::size_t find_slot(const SourceKey& key, std::size_t home) const noexcept;
+    [[nodiscard]] std::size_t find_slot(const SourceKey& key) const noexcept {
+        return find_slot(key, hash(key) & index_mask_);
+    }
+
+    // Admit `count` consecutive packets from one source; decisions go to
+    // out[0, count). Returns the number allowed.
+    std::size_t admit_run(const SourceKey& source, std::size_t home, std::size_t count,
+                          std::int64_t now_ns, Admit* out) noexcept;
+
+    void lru_unlink(std::uint32_t n) noexcept;
+    void lru_push_front(std::uint32_t n) noexcept;
+    void evict_lru() noexcept;
+    void erase_slot(std::size_t slot) noexcept;
+    void refill(Node& node, std::int64_t now_ns) const noexcept;
+
+    // Re-home every tracked node into fresh tables of `capacity` nodes
+    void resize(std::size_t capacity);
+
+    SourceLimiterConfig config_;
+    Clock clock_;
+    std::uint64_t seed_;
+    std::uint64_t burst_;           // burst_tokens in nano-tokens
+    std::int64_t full_refill_ns_;   // time to refill an empty bucket
+
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> index_;  // node index or kNil
+    std::size_t index_mask_;
+    std::uint32_t free_head_ = kNil;
+    std::uint32_t lru_head_ = kNil;     // most recently used
+    std::uint32_t lru_tail_ = kNil;     // least recently used
+    std::size_t size_ = 0;
+
+    // Metrics
+    std::uint64_t total_admits_ = 0;
+    std::uint64_t total_drops_ = 0;
+    std::uint64_t eviction_count_ = 0;
+};
+
 }  // namespace gateway
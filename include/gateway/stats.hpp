@@ -0,0 +1,249 @@
+#pragma once
+
+#include "gateway/classify.hpp"
+#include "gateway/forwarder.hpp"
+#include "gateway/histogram.hpp"
+#include "gateway/parse_envelope.hpp"
+#include "gateway/parse_log.hpp"
+#include "gateway/parse_metrics.hpp"
+#include "gateway/validate_log.hpp"
+#include "gateway/validate_metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace gateway {
+
+// ============================================================================
+// Gateway self-telemetry: per-thread stage counters and latency histograms
+//
+// Every pipeline thread owns one PipelineStats block and is its only
+// writer, so a count is a relaxed load + store (no locked RMW, a few ns)
+// and threads never share a cache line. Any thread may take a snapshot at
+// any time without stopping ingest; StatsRegistry merges the snapshots of
+// all registered threads.
+//
+// Invariants enforced:
+// - Fixed memory: blocks are allocated once by StatsRegistry
+// - One counter per value of every drop enum (kEnumCount, checked below)
+// - Readers never block or slow down writers
+// ============================================================================
+
+inline constexpr std::size_t kCacheLineBytes = 64;
+
+// Single-writer counter (or gauge), readable from any thread
+class StatCounter {
+public:
+    void add(std::uint64_t n = 1) noexcept {
+        value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    void set(std::uint64_t v) noexcept { value_.store(v, std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t value() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+// Number of values of a drop enum. Each specialization is checked against
+// the enum's last value, so appending a value without updating it fails
+// to compile.
+template <typename E>
+inline constexpr std::size_t kEnumCount = 0;
+
+template <> inline constexpr std::size_t kEnumCount<DropReason> = 3;
+template <> inline constexpr std::size_t kEnumCount<PrefilterDrop> = 7;
+template <> inline constexpr std::size_t kEnumCount<MetricsDropReason> = 21;
+template <> inline constexpr std::size_t kEnumCount<MetricsValidationDrop> = 11;
+template <> inline constexpr std::size_t kEnumCount<LogDropReason> = 16;
+template <> inline constexpr std::size_t kEnumCount<LogValidationDrop> = 8;
+template <> inline constexpr std::size_t kEnumCount<ForwardResult> = 6;
+
+static_assert(kEnumCount<DropReason> == static_cast<std::size_t>(DropReason::TrailingJunk) + 1);
+static_assert(kEnumCount<PrefilterDrop> == static_cast<std::size_t>(PrefilterDrop::TimestampInFuture) + 1);
+static_assert(kEnumCount<MetricsDropReason> ==
+              static_cast<std::size_t>(MetricsDropReason::DuplicateField) + 1);
+static_assert(kEnumCount<MetricsValidationDrop> ==
+              static_cast<std::size_t>(MetricsValidationDrop::MetricNameEmpty) + 1);
+static_assert(kEnumCount<LogDropReason> == static_cast<std::size_t>(LogDropReason::BinaryMalformed) + 1);
+static_assert(kEnumCount<LogValidationDrop> == static_cast<std::size_t>(LogValidationDrop::MessageEmpty) + 1);
+static_assert(kEnumCount<ForwardResult> == static_cast<std::size_t>(ForwardResult::DroppedPayloadTooLarge) + 1);
+
+// Snapshot of one enum's counters, indexed by value
+template <typename E>
+using EnumCounts = std::array<std::uint64_t, kEnumCount<E>>;
+
+template <std::size_t N>
+std::uint64_t total(const std::array<std::uint64_t, N>& counts) noexcept {
+    std::uint64_t n = 0;
+    for (std::uint64_t c : counts) {
+        n += c;
+    }
+    return n;
+}
+
+// One single-writer counter per value of E
+template <typename E>
+class EnumCounters {
+public:
+    void add(E value) noexcept {
+        const auto i = static_cast<std::size_t>(value);
+        if (i < counts_.size()) {
+            counts_[i].add();
+        }
+    }
+
+    [[nodiscard]] std::uint64_t count(E value) const noexcept {
+        const auto i = static_cast<std::size_t>(value);
+        return i < counts_.size() ? counts_[i].value() : 0;
+    }
+
+    [[nodiscard]] EnumCounts<E> snapshot() const noexcept {
+        EnumCounts<E> out{};
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            out[i] = counts_[i].value();
+        }
+        return out;
+    }
+
+private:
+    std::array<StatCounter, kEnumCount<E>> counts_{};
+};
+
+// Plain, mergeable copy of one or more PipelineStats blocks
+struct StatsSnapshot {
+    // TB-1 / TB-1.5
+    std::uint64_t received = 0;
+    std::uint64_t recv_truncated = 0;
+    std::uint64_t recv_no_buffer = 0;
+    std::uint64_t recv_errors = 0;
+    std::uint64_t source_limited = 0;
+
+    // Drops by reason, per stage
+    EnumCounts<DropReason> envelope{};
+    EnumCounts<PrefilterDrop> prefilter{};
+    EnumCounts<MetricsDropReason> metrics_parse{};
+    EnumCounts<MetricsValidationDrop> metrics_validation{};
+    EnumCounts<LogDropReason> log_parse{};
+    EnumCounts<LogValidationDrop> log_validation{};
+    std::uint64_t duplicates = 0;             // Replayed (agent_id, seq), after TB-4
+    std::uint64_t agent_limited = 0;          // Per-agent rate limit (after TB-4)
+    std::uint64_t aggregated = 0;             // Metric values folded into rollups
+    std::uint64_t aggregate_dropped = 0;      // Metric values over rollup caps
+    EnumCounts<ForwardResult> forward{};      // Queued included
+    std::uint64_t serialize_overflow = 0;     // Canonical form larger than a payload slot
+
+    // Gauges (summed on merge)
+    std::uint64_t forwarded = 0;
+    std::uint64_t queue_depth = 0;
+    std::uint64_t queue_capacity = 0;
+    std::uint64_t tracked_agents = 0;
+    std::uint64_t tracked_sources = 0;
+
+    // Latency (ns)
+    HistogramSnapshot parse;
+    HistogramSnapshot validate;
+    HistogramSnapshot queue;       // enqueue to sink write
+    HistogramSnapshot sink_write;
+
+    void merge(const StatsSnapshot& other) noexcept;
+};
+
+// ============================================================================
+// PipelineStats: the counters of one pipeline thread
+//
+// Each group is written by one thread only: the ingest group by the
+// worker, the sink group by whichever thread drains the forwarder (the
+// worker in sync mode, the forwarder's sink thread in async mode; see
+// ForwarderConfig::queue_latency). Groups start on their own cache line.
+// ============================================================================
+
+struct alignas(kCacheLineBytes) PipelineStats {
+    StatCounter received;
+    StatCounter recv_truncated;
+    StatCounter recv_no_buffer;
+    StatCounter recv_errors;
+    StatCounter source_limited;
+
+    EnumCounters<DropReason> envelope;
+    EnumCounters<PrefilterDrop> prefilter;
+    EnumCounters<MetricsDropReason> metrics_parse;
+    EnumCounters<MetricsValidationDrop> metrics_validation;
+    EnumCounters<LogDropReason> log_parse;
+    EnumCounters<LogValidationDrop> log_validation;
+    StatCounter duplicates;
+    StatCounter agent_limited;
+    StatCounter aggregated;
+    StatCounter aggregate_dropped;
+    EnumCounters<ForwardResult> forward;
+    StatCounter serialize_overflow;
+
+    StatCounter forwarded;
+    StatCounter queue_depth;
+    StatCounter queue_capacity;
+    StatCounter tracked_agents;
+    StatCounter tracked_sources;
+
+    LatencyHistogram parse;
+    LatencyHistogram validate;
+
+    // Sink group
+    alignas(kCacheLineBytes) LatencyHistogram queue;
+    LatencyHistogram sink_write;
+
+    [[nodiscard]] StatsSnapshot snapshot() const noexcept;
+};
+
+// ============================================================================
+// StatsRegistry
+//
+// Fixed table of PipelineStats blocks, one per registered thread. A thread
+// registers once at startup and then writes only its own block; snapshot()
+// merges every registered block and may run concurrently with them.
+//
+// Each block is allocated and zeroed by register_thread() on the calling
+// thread, so under the default first-touch policy a worker's counters
+// live on its own NUMA node rather than on the node of whoever built the
+// registry. register_thread(slot) claims a given block, so worker i can
+// own block i while registering from its own thread.
+//
+// Thread safety: register_thread() and snapshot() may be called from any
+// thread.
+// ============================================================================
+
+class StatsRegistry {
+public:
+    explicit StatsRegistry(std::size_t max_threads);
+    ~StatsRegistry();
+
+    StatsRegistry(const StatsRegistry&) = delete;
+    StatsRegistry& operator=(const StatsRegistry&) = delete;
+
+    // A zeroed block for the calling thread (the first free one), or
+    // nullptr once max_threads blocks are handed out
+    [[nodiscard]] PipelineStats* register_thread() noexcept;
+
+    // Block `slot` for the calling thread, or nullptr if it is out of
+    // range or already claimed
+    [[nodiscard]] PipelineStats* register_thread(std::size_t slot) noexcept;
+
+    // Merged view of all registered blocks
+    [[nodiscard]] StatsSnapshot snapshot() const noexcept;
+
+    // Snapshot of block i (zero if unclaimed), e.g. for per-worker output
+    [[nodiscard]] StatsSnapshot snapshot(std::size_t i) const noexcept;
+
+    [[nodiscard]] std::size_t registered() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    std::unique_ptr<std::atomic<PipelineStats*>[]> blocks_;  // nullptr = free
+    std::size_t capacity_;
+    std::atomic<std::size_t> registered_{0};
+};
+
+}  // namespace gateway
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gateway {
+
+// ============================================================================
+// CPU / NUMA topology and worker placement (multi-worker ingest)
+//
+// Read from sysfs and procfs at startup (no libnuma): node CPU lists from
+// /sys/devices/system/node/node<N>/cpulist, the NIC's node from
+// /sys/class/net/<if>/device/numa_node, and its RX queue interrupts from
+// /proc/interrupts with their CPUs from /proc/irq/<n>/. The roots are
+// parameters so tests can point them at a fake tree.
+//
+// Placement puts workers on the CPUs that take the NIC's RX interrupts
+// first, then on the rest of the NIC's node, then on the other nodes. Per-
+// worker state then lands on the worker's node by first touch: the worker
+// pins itself before it constructs anything (RecvLoop buffers, limiter
+// tables, forwarder slab), and set_local_memory_policy() overrides an
+// inherited interleave/bind policy for that thread.
+//
+// Everything here is best effort: a missing file means "unknown" (node
+// -1, no queues), never an error, so single-node hosts and containers
+// without /sys just see one node.
+// ============================================================================
+
+// Parse a sysfs CPU list ("0-3,8,10-11\n"); nullopt if malformed. The
+// result is ascending and free of duplicates.
+std::optional<std::vector<int>> parse_cpu_list(std::string_view text);
+
+struct CpuTopology {
+    std::vector<int> node_of_cpu;             // indexed by CPU; -1 if offline/unknown
+    std::vector<std::vector<int>> node_cpus;  // indexed by node; online CPUs, ascending
+
+    [[nodiscard]] int node_of(int cpu) const noexcept {
+        return cpu >= 0 && static_cast<std::size_t>(cpu) < node_of_cpu.size()
+                   ? node_of_cpu[static_cast<std::size_t>(cpu)] : -1;
+    }
+    [[nodiscard]] std::size_t node_count() const noexcept { return node_cpus.size(); }
+};
+
+// Nodes and their CPUs. Without node directories (no NUMA support) the
+// online CPUs (/sys/devices/system/cpu/online) form node 0.
+CpuTopology load_cpu_topology(const std::string& sys_root = "/sys");
+
+struct RxQueue {
+    int queue = 0;           // queue number from the IRQ name, else discovery order
+    int irq = 0;
+    std::vector<int> cpus;   // effective IRQ affinity (smp_affinity_list if absent)
+    int node = -1;           // node of the first CPU
+};
+
+struct NicTopology {
+    std::string name;
+    int node = -1;           // device's node; -1 if unknown (virtual NICs)
+    std::vector<RxQueue> rx_queues;  // sorted by queue
+};
+
+// RX queues of one interface: IRQs listed in the device's msi_irqs or
+// named after the interface, whose names mark a receive queue ("rx",
+// "TxRx", "input", "comp"), so ixgbe/i40e/ice, mlx5 and virtio names match.
+NicTopology load_nic_topology(std::string_view ifname, const CpuTopology& cpus,
+                              const std::string& sys_root = "/sys",
+                              const std::string& proc_root = "/proc");
+
+// CPU for each of `workers` workers: `preferred_cpus` in order (e.g. the
+// RX queue CPUs), then the rest of `preferred_node` (if >= 0), then every
+// other node in order, skipping offline and repeated CPUs. With more
+// workers than CPUs the list repeats. Empty if no CPU is known.
+std::vector<int> plan_worker_cpus(const CpuTopology& topology, std::size_t workers,
+                                  std::span<const int> preferred_cpus = {},
+                                  int preferred_node = -1);
+
+// CPUs for a worker's helper threads (the async sink thread): the
+// worker's node without the worker's own CPU, or just that CPU if it is
+// alone on its node. Empty if the CPU's node is unknown.
+std::vector<int> node_cpus_for(const CpuTopology& topology, int worker_cpu);
+
+// Worker serving each RX queue (same order as nic.rx_queues): the worker
+// pinned to one of the queue's CPUs, else the first worker on the
+// queue's node, else -1 (every path from that queue crosses nodes)
+struct RxPlacement {
+    int worker = -1;
+    bool same_cpu = false;   // worker runs on a CPU the queue interrupts
+};
+std::vector<RxPlacement> map_rx_queues(const NicTopology& nic, const CpuTopology& topology,
+                                       std::span<const int> worker_cpus);
+
+// Pin the calling thread to a set of CPUs; false if empty or refused
+bool pin_current_thread_to_cpus(std::span<const int> cpus);
+
+// Make the calling thread allocate from the node it runs on
+// (set_mempolicy MPOL_LOCAL), whatever policy it inherited. False if the
+// kernel refuses (e.g. no NUMA support) - first touch then still applies.
+bool set_local_memory_policy();
+
+// Steer an SO_REUSEPORT group by receiving CPU: attaches a classic BPF
+// program (SO_ATTACH_REUSEPORT_CBPF) to the group of `fd` that delivers a
+// datagram handled on CPU worker_cpus[i] to socket i (the i-th socket
+// bound to the group), and any other CPU's datagrams to socket cpu % n.
+// The RSS hash still picks the RX queue per 4-tuple, so every source
+// keeps landing on one worker. False if the kernel refuses (pre-4.5) or
+// worker_cpus is empty.
+bool attach_reuseport_cpu_steering(int fd, std::span<const int> worker_cpus);
+
+}  // namespace gateway
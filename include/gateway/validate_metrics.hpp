@@ -5,6 +5,9 @@
 
 #include <cstdint>
 #include <cmath>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <variant>
 
 namespace gateway {
@@ -67,6 +70,11 @@ struct ValidatedMetrics {
     std::uint64_t ts;
     const Metric* metrics;    // pointer to first metric
     std::size_t metric_count;
+    const MetricTag* tags;    // message tag pool (indexed by Metric::tag_offset)
+
+    [[nodiscard]] std::span<const MetricTag> tags_of(const Metric& m) const noexcept {
+        return {tags + m.tag_offset, m.tag_count};
+    }
 };
 
 // Result type: success or explicit drop reason
@@ -87,7 +95,60 @@ MetricsValidationResult validate_metrics(
     std::uint64_t current_time_ms
 ) noexcept;
 
+// Per-field TB-4 rules, as applied by validate_metrics() (and by the
+// fused path below as each field is decoded).
+//
+// check_metrics_timestamp: ts = 0 means absent (TimestampMissing if
+// required); otherwise the window check.
+// check_metric: name emptiness, then NaN / infinity / range.
+std::optional<MetricsValidationDrop> check_metrics_timestamp(
+    std::uint64_t ts,
+    const MetricsValidationConfig& config,
+    std::uint64_t current_time_ms
+) noexcept;
+
+std::optional<MetricsValidationDrop> check_metric(
+    const Metric& metric,
+    const MetricValueRules& rules
+) noexcept;
+
 // Default configuration
 inline constexpr MetricsValidationConfig kDefaultMetricsValidation = {};
 
+// ============================================================================
+// Fused TB-3 + TB-4: single-pass parse and validate
+//
+// Applies the TB-4 rules while the JSON is decoded, instead of a full
+// parse followed by a second walk over every metric:
+// - agent_id: TB-4 format checked in the same pass as the TB-3 charset
+// - ts: window checked as soon as the field is decoded
+// - each metric: checked as soon as its object closes
+//
+// Stops at the first violation, so an invalid message costs only the bytes
+// up to it. Drop reasons keep the two-stage taxonomy (MetricsDropReason
+// for structural failures, MetricsValidationDrop for semantic ones). A
+// message is accepted iff parse_metrics + validate_metrics accept it, with
+// identical contents; when a message has several violations the fused path
+// may report an earlier one than the two-stage path would.
+//
+// `scratch` backs the returned views (reuse it across messages).
+// ============================================================================
+
+using FusedMetricsResult =
+    std::variant<ValidatedMetrics, MetricsDropReason, MetricsValidationDrop>;
+
+FusedMetricsResult parse_and_validate_metrics(
+    std::span<const std::byte> input,
+    const MetricsValidationConfig& config,
+    std::uint64_t current_time_ms,
+    ParsedMetrics& scratch
+) noexcept;
+
+FusedMetricsResult parse_and_validate_metrics(
+    std::string_view input,
+    const MetricsValidationConfig& config,
+    std::uint64_t current_time_ms,
+    ParsedMetrics& scratch
+) noexcept;
+
 }  // namespace gateway
@@ -0,0 +1,211 @@
+#include "gateway/agent_limiter.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <random>
+
+namespace gateway {
+
+namespace {
+
+std::int64_t to_ns(std::chrono::steady_clock::time_point t) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+// Time to refill an empty bucket of `burst` nano-tokens
+std::int64_t full_refill_ns(std::uint64_t burst, std::uint32_t tokens_per_sec) noexcept {
+    return tokens_per_sec == 0
+               ? INT64_MAX
+               : static_cast<std::int64_t>((burst + tokens_per_sec - 1) / tokens_per_sec);
+}
+
+std::int64_t decay_ns(std::uint32_t decay_ms) noexcept {
+    return static_cast<std::int64_t>(std::max<std::uint32_t>(decay_ms, 1)) * 1'000'000;
+}
+
+}  // namespace
+
+AgentLimiter::AgentLimiter(AgentLimiterConfig config, Clock clock)
+    : config_(config)
+    , clock_(std::move(clock))
+    , seed_((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    , burst_(static_cast<std::uint64_t>(config.burst_tokens) * kTokenScale)
+    , full_refill_ns_(full_refill_ns(burst_, config.tokens_per_sec))
+    , decay_ns_(decay_ns(config.decay_ms))
+    , width_mask_(std::bit_ceil(std::max<std::size_t>(config.sketch_width, 1)) - 1)
+    , depth_(std::clamp<std::size_t>(config.sketch_depth, 1, kMaxDepth))
+    , sketch_(depth_ * (width_mask_ + 1))
+    , heavy_(std::max<std::size_t>(config.heavy_hitters, 1))
+    , heavy_index_(heavy_.size()) {}
+
+std::uint64_t AgentLimiter::hash(std::string_view agent_id) const noexcept {
+    // Seeded word-wise mix: agent ids are attacker-chosen, so neither
+    // sketch collisions nor fingerprint collisions may be predictable
+    return hash_bytes(seed_, agent_id);
+}
+
+std::uint32_t AgentLimiter::epoch_of(std::int64_t now_ns) const noexcept {
+    return now_ns <= 0 ? 0 : static_cast<std::uint32_t>(now_ns / decay_ns_);
+}
+
+std::size_t AgentLimiter::counter_index(std::uint64_t h, std::size_t row) const noexcept {
+    // Double hashing: row i uses h1 + i*h2 (h2 odd), as good as d
+    // independent hashes for count-min purposes
+    const std::uint64_t h1 = h & 0xffffffffULL;
+    const std::uint64_t h2 = (h >> 32) | 1;
+    return row * (width_mask_ + 1) + ((h1 + row * h2) & width_mask_);
+}
+
+std::uint32_t AgentLimiter::decayed(const Counter& c, std::uint32_t epoch) noexcept {
+    if (epoch <= c.epoch) {
+        return c.count;  // Same interval, or clock regression
+    }
+    const std::uint32_t shift = epoch - c.epoch;
+    return shift >= 32 ? 0 : c.count >> shift;
+}
+
+std::uint32_t AgentLimiter::sketch_add(std::uint64_t h, std::uint32_t epoch) noexcept {
+    std::size_t idx[kMaxDepth];
+    std::uint32_t value[kMaxDepth];
+    std::uint32_t min = UINT32_MAX;
+    for (std::size_t row = 0; row < depth_; ++row) {
+        idx[row] = counter_index(h, row);
+        value[row] = decayed(sketch_[idx[row]], epoch);
+        min = std::min(min, value[row]);
+    }
+    // Conservative update: only counters at the minimum need to grow for
+    // the estimate (the minimum) to grow; the others already cover it
+    const std::uint32_t next = min == UINT32_MAX ? min : min + 1;
+    for (std::size_t row = 0; row < depth_; ++row) {
+        Counter& c = sketch_[idx[row]];
+        c.count = std::max(value[row], next);
+        c.epoch = std::max(c.epoch, epoch);
+    }
+    return next;
+}
+
+std::size_t AgentLimiter::heavy_home(std::uint64_t fingerprint) const noexcept {
+    // Fingerprint is already mixed; take bits the sketch rows lean on least
+    return heavy_index_.home(fingerprint >> 20);
+}
+
+std::size_t AgentLimiter::find_heavy(std::uint64_t fingerprint) const noexcept {
+    return heavy_index_.find(heavy_home(fingerprint), [this, fingerprint](std::uint32_t n) {
+        return heavy_[n].fingerprint == fingerprint;
+    });
+}
+
+void AgentLimiter::refill(Heavy& heavy, std::int64_t now_ns) const noexcept {
+    const std::int64_t elapsed = now_ns - heavy.last_ns;
+    if (elapsed <= 0) {
+        return;  // Clock regression: no refill, keep the later timestamp
+    }
+    heavy.last_ns = now_ns;
+    if (elapsed >= full_refill_ns_) {
+        heavy.tokens = burst_;
+        return;
+    }
+    // elapsed < full_refill_ns_ bounds the product by ~burst_ (no overflow)
+    const std::uint64_t add = static_cast<std::uint64_t>(elapsed) * config_.tokens_per_sec;
+    heavy.tokens = std::min(heavy.tokens + add, burst_);
+}
+
+std::uint32_t AgentLimiter::promote(std::uint64_t fingerprint, std::int64_t now_ns) noexcept {
+    std::uint32_t n;
+    if (heavy_count_ < heavy_.size()) {
+        n = static_cast<std::uint32_t>(heavy_count_++);
+    } else {
+        // Full: evict the least constrained agent (most tokens after refill).
+        // Bounded O(heavy_hitters), and only on promotion.
+        n = 0;
+        std::uint64_t most = 0;
+        for (std::size_t i = 0; i < heavy_.size(); ++i) {
+            refill(heavy_[i], now_ns);
+            if (heavy_[i].tokens >= most) {
+                most = heavy_[i].tokens;
+                n = static_cast<std::uint32_t>(i);
+            }
+        }
+        heavy_index_.erase(find_heavy(heavy_[n].fingerprint), [this](std::uint32_t m) {
+            return heavy_home(heavy_[m].fingerprint);
+        });
+        ++heavy_evictions_;
+    }
+    // Empty start: the sketch already admitted a burst's worth of events
+    heavy_[n] = Heavy{.fingerprint = fingerprint, .tokens = 0, .last_ns = now_ns};
+    heavy_index_.set(find_heavy(fingerprint), n);
+    ++promotions_;
+    return n;
+}
+
+Admit AgentLimiter::admit(std::string_view agent_id) {
+    return admit(agent_id, clock_());
+}
+
+Admit AgentLimiter::admit(std::string_view agent_id,
+                          std::chrono::steady_clock::time_point now) noexcept {
+    const std::int64_t now_ns = to_ns(now);
+    const std::uint64_t h = hash(agent_id);
+    const std::uint32_t estimate = sketch_add(h, epoch_of(now_ns));
+
+    const std::size_t slot = find_heavy(h);
+    std::uint32_t n = heavy_index_[slot];
+    if (n == kNil) {
+        if (estimate <= config_.burst_tokens) {
+            ++total_admits_;
+            return Admit::Allow;
+        }
+        n = promote(h, now_ns);
+    }
+
+    Heavy& heavy = heavy_[n];
+    refill(heavy, now_ns);
+    if (heavy.tokens >= kTokenScale) {
+        heavy.tokens -= kTokenScale;
+        ++total_admits_;
+        return Admit::Allow;
+    }
+    ++total_drops_;
+    return Admit::Drop;
+}
+
+void AgentLimiter::reconfigure(const AgentLimiterConfig& config) noexcept {
+    const bool decay_changed = decay_ns(config.decay_ms) != decay_ns_;
+    config_.tokens_per_sec = config.tokens_per_sec;
+    config_.burst_tokens = config.burst_tokens;
+    config_.decay_ms = config.decay_ms;
+    burst_ = static_cast<std::uint64_t>(config.burst_tokens) * kTokenScale;
+    full_refill_ns_ = full_refill_ns(burst_, config.tokens_per_sec);
+    decay_ns_ = decay_ns(config.decay_ms);
+
+    for (std::size_t i = 0; i < heavy_count_; ++i) {
+        heavy_[i].tokens = std::min(heavy_[i].tokens, burst_);
+    }
+    if (decay_changed) {
+        // Stored epochs are in the old interval's units
+        std::fill(sketch_.begin(), sketch_.end(), Counter{});
+    }
+}
+
+std::uint32_t AgentLimiter::estimate(std::string_view agent_id,
+                                     std::chrono::steady_clock::time_point now) const noexcept {
+    const std::uint64_t h = hash(agent_id);
+    const std::uint32_t epoch = epoch_of(to_ns(now));
+    std::uint32_t min = UINT32_MAX;
+    for (std::size_t row = 0; row < depth_; ++row) {
+        min = std::min(min, decayed(sketch_[counter_index(h, row)], epoch));
+    }
+    return min;
+}
+
+bool AgentLimiter::is_heavy(std::string_view agent_id) const noexcept {
+    return heavy_index_[find_heavy(hash(agent_id))] != kNil;
+}
+
+std::size_t AgentLimiter::memory_bytes() const noexcept {
+    return sketch_.size() * sizeof(Counter) + heavy_.size() * sizeof(Heavy) +
+           heavy_index_.memory_bytes();
+}
+
+}  // namespace gateway
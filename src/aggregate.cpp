@@ -0,0 +1,289 @@
+#include "gateway/aggregate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <random>
+
+namespace gateway {
+
+namespace {
+
+// Tag order for series keys: by key, then value
+bool tag_less(const MetricTag* a, const MetricTag* b) noexcept {
+    return a->key != b->key ? a->key < b->key : a->value < b->value;
+}
+
+constexpr int kMinExponent = -9;  // frexp exponent of 2^-10 is -9
+constexpr int kOctaves = 48;
+
+}  // namespace
+
+MetricsAggregator::MetricsAggregator(AggregatorConfig config)
+    : config_(config)
+    , seed_((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    , series_(std::max<std::size_t>(config.max_series, 1))
+    , series_index_(series_.size())
+    , agents_(std::max<std::size_t>(config.max_agents, 1))
+    , agent_index_(agents_.size())
+    , arena_(config.arena_bytes)
+    , buckets_(config.quantiles ? series_.size() * kQuantileBuckets : 0)
+    , scratch_(series_.size())
+    , agent_offsets_(agents_.size() + 1) {}
+
+std::string_view MetricsAggregator::arena_copy(std::string_view s, bool& ok) noexcept {
+    if (!ok || s.empty()) {
+        return {};
+    }
+    if (arena_.size() - arena_used_ < s.size()) {
+        ok = false;
+        return {};
+    }
+    char* p = reinterpret_cast<char*>(arena_.data() + arena_used_);
+    std::memcpy(p, s.data(), s.size());
+    arena_used_ += s.size();
+    return {p, s.size()};
+}
+
+MetricTag* MetricsAggregator::arena_tags(std::size_t count, bool& ok) noexcept {
+    if (!ok || count == 0) {
+        return nullptr;
+    }
+    const std::size_t start = (arena_used_ + alignof(MetricTag) - 1) & ~(alignof(MetricTag) - 1);
+    const std::size_t bytes = count * sizeof(MetricTag);
+    if (start > arena_.size() || arena_.size() - start < bytes) {
+        ok = false;
+        return nullptr;
+    }
+    arena_used_ = start + bytes;
+    // std::vector<std::byte> storage is suitably aligned for MetricTag
+    return new (arena_.data() + start) MetricTag[count];
+}
+
+std::uint32_t MetricsAggregator::intern_agent(std::string_view agent_id, bool& arena_full) noexcept {
+    const std::uint64_t hash = hash_bytes(seed_, agent_id);
+    const std::size_t slot = agent_index_.find(agent_index_.home(hash), [&](std::uint32_t n) {
+        return agents_[n].hash == hash && agents_[n].id == agent_id;
+    });
+    if (agent_index_[slot] != kNil) {
+        return agent_index_[slot];
+    }
+    if (agent_count_ == agents_.size()) {
+        arena_full = false;
+        return kNil;
+    }
+    bool ok = true;
+    const std::string_view id = arena_copy(agent_id, ok);
+    if (!ok) {
+        arena_full = true;
+        return kNil;
+    }
+    const auto n = static_cast<std::uint32_t>(agent_count_++);
+    agents_[n] = Agent{.hash = hash, .id = id, .series = 0};
+    agent_index_.set(slot, n);
+    return n;
+}
+
+bool MetricsAggregator::matches(const Series& s, std::uint32_t agent, const Metric& metric,
+                                std::span<const MetricTag* const> tags) const noexcept {
+    if (s.agent != agent || s.tag_count != tags.size() || s.name != metric.name ||
+        s.unit != metric.unit) {
+        return false;
+    }
+    for (std::size_t i = 0; i < tags.size(); ++i) {
+        if (s.tags[i].key != tags[i]->key || s.tags[i].value != tags[i]->value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t MetricsAggregator::bucket_of(double v) noexcept {
+    if (!(v > 0x1p-10)) {
+        return 0;  // zero, negative, tiny and NaN
+    }
+    int exponent = 0;
+    const double mantissa = std::frexp(v, &exponent);  // [0.5, 1)
+    const int octave = exponent - kMinExponent;
+    if (octave >= kOctaves) {
+        return kQuantileBuckets - 1;
+    }
+    const auto sub = static_cast<std::size_t>((mantissa - 0.5) * 8);  // 0..3
+    return 1 + static_cast<std::size_t>(octave) * 4 + std::min<std::size_t>(sub, 3);
+}
+
+bool MetricsAggregator::fold(std::uint32_t agent, const Metric& metric,
+                             std::span<const MetricTag* const> tags) noexcept {
+    std::uint64_t hash = hash_bytes(seed_ ^ agents_[agent].hash, metric.name);
+    hash = hash_bytes(hash, metric.unit);
+    for (const MetricTag* tag : tags) {
+        hash = hash_bytes(hash_bytes(hash, tag->key), tag->value);
+    }
+
+    const std::size_t slot = series_index_.find(series_index_.home(hash), [&](std::uint32_t n) {
+        return series_[n].hash == hash && matches(series_[n], agent, metric, tags);
+    });
+
+    std::uint32_t n = series_index_[slot];
+    if (n == kNil) {
+        Agent& a = agents_[agent];
+        if (series_count_ == series_.size() || a.series >= config_.max_series_per_agent) {
+            ++dropped_cardinality_;
+            return false;
+        }
+        // Intern the key; on a full arena the partial copy is abandoned
+        // (reclaimed at the next flush)
+        bool ok = true;
+        const std::string_view name = arena_copy(metric.name, ok);
+        const std::string_view unit = arena_copy(metric.unit, ok);
+        MetricTag* stored = arena_tags(tags.size(), ok);
+        for (std::size_t i = 0; ok && i < tags.size(); ++i) {
+            stored[i].key = arena_copy(tags[i]->key, ok);
+            stored[i].value = arena_copy(tags[i]->value, ok);
+        }
+        if (!ok) {
+            ++dropped_arena_;
+            return false;
+        }
+        n = static_cast<std::uint32_t>(series_count_++);
+        series_[n] = Series{.hash = hash, .agent = agent,
+                            .tag_count = static_cast<std::uint32_t>(tags.size()),
+                            .name = name, .unit = unit, .tags = stored,
+                            .count = 0, .sum = 0, .min = metric.value, .max = metric.value};
+        series_index_.set(slot, n);
+        ++a.series;
+        if (!buckets_.empty()) {
+            std::fill_n(&buckets_[n * kQuantileBuckets], kQuantileBuckets, 0);
+        }
+    }
+
+    Series& s = series_[n];
+    ++s.count;
+    s.sum += metric.value;
+    s.min = std::min(s.min, metric.value);
+    s.max = std::max(s.max, metric.value);
+    if (!buckets_.empty()) {
+        ++buckets_[n * kQuantileBuckets + bucket_of(metric.value)];
+    }
+    ++folded_;
+    return true;
+}
+
+std::size_t MetricsAggregator::add(const ValidatedMetrics& metrics, std::uint64_t now_ms) noexcept {
+    if (metrics.metric_count == 0) {
+        return 0;
+    }
+    if (series_count_ == 0 && agent_count_ == 0) {
+        window_start_ms_ = now_ms;
+    }
+    bool arena_full = false;
+    const std::uint32_t agent = intern_agent(metrics.agent_id, arena_full);
+    if (agent == kNil) {
+        (arena_full ? dropped_arena_ : dropped_cardinality_) += metrics.metric_count;
+        return metrics.metric_count;
+    }
+
+    std::size_t dropped = 0;
+    const MetricTag* sorted[MetricsLimits::kMaxTags];
+    for (std::size_t i = 0; i < metrics.metric_count; ++i) {
+        const Metric& m = metrics.metrics[i];
+        const auto tags = metrics.tags_of(m);
+        const std::size_t count = std::min(tags.size(), MetricsLimits::kMaxTags);
+        // Insertion sort: at most kMaxTags entries
+        for (std::size_t t = 0; t < count; ++t) {
+            const MetricTag* tag = &tags[t];
+            std::size_t j = t;
+            for (; j > 0 && tag_less(tag, sorted[j - 1]); --j) {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = tag;
+        }
+        if (!fold(agent, m, std::span<const MetricTag* const>(sorted, count))) {
+            ++dropped;
+        }
+    }
+    return dropped;
+}
+
+double MetricsAggregator::quantile(const std::uint32_t* buckets, const Series& s,
+                                   double q) const noexcept {
+    const auto rank = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(s.count))), 1);
+    std::uint64_t seen = 0;
+    std::size_t b = 0;
+    for (; b < kQuantileBuckets; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            break;
+        }
+    }
+    if (b == 0) {
+        return s.min;
+    }
+    if (b >= kQuantileBuckets - 1) {
+        return s.max;
+    }
+    // Bucket midpoint: mantissa [0.5 + sub/8, 0.5 + (sub+1)/8) at the octave
+    const std::size_t octave = (b - 1) / 4;
+    const std::size_t sub = (b - 1) % 4;
+    const double mid = std::ldexp(0.5 + (static_cast<double>(sub) + 0.5) / 8,
+                                  static_cast<int>(octave) + kMinExponent);
+    return std::clamp(mid, s.min, s.max);
+}
+
+std::size_t MetricsAggregator::flush(std::uint64_t now_ms, const RollupSink& emit) {
+    const std::size_t emitted = series_count_;
+    if (emitted == 0) {
+        reset_window();
+        return 0;
+    }
+
+    // Group by agent with a counting sort: O(series + agents)
+    std::fill_n(agent_offsets_.begin(), agent_count_ + 1, 0);
+    for (std::size_t i = 0; i < series_count_; ++i) {
+        ++agent_offsets_[series_[i].agent + 1];
+    }
+    for (std::size_t a = 0; a < agent_count_; ++a) {
+        agent_offsets_[a + 1] += agent_offsets_[a];
+    }
+    for (std::size_t i = 0; i < series_count_; ++i) {
+        const Series& s = series_[i];
+        RollupSeries& out = scratch_[agent_offsets_[s.agent]++];
+        out = RollupSeries{.name = s.name, .unit = s.unit, .tags = {s.tags, s.tag_count},
+                           .count = s.count, .sum = s.sum, .min = s.min, .max = s.max};
+        if (!buckets_.empty()) {
+            const std::uint32_t* b = &buckets_[i * kQuantileBuckets];
+            out.p50 = quantile(b, s, 0.50);
+            out.p90 = quantile(b, s, 0.90);
+            out.p99 = quantile(b, s, 0.99);
+        }
+    }
+
+    // agent_offsets_[a] is now the end of agent a's group
+    std::size_t begin = 0;
+    for (std::size_t a = 0; a < agent_count_; ++a) {
+        const std::size_t end = agent_offsets_[a];
+        if (end > begin) {
+            emit(RollupEvent{.agent_id = agents_[a].id,
+                             .ts = window_start_ms_,
+                             .interval_ms = now_ms > window_start_ms_ ? now_ms - window_start_ms_ : 0,
+                             .quantiles = !buckets_.empty(),
+                             .series = std::span<const RollupSeries>(scratch_.data() + begin, end - begin)});
+        }
+        begin = end;
+    }
+
+    reset_window();
+    return emitted;
+}
+
+void MetricsAggregator::reset_window() noexcept {
+    series_index_.clear();
+    agent_index_.clear();
+    series_count_ = 0;
+    agent_count_ = 0;
+    arena_used_ = 0;
+}
+
+}  // namespace gateway
@@ -0,0 +1,428 @@
+#include "gateway/binary_format.hpp"
+#include "gateway/char_class.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace gateway {
+
+namespace {
+
+enum class ReadStatus : std::uint8_t { Ok, Truncated, Malformed, TooLong };
+
+// Map a read failure to the format's drop reason; `too_long` names the
+// field-specific limit that was exceeded
+template <typename Reason>
+Reason to_drop(ReadStatus status, Reason too_long) noexcept {
+    switch (status) {
+        case ReadStatus::Truncated: return Reason::BinaryTruncated;
+        case ReadStatus::TooLong:   return too_long;
+        case ReadStatus::Malformed:
+        case ReadStatus::Ok:        break;
+    }
+    return Reason::BinaryMalformed;
+}
+
+// Bounds-checked big-endian reader over the body
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> in) noexcept : in_(in) {}
+
+    bool at_end() const noexcept { return pos_ == in_.size(); }
+
+    bool u8(std::uint8_t& v) noexcept {
+        if (in_.size() - pos_ < 1) return false;
+        v = std::to_integer<std::uint8_t>(in_[pos_++]);
+        return true;
+    }
+
+    bool u32(std::uint32_t& v) noexcept {
+        std::uint64_t wide = 0;
+        if (!be(4, wide)) return false;
+        v = static_cast<std::uint32_t>(wide);
+        return true;
+    }
+
+    bool u64(std::uint64_t& v) noexcept { return be(8, v); }
+
+    ReadStatus varint(std::uint32_t& v) noexcept {
+        std::uint64_t acc = 0;
+        for (std::size_t i = 0; i < BinaryFormat::kMaxVarintBytes; ++i) {
+            std::uint8_t b = 0;
+            if (!u8(b)) return ReadStatus::Truncated;
+            acc |= static_cast<std::uint64_t>(b & 0x7F) << (7 * i);
+            if ((b & 0x80) == 0) {
+                if (acc > UINT32_MAX) return ReadStatus::Malformed;
+                v = static_cast<std::uint32_t>(acc);
+                return ReadStatus::Ok;
+            }
+        }
+        return ReadStatus::Malformed;
+    }
+
+    bool bytes(std::size_t n, std::string_view& s) noexcept {
+        if (in_.size() - pos_ < n) return false;
+        s = std::string_view(reinterpret_cast<const char*>(in_.data() + pos_), n);
+        pos_ += n;
+        return true;
+    }
+
+    // Length is checked against the limit before the remaining bytes, so
+    // an oversized field reports its limit rather than truncation
+    ReadStatus str(std::string_view& s, std::size_t limit) noexcept {
+        std::uint32_t len = 0;
+        if (auto st = varint(len); st != ReadStatus::Ok) return st;
+        if (len > limit) return ReadStatus::TooLong;
+        return bytes(len, s) ? ReadStatus::Ok : ReadStatus::Truncated;
+    }
+
+private:
+    bool be(std::size_t n, std::uint64_t& v) noexcept {
+        if (in_.size() - pos_ < n) return false;
+        std::uint64_t acc = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            acc = (acc << 8) | std::to_integer<std::uint64_t>(in_[pos_ + i]);
+        }
+        pos_ += n;
+        v = acc;
+        return true;
+    }
+
+    std::span<const std::byte> in_;
+    std::size_t pos_ = 0;
+};
+
+// Big-endian writer; any overflow latches `ok` to false
+class Writer {
+public:
+    explicit Writer(std::span<std::byte> out) noexcept : out_(out) {}
+
+    bool ok() const noexcept { return ok_; }
+    std::size_t size() const noexcept { return pos_; }
+
+    void u8(std::uint8_t v) noexcept {
+        if (!room(1)) return;
+        out_[pos_++] = std::byte{v};
+    }
+
+    void be(std::uint64_t v, std::size_t n) noexcept {
+        if (!room(n)) return;
+        for (std::size_t i = 0; i < n; ++i) {
+            out_[pos_ + i] = std::byte(static_cast<std::uint8_t>(v >> (8 * (n - 1 - i))));
+        }
+        pos_ += n;
+    }
+
+    void varint(std::uint32_t v) noexcept {
+        while (v >= 0x80) {
+            u8(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        u8(static_cast<std::uint8_t>(v));
+    }
+
+    void raw(std::string_view s) noexcept {
+        if (!room(s.size())) return;
+        std::memcpy(out_.data() + pos_, s.data(), s.size());
+        pos_ += s.size();
+    }
+
+    void str(std::string_view s) noexcept {
+        varint(static_cast<std::uint32_t>(s.size()));
+        raw(s);
+    }
+
+private:
+    bool room(std::size_t n) noexcept {
+        if (!ok_ || out_.size() - pos_ < n) {
+            ok_ = false;
+        }
+        return ok_;
+    }
+
+    std::span<std::byte> out_;
+    std::size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+bool is_reserved_log_key(std::string_view key) noexcept {
+    return key == "ts" || key == "level" || key == "msg" || key == "agent";
+}
+
+bool valid_log_key(std::string_view key) noexcept {
+    return !key.empty() && chars::is(key[0], chars::kLogKeyStart) &&
+           chars::all_of(key.data() + 1, key.size() - 1, chars::kLogKeyChar);
+}
+
+} // namespace
+
+std::optional<MetricsDropReason> parse_binary_metrics(std::span<const std::byte> input,
+                                                      ParsedMetrics& out) noexcept {
+    using R = MetricsDropReason;
+    using L = MetricsLimits;
+
+    if (input.size() > L::kMaxInputBytes) {
+        return R::InputTooLarge;
+    }
+
+    Reader r(input);
+    std::uint8_t magic = 0;
+    std::uint8_t version = 0;
+    if (!r.u8(magic) || !r.u8(version)) {
+        return R::BinaryTruncated;
+    }
+    if (magic != BinaryFormat::kMetricsMagic) {
+        return R::BinaryMalformed;
+    }
+    if (version != BinaryFormat::kVersion) {
+        return R::BinaryUnsupportedVersion;
+    }
+
+    out.agent_id = {};
+    out.metric_count = 0;
+    out.tag_total = 0;
+    out.text_used = 0;
+    if (!r.u32(out.seq) || !r.u64(out.ts)) {
+        return R::BinaryTruncated;
+    }
+
+    if (auto st = r.str(out.agent_id, L::kMaxAgentIdLen); st != ReadStatus::Ok) {
+        return to_drop(st, R::AgentIdTooLong);
+    }
+    if (out.agent_id.empty() ||
+        !chars::all_of(out.agent_id.data(), out.agent_id.size(), chars::kJsonAgentIdChar)) {
+        return R::AgentIdInvalidChars;
+    }
+
+    // Invariant 2: counts are checked before the loops they bound
+    std::uint32_t count = 0;
+    if (auto st = r.varint(count); st != ReadStatus::Ok) {
+        return to_drop(st, R::BinaryMalformed);
+    }
+    if (count > L::kMaxMetrics) {
+        return R::TooManyMetrics;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        Metric& m = out.metrics[i];
+
+        std::uint32_t name_ref = 0;
+        if (auto st = r.varint(name_ref); st != ReadStatus::Ok) {
+            return to_drop(st, R::BinaryMalformed);
+        }
+        if (name_ref & 1) {
+            const std::uint32_t earlier = name_ref >> 1;
+            if (earlier >= i) {
+                return R::BinaryMalformed;
+            }
+            m.name = out.metrics[earlier].name;
+        } else {
+            const std::uint32_t len = name_ref >> 1;
+            if (len > L::kMaxMetricNameLen) {
+                return R::MetricNameTooLong;
+            }
+            if (!r.bytes(len, m.name)) {
+                return R::BinaryTruncated;
+            }
+        }
+
+        std::uint64_t bits = 0;
+        if (!r.u64(bits)) {
+            return R::BinaryTruncated;
+        }
+        m.value = std::bit_cast<double>(bits);
+
+        if (auto st = r.str(m.unit, L::kMaxUnitLen); st != ReadStatus::Ok) {
+            return to_drop(st, R::UnitTooLong);
+        }
+
+        std::uint32_t tag_count = 0;
+        if (auto st = r.varint(tag_count); st != ReadStatus::Ok) {
+            return to_drop(st, R::BinaryMalformed);
+        }
+        if (tag_count > L::kMaxTags || out.tag_total + tag_count > L::kMaxTotalTags) {
+            return R::TooManyTags;
+        }
+        m.tag_offset = static_cast<std::uint16_t>(out.tag_total);
+        m.tag_count = static_cast<std::uint16_t>(tag_count);
+        for (std::uint32_t t = 0; t < tag_count; ++t) {
+            MetricTag& tag = out.tags[out.tag_total];
+            if (auto st = r.str(tag.key, L::kMaxTagKeyLen); st != ReadStatus::Ok) {
+                return to_drop(st, R::TagKeyTooLong);
+            }
+            if (auto st = r.str(tag.value, L::kMaxTagValueLen); st != ReadStatus::Ok) {
+                return to_drop(st, R::TagValueTooLong);
+            }
+            ++out.tag_total;
+        }
+        ++out.metric_count;
+    }
+
+    if (!r.at_end()) {
+        return R::BinaryMalformed;
+    }
+    return std::nullopt;
+}
+
+std::optional<LogDropReason> parse_binary_log(std::span<const std::byte> input,
+                                              ParsedLog& out) noexcept {
+    using R = LogDropReason;
+    using L = LogLimits;
+
+    if (input.size() > L::kMaxLineBytes) {
+        return R::InputTooLarge;
+    }
+
+    Reader r(input);
+    std::uint8_t magic = 0;
+    std::uint8_t version = 0;
+    if (!r.u8(magic) || !r.u8(version)) {
+        return R::BinaryTruncated;
+    }
+    if (magic != BinaryFormat::kLogMagic) {
+        return R::BinaryMalformed;
+    }
+    if (version != BinaryFormat::kVersion) {
+        return R::BinaryUnsupportedVersion;
+    }
+
+    out.field_count = 0;
+    out.agent_id = {};
+    out.msg = {};
+    std::uint8_t level = 0;
+    if (!r.u64(out.ts) || !r.u8(level)) {
+        return R::BinaryTruncated;
+    }
+    if (level > static_cast<std::uint8_t>(LogLevel::Fatal)) {
+        return R::InvalidLevel;
+    }
+    out.level = static_cast<LogLevel>(level);
+
+    if (auto st = r.str(out.agent_id, L::kMaxValueLen); st != ReadStatus::Ok) {
+        return to_drop(st, R::ValueTooLong);
+    }
+    if (auto st = r.str(out.msg, L::kMaxValueLen); st != ReadStatus::Ok) {
+        return to_drop(st, R::ValueTooLong);
+    }
+
+    // kMaxFields counts the dedicated fields too, as in a logfmt line
+    std::uint32_t count = 0;
+    if (auto st = r.varint(count); st != ReadStatus::Ok) {
+        return to_drop(st, R::BinaryMalformed);
+    }
+    const std::size_t dedicated = out.agent_id.empty() ? 3 : 4;
+    if (count > L::kMaxFields - dedicated) {
+        return R::TooManyFields;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        LogField& f = out.fields[i];
+        if (auto st = r.str(f.key, L::kMaxKeyLen); st != ReadStatus::Ok) {
+            return to_drop(st, R::KeyTooLong);
+        }
+        if (!valid_log_key(f.key)) {
+            return R::InvalidKeyChar;
+        }
+        if (is_reserved_log_key(f.key)) {
+            return R::BinaryMalformed;
+        }
+        if (auto st = r.str(f.value, L::kMaxValueLen); st != ReadStatus::Ok) {
+            return to_drop(st, R::ValueTooLong);
+        }
+        ++out.field_count;
+    }
+
+    if (!r.at_end()) {
+        return R::BinaryMalformed;
+    }
+    return std::nullopt;
+}
+
+std::size_t encode_binary_metrics(const ParsedMetrics& metrics,
+                                  std::span<std::byte> out) noexcept {
+    using L = MetricsLimits;
+    if (metrics.agent_id.size() > L::kMaxAgentIdLen || metrics.metric_count > L::kMaxMetrics) {
+        return 0;
+    }
+
+    Writer w(out);
+    w.u8(BinaryFormat::kMetricsMagic);
+    w.u8(BinaryFormat::kVersion);
+    w.be(metrics.seq, 4);
+    w.be(metrics.ts, 8);
+    w.str(metrics.agent_id);
+    w.varint(static_cast<std::uint32_t>(metrics.metric_count));
+
+    for (std::size_t i = 0; i < metrics.metric_count; ++i) {
+        const Metric& m = metrics.metrics[i];
+        if (m.name.size() > L::kMaxMetricNameLen || m.unit.size() > L::kMaxUnitLen ||
+            m.tag_count > L::kMaxTags) {
+            return 0;
+        }
+
+        // Back-reference the first earlier metric with the same name
+        std::size_t earlier = 0;
+        while (earlier < i && metrics.metrics[earlier].name != m.name) {
+            ++earlier;
+        }
+        if (earlier < i) {
+            w.varint(static_cast<std::uint32_t>(earlier << 1 | 1));
+        } else {
+            w.varint(static_cast<std::uint32_t>(m.name.size() << 1));
+            w.raw(m.name);
+        }
+
+        w.be(std::bit_cast<std::uint64_t>(m.value), 8);
+        w.str(m.unit);
+        w.varint(m.tag_count);
+        for (const MetricTag& tag : metrics.tags_of(m)) {
+            if (tag.key.size() > L::kMaxTagKeyLen || tag.value.size() > L::kMaxTagValueLen) {
+                return 0;
+            }
+            w.str(tag.key);
+            w.str(tag.value);
+        }
+    }
+    return w.ok() ? w.size() : 0;
+}
+
+std::size_t encode_binary_log(const ParsedLog& log, std::span<std::byte> out) noexcept {
+    using L = LogLimits;
+    if (log.agent_id.size() > L::kMaxValueLen || log.msg.size() > L::kMaxValueLen) {
+        return 0;
+    }
+
+    std::size_t extra = 0;
+    for (std::size_t i = 0; i < log.field_count; ++i) {
+        const LogField& f = log.fields[i];
+        if (is_reserved_log_key(f.key)) {
+            continue;
+        }
+        if (f.key.size() > L::kMaxKeyLen || f.value.size() > L::kMaxValueLen) {
+            return 0;
+        }
+        ++extra;
+    }
+    if (extra > L::kMaxFields - (log.agent_id.empty() ? 3 : 4)) {
+        return 0;
+    }
+
+    Writer w(out);
+    w.u8(BinaryFormat::kLogMagic);
+    w.u8(BinaryFormat::kVersion);
+    w.be(log.ts, 8);
+    w.u8(static_cast<std::uint8_t>(log.level));
+    w.str(log.agent_id);
+    w.str(log.msg);
+    w.varint(static_cast<std::uint32_t>(extra));
+    for (std::size_t i = 0; i < log.field_count; ++i) {
+        const LogField& f = log.fields[i];
+        if (!is_reserved_log_key(f.key)) {
+            w.str(f.key);
+            w.str(f.value);
+        }
+    }
+    return w.ok() ? w.size() : 0;
+}
+
+}  // namespace gateway
@@ -0,0 +1,44 @@
+#include "gateway/buffer_pool.hpp"
+
+namespace gateway {
+
+BufferPool::BufferPool(std::size_t buffer_count, std::size_t buffer_bytes)
+    : buffer_bytes_(buffer_bytes)
+    , slab_(buffer_count * buffer_bytes)
+    , free_list_(buffer_count)
+    , free_count_(buffer_count) {
+    // Hand out low indices first (stack top is the end of the array)
+    for (std::size_t i = 0; i < buffer_count; ++i) {
+        free_list_[i] = static_cast<BufferIndex>(buffer_count - 1 - i);
+    }
+}
+
+BufferHandle BufferPool::acquire() noexcept {
+    const BufferIndex index = acquire_index();
+    if (index == kNoBuffer) {
+        return {};
+    }
+    return BufferHandle(this, index);
+}
+
+BufferIndex BufferPool::acquire_index() noexcept {
+    if (free_count_ == 0) {
+        ++exhausted_count_;
+        return kNoBuffer;
+    }
+    --free_count_;
+    return free_list_[free_count_];
+}
+
+void BufferPool::release(BufferIndex index) noexcept {
+    // Capacity of free_list_ equals buffer count, so this never overflows
+    // as long as each buffer is released once (enforced by BufferHandle;
+    // by the caller for acquire_index()). Foreign indices are ignored.
+    if (index >= free_list_.size() || free_count_ >= free_list_.size()) {
+        return;
+    }
+    free_list_[free_count_] = index;
+    ++free_count_;
+}
+
+}  // namespace gateway
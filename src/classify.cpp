@@ -0,0 +1,332 @@
+#include "gateway/classify.hpp"
+#include "gateway/binary_format.hpp"
+#include "gateway/char_class.hpp"
+#include "gateway/keyword_table.hpp"
+#include "gateway/scan.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace gateway {
+
+namespace {
+
+// Root keys allowed before "metrics" (the parser rejects any other key)
+enum class RootKey : std::uint8_t { AgentId, Seq, Ts, Metrics, Unknown };
+enum class LogKey : std::uint8_t { Ts, Level, Msg, Agent, Unknown };
+
+constexpr KeywordTable<RootKey, 4> kRootKeys({"agent_id", "seq", "ts", "metrics"});
+constexpr KeywordTable<LogKey, 4> kLogKeys({"ts", "level", "msg", "agent"});
+
+// Byte cursor over the body; every read is bounds-checked
+struct Cursor {
+    std::string_view text;
+    std::size_t pos = 0;
+
+    char peek() const noexcept { return pos < text.size() ? text[pos] : '\0'; }
+    bool at_end() const noexcept { return pos >= text.size(); }
+
+    bool expect(char c) noexcept {
+        if (peek() != c || at_end()) {
+            return false;
+        }
+        ++pos;
+        return true;
+    }
+
+    void skip_json_space() noexcept {
+        pos += scan::skip_whitespace(text.data() + pos, text.size() - pos);
+    }
+
+    void skip_log_blank() noexcept {
+        while (!at_end() && chars::is(text[pos], chars::kLogBlank)) {
+            ++pos;
+        }
+    }
+
+    // JSON string with the parser's escape handling; view excludes quotes
+    std::optional<std::string_view> json_string() noexcept {
+        if (!expect('"')) {
+            return std::nullopt;
+        }
+        const std::size_t start = pos;
+        while (true) {
+            pos += scan::find_quote_or_escape(text.data() + pos, text.size() - pos);
+            if (at_end()) {
+                return std::nullopt;
+            }
+            if (text[pos] == '"') {
+                return text.substr(start, pos++ - start);
+            }
+            pos += (pos + 1 < text.size()) ? 2 : 1;
+        }
+    }
+
+    // JSON integer as the parser reads it: -?[0-9]+ into an int64
+    std::optional<std::int64_t> json_integer() noexcept {
+        const std::size_t start = pos;
+        if (peek() == '-') {
+            ++pos;
+        }
+        if (!chars::is(peek(), chars::kDigit)) {
+            return std::nullopt;
+        }
+        pos += scan::skip_digits(text.data() + pos, text.size() - pos);
+        std::int64_t value = 0;
+        auto [ptr, ec] = std::from_chars(text.data() + start, text.data() + pos, value);
+        if (ec != std::errc{}) {
+            return std::nullopt;
+        }
+        return value;
+    }
+};
+
+// Root object up to the "metrics" key; mirrors JsonParser's root loop
+ClassifyResult classify_json(Cursor& c) noexcept {
+    MessageHeader header{};
+    header.format = MessageFormat::Metrics;
+
+    if (!c.expect('{')) {
+        return PrefilterDrop::Malformed;
+    }
+    c.skip_json_space();
+    if (c.peek() == '}') {
+        return PrefilterDrop::MissingFormatKey;
+    }
+
+    while (true) {
+        c.skip_json_space();
+        auto key = c.json_string();
+        if (!key) {
+            return PrefilterDrop::Malformed;
+        }
+        c.skip_json_space();
+        if (!c.expect(':')) {
+            return PrefilterDrop::Malformed;
+        }
+        c.skip_json_space();
+
+        switch (kRootKeys.find(*key)) {
+            case RootKey::AgentId: {
+                auto val = c.json_string();
+                if (!val) {
+                    return PrefilterDrop::Malformed;
+                }
+                // An escaped id is decoded by TB-3; its raw bytes say
+                // nothing about the decoded format, so leave it unchecked
+                header.agent_id = val->find('\\') == std::string_view::npos
+                                      ? *val
+                                      : std::string_view{};
+                break;
+            }
+            case RootKey::Seq:
+                if (!c.json_integer()) {
+                    return PrefilterDrop::Malformed;
+                }
+                break;
+            case RootKey::Ts: {
+                auto val = c.json_integer();
+                if (!val) {
+                    return PrefilterDrop::Malformed;
+                }
+                header.ts = static_cast<std::uint64_t>(*val);
+                header.has_ts = true;
+                break;
+            }
+            case RootKey::Metrics:
+                // Header done: the array is left to the parser
+                header.header_bytes = c.pos;
+                return header;
+            case RootKey::Unknown:
+                return PrefilterDrop::Malformed;
+        }
+
+        c.skip_json_space();
+        if (c.peek() == '}') {
+            return PrefilterDrop::MissingFormatKey;
+        }
+        if (!c.expect(',')) {
+            return PrefilterDrop::Malformed;
+        }
+    }
+}
+
+// logfmt fields until ts, level and msg are seen; mirrors LogfmtParser's
+// key, '=' and quote rules (bare values end at blank, '=' or '"')
+ClassifyResult classify_log(Cursor& c) noexcept {
+    MessageHeader header{};
+    header.format = MessageFormat::Log;
+    bool has_level = false;
+    bool has_msg = false;
+    bool has_ts_key = false;
+
+    while (true) {
+        c.skip_log_blank();
+        if (c.at_end()) {
+            return PrefilterDrop::MissingFormatKey;
+        }
+
+        const std::size_t key_start = c.pos;
+        if (!chars::is(c.text[c.pos], chars::kLogKeyStart)) {
+            return PrefilterDrop::Malformed;
+        }
+        ++c.pos;
+        c.pos += chars::span_of(c.text.data() + c.pos, c.text.size() - c.pos, chars::kLogKeyChar);
+        const std::string_view key = c.text.substr(key_start, c.pos - key_start);
+        if (!c.expect('=')) {
+            return PrefilterDrop::Malformed;
+        }
+
+        std::string_view value;
+        if (c.peek() == '"' && !c.at_end()) {
+            const void* close = std::memchr(c.text.data() + c.pos + 1, '"',
+                                            c.text.size() - c.pos - 1);
+            if (close == nullptr) {
+                return PrefilterDrop::Malformed;
+            }
+            const std::size_t end = static_cast<std::size_t>(
+                static_cast<const char*>(close) - c.text.data());
+            value = c.text.substr(c.pos + 1, end - c.pos - 1);
+            c.pos = end + 1;
+        } else {
+            const std::size_t start = c.pos;
+            while (!c.at_end() && !chars::is(c.text[c.pos], chars::kLogBlank) &&
+                   c.text[c.pos] != '=' && c.text[c.pos] != '"') {
+                ++c.pos;
+            }
+            value = c.text.substr(start, c.pos - start);
+        }
+
+        switch (kLogKeys.find(key)) {
+            case LogKey::Ts: {
+                std::uint64_t ts = 0;
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), ts);
+                header.has_ts = ec == std::errc{} && ptr == value.data() + value.size();
+                header.ts = header.has_ts ? ts : 0;
+                has_ts_key = true;
+                break;
+            }
+            case LogKey::Level:
+                has_level = true;
+                break;
+            case LogKey::Msg:
+                has_msg = true;
+                break;
+            case LogKey::Agent:
+                header.agent_id = value;
+                break;
+            case LogKey::Unknown:
+                break;
+        }
+
+        if (has_ts_key && has_level && has_msg) {
+            header.header_bytes = c.pos;
+            return header;
+        }
+    }
+}
+
+// Binary header: fixed ts position, agent_id right after it. A length
+// prefix longer than one byte is legal but not worth a header check, so
+// the agent_id is then left to the decoder.
+ClassifyResult classify_binary(std::span<const std::byte> body) noexcept {
+    auto byte_at = [body](std::size_t i) { return std::to_integer<std::uint8_t>(body[i]); };
+
+    MessageHeader header{};
+    header.binary = true;
+    std::size_t ts_at = 0;
+    std::size_t agent_at = 0;
+    switch (byte_at(0)) {
+        case BinaryFormat::kMetricsMagic:
+            header.format = MessageFormat::Metrics;
+            ts_at = 2 + 4;                // after seq
+            agent_at = ts_at + 8;
+            break;
+        case BinaryFormat::kLogMagic:
+            header.format = MessageFormat::Log;
+            ts_at = 2;
+            agent_at = ts_at + 8 + 1;     // after level
+            break;
+        default:
+            return PrefilterDrop::UnknownFormat;
+    }
+
+    if (body.size() < agent_at + 1 || byte_at(1) != BinaryFormat::kVersion) {
+        return PrefilterDrop::Malformed;
+    }
+    for (std::size_t i = 0; i < 8; ++i) {
+        header.ts = (header.ts << 8) | byte_at(ts_at + i);
+    }
+    header.has_ts = true;
+
+    const std::uint8_t agent_len = byte_at(agent_at);
+    header.header_bytes = agent_at + 1;
+    if (agent_len < 0x80 && body.size() - header.header_bytes >= agent_len) {
+        header.agent_id = std::string_view(
+            reinterpret_cast<const char*>(body.data()) + header.header_bytes, agent_len);
+        header.header_bytes += agent_len;
+    }
+    return header;
+}
+
+} // namespace
+
+ClassifyResult classify_message(std::span<const std::byte> body) noexcept {
+    if (is_binary_body(body)) {
+        return classify_binary(body);
+    }
+    std::string_view sv(reinterpret_cast<const char*>(body.data()), body.size());
+    return classify_message(sv);
+}
+
+ClassifyResult classify_message(std::string_view body) noexcept {
+    const auto bytes = std::as_bytes(std::span(body.data(), body.size()));
+    if (is_binary_body(bytes)) {
+        return classify_binary(bytes);
+    }
+
+    // The log parser ignores trailing line endings and blanks
+    while (!body.empty() && (chars::is(body.back(), chars::kJsonSpace))) {
+        body.remove_suffix(1);
+    }
+
+    Cursor c{body};
+    c.skip_json_space();
+    if (c.at_end()) {
+        return PrefilterDrop::EmptyInput;
+    }
+
+    if (c.peek() == '{') {
+        return classify_json(c);
+    }
+
+    // logfmt has no leading whitespace skip beyond blanks
+    c.pos = 0;
+    c.skip_log_blank();
+    if (c.at_end() || !chars::is(c.peek(), chars::kLogKeyStart)) {
+        return PrefilterDrop::UnknownFormat;
+    }
+    return classify_log(c);
+}
+
+std::optional<PrefilterDrop> check_header(
+    const MessageHeader& header,
+    const TimestampWindow& window,
+    std::uint64_t current_time_ms
+) noexcept {
+    if (!header.agent_id.empty() &&
+        !validate_agent_id_format(header.agent_id.data(), header.agent_id.size())) {
+        return PrefilterDrop::AgentIdInvalidFormat;
+    }
+
+    if (header.has_ts && header.ts != 0 &&
+        !validate_timestamp_window(header.ts, current_time_ms, window)) {
+        const auto max_age = static_cast<std::uint64_t>(window.max_age_ms);
+        const std::uint64_t min_allowed = current_time_ms > max_age ? current_time_ms - max_age : 0;
+        return header.ts < min_allowed ? PrefilterDrop::TimestampTooOld
+                                       : PrefilterDrop::TimestampInFuture;
+    }
+    return std::nullopt;
+}
+
+}  // namespace gateway
@@ -0,0 +1,908 @@
+#include "gateway/columnar.hpp"
+
+#include "gateway/parse_log.hpp"      // LogLevel, log_level_to_string
+#include "gateway/parse_metrics.hpp"  // MetricsLimits
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace gateway {
+
+namespace {
+
+constexpr std::size_t kMaxVarintBytes = 10;
+constexpr std::size_t kMaxHeaderBytes = 3 + 2 * kMaxVarintBytes;
+constexpr std::size_t kMaxDoubleChars = 32;
+constexpr std::uint8_t kMaxLogLevel = static_cast<std::uint8_t>(LogLevel::Fatal);
+
+std::uint64_t zigzag(std::uint64_t cur, std::uint64_t prev) noexcept {
+    const auto d = static_cast<std::int64_t>(cur - prev);
+    return (static_cast<std::uint64_t>(d) << 1) ^ static_cast<std::uint64_t>(d >> 63);
+}
+
+std::uint64_t unzigzag(std::uint64_t z, std::uint64_t prev) noexcept {
+    return prev + ((z >> 1) ^ (0 - (z & 1)));
+}
+
+std::size_t varint_size(std::uint64_t v) noexcept {
+    return std::max<std::size_t>(1, (std::bit_width(v) + 6) / 7);
+}
+
+void put_u8(std::vector<std::byte>& out, std::uint8_t v) {
+    out.push_back(std::byte{v});
+}
+
+void put_varint(std::vector<std::byte>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(std::byte(static_cast<std::uint8_t>(v | 0x80)));
+        v >>= 7;
+    }
+    out.push_back(std::byte(static_cast<std::uint8_t>(v)));
+}
+
+void put_bytes(std::vector<std::byte>& out, std::string_view s) {
+    const auto* p = reinterpret_cast<const std::byte*>(s.data());
+    out.insert(out.end(), p, p + s.size());
+}
+
+void put_f64(std::vector<std::byte>& out, double v) {
+    const auto bits = std::bit_cast<std::uint64_t>(v);
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(std::byte(static_cast<std::uint8_t>(bits >> (8 * i))));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Strict reader for the canonical JSON of serialize_event(): literal key
+// runs, strings (kept escaped), canonical integers and numbers. Any
+// mismatch fails the whole event, which is then carried raw.
+// ----------------------------------------------------------------------------
+class Canonical {
+public:
+    explicit Canonical(std::string_view in) noexcept : in_(in) {}
+
+    bool at_end() const noexcept { return pos_ == in_.size(); }
+
+    bool lit(std::string_view s) noexcept {
+        if (in_.substr(pos_, s.size()) != s) {
+            return false;
+        }
+        pos_ += s.size();
+        return true;
+    }
+
+    // "..." -> the bytes between the quotes
+    bool str(std::string_view& out) noexcept {
+        if (!lit("\"")) {
+            return false;
+        }
+        const std::size_t begin = pos_;
+        while (pos_ < in_.size()) {
+            const char c = in_[pos_];
+            if (c == '"') {
+                out = in_.substr(begin, pos_ - begin);
+                ++pos_;
+                return true;
+            }
+            pos_ += c == '\\' ? 2 : 1;
+        }
+        return false;
+    }
+
+    // Digits without a leading zero, as std::to_chars writes them
+    bool integer(std::uint64_t& out) noexcept {
+        const char* first = in_.data() + pos_;
+        const char* last = in_.data() + in_.size();
+        auto [ptr, ec] = std::from_chars(first, last, out);
+        if (ec != std::errc{} || (*first == '0' && ptr - first > 1)) {
+            return false;
+        }
+        pos_ = static_cast<std::size_t>(ptr - in_.data());
+        return true;
+    }
+
+    // Shortest round-trip form (checked by formatting it again) or null
+    bool number(double& out) noexcept {
+        if (lit("null")) {
+            out = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+        const char* first = in_.data() + pos_;
+        const char* last = in_.data() + in_.size();
+        auto [ptr, ec] = std::from_chars(first, last, out);
+        if (ec != std::errc{} || !std::isfinite(out)) {
+            return false;
+        }
+        char tmp[kMaxDoubleChars];
+        const auto text = std::to_chars(tmp, tmp + sizeof(tmp), out);
+        if (std::string_view(tmp, text.ptr - tmp) != std::string_view(first, ptr - first)) {
+            return false;
+        }
+        pos_ = static_cast<std::size_t>(ptr - in_.data());
+        return true;
+    }
+
+private:
+    std::string_view in_;
+    std::size_t pos_ = 0;
+};
+
+// Bounds-checked reader over one column (or the block header)
+class ColumnReader {
+public:
+    ColumnReader() = default;
+    explicit ColumnReader(std::span<const std::byte> in) noexcept : in_(in) {}
+
+    bool at_end() const noexcept { return pos_ == in_.size(); }
+
+    bool u8(std::uint8_t& v) noexcept {
+        if (pos_ == in_.size()) return false;
+        v = std::to_integer<std::uint8_t>(in_[pos_++]);
+        return true;
+    }
+
+    bool varint(std::uint64_t& v) noexcept {
+        std::uint64_t acc = 0;
+        for (std::size_t i = 0; i < kMaxVarintBytes; ++i) {
+            std::uint8_t b = 0;
+            if (!u8(b)) return false;
+            if (i == kMaxVarintBytes - 1 && b > 1) return false;  // > 64 bits
+            acc |= static_cast<std::uint64_t>(b & 0x7F) << (7 * i);
+            if ((b & 0x80) == 0) {
+                v = acc;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool f64(double& v) noexcept {
+        if (in_.size() - pos_ < 8) return false;
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= std::to_integer<std::uint64_t>(in_[pos_ + i]) << (8 * i);
+        }
+        pos_ += 8;
+        v = std::bit_cast<double>(bits);
+        return true;
+    }
+
+    bool bytes(std::uint64_t n, std::span<const std::byte>& out) noexcept {
+        if (in_.size() - pos_ < n) return false;
+        out = in_.subspan(pos_, static_cast<std::size_t>(n));
+        pos_ += static_cast<std::size_t>(n);
+        return true;
+    }
+
+    bool str(std::uint64_t n, std::string_view& out) noexcept {
+        std::span<const std::byte> b;
+        if (!bytes(n, b)) return false;
+        out = std::string_view(reinterpret_cast<const char*>(b.data()), b.size());
+        return true;
+    }
+
+private:
+    std::span<const std::byte> in_;
+    std::size_t pos_ = 0;
+};
+
+// Canonical JSON output for the decoder
+class JsonOut {
+public:
+    explicit JsonOut(std::string& out) noexcept : out_(out) { out_.clear(); }
+
+    void raw(std::string_view s) { out_.append(s); }
+
+    void quoted(std::string_view s) {
+        out_.push_back('"');
+        out_.append(s);
+        out_.push_back('"');
+    }
+
+    void integer(std::uint64_t v) {
+        char tmp[24];
+        out_.append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), v).ptr);
+    }
+
+    void number(double v) {
+        if (!std::isfinite(v)) {
+            out_.append("null");
+            return;
+        }
+        char tmp[kMaxDoubleChars];
+        out_.append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), v).ptr);
+    }
+
+private:
+    std::string& out_;
+};
+
+}  // namespace
+
+// ============================================================================
+// ColumnarEncoder Implementation
+// ============================================================================
+
+ColumnarEncoder::ColumnarEncoder(ColumnarConfig config)
+    : config_(config)
+    , seed_((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    , symbols_(std::max<std::size_t>(config.max_symbols, 1))
+    , symbol_index_(symbols_.size()) {
+    config_.max_block_events = std::max<std::size_t>(config_.max_block_events, 1);
+    config_.max_symbols = symbols_.size();
+    scratch_metrics_.reserve(MetricsLimits::kMaxMetrics);
+}
+
+bool ColumnarEncoder::add(std::span<const std::byte> payload) {
+    if (full()) {
+        return false;
+    }
+
+    const std::string_view text(reinterpret_cast<const char*>(payload.data()), payload.size());
+    EventKind kind = EventKind::Raw;
+    if (decode_metrics(text)) {
+        kind = EventKind::Metrics;
+    } else if (decode_log(text)) {
+        kind = EventKind::Log;
+    }
+    if (kind != EventKind::Raw && scratch_strings_ > config_.max_symbols) {
+        kind = EventKind::Raw;
+    }
+    if (kind != EventKind::Raw && symbol_count_ + scratch_strings_ > config_.max_symbols) {
+        return false;
+    }
+
+    put_u8(column(Column::Kind), static_cast<std::uint8_t>(kind));
+    switch (kind) {
+        case EventKind::Metrics: add_metrics(); break;
+        case EventKind::Log:     add_log(); break;
+        case EventKind::Raw:     add_raw(payload); break;
+    }
+    ++events_;
+
+    column_bytes_ = 0;
+    for (const auto& c : columns_) {
+        column_bytes_ += c.size();
+    }
+    return true;
+}
+
+bool ColumnarEncoder::decode_metrics(std::string_view in) {
+    Canonical c(in);
+    scratch_metrics_.clear();
+    scratch_pairs_.clear();
+    scratch_strings_ = 1;
+
+    if (!c.lit("{\"type\":\"metrics\",\"agent_id\":") || !c.str(scratch_agent_) ||
+        !c.lit(",\"seq\":") || !c.integer(scratch_seq_) || scratch_seq_ > UINT32_MAX ||
+        !c.lit(",\"ts\":") || !c.integer(scratch_ts_) || !c.lit(",\"metrics\":[")) {
+        return false;
+    }
+    bool first = true;
+    while (!c.lit("]}")) {
+        if (!first && !c.lit(",")) {
+            return false;
+        }
+        first = false;
+
+        ScratchMetric m;
+        if (!c.lit("{\"n\":") || !c.str(m.name) || !c.lit(",\"v\":") || !c.number(m.value)) {
+            return false;
+        }
+        ++scratch_strings_;
+        if (c.lit(",\"u\":")) {
+            if (!c.str(m.unit) || m.unit.empty()) {
+                return false;
+            }
+            ++scratch_strings_;
+        }
+        m.tag_begin = static_cast<std::uint32_t>(scratch_pairs_.size());
+        if (c.lit(",\"t\":{")) {
+            do {
+                StrPair tag;
+                if (!c.str(tag.key) || !c.lit(":") || !c.str(tag.value)) {
+                    return false;
+                }
+                scratch_pairs_.push_back(tag);
+            } while (c.lit(","));
+            if (!c.lit("}")) {
+                return false;
+            }
+        }
+        m.tag_count = static_cast<std::uint32_t>(scratch_pairs_.size()) - m.tag_begin;
+        scratch_strings_ += 2 * m.tag_count;
+        if (!c.lit("}")) {
+            return false;
+        }
+        scratch_metrics_.push_back(m);
+    }
+    return c.at_end();
+}
+
+bool ColumnarEncoder::decode_log(std::string_view in) {
+    Canonical c(in);
+    scratch_pairs_.clear();
+    scratch_strings_ = 0;
+
+    if (!c.lit("{\"type\":\"log\"")) {
+        return false;
+    }
+    scratch_has_agent_ = c.lit(",\"agent_id\":");
+    if (scratch_has_agent_) {
+        if (!c.str(scratch_agent_) || scratch_agent_.empty()) {
+            return false;
+        }
+        ++scratch_strings_;
+    }
+    std::string_view level;
+    if (!c.lit(",\"ts\":") || !c.integer(scratch_ts_) || !c.lit(",\"level\":") ||
+        !c.str(level)) {
+        return false;
+    }
+    scratch_level_ = kMaxLogLevel + 1;
+    for (std::uint8_t l = 0; l <= kMaxLogLevel; ++l) {
+        if (level == log_level_to_string(static_cast<LogLevel>(l))) {
+            scratch_level_ = l;
+        }
+    }
+    if (scratch_level_ > kMaxLogLevel || !c.lit(",\"msg\":") || !c.str(scratch_msg_)) {
+        return false;
+    }
+    if (c.lit(",\"fields\":{")) {
+        do {
+            StrPair field;
+            if (!c.str(field.key) || !c.lit(":") || !c.str(field.value)) {
+                return false;
+            }
+            scratch_pairs_.push_back(field);
+        } while (c.lit(","));
+        if (!c.lit("}")) {
+            return false;
+        }
+        scratch_strings_ += scratch_pairs_.size();
+    }
+    return c.lit("}") && c.at_end();
+}
+
+void ColumnarEncoder::add_metrics() {
+    put_varint(column(Column::MetricAgent), intern(scratch_agent_));
+    put_varint(column(Column::MetricSeq), zigzag(scratch_seq_, prev_metric_seq_));
+    put_varint(column(Column::MetricTs), zigzag(scratch_ts_, prev_metric_ts_));
+    put_varint(column(Column::MetricCount), scratch_metrics_.size());
+    prev_metric_seq_ = scratch_seq_;
+    prev_metric_ts_ = scratch_ts_;
+
+    for (const auto& m : scratch_metrics_) {
+        put_varint(column(Column::MetricName), intern(m.name));
+        put_varint(column(Column::MetricUnit), m.unit.empty() ? 0 : intern(m.unit) + 1);
+        put_f64(column(Column::MetricValue), m.value);
+        put_varint(column(Column::MetricTagCount), m.tag_count);
+        for (std::uint32_t t = m.tag_begin; t < m.tag_begin + m.tag_count; ++t) {
+            put_varint(column(Column::MetricTagKey), intern(scratch_pairs_[t].key));
+            put_varint(column(Column::MetricTagValue), intern(scratch_pairs_[t].value));
+        }
+    }
+    ++block_metric_rows_;
+    ++metric_rows_;
+}
+
+void ColumnarEncoder::add_log() {
+    put_varint(column(Column::LogAgent), scratch_has_agent_ ? intern(scratch_agent_) + 1 : 0);
+    put_varint(column(Column::LogTs), zigzag(scratch_ts_, prev_log_ts_));
+    put_u8(column(Column::LogLevel), scratch_level_);
+    put_varint(column(Column::LogMsgLen), scratch_msg_.size());
+    put_bytes(column(Column::LogMsgHeap), scratch_msg_);
+    put_varint(column(Column::LogFieldCount), scratch_pairs_.size());
+    prev_log_ts_ = scratch_ts_;
+
+    for (const auto& f : scratch_pairs_) {
+        put_varint(column(Column::LogFieldKey), intern(f.key));
+        put_varint(column(Column::LogFieldLen), f.value.size());
+        put_bytes(column(Column::LogFieldHeap), f.value);
+    }
+    ++block_log_rows_;
+    ++log_rows_;
+}
+
+void ColumnarEncoder::add_raw(std::span<const std::byte> payload) {
+    put_varint(column(Column::RawLen), payload.size());
+    auto& heap = column(Column::RawHeap);
+    heap.insert(heap.end(), payload.begin(), payload.end());
+    ++block_raw_rows_;
+    ++raw_rows_;
+}
+
+std::uint32_t ColumnarEncoder::intern(std::string_view s) {
+    auto& bytes = column(Column::Symbols);
+    const std::uint64_t hash = hash_bytes(seed_, s);
+    const std::size_t slot = symbol_index_.find(symbol_index_.home(hash), [&](std::uint32_t n) {
+        const Symbol& sym = symbols_[n];
+        return sym.hash == hash && sym.length == s.size() &&
+               std::memcmp(bytes.data() + sym.offset, s.data(), s.size()) == 0;
+    });
+    if (symbol_index_[slot] != kNil) {
+        return symbol_index_[slot];
+    }
+    put_varint(bytes, s.size());
+    const auto n = static_cast<std::uint32_t>(symbol_count_++);
+    symbols_[n] = Symbol{.hash = hash,
+                         .offset = static_cast<std::uint32_t>(bytes.size()),
+                         .length = static_cast<std::uint32_t>(s.size())};
+    put_bytes(bytes, s);
+    symbol_index_.set(slot, n);
+    return n;
+}
+
+std::span<const std::byte> ColumnarEncoder::finish() {
+    block_.clear();
+    if (events_ == 0) {
+        return {};
+    }
+
+    body_.clear();
+    put_varint(body_, events_);
+    put_varint(body_, block_metric_rows_);
+    put_varint(body_, block_log_rows_);
+    put_varint(body_, block_raw_rows_);
+    for (const auto& c : columns_) {
+        put_varint(body_, c.size());
+        body_.insert(body_.end(), c.begin(), c.end());
+    }
+
+    std::size_t packed = 0;
+    if (config_.compress) {
+        packed_.resize(lz4_compress_bound(body_.size()));
+        packed = lz4_compress(body_, packed_);
+        // Only worth a flag if it saves more than the raw_len varint
+        if (packed + varint_size(body_.size()) >= body_.size()) {
+            packed = 0;
+        }
+    }
+
+    block_.reserve(kMaxHeaderBytes + body_.size());
+    put_u8(block_, ColumnarFormat::kMagic);
+    put_u8(block_, ColumnarFormat::kVersion);
+    if (packed > 0) {
+        put_u8(block_, ColumnarFormat::kFlagLz4);
+        put_varint(block_, packed);
+        put_varint(block_, body_.size());
+        block_.insert(block_.end(), packed_.begin(), packed_.begin() + static_cast<std::ptrdiff_t>(packed));
+        ++compressed_blocks_;
+    } else {
+        put_u8(block_, 0);
+        put_varint(block_, body_.size());
+        block_.insert(block_.end(), body_.begin(), body_.end());
+    }
+
+    reset_block();
+    return block_;
+}
+
+void ColumnarEncoder::reset_block() noexcept {
+    for (auto& c : columns_) {
+        c.clear();
+    }
+    if (symbol_count_ > 0) {
+        symbol_index_.clear();
+    }
+    symbol_count_ = 0;
+    column_bytes_ = 0;
+    events_ = 0;
+    block_metric_rows_ = 0;
+    block_log_rows_ = 0;
+    block_raw_rows_ = 0;
+    prev_metric_seq_ = 0;
+    prev_metric_ts_ = 0;
+    prev_log_ts_ = 0;
+}
+
+// ============================================================================
+// Block decoder
+// ============================================================================
+
+bool decode_columnar_block(std::span<const std::byte> block, std::vector<std::byte>& scratch,
+                           const std::function<void(std::span<const std::byte>)>& emit) {
+    ColumnReader header(block);
+    std::uint8_t magic = 0;
+    std::uint8_t version = 0;
+    std::uint8_t flags = 0;
+    std::uint64_t body_len = 0;
+    if (!header.u8(magic) || magic != ColumnarFormat::kMagic || !header.u8(version) ||
+        version != ColumnarFormat::kVersion || !header.u8(flags) ||
+        (flags & ~ColumnarFormat::kFlagLz4) != 0 || !header.varint(body_len)) {
+        return false;
+    }
+
+    std::span<const std::byte> body;
+    if ((flags & ColumnarFormat::kFlagLz4) != 0) {
+        std::uint64_t raw_len = 0;
+        std::span<const std::byte> packed;
+        // LZ4 expands at most ~255x; reject sizes no valid packed body has
+        if (!header.varint(raw_len) || !header.bytes(body_len, packed) ||
+            raw_len > packed.size() * 255 + 16) {
+            return false;
+        }
+        scratch.resize(static_cast<std::size_t>(raw_len));
+        if (!lz4_decompress(packed, scratch)) {
+            return false;
+        }
+        body = scratch;
+    } else if (!header.bytes(body_len, body)) {
+        return false;
+    }
+    if (!header.at_end()) {
+        return false;
+    }
+
+    ColumnReader in(body);
+    std::uint64_t events = 0;
+    std::uint64_t rows[3] = {};
+    if (!in.varint(events) || !in.varint(rows[0]) || !in.varint(rows[1]) || !in.varint(rows[2])) {
+        return false;
+    }
+    ColumnReader cols[kColumnCount];
+    for (auto& col : cols) {
+        std::uint64_t len = 0;
+        std::span<const std::byte> bytes;
+        if (!in.varint(len) || !in.bytes(len, bytes)) {
+            return false;
+        }
+        col = ColumnReader(bytes);
+    }
+    if (!in.at_end() || rows[0] + rows[1] + rows[2] != events || rows[0] > events ||
+        rows[1] > events) {
+        return false;
+    }
+    auto col = [&](Column c) -> ColumnReader& { return cols[static_cast<std::size_t>(c)]; };
+
+    std::vector<std::string_view> symbols;
+    while (!col(Column::Symbols).at_end()) {
+        std::uint64_t len = 0;
+        std::string_view s;
+        if (!col(Column::Symbols).varint(len) || !col(Column::Symbols).str(len, s)) {
+            return false;
+        }
+        symbols.push_back(s);
+    }
+    auto symbol = [&](Column c, bool optional, std::string_view& out, bool& present) {
+        std::uint64_t ref = 0;
+        if (!col(c).varint(ref)) return false;
+        present = !optional || ref != 0;
+        if (optional && ref != 0) --ref;
+        if (present && ref >= symbols.size()) return false;
+        out = present ? symbols[static_cast<std::size_t>(ref)] : std::string_view{};
+        return true;
+    };
+
+    std::string event;
+    std::uint64_t prev_seq = 0;
+    std::uint64_t prev_metric_ts = 0;
+    std::uint64_t prev_log_ts = 0;
+    std::uint64_t seen[3] = {};
+    for (std::uint64_t e = 0; e < events; ++e) {
+        std::uint8_t kind = 0;
+        if (!col(Column::Kind).u8(kind) || kind > static_cast<std::uint8_t>(EventKind::Raw) ||
+            ++seen[kind] > rows[kind]) {
+            return false;
+        }
+        JsonOut w(event);
+        bool present = false;
+        std::string_view s;
+
+        if (kind == static_cast<std::uint8_t>(EventKind::Metrics)) {
+            std::uint64_t seq = 0;
+            std::uint64_t ts = 0;
+            std::uint64_t count = 0;
+            if (!symbol(Column::MetricAgent, false, s, present) ||
+                !col(Column::MetricSeq).varint(seq) || !col(Column::MetricTs).varint(ts) ||
+                !col(Column::MetricCount).varint(count)) {
+                return false;
+            }
+            prev_seq = unzigzag(seq, prev_seq);
+            prev_metric_ts = unzigzag(ts, prev_metric_ts);
+            w.raw("{\"type\":\"metrics\",\"agent_id\":");
+            w.quoted(s);
+            w.raw(",\"seq\":");
+            w.integer(prev_seq);
+            w.raw(",\"ts\":");
+            w.integer(prev_metric_ts);
+            w.raw(",\"metrics\":[");
+            for (std::uint64_t i = 0; i < count; ++i) {
+                double value = 0;
+                std::uint64_t tags = 0;
+                if (!symbol(Column::MetricName, false, s, present)) return false;
+                w.raw(i == 0 ? "{\"n\":" : ",{\"n\":");
+                w.quoted(s);
+                if (!symbol(Column::MetricUnit, true, s, present) ||
+                    !col(Column::MetricValue).f64(value) ||
+                    !col(Column::MetricTagCount).varint(tags)) {
+                    return false;
+                }
+                w.raw(",\"v\":");
+                w.number(value);
+                if (present) {
+                    w.raw(",\"u\":");
+                    w.quoted(s);
+                }
+                for (std::uint64_t t = 0; t < tags; ++t) {
+                    w.raw(t == 0 ? ",\"t\":{" : ",");
+                    if (!symbol(Column::MetricTagKey, false, s, present)) return false;
+                    w.quoted(s);
+                    w.raw(":");
+                    if (!symbol(Column::MetricTagValue, false, s, present)) return false;
+                    w.quoted(s);
+                }
+                w.raw(tags > 0 ? "}}" : "}");
+            }
+            w.raw("]}");
+        } else if (kind == static_cast<std::uint8_t>(EventKind::Log)) {
+            std::uint64_t ts = 0;
+            std::uint8_t level = 0;
+            std::uint64_t len = 0;
+            std::uint64_t fields = 0;
+            if (!symbol(Column::LogAgent, true, s, present) || !col(Column::LogTs).varint(ts) ||
+                !col(Column::LogLevel).u8(level) || level > kMaxLogLevel) {
+                return false;
+            }
+            prev_log_ts = unzigzag(ts, prev_log_ts);
+            w.raw("{\"type\":\"log\"");
+            if (present) {
+                w.raw(",\"agent_id\":");
+                w.quoted(s);
+            }
+            w.raw(",\"ts\":");
+            w.integer(prev_log_ts);
+            w.raw(",\"level\":");
+            w.quoted(log_level_to_string(static_cast<LogLevel>(level)));
+            if (!col(Column::LogMsgLen).varint(len) || !col(Column::LogMsgHeap).str(len, s) ||
+                !col(Column::LogFieldCount).varint(fields)) {
+                return false;
+            }
+            w.raw(",\"msg\":");
+            w.quoted(s);
+            for (std::uint64_t f = 0; f < fields; ++f) {
+                w.raw(f == 0 ? ",\"fields\":{" : ",");
+                if (!symbol(Column::LogFieldKey, false, s, present)) return false;
+                w.quoted(s);
+                w.raw(":");
+                if (!col(Column::LogFieldLen).varint(len) ||
+                    !col(Column::LogFieldHeap).str(len, s)) {
+                    return false;
+                }
+                w.quoted(s);
+            }
+            w.raw(fields > 0 ? "}}" : "}");
+        } else {
+            std::uint64_t len = 0;
+            if (!col(Column::RawLen).varint(len) || !col(Column::RawHeap).str(len, s)) {
+                return false;
+            }
+            w.raw(s);
+        }
+        emit(std::as_bytes(std::span(event)));
+    }
+
+    // Every column fully consumed
+    return std::all_of(std::begin(cols), std::end(cols),
+                       [](const ColumnReader& c) { return c.at_end(); });
+}
+
+// ============================================================================
+// LZ4 block format
+// ============================================================================
+
+namespace {
+
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kLastLiterals = 5;     // the last 5 bytes are always literals
+constexpr std::size_t kMatchFindLimit = 12;  // no match starts in the last 12 bytes
+constexpr std::size_t kMaxOffset = 65535;
+constexpr unsigned kHashLog = 12;
+
+std::uint32_t read32(const std::byte* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint32_t hash4(std::uint32_t v) noexcept {
+    return (v * 2654435761u) >> (32 - kHashLog);
+}
+
+// Length continuation bytes (255, 255, ..., rest) after a 15 nibble
+bool put_length(std::byte*& op, const std::byte* end, std::size_t len) noexcept {
+    while (len >= 255) {
+        if (op == end) return false;
+        *op++ = std::byte{255};
+        len -= 255;
+    }
+    if (op == end) return false;
+    *op++ = std::byte(static_cast<std::uint8_t>(len));
+    return true;
+}
+
+bool put_sequence(std::byte*& op, const std::byte* end, const std::byte* literals,
+                  std::size_t literal_len, std::size_t offset, std::size_t match_len) noexcept {
+    if (op == end) return false;
+    std::byte* token = op++;
+    const std::size_t lit_code = std::min<std::size_t>(literal_len, 15);
+    if (lit_code == 15 && !put_length(op, end, literal_len - 15)) return false;
+    if (static_cast<std::size_t>(end - op) < literal_len) return false;
+    std::memcpy(op, literals, literal_len);
+    op += literal_len;
+    std::size_t match_code = 0;
+    if (match_len > 0) {
+        if (end - op < 2) return false;
+        *op++ = std::byte(static_cast<std::uint8_t>(offset));
+        *op++ = std::byte(static_cast<std::uint8_t>(offset >> 8));
+        match_code = std::min<std::size_t>(match_len - kMinMatch, 15);
+        if (match_code == 15 && !put_length(op, end, match_len - kMinMatch - 15)) return false;
+    }
+    *token = std::byte(static_cast<std::uint8_t>((lit_code << 4) | match_code));
+    return true;
+}
+
+bool get_length(const std::byte*& ip, const std::byte* end, std::size_t& len) noexcept {
+    std::uint8_t b = 0;
+    do {
+        if (ip == end) return false;
+        b = std::to_integer<std::uint8_t>(*ip++);
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+}  // namespace
+
+std::size_t lz4_compress(std::span<const std::byte> in, std::span<std::byte> out) noexcept {
+    if (in.empty()) {
+        return 0;
+    }
+    const std::byte* base = in.data();
+    const std::size_t n = in.size();
+    std::byte* op = out.data();
+    const std::byte* oend = out.data() + out.size();
+
+    std::array<std::uint32_t, std::size_t{1} << kHashLog> table{};  // position + 1, 0 = empty
+    std::size_t anchor = 0;
+    if (n > kMatchFindLimit) {
+        const std::size_t match_limit = n - kLastLiterals;
+        std::size_t ip = 0;
+        while (ip + kMatchFindLimit <= n) {
+            const std::uint32_t seq = read32(base + ip);
+            const std::uint32_t h = hash4(seq);
+            const std::size_t candidate = table[h];
+            table[h] = static_cast<std::uint32_t>(ip + 1);
+            if (candidate == 0 || ip - (candidate - 1) > kMaxOffset ||
+                read32(base + candidate - 1) != seq) {
+                ++ip;
+                continue;
+            }
+            const std::size_t match = candidate - 1;
+            std::size_t len = kMinMatch;
+            while (ip + len < match_limit && base[ip + len] == base[match + len]) {
+                ++len;
+            }
+            if (!put_sequence(op, oend, base + anchor, ip - anchor, ip - match, len)) {
+                return 0;
+            }
+            ip += len;
+            anchor = ip;
+            // Index a position inside the match, as the reference does
+            if (ip + kMatchFindLimit <= n) {
+                table[hash4(read32(base + ip - 2))] = static_cast<std::uint32_t>(ip - 2 + 1);
+            }
+        }
+    }
+    if (!put_sequence(op, oend, base + anchor, n - anchor, 0, 0)) {
+        return 0;
+    }
+    return static_cast<std::size_t>(op - out.data());
+}
+
+bool lz4_decompress(std::span<const std::byte> in, std::span<std::byte> out) noexcept {
+    const std::byte* ip = in.data();
+    const std::byte* iend = in.data() + in.size();
+    std::byte* op = out.data();
+    std::byte* const oend = out.data() + out.size();
+
+    while (true) {
+        if (ip == iend) return false;
+        const auto token = std::to_integer<std::uint8_t>(*ip++);
+
+        std::size_t literal_len = token >> 4;
+        if (literal_len == 15 && !get_length(ip, iend, literal_len)) return false;
+        if (static_cast<std::size_t>(iend - ip) < literal_len ||
+            static_cast<std::size_t>(oend - op) < literal_len) {
+            return false;
+        }
+        std::memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+        if (ip == iend) {
+            break;  // last sequence: literals only
+        }
+
+        if (iend - ip < 2) return false;
+        const std::size_t offset = std::to_integer<std::size_t>(ip[0]) |
+                                   (std::to_integer<std::size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - out.data())) return false;
+
+        std::size_t match_len = token & 0x0F;
+        if (match_len == 15 && !get_length(ip, iend, match_len)) return false;
+        match_len += kMinMatch;
+        if (static_cast<std::size_t>(oend - op) < match_len) return false;
+        // Byte by byte: the match may overlap the bytes it produces
+        const std::byte* match = op - offset;
+        for (std::size_t i = 0; i < match_len; ++i) {
+            op[i] = match[i];
+        }
+        op += match_len;
+    }
+    return op == oend;
+}
+
+// ============================================================================
+// ColumnarSink Implementation
+// ============================================================================
+
+ColumnarSink::ColumnarSink(std::unique_ptr<Sink> inner, ColumnarConfig config)
+    : inner_(std::move(inner))
+    , encoder_(config) {}
+
+ColumnarSink::~ColumnarSink() {
+    flush();
+}
+
+bool ColumnarSink::write(std::span<const std::byte> payload) noexcept {
+    return write_batch(std::span<const std::span<const std::byte>>(&payload, 1)) == 1;
+}
+
+std::size_t ColumnarSink::write_batch(
+    std::span<const std::span<const std::byte>> payloads) noexcept {
+    for (const auto& payload : payloads) {
+        if (!encoder_.add(payload)) {
+            ship();
+            (void)encoder_.add(payload);  // an empty block takes any payload
+        }
+        if (encoder_.events() == 1) {
+            oldest_ = Clock::now();
+        }
+        bytes_in_ += payload.size();
+    }
+
+    if (encoder_.full() ||
+        (!encoder_.empty() && Clock::now() - oldest_ >= encoder_.config().max_delay)) {
+        ship();
+    }
+    return payloads.size();
+}
+
+void ColumnarSink::flush() noexcept {
+    ship();
+    inner_->flush();
+}
+
+void ColumnarSink::ship() noexcept {
+    const std::size_t events = encoder_.events();
+    const auto block = encoder_.finish();
+    if (block.empty()) {
+        return;
+    }
+    bytes_out_ += block.size();
+    if (inner_->write(block)) {
+        ++blocks_written_;
+    } else {
+        dropped_events_ += events;
+    }
+}
+
+}  // namespace gateway
@@ -0,0 +1,96 @@
+#include "gateway/event_loop.hpp"
+
+#include <algorithm>
+
+namespace gateway {
+
+using std::chrono::microseconds;
+
+EventLoop::EventLoop(RecvLoop& recv, EventLoopConfig config, Clock clock)
+    : recv_(recv)
+    , config_(config)
+    , clock_(std::move(clock)) {
+    config_.spin_window = std::max(config_.spin_window, microseconds(0));
+    config_.max_block = std::max(config_.max_block, microseconds(0));
+    // Start outside the spin window: an idle loop blocks from the first call
+    last_data_ = clock_() - config_.spin_window - microseconds(1);
+}
+
+bool EventLoop::add_timer(microseconds interval, TimerHandler handler) {
+    if (interval <= microseconds(0) || timer_count_ == kMaxTimers) {
+        return false;
+    }
+    Timer& timer = timers_[timer_count_++];
+    timer.interval = interval;
+    timer.next = clock_() + interval;
+    timer.handler = std::move(handler);
+    return true;
+}
+
+void EventLoop::fire_timers(std::chrono::steady_clock::time_point now) {
+    for (std::size_t i = 0; i < timer_count_; ++i) {
+        Timer& timer = timers_[i];
+        if (now < timer.next) {
+            continue;
+        }
+        timer.handler();
+        ++metrics_.timer_fires;
+        timer.next += timer.interval;
+        if (timer.next <= now) {
+            timer.next = now + timer.interval;  // fell behind: skip missed periods
+        }
+    }
+}
+
+microseconds EventLoop::wait_at(std::chrono::steady_clock::time_point now) const {
+    if (pending_ || now - last_data_ < config_.spin_window) {
+        return microseconds(0);
+    }
+    microseconds wait = config_.max_block;
+    for (std::size_t i = 0; i < timer_count_; ++i) {
+        // Round up so the wake-up is never before the timer is due
+        const auto until = std::chrono::ceil<microseconds>(timers_[i].next - now);
+        wait = std::min(wait, std::max(microseconds(0), until));
+    }
+    return wait;
+}
+
+microseconds EventLoop::next_wait() const {
+    return wait_at(clock_());
+}
+
+std::size_t EventLoop::run_once() {
+    const auto now = clock_();
+    fire_timers(now);
+
+    const microseconds wait = wait_at(now);
+    if (wait > microseconds(0)) {
+        ++metrics_.waits;
+    }
+    auto batch = recv_.recv_batch(wait);
+    if (!batch.empty()) {
+        last_data_ = clock_();
+        pending_ = false;
+        ++metrics_.batches;
+        if (on_batch_) {
+            on_batch_(batch);
+        }
+        return batch.size();
+    }
+
+    if (wait == microseconds(0)) {
+        ++metrics_.polls;
+    } else {
+        ++metrics_.idle_wakeups;
+    }
+    pending_ = on_idle_ ? on_idle_() : false;
+    return 0;
+}
+
+void EventLoop::run(const std::atomic<bool>& running) {
+    while (running.load(std::memory_order_relaxed)) {
+        (void)run_once();
+    }
+}
+
+}  // namespace gateway
@@ -1,46 +1,137 @@
 #include "gateway/forwarder.hpp"
 
+#include "gateway/topology.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
 namespace gateway {
 
 // ============================================================================
 // AgentQuotaTracker Implementation
 // ============================================================================
 
-AgentQuotaTracker::AgentQuotaTracker(std::size_t max_per_agent) noexcept
-    : max_per_agent_(max_per_agent) {}
+AgentQuotaTracker::AgentQuotaTracker(std::size_t max_per_agent, std::size_t max_agents)
+    : seed_((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    , entries_(std::max<std::size_t>(max_agents, 1))
+    , free_handles_(entries_.size())
+    , index_(entries_.size())
+    , max_per_agent_(max_per_agent) {
+    // Hand out low handles first (stack top is the end of the array)
+    for (std::size_t i = 0; i < free_handles_.size(); ++i) {
+        free_handles_[i] = static_cast<AgentHandle>(free_handles_.size() - 1 - i);
+    }
+}
+
+std::uint32_t AgentQuotaTracker::hash_id(std::string_view agent_id) const noexcept {
+    return static_cast<std::uint32_t>(hash_bytes(seed_, agent_id));
+}
+
+std::size_t AgentQuotaTracker::find_slot(std::string_view agent_id,
+                                         std::uint32_t hash) const noexcept {
+    return index_.find(index_.home(hash), [&](std::uint32_t n) {
+        const Entry& e = entries_[n];
+        return e.hash == hash && e.len == agent_id.size() &&
+               std::memcmp(e.id, agent_id.data(), agent_id.size()) == 0;
+    });
+}
+
+ReserveResult AgentQuotaTracker::try_reserve(std::string_view agent_id,
+                                             AgentHandle& handle) noexcept {
+    if (agent_id.size() > AgentIdRules::kMaxLength) {
+        ++table_full_rejections_;
+        return ReserveResult::TableFull;
+    }
+
+    const std::uint32_t hash = hash_id(agent_id);
+    const std::size_t slot = find_slot(agent_id, hash);
 
-bool AgentQuotaTracker::try_reserve(const std::string& agent_id) noexcept {
-    auto& count = in_flight_[agent_id];  // Inserts 0 if new
-    if (count >= max_per_agent_) {
+    if (index_[slot] != kEmptySlot) {
+        Entry& e = entries_[index_[slot]];
+        if (e.count >= max_per_agent_) {
+            ++quota_rejections_;
+            return ReserveResult::QuotaExceeded;  // Reject: agent over quota
+        }
+        ++e.count;
+        ++total_in_flight_;
+        handle = index_[slot];
+        return ReserveResult::Ok;
+    }
+
+    // New agent
+    if (max_per_agent_ == 0) {
         ++quota_rejections_;
-        return false;  // Reject: agent over quota
+        return ReserveResult::QuotaExceeded;
+    }
+    if (free_handles_.empty()) {
+        ++table_full_rejections_;
+        return ReserveResult::TableFull;
     }
-    ++count;
+    handle = free_handles_.back();
+    free_handles_.pop_back();
+
+    Entry& e = entries_[handle];
+    e.hash = hash;
+    e.count = 1;
+    e.len = static_cast<std::uint8_t>(agent_id.size());
+    std::memcpy(e.id, agent_id.data(), agent_id.size());
+    index_.set(slot, handle);
     ++total_in_flight_;
-    return true;
+    return ReserveResult::Ok;
 }
 
-void AgentQuotaTracker::release(const std::string& agent_id) noexcept {
-    auto it = in_flight_.find(agent_id);
-    if (it != in_flight_.end()) {
-        if (it->second > 0) {
-            --it->second;
-            --total_in_flight_;
-        }
-        // Prune entry if count reaches 0 (keeps map bounded)
-        if (it->second == 0) {
-            in_flight_.erase(it);
-        }
+bool AgentQuotaTracker::try_reserve(std::string_view agent_id) noexcept {
+    AgentHandle handle = kInvalidAgentHandle;
+    return try_reserve(agent_id, handle) == ReserveResult::Ok;
+}
+
+void AgentQuotaTracker::release(AgentHandle handle) noexcept {
+    if (handle >= entries_.size()) {
+        return;
+    }
+    Entry& e = entries_[handle];
+    if (e.count == 0) {
+        return;  // Not in flight (double release): ignore
+    }
+    --e.count;
+    --total_in_flight_;
+    // Prune entry if count reaches 0 (keeps table bounded)
+    if (e.count == 0) {
+        remove(handle);
+    }
+}
+
+void AgentQuotaTracker::release(std::string_view agent_id) noexcept {
+    if (agent_id.size() > AgentIdRules::kMaxLength) {
+        return;
+    }
+    const std::size_t slot = find_slot(agent_id, hash_id(agent_id));
+    if (index_[slot] != kEmptySlot) {
+        release(index_[slot]);
     }
 }
 
-std::size_t AgentQuotaTracker::in_flight_count(const std::string& agent_id) const noexcept {
-    auto it = in_flight_.find(agent_id);
-    return it != in_flight_.end() ? it->second : 0;
+void AgentQuotaTracker::remove(AgentHandle handle) noexcept {
+    index_.erase(index_.slot_of(index_.home(entries_[handle].hash), handle),
+                 [this](std::uint32_t n) { return index_.home(entries_[n].hash); });
+    free_handles_.push_back(handle);
+}
+
+std::size_t AgentQuotaTracker::in_flight_count(std::string_view agent_id) const noexcept {
+    if (agent_id.size() > AgentIdRules::kMaxLength) {
+        return 0;
+    }
+    const std::size_t slot = find_slot(agent_id, hash_id(agent_id));
+    return index_[slot] != kEmptySlot ? entries_[index_[slot]].count : 0;
+}
+
+std::size_t AgentQuotaTracker::in_flight_count(AgentHandle handle) const noexcept {
+    return handle < entries_.size() ? entries_[handle].count : 0;
 }
 
 std::size_t AgentQuotaTracker::tracked_agents() const noexcept {
-    return in_flight_.size();
+    return entries_.size() - free_handles_.size();
 }
 
 std::size_t AgentQuotaTracker::total_in_flight() const noexcept {
@@ -51,55 +142,234 @@ std::size_t AgentQuotaTracker::total_in_flight() const noexcept {
 // BoundedForwarder Implementation
 // ============================================================================
 
+namespace {
+
+// Upper bound on ForwarderConfig::sink_batch_size (sizes the scratch
+// buffers and the release ring headroom)
+constexpr std::size_t kMaxSinkBatch = 1024;
+
+std::size_t sink_batch_size(const ForwarderConfig& config) noexcept {
+    return std::clamp<std::size_t>(config.sink_batch_size, 1, kMaxSinkBatch);
+}
+
+// Bound on queued events: the sum of the lane capacities with lanes,
+// else max_queue_depth
+std::size_t queue_bound(const ForwarderConfig& config) noexcept {
+    if (config.lanes == LanePolicy::Single) {
+        return config.max_queue_depth;
+    }
+    std::size_t total = 0;
+    for (std::size_t capacity : config.lane_capacity) {
+        total += capacity;
+    }
+    return total;
+}
+
+// Release ring capacity: releases not yet applied by the producer never
+// exceed the events queued at its last apply plus one in-flight batch
+std::size_t release_ring_size(const ForwarderConfig& config) noexcept {
+    return round_up_pow2(queue_bound(config) + sink_batch_size(config));
+}
+
+// Upper bound on events holding a quota slot at once, and so on distinct
+// agents in the tracker: queued events, the one being reserved before the
+// queue-full check, plus (async) one batch being written and releases not
+// yet applied
+std::size_t max_reserved_events(const ForwarderConfig& config) noexcept {
+    const std::size_t inline_bound = queue_bound(config) + 1;
+    if (!config.async_sink) {
+        return inline_bound;
+    }
+    return inline_bound + sink_batch_size(config) + release_ring_size(config);
+}
+
+// Payload slots: events not yet handed back once the producer has applied
+// pending releases (queued, plus one batch held by the sink thread in
+// async mode), plus the payload_buffer() slot. Releases pushed after that
+// apply belong to events already counted, so this bound is exact.
+std::size_t payload_slot_count(const ForwarderConfig& config) noexcept {
+    const std::size_t in_flight = queue_bound(config) +
+                                  (config.async_sink ? sink_batch_size(config) : 0);
+    return in_flight + 1;
+}
+
+}  // namespace
+
 BoundedForwarder::BoundedForwarder(ForwarderConfig config, std::unique_ptr<Sink> sink)
-    : config_(config)
-    , quota_tracker_(config.max_per_agent)
-    , queue_(config.max_queue_depth)
-    , sink_(std::move(sink)) {}
+    : config_(std::move(config))
+    , quota_tracker_(config_.max_per_agent, max_reserved_events(config_))
+    , slab_(payload_slot_count(config_), config_.max_payload_bytes)
+    , latency_sampler_(config_.latency_sample_shift)
+    , timed_(config_.queue_latency != nullptr || config_.sink_write_latency != nullptr)
+    , sink_(std::move(sink)) {
+    const bool drr = config_.scheduler == SchedulerMode::DeficitRoundRobin;
+    if (config_.lanes == LanePolicy::Single) {
+        lanes_[0].capacity = config_.max_queue_depth;
+    } else {
+        lane_count_ = kLaneCount;
+        for (std::size_t i = 0; i < kLaneCount; ++i) {
+            lanes_[i].capacity = config_.lane_capacity[i];
+            lanes_[i].weight = std::max<std::uint32_t>(config_.lane_weight[i], 1);
+        }
+        // First pop hands the turn to lane 0
+        turn_lane_ = lane_count_ - 1;
+    }
+    sink_schedules_ = config_.async_sink && (drr || lane_count_ > 1);
+
+    // Plain async FIFO passes events straight through the ring, with no
+    // lane queue behind it
+    const bool lane_queues = !config_.async_sink || sink_schedules_;
+    if (lane_queues && drr) {
+        // A quantum of at least one payload slot serves an event on every
+        // visit, which keeps dequeue O(1)
+        const std::size_t quantum = std::clamp<std::size_t>(
+            std::max(config_.drr_quantum, config_.max_payload_bytes), 1, UINT32_MAX);
+        for (std::size_t i = 0; i < lane_count_; ++i) {
+            lanes_[i].drr = std::make_unique<DrrQueue<QueuedEvent>>(
+                lanes_[i].capacity, quota_tracker_.max_agents(),
+                static_cast<std::uint32_t>(quantum));
+        }
+        weights_ = config_.agent_weights;
+        std::sort(weights_.begin(), weights_.end(),
+                  [](const AgentWeight& a, const AgentWeight& b) { return a.agent_id < b.agent_id; });
+        agent_weights_.assign(quota_tracker_.max_agents(), 1);
+    } else if (lane_queues) {
+        for (std::size_t i = 0; i < lane_count_; ++i) {
+            lanes_[i].fifo = std::make_unique<BoundedQueue<QueuedEvent>>(lanes_[i].capacity);
+        }
+    }
+
+    if (!config_.async_sink) {
+        return;
+    }
+    config_.sink_batch_size = sink_batch_size(config_);
+
+    ring_ = std::make_unique<SpscRing<QueuedEvent>>(queue_bound(config_));
+    releases_ = std::make_unique<SpscRing<Completion>>(release_ring_size(config_));
+    batch_.resize(config_.sink_batch_size);
+    batch_payloads_.resize(config_.sink_batch_size);
+    sink_thread_ = std::thread([this] { sink_thread_main(); });
+}
+
+BoundedForwarder::~BoundedForwarder() {
+    stop();
+}
 
 ForwardResult BoundedForwarder::try_forward(QueuedEvent event) noexcept {
-    // Capture agent_id before any move (needed for quota release on failure)
-    const std::string agent_id = event.agent_id;
+    if (ring_) {
+        apply_pending_releases();
+    }
 
-    // Step 1: Check agent quota (fairness)
-    if (!quota_tracker_.try_reserve(agent_id)) {
-        ++dropped_quota_;
-        return ForwardResult::DroppedAgentQuotaExceeded;
+    // Step 1: Check agent quota (fairness); interns the id
+    AgentHandle agent = kInvalidAgentHandle;
+    switch (quota_tracker_.try_reserve(event.agent_id, agent)) {
+        case ReserveResult::Ok:
+            break;
+        case ReserveResult::QuotaExceeded:
+            add(dropped_quota_, 1);
+            return ForwardResult::DroppedAgentQuotaExceeded;
+        case ReserveResult::TableFull:
+            add(dropped_agent_table_, 1);
+            return ForwardResult::DroppedAgentTableFull;
+    }
+    if (!weights_.empty() && quota_tracker_.in_flight_count(agent) == 1) {
+        // Newly interned: look its DRR weight up once, by handle afterwards
+        agent_weights_[agent] = weight_for(event.agent_id);
     }
+    event.agent = agent;
+    event.agent_id = {};  // borrowed view must not outlive this call
 
-    // Step 2: Try to enqueue (backlog bound)
-    if (queue_.try_push(std::move(event)) == PushResult::Dropped) {
+    // Step 2: Check queue (or lane) capacity (backlog bound). Checked ahead
+    // of the push so a full queue never takes payload storage; this thread
+    // is the only producer, so the push below cannot then fail.
+    const std::size_t lane = lane_index(event);
+    if (lane_full(lane)) {
         // Must release the quota we just reserved since enqueue failed
-        quota_tracker_.release(agent_id);
-        ++dropped_queue_full_;
+        quota_tracker_.release(agent);
+        add(dropped_queue_full_, 1);
+        add(dropped_lane_full_[static_cast<std::size_t>(lane_for(event.type, event.level))], 1);
         return ForwardResult::DroppedQueueFull;
     }
 
+    // Step 3: Place the payload in a slot: the payload_buffer() slot if
+    // there is one (in place when the payload was written there), else a
+    // fresh one
+    if (event.payload.size() > slab_.buffer_bytes()) {
+        quota_tracker_.release(agent);
+        add(dropped_payload_too_large_, 1);
+        return ForwardResult::DroppedPayloadTooLarge;
+    }
+    BufferIndex slot = reserved_slot_ != kNoBuffer ? reserved_slot_ : slab_.acquire_index();
+    if (slot == kNoBuffer) {
+        quota_tracker_.release(agent);
+        add(dropped_payload_storage_, 1);
+        return ForwardResult::DroppedPayloadStorageFull;
+    }
+    reserved_slot_ = kNoBuffer;
+
+    const std::span<std::byte> dst = slab_.buffer(slot);
+    if (!event.payload.empty() && event.payload.data() != dst.data()) {
+        std::memmove(dst.data(), event.payload.data(), event.payload.size());
+    }
+    event.payload = dst.first(event.payload.size());
+    event.payload_slot = slot;
+    event.enqueued_ns = timed_ && latency_sampler_.next() ? monotonic_ns() : 0;
+
+    // Step 4: Enqueue
+    const PushResult pushed = ring_ ? ring_->try_push(std::move(event)) : push_lane(event, lane);
+    if (pushed == PushResult::Dropped) {
+        // Unreachable (checked above)
+        complete(agent, slot);
+        add(dropped_queue_full_, 1);
+        return ForwardResult::DroppedQueueFull;
+    }
+
+    if (ring_) {
+        ++pushed_;
+        ++lanes_[lane].pushed;
+        wake_sink();
+    }
     return ForwardResult::Queued;
 }
 
 bool BoundedForwarder::drain_one() noexcept {
-    auto event_opt = queue_.try_pop();
-    if (!event_opt) {
-        return false;  // Queue was empty
+    if (ring_) {
+        apply_pending_releases();
+        return false;  // Sink thread owns draining
     }
 
-    QueuedEvent& event = *event_opt;
-
-    // Release agent quota (must happen regardless of sink success)
-    quota_tracker_.release(event.agent_id);
+    QueuedEvent event;
+    if (!pop_lane(event)) {
+        return false;  // Queue was empty
+    }
 
-    // Write to sink
-    if (sink_->write(std::span<const std::byte>(event.payload))) {
-        ++total_forwarded_;
+    // Write to sink, then release agent quota (regardless of sink
+    // success) and the payload slot
+    const std::uint64_t start = event.enqueued_ns != 0 ? monotonic_ns() : 0;
+    if (sink_->write(event.payload)) {
+        add(total_forwarded_, 1);
     } else {
-        ++sink_failures_;
+        add(sink_failures_, 1);
+    }
+    if (start != 0) {
+        record_latency(event.enqueued_ns, start, monotonic_ns());
     }
+    complete(event.agent, event.payload_slot);
 
     return true;
 }
 
 std::size_t BoundedForwarder::drain_all() noexcept {
+    if (ring_) {
+        // Wait for the sink thread to catch up with everything pushed so far
+        std::uint64_t done = processed_.load(std::memory_order_acquire);
+        while (done < pushed_) {
+            processed_.wait(done, std::memory_order_acquire);
+            done = processed_.load(std::memory_order_acquire);
+        }
+        return apply_pending_releases();
+    }
+
     std::size_t count = 0;
     while (drain_one()) {
         ++count;
@@ -107,20 +377,282 @@ std::size_t BoundedForwarder::drain_all() noexcept {
     return count;
 }
 
+std::size_t BoundedForwarder::apply_pending_releases() noexcept {
+    if (!releases_) {
+        return 0;
+    }
+    std::size_t count = 0;
+    Completion done[64];
+    std::size_t n;
+    while ((n = releases_->try_pop_n(done)) > 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            complete(done[i].agent, done[i].payload_slot);
+        }
+        count += n;
+    }
+    return count;
+}
+
+void BoundedForwarder::complete(AgentHandle agent, BufferIndex payload_slot) noexcept {
+    quota_tracker_.release(agent);
+    slab_.release(payload_slot);
+}
+
+void BoundedForwarder::record_latency(std::uint64_t enqueued_ns, std::uint64_t write_start_ns,
+                                      std::uint64_t write_end_ns) const noexcept {
+    // A zero stamp skips that histogram (see the sink thread's batch path)
+    if (config_.queue_latency && enqueued_ns != 0) {
+        config_.queue_latency->record(write_start_ns - enqueued_ns);
+    }
+    if (config_.sink_write_latency && write_end_ns != 0) {
+        config_.sink_write_latency->record(write_end_ns - write_start_ns);
+    }
+}
+
+std::size_t BoundedForwarder::lane_index(const QueuedEvent& event) const noexcept {
+    return lane_count_ == 1 ? 0 : static_cast<std::size_t>(lane_for(event.type, event.level));
+}
+
+bool BoundedForwarder::lane_full(std::size_t lane) const noexcept {
+    const LaneQueue& q = lanes_[lane];
+    if (sink_schedules_) {
+        // The backlog sits in the sink thread's lane queues: count events
+        // not yet written
+        return q.pushed - q.written.load(std::memory_order_acquire) >= q.capacity;
+    }
+    if (ring_) {
+        // The ring's capacity is rounded up to a power of two; enforce the
+        // configured depth exactly. size() can only overestimate here.
+        return ring_->size() >= q.capacity;
+    }
+    return q.drr ? q.drr->full() : q.fifo->full();
+}
+
+std::uint32_t BoundedForwarder::weight_for(std::string_view agent_id) const noexcept {
+    auto it = std::lower_bound(weights_.begin(), weights_.end(), agent_id,
+                               [](const AgentWeight& w, std::string_view id) { return w.agent_id < id; });
+    return it != weights_.end() && it->agent_id == agent_id ? it->weight : 1;
+}
+
+PushResult BoundedForwarder::push_lane(QueuedEvent& event, std::size_t lane) noexcept {
+    LaneQueue& q = lanes_[lane];
+    if (!q.drr) {
+        return q.fifo->try_push(std::move(event));
+    }
+    // Cost is payload bytes, so agents share sink bandwidth, not event counts
+    const AgentHandle agent = event.agent;
+    const auto cost = static_cast<std::uint32_t>(std::max<std::size_t>(event.payload.size(), 1));
+    return q.drr->try_push(std::move(event), agent, cost, agent_weights_[agent]);
+}
+
+bool BoundedForwarder::pop_lane(QueuedEvent& out) noexcept {
+    const auto pop = [&](LaneQueue& q) { return q.drr ? q.drr->try_pop(out) : q.fifo->try_pop(out); };
+
+    if (config_.lanes != LanePolicy::Weighted) {
+        // Strict priority (or the single queue): lowest non-empty lane
+        for (std::size_t i = 0; i < lane_count_; ++i) {
+            if (pop(lanes_[i])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Weighted: the lane holding the turn serves up to its weight, then
+    // the turn moves on; empty lanes pass it straight along
+    for (std::size_t tries = 0; tries <= lane_count_; ++tries) {
+        if (turn_left_ > 0 && pop(lanes_[turn_lane_])) {
+            --turn_left_;
+            return true;
+        }
+        turn_lane_ = (turn_lane_ + 1) % lane_count_;
+        turn_left_ = lanes_[turn_lane_].weight;
+    }
+    return false;
+}
+
+bool BoundedForwarder::lanes_empty() const noexcept {
+    for (std::size_t i = 0; i < lane_count_; ++i) {
+        const LaneQueue& q = lanes_[i];
+        if (q.drr ? !q.drr->empty() : !q.fifo->empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::span<std::byte> BoundedForwarder::payload_buffer() noexcept {
+    if (reserved_slot_ == kNoBuffer) {
+        if (ring_) {
+            apply_pending_releases();
+        }
+        reserved_slot_ = slab_.acquire_index();
+        if (reserved_slot_ == kNoBuffer) {
+            return {};
+        }
+    }
+    return slab_.buffer(reserved_slot_);
+}
+
+void BoundedForwarder::set_max_per_agent(std::size_t max_per_agent) noexcept {
+    // The tracker is producer-owned in both modes, so no sink-thread sync
+    config_.max_per_agent = max_per_agent;
+    quota_tracker_.set_max_per_agent(max_per_agent);
+}
+
+void BoundedForwarder::stop() noexcept {
+    if (!sink_thread_.joinable()) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_release);
+    wake_seq_.fetch_add(1, std::memory_order_release);
+    wake_seq_.notify_one();
+    sink_thread_.join();
+    apply_pending_releases();
+}
+
+void BoundedForwarder::wake_sink() noexcept {
+    // Pairs with the fence in sink_thread_main(): either the sink sees the
+    // pushed event on its re-check, or we see it asleep and wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sink_sleeping_.load(std::memory_order_relaxed)) {
+        wake_seq_.fetch_add(1, std::memory_order_release);
+        wake_seq_.notify_one();
+    }
+}
+
+void BoundedForwarder::sink_thread_main() noexcept {
+    // Best effort: on refusal the thread keeps the worker's affinity
+    if (!config_.sink_cpus.empty()) {
+        (void)pin_current_thread_to_cpus(config_.sink_cpus);
+    }
+    while (true) {
+        // Never take more events than there are free release slots, so
+        // every dequeued event's quota release fits (see constructor).
+        const std::size_t room = releases_->capacity() - releases_->size();
+        const std::size_t want = std::min(room, batch_.size());
+        std::size_t n = 0;
+        if (sink_schedules_) {
+            // Take everything that has arrived so the scheduler sees every
+            // backlogged lane and agent. Cannot overflow: try_forward()
+            // keeps each lane's events not yet written below its capacity.
+            QueuedEvent event;
+            while (ring_->try_pop(event)) {
+                (void)push_lane(event, lane_index(event));
+            }
+            while (n < want && pop_lane(batch_[n])) {
+                ++n;
+            }
+        } else {
+            n = ring_->try_pop_n(std::span(batch_.data(), want));
+        }
+
+        if (n == 0) {
+            if (!ring_->empty() || (sink_schedules_ && !lanes_empty())) {
+                // No release room yet. Unreachable given the release ring
+                // sizing, kept as a defensive spin rather than a drop.
+                std::this_thread::yield();
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire)) {
+                break;
+            }
+            // Queue ran dry: don't hold buffered events back while idle
+            sink_->flush();
+            const std::uint32_t seq = wake_seq_.load(std::memory_order_acquire);
+            sink_sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring_->empty() && !stopping_.load(std::memory_order_acquire)) {
+                wake_seq_.wait(seq, std::memory_order_acquire);
+            }
+            sink_sleeping_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        bool sampled = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            batch_payloads_[i] = batch_[i].payload;
+            sampled |= batch_[i].enqueued_ns != 0;
+        }
+        const std::uint64_t start = sampled ? monotonic_ns() : 0;
+        const std::size_t ok = sink_->write_batch(
+            std::span<const std::span<const std::byte>>(batch_payloads_.data(), n));
+        if (sampled) {
+            // One sink call: its duration is recorded once per batch
+            record_latency(0, start, monotonic_ns());
+            for (std::size_t i = 0; i < n; ++i) {
+                if (batch_[i].enqueued_ns != 0) {
+                    record_latency(batch_[i].enqueued_ns, start, 0);
+                }
+            }
+        }
+        add(total_forwarded_, ok);
+        add(sink_failures_, n - std::min(ok, n));
+        add(sink_batches_, 1);
+
+        // Hand quota and payload slots back (regardless of sink success)
+        for (std::size_t i = 0; i < n; ++i) {
+            (void)releases_->try_push(Completion{batch_[i].agent, batch_[i].payload_slot});
+        }
+
+        if (sink_schedules_) {
+            std::array<std::uint64_t, kLaneCount> written{};
+            for (std::size_t i = 0; i < n; ++i) {
+                ++written[lane_index(batch_[i])];
+            }
+            for (std::size_t i = 0; i < lane_count_; ++i) {
+                LaneQueue& q = lanes_[i];
+                q.written.store(q.written.load(std::memory_order_relaxed) + written[i],
+                                std::memory_order_release);
+            }
+        }
+        processed_.fetch_add(n, std::memory_order_release);
+        processed_.notify_all();
+    }
+    sink_->flush();
+}
+
 std::size_t BoundedForwarder::queue_depth() const noexcept {
-    return queue_.size();
+    if (sink_schedules_) {
+        return static_cast<std::size_t>(pushed_ - processed_.load(std::memory_order_acquire));
+    }
+    if (ring_) {
+        return ring_->size();
+    }
+    std::size_t depth = 0;
+    for (std::size_t i = 0; i < lane_count_; ++i) {
+        const LaneQueue& q = lanes_[i];
+        depth += q.drr ? q.drr->size() : q.fifo->size();
+    }
+    return depth;
 }
 
 std::size_t BoundedForwarder::queue_capacity() const noexcept {
-    return queue_.capacity();
+    return queue_bound(config_);
+}
+
+std::size_t BoundedForwarder::lane_depth(Lane lane) const noexcept {
+    if (lane_count_ == 1) {
+        return 0;
+    }
+    const LaneQueue& q = lanes_[static_cast<std::size_t>(lane)];
+    if (sink_schedules_) {
+        return static_cast<std::size_t>(q.pushed - q.written.load(std::memory_order_acquire));
+    }
+    return q.drr ? q.drr->size() : q.fifo->size();
 }
 
 bool BoundedForwarder::queue_empty() const noexcept {
-    return queue_.empty();
+    return queue_depth() == 0;
 }
 
 const AgentQuotaTracker& BoundedForwarder::quota_tracker() const noexcept {
     return quota_tracker_;
 }
 
+std::size_t BoundedForwarder::payload_slots_in_use() const noexcept {
+    const std::size_t held = reserved_slot_ != kNoBuffer ? 1 : 0;
+    return slab_.capacity() - slab_.available() - held;
+}
+
 }  // namespace gateway
@@ -0,0 +1,212 @@
+#include "gateway/source_limiter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gateway {
+
+namespace {
+
+// Ages beyond this are treated alike (keeps rebasing free of overflow)
+constexpr std::int64_t kMaxAgeNs = std::int64_t{1} << 62;
+
+std::int64_t to_ns(std::chrono::steady_clock::time_point t) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+std::int64_t wall_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Read-only mapping of a whole file, unmapped on scope exit
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) noexcept {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            status_ = errno == ENOENT ? SnapshotStatus::NotFound : SnapshotStatus::IoError;
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            status_ = SnapshotStatus::IoError;
+        } else if (st.st_size == 0) {
+            status_ = SnapshotStatus::BadFormat;  // nothing to map
+        } else {
+            size_ = static_cast<std::size_t>(st.st_size);
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data_ = static_cast<const std::byte*>(p);
+                status_ = SnapshotStatus::Ok;
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] SnapshotStatus status() const noexcept { return status_; }
+    [[nodiscard]] const std::byte* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+private:
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    SnapshotStatus status_ = SnapshotStatus::IoError;
+};
+
+}  // namespace
+
+std::uint64_t snapshot_checksum(const LimiterSnapshotRecord* records, std::size_t count) noexcept {
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ count;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(records);
+    for (std::size_t off = 0; off < count * sizeof(LimiterSnapshotRecord); off += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + off, sizeof(word));
+        h = (h ^ word) * 0x100000001b3ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+SnapshotStatus FlatSourceLimiter::save_snapshot(const char* path) const {
+    const std::string tmp = std::string(path) + ".tmp";
+    const std::size_t bytes = sizeof(LimiterSnapshotHeader) + size_ * sizeof(LimiterSnapshotRecord);
+
+    const int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return SnapshotStatus::IoError;
+    }
+    void* map = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        ::close(fd);
+        ::unlink(tmp.c_str());
+        return SnapshotStatus::IoError;
+    }
+
+    // Records straight into the mapping, most recently used first
+    const std::int64_t now_ns = to_ns(clock_());
+    auto* records = reinterpret_cast<LimiterSnapshotRecord*>(
+        static_cast<std::byte*>(map) + sizeof(LimiterSnapshotHeader));
+    std::size_t count = 0;
+    for (std::uint32_t n = lru_head_; n != kNil; n = nodes_[n].next) {
+        const Node& node = nodes_[n];
+        records[count++] = LimiterSnapshotRecord{
+            .ip = node.key.ip,
+            .port = node.key.port,
+            .reserved = 0,
+            .tokens = node.tokens,
+            .idle_ns = std::clamp<std::int64_t>(now_ns - node.last_ns, 0, kMaxAgeNs),
+        };
+    }
+
+    const LimiterSnapshotHeader header{
+        .magic = kLimiterSnapshotMagic,
+        .version = kLimiterSnapshotVersion,
+        .record_size = sizeof(LimiterSnapshotRecord),
+        .count = count,
+        .saved_wall_ns = wall_ns(),
+        .tokens_per_sec = config_.tokens_per_sec,
+        .burst_tokens = config_.burst_tokens,
+        .checksum = snapshot_checksum(records, count),
+    };
+    std::memcpy(map, &header, sizeof(header));
+
+    const bool synced = ::msync(map, bytes, MS_SYNC) == 0;
+    ::munmap(map, bytes);
+    const bool ok = synced && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(tmp.c_str(), path) != 0) {
+        ::unlink(tmp.c_str());
+        return SnapshotStatus::IoError;
+    }
+    return SnapshotStatus::Ok;
+}
+
+SnapshotStatus FlatSourceLimiter::restore_snapshot(const char* path) {
+    const MappedFile file(path);
+    if (file.status() != SnapshotStatus::Ok) {
+        return file.status();
+    }
+
+    // Validate everything before touching the table
+    LimiterSnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        return SnapshotStatus::BadFormat;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    const std::size_t payload = file.size() - sizeof(header);
+    if (header.magic != kLimiterSnapshotMagic || header.version != kLimiterSnapshotVersion ||
+        header.record_size != sizeof(LimiterSnapshotRecord) ||
+        header.count != payload / sizeof(LimiterSnapshotRecord) ||
+        payload % sizeof(LimiterSnapshotRecord) != 0) {
+        return SnapshotStatus::BadFormat;
+    }
+    // The mapping is page aligned, and the header keeps records 8-byte aligned
+    const auto* records =
+        reinterpret_cast<const LimiterSnapshotRecord*>(file.data() + sizeof(header));
+    const auto count = static_cast<std::size_t>(header.count);
+    if (snapshot_checksum(records, count) != header.checksum) {
+        return SnapshotStatus::BadFormat;
+    }
+
+    // Time the state spent on disk counts as idle time (refills buckets)
+    const std::int64_t now_ns = to_ns(clock_());
+    const std::int64_t downtime = std::clamp<std::int64_t>(wall_ns() - header.saved_wall_ns, 0, kMaxAgeNs);
+
+    std::fill(index_.begin(), index_.end(), kNil);
+    lru_head_ = kNil;
+    lru_tail_ = kNil;
+    size_ = 0;
+
+    // Append in file order (MRU first) so LRU order is kept
+    for (std::size_t i = 0; i < count && size_ < nodes_.size(); ++i) {
+        const LimiterSnapshotRecord& rec = records[i];
+        const SourceKey key{rec.ip, rec.port};
+        const std::size_t slot = find_slot(key);
+        if (index_[slot] != kNil) {
+            continue;  // duplicate record: keep the more recent one
+        }
+        const std::int64_t age = std::min(std::clamp<std::int64_t>(rec.idle_ns, 0, kMaxAgeNs) + downtime,
+                                          std::min(full_refill_ns_, kMaxAgeNs));
+        const auto m = static_cast<std::uint32_t>(size_++);
+        nodes_[m] = Node{.key = key, .prev = lru_tail_, .next = kNil,
+                         .tokens = std::min(rec.tokens, burst_), .last_ns = now_ns - age};
+        if (lru_tail_ != kNil) {
+            nodes_[lru_tail_].next = m;
+        } else {
+            lru_head_ = m;
+        }
+        lru_tail_ = m;
+        index_[slot] = m;
+    }
+
+    // Remaining nodes form the free list
+    free_head_ = kNil;
+    for (std::size_t i = nodes_.size(); i-- > size_;) {
+        nodes_[i].next = free_head_;
+        free_head_ = static_cast<std::uint32_t>(i);
+    }
+    return SnapshotStatus::Ok;
+}
+
+}  // namespace gateway
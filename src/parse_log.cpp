@@ -1,6 +1,10 @@
 #include "gateway/parse_log.hpp"
+#include "gateway/binary_format.hpp"
+#include "gateway/char_class.hpp"
+#include "gateway/keyword_table.hpp"
+#include "gateway/scan.hpp"
 
-#include <cctype>
+#include <bit>
 #include <charconv>
 #include <cstring>
 #include <optional>
@@ -9,7 +13,18 @@ namespace gateway {
 
 namespace {
 
-// Single-pass logfmt parser with bounded memory and CPU.
+// Known fields and level names, dispatched through compile-time perfect
+// hashes. Level order matches LogLevel's numeric values.
+enum class LogKey : std::uint8_t { Ts, Level, Msg, Agent, Unknown };
+enum class LevelName : std::uint8_t { Trace, Debug, Info, Warn, Error, Fatal, Unknown };
+
+constexpr KeywordTable<LogKey, 4> kLogKeys({"ts", "level", "msg", "agent"});
+constexpr KeywordTable<LevelName, 6> kLevelNames(
+    {"trace", "debug", "info", "warn", "error", "fatal"});
+
+static_assert(static_cast<int>(LevelName::Fatal) == static_cast<int>(LogLevel::Fatal));
+
+// Two-stage logfmt parser with bounded memory and CPU.
 // Format: key=value key=value key="quoted value"
 //
 // Grammar:
@@ -19,13 +34,19 @@ namespace {
 //   value  = bare | quoted
 //   bare   = [^\s"=]+
 //   quoted = '"' [^"]* '"'
+//
+// Stage 1 classifies the whole line into delimiter bitmaps (blank, '=',
+// '"') with scan::delimiter_bitmaps. Stage 2 walks fields by bit-scanning
+// those bitmaps: skipping blanks, finding the end of a key or bare value
+// and finding a closing quote are each a find-next-bit, not a per-byte
+// loop. Drop reasons are identical to a byte-at-a-time parse.
 
 class LogfmtParser {
 public:
     explicit LogfmtParser(std::string_view input) noexcept
         : input_(input), pos_(0) {}
 
-    LogResult parse() noexcept {
+    std::optional<LogDropReason> parse(ParsedLog& result) noexcept {
         // Invariant 1: Check size bound before any parsing
         if (input_.size() > LogLimits::kMaxLineBytes) {
             return LogDropReason::InputTooLarge;
@@ -46,7 +67,8 @@ public:
             return LogDropReason::EmptyInput;
         }
 
-        ParsedLog result{};
+        // Reset only the header fields; fields[] is scratch space, valid
+        // up to field_count
         result.field_count = 0;
         result.ts = 0;
         result.level = LogLevel::Info;
@@ -57,9 +79,12 @@ public:
         bool has_level = false;
         bool has_msg = false;
 
-        // Parse fields
+        // Stage 1: one pass over the line
+        scan::delimiter_bitmaps(input_.data(), input_.size(), blank_, equals_, quote_);
+
+        // Stage 2: slice fields
         while (pos_ < input_.size()) {
-            skip_spaces();
+            pos_ = next_non_blank(pos_);
             if (pos_ >= input_.size()) break;
 
             // Invariant 2: Bound iteration count
@@ -67,56 +92,78 @@ public:
                 return LogDropReason::TooManyFields;
             }
 
-            // Parse key
-            auto key = parse_key();
-            if (!key) {
-                return key.error();
+            // Key: the key-character run up to the next delimiter
+            const std::size_t key_start = pos_;
+            const std::size_t delim = next_delimiter(pos_);
+            std::size_t key_end = key_start;
+            if (!chars::is(input_[key_end], chars::kLogKeyStart)) {
+                return LogDropReason::InvalidKeyChar;
             }
-
-            if (key->size() > LogLimits::kMaxKeyLen) {
+            ++key_end;
+            key_end += chars::span_of(input_.data() + key_end, delim - key_end,
+                                      chars::kLogKeyChar);
+            if (key_end - key_start > LogLimits::kMaxKeyLen) {
                 return LogDropReason::KeyTooLong;
             }
 
-            // Expect '='
-            if (pos_ >= input_.size() || input_[pos_] != '=') {
+            // Expect '=' right after the key
+            if (key_end != delim || delim >= input_.size() || !test(equals_, delim)) {
                 return LogDropReason::MissingEquals;
             }
-            ++pos_; // consume '='
-
-            // Parse value
-            auto value = parse_value();
-            if (!value) {
-                return value.error();
+            const std::string_view key = input_.substr(key_start, key_end - key_start);
+            pos_ = delim + 1; // consume '='
+
+            // Value: empty at end of line, quoted, or bare up to a delimiter
+            std::string_view value;
+            if (pos_ < input_.size() && test(quote_, pos_)) {
+                const std::size_t close = next_set(quote_, pos_ + 1);
+                if (close >= input_.size()) {
+                    return LogDropReason::UnterminatedQuote;
+                }
+                value = input_.substr(pos_ + 1, close - pos_ - 1);
+                pos_ = close + 1;
+            } else if (pos_ < input_.size()) {
+                const std::size_t value_end = next_delimiter(pos_);
+                value = input_.substr(pos_, value_end - pos_);
+                pos_ = value_end;
             }
 
-            if (value->size() > LogLimits::kMaxValueLen) {
+            if (value.size() > LogLimits::kMaxValueLen) {
                 return LogDropReason::ValueTooLong;
             }
 
             // Store field
-            result.fields[result.field_count].key = *key;
-            result.fields[result.field_count].value = *value;
+            result.fields[result.field_count].key = key;
+            result.fields[result.field_count].value = value;
             ++result.field_count;
 
             // Handle known fields
-            if (*key == "ts") {
-                std::uint64_t ts_val = 0;
-                auto [ptr, ec] = std::from_chars(value->data(), value->data() + value->size(), ts_val);
-                if (ec != std::errc{} || ptr != value->data() + value->size()) {
-                    return LogDropReason::InvalidTimestamp;
-                }
-                result.ts = ts_val;
-                has_ts = true;
-            } else if (*key == "level") {
-                if (!parse_log_level(*value, result.level)) {
-                    return LogDropReason::InvalidLevel;
+            switch (kLogKeys.find(key)) {
+                case LogKey::Ts: {
+                    std::uint64_t ts_val = 0;
+                    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), ts_val);
+                    if (ec != std::errc{} || ptr != value.data() + value.size()) {
+                        return LogDropReason::InvalidTimestamp;
+                    }
+                    result.ts = ts_val;
+                    has_ts = true;
+                    break;
                 }
-                has_level = true;
-            } else if (*key == "msg") {
-                result.msg = *value;
-                has_msg = true;
-            } else if (*key == "agent") {
-                result.agent_id = *value;
+                case LogKey::Level:
+                    if (!parse_log_level(value, result.level)) {
+                        return LogDropReason::InvalidLevel;
+                    }
+                    has_level = true;
+                    break;
+                case LogKey::Msg:
+                    result.msg = value;
+                    has_msg = true;
+                    break;
+                case LogKey::Agent:
+                    result.agent_id = value;
+                    break;
+                case LogKey::Unknown:
+                    break;
             }
         }
 
@@ -131,148 +178,96 @@ public:
             return LogDropReason::MissingMessage;
         }
 
-        return result;
+        return std::nullopt;
     }
 
 private:
+    static constexpr std::size_t kWords = (LogLimits::kMaxLineBytes + 63) / 64;
+
     std::string_view input_;
     std::size_t pos_;
 
-    void skip_spaces() noexcept {
-        while (pos_ < input_.size() &&
-               (input_[pos_] == ' ' || input_[pos_] == '\t')) {
-            ++pos_;
-        }
-    }
-
-    // Result type for key/value parsing
-    struct ParseError {
-        LogDropReason reason;
-    };
-
-    template<typename T>
-    struct Result {
-        std::optional<T> value;
-        LogDropReason error_reason;
-
-        Result(T v) : value(std::move(v)), error_reason{} {}
-        Result(LogDropReason e) : value(std::nullopt), error_reason(e) {}
-
-        explicit operator bool() const { return value.has_value(); }
-        T& operator*() { return *value; }
-        const T& operator*() const { return *value; }
-        T* operator->() { return &(*value); }
-        const T* operator->() const { return &(*value); }
-        LogDropReason error() const { return error_reason; }
-    };
-
-    // Parse a key: [a-z_][a-z0-9_]*
-    Result<std::string_view> parse_key() noexcept {
-        std::size_t start = pos_;
-
-        // First character: [a-z_]
-        if (pos_ >= input_.size()) {
-            return LogDropReason::MissingEquals;
-        }
-
-        char c = input_[pos_];
-        if (!is_key_start(c)) {
-            return LogDropReason::InvalidKeyChar;
-        }
-        ++pos_;
+    // Delimiter bitmaps for input_ (bits past input_.size() are zero)
+    std::uint64_t blank_[kWords];
+    std::uint64_t equals_[kWords];
+    std::uint64_t quote_[kWords];
 
-        // Remaining characters: [a-z0-9_]
-        while (pos_ < input_.size()) {
-            c = input_[pos_];
-            if (!is_key_char(c)) {
-                break;
-            }
-            ++pos_;
-        }
-
-        return input_.substr(start, pos_ - start);
+    static bool test(const std::uint64_t* bits, std::size_t i) noexcept {
+        return (bits[i / 64] >> (i % 64)) & 1u;
     }
 
-    // Parse a value: bare or quoted
-    Result<std::string_view> parse_value() noexcept {
-        if (pos_ >= input_.size()) {
-            // Empty value at end of line
-            return std::string_view{};
-        }
-
-        if (input_[pos_] == '"') {
-            return parse_quoted_value();
-        } else {
-            return parse_bare_value();
+    // First position >= from whose bit (in the combined word produced by
+    // `word`) is set, or input_.size()
+    template <typename WordFn>
+    std::size_t next_bit(std::size_t from, WordFn word) const noexcept {
+        if (from >= input_.size()) {
+            return input_.size();
         }
-    }
-
-    // Parse bare value (unquoted): [^\s"=]+
-    Result<std::string_view> parse_bare_value() noexcept {
-        std::size_t start = pos_;
-
-        while (pos_ < input_.size()) {
-            char c = input_[pos_];
-            if (c == ' ' || c == '\t' || c == '"' || c == '=') {
-                break;
+        std::size_t w = from / 64;
+        std::uint64_t bits = word(w) & (~std::uint64_t{0} << (from % 64));
+        const std::size_t words = (input_.size() + 63) / 64;
+        while (bits == 0) {
+            if (++w >= words) {
+                return input_.size();
             }
-            ++pos_;
+            bits = word(w);
         }
-
-        return input_.substr(start, pos_ - start);
+        const std::size_t i = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+        return i < input_.size() ? i : input_.size();
     }
 
-    // Parse quoted value: "[^"]*"
-    Result<std::string_view> parse_quoted_value() noexcept {
-        if (pos_ >= input_.size() || input_[pos_] != '"') {
-            return LogDropReason::UnterminatedQuote;
-        }
-        ++pos_; // consume opening quote
-
-        std::size_t start = pos_;
-
-        // Find closing quote (simple: no escape handling for logfmt)
-        while (pos_ < input_.size()) {
-            if (input_[pos_] == '"') {
-                std::string_view result = input_.substr(start, pos_ - start);
-                ++pos_; // consume closing quote
-                return result;
-            }
-            ++pos_;
-        }
-
-        return LogDropReason::UnterminatedQuote;
+    std::size_t next_set(const std::uint64_t* bits, std::size_t from) const noexcept {
+        return next_bit(from, [bits](std::size_t w) { return bits[w]; });
     }
 
-    static bool is_key_start(char c) noexcept {
-        return (c >= 'a' && c <= 'z') || c == '_';
+    // Next blank, '=' or '"' (ends a key or a bare value)
+    std::size_t next_delimiter(std::size_t from) const noexcept {
+        return next_bit(from, [this](std::size_t w) { return blank_[w] | equals_[w] | quote_[w]; });
     }
 
-    static bool is_key_char(char c) noexcept {
-        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+    // Next byte that is not a blank
+    std::size_t next_non_blank(std::size_t from) const noexcept {
+        return next_bit(from, [this](std::size_t w) { return ~blank_[w]; });
     }
 };
 
 } // namespace
 
+std::optional<LogDropReason> parse_log(std::span<const std::byte> input,
+                                       ParsedLog& out) noexcept {
+    std::string_view sv(reinterpret_cast<const char*>(input.data()), input.size());
+    return parse_log(sv, out);
+}
+
+std::optional<LogDropReason> parse_log(std::string_view input, ParsedLog& out) noexcept {
+    const auto bytes = std::as_bytes(std::span(input.data(), input.size()));
+    if (is_binary_body(bytes)) {
+        return parse_binary_log(bytes, out);
+    }
+    LogfmtParser parser(input);
+    return parser.parse(out);
+}
+
 LogResult parse_log(std::span<const std::byte> input) noexcept {
     std::string_view sv(reinterpret_cast<const char*>(input.data()), input.size());
     return parse_log(sv);
 }
 
 LogResult parse_log(std::string_view input) noexcept {
-    LogfmtParser parser(input);
-    return parser.parse();
+    ParsedLog result;
+    if (auto drop = parse_log(input, result)) {
+        return *drop;
+    }
+    return result;
 }
 
 bool parse_log_level(std::string_view s, LogLevel& out) noexcept {
-    if (s == "trace") { out = LogLevel::Trace; return true; }
-    if (s == "debug") { out = LogLevel::Debug; return true; }
-    if (s == "info")  { out = LogLevel::Info;  return true; }
-    if (s == "warn")  { out = LogLevel::Warn;  return true; }
-    if (s == "error") { out = LogLevel::Error; return true; }
-    if (s == "fatal") { out = LogLevel::Fatal; return true; }
-    return false;
+    const LevelName level = kLevelNames.find(s);
+    if (level == LevelName::Unknown) {
+        return false;
+    }
+    out = static_cast<LogLevel>(level);
+    return true;
 }
 
 } // namespace gateway
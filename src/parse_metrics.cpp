@@ -1,23 +1,43 @@
 #include "gateway/parse_metrics.hpp"
+#include "gateway/binary_format.hpp"
+#include "gateway/char_class.hpp"
+#include "gateway/keyword_table.hpp"
+#include "gateway/scan.hpp"
+#include "gateway/validate_metrics.hpp"
 
-#include <cctype>
 #include <charconv>
 #include <cstring>
 #include <optional>
+#include <variant>
 
 namespace gateway {
 
 namespace {
 
+// Schema keys, dispatched through compile-time perfect hashes
+enum class RootKey : std::uint8_t { AgentId, Seq, Ts, Metrics, Unknown };
+enum class MetricKey : std::uint8_t { Name, Value, Unit, Tags, Unknown };
+
+constexpr KeywordTable<RootKey, 4> kRootKeys({"agent_id", "seq", "ts", "metrics"});
+constexpr KeywordTable<MetricKey, 4> kMetricKeys({"n", "v", "u", "t"});
+
 // Minimal JSON tokenizer with bounded parsing.
 // Does NOT build a DOM - validates and extracts in single pass.
+//
+// With `rules` set (fused mode), TB-4 rules are applied as fields are
+// decoded and the first violation ends the parse; otherwise only TB-3
+// reasons are produced.
 
 class JsonParser {
 public:
-    explicit JsonParser(std::string_view input) noexcept
-        : input_(input), pos_(0), depth_(0) {}
+    using Failure = std::variant<MetricsDropReason, MetricsValidationDrop>;
 
-    MetricsResult parse() noexcept {
+    explicit JsonParser(std::string_view input,
+                        const MetricsValidationConfig* rules = nullptr,
+                        std::uint64_t current_time_ms = 0) noexcept
+        : input_(input), pos_(0), depth_(0), rules_(rules), now_ms_(current_time_ms) {}
+
+    std::optional<Failure> parse(ParsedMetrics& result) noexcept {
         // Invariant 1: Check size bound before any parsing
         if (input_.size() > MetricsLimits::kMaxInputBytes) {
             return MetricsDropReason::InputTooLarge;
@@ -28,13 +48,19 @@ public:
             return MetricsDropReason::InvalidJson;
         }
 
-        ParsedMetrics result{};
-        result.metric_count = 0;
+        // Reset only what this message will overwrite: the fixed arrays
+        // are scratch space, valid up to metric_count / tag_total
+        result.agent_id = {};
+        result.seq = 0;
         result.ts = 0;
+        result.metric_count = 0;
+        result.tag_total = 0;
+        result.text_used = 0;
 
         bool has_agent_id = false;
         bool has_seq = false;
         bool has_metrics = false;
+        std::uint8_t seen_keys = 0;
 
         // Parse root object fields
         skip_whitespace();
@@ -59,42 +85,76 @@ public:
             }
             skip_whitespace();
 
-            // Dispatch based on key
-            if (*key == "agent_id") {
-                auto val = parse_string();
-                if (!val) {
-                    return MetricsDropReason::InvalidFieldType;
-                }
-                if (val->size() > MetricsLimits::kMaxAgentIdLen) {
-                    return MetricsDropReason::AgentIdTooLong;
+            // Each root key at most once: the fused path applies TB-4 to
+            // the value it sees, so a later repeat could not override it
+            const RootKey root_key = kRootKeys.find(*key);
+            if (root_key != RootKey::Unknown) {
+                const auto bit = static_cast<std::uint8_t>(1u << static_cast<unsigned>(root_key));
+                if (seen_keys & bit) {
+                    return MetricsDropReason::DuplicateField;
                 }
-                if (!validate_agent_id(*val)) {
-                    return MetricsDropReason::AgentIdInvalidChars;
+                seen_keys |= bit;
+            }
+
+            // Dispatch based on key
+            switch (root_key) {
+                case RootKey::AgentId: {
+                    std::string_view agent_id;
+                    if (auto r = parse_text(MetricsLimits::kMaxAgentIdLen, result, agent_id,
+                                            MetricsDropReason::InvalidFieldType,
+                                            MetricsDropReason::AgentIdTooLong)) {
+                        return *r;
+                    }
+                    if (rules_) {
+                        // TB-4 format is the stricter charset: one pass in
+                        // the common case, TB-3 only to classify a failure
+                        if (!validate_agent_id_format(agent_id.data(), agent_id.size())) {
+                            if (!validate_agent_id(agent_id)) {
+                                return MetricsDropReason::AgentIdInvalidChars;
+                            }
+                            return MetricsValidationDrop::AgentIdInvalidFormat;
+                        }
+                    } else if (!validate_agent_id(agent_id)) {
+                        return MetricsDropReason::AgentIdInvalidChars;
+                    }
+                    result.agent_id = agent_id;
+                    has_agent_id = true;
+                    break;
                 }
-                result.agent_id = *val;
-                has_agent_id = true;
-            } else if (*key == "seq") {
-                auto val = parse_integer();
-                if (!val) {
-                    return MetricsDropReason::InvalidFieldType;
+                case RootKey::Seq: {
+                    auto val = parse_integer();
+                    if (!val) {
+                        return MetricsDropReason::InvalidFieldType;
+                    }
+                    result.seq = static_cast<std::uint32_t>(*val);
+                    has_seq = true;
+                    break;
                 }
-                result.seq = static_cast<std::uint32_t>(*val);
-                has_seq = true;
-            } else if (*key == "ts") {
-                auto val = parse_integer();
-                if (!val) {
-                    return MetricsDropReason::InvalidFieldType;
+                case RootKey::Ts: {
+                    auto val = parse_integer();
+                    if (!val) {
+                        return MetricsDropReason::InvalidFieldType;
+                    }
+                    result.ts = static_cast<std::uint64_t>(*val);
+                    // ts = 0 reads as absent; checked once the object ends
+                    if (rules_ && result.ts != 0) {
+                        if (auto drop = check_metrics_timestamp(result.ts, *rules_, now_ms_)) {
+                            return *drop;
+                        }
+                    }
+                    break;
                 }
-                result.ts = static_cast<std::uint64_t>(*val);
-            } else if (*key == "metrics") {
-                auto r = parse_metrics_array(result);
-                if (r) {
-                    return *r;
+                case RootKey::Metrics: {
+                    auto r = parse_metrics_array(result);
+                    if (r) {
+                        return *r;
+                    }
+                    has_metrics = true;
+                    break;
                 }
-                has_metrics = true;
-            } else {
-                // additionalProperties: false
-                return MetricsDropReason::UnexpectedField;
+                case RootKey::Unknown:
+                    // additionalProperties: false
+                    return MetricsDropReason::UnexpectedField;
             }
 
             skip_whitespace();
@@ -111,14 +171,21 @@ public:
         if (!has_agent_id || !has_seq || !has_metrics) {
             return MetricsDropReason::MissingRequiredField;
         }
+        if (rules_ && result.ts == 0) {
+            if (auto drop = check_metrics_timestamp(0, *rules_, now_ms_)) {
+                return *drop;
+            }
+        }
 
-        return result;
+        return std::nullopt;
     }
 
 private:
     std::string_view input_;
     std::size_t pos_;
     std::size_t depth_;
+    const MetricsValidationConfig* rules_;
+    std::uint64_t now_ms_;
 
     char peek() const noexcept {
         return (pos_ < input_.size()) ? input_[pos_] : '\0';
@@ -136,42 +203,185 @@ private:
         return false;
     }
 
+    // Bytes left from pos_ (scan:: functions never look past the end)
+    const char* cursor() const noexcept { return input_.data() + pos_; }
+    std::size_t remaining() const noexcept { return input_.size() - pos_; }
+
     void skip_whitespace() noexcept {
-        while (pos_ < input_.size()) {
-            char c = input_[pos_];
-            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
-                ++pos_;
-            } else {
-                break;
-            }
-        }
+        pos_ += scan::skip_whitespace(cursor(), remaining());
+    }
+
+    void skip_digits() noexcept {
+        pos_ += scan::skip_digits(cursor(), remaining());
     }
 
-    // Parse a JSON string, returns view into original input
-    std::optional<std::string_view> parse_string() noexcept {
+    // Parse a JSON string, returns view into original input (still
+    // escaped); `escaped`, if given, is set when it contains a backslash
+    std::optional<std::string_view> parse_string(bool* escaped = nullptr) noexcept {
         if (!expect('"')) {
             return std::nullopt;
         }
 
         std::size_t start = pos_;
-        while (pos_ < input_.size()) {
-            char c = input_[pos_];
-            if (c == '"') {
+        while (true) {
+            // Jump to the next quote or backslash; plain bytes are skipped
+            // a vector block at a time
+            pos_ += scan::find_quote_or_escape(cursor(), remaining());
+            if (pos_ >= input_.size()) {
+                return std::nullopt; // Unterminated string
+            }
+            if (input_[pos_] == '"') {
                 std::string_view result = input_.substr(start, pos_ - start);
                 advance(); // consume closing quote
                 return result;
             }
-            if (c == '\\') {
-                // Skip escaped character
+            // Skip escaped character
+            if (escaped != nullptr) {
+                *escaped = true;
+            }
+            advance();
+            if (pos_ < input_.size()) {
                 advance();
-                if (pos_ < input_.size()) {
-                    advance();
+            }
+        }
+    }
+
+    // Parse a string field that is kept in the result: decoded, at most
+    // `limit` bytes. Strings without escapes stay views into the input;
+    // the rest are decoded into result.text. Fails with `not_string` if
+    // the value is not a string, `too_long` past the limit and InvalidJson
+    // on a bad escape.
+    std::optional<Failure> parse_text(std::size_t limit, ParsedMetrics& result,
+                                      std::string_view& out, MetricsDropReason not_string,
+                                      MetricsDropReason too_long) noexcept {
+        bool escaped = false;
+        auto raw = parse_string(&escaped);
+        if (!raw) {
+            return not_string;
+        }
+        if (!escaped) {
+            if (raw->size() > limit) {
+                return too_long;
+            }
+            out = *raw;
+            return std::nullopt;
+        }
+
+        // text holds every stored string at its limit; only a repeated key
+        // (the last one wins) can run out of room
+        if (result.text.size() - result.text_used < limit) {
+            return MetricsDropReason::InvalidJson;
+        }
+        char* const dst = result.text.data() + result.text_used;
+        std::size_t n = 0;
+        switch (decode_string(*raw, limit, dst, n)) {
+            case Decode::Ok:
+                break;
+            case Decode::TooLong:
+                return too_long;
+            case Decode::BadEscape:
+                return MetricsDropReason::InvalidJson;
+        }
+        result.text_used += n;
+        out = std::string_view(dst, n);
+        return std::nullopt;
+    }
+
+    enum class Decode : std::uint8_t { Ok, TooLong, BadEscape };
+
+    // Four hex digits at raw[at..at+4)
+    static bool parse_hex4(std::string_view raw, std::size_t at, std::uint32_t& out) noexcept {
+        if (raw.size() - at < 4) {
+            return false;
+        }
+        std::uint32_t v = 0;
+        for (std::size_t i = at; i < at + 4; ++i) {
+            const char c = raw[i];
+            const int digit = c >= '0' && c <= '9'   ? c - '0'
+                              : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                              : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                                     : -1;
+            if (digit < 0) {
+                return false;
+            }
+            v = v << 4 | static_cast<std::uint32_t>(digit);
+        }
+        out = v;
+        return true;
+    }
+
+    // Decode the JSON escapes of `raw` (contents between the quotes) into
+    // dst[0, limit): the RFC 8259 short escapes and \uXXXX, surrogate
+    // pairs combined, to UTF-8. A lone surrogate is a bad escape. Decoded
+    // text is never longer than `raw`.
+    static Decode decode_string(std::string_view raw, std::size_t limit, char* dst,
+                                std::size_t& n) noexcept {
+        n = 0;
+        std::size_t i = 0;
+        while (i < raw.size()) {
+            // Copy the run up to the next backslash in one go
+            std::size_t run = raw.find('\\', i);
+            if (run == std::string_view::npos) {
+                run = raw.size();
+            }
+            if (run - i > limit - n) {
+                return Decode::TooLong;
+            }
+            std::memcpy(dst + n, raw.data() + i, run - i);
+            n += run - i;
+            i = run;
+            if (i == raw.size()) {
+                break;
+            }
+
+            // parse_string() never ends a string inside an escape
+            std::uint32_t cp = 0;
+            switch (raw[i + 1]) {
+                case '"':  cp = '"'; i += 2; break;
+                case '\\': cp = '\\'; i += 2; break;
+                case '/':  cp = '/'; i += 2; break;
+                case 'b':  cp = '\b'; i += 2; break;
+                case 'f':  cp = '\f'; i += 2; break;
+                case 'n':  cp = '\n'; i += 2; break;
+                case 'r':  cp = '\r'; i += 2; break;
+                case 't':  cp = '\t'; i += 2; break;
+                case 'u': {
+                    if (!parse_hex4(raw, i + 2, cp) || (cp >= 0xDC00 && cp <= 0xDFFF)) {
+                        return Decode::BadEscape;
+                    }
+                    i += 6;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        std::uint32_t low = 0;
+                        if (raw.size() - i < 6 || raw[i] != '\\' || raw[i + 1] != 'u' ||
+                            !parse_hex4(raw, i + 2, low) || low < 0xDC00 || low > 0xDFFF) {
+                            return Decode::BadEscape;
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                    break;
                 }
+                default:
+                    return Decode::BadEscape;
+            }
+
+            // UTF-8 encode
+            const std::size_t len = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+            if (len > limit - n) {
+                return Decode::TooLong;
+            }
+            if (len == 1) {
+                dst[n] = static_cast<char>(cp);
             } else {
-                advance();
+                const unsigned char lead = len == 2 ? 0xC0 : len == 3 ? 0xE0 : 0xF0;
+                dst[n] = static_cast<char>(lead | (cp >> (6 * (len - 1))));
+                for (std::size_t k = 1; k < len; ++k) {
+                    dst[n + k] = static_cast<char>(0x80 | ((cp >> (6 * (len - 1 - k))) & 0x3F));
+                }
             }
+            n += len;
         }
-        return std::nullopt; // Unterminated string
+        return Decode::Ok;
     }
 
     // Parse a JSON integer
@@ -183,13 +393,11 @@ private:
             advance();
         }
 
-        if (!std::isdigit(static_cast<unsigned char>(peek()))) {
+        if (!chars::is(peek(), chars::kDigit)) {
             return std::nullopt;
         }
 
-        while (std::isdigit(static_cast<unsigned char>(peek()))) {
-            advance();
-        }
+        skip_digits();
 
         std::string_view num_str = input_.substr(start, pos_ - start);
         std::int64_t value = 0;
@@ -210,19 +418,15 @@ private:
         }
 
         // Integer part
-        if (!std::isdigit(static_cast<unsigned char>(peek()))) {
+        if (!chars::is(peek(), chars::kDigit)) {
             return std::nullopt;
         }
-        while (std::isdigit(static_cast<unsigned char>(peek()))) {
-            advance();
-        }
+        skip_digits();
 
         // Fractional part
         if (peek() == '.') {
             advance();
-            while (std::isdigit(static_cast<unsigned char>(peek()))) {
-                advance();
-            }
+            skip_digits();
         }
 
         // Exponent
@@ -231,9 +435,7 @@ private:
             if (peek() == '+' || peek() == '-') {
                 advance();
             }
-            while (std::isdigit(static_cast<unsigned char>(peek()))) {
-                advance();
-            }
+            skip_digits();
         }
 
         std::string_view num_str = input_.substr(start, pos_ - start);
@@ -247,14 +449,7 @@ private:
 
     // Validate agent_id characters: ^[a-zA-Z0-9_.-]+$
     static bool validate_agent_id(std::string_view s) noexcept {
-        if (s.empty()) return false;
-        for (char c : s) {
-            if (!std::isalnum(static_cast<unsigned char>(c)) &&
-                c != '_' && c != '.' && c != '-') {
-                return false;
-            }
-        }
-        return true;
+        return !s.empty() && chars::all_of(s.data(), s.size(), chars::kJsonAgentIdChar);
     }
 
     // Skip a JSON value (for unknown fields - but we reject those)
@@ -272,7 +467,7 @@ private:
             return skip_literal();
         } else if (c == 'n') {
             return skip_literal();
-        } else if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+        } else if (c == '-' || chars::is(c, chars::kDigit)) {
             return parse_number().has_value();
         }
         return false;
@@ -346,7 +541,7 @@ private:
     }
 
     // Parse the metrics array
-    std::optional<MetricsDropReason> parse_metrics_array(ParsedMetrics& result) noexcept {
+    std::optional<Failure> parse_metrics_array(ParsedMetrics& result) noexcept {
         if (!expect('[')) {
             return MetricsDropReason::InvalidFieldType;
         }
@@ -368,10 +563,16 @@ private:
                 return MetricsDropReason::TooManyMetrics;
             }
 
-            auto r = parse_metric(result.metrics[result.metric_count]);
+            auto r = parse_metric(result.metrics[result.metric_count], result);
             if (r) {
                 return r;
             }
+            if (rules_) {
+                if (auto drop = check_metric(result.metrics[result.metric_count],
+                                             rules_->value_rules)) {
+                    return *drop;
+                }
+            }
             ++result.metric_count;
 
             skip_whitespace();
@@ -387,8 +588,8 @@ private:
         }
     }
 
-    // Parse a single metric object
-    std::optional<MetricsDropReason> parse_metric(Metric& metric) noexcept {
+    // Parse a single metric object; its tags are appended to result's pool
+    std::optional<Failure> parse_metric(Metric& metric, ParsedMetrics& result) noexcept {
         if (!expect('{')) {
             return MetricsDropReason::InvalidJson;
         }
@@ -399,6 +600,7 @@ private:
         metric.name = {};
         metric.value = 0.0;
         metric.unit = {};
+        metric.tag_offset = static_cast<std::uint16_t>(result.tag_total);
         metric.tag_count = 0;
 
         bool has_name = false;
@@ -425,40 +627,43 @@ private:
             }
             skip_whitespace();
 
-            if (*key == "n") {
-                auto val = parse_string();
-                if (!val) {
-                    return MetricsDropReason::InvalidFieldType;
-                }
-                if (val->size() > MetricsLimits::kMaxMetricNameLen) {
-                    return MetricsDropReason::MetricNameTooLong;
+            switch (kMetricKeys.find(*key)) {
+                case MetricKey::Name: {
+                    if (auto r = parse_text(MetricsLimits::kMaxMetricNameLen, result, metric.name,
+                                            MetricsDropReason::InvalidFieldType,
+                                            MetricsDropReason::MetricNameTooLong)) {
+                        return r;
+                    }
+                    has_name = true;
+                    break;
                 }
-                metric.name = *val;
-                has_name = true;
-            } else if (*key == "v") {
-                auto val = parse_number();
-                if (!val) {
-                    return MetricsDropReason::MetricValueNotNumber;
+                case MetricKey::Value: {
+                    auto val = parse_number();
+                    if (!val) {
+                        return MetricsDropReason::MetricValueNotNumber;
+                    }
+                    metric.value = *val;
+                    has_value = true;
+                    break;
                 }
-                metric.value = *val;
-                has_value = true;
-            } else if (*key == "u") {
-                auto val = parse_string();
-                if (!val) {
-                    return MetricsDropReason::InvalidFieldType;
+                case MetricKey::Unit: {
+                    if (auto r = parse_text(MetricsLimits::kMaxUnitLen, result, metric.unit,
+                                            MetricsDropReason::InvalidFieldType,
+                                            MetricsDropReason::UnitTooLong)) {
+                        return r;
+                    }
+                    break;
                 }
-                if (val->size() > MetricsLimits::kMaxUnitLen) {
-                    return MetricsDropReason::UnitTooLong;
+                case MetricKey::Tags: {
+                    auto r = parse_tags(metric, result);
+                    if (r) {
+                        return r;
+                    }
+                    break;
                 }
-                metric.unit = *val;
-            } else if (*key == "t") {
-                auto r = parse_tags(metric);
-                if (r) {
-                    return r;
-                }
-            } else {
-                // additionalProperties: false
-                return MetricsDropReason::UnexpectedField;
+                case MetricKey::Unknown:
+                    // additionalProperties: false
+                    return MetricsDropReason::UnexpectedField;
             }
 
             skip_whitespace();
@@ -482,8 +687,9 @@ private:
         return std::nullopt;
     }
 
-    // Parse tags object
-    std::optional<MetricsDropReason> parse_tags(Metric& metric) noexcept {
+    // Parse tags object. Tags of one metric are contiguous in the pool
+    // because metrics are parsed one at a time.
+    std::optional<Failure> parse_tags(Metric& metric, ParsedMetrics& result) noexcept {
         if (!expect('{')) {
             return MetricsDropReason::InvalidFieldType;
         }
@@ -500,17 +706,17 @@ private:
 
         while (true) {
             // Invariant 2: Bound iteration count
-            if (metric.tag_count >= MetricsLimits::kMaxTags) {
+            if (metric.tag_count >= MetricsLimits::kMaxTags ||
+                result.tag_total >= MetricsLimits::kMaxTotalTags) {
                 return MetricsDropReason::TooManyTags;
             }
 
             skip_whitespace();
-            auto key = parse_string();
-            if (!key) {
-                return MetricsDropReason::InvalidJson;
-            }
-            if (key->size() > MetricsLimits::kMaxTagKeyLen) {
-                return MetricsDropReason::TagKeyTooLong;
+            MetricTag& tag = result.tags[result.tag_total];
+            if (auto r = parse_text(MetricsLimits::kMaxTagKeyLen, result, tag.key,
+                                    MetricsDropReason::InvalidJson,
+                                    MetricsDropReason::TagKeyTooLong)) {
+                return r;
             }
 
             skip_whitespace();
@@ -519,16 +725,12 @@ private:
             }
             skip_whitespace();
 
-            auto val = parse_string();
-            if (!val) {
-                return MetricsDropReason::InvalidFieldType;
-            }
-            if (val->size() > MetricsLimits::kMaxTagValueLen) {
-                return MetricsDropReason::TagValueTooLong;
+            if (auto r = parse_text(MetricsLimits::kMaxTagValueLen, result, tag.value,
+                                    MetricsDropReason::InvalidFieldType,
+                                    MetricsDropReason::TagValueTooLong)) {
+                return r;
             }
-
-            metric.tags[metric.tag_count].key = *key;
-            metric.tags[metric.tag_count].value = *val;
+            ++result.tag_total;
             ++metric.tag_count;
 
             skip_whitespace();
@@ -546,14 +748,115 @@ private:
 
 } // namespace
 
+ParsedMetrics::ParsedMetrics(const ParsedMetrics& other) noexcept {
+    *this = other;
+}
+
+ParsedMetrics& ParsedMetrics::operator=(const ParsedMetrics& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    // Views into other.text move to the same offset in ours; views into
+    // the input are kept
+    const auto from = reinterpret_cast<std::uintptr_t>(other.text.data());
+    auto rebase = [&](std::string_view v) noexcept {
+        const auto at = reinterpret_cast<std::uintptr_t>(v.data());
+        return at >= from && at < from + other.text_used
+                   ? std::string_view(text.data() + (at - from), v.size())
+                   : v;
+    };
+
+    seq = other.seq;
+    ts = other.ts;
+    metric_count = other.metric_count;
+    tag_total = other.tag_total;
+    text_used = other.text_used;
+    std::memcpy(text.data(), other.text.data(), text_used);
+    agent_id = rebase(other.agent_id);
+    for (std::size_t i = 0; i < metric_count; ++i) {
+        metrics[i] = other.metrics[i];
+        metrics[i].name = rebase(other.metrics[i].name);
+        metrics[i].unit = rebase(other.metrics[i].unit);
+    }
+    for (std::size_t i = 0; i < tag_total; ++i) {
+        tags[i].key = rebase(other.tags[i].key);
+        tags[i].value = rebase(other.tags[i].value);
+    }
+    return *this;
+}
+
+std::optional<MetricsDropReason> parse_metrics(std::span<const std::byte> input,
+                                               ParsedMetrics& out) noexcept {
+    std::string_view sv(reinterpret_cast<const char*>(input.data()), input.size());
+    return parse_metrics(sv, out);
+}
+
+std::optional<MetricsDropReason> parse_metrics(std::string_view input,
+                                               ParsedMetrics& out) noexcept {
+    const auto bytes = std::as_bytes(std::span(input.data(), input.size()));
+    if (is_binary_body(bytes)) {
+        return parse_binary_metrics(bytes, out);
+    }
+    JsonParser parser(input);
+    if (auto failure = parser.parse(out)) {
+        // No rules, so only TB-3 reasons are produced
+        return std::get<MetricsDropReason>(*failure);
+    }
+    return std::nullopt;
+}
+
 MetricsResult parse_metrics(std::span<const std::byte> input) noexcept {
     std::string_view sv(reinterpret_cast<const char*>(input.data()), input.size());
     return parse_metrics(sv);
 }
 
 MetricsResult parse_metrics(std::string_view input) noexcept {
-    JsonParser parser(input);
-    return parser.parse();
+    ParsedMetrics result;
+    if (auto drop = parse_metrics(input, result)) {
+        return *drop;
+    }
+    return result;
+}
+
+FusedMetricsResult parse_and_validate_metrics(std::span<const std::byte> input,
+                                              const MetricsValidationConfig& config,
+                                              std::uint64_t current_time_ms,
+                                              ParsedMetrics& scratch) noexcept {
+    std::string_view sv(reinterpret_cast<const char*>(input.data()), input.size());
+    return parse_and_validate_metrics(sv, config, current_time_ms, scratch);
+}
+
+// Defined here rather than in validate_metrics.cpp: it drives JsonParser
+FusedMetricsResult parse_and_validate_metrics(std::string_view input,
+                                              const MetricsValidationConfig& config,
+                                              std::uint64_t current_time_ms,
+                                              ParsedMetrics& scratch) noexcept {
+    // Binary bodies are cheap to decode in full; validate afterwards
+    const auto bytes = std::as_bytes(std::span(input.data(), input.size()));
+    if (is_binary_body(bytes)) {
+        if (auto drop = parse_binary_metrics(bytes, scratch)) {
+            return *drop;
+        }
+        auto r = validate_metrics(scratch, config, current_time_ms);
+        if (const auto* drop = std::get_if<MetricsValidationDrop>(&r)) {
+            return *drop;
+        }
+        return std::get<ValidatedMetrics>(r);
+    }
+
+    JsonParser parser(input, &config, current_time_ms);
+    if (auto failure = parser.parse(scratch)) {
+        return std::visit([](auto reason) -> FusedMetricsResult { return reason; }, *failure);
+    }
+
+    ValidatedMetrics result;
+    result.agent_id = scratch.agent_id;
+    result.seq = scratch.seq;
+    result.ts = scratch.ts;
+    result.metrics = scratch.metrics.data();
+    result.metric_count = scratch.metric_count;
+    result.tags = scratch.tags.data();
+    return result;
 }
 
 } // namespace gateway
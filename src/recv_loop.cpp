@@ -1,5 +1,6 @@
 #include "gateway/recv_loop.hpp"
 
+#include <algorithm>  // std::clamp
 #include <cerrno>
 #include <cstring>  // memset
 
@@ -8,14 +9,353 @@
 #include <netinet/in.h>
 #include <netinet/ip.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <fcntl.h>
+#include <poll.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// recvmmsg is Linux-specific; other platforms fall back to recv_one() loops
+#if defined(__linux__)
+#define RECVMMSG_SUPPORTED 1
+#else
+#define RECVMMSG_SUPPORTED 0
+#endif
+
+// io_uring through raw syscalls (no liburing). Multishot recvmsg with a
+// provided-buffer ring needs the 6.0+ UAPI; older headers build without
+// the backend and RecvBackend::IoUring always falls back.
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// IORING_RECV_MULTISHOT (6.0) implies the provided-buffer ring UAPI (5.19)
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define URING_SUPPORTED 1
+#endif
+#endif
+#ifndef URING_SUPPORTED
+#define URING_SUPPORTED 0
+#endif
+
 namespace gateway {
 
+namespace {
+
+// Upper bound on recvmmsg vlen (matches the kernel's UIO_MAXIOV)
+constexpr std::size_t kMaxBatchSize = 1024;
+
+// Clamp batch/pool sizes so a batch always fits in the pool
+RecvConfig normalize(RecvConfig config) noexcept {
+    config.batch_size = std::clamp<std::size_t>(config.batch_size, 1, kMaxBatchSize);
+    config.buffer_pool_size = std::max(config.buffer_pool_size, config.batch_size);
+    return config;
+}
+
+#if URING_SUPPORTED
+// A multishot recvmsg buffer starts with the kernel's io_uring_recvmsg_out
+// header and the source address, then the payload
+constexpr std::size_t kUringPrefixBytes = sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in);
+constexpr std::uint64_t kRecvUserData = 1;
+#else
+constexpr std::size_t kUringPrefixBytes = 0;
+#endif
+
+// Pool buffers carry the io_uring prefix when that backend may be used,
+// so the payload region is exactly max_datagram_bytes on either path
+std::size_t pool_buffer_bytes(const RecvConfig& config) noexcept {
+    return config.max_datagram_bytes +
+           (config.backend == RecvBackend::IoUring ? kUringPrefixBytes : 0);
+}
+
+}  // namespace
+
+#if URING_SUPPORTED
+
+// ============================================================================
+// io_uring receive state
+//
+// One SQ entry is ever in flight: the multishot recvmsg (re-armed when a
+// completion arrives without IORING_CQE_F_MORE, e.g. after ENOBUFS). The
+// provided-buffer ring holds up to `entries` pooled buffers lent to the
+// kernel; buffer id i is backed by lent[i]. A completion moves lent[i]
+// into the Datagram and frees id i, which is refilled from the pool at
+// the next recv_batch() call.
+//
+// Invariants:
+// - Every buffer the kernel can write to is owned by `lent` (pool memory
+//   stays valid until the buffer ring is unregistered in the destructor)
+// - No allocation after construction
+// ============================================================================
+
+struct RecvLoop::UringState {
+    int ring_fd = -1;
+
+    void* sq_ring = MAP_FAILED;
+    std::size_t sq_ring_bytes = 0;
+    void* cq_ring = MAP_FAILED;
+    std::size_t cq_ring_bytes = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqes_bytes = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    io_uring_buf_ring* buf_ring = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    std::size_t buf_ring_bytes = 0;
+    bool buf_ring_registered = false;
+    std::uint16_t entries = 0;           // buffer ring size (power of two)
+    std::uint16_t buf_tail = 0;          // our copy of buf_ring->tail
+    std::vector<BufferHandle> lent;      // by buffer id
+    std::vector<std::uint16_t> free_ids; // ids whose buffer was consumed
+
+    msghdr msg{};                        // multishot template: name only
+    bool armed = false;
+    bool delivered = false;              // at least one completion succeeded
+
+    ~UringState() {
+        if (buf_ring_registered) {
+            io_uring_buf_reg reg{};
+            reg.bgid = 0;
+            syscall(__NR_io_uring_register, ring_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        }
+        if (ring_fd >= 0) {
+            close(ring_fd);
+        }
+        if (buf_ring != MAP_FAILED) munmap(buf_ring, buf_ring_bytes);
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_bytes);
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_bytes);
+        if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_bytes);
+    }
+
+    bool init(std::size_t batch_size) {
+        entries = 1;
+        while (entries < batch_size && entries < 32768) {
+            entries = static_cast<std::uint16_t>(entries * 2);
+        }
+
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = std::max<unsigned>(2u * entries, 64);
+#ifdef IORING_SETUP_COOP_TASKRUN
+        // Completions are processed at our next io_uring_enter instead of
+        // interrupting the thread
+        params.flags |= IORING_SETUP_COOP_TASKRUN;
+#endif
+        ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, 4, &params));
+        if (ring_fd < 0 && errno == EINVAL) {
+            params = io_uring_params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = std::max<unsigned>(2u * entries, 64);
+            ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, 4, &params));
+        }
+        if (ring_fd < 0) {
+            return false;
+        }
+
+        sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_bytes = cq_ring_bytes = std::max(sq_ring_bytes, cq_ring_bytes);
+        }
+        sq_ring = mmap(nullptr, sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED) {
+            return false;
+        }
+        cq_ring = single_mmap ? sq_ring
+            : mmap(nullptr, cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            return false;
+        }
+        sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_bytes, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        auto* sq = static_cast<std::byte*>(sq_ring);
+        auto* cq = static_cast<std::byte*>(cq_ring);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // Provided-buffer ring: page-aligned memory we own, registered as group 0
+        buf_ring_bytes = entries * sizeof(io_uring_buf);
+        buf_ring = static_cast<io_uring_buf_ring*>(mmap(nullptr, buf_ring_bytes, PROT_READ | PROT_WRITE,
+                                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (buf_ring == MAP_FAILED) {
+            return false;
+        }
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<std::uint64_t>(buf_ring);
+        reg.ring_entries = entries;
+        reg.bgid = 0;
+        if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            return false;
+        }
+        buf_ring_registered = true;
+
+        lent.resize(entries);
+        free_ids.reserve(entries);
+        for (std::uint16_t id = entries; id > 0; --id) {
+            free_ids.push_back(static_cast<std::uint16_t>(id - 1));
+        }
+
+        // Kernel writes the source address into each buffer's prefix
+        msg.msg_namelen = sizeof(sockaddr_in);
+        return true;
+    }
+
+    // Entry i of the buffer ring. Not buf_ring->bufs[i]: in C++ the UAPI's
+    // __DECLARE_FLEX_ARRAY wrapper puts `bufs` at offset 8 instead of 0.
+    io_uring_buf& ring_buf(unsigned i) noexcept {
+        return reinterpret_cast<io_uring_buf*>(buf_ring)[i];
+    }
+
+    // Lend free pool buffers to the kernel for every consumed id
+    void refill(BufferPool& pool) noexcept {
+        std::uint16_t added = 0;
+        while (!free_ids.empty()) {
+            BufferHandle handle = pool.acquire();
+            if (!handle) {
+                break;
+            }
+            const std::uint16_t id = free_ids.back();
+            free_ids.pop_back();
+            const std::span<std::byte> bytes = handle.bytes();
+            io_uring_buf& buf = ring_buf((buf_tail + added) & (entries - 1));
+            buf.addr = reinterpret_cast<std::uint64_t>(bytes.data());
+            buf.len = static_cast<std::uint32_t>(bytes.size());
+            buf.bid = id;
+            lent[id] = std::move(handle);
+            ++added;
+        }
+        if (added != 0) {
+            buf_tail = static_cast<std::uint16_t>(buf_tail + added);
+            __atomic_store_n(&buf_ring->tail, buf_tail, __ATOMIC_RELEASE);
+        }
+    }
+
+    // Queue the multishot recvmsg (submitted by the next enter())
+    void prepare_recv(int fd) noexcept {
+        const unsigned tail = *sq_tail;
+        const unsigned index = tail & *sq_mask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_RECVMSG;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uint64_t>(&msg);
+        sqe.len = 1;
+        sqe.msg_flags = MSG_TRUNC;       // payloadlen reports the real size
+        sqe.ioprio = IORING_RECV_MULTISHOT;
+        sqe.flags = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = 0;
+        sqe.user_data = kRecvUserData;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        armed = true;
+    }
+
+    [[nodiscard]] bool completions_pending() const noexcept {
+        return *cq_head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    }
+
+    // Submit `to_submit` entries and, if `wait`, wait for one completion
+    // (wait_ns < 0: indefinitely). Returns false on a hard error.
+    bool enter(unsigned to_submit, bool wait, std::int64_t wait_ns) noexcept {
+        unsigned flags = IORING_ENTER_GETEVENTS;
+        io_uring_getevents_arg arg{};
+        __kernel_timespec ts{};
+        const void* argp = nullptr;
+        std::size_t argsz = 0;
+        if (wait && wait_ns >= 0) {
+            ts.tv_sec = wait_ns / 1'000'000'000;
+            ts.tv_nsec = wait_ns % 1'000'000'000;
+            arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+            flags |= IORING_ENTER_EXT_ARG;
+            argp = &arg;
+            argsz = sizeof(arg);
+        }
+        const long r = syscall(__NR_io_uring_enter, ring_fd, to_submit, wait ? 1u : 0u, flags, argp, argsz);
+        return r >= 0 || errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY;
+    }
+};
+
+#else
+
+struct RecvLoop::UringState {};
+
+#endif  // URING_SUPPORTED
+
+// One slot per datagram: kernel writes the source address into these
+// preallocated arrays and the bytes into pooled buffers, so recv_batch()
+// never allocates.
+struct RecvLoop::BatchState {
+#if RECVMMSG_SUPPORTED
+    std::vector<mmsghdr> msgs;
+    std::vector<iovec> iovs;
+    std::vector<sockaddr_in> addrs;
+#endif
+    std::vector<BufferHandle> handles;  // buffers lent to the kernel per call
+};
+
 RecvLoop::RecvLoop(int fd, RecvConfig config)
     : fd_(fd)
-    , config_(config)
-    , buffer_(config.max_datagram_bytes) {}
+    , config_(normalize(config))
+    , pool_(config_.buffer_pool_size, pool_buffer_bytes(config_))
+    , batch_(std::make_unique<BatchState>())
+    , batch_results_(config_.batch_size) {
+    const int fl = fcntl(fd_, F_GETFL, 0);
+    blocking_ = fl >= 0 && (fl & O_NONBLOCK) == 0;
+
+#if URING_SUPPORTED
+    if (config_.backend == RecvBackend::IoUring) {
+        uring_ = std::make_unique<UringState>();
+        if (uring_->init(config_.batch_size)) {
+            backend_ = RecvBackend::IoUring;
+        } else {
+            uring_.reset();
+        }
+    }
+#endif
+
+    const std::size_t slots = config_.batch_size;
+
+    batch_->handles.resize(slots);
+#if RECVMMSG_SUPPORTED
+    batch_->msgs.resize(slots);
+    batch_->iovs.resize(slots);
+    batch_->addrs.resize(slots);
+    for (std::size_t i = 0; i < slots; ++i) {
+        std::memset(&batch_->msgs[i], 0, sizeof(mmsghdr));
+        batch_->msgs[i].msg_hdr.msg_iov = &batch_->iovs[i];
+        batch_->msgs[i].msg_hdr.msg_iovlen = 1;
+        batch_->msgs[i].msg_hdr.msg_name = &batch_->addrs[i];
+    }
+#endif
+}
+
+// Members declared after pool_ (batch_, batch_results_) are destroyed
+// first, so every held buffer returns to the pool before it goes away.
+RecvLoop::~RecvLoop() = default;
 
 bool RecvLoop::configure_socket() {
     // Set receive buffer size
@@ -33,6 +373,15 @@ bool RecvLoop::configure_socket() {
     }
 #endif
 
+    // Busy-poll the device queue during blocking waits (needs CAP_NET_ADMIN
+    // above net.core.busy_read); non-fatal, the wait just sleeps instead
+#ifdef SO_BUSY_POLL
+    if (config_.busy_poll_us > 0) {
+        int busy_poll = config_.busy_poll_us;
+        (void)setsockopt(fd_, SOL_SOCKET, SO_BUSY_POLL, &busy_poll, sizeof(busy_poll));
+    }
+#endif
+
     return true;
 }
 
@@ -40,6 +389,15 @@ RecvResult RecvLoop::recv_one() {
     RecvResult result{};
     result.status = RecvStatus::Error;
 
+    BufferHandle handle = pool_.acquire();
+    if (!handle) {
+        // Leave the datagram in the kernel queue rather than allocate
+        result.status = RecvStatus::NoBuffer;
+        ++metrics_.no_buffer;
+        return result;
+    }
+    std::span<std::byte> buffer = handle.bytes().first(config_.max_datagram_bytes);
+
     sockaddr_in src_addr{};
     socklen_t addr_len = sizeof(src_addr);
 
@@ -47,8 +405,8 @@ RecvResult RecvLoop::recv_one() {
     // This lets us detect oversized packets
     ssize_t n = recvfrom(
         fd_,
-        buffer_.data(),
-        buffer_.size(),
+        buffer.data(),
+        buffer.size(),
         MSG_TRUNC,
         reinterpret_cast<sockaddr*>(&src_addr),
         &addr_len
@@ -66,15 +424,16 @@ RecvResult RecvLoop::recv_one() {
     }
 
     // Check for truncation (packet was larger than buffer)
-    if (static_cast<std::size_t>(n) > buffer_.size()) {
+    if (static_cast<std::size_t>(n) > buffer.size()) {
         result.status = RecvStatus::Truncated;
         ++metrics_.truncated;
         return result;
     }
 
-    // Success: copy data and extract source
+    // Success: hand out a view of the pooled buffer and extract source
     result.status = RecvStatus::Ok;
-    result.datagram.data.assign(buffer_.begin(), buffer_.begin() + n);
+    result.datagram.data = buffer.first(static_cast<std::size_t>(n));
+    result.datagram.buffer = std::move(handle);
     result.datagram.source.ip = ntohl(src_addr.sin_addr.s_addr);
     result.datagram.source.port = ntohs(src_addr.sin_port);
 
@@ -82,7 +441,255 @@ RecvResult RecvLoop::recv_one() {
     return result;
 }
 
-int create_udp_socket(std::uint16_t port) {
+void RecvLoop::release_batch() noexcept {
+    for (auto& r : batch_results_) {
+        r.datagram = Datagram{};
+    }
+}
+
+bool RecvLoop::wait_readable(std::int64_t wait_ns) noexcept {
+    pollfd pfd{};
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(wait_ns / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(wait_ns % 1'000'000'000);
+    return ppoll(&pfd, 1, wait_ns < 0 ? nullptr : &ts, nullptr) > 0;
+}
+
+std::span<RecvResult> RecvLoop::recv_batch() {
+    if (backend_ == RecvBackend::IoUring) {
+        return recv_batch_uring(blocking_ ? -1 : 0);
+    }
+    return recv_batch_mmsg();
+}
+
+std::span<RecvResult> RecvLoop::recv_batch(std::chrono::microseconds max_wait) {
+    const std::int64_t wait_ns = std::max<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(max_wait).count(), 0);
+    if (backend_ == RecvBackend::IoUring) {
+        return recv_batch_uring(wait_ns);
+    }
+    if (wait_ns == 0 && blocking_) {
+        // Never block: only receive what is already queued
+        if (!wait_readable(0)) {
+            release_batch();
+            return {};
+        }
+    } else if (wait_ns > 0 && !wait_readable(wait_ns)) {
+        release_batch();
+        return {};
+    }
+    return recv_batch_mmsg();
+}
+
+std::span<RecvResult> RecvLoop::recv_batch_mmsg() {
+    // Return buffers still held by the previous batch
+    release_batch();
+
+#if RECVMMSG_SUPPORTED
+    // Lend up to batch_size pooled buffers to the kernel
+    std::size_t slots = 0;
+    while (slots < config_.batch_size) {
+        BufferHandle handle = pool_.acquire();
+        if (!handle) {
+            break;
+        }
+        std::span<std::byte> buffer = handle.bytes().first(config_.max_datagram_bytes);
+        batch_->iovs[slots].iov_base = buffer.data();
+        batch_->iovs[slots].iov_len = buffer.size();
+        batch_->handles[slots] = std::move(handle);
+
+        // Kernel overwrites namelen/flags on each call
+        batch_->msgs[slots].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        batch_->msgs[slots].msg_hdr.msg_flags = 0;
+        batch_->msgs[slots].msg_len = 0;
+        ++slots;
+    }
+
+    if (slots == 0) {
+        RecvResult& r = batch_results_[0];
+        r.status = RecvStatus::NoBuffer;
+        r.error_code = 0;
+        ++metrics_.no_buffer;
+        return std::span<RecvResult>(batch_results_.data(), 1);
+    }
+
+    // MSG_TRUNC: msg_len reports the real datagram size (oversize detection)
+    // MSG_WAITFORONE: on blocking sockets, return once at least one arrived
+    int n = recvmmsg(fd_, batch_->msgs.data(), static_cast<unsigned int>(slots),
+                     MSG_TRUNC | MSG_WAITFORONE, nullptr);
+
+    std::size_t count = 0;
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            RecvResult& r = batch_results_[0];
+            r.status = RecvStatus::Error;
+            r.error_code = errno;
+            ++metrics_.errors;
+            count = 1;
+        }
+    } else {
+        count = static_cast<std::size_t>(n);
+        for (std::size_t i = 0; i < count; ++i) {
+            const mmsghdr& msg = batch_->msgs[i];
+            RecvResult& r = batch_results_[i];
+            r.error_code = 0;
+
+            // TB-1: same oversize rule as recv_one()
+            if (msg.msg_len > config_.max_datagram_bytes ||
+                (msg.msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+                r.status = RecvStatus::Truncated;
+                ++metrics_.truncated;
+                continue;
+            }
+
+            r.status = RecvStatus::Ok;
+            r.datagram.data = batch_->handles[i].bytes().first(msg.msg_len);
+            r.datagram.buffer = std::move(batch_->handles[i]);
+            r.datagram.source.ip = ntohl(batch_->addrs[i].sin_addr.s_addr);
+            r.datagram.source.port = ntohs(batch_->addrs[i].sin_port);
+            ++metrics_.received;
+        }
+    }
+
+    // Unused and truncated slots go straight back to the pool
+    for (std::size_t i = 0; i < slots; ++i) {
+        batch_->handles[i].reset();
+    }
+
+    return std::span<RecvResult>(batch_results_.data(), count);
+#else
+    std::size_t count = 0;
+    while (count < config_.batch_size) {
+        RecvResult r = recv_one();
+        if (r.status == RecvStatus::WouldBlock) {
+            break;
+        }
+        const bool stop = r.status == RecvStatus::Error ||
+                          r.status == RecvStatus::NoBuffer;
+        batch_results_[count++] = std::move(r);
+        if (stop) {
+            break;
+        }
+    }
+    return std::span<RecvResult>(batch_results_.data(), count);
+#endif
+}
+
+void RecvLoop::fall_back_to_recvmmsg() noexcept {
+    uring_.reset();  // Unregisters the buffer ring; lent buffers return to the pool
+    backend_ = RecvBackend::Recvmmsg;
+}
+
+std::span<RecvResult> RecvLoop::recv_batch_uring(std::int64_t wait_ns) {
+    release_batch();
+
+#if URING_SUPPORTED
+    UringState& u = *uring_;
+    u.refill(pool_);
+    if (u.free_ids.size() == u.entries) {
+        // Every pooled buffer is held by the caller: nothing to lend
+        RecvResult& r = batch_results_[0];
+        r.status = RecvStatus::NoBuffer;
+        r.error_code = 0;
+        ++metrics_.no_buffer;
+        return std::span<RecvResult>(batch_results_.data(), 1);
+    }
+
+    // One syscall at most: submit a re-arm and/or collect completions.
+    // Skipped when completions are already waiting in the CQ ring.
+    unsigned to_submit = 0;
+    if (!u.armed) {
+        u.prepare_recv(fd_);
+        to_submit = 1;
+    }
+    if (to_submit != 0 || !u.completions_pending()) {
+        if (!u.enter(to_submit, false, 0)) {
+            fall_back_to_recvmmsg();
+            return recv_batch_mmsg();
+        }
+        if (!u.completions_pending() && wait_ns != 0 && !u.enter(0, true, wait_ns)) {
+            fall_back_to_recvmmsg();
+            return recv_batch_mmsg();
+        }
+    }
+
+    std::size_t count = 0;
+    unsigned head = *u.cq_head;
+    const unsigned tail = __atomic_load_n(u.cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail && count < config_.batch_size) {
+        const io_uring_cqe& cqe = u.cqes[head & *u.cq_mask];
+        if (cqe.user_data != kRecvUserData) {
+            ++head;
+            continue;
+        }
+        if (cqe.res < 0 && count != 0) {
+            break;  // Errors are reported alone, at the next call
+        }
+        ++head;
+        if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+            u.armed = false;  // Multishot ended; re-armed next call
+        }
+
+        RecvResult& r = batch_results_[count];
+        r.error_code = 0;
+        if (cqe.res < 0) {
+            if (cqe.res == -ENOBUFS) {
+                r.status = RecvStatus::NoBuffer;
+                ++metrics_.no_buffer;
+            } else if (!u.delivered && (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP)) {
+                // Kernel without multishot recvmsg: switch paths for good
+                __atomic_store_n(u.cq_head, head, __ATOMIC_RELEASE);
+                fall_back_to_recvmmsg();
+                return recv_batch_mmsg();
+            } else {
+                r.status = RecvStatus::Error;
+                r.error_code = -cqe.res;
+                ++metrics_.errors;
+            }
+            ++count;
+            break;
+        }
+        if ((cqe.flags & IORING_CQE_F_BUFFER) == 0) {
+            continue;
+        }
+        u.delivered = true;
+
+        const auto id = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        BufferHandle handle = std::move(u.lent[id]);
+        u.free_ids.push_back(id);
+        const std::span<std::byte> bytes = handle.bytes();
+        io_uring_recvmsg_out out;
+        std::memcpy(&out, bytes.data(), sizeof(out));
+        sockaddr_in src{};
+        std::memcpy(&src, bytes.data() + sizeof(out), sizeof(src));
+
+        // TB-1: same oversize rule as recv_one()
+        if (out.payloadlen > config_.max_datagram_bytes || (out.flags & MSG_TRUNC) != 0) {
+            r.status = RecvStatus::Truncated;
+            ++metrics_.truncated;
+            ++count;
+            continue;  // handle returns to the pool
+        }
+
+        r.status = RecvStatus::Ok;
+        r.datagram.data = bytes.subspan(sizeof(out) + u.msg.msg_namelen, out.payloadlen);
+        r.datagram.buffer = std::move(handle);
+        r.datagram.source.ip = ntohl(src.sin_addr.s_addr);
+        r.datagram.source.port = ntohs(src.sin_port);
+        ++metrics_.received;
+        ++count;
+    }
+    __atomic_store_n(u.cq_head, head, __ATOMIC_RELEASE);
+    return std::span<RecvResult>(batch_results_.data(), count);
+#else
+    (void)wait_ns;
+    return recv_batch_mmsg();
+#endif
+}
+
+int create_udp_socket(std::uint16_t port, bool reuse_port) {
     int fd = socket(AF_INET, SOCK_DGRAM, 0);
     if (fd < 0) {
         return -1;
@@ -92,6 +699,18 @@ int create_udp_socket(std::uint16_t port) {
     int opt = 1;
     setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 
+    if (reuse_port) {
+#ifdef SO_REUSEPORT
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            close(fd);
+            return -1;
+        }
+#else
+        close(fd);
+        return -1;
+#endif
+    }
+
     sockaddr_in addr{};
     addr.sin_family = AF_INET;
     addr.sin_addr.s_addr = INADDR_ANY;
@@ -105,4 +724,50 @@ int create_udp_socket(std::uint16_t port) {
     return fd;
 }
 
+std::vector<int> create_reuseport_sockets(std::uint16_t port, std::size_t count) {
+    std::vector<int> fds;
+    fds.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        int fd = create_udp_socket(port, true);
+        if (fd < 0) {
+            for (int open_fd : fds) {
+                close(open_fd);
+            }
+            return {};
+        }
+        fds.push_back(fd);
+
+        // Port 0: the rest of the group must join the port the kernel chose
+        if (port == 0) {
+            sockaddr_in addr{};
+            socklen_t len = sizeof(addr);
+            if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+                for (int open_fd : fds) {
+                    close(open_fd);
+                }
+                return {};
+            }
+            port = ntohs(addr.sin_port);
+        }
+    }
+
+    return fds;
+}
+
+bool pin_current_thread_to_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
 }  // namespace gateway
@@ -0,0 +1,160 @@
+#include "gateway/seq_dedup.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <random>
+
+namespace gateway {
+
+namespace {
+
+// Signed distance from `from` to `to` in seq space (serial arithmetic)
+std::int32_t seq_delta(std::uint32_t to, std::uint32_t from) noexcept {
+    return static_cast<std::int32_t>(to - from);
+}
+
+}  // namespace
+
+SeqDeduplicator::SeqDeduplicator(DedupConfig config)
+    : seed_((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    , words_(std::bit_ceil(std::clamp<std::size_t>(config.window, 64, kMaxWindow)) / 64)
+    , entries_(std::max<std::size_t>(config.max_agents, 1))
+    , bits_(entries_.size() * words_, 0)
+    , index_(entries_.size()) {}
+
+std::size_t SeqDeduplicator::find_slot(std::string_view agent_id,
+                                       std::uint64_t hash) const noexcept {
+    return index_.find(index_.home(hash), [&](std::uint32_t n) {
+        const Entry& e = entries_[n];
+        return e.hash == hash && e.len == agent_id.size() &&
+               std::memcmp(e.id, agent_id.data(), agent_id.size()) == 0;
+    });
+}
+
+void SeqDeduplicator::clear_range(std::uint64_t* words, std::uint32_t from,
+                                  std::uint32_t count) const noexcept {
+    // A word at a time: at most window / 64 + 1 writes
+    const std::size_t bit_mask = words_ * 64 - 1;
+    while (count > 0) {
+        const std::size_t bit = from & bit_mask;
+        const std::uint32_t offset = bit & 63;
+        const std::uint32_t n = std::min<std::uint32_t>(64 - offset, count);
+        const std::uint64_t mask = n == 64 ? ~0ULL : ((1ULL << n) - 1) << offset;
+        words[bit >> 6] &= ~mask;
+        from += n;
+        count -= n;
+    }
+}
+
+void SeqDeduplicator::reset_window(std::uint32_t n, std::uint32_t seq) noexcept {
+    std::uint64_t* words = bitmap(n);
+    std::fill(words, words + words_, 0);
+    entries_[n].highest = seq;
+}
+
+DedupResult SeqDeduplicator::check(std::string_view agent_id, std::uint32_t seq) noexcept {
+    if (!seen(agent_id, seq)) {
+        return DedupResult::New;
+    }
+    ++duplicates_;
+    return DedupResult::Duplicate;
+}
+
+void SeqDeduplicator::commit(std::string_view agent_id, std::uint32_t seq) noexcept {
+    if (agent_id.size() > AgentIdRules::kMaxLength) {
+        return;
+    }
+    const std::uint64_t hash = hash_bytes(seed_, agent_id);
+    const std::size_t slot = find_slot(agent_id, hash);
+    const std::size_t window = words_ * 64;
+    std::uint32_t n = index_[slot];
+
+    if (n == kNil) {
+        if (size_ < entries_.size()) {
+            n = static_cast<std::uint32_t>(size_++);
+        } else {
+            // Full: recycle the least recently seen agent
+            n = lru_tail_;
+            lru_unlink(n);
+            index_.erase(index_.slot_of(index_.home(entries_[n].hash), n),
+                         [this](std::uint32_t m) { return index_.home(entries_[m].hash); });
+            ++evictions_;
+        }
+        Entry& e = entries_[n];
+        e.hash = hash;
+        e.len = static_cast<std::uint8_t>(agent_id.size());
+        std::memcpy(e.id, agent_id.data(), agent_id.size());
+        reset_window(n, seq);
+        // The slot found above may have moved if erase() shifted its run
+        index_.set(find_slot(agent_id, hash), n);
+    } else {
+        lru_unlink(n);
+        Entry& e = entries_[n];
+        const std::int32_t ahead = seq_delta(seq, e.highest);
+        if (ahead > 0) {
+            // Slide forward: seqs in (highest, seq] are new to the window
+            std::uint64_t* words = bitmap(n);
+            if (static_cast<std::size_t>(ahead) >= window) {
+                std::fill(words, words + words_, 0);
+            } else {
+                clear_range(words, e.highest + 1, static_cast<std::uint32_t>(ahead));
+            }
+            e.highest = seq;
+        } else if (static_cast<std::size_t>(-static_cast<std::int64_t>(ahead)) >= window) {
+            // Too far behind to be a retry: the agent restarted its counter
+            reset_window(n, seq);
+            ++resets_;
+        }
+    }
+    lru_push_front(n);
+
+    const std::size_t bit = seq & (window - 1);
+    bitmap(n)[bit >> 6] |= 1ULL << (bit & 63);
+}
+
+bool SeqDeduplicator::seen(std::string_view agent_id, std::uint32_t seq) const noexcept {
+    if (agent_id.size() > AgentIdRules::kMaxLength) {
+        return false;
+    }
+    const std::uint32_t n = index_[find_slot(agent_id, hash_bytes(seed_, agent_id))];
+    if (n == kNil) {
+        return false;
+    }
+    const std::size_t window = words_ * 64;
+    const std::int32_t ahead = seq_delta(seq, entries_[n].highest);
+    if (ahead > 0 || static_cast<std::size_t>(-static_cast<std::int64_t>(ahead)) >= window) {
+        return false;
+    }
+    const std::size_t bit = seq & (window - 1);
+    return (bitmap(n)[bit >> 6] >> (bit & 63) & 1) != 0;
+}
+
+void SeqDeduplicator::lru_unlink(std::uint32_t n) noexcept {
+    Entry& e = entries_[n];
+    if (e.prev != kNil) {
+        entries_[e.prev].next = e.next;
+    } else {
+        lru_head_ = e.next;
+    }
+    if (e.next != kNil) {
+        entries_[e.next].prev = e.prev;
+    } else {
+        lru_tail_ = e.prev;
+    }
+}
+
+void SeqDeduplicator::lru_push_front(std::uint32_t n) noexcept {
+    Entry& e = entries_[n];
+    e.prev = kNil;
+    e.next = lru_head_;
+    if (lru_head_ != kNil) {
+        entries_[lru_head_].prev = n;
+    }
+    lru_head_ = n;
+    if (lru_tail_ == kNil) {
+        lru_tail_ = n;
+    }
+}
+
+}  // namespace gateway
@@ -0,0 +1,309 @@
+#include "gateway/serialize.hpp"
+
+#include "gateway/aggregate.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+
+namespace gateway {
+
+namespace {
+
+// Per-byte escape: 0 = copy as is, 'u' = \u00XX, otherwise the character
+// written after the backslash
+constexpr std::array<char, 256> kEscape = [] {
+    std::array<char, 256> t{};
+    for (std::size_t c = 0; c < 0x20; ++c) {
+        t[c] = 'u';
+    }
+    t['\b'] = 'b';
+    t['\f'] = 'f';
+    t['\n'] = 'n';
+    t['\r'] = 'r';
+    t['\t'] = 't';
+    t['"'] = '"';
+    t['\\'] = '\\';
+    return t;
+}();
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// Longest std::to_chars output for a double (shortest round-trip form)
+constexpr std::size_t kMaxDoubleChars = 32;
+
+// Bounded output cursor; the first write that does not fit sets failed_
+// and turns every later write into a no-op
+class Writer {
+public:
+    explicit Writer(std::span<std::byte> out) noexcept
+        : begin_(reinterpret_cast<char*>(out.data()))
+        , pos_(begin_)
+        , end_(begin_ + out.size()) {}
+
+    // Bytes written, or 0 if anything did not fit
+    std::size_t finish() const noexcept {
+        return failed_ ? 0 : static_cast<std::size_t>(pos_ - begin_);
+    }
+
+    void raw(std::string_view s) noexcept {
+        if (!room(s.size())) {
+            return;
+        }
+        std::memcpy(pos_, s.data(), s.size());
+        pos_ += s.size();
+    }
+
+    void ch(char c) noexcept {
+        if (room(1)) {
+            *pos_++ = c;
+        }
+    }
+
+    void integer(std::uint64_t v) noexcept {
+        if (failed_) {
+            return;
+        }
+        auto [ptr, ec] = std::to_chars(pos_, end_, v);
+        if (ec != std::errc{}) {
+            failed_ = true;
+            return;
+        }
+        pos_ = ptr;
+    }
+
+    void number(double v) noexcept {
+        if (!std::isfinite(v)) {
+            raw("null");
+            return;
+        }
+        if (!room(kMaxDoubleChars)) {
+            // Might still fit; format aside and copy
+            char tmp[kMaxDoubleChars];
+            auto [ptr, ec] = std::to_chars(tmp, tmp + sizeof(tmp), v);
+            raw(ec == std::errc{} ? std::string_view(tmp, ptr - tmp) : std::string_view{});
+            return;
+        }
+        pos_ = std::to_chars(pos_, end_, v).ptr;
+    }
+
+    // Quoted, escaped JSON string
+    void str(std::string_view s) noexcept {
+        ch('"');
+        std::size_t i = 0;
+        while (i < s.size() && !failed_) {
+            // Copy the run of bytes that need no escape in one go
+            std::size_t run = i;
+            while (run < s.size() && kEscape[static_cast<unsigned char>(s[run])] == 0) {
+                ++run;
+            }
+            raw(s.substr(i, run - i));
+            if (run == s.size()) {
+                break;
+            }
+
+            const auto c = static_cast<unsigned char>(s[run]);
+            const char esc = kEscape[c];
+            if (esc == 'u') {
+                const char seq[] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF]};
+                raw(std::string_view(seq, sizeof(seq)));
+            } else {
+                const char seq[] = {'\\', esc};
+                raw(std::string_view(seq, sizeof(seq)));
+            }
+            i = run + 1;
+        }
+        ch('"');
+    }
+
+    // Rollback point for writing a prefix of repeated items
+    std::size_t offset() const noexcept { return static_cast<std::size_t>(pos_ - begin_); }
+    std::size_t remaining() const noexcept { return static_cast<std::size_t>(end_ - pos_); }
+    bool failed() const noexcept { return failed_; }
+    void rewind(std::size_t offset) noexcept {
+        pos_ = begin_ + offset;
+        failed_ = false;
+    }
+
+    // ,"key": (leading comma unless first)
+    void key(std::string_view k, bool first = false) noexcept {
+        if (!first) {
+            ch(',');
+        }
+        ch('"');
+        raw(k);
+        raw("\":");
+    }
+
+private:
+    bool room(std::size_t n) noexcept {
+        if (failed_ || static_cast<std::size_t>(end_ - pos_) < n) {
+            failed_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    char* begin_;
+    char* pos_;
+    char* end_;
+    bool failed_ = false;
+};
+
+void write_tags(Writer& w, std::span<const MetricTag> tags) noexcept {
+    w.key("t");
+    w.ch('{');
+    for (std::size_t t = 0; t < tags.size(); ++t) {
+        if (t > 0) {
+            w.ch(',');
+        }
+        w.str(tags[t].key);
+        w.ch(':');
+        w.str(tags[t].value);
+    }
+    w.ch('}');
+}
+
+bool is_dedicated_log_key(std::string_view key) noexcept {
+    return key == "ts" || key == "level" || key == "msg" || key == "agent";
+}
+
+}  // namespace
+
+std::size_t serialize_event(const ValidatedMetrics& metrics, std::span<std::byte> out) noexcept {
+    Writer w(out);
+    w.raw("{\"type\":\"metrics\"");
+    w.key("agent_id");
+    w.str(metrics.agent_id);
+    w.key("seq");
+    w.integer(metrics.seq);
+    w.key("ts");
+    w.integer(metrics.ts);
+    w.key("metrics");
+    w.ch('[');
+    for (std::size_t i = 0; i < metrics.metric_count; ++i) {
+        const Metric& m = metrics.metrics[i];
+        if (i > 0) {
+            w.ch(',');
+        }
+        w.ch('{');
+        w.key("n", true);
+        w.str(m.name);
+        w.key("v");
+        w.number(m.value);
+        if (!m.unit.empty()) {
+            w.key("u");
+            w.str(m.unit);
+        }
+        const auto tags = metrics.tags_of(m);
+        if (!tags.empty()) {
+            write_tags(w, tags);
+        }
+        w.ch('}');
+    }
+    w.raw("]}");
+    return w.finish();
+}
+
+std::size_t serialize_event(const ValidatedLog& log, std::span<std::byte> out) noexcept {
+    Writer w(out);
+    w.raw("{\"type\":\"log\"");
+    if (!log.agent_id.empty()) {
+        w.key("agent_id");
+        w.str(log.agent_id);
+    }
+    w.key("ts");
+    w.integer(log.ts);
+    w.key("level");
+    w.ch('"');
+    w.raw(log_level_to_string(log.level));
+    w.ch('"');
+    w.key("msg");
+    w.str(log.msg);
+
+    bool first = true;
+    for (std::size_t i = 0; i < log.field_count; ++i) {
+        const LogField& f = log.fields[i];
+        if (is_dedicated_log_key(f.key)) {
+            continue;
+        }
+        if (first) {
+            w.key("fields");
+            w.ch('{');
+        } else {
+            w.ch(',');
+        }
+        first = false;
+        w.str(f.key);
+        w.ch(':');
+        w.str(f.value);
+    }
+    if (!first) {
+        w.ch('}');
+    }
+    w.ch('}');
+    return w.finish();
+}
+
+std::size_t serialize_rollup(const RollupEvent& rollup, std::span<std::byte> out,
+                             std::size_t& written) noexcept {
+    written = 0;
+    Writer w(out);
+    w.raw("{\"type\":\"rollup\"");
+    w.key("agent_id");
+    w.str(rollup.agent_id);
+    w.key("ts");
+    w.integer(rollup.ts);
+    w.key("interval_ms");
+    w.integer(rollup.interval_ms);
+    w.key("metrics");
+    w.ch('[');
+    for (const RollupSeries& s : rollup.series) {
+        const std::size_t mark = w.offset();
+        if (written > 0) {
+            w.ch(',');
+        }
+        w.ch('{');
+        w.key("n", true);
+        w.str(s.name);
+        if (!s.unit.empty()) {
+            w.key("u");
+            w.str(s.unit);
+        }
+        if (!s.tags.empty()) {
+            write_tags(w, s.tags);
+        }
+        w.key("count");
+        w.integer(s.count);
+        w.key("sum");
+        w.number(s.sum);
+        w.key("min");
+        w.number(s.min);
+        w.key("max");
+        w.number(s.max);
+        if (rollup.quantiles) {
+            w.key("p50");
+            w.number(s.p50);
+            w.key("p90");
+            w.number(s.p90);
+            w.key("p99");
+            w.number(s.p99);
+        }
+        w.ch('}');
+        // Keep room for the closing "]}"
+        if (w.failed() || w.remaining() < 2) {
+            w.rewind(mark);
+            break;
+        }
+        ++written;
+    }
+    if (written == 0) {
+        return 0;
+    }
+    w.raw("]}");
+    return w.finish();
+}
+
+}  // namespace gateway
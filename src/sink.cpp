@@ -0,0 +1,213 @@
+#include "gateway/sink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace gateway {
+
+namespace {
+
+// Linux IOV_MAX; one writev never takes more entries than this
+constexpr std::size_t kMaxIov = 1024;
+
+const std::byte kNewline{'\n'};
+
+iovec make_iov(const std::byte* data, std::size_t len) noexcept {
+    // writev never writes through iov_base; the cast only satisfies the ABI
+    return iovec{const_cast<std::byte*>(data), len};
+}
+
+using Clock = std::chrono::steady_clock;
+
+}  // namespace
+
+// ============================================================================
+// BufferedFdSink Implementation
+// ============================================================================
+
+BufferedFdSink::BufferedFdSink(int fd, BufferedSinkConfig config)
+    : fd_(fd)
+    , config_(config)
+    , buffer_(std::max<std::size_t>(config.max_buffered_bytes, 1))
+    , iov_(kMaxIov) {}
+
+BufferedFdSink::~BufferedFdSink() {
+    flush();
+}
+
+bool BufferedFdSink::write(std::span<const std::byte> payload) noexcept {
+    return write_batch(std::span<const std::span<const std::byte>>(&payload, 1)) == 1;
+}
+
+std::size_t BufferedFdSink::write_batch(
+    std::span<const std::span<const std::byte>> payloads) noexcept {
+    std::size_t incoming = 0;
+    for (const auto& payload : payloads) {
+        incoming += payload.size() + 1;  // + newline
+    }
+
+    if (used_ + incoming > buffer_.size()) {
+        // Would overflow the buffer: send buffered bytes and this batch
+        // together, straight from the callers' payloads
+        write_through(payloads);
+    } else {
+        for (const auto& payload : payloads) {
+            append(payload);
+        }
+        if (used_ >= config_.max_buffered_bytes ||
+            buffered_events_ >= config_.max_buffered_events ||
+            Clock::now() - oldest_ >= config_.max_delay) {
+            flush();
+        }
+    }
+
+    write_count_ += payloads.size();
+    return payloads.size();
+}
+
+void BufferedFdSink::flush() noexcept {
+    if (used_ == 0) {
+        return;
+    }
+    iov_[0] = make_iov(buffer_.data(), used_);
+    if (!write_iov(1)) {
+        dropped_events_ += buffered_events_;
+    }
+    used_ = 0;
+    buffered_events_ = 0;
+}
+
+void BufferedFdSink::append(std::span<const std::byte> payload) noexcept {
+    if (buffered_events_ == 0) {
+        oldest_ = Clock::now();
+    }
+    std::memcpy(buffer_.data() + used_, payload.data(), payload.size());
+    used_ += payload.size();
+    buffer_[used_++] = kNewline;
+    ++buffered_events_;
+}
+
+void BufferedFdSink::write_through(std::span<const std::span<const std::byte>> payloads) noexcept {
+    std::size_t count = 0;
+    std::size_t events = 0;  // events covered by iov_[0, count)
+    if (used_ > 0) {
+        iov_[count++] = make_iov(buffer_.data(), used_);
+        events = buffered_events_;
+    }
+    for (const auto& payload : payloads) {
+        if (count + 2 > kMaxIov) {
+            if (!write_iov(count)) {
+                dropped_events_ += events;
+            }
+            count = 0;
+            events = 0;
+        }
+        iov_[count++] = make_iov(payload.data(), payload.size());
+        iov_[count++] = make_iov(&kNewline, 1);
+        ++events;
+    }
+    if (count > 0 && !write_iov(count)) {
+        dropped_events_ += events;
+    }
+    used_ = 0;
+    buffered_events_ = 0;
+}
+
+bool BufferedFdSink::write_iov(std::size_t count) noexcept {
+    iovec* iov = iov_.data();
+    while (count > 0) {
+        ++syscall_count_;
+        const ssize_t n = ::writev(fd_, iov, static_cast<int>(count));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        // Partial write: skip fully written entries, trim the next one
+        auto remaining = static_cast<std::size_t>(n);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// BufferedSink Implementation
+// ============================================================================
+
+BufferedSink::BufferedSink(std::unique_ptr<Sink> inner, BufferedSinkConfig config)
+    : inner_(std::move(inner))
+    , config_(config)
+    , arena_(std::max<std::size_t>(config.max_buffered_bytes, 1)) {
+    config_.max_buffered_events = std::max<std::size_t>(config_.max_buffered_events, 1);
+    pending_.reserve(config_.max_buffered_events);
+}
+
+BufferedSink::~BufferedSink() {
+    flush();
+}
+
+bool BufferedSink::write(std::span<const std::byte> payload) noexcept {
+    return write_batch(std::span<const std::span<const std::byte>>(&payload, 1)) == 1;
+}
+
+std::size_t BufferedSink::write_batch(
+    std::span<const std::span<const std::byte>> payloads) noexcept {
+    for (const auto& payload : payloads) {
+        if (payload.size() > arena_.size()) {
+            // Too large to buffer: keep ordering, then pass it through
+            flush_pending();
+            if (!inner_->write(payload)) {
+                ++dropped_events_;
+            }
+            continue;
+        }
+        if (used_ + payload.size() > arena_.size() ||
+            pending_.size() >= config_.max_buffered_events) {
+            flush_pending();
+        }
+        if (pending_.empty()) {
+            oldest_ = Clock::now();
+        }
+        std::memcpy(arena_.data() + used_, payload.data(), payload.size());
+        pending_.emplace_back(arena_.data() + used_, payload.size());
+        used_ += payload.size();
+    }
+
+    if (pending_.size() >= config_.max_buffered_events ||
+        used_ >= config_.max_buffered_bytes ||
+        (!pending_.empty() && Clock::now() - oldest_ >= config_.max_delay)) {
+        flush_pending();
+    }
+    return payloads.size();
+}
+
+void BufferedSink::flush() noexcept {
+    flush_pending();
+    inner_->flush();
+}
+
+void BufferedSink::flush_pending() noexcept {
+    if (pending_.empty()) {
+        return;
+    }
+    const std::size_t ok = inner_->write_batch(pending_);
+    dropped_events_ += pending_.size() - std::min(ok, pending_.size());
+    ++batches_flushed_;
+    pending_.clear();
+    used_ = 0;
+}
+
+}  // namespace gateway
@@ -1,6 +1,9 @@
 #include "gateway/source_limiter.hpp"
+#include "gateway/hash_index.hpp"
 
 #include <algorithm>  // std::min
+#include <bit>
+#include <random>
 
 namespace gateway {
 
@@ -9,8 +12,10 @@ SourceLimiter::SourceLimiter(SourceLimiterConfig config, Clock clock)
     , clock_(std::move(clock)) {}
 
 Admit SourceLimiter::admit(const SourceKey& source) {
-    auto now = clock_();
+    return admit(source, clock_());
+}
 
+Admit SourceLimiter::admit(const SourceKey& source, std::chrono::steady_clock::time_point now) {
     auto it = sources_.find(source);
     if (it == sources_.end()) {
         // New source: evict if at capacity
@@ -36,7 +41,7 @@ Admit SourceLimiter::admit(const SourceKey& source) {
     }
 
     // Refill tokens based on elapsed time
-    refill_bucket(it->second.bucket);
+    refill_bucket(it->second.bucket, now);
 
     // Try to consume a token
     if (it->second.bucket.tokens >= 1.0) {
@@ -49,8 +54,30 @@ Admit SourceLimiter::admit(const SourceKey& source) {
     return Admit::Drop;
 }
 
-void SourceLimiter::refill_bucket(Bucket& bucket) {
-    auto now = clock_();
+std::size_t SourceLimiter::admit_batch(std::span<const SourceKey> sources,
+                                       std::span<Admit> out) {
+    const auto now = clock_();
+    const std::size_t n = std::min(sources.size(), out.size());
+    std::size_t allowed = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = admit(sources[i], now);
+        allowed += out[i] == Admit::Allow;
+    }
+    return allowed;
+}
+
+void SourceLimiter::reconfigure(const SourceLimiterConfig& config) {
+    config_ = config;
+    while (sources_.size() > config_.max_sources) {
+        evict_lru();
+    }
+    const double burst = static_cast<double>(config_.burst_tokens);
+    for (auto& [key, entry] : sources_) {
+        entry.bucket.tokens = std::min(entry.bucket.tokens, burst);
+    }
+}
+
+void SourceLimiter::refill_bucket(Bucket& bucket, std::chrono::steady_clock::time_point now) {
     auto elapsed = std::chrono::duration<double>(now - bucket.last_update);
     double tokens_to_add = elapsed.count() * config_.tokens_per_sec;
 
@@ -80,4 +107,283 @@ bool SourceLimiter::is_tracked(const SourceKey& source) const {
     return sources_.find(source) != sources_.end();
 }
 
+// ============================================================================
+// FlatSourceLimiter Implementation
+// ============================================================================
+
+namespace {
+
+std::int64_t to_ns(std::chrono::steady_clock::time_point t) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+// Time to refill an empty bucket of `burst` nano-tokens
+std::int64_t full_refill_ns(std::uint64_t burst, std::uint32_t tokens_per_sec) noexcept {
+    return tokens_per_sec == 0
+               ? INT64_MAX
+               : static_cast<std::int64_t>((burst + tokens_per_sec - 1) / tokens_per_sec);
+}
+
+}  // namespace
+
+FlatSourceLimiter::FlatSourceLimiter(SourceLimiterConfig config, Clock clock)
+    : config_(config)
+    , clock_(std::move(clock))
+    , seed_((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}())
+    , burst_(static_cast<std::uint64_t>(config.burst_tokens) * kTokenScale)
+    , full_refill_ns_(full_refill_ns(burst_, config.tokens_per_sec))
+    , nodes_(std::max<std::size_t>(config.max_sources, 1))
+    , index_(std::bit_ceil(nodes_.size() * 2), kNil)
+    , index_mask_(index_.size() - 1) {
+    // Free list threads all nodes through `next`
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+        nodes_[i].next = i + 1 < nodes_.size() ? static_cast<std::uint32_t>(i + 1) : kNil;
+    }
+    free_head_ = 0;
+}
+
+std::uint64_t FlatSourceLimiter::hash(const SourceKey& key) const noexcept {
+    // Seeded murmur3 finalizer: sources are attacker-chosen, so collisions
+    // must not be predictable from the key alone
+    return hash_mix(((static_cast<std::uint64_t>(key.ip) << 16) | key.port) ^ seed_);
+}
+
+std::size_t FlatSourceLimiter::find_slot(const SourceKey& key, std::size_t home) const noexcept {
+    // Load factor <= 0.5 guarantees an empty slot terminates the probe
+    std::size_t slot = home;
+    while (index_[slot] != kNil && !(nodes_[index_[slot]].key == key)) {
+        slot = (slot + 1) & index_mask_;
+    }
+    return slot;
+}
+
+Admit FlatSourceLimiter::admit(const SourceKey& source) {
+    return admit(source, clock_());
+}
+
+Admit FlatSourceLimiter::admit(const SourceKey& source,
+                               std::chrono::steady_clock::time_point now) noexcept {
+    Admit result;
+    admit_run(source, hash(source) & index_mask_, 1, to_ns(now), &result);
+    return result;
+}
+
+std::size_t FlatSourceLimiter::admit_batch(std::span<const SourceKey> sources,
+                                           std::span<Admit> out) noexcept {
+    const std::int64_t now_ns = to_ns(clock_());
+    const std::size_t total = std::min(sources.size(), out.size());
+    std::size_t allowed = 0;
+
+    // Work in chunks: hash + prefetch index slots for the whole chunk,
+    // then process runs while prefetching nodes a few packets ahead
+    constexpr std::size_t kChunk = 32;
+    constexpr std::size_t kNodeLookahead = 4;
+    std::size_t homes[kChunk];
+
+    for (std::size_t base = 0; base < total; base += kChunk) {
+        const std::size_t m = std::min(kChunk, total - base);
+        const SourceKey* keys = sources.data() + base;
+
+        for (std::size_t j = 0; j < m; ++j) {
+            homes[j] = hash(keys[j]) & index_mask_;
+            prefetch(&index_[homes[j]]);
+        }
+
+        std::size_t j = 0;
+        while (j < m) {
+            if (j + kNodeLookahead < m) {
+                const std::uint32_t ahead = index_[homes[j + kNodeLookahead]];
+                if (ahead != kNil) {
+                    prefetch(&nodes_[ahead]);
+                }
+            }
+            // Group the run of identical consecutive sources
+            std::size_t run = 1;
+            while (j + run < m && keys[j + run] == keys[j]) {
+                ++run;
+            }
+            allowed += admit_run(keys[j], homes[j], run, now_ns, out.data() + base + j);
+            j += run;
+        }
+    }
+    return allowed;
+}
+
+std::size_t FlatSourceLimiter::admit_run(const SourceKey& source, std::size_t home,
+                                         std::size_t count, std::int64_t now_ns,
+                                         Admit* out) noexcept {
+    std::size_t slot = find_slot(source, home);
+    std::uint32_t n = index_[slot];
+    if (n == kNil) {
+        // New source: evict if at capacity
+        if (size_ >= nodes_.size()) {
+            evict_lru();
+            slot = find_slot(source, home);  // eviction may have shifted the run
+        }
+        n = free_head_;
+        free_head_ = nodes_[n].next;
+        nodes_[n] = Node{.key = source, .prev = kNil, .next = kNil,
+                         .tokens = burst_, .last_ns = now_ns};
+        index_[slot] = n;
+        ++size_;
+        lru_push_front(n);
+    } else if (n != lru_head_) {
+        // Existing source: move to front of LRU
+        lru_unlink(n);
+        lru_push_front(n);
+    }
+
+    Node& node = nodes_[n];
+    refill(node, now_ns);
+
+    // Consume one token per packet while they last; the rest are dropped
+    const std::uint64_t available = node.tokens / kTokenScale;
+    const std::size_t allowed = available < count ? static_cast<std::size_t>(available) : count;
+    node.tokens -= static_cast<std::uint64_t>(allowed) * kTokenScale;
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = i < allowed ? Admit::Allow : Admit::Drop;
+    }
+
+    total_admits_ += allowed;
+    total_drops_ += count - allowed;
+    return allowed;
+}
+
+void FlatSourceLimiter::refill(Node& node, std::int64_t now_ns) const noexcept {
+    const std::int64_t elapsed = now_ns - node.last_ns;
+    if (elapsed <= 0) {
+        return;  // Clock regression: no refill, keep the later timestamp
+    }
+    node.last_ns = now_ns;
+    if (elapsed >= full_refill_ns_) {
+        node.tokens = burst_;
+        return;
+    }
+    // elapsed < full_refill_ns_ bounds the product by ~burst_ (no overflow)
+    const std::uint64_t add = static_cast<std::uint64_t>(elapsed) * config_.tokens_per_sec;
+    node.tokens = std::min(node.tokens + add, burst_);
+}
+
+void FlatSourceLimiter::lru_unlink(std::uint32_t n) noexcept {
+    Node& node = nodes_[n];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        lru_head_ = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    } else {
+        lru_tail_ = node.prev;
+    }
+}
+
+void FlatSourceLimiter::lru_push_front(std::uint32_t n) noexcept {
+    Node& node = nodes_[n];
+    node.prev = kNil;
+    node.next = lru_head_;
+    if (lru_head_ != kNil) {
+        nodes_[lru_head_].prev = n;
+    }
+    lru_head_ = n;
+    if (lru_tail_ == kNil) {
+        lru_tail_ = n;
+    }
+}
+
+void FlatSourceLimiter::evict_lru() noexcept {
+    if (lru_tail_ == kNil) {
+        return;
+    }
+    // Remove least recently used (tail of list)
+    const std::uint32_t victim = lru_tail_;
+    erase_slot(find_slot(nodes_[victim].key));
+    lru_unlink(victim);
+    nodes_[victim].next = free_head_;
+    free_head_ = victim;
+    --size_;
+    ++eviction_count_;
+}
+
+void FlatSourceLimiter::erase_slot(std::size_t slot) noexcept {
+    // Backward-shift deletion: pull later members of the probe run into
+    // the hole so lookups never need tombstones
+    std::size_t hole = slot;
+    std::size_t next = (hole + 1) & index_mask_;
+    while (index_[next] != kNil) {
+        const std::size_t home = hash(nodes_[index_[next]].key) & index_mask_;
+        // Move if `home` is not cyclically within (hole, next]
+        if (((next - home) & index_mask_) >= ((next - hole) & index_mask_)) {
+            index_[hole] = index_[next];
+            hole = next;
+        }
+        next = (next + 1) & index_mask_;
+    }
+    index_[hole] = kNil;
+}
+
+void FlatSourceLimiter::reconfigure(const SourceLimiterConfig& config) {
+    config_ = config;
+    burst_ = static_cast<std::uint64_t>(config.burst_tokens) * kTokenScale;
+    full_refill_ns_ = full_refill_ns(burst_, config.tokens_per_sec);
+
+    const std::size_t capacity = std::max<std::size_t>(config.max_sources, 1);
+    if (capacity != nodes_.size()) {
+        resize(capacity);
+    }
+    for (std::uint32_t n = lru_head_; n != kNil; n = nodes_[n].next) {
+        nodes_[n].tokens = std::min(nodes_[n].tokens, burst_);
+    }
+}
+
+void FlatSourceLimiter::resize(std::size_t capacity) {
+    std::vector<Node> old = std::move(nodes_);
+    const std::uint32_t old_head = lru_head_;
+
+    nodes_.assign(capacity, Node{});
+    index_.assign(std::bit_ceil(capacity * 2), kNil);
+    index_mask_ = index_.size() - 1;
+    lru_head_ = kNil;
+    lru_tail_ = kNil;
+    size_ = 0;
+
+    // Walk from MRU to LRU, appending at the tail so the order is kept
+    for (std::uint32_t n = old_head; n != kNil; n = old[n].next) {
+        if (size_ == capacity) {
+            ++eviction_count_;
+            continue;
+        }
+        const auto m = static_cast<std::uint32_t>(size_++);
+        nodes_[m] = old[n];
+        nodes_[m].prev = lru_tail_;
+        nodes_[m].next = kNil;
+        if (lru_tail_ != kNil) {
+            nodes_[lru_tail_].next = m;
+        } else {
+            lru_head_ = m;
+        }
+        lru_tail_ = m;
+        index_[find_slot(nodes_[m].key)] = m;
+    }
+
+    // Remaining nodes form the free list
+    free_head_ = kNil;
+    for (std::size_t i = capacity; i-- > size_;) {
+        nodes_[i].next = free_head_;
+        free_head_ = static_cast<std::uint32_t>(i);
+    }
+}
+
+bool FlatSourceLimiter::is_tracked(const SourceKey& source) const noexcept {
+    return index_[find_slot(source)] != kNil;
+}
+
 }  // namespace gateway
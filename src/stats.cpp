@@ -0,0 +1,148 @@
+#include "gateway/stats.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace gateway {
+
+namespace {
+
+template <std::size_t N>
+void merge_counts(std::array<std::uint64_t, N>& into, const std::array<std::uint64_t, N>& from) noexcept {
+    for (std::size_t i = 0; i < into.size(); ++i) {
+        into[i] += from[i];
+    }
+}
+
+}  // namespace
+
+void StatsSnapshot::merge(const StatsSnapshot& other) noexcept {
+    received += other.received;
+    recv_truncated += other.recv_truncated;
+    recv_no_buffer += other.recv_no_buffer;
+    recv_errors += other.recv_errors;
+    source_limited += other.source_limited;
+
+    merge_counts(envelope, other.envelope);
+    merge_counts(prefilter, other.prefilter);
+    merge_counts(metrics_parse, other.metrics_parse);
+    merge_counts(metrics_validation, other.metrics_validation);
+    merge_counts(log_parse, other.log_parse);
+    merge_counts(log_validation, other.log_validation);
+    duplicates += other.duplicates;
+    agent_limited += other.agent_limited;
+    aggregated += other.aggregated;
+    aggregate_dropped += other.aggregate_dropped;
+    merge_counts(forward, other.forward);
+    serialize_overflow += other.serialize_overflow;
+
+    forwarded += other.forwarded;
+    queue_depth += other.queue_depth;
+    queue_capacity += other.queue_capacity;
+    tracked_agents += other.tracked_agents;
+    tracked_sources += other.tracked_sources;
+
+    parse.merge(other.parse);
+    validate.merge(other.validate);
+    queue.merge(other.queue);
+    sink_write.merge(other.sink_write);
+}
+
+StatsSnapshot PipelineStats::snapshot() const noexcept {
+    StatsSnapshot s;
+    s.received = received.value();
+    s.recv_truncated = recv_truncated.value();
+    s.recv_no_buffer = recv_no_buffer.value();
+    s.recv_errors = recv_errors.value();
+    s.source_limited = source_limited.value();
+
+    s.envelope = envelope.snapshot();
+    s.prefilter = prefilter.snapshot();
+    s.metrics_parse = metrics_parse.snapshot();
+    s.metrics_validation = metrics_validation.snapshot();
+    s.log_parse = log_parse.snapshot();
+    s.log_validation = log_validation.snapshot();
+    s.duplicates = duplicates.value();
+    s.agent_limited = agent_limited.value();
+    s.aggregated = aggregated.value();
+    s.aggregate_dropped = aggregate_dropped.value();
+    s.forward = forward.snapshot();
+    s.serialize_overflow = serialize_overflow.value();
+
+    s.forwarded = forwarded.value();
+    s.queue_depth = queue_depth.value();
+    s.queue_capacity = queue_capacity.value();
+    s.tracked_agents = tracked_agents.value();
+    s.tracked_sources = tracked_sources.value();
+
+    s.parse = parse.snapshot();
+    s.validate = validate.snapshot();
+    s.queue = queue.snapshot();
+    s.sink_write = sink_write.snapshot();
+    return s;
+}
+
+StatsRegistry::StatsRegistry(std::size_t max_threads)
+    : blocks_(std::make_unique<std::atomic<PipelineStats*>[]>(max_threads))
+    , capacity_(max_threads) {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        blocks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+StatsRegistry::~StatsRegistry() {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        delete blocks_[i].load(std::memory_order_relaxed);
+    }
+}
+
+PipelineStats* StatsRegistry::register_thread() noexcept {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        if (blocks_[i].load(std::memory_order_relaxed) == nullptr) {
+            if (PipelineStats* block = register_thread(i)) {
+                return block;
+            }
+        }
+    }
+    return nullptr;
+}
+
+PipelineStats* StatsRegistry::register_thread(std::size_t slot) noexcept {
+    if (slot >= capacity_ || blocks_[slot].load(std::memory_order_relaxed) != nullptr) {
+        return nullptr;
+    }
+    // Constructed (so first touched) here, on the registering thread
+    auto* block = new (std::nothrow) PipelineStats();
+    if (block == nullptr) {
+        return nullptr;
+    }
+    PipelineStats* expected = nullptr;
+    if (!blocks_[slot].compare_exchange_strong(expected, block, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+        delete block;  // lost the race for this slot
+        return nullptr;
+    }
+    registered_.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+std::size_t StatsRegistry::registered() const noexcept {
+    return registered_.load(std::memory_order_relaxed);
+}
+
+StatsSnapshot StatsRegistry::snapshot() const noexcept {
+    StatsSnapshot merged;
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        if (const PipelineStats* block = blocks_[i].load(std::memory_order_acquire)) {
+            merged.merge(block->snapshot());
+        }
+    }
+    return merged;
+}
+
+StatsSnapshot StatsRegistry::snapshot(std::size_t i) const noexcept {
+    const PipelineStats* block = i < capacity_ ? blocks_[i].load(std::memory_order_acquire) : nullptr;
+    return block != nullptr ? block->snapshot() : StatsSnapshot{};
+}
+
+}  // namespace gateway
@@ -0,0 +1,406 @@
+#include "gateway/topology.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace gateway {
+
+namespace {
+
+// Bound on CPU numbers accepted from sysfs (the kernel's NR_CPUS is 8192
+// at most today), so a corrupt list cannot size a huge table
+constexpr int kMaxCpus = 1 << 16;
+constexpr int kMaxNodes = 1 << 10;
+
+// Whole small file, or nullopt if it cannot be read
+std::optional<std::string> read_file(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return std::nullopt;
+    }
+    std::string out;
+    char buf[4096];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0) {
+        out.append(buf, n);
+    }
+    std::fclose(file);
+    return out;
+}
+
+// Entries of a directory that are `prefix` followed by a number
+std::vector<int> numbered_entries(const std::string& dir, std::string_view prefix) {
+    std::vector<int> out;
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr) {
+        return out;
+    }
+    while (const dirent* e = readdir(d)) {
+        const std::string_view name(e->d_name);
+        if (name.size() <= prefix.size() || name.substr(0, prefix.size()) != prefix) {
+            continue;
+        }
+        const std::string_view digits = name.substr(prefix.size());
+        if (std::all_of(digits.begin(), digits.end(),
+                        [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }) &&
+            digits.size() < 8) {
+            out.push_back(std::atoi(std::string(digits).c_str()));
+        }
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::string_view trim(std::string_view s) noexcept {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+bool parse_int(std::string_view s, int& out) noexcept {
+    if (s.empty() || s.size() > 9) {
+        return false;
+    }
+    int v = 0;
+    for (char c : s) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        v = v * 10 + (c - '0');
+    }
+    out = v;
+    return true;
+}
+
+// Receive-queue marker in an IRQ action name and the queue number that
+// follows it (-1 if none): "eth0-TxRx-3", "mlx5_comp3@pci:...",
+// "virtio4-input.0", "virtio4-rx"
+bool rx_queue_name(std::string_view name, int& queue) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    std::size_t end = std::string::npos;
+    for (std::string_view marker : {"rx", "input", "comp"}) {
+        const std::size_t at = lower.rfind(marker);
+        if (at != std::string::npos) {
+            end = std::max(end == std::string::npos ? 0 : end, at + marker.size());
+        }
+    }
+    if (end == std::string::npos) {
+        return false;
+    }
+    while (end < lower.size() && (lower[end] == '-' || lower[end] == '.' || lower[end] == '_')) {
+        ++end;
+    }
+    std::size_t digits = end;
+    while (digits < lower.size() && std::isdigit(static_cast<unsigned char>(lower[digits]))) {
+        ++digits;
+    }
+    if (digits == end || !parse_int(std::string_view(lower).substr(end, digits - end), queue)) {
+        queue = -1;
+    }
+    return true;
+}
+
+// `name` mentions interface `ifname` as a whole word ("eth1-TxRx-0"
+// and "i40e-eth1-TxRx-0", not "eth10-TxRx-0")
+bool names_interface(std::string_view name, std::string_view ifname) noexcept {
+    auto is_word = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; };
+    for (std::size_t at = name.find(ifname); at != std::string_view::npos;
+         at = name.find(ifname, at + 1)) {
+        const std::size_t end = at + ifname.size();
+        if ((at == 0 || !is_word(name[at - 1])) && (end == name.size() || !is_word(name[end]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+std::optional<std::vector<int>> parse_cpu_list(std::string_view text) {
+    std::vector<int> cpus;
+    text = trim(text);
+    while (!text.empty()) {
+        const std::size_t comma = text.find(',');
+        const std::string_view item = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+        if (comma != std::string_view::npos && text.empty()) {
+            return std::nullopt;  // trailing comma
+        }
+
+        const std::size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        if (!parse_int(item.substr(0, dash), first) ||
+            (dash != std::string_view::npos && !parse_int(item.substr(dash + 1), last))) {
+            return std::nullopt;
+        }
+        if (dash == std::string_view::npos) {
+            last = first;
+        }
+        if (first > last || last >= kMaxCpus) {
+            return std::nullopt;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+CpuTopology load_cpu_topology(const std::string& sys_root) {
+    CpuTopology topology;
+    const std::string node_dir = sys_root + "/devices/system/node";
+
+    auto add = [&](int node, const std::vector<int>& cpus) {
+        if (topology.node_cpus.size() <= static_cast<std::size_t>(node)) {
+            topology.node_cpus.resize(static_cast<std::size_t>(node) + 1);
+        }
+        for (int cpu : cpus) {
+            if (topology.node_of_cpu.size() <= static_cast<std::size_t>(cpu)) {
+                topology.node_of_cpu.resize(static_cast<std::size_t>(cpu) + 1, -1);
+            }
+            if (topology.node_of_cpu[static_cast<std::size_t>(cpu)] < 0) {
+                topology.node_of_cpu[static_cast<std::size_t>(cpu)] = node;
+                topology.node_cpus[static_cast<std::size_t>(node)].push_back(cpu);
+            }
+        }
+    };
+
+    for (int node : numbered_entries(node_dir, "node")) {
+        if (node >= kMaxNodes) {
+            continue;
+        }
+        const auto text = read_file(node_dir + "/node" + std::to_string(node) + "/cpulist");
+        const auto cpus = text ? parse_cpu_list(*text) : std::nullopt;
+        if (cpus) {
+            add(node, *cpus);
+        }
+    }
+    if (topology.node_cpus.empty()) {
+        const auto text = read_file(sys_root + "/devices/system/cpu/online");
+        if (const auto cpus = text ? parse_cpu_list(*text) : std::nullopt) {
+            add(0, *cpus);
+        }
+    }
+    return topology;
+}
+
+NicTopology load_nic_topology(std::string_view ifname, const CpuTopology& cpus,
+                              const std::string& sys_root, const std::string& proc_root) {
+    NicTopology nic;
+    nic.name = std::string(ifname);
+    const std::string device = sys_root + "/class/net/" + nic.name + "/device";
+
+    int node = -1;
+    if (const auto text = read_file(device + "/numa_node")) {
+        const std::string_view t = trim(*text);
+        if (t != "-1" && parse_int(t, node)) {
+            nic.node = node;
+        }
+    }
+
+    // IRQs owned by the device (virtio lists them on its PCI parent)
+    std::vector<int> msi = numbered_entries(device + "/msi_irqs", "");
+    if (msi.empty()) {
+        msi = numbered_entries(device + "/../msi_irqs", "");
+    }
+
+    const auto interrupts = read_file(proc_root + "/interrupts");
+    if (!interrupts) {
+        return nic;
+    }
+    std::string_view rest(*interrupts);
+    int order = 0;
+    while (!rest.empty()) {
+        const std::size_t eol = rest.find('\n');
+        const std::string_view line = trim(rest.substr(0, eol));
+        rest = eol == std::string_view::npos ? std::string_view{} : rest.substr(eol + 1);
+
+        // "  45:  123  456  PCI-MSIX-0000:3b:00.0  1-edge  eth0-TxRx-0"
+        const std::size_t colon = line.find(':');
+        int irq = 0;
+        if (colon == std::string_view::npos || !parse_int(trim(line.substr(0, colon)), irq)) {
+            continue;  // header, NMI, LOC, ...
+        }
+        const std::size_t name_at = line.find_last_of(" \t");
+        const std::string_view name = name_at == std::string_view::npos ? std::string_view{}
+                                                                        : line.substr(name_at + 1);
+        const bool owned = std::binary_search(msi.begin(), msi.end(), irq) ||
+                           (!nic.name.empty() && names_interface(name, nic.name));
+        int queue = -1;
+        if (!owned || !rx_queue_name(name, queue)) {
+            continue;
+        }
+
+        RxQueue q;
+        q.irq = irq;
+        q.queue = queue >= 0 ? queue : order;
+        ++order;
+        const std::string irq_dir = proc_root + "/irq/" + std::to_string(irq);
+        for (const char* file : {"/effective_affinity_list", "/smp_affinity_list"}) {
+            const auto text = read_file(irq_dir + file);
+            const auto list = text ? parse_cpu_list(*text) : std::nullopt;
+            if (list && !list->empty()) {
+                q.cpus = *list;
+                break;
+            }
+        }
+        q.node = q.cpus.empty() ? -1 : cpus.node_of(q.cpus.front());
+        nic.rx_queues.push_back(std::move(q));
+    }
+    std::stable_sort(nic.rx_queues.begin(), nic.rx_queues.end(),
+                     [](const RxQueue& a, const RxQueue& b) { return a.queue < b.queue; });
+    return nic;
+}
+
+std::vector<int> plan_worker_cpus(const CpuTopology& topology, std::size_t workers,
+                                  std::span<const int> preferred_cpus, int preferred_node) {
+    std::vector<int> order;
+    std::vector<bool> used(topology.node_of_cpu.size(), false);
+    auto take = [&](int cpu) {
+        if (topology.node_of(cpu) >= 0 && !used[static_cast<std::size_t>(cpu)]) {
+            used[static_cast<std::size_t>(cpu)] = true;
+            order.push_back(cpu);
+        }
+    };
+
+    for (int cpu : preferred_cpus) {
+        take(cpu);
+    }
+    if (preferred_node >= 0 && static_cast<std::size_t>(preferred_node) < topology.node_count()) {
+        for (int cpu : topology.node_cpus[static_cast<std::size_t>(preferred_node)]) {
+            take(cpu);
+        }
+    }
+    for (const auto& node : topology.node_cpus) {
+        for (int cpu : node) {
+            take(cpu);
+        }
+    }
+
+    std::vector<int> plan;
+    if (order.empty()) {
+        return plan;
+    }
+    plan.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        plan.push_back(order[i % order.size()]);
+    }
+    return plan;
+}
+
+std::vector<int> node_cpus_for(const CpuTopology& topology, int worker_cpu) {
+    const int node = topology.node_of(worker_cpu);
+    if (node < 0) {
+        return {};
+    }
+    std::vector<int> cpus;
+    for (int cpu : topology.node_cpus[static_cast<std::size_t>(node)]) {
+        if (cpu != worker_cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        cpus.push_back(worker_cpu);
+    }
+    return cpus;
+}
+
+std::vector<RxPlacement> map_rx_queues(const NicTopology& nic, const CpuTopology& topology,
+                                       std::span<const int> worker_cpus) {
+    std::vector<RxPlacement> out;
+    out.reserve(nic.rx_queues.size());
+    for (const auto& q : nic.rx_queues) {
+        RxPlacement p;
+        for (std::size_t w = 0; w < worker_cpus.size() && p.worker < 0; ++w) {
+            if (std::find(q.cpus.begin(), q.cpus.end(), worker_cpus[w]) != q.cpus.end()) {
+                p = RxPlacement{static_cast<int>(w), true};
+            }
+        }
+        for (std::size_t w = 0; w < worker_cpus.size() && p.worker < 0; ++w) {
+            if (q.node >= 0 && topology.node_of(worker_cpus[w]) == q.node) {
+                p = RxPlacement{static_cast<int>(w), false};
+            }
+        }
+        out.push_back(p);
+    }
+    return out;
+}
+
+bool pin_current_thread_to_cpus(std::span<const int> cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    bool any = false;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+            any = true;
+        }
+    }
+    return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+bool set_local_memory_policy() {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    return syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+bool attach_reuseport_cpu_steering(int fd, std::span<const int> worker_cpus) {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    // ld cpu; (jeq cpu_i ? ret i)*; a %= n; ret a
+    if (worker_cpus.empty() || worker_cpus.size() * 2 + 3 > BPF_MAXINSNS) {
+        return false;
+    }
+    std::vector<sock_filter> code;
+    code.reserve(worker_cpus.size() * 2 + 3);
+    code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+                            static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+    for (std::size_t i = 0; i < worker_cpus.size(); ++i) {
+        code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+                                static_cast<std::uint32_t>(worker_cpus[i]), 0, 1));
+        code.push_back(BPF_STMT(BPF_RET | BPF_K, static_cast<std::uint32_t>(i)));
+    }
+    code.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K,
+                            static_cast<std::uint32_t>(worker_cpus.size())));
+    code.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+
+    sock_fprog prog{};
+    prog.len = static_cast<unsigned short>(code.size());
+    prog.filter = code.data();
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0;
+#else
+    (void)fd;
+    (void)worker_cpus;
+    return false;
+#endif
+}
+
+}  // namespace gateway
@@ -1,4 +1,5 @@
 #include "gateway/validate_config.hpp"
+#include "gateway/char_class.hpp"
 
 namespace gateway {
 
@@ -13,25 +14,9 @@ bool validate_agent_id_format(const char* data, std::size_t len) noexcept {
         return false;
     }
 
-    // First character must be a letter
-    char c = data[0];
-    if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) {
-        return false;
-    }
-
-    // Remaining characters: [a-zA-Z0-9_-]
-    for (std::size_t i = 1; i < len; ++i) {
-        c = data[i];
-        bool valid = (c >= 'a' && c <= 'z') ||
-                     (c >= 'A' && c <= 'Z') ||
-                     (c >= '0' && c <= '9') ||
-                     c == '_' || c == '-';
-        if (!valid) {
-            return false;
-        }
-    }
-
-    return true;
+    // First character must be a letter, remaining: [a-zA-Z0-9_-]
+    return chars::is(data[0], chars::kAlpha) &&
+           chars::all_of(data + 1, len - 1, chars::kAgentIdChar);
 }
 
 bool validate_timestamp_window(
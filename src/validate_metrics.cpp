@@ -4,6 +4,67 @@
 
 namespace gateway {
 
+std::optional<MetricsValidationDrop> check_metrics_timestamp(
+    std::uint64_t ts,
+    const MetricsValidationConfig& config,
+    std::uint64_t current_time_ms
+) noexcept {
+    // Check if timestamp is required and missing
+    if (ts == 0) {
+        if (config.require_timestamp) {
+            return MetricsValidationDrop::TimestampMissing;
+        }
+        return std::nullopt;
+    }
+
+    // Check timestamp window (only if timestamp is provided)
+    if (!validate_timestamp_window(ts, current_time_ms, config.timestamp_window)) {
+        // Determine if too old or in future
+        std::uint64_t min_allowed = 0;
+        if (current_time_ms > static_cast<std::uint64_t>(config.timestamp_window.max_age_ms)) {
+            min_allowed = current_time_ms - static_cast<std::uint64_t>(config.timestamp_window.max_age_ms);
+        }
+
+        if (ts < min_allowed) {
+            return MetricsValidationDrop::TimestampTooOld;
+        } else {
+            return MetricsValidationDrop::TimestampInFuture;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<MetricsValidationDrop> check_metric(
+    const Metric& m,
+    const MetricValueRules& rules
+) noexcept {
+    // Check metric name is not empty
+    if (m.name.empty()) {
+        return MetricsValidationDrop::MetricNameEmpty;
+    }
+
+    // Check for NaN
+    if (rules.reject_nan && std::isnan(m.value)) {
+        return MetricsValidationDrop::MetricValueNaN;
+    }
+
+    // Check for infinity
+    if (rules.reject_infinity && std::isinf(m.value)) {
+        return MetricsValidationDrop::MetricValueInfinity;
+    }
+
+    // Check value range (only if not NaN/Inf)
+    if (!std::isnan(m.value) && !std::isinf(m.value)) {
+        if (m.value < rules.min_value) {
+            return MetricsValidationDrop::MetricValueTooLow;
+        }
+        if (m.value > rules.max_value) {
+            return MetricsValidationDrop::MetricValueTooHigh;
+        }
+    }
+    return std::nullopt;
+}
+
 MetricsValidationResult validate_metrics(
     const ParsedMetrics& parsed,
     const MetricsValidationConfig& config,
@@ -32,26 +93,8 @@ MetricsValidationResult validate_metrics(
     // Validate timestamp
     // =========================================================================
 
-    // Check if timestamp is required and missing
-    if (config.require_timestamp && parsed.ts == 0) {
-        return MetricsValidationDrop::TimestampMissing;
-    }
-
-    // Check timestamp window (only if timestamp is provided)
-    if (parsed.ts != 0) {
-        if (!validate_timestamp_window(parsed.ts, current_time_ms, config.timestamp_window)) {
-            // Determine if too old or in future
-            std::uint64_t min_allowed = 0;
-            if (current_time_ms > static_cast<std::uint64_t>(config.timestamp_window.max_age_ms)) {
-                min_allowed = current_time_ms - static_cast<std::uint64_t>(config.timestamp_window.max_age_ms);
-            }
-
-            if (parsed.ts < min_allowed) {
-                return MetricsValidationDrop::TimestampTooOld;
-            } else {
-                return MetricsValidationDrop::TimestampInFuture;
-            }
-        }
+    if (auto drop = check_metrics_timestamp(parsed.ts, config, current_time_ms)) {
+        return *drop;
     }
 
     // =========================================================================
@@ -60,31 +103,8 @@ MetricsValidationResult validate_metrics(
     // =========================================================================
 
     for (std::size_t i = 0; i < parsed.metric_count; ++i) {
-        const Metric& m = parsed.metrics[i];
-
-        // Check metric name is not empty
-        if (m.name.empty()) {
-            return MetricsValidationDrop::MetricNameEmpty;
-        }
-
-        // Check for NaN
-        if (config.value_rules.reject_nan && std::isnan(m.value)) {
-            return MetricsValidationDrop::MetricValueNaN;
-        }
-
-        // Check for infinity
-        if (config.value_rules.reject_infinity && std::isinf(m.value)) {
-            return MetricsValidationDrop::MetricValueInfinity;
-        }
-
-        // Check value range (only if not NaN/Inf)
-        if (!std::isnan(m.value) && !std::isinf(m.value)) {
-            if (m.value < config.value_rules.min_value) {
-                return MetricsValidationDrop::MetricValueTooLow;
-            }
-            if (m.value > config.value_rules.max_value) {
-                return MetricsValidationDrop::MetricValueTooHigh;
-            }
+        if (auto drop = check_metric(parsed.metrics[i], config.value_rules)) {
+            return *drop;
         }
     }
 
@@ -98,6 +118,7 @@ MetricsValidationResult validate_metrics(
     result.ts = parsed.ts;
     result.metrics = parsed.metrics.data();
     result.metric_count = parsed.metric_count;
+    result.tags = parsed.tags.data();
 
     return result;
 }
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Regenerate tests/lz4_vectors.hpp against the reference liblz4.
+
+    cmake --build _gate_build --target gateway
+    python3 tests/gen_lz4_vectors.py _gate_build/libgateway.a
+
+For each input (the same recipes as lz4_vector_input() in
+test_columnar.cpp):
+- compresses it with liblz4's LZ4_compress_default and LZ4_compress_HC
+  (level 12); test_columnar decodes both with gateway::lz4_decompress
+- compresses it with gateway::lz4_compress (a small driver linked against
+  the given libgateway.a) and checks that liblz4's LZ4_decompress_safe
+  restores the input; test_columnar pins those bytes, so an encoder change
+  fails until this script re-verifies it
+
+Needs only the liblz4 shared library (no headers) and a C++20 compiler.
+"""
+
+import ctypes
+import ctypes.util
+import os
+import pathlib
+import subprocess
+import sys
+import tempfile
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+OUT = ROOT / "tests" / "lz4_vectors.hpp"
+
+DRIVER = r"""
+#include "gateway/columnar.hpp"
+#include <cstdio>
+#include <iterator>
+#include <vector>
+int main() {
+    std::vector<std::byte> in;
+    for (int c; (c = std::getchar()) != EOF;) in.push_back(std::byte(c));
+    std::vector<std::byte> out(gateway::lz4_compress_bound(in.size()));
+    const std::size_t n = gateway::lz4_compress(in, out);
+    std::fwrite(out.data(), 1, n, stdout);
+    return n == 0;
+}
+"""
+
+
+def lcg_bytes(seed, n):
+    out = bytearray()
+    x = seed
+    for _ in range(n):
+        x = (x * 1103515245 + 12345) & 0xFFFFFFFF
+        out.append(x >> 24)
+    return bytes(out)
+
+
+METRICS = (
+    b'{"type":"metrics","agent_id":"web-01","seq":1,"ts":1700000000000,'
+    b'"metrics":[{"n":"cpu","v":0.5,"u":"pct","t":{"host":"h1"}}]}'
+    b'{"type":"metrics","agent_id":"web-01","seq":2,"ts":1700000001000,'
+    b'"metrics":[{"n":"cpu","v":0.75,"u":"pct","t":{"host":"h1"}}]}'
+)
+
+# name -> input; keep in step with lz4_vector_input() in test_columnar.cpp
+INPUTS = [
+    ("one_byte", b"x"),
+    ("below_min_match", b"columnar col"),
+    ("metrics_json", METRICS),
+    ("long_run", b"a" * 1000),
+    ("random", lcg_bytes(1, 300)),
+    ("beyond_max_offset", lcg_bytes(2, 256) + b"x" * 66000 + lcg_bytes(2, 256)),
+    ("repeated_word", (b"columnar " * 556)[:5000]),
+]
+
+
+def load_lz4():
+    path = ctypes.util.find_library("lz4") or "liblz4.so.1"
+    lib = ctypes.CDLL(path)
+    lib.LZ4_versionString.restype = ctypes.c_char_p
+    for fn in (lib.LZ4_compress_default, lib.LZ4_decompress_safe):
+        fn.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_int]
+        fn.restype = ctypes.c_int
+    lib.LZ4_compress_HC.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int,
+                                    ctypes.c_int, ctypes.c_int]
+    lib.LZ4_compress_HC.restype = ctypes.c_int
+    return lib
+
+
+def lz4_compress(lib, data, hc):
+    bound = len(data) + len(data) // 255 + 16
+    out = ctypes.create_string_buffer(bound)
+    if hc:
+        n = lib.LZ4_compress_HC(data, out, len(data), bound, 12)
+    else:
+        n = lib.LZ4_compress_default(data, out, len(data), bound)
+    if n <= 0:
+        sys.exit("liblz4 failed to compress")
+    return out.raw[:n]
+
+
+def lz4_decompress(lib, packed, size):
+    out = ctypes.create_string_buffer(size)
+    n = lib.LZ4_decompress_safe(packed, out, len(packed), size)
+    return out.raw[:n] if n == size else None
+
+
+def build_driver(libgateway, tmp):
+    src = pathlib.Path(tmp) / "driver.cpp"
+    exe = pathlib.Path(tmp) / "driver"
+    src.write_text(DRIVER)
+    cxx = os.environ.get("CXX", "c++")
+    subprocess.run([cxx, "-std=c++20", "-O2", f"-I{ROOT / 'include'}", str(src),
+                    str(libgateway), "-pthread", "-o", str(exe)], check=True)
+    return exe
+
+
+def c_array(name, data):
+    lines = []
+    for off in range(0, len(data), 16):
+        lines.append("    " + ", ".join(f"0x{b:02x}" for b in data[off:off + 16]) + ",")
+    return f"inline constexpr unsigned char {name}[] = {{\n" + "\n".join(lines) + "\n};\n"
+
+
+def camel(name):
+    return "".join(part.capitalize() for part in name.split("_"))
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    lib = load_lz4()
+    version = lib.LZ4_versionString().decode()
+
+    arrays = []
+    rows = []
+    with tempfile.TemporaryDirectory() as tmp:
+        driver = build_driver(pathlib.Path(sys.argv[1]).resolve(), tmp)
+        for name, data in INPUTS:
+            fast = lz4_compress(lib, data, hc=False)
+            hc = lz4_compress(lib, data, hc=True)
+            ours = subprocess.run([str(driver)], input=data, stdout=subprocess.PIPE,
+                                  check=True).stdout
+            if lz4_decompress(lib, ours, len(data)) != data:
+                sys.exit(f"{name}: LZ4_decompress_safe rejects gateway::lz4_compress output")
+            base = "k" + camel(name)
+            arrays += [c_array(base + "Fast", fast), c_array(base + "Hc", hc),
+                       c_array(base + "Gateway", ours)]
+            rows.append(f'    {{"{name}", {len(data)}, {base}Fast, {base}Hc, {base}Gateway}},')
+
+    OUT.write_text(
+        "#pragma once\n\n"
+        f"// Generated by tests/gen_lz4_vectors.py against liblz4 {version}; do not edit.\n"
+        "//\n"
+        "// Per input: LZ4_compress_default and LZ4_compress_HC(level 12) output,\n"
+        "// and gateway::lz4_compress output that LZ4_decompress_safe restored to\n"
+        "// the input when this file was generated.\n\n"
+        "#include <cstddef>\n#include <span>\n\n"
+        "namespace lz4_vectors {\n\n"
+        + "\n".join(arrays)
+        + "\nstruct Vector {\n"
+        "    const char* name;  // input recipe, see lz4_vector_input()\n"
+        "    std::size_t size;  // input bytes\n"
+        "    std::span<const unsigned char> fast;     // LZ4_compress_default\n"
+        "    std::span<const unsigned char> hc;       // LZ4_compress_HC, level 12\n"
+        "    std::span<const unsigned char> gateway;  // gateway::lz4_compress\n"
+        "};\n\n"
+        "inline constexpr Vector kVectors[] = {\n" + "\n".join(rows) + "\n};\n\n"
+        "}  // namespace lz4_vectors\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,344 @@
+#pragma once
+
+// Generated by tests/gen_lz4_vectors.py against liblz4 1.9.4; do not edit.
+//
+// Per input: LZ4_compress_default and LZ4_compress_HC(level 12) output,
+// and gateway::lz4_compress output that LZ4_decompress_safe restored to
+// the input when this file was generated.
+
+#include <cstddef>
+#include <span>
+
+namespace lz4_vectors {
+
+inline constexpr unsigned char kOneByteFast[] = {
+    0x10, 0x78,
+};
+
+inline constexpr unsigned char kOneByteHc[] = {
+    0x10, 0x78,
+};
+
+inline constexpr unsigned char kOneByteGateway[] = {
+    0x10, 0x78,
+};
+
+inline constexpr unsigned char kBelowMinMatchFast[] = {
+    0xc0, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x61, 0x72, 0x20, 0x63, 0x6f, 0x6c,
+};
+
+inline constexpr unsigned char kBelowMinMatchHc[] = {
+    0xc0, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x61, 0x72, 0x20, 0x63, 0x6f, 0x6c,
+};
+
+inline constexpr unsigned char kBelowMinMatchGateway[] = {
+    0xc0, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x61, 0x72, 0x20, 0x63, 0x6f, 0x6c,
+};
+
+inline constexpr unsigned char kMetricsJsonFast[] = {
+    0xf6, 0x27, 0x7b, 0x22, 0x74, 0x79, 0x70, 0x65, 0x22, 0x3a, 0x22, 0x6d, 0x65, 0x74, 0x72, 0x69,
+    0x63, 0x73, 0x22, 0x2c, 0x22, 0x61, 0x67, 0x65, 0x6e, 0x74, 0x5f, 0x69, 0x64, 0x22, 0x3a, 0x22,
+    0x77, 0x65, 0x62, 0x2d, 0x30, 0x31, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x3a, 0x31, 0x2c,
+    0x22, 0x74, 0x73, 0x22, 0x3a, 0x31, 0x37, 0x30, 0x01, 0x00, 0x15, 0x2c, 0x39, 0x00, 0xff, 0x24,
+    0x3a, 0x5b, 0x7b, 0x22, 0x6e, 0x22, 0x3a, 0x22, 0x63, 0x70, 0x75, 0x22, 0x2c, 0x22, 0x76, 0x22,
+    0x3a, 0x30, 0x2e, 0x35, 0x2c, 0x22, 0x75, 0x22, 0x3a, 0x22, 0x70, 0x63, 0x74, 0x22, 0x2c, 0x22,
+    0x74, 0x22, 0x3a, 0x7b, 0x22, 0x68, 0x6f, 0x73, 0x74, 0x22, 0x3a, 0x22, 0x68, 0x31, 0x22, 0x7d,
+    0x7d, 0x5d, 0x7d, 0x7d, 0x00, 0x19, 0x1b, 0x32, 0x7d, 0x00, 0x1f, 0x31, 0x7d, 0x00, 0x0d, 0x1f,
+    0x37, 0x7e, 0x00, 0x08, 0x50, 0x22, 0x7d, 0x7d, 0x5d, 0x7d,
+};
+
+inline constexpr unsigned char kMetricsJsonHc[] = {
+    0xf6, 0x27, 0x7b, 0x22, 0x74, 0x79, 0x70, 0x65, 0x22, 0x3a, 0x22, 0x6d, 0x65, 0x74, 0x72, 0x69,
+    0x63, 0x73, 0x22, 0x2c, 0x22, 0x61, 0x67, 0x65, 0x6e, 0x74, 0x5f, 0x69, 0x64, 0x22, 0x3a, 0x22,
+    0x77, 0x65, 0x62, 0x2d, 0x30, 0x31, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x3a, 0x31, 0x2c,
+    0x22, 0x74, 0x73, 0x22, 0x3a, 0x31, 0x37, 0x30, 0x01, 0x00, 0x15, 0x2c, 0x39, 0x00, 0xff, 0x24,
+    0x3a, 0x5b, 0x7b, 0x22, 0x6e, 0x22, 0x3a, 0x22, 0x63, 0x70, 0x75, 0x22, 0x2c, 0x22, 0x76, 0x22,
+    0x3a, 0x30, 0x2e, 0x35, 0x2c, 0x22, 0x75, 0x22, 0x3a, 0x22, 0x70, 0x63, 0x74, 0x22, 0x2c, 0x22,
+    0x74, 0x22, 0x3a, 0x7b, 0x22, 0x68, 0x6f, 0x73, 0x74, 0x22, 0x3a, 0x22, 0x68, 0x31, 0x22, 0x7d,
+    0x7d, 0x5d, 0x7d, 0x7d, 0x00, 0x19, 0x1b, 0x32, 0x7d, 0x00, 0x1f, 0x31, 0x7d, 0x00, 0x0d, 0x1f,
+    0x37, 0x7e, 0x00, 0x08, 0x50, 0x22, 0x7d, 0x7d, 0x5d, 0x7d,
+};
+
+inline constexpr unsigned char kMetricsJsonGateway[] = {
+    0xf6, 0x27, 0x7b, 0x22, 0x74, 0x79, 0x70, 0x65, 0x22, 0x3a, 0x22, 0x6d, 0x65, 0x74, 0x72, 0x69,
+    0x63, 0x73, 0x22, 0x2c, 0x22, 0x61, 0x67, 0x65, 0x6e, 0x74, 0x5f, 0x69, 0x64, 0x22, 0x3a, 0x22,
+    0x77, 0x65, 0x62, 0x2d, 0x30, 0x31, 0x22, 0x2c, 0x22, 0x73, 0x65, 0x71, 0x22, 0x3a, 0x31, 0x2c,
+    0x22, 0x74, 0x73, 0x22, 0x3a, 0x31, 0x37, 0x30, 0x01, 0x00, 0x15, 0x2c, 0x39, 0x00, 0xff, 0x24,
+    0x3a, 0x5b, 0x7b, 0x22, 0x6e, 0x22, 0x3a, 0x22, 0x63, 0x70, 0x75, 0x22, 0x2c, 0x22, 0x76, 0x22,
+    0x3a, 0x30, 0x2e, 0x35, 0x2c, 0x22, 0x75, 0x22, 0x3a, 0x22, 0x70, 0x63, 0x74, 0x22, 0x2c, 0x22,
+    0x74, 0x22, 0x3a, 0x7b, 0x22, 0x68, 0x6f, 0x73, 0x74, 0x22, 0x3a, 0x22, 0x68, 0x31, 0x22, 0x7d,
+    0x7d, 0x5d, 0x7d, 0x7d, 0x00, 0x19, 0x1b, 0x32, 0x7d, 0x00, 0x2f, 0x31, 0x30, 0x7d, 0x00, 0x0c,
+    0x1f, 0x37, 0x7e, 0x00, 0x08, 0x50, 0x22, 0x7d, 0x7d, 0x5d, 0x7d,
+};
+
+inline constexpr unsigned char kLongRunFast[] = {
+    0x1f, 0x61, 0x01, 0x00, 0xff, 0xff, 0xff, 0xd2, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61,
+};
+
+inline constexpr unsigned char kLongRunHc[] = {
+    0x1f, 0x61, 0x01, 0x00, 0xff, 0xff, 0xff, 0xd2, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61,
+};
+
+inline constexpr unsigned char kLongRunGateway[] = {
+    0x1f, 0x61, 0x01, 0x00, 0xff, 0xff, 0xff, 0xd2, 0x50, 0x61, 0x61, 0x61, 0x61, 0x61,
+};
+
+inline constexpr unsigned char kRandomFast[] = {
+    0xf0, 0xff, 0x1e, 0x41, 0x96, 0x27, 0xc4, 0xf9, 0x95, 0xd9, 0x9c, 0xbf, 0x0f, 0x0a, 0x31, 0x23,
+    0xaf, 0x7d, 0xc4, 0xe2, 0xd2, 0xe2, 0xe3, 0xe9, 0x93, 0x50, 0x28, 0x2c, 0x75, 0x42, 0xb3, 0x4d,
+    0xe4, 0xf7, 0xef, 0xee, 0x56, 0xe1, 0xca, 0x31, 0xad, 0x99, 0x69, 0xb5, 0x3b, 0x7d, 0x10, 0x1b,
+    0x7a, 0xde, 0xb4, 0xe3, 0x61, 0x7a, 0x83, 0x28, 0xe0, 0x9f, 0x4b, 0x85, 0xfa, 0x28, 0x87, 0x38,
+    0x75, 0x49, 0x8f, 0x48, 0x20, 0xbf, 0x1e, 0x3d, 0x33, 0xef, 0x36, 0xad, 0x30, 0x05, 0x14, 0xc2,
+    0x59, 0x0c, 0xb3, 0x62, 0x9f, 0xab, 0x1d, 0xa6, 0xa6, 0xf1, 0x84, 0xd3, 0x33, 0x56, 0xdd, 0xf8,
+    0x1d, 0xeb, 0x7b, 0xe3, 0xb7, 0x56, 0xe7, 0x14, 0x23, 0x11, 0xee, 0xe0, 0x1a, 0x11, 0xa5, 0xe6,
+    0x1c, 0xc8, 0xdb, 0x99, 0xfe, 0x20, 0x37, 0x60, 0x6e, 0xf2, 0xfd, 0xb2, 0xb7, 0x10, 0x3a, 0x1e,
+    0xfe, 0xd3, 0xcd, 0x1e, 0xba, 0xe5, 0x8a, 0x3c, 0x13, 0x9f, 0x78, 0xce, 0x7e, 0x3d, 0xe6, 0x5f,
+    0xb0, 0xbd, 0xc3, 0x8c, 0xcc, 0x2c, 0x92, 0xe3, 0x5b, 0xb9, 0xda, 0x0c, 0x7b, 0xc6, 0xde, 0x4a,
+    0x51, 0xe4, 0x18, 0x26, 0xa4, 0x57, 0xa5, 0xc8, 0x35, 0xa7, 0xb8, 0x48, 0x3e, 0x4d, 0xb5, 0x10,
+    0x20, 0x84, 0x7d, 0x0e, 0x30, 0xd2, 0x2c, 0x46, 0x2d, 0xc8, 0x3c, 0x14, 0xce, 0x16, 0xc7, 0x25,
+    0x6f, 0xea, 0x6c, 0xf2, 0xcc, 0x45, 0x15, 0x53, 0x58, 0xa1, 0x8d, 0x68, 0x98, 0x36, 0xad, 0xeb,
+    0x91, 0xa1, 0x96, 0xbd, 0x30, 0xc0, 0x40, 0x2d, 0x43, 0x0f, 0x42, 0x4d, 0x5d, 0xc7, 0xac, 0x66,
+    0xcb, 0xa2, 0x55, 0x46, 0x64, 0xf1, 0xf1, 0x08, 0xe6, 0x74, 0xd2, 0x95, 0x26, 0x15, 0x24, 0xeb,
+    0x44, 0x84, 0x1a, 0x02, 0xad, 0x4f, 0x42, 0xc5, 0x93, 0xe9, 0x04, 0x83, 0x30, 0xce, 0x02, 0xd0,
+    0xf5, 0xaf, 0xdd, 0xb2, 0x7d, 0x4c, 0x8e, 0x9c, 0xe6, 0x6f, 0x5e, 0x81, 0xde, 0x35, 0x2e, 0x1a,
+    0x97, 0x89, 0x8e, 0x14, 0x64, 0x85, 0xe5, 0xcc, 0xb3, 0x1d, 0x97, 0xce, 0xaa, 0x4d, 0xfb, 0x30,
+    0x97, 0xa6, 0x86, 0x92, 0x01, 0xf1, 0x7a, 0x50, 0xfa, 0x50, 0x05, 0x2c, 0x12, 0x0d, 0x99,
+};
+
+inline constexpr unsigned char kRandomHc[] = {
+    0xf0, 0xff, 0x1e, 0x41, 0x96, 0x27, 0xc4, 0xf9, 0x95, 0xd9, 0x9c, 0xbf, 0x0f, 0x0a, 0x31, 0x23,
+    0xaf, 0x7d, 0xc4, 0xe2, 0xd2, 0xe2, 0xe3, 0xe9, 0x93, 0x50, 0x28, 0x2c, 0x75, 0x42, 0xb3, 0x4d,
+    0xe4, 0xf7, 0xef, 0xee, 0x56, 0xe1, 0xca, 0x31, 0xad, 0x99, 0x69, 0xb5, 0x3b, 0x7d, 0x10, 0x1b,
+    0x7a, 0xde, 0xb4, 0xe3, 0x61, 0x7a, 0x83, 0x28, 0xe0, 0x9f, 0x4b, 0x85, 0xfa, 0x28, 0x87, 0x38,
+    0x75, 0x49, 0x8f, 0x48, 0x20, 0xbf, 0x1e, 0x3d, 0x33, 0xef, 0x36, 0xad, 0x30, 0x05, 0x14, 0xc2,
+    0x59, 0x0c, 0xb3, 0x62, 0x9f, 0xab, 0x1d, 0xa6, 0xa6, 0xf1, 0x84, 0xd3, 0x33, 0x56, 0xdd, 0xf8,
+    0x1d, 0xeb, 0x7b, 0xe3, 0xb7, 0x56, 0xe7, 0x14, 0x23, 0x11, 0xee, 0xe0, 0x1a, 0x11, 0xa5, 0xe6,
+    0x1c, 0xc8, 0xdb, 0x99, 0xfe, 0x20, 0x37, 0x60, 0x6e, 0xf2, 0xfd, 0xb2, 0xb7, 0x10, 0x3a, 0x1e,
+    0xfe, 0xd3, 0xcd, 0x1e, 0xba, 0xe5, 0x8a, 0x3c, 0x13, 0x9f, 0x78, 0xce, 0x7e, 0x3d, 0xe6, 0x5f,
+    0xb0, 0xbd, 0xc3, 0x8c, 0xcc, 0x2c, 0x92, 0xe3, 0x5b, 0xb9, 0xda, 0x0c, 0x7b, 0xc6, 0xde, 0x4a,
+    0x51, 0xe4, 0x18, 0x26, 0xa4, 0x57, 0xa5, 0xc8, 0x35, 0xa7, 0xb8, 0x48, 0x3e, 0x4d, 0xb5, 0x10,
+    0x20, 0x84, 0x7d, 0x0e, 0x30, 0xd2, 0x2c, 0x46, 0x2d, 0xc8, 0x3c, 0x14, 0xce, 0x16, 0xc7, 0x25,
+    0x6f, 0xea, 0x6c, 0xf2, 0xcc, 0x45, 0x15, 0x53, 0x58, 0xa1, 0x8d, 0x68, 0x98, 0x36, 0xad, 0xeb,
+    0x91, 0xa1, 0x96, 0xbd, 0x30, 0xc0, 0x40, 0x2d, 0x43, 0x0f, 0x42, 0x4d, 0x5d, 0xc7, 0xac, 0x66,
+    0xcb, 0xa2, 0x55, 0x46, 0x64, 0xf1, 0xf1, 0x08, 0xe6, 0x74, 0xd2, 0x95, 0x26, 0x15, 0x24, 0xeb,
+    0x44, 0x84, 0x1a, 0x02, 0xad, 0x4f, 0x42, 0xc5, 0x93, 0xe9, 0x04, 0x83, 0x30, 0xce, 0x02, 0xd0,
+    0xf5, 0xaf, 0xdd, 0xb2, 0x7d, 0x4c, 0x8e, 0x9c, 0xe6, 0x6f, 0x5e, 0x81, 0xde, 0x35, 0x2e, 0x1a,
+    0x97, 0x89, 0x8e, 0x14, 0x64, 0x85, 0xe5, 0xcc, 0xb3, 0x1d, 0x97, 0xce, 0xaa, 0x4d, 0xfb, 0x30,
+    0x97, 0xa6, 0x86, 0x92, 0x01, 0xf1, 0x7a, 0x50, 0xfa, 0x50, 0x05, 0x2c, 0x12, 0x0d, 0x99,
+};
+
+inline constexpr unsigned char kRandomGateway[] = {
+    0xf0, 0xff, 0x1e, 0x41, 0x96, 0x27, 0xc4, 0xf9, 0x95, 0xd9, 0x9c, 0xbf, 0x0f, 0x0a, 0x31, 0x23,
+    0xaf, 0x7d, 0xc4, 0xe2, 0xd2, 0xe2, 0xe3, 0xe9, 0x93, 0x50, 0x28, 0x2c, 0x75, 0x42, 0xb3, 0x4d,
+    0xe4, 0xf7, 0xef, 0xee, 0x56, 0xe1, 0xca, 0x31, 0xad, 0x99, 0x69, 0xb5, 0x3b, 0x7d, 0x10, 0x1b,
+    0x7a, 0xde, 0xb4, 0xe3, 0x61, 0x7a, 0x83, 0x28, 0xe0, 0x9f, 0x4b, 0x85, 0xfa, 0x28, 0x87, 0x38,
+    0x75, 0x49, 0x8f, 0x48, 0x20, 0xbf, 0x1e, 0x3d, 0x33, 0xef, 0x36, 0xad, 0x30, 0x05, 0x14, 0xc2,
+    0x59, 0x0c, 0xb3, 0x62, 0x9f, 0xab, 0x1d, 0xa6, 0xa6, 0xf1, 0x84, 0xd3, 0x33, 0x56, 0xdd, 0xf8,
+    0x1d, 0xeb, 0x7b, 0xe3, 0xb7, 0x56, 0xe7, 0x14, 0x23, 0x11, 0xee, 0xe0, 0x1a, 0x11, 0xa5, 0xe6,
+    0x1c, 0xc8, 0xdb, 0x99, 0xfe, 0x20, 0x37, 0x60, 0x6e, 0xf2, 0xfd, 0xb2, 0xb7, 0x10, 0x3a, 0x1e,
+    0xfe, 0xd3, 0xcd, 0x1e, 0xba, 0xe5, 0x8a, 0x3c, 0x13, 0x9f, 0x78, 0xce, 0x7e, 0x3d, 0xe6, 0x5f,
+    0xb0, 0xbd, 0xc3, 0x8c, 0xcc, 0x2c, 0x92, 0xe3, 0x5b, 0xb9, 0xda, 0x0c, 0x7b, 0xc6, 0xde, 0x4a,
+    0x51, 0xe4, 0x18, 0x26, 0xa4, 0x57, 0xa5, 0xc8, 0x35, 0xa7, 0xb8, 0x48, 0x3e, 0x4d, 0xb5, 0x10,
+    0x20, 0x84, 0x7d, 0x0e, 0x30, 0xd2, 0x2c, 0x46, 0x2d, 0xc8, 0x3c, 0x14, 0xce, 0x16, 0xc7, 0x25,
+    0x6f, 0xea, 0x6c, 0xf2, 0xcc, 0x45, 0x15, 0x53, 0x58, 0xa1, 0x8d, 0x68, 0x98, 0x36, 0xad, 0xeb,
+    0x91, 0xa1, 0x96, 0xbd, 0x30, 0xc0, 0x40, 0x2d, 0x43, 0x0f, 0x42, 0x4d, 0x5d, 0xc7, 0xac, 0x66,
+    0xcb, 0xa2, 0x55, 0x46, 0x64, 0xf1, 0xf1, 0x08, 0xe6, 0x74, 0xd2, 0x95, 0x26, 0x15, 0x24, 0xeb,
+    0x44, 0x84, 0x1a, 0x02, 0xad, 0x4f, 0x42, 0xc5, 0x93, 0xe9, 0x04, 0x83, 0x30, 0xce, 0x02, 0xd0,
+    0xf5, 0xaf, 0xdd, 0xb2, 0x7d, 0x4c, 0x8e, 0x9c, 0xe6, 0x6f, 0x5e, 0x81, 0xde, 0x35, 0x2e, 0x1a,
+    0x97, 0x89, 0x8e, 0x14, 0x64, 0x85, 0xe5, 0xcc, 0xb3, 0x1d, 0x97, 0xce, 0xaa, 0x4d, 0xfb, 0x30,
+    0x97, 0xa6, 0x86, 0x92, 0x01, 0xf1, 0x7a, 0x50, 0xfa, 0x50, 0x05, 0x2c, 0x12, 0x0d, 0x99,
+};
+
+inline constexpr unsigned char kBeyondMaxOffsetFast[] = {
+    0xff, 0xf4, 0x83, 0x59, 0xa7, 0xb2, 0xe4, 0x69, 0x75, 0x6c, 0xcf, 0xff, 0x65, 0xfa, 0xb0, 0x38,
+    0xa9, 0x23, 0x45, 0xbf, 0x08, 0x82, 0x02, 0x86, 0x46, 0xf4, 0xdb, 0x40, 0xcc, 0x8c, 0x3c, 0x32,
+    0xec, 0x7a, 0xd8, 0xe0, 0xa2, 0x4d, 0xa1, 0xa8, 0x9b, 0x81, 0x0e, 0x4f, 0xfe, 0x35, 0x84, 0x1b,
+    0x2c, 0x9a, 0x81, 0xe8, 0x81, 0x54, 0xe7, 0x72, 0xbc, 0xe6, 0x7d, 0xad, 0xa2, 0xfc, 0x8a, 0xe1,
+    0x07, 0x05, 0x1e, 0xfa, 0x40, 0x8c, 0x6d, 0x2d, 0xb8, 0x3d, 0x4c, 0xe8, 0x25, 0x71, 0xbd, 0xaf,
+    0x9d, 0xd2, 0x19, 0x5e, 0x7b, 0x50, 0x34, 0xf4, 0xdc, 0x8a, 0xa2, 0xd1, 0x2d, 0x64, 0xeb, 0x1c,
+    0x04, 0x63, 0x52, 0xb6, 0x3e, 0x0f, 0x93, 0xe3, 0x22, 0x77, 0x9a, 0xa4, 0x07, 0x91, 0x2e, 0x59,
+    0xb4, 0x13, 0x17, 0x27, 0x73, 0xfd, 0x25, 0x4b, 0x9d, 0xfb, 0x2d, 0x3e, 0x18, 0x50, 0xe0, 0x5f,
+    0xfa, 0xe4, 0x0d, 0x8f, 0x55, 0xc3, 0xbc, 0xde, 0xef, 0x12, 0x29, 0x49, 0x4d, 0x46, 0x86, 0x27,
+    0x64, 0x33, 0x23, 0xb3, 0xdf, 0x2e, 0x50, 0xe1, 0xb2, 0x63, 0x1c, 0x6f, 0x89, 0x14, 0xc6, 0xd0,
+    0x39, 0x63, 0x82, 0x6c, 0x3b, 0xe1, 0xec, 0x5d, 0xef, 0xfb, 0x45, 0x88, 0x19, 0x0a, 0x50, 0xd5,
+    0xde, 0x93, 0x7d, 0xde, 0x33, 0x02, 0xa5, 0x4d, 0x89, 0xf5, 0x86, 0xcc, 0x22, 0xd3, 0xd6, 0x3e,
+    0x4f, 0x48, 0x82, 0xa1, 0xa0, 0xee, 0x83, 0xcf, 0xb0, 0x2e, 0x54, 0x01, 0x0d, 0x27, 0xf4, 0xcb,
+    0x8c, 0x21, 0x06, 0xf4, 0xde, 0xe4, 0x74, 0x52, 0x4d, 0xf3, 0xa3, 0xaa, 0x00, 0x7a, 0x25, 0x29,
+    0x06, 0x85, 0x7a, 0xec, 0x33, 0xba, 0x3c, 0xca, 0x79, 0xb1, 0xda, 0x3c, 0x45, 0xaf, 0xb3, 0x1d,
+    0x16, 0x56, 0x37, 0xa8, 0x4a, 0x8a, 0x66, 0xde, 0xe5, 0xa7, 0xc3, 0x49, 0xbf, 0xc3, 0xa4, 0xb9,
+    0x65, 0x9b, 0x78, 0x78, 0x78, 0x03, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbc, 0xf0, 0xf1, 0x83, 0x59, 0xa7, 0xb2,
+    0xe4, 0x69, 0x75, 0x6c, 0xcf, 0xff, 0x65, 0xfa, 0xb0, 0x38, 0xa9, 0x23, 0x45, 0xbf, 0x08, 0x82,
+    0x02, 0x86, 0x46, 0xf4, 0xdb, 0x40, 0xcc, 0x8c, 0x3c, 0x32, 0xec, 0x7a, 0xd8, 0xe0, 0xa2, 0x4d,
+    0xa1, 0xa8, 0x9b, 0x81, 0x0e, 0x4f, 0xfe, 0x35, 0x84, 0x1b, 0x2c, 0x9a, 0x81, 0xe8, 0x81, 0x54,
+    0xe7, 0x72, 0xbc, 0xe6, 0x7d, 0xad, 0xa2, 0xfc, 0x8a, 0xe1, 0x07, 0x05, 0x1e, 0xfa, 0x40, 0x8c,
+    0x6d, 0x2d, 0xb8, 0x3d, 0x4c, 0xe8, 0x25, 0x71, 0xbd, 0xaf, 0x9d, 0xd2, 0x19, 0x5e, 0x7b, 0x50,
+    0x34, 0xf4, 0xdc, 0x8a, 0xa2, 0xd1, 0x2d, 0x64, 0xeb, 0x1c, 0x04, 0x63, 0x52, 0xb6, 0x3e, 0x0f,
+    0x93, 0xe3, 0x22, 0x77, 0x9a, 0xa4, 0x07, 0x91, 0x2e, 0x59, 0xb4, 0x13, 0x17, 0x27, 0x73, 0xfd,
+    0x25, 0x4b, 0x9d, 0xfb, 0x2d, 0x3e, 0x18, 0x50, 0xe0, 0x5f, 0xfa, 0xe4, 0x0d, 0x8f, 0x55, 0xc3,
+    0xbc, 0xde, 0xef, 0x12, 0x29, 0x49, 0x4d, 0x46, 0x86, 0x27, 0x64, 0x33, 0x23, 0xb3, 0xdf, 0x2e,
+    0x50, 0xe1, 0xb2, 0x63, 0x1c, 0x6f, 0x89, 0x14, 0xc6, 0xd0, 0x39, 0x63, 0x82, 0x6c, 0x3b, 0xe1,
+    0xec, 0x5d, 0xef, 0xfb, 0x45, 0x88, 0x19, 0x0a, 0x50, 0xd5, 0xde, 0x93, 0x7d, 0xde, 0x33, 0x02,
+    0xa5, 0x4d, 0x89, 0xf5, 0x86, 0xcc, 0x22, 0xd3, 0xd6, 0x3e, 0x4f, 0x48, 0x82, 0xa1, 0xa0, 0xee,
+    0x83, 0xcf, 0xb0, 0x2e, 0x54, 0x01, 0x0d, 0x27, 0xf4, 0xcb, 0x8c, 0x21, 0x06, 0xf4, 0xde, 0xe4,
+    0x74, 0x52, 0x4d, 0xf3, 0xa3, 0xaa, 0x00, 0x7a, 0x25, 0x29, 0x06, 0x85, 0x7a, 0xec, 0x33, 0xba,
+    0x3c, 0xca, 0x79, 0xb1, 0xda, 0x3c, 0x45, 0xaf, 0xb3, 0x1d, 0x16, 0x56, 0x37, 0xa8, 0x4a, 0x8a,
+    0x66, 0xde, 0xe5, 0xa7, 0xc3, 0x49, 0xbf, 0xc3, 0xa4, 0xb9, 0x65, 0x9b,
+};
+
+inline constexpr unsigned char kBeyondMaxOffsetHc[] = {
+    0xff, 0xf2, 0x83, 0x59, 0xa7, 0xb2, 0xe4, 0x69, 0x75, 0x6c, 0xcf, 0xff, 0x65, 0xfa, 0xb0, 0x38,
+    0xa9, 0x23, 0x45, 0xbf, 0x08, 0x82, 0x02, 0x86, 0x46, 0xf4, 0xdb, 0x40, 0xcc, 0x8c, 0x3c, 0x32,
+    0xec, 0x7a, 0xd8, 0xe0, 0xa2, 0x4d, 0xa1, 0xa8, 0x9b, 0x81, 0x0e, 0x4f, 0xfe, 0x35, 0x84, 0x1b,
+    0x2c, 0x9a, 0x81, 0xe8, 0x81, 0x54, 0xe7, 0x72, 0xbc, 0xe6, 0x7d, 0xad, 0xa2, 0xfc, 0x8a, 0xe1,
+    0x07, 0x05, 0x1e, 0xfa, 0x40, 0x8c, 0x6d, 0x2d, 0xb8, 0x3d, 0x4c, 0xe8, 0x25, 0x71, 0xbd, 0xaf,
+    0x9d, 0xd2, 0x19, 0x5e, 0x7b, 0x50, 0x34, 0xf4, 0xdc, 0x8a, 0xa2, 0xd1, 0x2d, 0x64, 0xeb, 0x1c,
+    0x04, 0x63, 0x52, 0xb6, 0x3e, 0x0f, 0x93, 0xe3, 0x22, 0x77, 0x9a, 0xa4, 0x07, 0x91, 0x2e, 0x59,
+    0xb4, 0x13, 0x17, 0x27, 0x73, 0xfd, 0x25, 0x4b, 0x9d, 0xfb, 0x2d, 0x3e, 0x18, 0x50, 0xe0, 0x5f,
+    0xfa, 0xe4, 0x0d, 0x8f, 0x55, 0xc3, 0xbc, 0xde, 0xef, 0x12, 0x29, 0x49, 0x4d, 0x46, 0x86, 0x27,
+    0x64, 0x33, 0x23, 0xb3, 0xdf, 0x2e, 0x50, 0xe1, 0xb2, 0x63, 0x1c, 0x6f, 0x89, 0x14, 0xc6, 0xd0,
+    0x39, 0x63, 0x82, 0x6c, 0x3b, 0xe1, 0xec, 0x5d, 0xef, 0xfb, 0x45, 0x88, 0x19, 0x0a, 0x50, 0xd5,
+    0xde, 0x93, 0x7d, 0xde, 0x33, 0x02, 0xa5, 0x4d, 0x89, 0xf5, 0x86, 0xcc, 0x22, 0xd3, 0xd6, 0x3e,
+    0x4f, 0x48, 0x82, 0xa1, 0xa0, 0xee, 0x83, 0xcf, 0xb0, 0x2e, 0x54, 0x01, 0x0d, 0x27, 0xf4, 0xcb,
+    0x8c, 0x21, 0x06, 0xf4, 0xde, 0xe4, 0x74, 0x52, 0x4d, 0xf3, 0xa3, 0xaa, 0x00, 0x7a, 0x25, 0x29,
+    0x06, 0x85, 0x7a, 0xec, 0x33, 0xba, 0x3c, 0xca, 0x79, 0xb1, 0xda, 0x3c, 0x45, 0xaf, 0xb3, 0x1d,
+    0x16, 0x56, 0x37, 0xa8, 0x4a, 0x8a, 0x66, 0xde, 0xe5, 0xa7, 0xc3, 0x49, 0xbf, 0xc3, 0xa4, 0xb9,
+    0x65, 0x9b, 0x78, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbe, 0xf0, 0xf1, 0x83, 0x59, 0xa7, 0xb2, 0xe4, 0x69,
+    0x75, 0x6c, 0xcf, 0xff, 0x65, 0xfa, 0xb0, 0x38, 0xa9, 0x23, 0x45, 0xbf, 0x08, 0x82, 0x02, 0x86,
+    0x46, 0xf4, 0xdb, 0x40, 0xcc, 0x8c, 0x3c, 0x32, 0xec, 0x7a, 0xd8, 0xe0, 0xa2, 0x4d, 0xa1, 0xa8,
+    0x9b, 0x81, 0x0e, 0x4f, 0xfe, 0x35, 0x84, 0x1b, 0x2c, 0x9a, 0x81, 0xe8, 0x81, 0x54, 0xe7, 0x72,
+    0xbc, 0xe6, 0x7d, 0xad, 0xa2, 0xfc, 0x8a, 0xe1, 0x07, 0x05, 0x1e, 0xfa, 0x40, 0x8c, 0x6d, 0x2d,
+    0xb8, 0x3d, 0x4c, 0xe8, 0x25, 0x71, 0xbd, 0xaf, 0x9d, 0xd2, 0x19, 0x5e, 0x7b, 0x50, 0x34, 0xf4,
+    0xdc, 0x8a, 0xa2, 0xd1, 0x2d, 0x64, 0xeb, 0x1c, 0x04, 0x63, 0x52, 0xb6, 0x3e, 0x0f, 0x93, 0xe3,
+    0x22, 0x77, 0x9a, 0xa4, 0x07, 0x91, 0x2e, 0x59, 0xb4, 0x13, 0x17, 0x27, 0x73, 0xfd, 0x25, 0x4b,
+    0x9d, 0xfb, 0x2d, 0x3e, 0x18, 0x50, 0xe0, 0x5f, 0xfa, 0xe4, 0x0d, 0x8f, 0x55, 0xc3, 0xbc, 0xde,
+    0xef, 0x12, 0x29, 0x49, 0x4d, 0x46, 0x86, 0x27, 0x64, 0x33, 0x23, 0xb3, 0xdf, 0x2e, 0x50, 0xe1,
+    0xb2, 0x63, 0x1c, 0x6f, 0x89, 0x14, 0xc6, 0xd0, 0x39, 0x63, 0x82, 0x6c, 0x3b, 0xe1, 0xec, 0x5d,
+    0xef, 0xfb, 0x45, 0x88, 0x19, 0x0a, 0x50, 0xd5, 0xde, 0x93, 0x7d, 0xde, 0x33, 0x02, 0xa5, 0x4d,
+    0x89, 0xf5, 0x86, 0xcc, 0x22, 0xd3, 0xd6, 0x3e, 0x4f, 0x48, 0x82, 0xa1, 0xa0, 0xee, 0x83, 0xcf,
+    0xb0, 0x2e, 0x54, 0x01, 0x0d, 0x27, 0xf4, 0xcb, 0x8c, 0x21, 0x06, 0xf4, 0xde, 0xe4, 0x74, 0x52,
+    0x4d, 0xf3, 0xa3, 0xaa, 0x00, 0x7a, 0x25, 0x29, 0x06, 0x85, 0x7a, 0xec, 0x33, 0xba, 0x3c, 0xca,
+    0x79, 0xb1, 0xda, 0x3c, 0x45, 0xaf, 0xb3, 0x1d, 0x16, 0x56, 0x37, 0xa8, 0x4a, 0x8a, 0x66, 0xde,
+    0xe5, 0xa7, 0xc3, 0x49, 0xbf, 0xc3, 0xa4, 0xb9, 0x65, 0x9b,
+};
+
+inline constexpr unsigned char kBeyondMaxOffsetGateway[] = {
+    0xff, 0xf2, 0x83, 0x59, 0xa7, 0xb2, 0xe4, 0x69, 0x75, 0x6c, 0xcf, 0xff, 0x65, 0xfa, 0xb0, 0x38,
+    0xa9, 0x23, 0x45, 0xbf, 0x08, 0x82, 0x02, 0x86, 0x46, 0xf4, 0xdb, 0x40, 0xcc, 0x8c, 0x3c, 0x32,
+    0xec, 0x7a, 0xd8, 0xe0, 0xa2, 0x4d, 0xa1, 0xa8, 0x9b, 0x81, 0x0e, 0x4f, 0xfe, 0x35, 0x84, 0x1b,
+    0x2c, 0x9a, 0x81, 0xe8, 0x81, 0x54, 0xe7, 0x72, 0xbc, 0xe6, 0x7d, 0xad, 0xa2, 0xfc, 0x8a, 0xe1,
+    0x07, 0x05, 0x1e, 0xfa, 0x40, 0x8c, 0x6d, 0x2d, 0xb8, 0x3d, 0x4c, 0xe8, 0x25, 0x71, 0xbd, 0xaf,
+    0x9d, 0xd2, 0x19, 0x5e, 0x7b, 0x50, 0x34, 0xf4, 0xdc, 0x8a, 0xa2, 0xd1, 0x2d, 0x64, 0xeb, 0x1c,
+    0x04, 0x63, 0x52, 0xb6, 0x3e, 0x0f, 0x93, 0xe3, 0x22, 0x77, 0x9a, 0xa4, 0x07, 0x91, 0x2e, 0x59,
+    0xb4, 0x13, 0x17, 0x27, 0x73, 0xfd, 0x25, 0x4b, 0x9d, 0xfb, 0x2d, 0x3e, 0x18, 0x50, 0xe0, 0x5f,
+    0xfa, 0xe4, 0x0d, 0x8f, 0x55, 0xc3, 0xbc, 0xde, 0xef, 0x12, 0x29, 0x49, 0x4d, 0x46, 0x86, 0x27,
+    0x64, 0x33, 0x23, 0xb3, 0xdf, 0x2e, 0x50, 0xe1, 0xb2, 0x63, 0x1c, 0x6f, 0x89, 0x14, 0xc6, 0xd0,
+    0x39, 0x63, 0x82, 0x6c, 0x3b, 0xe1, 0xec, 0x5d, 0xef, 0xfb, 0x45, 0x88, 0x19, 0x0a, 0x50, 0xd5,
+    0xde, 0x93, 0x7d, 0xde, 0x33, 0x02, 0xa5, 0x4d, 0x89, 0xf5, 0x86, 0xcc, 0x22, 0xd3, 0xd6, 0x3e,
+    0x4f, 0x48, 0x82, 0xa1, 0xa0, 0xee, 0x83, 0xcf, 0xb0, 0x2e, 0x54, 0x01, 0x0d, 0x27, 0xf4, 0xcb,
+    0x8c, 0x21, 0x06, 0xf4, 0xde, 0xe4, 0x74, 0x52, 0x4d, 0xf3, 0xa3, 0xaa, 0x00, 0x7a, 0x25, 0x29,
+    0x06, 0x85, 0x7a, 0xec, 0x33, 0xba, 0x3c, 0xca, 0x79, 0xb1, 0xda, 0x3c, 0x45, 0xaf, 0xb3, 0x1d,
+    0x16, 0x56, 0x37, 0xa8, 0x4a, 0x8a, 0x66, 0xde, 0xe5, 0xa7, 0xc3, 0x49, 0xbf, 0xc3, 0xa4, 0xb9,
+    0x65, 0x9b, 0x78, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbe, 0xf0, 0xf1, 0x83, 0x59, 0xa7, 0xb2, 0xe4, 0x69,
+    0x75, 0x6c, 0xcf, 0xff, 0x65, 0xfa, 0xb0, 0x38, 0xa9, 0x23, 0x45, 0xbf, 0x08, 0x82, 0x02, 0x86,
+    0x46, 0xf4, 0xdb, 0x40, 0xcc, 0x8c, 0x3c, 0x32, 0xec, 0x7a, 0xd8, 0xe0, 0xa2, 0x4d, 0xa1, 0xa8,
+    0x9b, 0x81, 0x0e, 0x4f, 0xfe, 0x35, 0x84, 0x1b, 0x2c, 0x9a, 0x81, 0xe8, 0x81, 0x54, 0xe7, 0x72,
+    0xbc, 0xe6, 0x7d, 0xad, 0xa2, 0xfc, 0x8a, 0xe1, 0x07, 0x05, 0x1e, 0xfa, 0x40, 0x8c, 0x6d, 0x2d,
+    0xb8, 0x3d, 0x4c, 0xe8, 0x25, 0x71, 0xbd, 0xaf, 0x9d, 0xd2, 0x19, 0x5e, 0x7b, 0x50, 0x34, 0xf4,
+    0xdc, 0x8a, 0xa2, 0xd1, 0x2d, 0x64, 0xeb, 0x1c, 0x04, 0x63, 0x52, 0xb6, 0x3e, 0x0f, 0x93, 0xe3,
+    0x22, 0x77, 0x9a, 0xa4, 0x07, 0x91, 0x2e, 0x59, 0xb4, 0x13, 0x17, 0x27, 0x73, 0xfd, 0x25, 0x4b,
+    0x9d, 0xfb, 0x2d, 0x3e, 0x18, 0x50, 0xe0, 0x5f, 0xfa, 0xe4, 0x0d, 0x8f, 0x55, 0xc3, 0xbc, 0xde,
+    0xef, 0x12, 0x29, 0x49, 0x4d, 0x46, 0x86, 0x27, 0x64, 0x33, 0x23, 0xb3, 0xdf, 0x2e, 0x50, 0xe1,
+    0xb2, 0x63, 0x1c, 0x6f, 0x89, 0x14, 0xc6, 0xd0, 0x39, 0x63, 0x82, 0x6c, 0x3b, 0xe1, 0xec, 0x5d,
+    0xef, 0xfb, 0x45, 0x88, 0x19, 0x0a, 0x50, 0xd5, 0xde, 0x93, 0x7d, 0xde, 0x33, 0x02, 0xa5, 0x4d,
+    0x89, 0xf5, 0x86, 0xcc, 0x22, 0xd3, 0xd6, 0x3e, 0x4f, 0x48, 0x82, 0xa1, 0xa0, 0xee, 0x83, 0xcf,
+    0xb0, 0x2e, 0x54, 0x01, 0x0d, 0x27, 0xf4, 0xcb, 0x8c, 0x21, 0x06, 0xf4, 0xde, 0xe4, 0x74, 0x52,
+    0x4d, 0xf3, 0xa3, 0xaa, 0x00, 0x7a, 0x25, 0x29, 0x06, 0x85, 0x7a, 0xec, 0x33, 0xba, 0x3c, 0xca,
+    0x79, 0xb1, 0xda, 0x3c, 0x45, 0xaf, 0xb3, 0x1d, 0x16, 0x56, 0x37, 0xa8, 0x4a, 0x8a, 0x66, 0xde,
+    0xe5, 0xa7, 0xc3, 0x49, 0xbf, 0xc3, 0xa4, 0xb9, 0x65, 0x9b,
+};
+
+inline constexpr unsigned char kRepeatedWordFast[] = {
+    0x9f, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x61, 0x72, 0x20, 0x09, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7a,
+    0x50, 0x63, 0x6f, 0x6c, 0x75, 0x6d,
+};
+
+inline constexpr unsigned char kRepeatedWordHc[] = {
+    0x9f, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x61, 0x72, 0x20, 0x09, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7a,
+    0x50, 0x63, 0x6f, 0x6c, 0x75, 0x6d,
+};
+
+inline constexpr unsigned char kRepeatedWordGateway[] = {
+    0x9f, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x61, 0x72, 0x20, 0x09, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7a,
+    0x50, 0x63, 0x6f, 0x6c, 0x75, 0x6d,
+};
+
+struct Vector {
+    const char* name;  // input recipe, see lz4_vector_input()
+    std::size_t size;  // input bytes
+    std::span<const unsigned char> fast;     // LZ4_compress_default
+    std::span<const unsigned char> hc;       // LZ4_compress_HC, level 12
+    std::span<const unsigned char> gateway;  // gateway::lz4_compress
+};
+
+inline constexpr Vector kVectors[] = {
+    {"one_byte", 1, kOneByteFast, kOneByteHc, kOneByteGateway},
+    {"below_min_match", 12, kBelowMinMatchFast, kBelowMinMatchHc, kBelowMinMatchGateway},
+    {"metrics_json", 251, kMetricsJsonFast, kMetricsJsonHc, kMetricsJsonGateway},
+    {"long_run", 1000, kLongRunFast, kLongRunHc, kLongRunGateway},
+    {"random", 300, kRandomFast, kRandomHc, kRandomGateway},
+    {"beyond_max_offset", 66512, kBeyondMaxOffsetFast, kBeyondMaxOffsetHc, kBeyondMaxOffsetGateway},
+    {"repeated_word", 5000, kRepeatedWordFast, kRepeatedWordHc, kRepeatedWordGateway},
+};
+
+}  // namespace lz4_vectors
@@ -0,0 +1,261 @@
+#include "gateway/agent_limiter.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Fake clock for testing
+class FakeClock {
+public:
+    std::chrono::steady_clock::time_point now() const { return current_; }
+
+    void advance(std::chrono::steady_clock::duration d) { current_ += d; }
+
+    gateway::Clock as_clock() {
+        return [this]() { return this->now(); };
+    }
+
+private:
+    std::chrono::steady_clock::time_point current_ =
+        std::chrono::steady_clock::time_point{};
+};
+
+gateway::AgentLimiterConfig small_config() {
+    return gateway::AgentLimiterConfig{
+        .tokens_per_sec = 100,
+        .burst_tokens = 100,
+        .sketch_width = 1024,
+        .sketch_depth = 4,
+        .heavy_hitters = 16,
+        .decay_ms = 1000,
+    };
+}
+
+bool test_quiet_agents_admitted() {
+    FakeClock clock;
+    gateway::AgentLimiter limiter(small_config(), clock.as_clock());
+
+    // 50 agents at 10 events/s for 10 s, next to a flood: none is limited
+    for (int sec = 0; sec < 10; ++sec) {
+        for (int tick = 0; tick < 10; ++tick) {
+            for (int a = 0; a < 50; ++a) {
+                const std::string id = "agent-" + std::to_string(a);
+                if (limiter.admit(id) != gateway::Admit::Allow) {
+                    std::printf("Quiet agent %d dropped at %d.%d s\n", a, sec, tick);
+                    return false;
+                }
+            }
+            for (int i = 0; i < 100; ++i) {
+                (void)limiter.admit("flood");
+            }
+            clock.advance(100ms);
+        }
+    }
+    if (limiter.heavy_count() != 1 || !limiter.is_heavy("flood")) {
+        std::printf("Expected only the flood tracked, got %zu\n", limiter.heavy_count());
+        return false;
+    }
+    return true;
+}
+
+bool test_flood_limited_to_rate() {
+    FakeClock clock;
+    gateway::AgentLimiter limiter(small_config(), clock.as_clock());
+
+    // Burst: the sketch admits burst_tokens events, then the bucket starts empty
+    int allowed = 0;
+    for (int i = 0; i < 1000; ++i) {
+        allowed += limiter.admit("flood") == gateway::Admit::Allow;
+    }
+    if (allowed != 100) {
+        std::printf("Expected 100 allowed in the burst, got %d\n", allowed);
+        return false;
+    }
+    if (limiter.promotions() != 1 || limiter.total_drops() != 900) {
+        std::printf("Expected 1 promotion and 900 drops, got %llu / %llu\n",
+                    static_cast<unsigned long long>(limiter.promotions()),
+                    static_cast<unsigned long long>(limiter.total_drops()));
+        return false;
+    }
+
+    // Sustained: 1000 events/s offered, ~100/s admitted
+    allowed = 0;
+    for (int ms = 0; ms < 5000; ++ms) {
+        clock.advance(1ms);
+        allowed += limiter.admit("flood") == gateway::Admit::Allow;
+    }
+    if (allowed < 495 || allowed > 505) {
+        std::printf("Expected ~500 allowed over 5 s, got %d\n", allowed);
+        return false;
+    }
+    return true;
+}
+
+bool test_invented_ids_fixed_memory() {
+    FakeClock clock;
+    gateway::AgentLimiter limiter({}, clock.as_clock());
+    const std::size_t before = limiter.memory_bytes();
+
+    // Each invented id sends once: all admitted, none promoted
+    for (int i = 0; i < 200000; ++i) {
+        const std::string id = "spoofed-" + std::to_string(i);
+        if (limiter.admit(id) != gateway::Admit::Allow) {
+            std::printf("Invented id %d dropped\n", i);
+            return false;
+        }
+    }
+    if (limiter.memory_bytes() != before) {
+        std::printf("Memory grew: %zu -> %zu\n", before, limiter.memory_bytes());
+        return false;
+    }
+    if (limiter.heavy_count() != 0) {
+        std::printf("Expected no heavy hitters, got %zu\n", limiter.heavy_count());
+        return false;
+    }
+    // Default sizing stays small
+    if (before > 256 * 1024) {
+        std::printf("Default state unexpectedly large: %zu bytes\n", before);
+        return false;
+    }
+    return true;
+}
+
+bool test_counts_decay() {
+    FakeClock clock;
+    gateway::AgentLimiter limiter(small_config(), clock.as_clock());
+
+    for (int i = 0; i < 100; ++i) {
+        (void)limiter.admit("bursty");
+    }
+    if (limiter.estimate("bursty", clock.now()) != 100) {
+        std::printf("Expected estimate 100, got %u\n", limiter.estimate("bursty", clock.now()));
+        return false;
+    }
+
+    // One decay interval halves the count
+    clock.advance(1s);
+    if (limiter.estimate("bursty", clock.now()) != 50) {
+        std::printf("Expected estimate 50, got %u\n", limiter.estimate("bursty", clock.now()));
+        return false;
+    }
+
+    // Once decayed, another full burst is admitted without promotion
+    clock.advance(10s);
+    for (int i = 0; i < 100; ++i) {
+        if (limiter.admit("bursty") != gateway::Admit::Allow) {
+            std::printf("Decayed agent dropped at %d\n", i);
+            return false;
+        }
+    }
+    if (limiter.heavy_count() != 0) {
+        std::printf("Decayed agent promoted\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_eviction_repromotes_without_burst() {
+    FakeClock clock;
+    auto config = small_config();
+    config.heavy_hitters = 2;
+    gateway::AgentLimiter limiter(config, clock.as_clock());
+
+    // Three floods compete for two exact buckets
+    for (const char* id : {"flood-a", "flood-b", "flood-c"}) {
+        for (int i = 0; i < 101; ++i) {
+            (void)limiter.admit(id);
+        }
+    }
+    if (limiter.heavy_count() != 2 || limiter.heavy_evictions() != 1) {
+        std::printf("Expected 2 tracked and 1 eviction, got %zu / %llu\n", limiter.heavy_count(),
+                    static_cast<unsigned long long>(limiter.heavy_evictions()));
+        return false;
+    }
+    if (!limiter.is_heavy("flood-c")) {
+        std::printf("Newest flood not tracked\n");
+        return false;
+    }
+
+    // An evicted flood's sketch count is still high: it is dropped at once
+    for (const char* id : {"flood-a", "flood-b", "flood-c"}) {
+        if (limiter.admit(id) != gateway::Admit::Drop) {
+            std::printf("%s got a fresh burst\n", id);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_reconfigure_rate() {
+    FakeClock clock;
+    gateway::AgentLimiter limiter(small_config(), clock.as_clock());
+
+    for (int i = 0; i < 200; ++i) {
+        (void)limiter.admit("flood");
+    }
+    if (!limiter.is_heavy("flood")) {
+        std::printf("Flood not promoted\n");
+        return false;
+    }
+
+    // Higher rate applies to the existing bucket; sizes are unchanged
+    const std::size_t bytes = limiter.memory_bytes();
+    auto config = small_config();
+    config.tokens_per_sec = 1000;
+    config.burst_tokens = 1000;
+    config.sketch_width = 1 << 16;
+    limiter.reconfigure(config);
+    if (limiter.memory_bytes() != bytes || !limiter.is_heavy("flood")) {
+        std::printf("Reconfigure changed sizes or lost the bucket\n");
+        return false;
+    }
+
+    clock.advance(100ms);
+    int allowed = 0;
+    for (int i = 0; i < 1000; ++i) {
+        allowed += limiter.admit("flood") == gateway::Admit::Allow;
+    }
+    if (allowed != 100) {
+        std::printf("Expected 100 allowed at the new rate, got %d\n", allowed);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_quiet_agents_admitted()) {
+        std::printf("test_quiet_agents_admitted failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_flood_limited_to_rate()) {
+        std::printf("test_flood_limited_to_rate failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_invented_ids_fixed_memory()) {
+        std::printf("test_invented_ids_fixed_memory failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_counts_decay()) {
+        std::printf("test_counts_decay failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_eviction_repromotes_without_burst()) {
+        std::printf("test_eviction_repromotes_without_burst failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_reconfigure_rate()) {
+        std::printf("test_reconfigure_rate failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All agent_limiter tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+#include "gateway/aggregate.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+gateway::ValidatedMetrics make_metrics(std::string_view agent, const gateway::Metric* metrics,
+                                       std::size_t count, const gateway::MetricTag* tags) {
+    gateway::ValidatedMetrics v{};
+    v.agent_id = agent;
+    v.seq = 1;
+    v.ts = 1700000000000;
+    v.metrics = metrics;
+    v.metric_count = count;
+    v.tags = tags;
+    return v;
+}
+
+// Copy of a flushed window, keyed "agent/name"
+struct Flushed {
+    std::string agent;
+    std::uint64_t ts = 0;
+    std::uint64_t interval_ms = 0;
+    std::vector<gateway::RollupSeries> series;
+    std::vector<std::string> tag_text;  // "k=v,k=v" per series
+};
+
+std::vector<Flushed> flush_all(gateway::MetricsAggregator& agg, std::uint64_t now_ms) {
+    std::vector<Flushed> out;
+    agg.flush(now_ms, [&](const gateway::RollupEvent& e) {
+        Flushed f{std::string(e.agent_id), e.ts, e.interval_ms, {}, {}};
+        for (const auto& s : e.series) {
+            f.series.push_back(s);
+            std::string text;
+            for (const auto& t : s.tags) {
+                text += std::string(t.key) + "=" + std::string(t.value) + ",";
+            }
+            f.tag_text.push_back(text);
+        }
+        out.push_back(std::move(f));
+    });
+    return out;
+}
+
+bool test_folds_count_sum_min_max() {
+    gateway::MetricsAggregator agg;
+
+    for (double v : {3.0, 1.0, 2.0, 6.0}) {
+        const gateway::MetricTag tags[] = {{"host", "h1"}};
+        const gateway::Metric metrics[] = {{"cpu", v, "pct", 0, 1}};
+        if (agg.add(make_metrics("agent-1", metrics, 1, tags), 1000) != 0) {
+            std::printf("Metric dropped\n");
+            return false;
+        }
+    }
+    if (agg.series_count() != 1 || agg.folded() != 4) {
+        std::printf("Expected 1 series / 4 folded, got %zu / %llu\n", agg.series_count(),
+                    static_cast<unsigned long long>(agg.folded()));
+        return false;
+    }
+
+    const auto flushed = flush_all(agg, 2000);
+    if (flushed.size() != 1 || flushed[0].series.size() != 1) {
+        std::printf("Expected one event with one series\n");
+        return false;
+    }
+    const auto& f = flushed[0];
+    const auto& s = f.series[0];
+    if (f.agent != "agent-1" || f.ts != 1000 || f.interval_ms != 1000 || s.name != "cpu" ||
+        s.unit != "pct" || f.tag_text[0] != "host=h1," || s.count != 4 || s.sum != 12 ||
+        s.min != 1 || s.max != 6) {
+        std::printf("Wrong rollup: count %llu sum %g min %g max %g\n",
+                    static_cast<unsigned long long>(s.count), s.sum, s.min, s.max);
+        return false;
+    }
+    return true;
+}
+
+bool test_tag_order_does_not_split() {
+    gateway::MetricsAggregator agg;
+
+    const gateway::MetricTag tags[] = {{"host", "h1"}, {"dc", "eu"}, {"dc", "eu"}, {"host", "h1"}};
+    const gateway::Metric metrics[] = {
+        {"cpu", 1, "", 0, 2},
+        {"cpu", 2, "", 2, 2},
+    };
+    (void)agg.add(make_metrics("agent-1", metrics, 2, tags), 0);
+    if (agg.series_count() != 1) {
+        std::printf("Tag order split the series: %zu\n", agg.series_count());
+        return false;
+    }
+    const auto flushed = flush_all(agg, 1);
+    return flushed.size() == 1 && flushed[0].tag_text[0] == "dc=eu,host=h1," &&
+           flushed[0].series[0].count == 2;
+}
+
+bool test_keys_separate_series() {
+    gateway::MetricsAggregator agg;
+
+    const gateway::MetricTag tags[] = {{"host", "h1"}, {"host", "h2"}};
+    const gateway::Metric metrics[] = {
+        {"cpu", 1, "", 0, 1},     // host=h1
+        {"cpu", 1, "", 1, 1},     // host=h2
+        {"cpu", 1, "pct", 0, 1},  // other unit
+        {"cpu", 1, "", 0, 0},     // no tags
+        {"mem", 1, "", 0, 1},     // other name
+    };
+    (void)agg.add(make_metrics("agent-1", metrics, 5, tags), 0);
+    (void)agg.add(make_metrics("agent-2", metrics, 5, tags), 0);
+    (void)agg.add(make_metrics("agent-1", metrics, 5, tags), 0);
+    if (agg.series_count() != 10 || agg.agent_count() != 2) {
+        std::printf("Expected 10 series / 2 agents, got %zu / %zu\n", agg.series_count(),
+                    agg.agent_count());
+        return false;
+    }
+
+    // One event per agent; window cleared afterwards
+    const auto flushed = flush_all(agg, 10);
+    if (flushed.size() != 2 || flushed[0].series.size() != 5 || flushed[1].series.size() != 5) {
+        std::printf("Expected 2 events of 5 series\n");
+        return false;
+    }
+    for (const auto& f : flushed) {
+        const std::uint64_t want = f.agent == "agent-1" ? 2 : 1;
+        for (const auto& s : f.series) {
+            if (s.count != want) {
+                std::printf("%s: count %llu, want %llu\n", f.agent.c_str(),
+                            static_cast<unsigned long long>(s.count),
+                            static_cast<unsigned long long>(want));
+                return false;
+            }
+        }
+    }
+    if (agg.series_count() != 0 || agg.agent_count() != 0 || agg.arena_used() != 0 ||
+        !flush_all(agg, 20).empty()) {
+        std::printf("Window not cleared by flush\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_cardinality_caps() {
+    gateway::MetricsAggregator agg(gateway::AggregatorConfig{
+        .max_series = 8, .max_series_per_agent = 3, .max_agents = 2});
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 10; ++i) {
+        names.push_back("m" + std::to_string(i));
+    }
+    std::vector<gateway::Metric> metrics;
+    for (const auto& n : names) {
+        metrics.push_back({n, 1, "", 0, 0});
+    }
+
+    // Per agent: 3 series kept, 7 dropped; existing series keep folding
+    if (agg.add(make_metrics("a", metrics.data(), metrics.size(), nullptr), 0) != 7 ||
+        agg.add(make_metrics("a", metrics.data(), 3, nullptr), 0) != 0) {
+        std::printf("Per-agent cap not applied\n");
+        return false;
+    }
+    // Agent table: a third agent is dropped whole
+    (void)agg.add(make_metrics("b", metrics.data(), 3, nullptr), 0);
+    if (agg.add(make_metrics("c", metrics.data(), 2, nullptr), 0) != 2) {
+        std::printf("Agent cap not applied\n");
+        return false;
+    }
+    if (agg.series_count() != 6 || agg.dropped_cardinality() != 9 || agg.folded() != 9) {
+        std::printf("Expected 6 series / 9 dropped / 9 folded, got %zu / %llu / %llu\n",
+                    agg.series_count(), static_cast<unsigned long long>(agg.dropped_cardinality()),
+                    static_cast<unsigned long long>(agg.folded()));
+        return false;
+    }
+    // A flush frees the window again
+    (void)flush_all(agg, 1);
+    return agg.add(make_metrics("c", metrics.data(), 2, nullptr), 2) == 0;
+}
+
+bool test_arena_full_drops() {
+    gateway::MetricsAggregator agg(gateway::AggregatorConfig{.arena_bytes = 64});
+
+    const std::string long_name(40, 'x');
+    const std::string other_name(40, 'y');
+    const gateway::Metric first[] = {{long_name, 1, "", 0, 0}};
+    const gateway::Metric second[] = {{other_name, 1, "", 0, 0}};
+    if (agg.add(make_metrics("agent-1", first, 1, nullptr), 0) != 0 ||
+        agg.add(make_metrics("agent-1", second, 1, nullptr), 0) != 1) {
+        std::printf("Arena bound not applied\n");
+        return false;
+    }
+    if (agg.dropped_arena() != 1 || agg.arena_used() > 64) {
+        std::printf("Expected 1 arena drop, used %zu\n", agg.arena_used());
+        return false;
+    }
+    // The existing series still folds
+    return agg.add(make_metrics("agent-1", first, 1, nullptr), 0) == 0 && agg.folded() == 2;
+}
+
+bool test_quantiles() {
+    gateway::MetricsAggregator agg(gateway::AggregatorConfig{.quantiles = true});
+
+    for (int i = 1; i <= 1000; ++i) {
+        const gateway::Metric metrics[] = {{"latency", static_cast<double>(i), "ms", 0, 0}};
+        (void)agg.add(make_metrics("agent-1", metrics, 1, nullptr), 0);
+    }
+    const auto flushed = flush_all(agg, 1);
+    if (flushed.size() != 1) {
+        return false;
+    }
+    const auto& s = flushed[0].series[0];
+    const struct {
+        double got;
+        double want;
+    } checks[] = {{s.p50, 500}, {s.p90, 900}, {s.p99, 990}};
+    for (const auto& c : checks) {
+        if (std::fabs(c.got - c.want) > c.want * 0.12) {
+            std::printf("Quantile %g too far from %g\n", c.got, c.want);
+            return false;
+        }
+    }
+
+    // Non-positive values land in the lowest bucket, reported as min
+    gateway::MetricsAggregator neg(gateway::AggregatorConfig{.quantiles = true});
+    for (double v : {-5.0, -3.0, 0.0, 10.0}) {
+        const gateway::Metric metrics[] = {{"temp", v, "", 0, 0}};
+        (void)neg.add(make_metrics("agent-1", metrics, 1, nullptr), 0);
+    }
+    const auto n = flush_all(neg, 1);
+    if (n[0].series[0].p50 != -5.0 || n[0].series[0].p99 < 8.0 || n[0].series[0].p99 > 10.0) {
+        std::printf("Non-positive quantiles wrong: p50 %g p99 %g\n", n[0].series[0].p50,
+                    n[0].series[0].p99);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_folds_count_sum_min_max()) {
+        std::printf("test_folds_count_sum_min_max failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_tag_order_does_not_split()) {
+        std::printf("test_tag_order_does_not_split failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_keys_separate_series()) {
+        std::printf("test_keys_separate_series failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_cardinality_caps()) {
+        std::printf("test_cardinality_caps failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_arena_full_drops()) {
+        std::printf("test_arena_full_drops failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_quantiles()) {
+        std::printf("test_quantiles failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All aggregate tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,421 @@
+#include "gateway/binary_format.hpp"
+#include "gateway/classify.hpp"
+#include "gateway/validate_metrics.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// Binary body format: round trips, limits and hostile-input decoding.
+
+namespace {
+
+using Bytes = std::vector<std::byte>;
+
+// Hand-built bodies for the hostile cases the encoder refuses to produce
+struct Builder {
+    Bytes out;
+
+    Builder& u8(std::uint8_t v) {
+        out.push_back(std::byte{v});
+        return *this;
+    }
+    Builder& be(std::uint64_t v, int n) {
+        for (int i = n - 1; i >= 0; --i) u8(static_cast<std::uint8_t>(v >> (8 * i)));
+        return *this;
+    }
+    Builder& varint(std::uint32_t v) {
+        while (v >= 0x80) {
+            u8(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        return u8(static_cast<std::uint8_t>(v));
+    }
+    Builder& str(std::string_view s) {
+        varint(static_cast<std::uint32_t>(s.size()));
+        for (char c : s) u8(static_cast<std::uint8_t>(c));
+        return *this;
+    }
+    Builder& metrics_header(std::string_view agent = "node-1") {
+        return u8(gateway::BinaryFormat::kMetricsMagic)
+            .u8(gateway::BinaryFormat::kVersion)
+            .be(7, 4)
+            .be(1705689600000, 8)
+            .str(agent);
+    }
+    Builder& metric(std::string_view name, double v) {
+        varint(static_cast<std::uint32_t>(name.size() << 1));
+        for (char c : name) u8(static_cast<std::uint8_t>(c));
+        return be(std::bit_cast<std::uint64_t>(v), 8).str("").varint(0);
+    }
+    Builder& log_header(std::uint8_t level = 2, std::string_view agent = "") {
+        return u8(gateway::BinaryFormat::kLogMagic)
+            .u8(gateway::BinaryFormat::kVersion)
+            .be(1705689600000, 8)
+            .u8(level)
+            .str(agent)
+            .str("hello");
+    }
+};
+
+std::optional<gateway::MetricsDropReason> decode_metrics(const Bytes& b) {
+    static gateway::ParsedMetrics scratch;
+    return gateway::parse_binary_metrics(b, scratch);
+}
+
+std::optional<gateway::LogDropReason> decode_log(const Bytes& b) {
+    static gateway::ParsedLog scratch;
+    return gateway::parse_binary_log(b, scratch);
+}
+
+// Sample message with repeated names, tags and values text can't carry
+gateway::ParsedMetrics sample_metrics() {
+    gateway::ParsedMetrics m{};
+    m.agent_id = "node-1.eu";
+    m.seq = 0xDEADBEEF;
+    m.ts = 1705689600123;
+    const double values[] = {0.1 + 0.2, std::numeric_limits<double>::denorm_min(), -0.0,
+                             1e300, 42.0};
+    const char* names[] = {"cpu", "mem", "cpu", "disk", "cpu"};
+    m.metric_count = 5;
+    m.tag_total = 0;
+    for (std::size_t i = 0; i < 5; ++i) {
+        auto& x = m.metrics[i];
+        x.name = names[i];
+        x.value = values[i];
+        x.unit = (i % 2) ? "ms" : "";
+        x.tag_offset = static_cast<std::uint16_t>(m.tag_total);
+        x.tag_count = static_cast<std::uint16_t>(i % 3);
+        for (std::size_t t = 0; t < x.tag_count; ++t) {
+            m.tags[m.tag_total++] = {t ? "zone" : "host", t ? "eu-1" : "db7"};
+        }
+    }
+    return m;
+}
+
+bool test_metrics_round_trip() {
+    const auto m = sample_metrics();
+    std::array<std::byte, 512> buf{};
+    const std::size_t n = gateway::encode_binary_metrics(m, buf);
+    if (n == 0) return false;
+
+    // Through the normal entry point: dispatch on the magic byte
+    gateway::ParsedMetrics out;
+    if (gateway::parse_metrics(std::span<const std::byte>(buf.data(), n), out)) return false;
+
+    if (out.agent_id != m.agent_id || out.seq != m.seq || out.ts != m.ts ||
+        out.metric_count != m.metric_count || out.tag_total != m.tag_total) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m.metric_count; ++i) {
+        const auto& a = m.metrics[i];
+        const auto& b = out.metrics[i];
+        // Bit-exact values, including -0.0 and denormals
+        if (a.name != b.name || a.unit != b.unit ||
+            std::bit_cast<std::uint64_t>(a.value) != std::bit_cast<std::uint64_t>(b.value)) {
+            return false;
+        }
+        const auto at = m.tags_of(a);
+        const auto bt = out.tags_of(b);
+        if (at.size() != bt.size()) return false;
+        for (std::size_t t = 0; t < at.size(); ++t) {
+            if (at[t].key != bt[t].key || at[t].value != bt[t].value) return false;
+        }
+    }
+
+    // Repeated names are back-references: "cpu" is stored once
+    std::size_t cpu_bytes = 0;
+    for (std::size_t i = 0; i + 3 <= n; ++i) {
+        if (std::memcmp(buf.data() + i, "cpu", 3) == 0) ++cpu_bytes;
+    }
+    return cpu_bytes == 1;
+}
+
+bool test_log_round_trip() {
+    gateway::ParsedLog log{};
+    log.ts = 1705689600000;
+    log.level = gateway::LogLevel::Error;
+    log.agent_id = "worker-3";
+    log.msg = "disk \"full\" = 100%";
+    // Text-parsed logs carry the dedicated fields too; only extras are sent
+    log.fields[0] = {"ts", "1705689600000"};
+    log.fields[1] = {"level", "error"};
+    log.fields[2] = {"zone", "eu"};
+    log.fields[3] = {"req_id", "a1b2"};
+    log.field_count = 4;
+
+    std::array<std::byte, 256> buf{};
+    const std::size_t n = gateway::encode_binary_log(log, buf);
+    if (n == 0) return false;
+
+    gateway::ParsedLog out;
+    if (gateway::parse_log(std::span<const std::byte>(buf.data(), n), out)) return false;
+    return out.ts == log.ts && out.level == log.level && out.agent_id == log.agent_id &&
+           out.msg == log.msg && out.field_count == 2 && out.fields[0].key == "zone" &&
+           out.fields[1].value == "a1b2";
+}
+
+bool test_metrics_limits() {
+    using R = gateway::MetricsDropReason;
+    using L = gateway::MetricsLimits;
+
+    Builder ok;
+    ok.metrics_header().varint(1).metric("cpu", 1.0);
+    if (decode_metrics(ok.out).has_value()) return false;
+
+    struct Case {
+        Bytes body;
+        R reason;
+    };
+    std::vector<Case> cases;
+
+    Builder b;
+    b.metrics_header().varint(L::kMaxMetrics + 1);
+    cases.push_back({b.out, R::TooManyMetrics});
+
+    b = {};
+    b.metrics_header().varint(1).metric(std::string(L::kMaxMetricNameLen + 1, 'n'), 1.0);
+    cases.push_back({b.out, R::MetricNameTooLong});
+
+    b = {};
+    b.metrics_header(std::string(L::kMaxAgentIdLen + 1, 'a')).varint(0);
+    cases.push_back({b.out, R::AgentIdTooLong});
+
+    b = {};
+    b.metrics_header("bad id").varint(0);
+    cases.push_back({b.out, R::AgentIdInvalidChars});
+
+    b = {};
+    b.metrics_header("").varint(0);
+    cases.push_back({b.out, R::AgentIdInvalidChars});
+
+    b = {};
+    b.metrics_header().varint(1).varint(3 << 1).u8('c').u8('p').u8('u')
+        .be(0, 8).str("").varint(L::kMaxTags + 1);
+    cases.push_back({b.out, R::TooManyTags});
+
+    b = {};
+    b.metrics_header().varint(1).varint(3 << 1).u8('c').u8('p').u8('u')
+        .be(0, 8).str(std::string(L::kMaxUnitLen + 1, 'u'));
+    cases.push_back({b.out, R::UnitTooLong});
+
+    // Name reference to itself / a later metric
+    b = {};
+    b.metrics_header().varint(1).varint(0 << 1 | 1);
+    cases.push_back({b.out, R::BinaryMalformed});
+
+    // Trailing bytes after the last metric
+    b = ok;
+    b.u8(0);
+    cases.push_back({b.out, R::BinaryMalformed});
+
+    // Varint longer than 5 bytes
+    b = {};
+    b.metrics_header().u8(0x80).u8(0x80).u8(0x80).u8(0x80).u8(0x80).u8(0x00);
+    cases.push_back({b.out, R::BinaryMalformed});
+
+    // Unknown version
+    b = ok;
+    b.out[1] = std::byte{2};
+    cases.push_back({b.out, R::BinaryUnsupportedVersion});
+
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        if (decode_metrics(cases[i].body) != cases[i].reason) {
+            std::printf("Metrics limit case %zu: wrong drop reason\n", i);
+            return false;
+        }
+    }
+
+    // Total tag pool: 17 metrics x 8 tags > 128
+    b = {};
+    b.metrics_header().varint(17);
+    for (int i = 0; i < 17; ++i) {
+        b.varint(1 << 1).u8('m').be(0, 8).str("").varint(L::kMaxTags);
+        for (std::size_t t = 0; t < L::kMaxTags; ++t) b.str("k").str("v");
+    }
+    return decode_metrics(b.out) == R::TooManyTags;
+}
+
+bool test_log_limits() {
+    using R = gateway::LogDropReason;
+
+    Builder ok;
+    ok.log_header().varint(1).str("zone").str("eu");
+    if (decode_log(ok.out).has_value()) return false;
+
+    struct Case {
+        Bytes body;
+        R reason;
+    };
+    std::vector<Case> cases;
+    Builder b;
+    b.log_header(6).varint(0);
+    cases.push_back({b.out, R::InvalidLevel});
+
+    b = {};
+    b.log_header().varint(1).str("Zone").str("eu");
+    cases.push_back({b.out, R::InvalidKeyChar});
+
+    b = {};
+    b.log_header().varint(1).str("msg").str("again");
+    cases.push_back({b.out, R::BinaryMalformed});
+
+    // 3 dedicated + 13 extra = 16 fields, one more with an agent
+    b = {};
+    b.log_header(2, "node").varint(13);
+    cases.push_back({b.out, R::TooManyFields});
+
+    b = {};
+    b.log_header().varint(1).str(std::string(gateway::LogLimits::kMaxKeyLen + 1, 'k')).str("v");
+    cases.push_back({b.out, R::KeyTooLong});
+
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        if (decode_log(cases[i].body) != cases[i].reason) {
+            std::printf("Log limit case %zu: wrong drop reason\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_truncation_every_prefix() {
+    // Every proper prefix drops (exact-size heap copies catch over-reads)
+    std::array<std::byte, 512> buf{};
+    const std::size_t n = gateway::encode_binary_metrics(sample_metrics(), buf);
+    for (std::size_t len = 0; len < n; ++len) {
+        auto copy = std::make_unique<std::byte[]>(len + 1);
+        std::memcpy(copy.get(), buf.data(), len);
+        gateway::ParsedMetrics out;
+        if (!gateway::parse_binary_metrics(std::span<const std::byte>(copy.get(), len), out)) {
+            std::printf("Prefix of %zu bytes decoded\n", len);
+            return false;
+        }
+        (void)gateway::classify_message(std::span<const std::byte>(copy.get(), len));
+    }
+    return true;
+}
+
+bool test_random_mutations() {
+    // Random byte flips never crash and never break the limits
+    std::array<std::byte, 512> buf{};
+    const std::size_t n = gateway::encode_binary_metrics(sample_metrics(), buf);
+    std::uint32_t rng = 4242;
+    gateway::ParsedMetrics out;
+    for (int i = 0; i < 20000; ++i) {
+        Bytes body(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+        for (int k = 0; k < 3; ++k) {
+            rng = rng * 1103515245u + 12345u;
+            body[(rng >> 8) % n] = std::byte(static_cast<std::uint8_t>(rng >> 24));
+        }
+        if (!gateway::parse_binary_metrics(body, out)) {
+            if (out.metric_count > gateway::MetricsLimits::kMaxMetrics ||
+                out.tag_total > gateway::MetricsLimits::kMaxTotalTags) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool test_encoder_refuses() {
+    auto m = sample_metrics();
+    std::array<std::byte, 16> small{};
+    if (gateway::encode_binary_metrics(m, small) != 0) return false;
+
+    std::string long_name(gateway::MetricsLimits::kMaxMetricNameLen + 1, 'x');
+    m.metrics[0].name = long_name;
+    std::array<std::byte, 1024> buf{};
+    return gateway::encode_binary_metrics(m, buf) == 0;
+}
+
+bool test_pipeline_and_classify() {
+    constexpr std::uint64_t now = 1705689600000;
+    auto m = sample_metrics();
+    m.agent_id = "node-1";
+    m.ts = now;
+    m.metrics[3].value = 5.0;  // 1e300 is out of the TB-4 value range
+    std::array<std::byte, 512> buf{};
+    const std::size_t n = gateway::encode_binary_metrics(m, buf);
+    const std::span<const std::byte> body(buf.data(), n);
+
+    gateway::ParsedMetrics scratch;
+    auto r = gateway::parse_and_validate_metrics(body, gateway::kDefaultMetricsValidation, now,
+                                                 scratch);
+    const auto* v = std::get_if<gateway::ValidatedMetrics>(&r);
+    if (v == nullptr || v->metric_count != 5 || v->agent_id != "node-1") return false;
+
+    auto c = gateway::classify_message(body);
+    const auto* h = std::get_if<gateway::MessageHeader>(&c);
+    if (h == nullptr || !h->binary || h->format != gateway::MessageFormat::Metrics ||
+        h->agent_id != "node-1" || h->ts != now) {
+        return false;
+    }
+
+    // Header-only reject on the fixed-position ts
+    if (gateway::check_header(*h, gateway::kDefaultTimestampWindow, now + 3'600'000) !=
+        gateway::PrefilterDrop::TimestampTooOld) {
+        return false;
+    }
+
+    // Unknown magic is not a format
+    const std::byte junk[] = {std::byte{0xFF}, std::byte{1}};
+    auto u = gateway::classify_message(std::span<const std::byte>(junk));
+    const auto* d = std::get_if<gateway::PrefilterDrop>(&u);
+    return d != nullptr && *d == gateway::PrefilterDrop::UnknownFormat;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_metrics_round_trip()) {
+        std::printf("test_metrics_round_trip failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_log_round_trip()) {
+        std::printf("test_log_round_trip failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_metrics_limits()) {
+        std::printf("test_metrics_limits failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_log_limits()) {
+        std::printf("test_log_limits failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_truncation_every_prefix()) {
+        std::printf("test_truncation_every_prefix failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_random_mutations()) {
+        std::printf("test_random_mutations failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_encoder_refuses()) {
+        std::printf("test_encoder_refuses failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_pipeline_and_classify()) {
+        std::printf("test_pipeline_and_classify failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All binary_format tests passed\n");
+    return EXIT_SUCCESS;
+}
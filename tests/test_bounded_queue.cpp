@@ -3,6 +3,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -273,6 +274,28 @@ bool test_interleaved_push_pop() {
     return true;
 }
 
+bool test_bulk_push_pop() {
+    gateway::BoundedQueue<int> queue(3);
+
+    // Bulk push beyond capacity: fits 3, drops 2
+    std::vector<int> in = {1, 2, 3, 4, 5};
+    if (queue.try_push_n(in) != 3) return false;
+    if (queue.drop_count() != 2) return false;
+
+    // Bulk pop into a larger span returns what is there, FIFO
+    std::vector<int> out(5, 0);
+    if (queue.try_pop_n(out) != 3) return false;
+    if (out[0] != 1 || out[1] != 2 || out[2] != 3) return false;
+
+    // Pop into reference on empty queue
+    int v = -1;
+    if (queue.try_pop(v)) return false;
+    queue.try_push(7);
+    if (!queue.try_pop(v) || v != 7) return false;
+
+    return true;
+}
+
 }  // namespace
 
 int main() {
@@ -336,6 +359,11 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    if (!test_bulk_push_pop()) {
+        std::printf("test_bulk_push_pop failed\n");
+        return EXIT_FAILURE;
+    }
+
     std::printf("All bounded_queue tests passed\n");
     return EXIT_SUCCESS;
 }
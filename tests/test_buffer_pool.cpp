@@ -0,0 +1,246 @@
+#include "gateway/buffer_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool test_acquire_release() {
+    gateway::BufferPool pool(2, 64);
+
+    if (pool.capacity() != 2) return false;
+    if (pool.available() != 2) return false;
+    if (pool.buffer_bytes() != 64) return false;
+
+    {
+        auto h = pool.acquire();
+        if (!h) return false;
+        if (h.bytes().size() != 64) return false;
+        if (pool.available() != 1) return false;
+    }
+
+    // Handle destroyed -> buffer back in pool
+    if (pool.available() != 2) {
+        std::printf("Expected buffer returned on handle destruction\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool test_exhaustion_does_not_grow() {
+    gateway::BufferPool pool(2, 16);
+
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    auto c = pool.acquire();
+
+    if (!a || !b) return false;
+
+    // Third acquire fails: pool never grows
+    if (c) {
+        std::printf("Expected empty handle from exhausted pool\n");
+        return false;
+    }
+    if (!c.bytes().empty()) return false;
+    if (pool.exhausted_count() != 1) return false;
+
+    a.reset();
+    auto d = pool.acquire();
+    if (!d) {
+        std::printf("Expected acquire to succeed after release\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool test_buffers_are_distinct() {
+    gateway::BufferPool pool(4, 32);
+
+    std::vector<gateway::BufferHandle> handles;
+    for (int i = 0; i < 4; ++i) {
+        handles.push_back(pool.acquire());
+        if (!handles.back()) return false;
+    }
+
+    // Write a distinct pattern to each buffer, then verify none overlap
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        for (auto& b : handles[i].bytes()) {
+            b = static_cast<std::byte>(i + 1);
+        }
+    }
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        for (auto b : handles[i].bytes()) {
+            if (b != static_cast<std::byte>(i + 1)) {
+                std::printf("Buffer %zu overlaps another buffer\n", i);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool test_handle_move_semantics() {
+    gateway::BufferPool pool(1, 8);
+
+    auto a = pool.acquire();
+    std::byte* data = a.bytes().data();
+
+    // Move construct: ownership transfers, source empty
+    gateway::BufferHandle b(std::move(a));
+    if (a || !b) return false;
+    if (b.bytes().data() != data) return false;
+    if (pool.available() != 0) return false;
+
+    // Move assign into a handle that owns nothing
+    gateway::BufferHandle c;
+    c = std::move(b);
+    if (b || !c) return false;
+    if (pool.available() != 0) return false;
+
+    // Move assign over an owning handle releases the old buffer exactly once
+    gateway::BufferHandle d;
+    c = std::move(d);
+    if (c) return false;
+    if (pool.available() != 1) {
+        std::printf("Expected buffer released on move-assign\n");
+        return false;
+    }
+
+    // Reset on empty handle is a no-op
+    c.reset();
+    if (pool.available() != 1) return false;
+
+    return true;
+}
+
+bool test_zero_capacity_pool() {
+    gateway::BufferPool pool(0, 64);
+
+    if (pool.acquire()) return false;
+    if (pool.exhausted_count() != 1) return false;
+
+    return true;
+}
+
+
+bool test_index_acquire_release() {
+    gateway::BufferPool pool(2, 16);
+
+    const gateway::BufferIndex a = pool.acquire_index();
+    const gateway::BufferIndex b = pool.acquire_index();
+    if (a == gateway::kNoBuffer || b == gateway::kNoBuffer || a == b) return false;
+    if (pool.buffer(a).size() != 16 || pool.available() != 0) return false;
+
+    if (pool.acquire_index() != gateway::kNoBuffer) {
+        std::printf("Expected kNoBuffer from exhausted pool\n");
+        return false;
+    }
+    if (pool.exhausted_count() != 1) return false;
+
+    pool.release(a);
+    if (pool.available() != 1 || pool.acquire_index() != a) return false;
+
+    // Indices and handles share one free list
+    pool.release(a);
+    pool.release(b);
+    auto h = pool.acquire();
+    return h && pool.available() == 1;
+}
+
+bool test_index_release_in_any_order() {
+    constexpr std::size_t kBuffers = 16;
+    gateway::BufferPool pool(kBuffers, 8);
+
+    std::vector<gateway::BufferIndex> held;
+    for (std::size_t i = 0; i < kBuffers; ++i) {
+        held.push_back(pool.acquire_index());
+    }
+
+    // Release odd indices first, then even ones in reverse
+    for (std::size_t i = 1; i < kBuffers; i += 2) {
+        pool.release(held[i]);
+    }
+    for (std::size_t i = kBuffers; i-- > 0;) {
+        if (i % 2 == 0) {
+            pool.release(held[i]);
+        }
+    }
+    if (pool.available() != kBuffers) return false;
+
+    // Every buffer can be handed out again, each exactly once
+    std::vector<gateway::BufferIndex> again;
+    for (std::size_t i = 0; i < kBuffers; ++i) {
+        again.push_back(pool.acquire_index());
+    }
+    std::sort(again.begin(), again.end());
+    for (std::size_t i = 0; i < kBuffers; ++i) {
+        if (again[i] != i) {
+            std::printf("Expected index %zu after reuse, got %u\n", i, again[i]);
+            return false;
+        }
+    }
+    return pool.acquire_index() == gateway::kNoBuffer;
+}
+
+bool test_release_foreign_index_ignored() {
+    gateway::BufferPool pool(1, 8);
+
+    // An index that was never handed out (or is out of range) is ignored
+    pool.release(0);
+    pool.release(7);
+    pool.release(gateway::kNoBuffer);
+    return pool.available() == 1;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_acquire_release()) {
+        std::printf("test_acquire_release failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_exhaustion_does_not_grow()) {
+        std::printf("test_exhaustion_does_not_grow failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_buffers_are_distinct()) {
+        std::printf("test_buffers_are_distinct failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_handle_move_semantics()) {
+        std::printf("test_handle_move_semantics failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_zero_capacity_pool()) {
+        std::printf("test_zero_capacity_pool failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_index_acquire_release()) {
+        std::printf("test_index_acquire_release failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_index_release_in_any_order()) {
+        std::printf("test_index_release_in_any_order failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_release_foreign_index_ignored()) {
+        std::printf("test_release_foreign_index_ignored failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All buffer_pool tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+#include "gateway/char_class.hpp"
+#include "gateway/keyword_table.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+// Character-class table and compile-time keyword tables.
+
+namespace {
+
+namespace chars = gateway::chars;
+
+// Reference predicates: the range comparisons the table replaces
+bool ref_digit(unsigned char c) { return c >= '0' && c <= '9'; }
+bool ref_lower(unsigned char c) { return c >= 'a' && c <= 'z'; }
+bool ref_alpha(unsigned char c) { return ref_lower(c) || (c >= 'A' && c <= 'Z'); }
+
+bool test_table_matches_reference() {
+    for (unsigned v = 0; v < 256; ++v) {
+        const auto u = static_cast<unsigned char>(v);
+        const auto c = static_cast<char>(u);
+        const bool checks[][2] = {
+            {chars::is(c, chars::kDigit), ref_digit(u)},
+            {chars::is(c, chars::kAlpha), ref_alpha(u)},
+            {chars::is(c, chars::kAgentIdChar),
+             ref_alpha(u) || ref_digit(u) || u == '_' || u == '-'},
+            {chars::is(c, chars::kJsonAgentIdChar),
+             ref_alpha(u) || ref_digit(u) || u == '_' || u == '-' || u == '.'},
+            {chars::is(c, chars::kLogKeyStart), ref_lower(u) || u == '_'},
+            {chars::is(c, chars::kLogKeyChar), ref_lower(u) || ref_digit(u) || u == '_'},
+            {chars::is(c, chars::kJsonSpace), u == ' ' || u == '\t' || u == '\n' || u == '\r'},
+            {chars::is(c, chars::kLogBlank), u == ' ' || u == '\t'},
+        };
+        for (std::size_t k = 0; k < sizeof(checks) / sizeof(checks[0]); ++k) {
+            if (checks[k][0] != checks[k][1]) {
+                std::printf("Class %zu wrong for byte 0x%02x\n", k, v);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool test_all_of_and_span_of() {
+    static_assert(chars::all_of("abc_09", 6, chars::kLogKeyChar));
+    static_assert(!chars::all_of("abc-09", 6, chars::kLogKeyChar));
+    static_assert(chars::all_of("", 0, chars::kDigit));
+
+    const std::string id = "node-42_x";
+    if (!chars::all_of(id.data(), id.size(), chars::kAgentIdChar)) return false;
+
+    // A single bad byte anywhere fails, including high bytes
+    for (std::size_t i = 0; i < id.size(); ++i) {
+        std::string bad = id;
+        bad[i] = static_cast<char>(0xC3);
+        if (chars::all_of(bad.data(), bad.size(), chars::kAgentIdChar)) return false;
+    }
+
+    if (chars::span_of("level=info", 10, chars::kLogKeyChar) != 5) return false;
+    if (chars::span_of("12345", 5, chars::kDigit) != 5) return false;
+    if (chars::span_of("x1", 2, chars::kDigit) != 0) return false;
+
+    return true;
+}
+
+enum class Root : std::uint8_t { AgentId, Seq, Ts, Metrics, Unknown };
+enum class Level : std::uint8_t { Trace, Debug, Info, Warn, Error, Fatal, Unknown };
+enum class Letter : std::uint8_t { N, V, U, T, Unknown };
+
+constexpr gateway::KeywordTable<Root, 4> kRoot({"agent_id", "seq", "ts", "metrics"});
+constexpr gateway::KeywordTable<Level, 6> kLevel(
+    {"trace", "debug", "info", "warn", "error", "fatal"});
+constexpr gateway::KeywordTable<Letter, 4> kLetter({"n", "v", "u", "t"});
+
+// Lookups are usable in constant expressions
+static_assert(kRoot.find("metrics") == Root::Metrics);
+static_assert(kLevel.find("warn") == Level::Warn);
+static_assert(kLetter.find("t") == Letter::T);
+static_assert(kLetter.find("tags") == Letter::Unknown);
+
+bool test_keyword_lookup() {
+    const std::string_view roots[] = {"agent_id", "seq", "ts", "metrics"};
+    for (std::size_t i = 0; i < 4; ++i) {
+        if (kRoot.find(roots[i]) != static_cast<Root>(i)) return false;
+    }
+    const std::string_view levels[] = {"trace", "debug", "info", "warn", "error", "fatal"};
+    for (std::size_t i = 0; i < 6; ++i) {
+        if (kLevel.find(levels[i]) != static_cast<Level>(i)) return false;
+    }
+
+    // Near misses: same length and first/last byte (same slot), prefixes,
+    // suffixes, case changes, embedded NUL, empty
+    const std::string_view misses[] = {
+        "agent_xd", "agent_i", "agent_idd", "Agent_id", "sq", "sea", "tss", "t", "s",
+        "metricx", "metric", std::string_view("ts\0", 3), "", "tags", "seq ",
+    };
+    for (auto m : misses) {
+        if (kRoot.find(m) != Root::Unknown) {
+            std::printf("Unexpected root key match\n");
+            return false;
+        }
+    }
+    const std::string_view level_misses[] = {"INFO", "inf", "infos", "iNfo", "warm", "fatel",
+                                             "tracf", "", "e", "error\n"};
+    for (auto m : level_misses) {
+        if (kLevel.find(m) != Level::Unknown) {
+            std::printf("Unexpected level match\n");
+            return false;
+        }
+    }
+
+    // Every single-byte string: only the four schema letters match
+    for (unsigned v = 0; v < 256; ++v) {
+        const char c = static_cast<char>(v);
+        const Letter got = kLetter.find(std::string_view(&c, 1));
+        const bool member = c == 'n' || c == 'v' || c == 'u' || c == 't';
+        if ((got != Letter::Unknown) != member) return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_table_matches_reference()) {
+        std::printf("test_table_matches_reference failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_all_of_and_span_of()) {
+        std::printf("test_all_of_and_span_of failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_keyword_lookup()) {
+        std::printf("test_keyword_lookup failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All char_class tests passed\n");
+    return EXIT_SUCCESS;
+}
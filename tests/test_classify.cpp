@@ -0,0 +1,260 @@
+#include "gateway/classify.hpp"
+#include "gateway/parse_log.hpp"
+#include "gateway/parse_metrics.hpp"
+#include "gateway/validate_log.hpp"
+#include "gateway/validate_metrics.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+
+// Pre-filter tests: format detection, header extraction, and soundness
+// against the full TB-3/TB-4 pipeline.
+
+namespace {
+
+constexpr std::uint64_t kNow = 1705689600000;
+
+const gateway::MessageHeader* header_of(const gateway::ClassifyResult& r) {
+    return std::get_if<gateway::MessageHeader>(&r);
+}
+
+bool is_drop(const gateway::ClassifyResult& r, gateway::PrefilterDrop reason) {
+    const auto* d = std::get_if<gateway::PrefilterDrop>(&r);
+    return d != nullptr && *d == reason;
+}
+
+// Pre-filter verdict: true if classify or the header check drops
+bool prefilter_drops(std::string_view body) {
+    auto r = gateway::classify_message(body);
+    const auto* h = header_of(r);
+    if (h == nullptr) {
+        return true;
+    }
+    return gateway::check_header(*h, gateway::kDefaultTimestampWindow, kNow).has_value();
+}
+
+// Full pipeline verdict (format chosen by the message itself)
+bool pipeline_accepts(std::string_view body, bool as_log) {
+    if (as_log) {
+        gateway::ParsedLog parsed;
+        if (gateway::parse_log(body, parsed)) return false;
+        auto v = gateway::validate_log(parsed, gateway::kDefaultLogValidation, kNow);
+        return std::holds_alternative<gateway::ValidatedLog>(v);
+    }
+    gateway::ParsedMetrics parsed;
+    auto v = gateway::parse_and_validate_metrics(body, gateway::kDefaultMetricsValidation, kNow,
+                                                 parsed);
+    return std::holds_alternative<gateway::ValidatedMetrics>(v);
+}
+
+bool test_formats_and_header() {
+    const std::string json = R"(  {"agent_id": "node-1", "seq": 7, "ts": )" +
+                             std::to_string(kNow) + R"(, "metrics": [{"n": "cpu", "v": 1}]})";
+    auto r = gateway::classify_message(json);
+    const auto* h = header_of(r);
+    if (h == nullptr || h->format != gateway::MessageFormat::Metrics) return false;
+    if (h->agent_id != "node-1" || !h->has_ts || h->ts != kNow) return false;
+    // The scan stops at the metrics value; the array is never examined
+    if (h->header_bytes != json.find('[')) return false;
+
+    const std::string log = "ts=" + std::to_string(kNow) +
+                            " level=info agent=node-2 msg=\"hello world\" extra=1\n";
+    auto r2 = gateway::classify_message(log);
+    const auto* h2 = header_of(r2);
+    if (h2 == nullptr || h2->format != gateway::MessageFormat::Log) return false;
+    if (h2->agent_id != "node-2" || !h2->has_ts || h2->ts != kNow) return false;
+    if (h2->header_bytes != log.find(" extra")) return false;
+
+    return true;
+}
+
+bool test_structural_drops() {
+    using gateway::PrefilterDrop;
+    struct Case {
+        std::string_view body;
+        PrefilterDrop reason;
+    };
+    const Case cases[] = {
+        {"", PrefilterDrop::EmptyInput},
+        {" \t\r\n", PrefilterDrop::EmptyInput},
+        {"\x01\x02\x03garbage", PrefilterDrop::UnknownFormat},
+        {"Ts=1 level=info msg=x", PrefilterDrop::UnknownFormat},
+        {"[1, 2, 3]", PrefilterDrop::UnknownFormat},
+        {"{", PrefilterDrop::Malformed},
+        {"{}", PrefilterDrop::MissingFormatKey},
+        {R"({"agent_id": "a", "seq": 1})", PrefilterDrop::MissingFormatKey},
+        {R"({"agent_id": 5, "metrics": []})", PrefilterDrop::Malformed},
+        {R"({"extra": 1, "metrics": []})", PrefilterDrop::Malformed},
+        {R"({"seq": 1.5, "metrics": []})", PrefilterDrop::Malformed},
+        {R"({"agent_id": "unterminated)", PrefilterDrop::Malformed},
+        {"ts=1 level=info", PrefilterDrop::MissingFormatKey},
+        {"ts=1 level=info msg=\"open", PrefilterDrop::Malformed},
+        {"ts=1 Level=info msg=x", PrefilterDrop::Malformed},
+        {"ts=1 level", PrefilterDrop::Malformed},
+    };
+    for (const auto& c : cases) {
+        if (!is_drop(gateway::classify_message(c.body), c.reason)) {
+            std::printf("Wrong pre-filter result for: %.*s\n", static_cast<int>(c.body.size()),
+                        c.body.data());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_header_reject() {
+    using gateway::PrefilterDrop;
+    const gateway::TimestampWindow window = gateway::kDefaultTimestampWindow;
+    auto check = [&window](std::string_view body) {
+        auto r = gateway::classify_message(body);
+        return gateway::check_header(std::get<gateway::MessageHeader>(r), window, kNow);
+    };
+
+    const std::string old_ts = std::to_string(kNow - 600'000);
+    const std::string future_ts = std::to_string(kNow + 600'000);
+    const std::string now_ts = std::to_string(kNow);
+
+    if (check(R"({"agent_id": "9node", "metrics": [)") != PrefilterDrop::AgentIdInvalidFormat) {
+        return false;
+    }
+    if (check(R"({"ts": )" + old_ts + R"(, "metrics": [)") != PrefilterDrop::TimestampTooOld) {
+        return false;
+    }
+    if (check("ts=" + future_ts + " level=info msg=x") != PrefilterDrop::TimestampInFuture) {
+        return false;
+    }
+    if (check("ts=" + now_ts + " agent=no.de level=info msg=x") !=
+        PrefilterDrop::AgentIdInvalidFormat) {
+        return false;
+    }
+
+    // An escaped JSON agent_id is left to TB-3/TB-4, which decode it first
+    const std::string escaped = R"({"agent_id":"a\u0062c","seq":1,"ts":)" + now_ts +
+                                R"(,"metrics":[{"n":"x","v":1}]})";
+    if (check(escaped).has_value() || prefilter_drops(escaped) ||
+        !pipeline_accepts(escaped, false)) {
+        return false;
+    }
+
+    // Absent or zero fields are left to TB-3/TB-4
+    if (check(R"({"metrics": [)").has_value()) return false;
+    if (check(R"({"ts": 0, "metrics": [)").has_value()) return false;
+    if (check("ts=" + now_ts + " level=info msg=x").has_value()) return false;
+
+    return true;
+}
+
+// Message with one random mutation applied (or none)
+std::string mutated_message(std::uint32_t& rng, bool& as_log) {
+    auto next = [&rng] {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 16;
+    };
+    const std::uint64_t ts = kNow - 700'000 + (next() % 2000) * 500;  // straddles the window
+    const std::string agent = (next() % 4 == 0) ? "9bad" : "node-" + std::to_string(next() % 50);
+
+    std::string body;
+    as_log = next() % 2 == 0;
+    if (as_log) {
+        body = "ts=" + std::to_string(ts) + " level=" + ((next() % 8 == 0) ? "loud" : "warn") +
+               " agent=" + agent + " msg=\"disk at " + std::to_string(next() % 100) + "%\"";
+        if (next() % 2 == 0) body += " zone=eu";
+    } else {
+        body = R"({"agent_id": ")" + agent + R"(", "seq": )" + std::to_string(next() % 100) +
+               R"(, "ts": )" + std::to_string(ts) +
+               R"(, "metrics": [{"n": "cpu", "v": )" + std::to_string(next() % 100) + "}]}";
+    }
+
+    // Mutations: flip a byte, drop a byte, truncate, or leave intact
+    switch (next() % 4) {
+        case 0: {
+            const std::size_t at = next() % body.size();
+            body[at] = static_cast<char>("\"={} =x9\\\x80"[next() % 10]);
+            break;
+        }
+        case 1:
+            body.erase(next() % body.size(), 1);
+            break;
+        case 2:
+            body.resize(next() % body.size());
+            break;
+        default:
+            break;
+    }
+    return body;
+}
+
+bool test_sound_against_pipeline() {
+    // A pre-filter drop must never hide a message the pipeline accepts
+    std::uint32_t rng = 777;
+    int accepted = 0;
+    int prefiltered = 0;
+    for (int i = 0; i < 20000; ++i) {
+        bool as_log = false;
+        const std::string body = mutated_message(rng, as_log);
+        const bool dropped = prefilter_drops(body);
+        const bool ok = pipeline_accepts(body, as_log);
+        if (dropped && ok) {
+            std::printf("Pre-filter dropped an accepted message: %s\n", body.c_str());
+            return false;
+        }
+        accepted += ok ? 1 : 0;
+        prefiltered += dropped ? 1 : 0;
+    }
+    // Both outcomes must actually be exercised
+    return accepted > 1000 && prefiltered > 1000;
+}
+
+bool test_never_reads_past_end() {
+    // Every prefix of a valid message in an exact-size heap buffer
+    const std::string bodies[] = {
+        R"({"agent_id": "node-1", "seq": 1, "ts": 1705689600000, "metrics": [])",
+        "ts=1705689600000 level=info agent=node-1 msg=\"quoted value\"",
+    };
+    for (const auto& body : bodies) {
+        for (std::size_t n = 0; n <= body.size(); ++n) {
+            auto buf = std::make_unique<char[]>(n == 0 ? 1 : n);
+            std::memcpy(buf.get(), body.data(), n);
+            (void)gateway::classify_message(std::string_view(buf.get(), n));
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_formats_and_header()) {
+        std::printf("test_formats_and_header failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_structural_drops()) {
+        std::printf("test_structural_drops failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_header_reject()) {
+        std::printf("test_header_reject failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_sound_against_pipeline()) {
+        std::printf("test_sound_against_pipeline failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_never_reads_past_end()) {
+        std::printf("test_never_reads_past_end failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All classify tests passed\n");
+    return EXIT_SUCCESS;
+}
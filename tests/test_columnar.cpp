@@ -0,0 +1,611 @@
+#include "gateway/columnar.hpp"
+
+#include "gateway/aggregate.hpp"
+#include "gateway/serialize.hpp"
+
+#include "lz4_vectors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+std::span<const std::byte> bytes_of(const std::string& s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+std::string metrics_json(std::string_view agent, std::uint32_t seq, std::uint64_t ts,
+                         const gateway::Metric* metrics, std::size_t count,
+                         const gateway::MetricTag* tags) {
+    gateway::ValidatedMetrics v{};
+    v.agent_id = agent;
+    v.seq = seq;
+    v.ts = ts;
+    v.metrics = metrics;
+    v.metric_count = count;
+    v.tags = tags;
+    std::array<std::byte, 4096> buf{};
+    const std::size_t n = gateway::serialize_event(v, buf);
+    return std::string(reinterpret_cast<const char*>(buf.data()), n);
+}
+
+std::string log_json(std::string_view agent, std::uint64_t ts, gateway::LogLevel level,
+                     std::string_view msg, const gateway::LogField* fields, std::size_t count) {
+    const gateway::ValidatedLog v{agent, ts, level, msg, fields, count};
+    std::array<std::byte, 4096> buf{};
+    const std::size_t n = gateway::serialize_event(v, buf);
+    return std::string(reinterpret_cast<const char*>(buf.data()), n);
+}
+
+// Decode a block into strings; `ok` set to the decoder's result
+std::vector<std::string> decode(std::span<const std::byte> block, bool& ok) {
+    std::vector<std::string> out;
+    std::vector<std::byte> scratch;
+    ok = gateway::decode_columnar_block(block, scratch, [&](std::span<const std::byte> e) {
+        out.emplace_back(reinterpret_cast<const char*>(e.data()), e.size());
+    });
+    return out;
+}
+
+bool expect_events(const std::vector<std::string>& got, const std::vector<std::string>& want) {
+    if (got.size() != want.size()) {
+        std::printf("Decoded %zu events, want %zu\n", got.size(), want.size());
+        return false;
+    }
+    for (std::size_t i = 0; i < want.size(); ++i) {
+        if (got[i] != want[i]) {
+            std::printf("Event %zu:\n  want %s\n   got %s\n", i, want[i].c_str(), got[i].c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// A mixed stream: escapes, null values, non-ASCII, ts going backwards,
+// seq wrapping, logs with and without agent and fields, and a rollup
+std::vector<std::string> sample_events() {
+    std::vector<std::string> events;
+
+    const gateway::MetricTag tags[] = {{"host", "h1"}, {"dc", "eu"}, {"q\"x", "\\\n\x01"}};
+    const gateway::Metric metrics[] = {
+        {"cpu", 0.5, "pct", 0, 2},
+        {"mem", 1024, "", 2, 0},
+        {"temp", -0.0, "C", 2, 1},
+        {"bad", std::numeric_limits<double>::quiet_NaN(), "", 0, 0},
+        {"caf\xc3\xa9", 1e300, "", 0, 1},
+    };
+    events.push_back(metrics_json("agent-1", 7, 1700000000000, metrics, 5, tags));
+    events.push_back(metrics_json("agent-2", UINT32_MAX, 1700000000500, metrics, 2, tags));
+    events.push_back(metrics_json("agent-1", 0, 1699999999000, metrics + 1, 1, tags));
+    events.push_back(metrics_json("", 3, 0, nullptr, 0, nullptr));
+
+    const gateway::LogField fields[] = {{"disk", "sda"}, {"path", "/var/\"log\""}};
+    events.push_back(log_json("agent-1", 1700000000100, gateway::LogLevel::Error, "disk full",
+                              fields, 2));
+    events.push_back(log_json("", 1700000000050, gateway::LogLevel::Trace, "", nullptr, 0));
+    events.push_back(log_json("agent-3", UINT64_MAX, gateway::LogLevel::Fatal,
+                              "line\nbreak \xe2\x9c\x93", fields + 1, 1));
+
+    const gateway::MetricTag rollup_tags[] = {{"host", "h1"}};
+    const gateway::RollupSeries series[] = {{"cpu", "pct", rollup_tags, 3, 1.5, 0.2, 0.9}};
+    const gateway::RollupEvent rollup{"agent-1", 1700000000000, 1000, false, series};
+    std::array<std::byte, 1024> buf{};
+    std::size_t written = 0;
+    const std::size_t n = gateway::serialize_rollup(rollup, buf, written);
+    events.emplace_back(reinterpret_cast<const char*>(buf.data()), n);
+
+    events.push_back(metrics_json("agent-2", 8, 1700000000600, metrics, 3, tags));
+    return events;
+}
+
+// Inputs behind lz4_vectors.hpp; keep in step with INPUTS in
+// tests/gen_lz4_vectors.py (a mismatch fails the size or decode checks)
+std::vector<std::byte> lcg_bytes(std::uint32_t seed, std::size_t n) {
+    std::vector<std::byte> out(n);
+    for (auto& b : out) {
+        seed = seed * 1103515245u + 12345u;
+        b = std::byte(static_cast<std::uint8_t>(seed >> 24));
+    }
+    return out;
+}
+
+std::vector<std::byte> lz4_vector_input(std::string_view name) {
+    auto text = [](std::string_view s) {
+        const auto b = std::as_bytes(std::span(s.data(), s.size()));
+        return std::vector<std::byte>(b.begin(), b.end());
+    };
+    if (name == "one_byte") return text("x");
+    if (name == "below_min_match") return text("columnar col");
+    if (name == "metrics_json") {
+        return text(R"({"type":"metrics","agent_id":"web-01","seq":1,"ts":1700000000000,)"
+                    R"("metrics":[{"n":"cpu","v":0.5,"u":"pct","t":{"host":"h1"}}]})"
+                    R"({"type":"metrics","agent_id":"web-01","seq":2,"ts":1700000001000,)"
+                    R"("metrics":[{"n":"cpu","v":0.75,"u":"pct","t":{"host":"h1"}}]})");
+    }
+    if (name == "long_run") return std::vector<std::byte>(1000, std::byte{'a'});
+    if (name == "random") return lcg_bytes(1, 300);
+    if (name == "beyond_max_offset") {
+        auto out = lcg_bytes(2, 256);
+        out.insert(out.end(), 66000, std::byte{'x'});
+        const auto again = lcg_bytes(2, 256);
+        out.insert(out.end(), again.begin(), again.end());
+        return out;
+    }
+    if (name == "repeated_word") {
+        std::vector<std::byte> out(5000);
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            out[i] = std::byte(static_cast<std::uint8_t>("columnar "[i % 9]));
+        }
+        return out;
+    }
+    return {};
+}
+
+// Walk an LZ4 block by the format spec alone and check what a conforming
+// encoder must produce: offsets within the output so far, the last
+// sequence literals only, no match starting in the last 12 bytes and no
+// match reaching the last 5
+bool follows_lz4_block_rules(std::span<const std::byte> in, std::size_t size) {
+    std::size_t pos = 0;
+    std::size_t produced = 0;
+    auto length = [&](std::size_t base, std::size_t& len) {
+        len = base;
+        if (base != 15) return true;
+        for (std::uint8_t b = 255; b == 255; len += b) {
+            if (pos == in.size()) return false;
+            b = static_cast<std::uint8_t>(in[pos++]);
+        }
+        return true;
+    };
+    while (pos < in.size()) {
+        const auto token = static_cast<std::uint8_t>(in[pos++]);
+        std::size_t literals = 0;
+        if (!length(token >> 4, literals) || in.size() - pos < literals) return false;
+        pos += literals;
+        produced += literals;
+        if (pos == in.size()) {
+            return produced == size;  // Last sequence: literals only
+        }
+        if (in.size() - pos < 2) return false;
+        const std::size_t offset = static_cast<std::uint8_t>(in[pos]) |
+                                   static_cast<std::size_t>(static_cast<std::uint8_t>(in[pos + 1])) << 8;
+        pos += 2;
+        std::size_t match = 0;
+        if (!length(token & 0x0f, match)) return false;
+        match += 4;
+        if (offset == 0 || offset > produced || produced + 12 > size ||
+            produced + match + 5 > size) {
+            return false;
+        }
+        produced += match;
+    }
+    return false;  // Empty, or ended after a match
+}
+
+bool test_round_trip() {
+    gateway::ColumnarEncoder encoder;
+    const auto events = sample_events();
+    for (const auto& e : events) {
+        if (!encoder.add(bytes_of(e))) {
+            std::printf("add() refused an event\n");
+            return false;
+        }
+    }
+    if (encoder.events() != events.size() || encoder.metric_rows() != 5 ||
+        encoder.log_rows() != 3 || encoder.raw_rows() != 1) {
+        std::printf("Expected 5 metric / 3 log / 1 raw rows, got %llu / %llu / %llu\n",
+                    static_cast<unsigned long long>(encoder.metric_rows()),
+                    static_cast<unsigned long long>(encoder.log_rows()),
+                    static_cast<unsigned long long>(encoder.raw_rows()));
+        return false;
+    }
+
+    const auto block = encoder.finish();
+    bool ok = false;
+    if (!expect_events(decode(block, ok), events) || !ok) {
+        return false;
+    }
+    // The encoder starts a fresh block
+    return encoder.empty() && encoder.symbol_count() == 0 && encoder.finish().empty();
+}
+
+bool test_non_canonical_is_raw() {
+    gateway::ColumnarEncoder encoder;
+    const std::vector<std::string> events = {
+        "{\"type\":\"metrics\", \"agent_id\":\"a\",\"seq\":1,\"ts\":1,\"metrics\":[]}",
+        "{\"type\":\"metrics\",\"agent_id\":\"a\",\"seq\":01,\"ts\":1,\"metrics\":[]}",
+        "{\"type\":\"metrics\",\"agent_id\":\"a\",\"seq\":1,\"ts\":1,"
+        "\"metrics\":[{\"n\":\"x\",\"v\":1.50}]}",
+        "{\"type\":\"metrics\",\"agent_id\":\"a\",\"seq\":1,\"ts\":1,"
+        "\"metrics\":[{\"n\":\"x\",\"v\":1,\"u\":\"\"}]}",
+        "{\"type\":\"metrics\",\"agent_id\":\"a\",\"seq\":4294967296,\"ts\":1,\"metrics\":[]}",
+        "{\"type\":\"log\",\"ts\":1,\"level\":\"loud\",\"msg\":\"m\"}",
+        "{\"type\":\"log\",\"ts\":1,\"level\":\"info\",\"msg\":\"m\",\"fields\":{}}",
+        "{\"type\":\"log\",\"ts\":1,\"level\":\"info\",\"msg\":\"m\"}trailing",
+        "not json at all",
+        "",
+    };
+    for (const auto& e : events) {
+        (void)encoder.add(bytes_of(e));
+    }
+    if (encoder.raw_rows() != events.size()) {
+        std::printf("Expected %zu raw rows, got %llu\n", events.size(),
+                    static_cast<unsigned long long>(encoder.raw_rows()));
+        return false;
+    }
+    bool ok = false;
+    return expect_events(decode(encoder.finish(), ok), events) && ok;
+}
+
+bool test_dictionary_shrinks_egress() {
+    gateway::ColumnarEncoder encoder;
+    std::vector<std::string> events;
+    std::size_t json_bytes = 0;
+
+    const gateway::MetricTag tags[] = {{"host", "web-01.eu-west.example"}, {"dc", "eu-west-1"}};
+    for (std::uint32_t i = 0; i < 500; ++i) {
+        const gateway::Metric metrics[] = {
+            {"cpu.user", 0.25 * (i % 7), "percent", 0, 2},
+            {"mem.resident", 1024.0 * i, "bytes", 0, 2},
+        };
+        const std::string agent = "agent-" + std::to_string(i % 3);
+        events.push_back(metrics_json(agent, 1000 + i / 3, 1700000000000 + i * 10, metrics, 2, tags));
+        json_bytes += events.back().size();
+        if (!encoder.add(bytes_of(events.back()))) {
+            std::printf("add() refused event %u\n", i);
+            return false;
+        }
+    }
+    const auto block = encoder.finish();
+    if (block.size() * 4 > json_bytes) {
+        std::printf("Block %zu bytes for %zu JSON bytes\n", block.size(), json_bytes);
+        return false;
+    }
+    bool ok = false;
+    return expect_events(decode(block, ok), events) && ok;
+}
+
+bool test_block_bounds() {
+    const gateway::Metric metrics[] = {{"m", 1, "", 0, 0}};
+    const std::string event = metrics_json("a", 1, 1, metrics, 1, nullptr);
+
+    // Event bound
+    gateway::ColumnarEncoder small(gateway::ColumnarConfig{.max_block_events = 3});
+    for (int i = 0; i < 3; ++i) {
+        if (!small.add(bytes_of(event))) {
+            return false;
+        }
+    }
+    if (!small.full() || small.add(bytes_of(event))) {
+        std::printf("Event bound not applied\n");
+        return false;
+    }
+    (void)small.finish();
+    if (!small.add(bytes_of(event))) {
+        std::printf("Fresh block refused an event\n");
+        return false;
+    }
+
+    // Dictionary bound: an event is refused whole when its strings do not fit
+    gateway::ColumnarEncoder dict(gateway::ColumnarConfig{.max_symbols = 4});
+    const gateway::Metric three[] = {{"x", 1, "", 0, 0}, {"y", 1, "", 0, 0}};
+    const std::string first = metrics_json("a", 1, 1, three, 2, nullptr);   // a, x, y
+    const std::string second = metrics_json("b", 1, 1, three, 2, nullptr);  // needs up to 3 more
+    if (!dict.add(bytes_of(first)) || dict.add(bytes_of(second)) || dict.events() != 1) {
+        std::printf("Dictionary bound not applied\n");
+        return false;
+    }
+    (void)dict.finish();
+    if (!dict.add(bytes_of(second))) {
+        return false;
+    }
+
+    // More strings than the whole dictionary: carried raw
+    const gateway::MetricTag tags[] = {{"k1", "v1"}, {"k2", "v2"}};
+    const gateway::Metric wide[] = {{"m", 1, "u", 0, 2}};
+    const std::string big = metrics_json("c", 1, 1, wide, 1, tags);
+    if (!dict.add(bytes_of(big)) || dict.raw_rows() != 1) {
+        std::printf("Oversized event not carried raw\n");
+        return false;
+    }
+    bool ok = false;
+    return expect_events(decode(dict.finish(), ok), {second, big}) && ok;
+}
+
+bool test_lz4_round_trip() {
+    std::mt19937 rng(7);
+    std::vector<std::vector<std::byte>> inputs;
+    for (std::size_t n : {1u, 5u, 12u, 13u, 64u, 1000u, 70000u}) {
+        std::vector<std::byte> random(n);
+        for (auto& b : random) {
+            b = std::byte(static_cast<std::uint8_t>(rng()));
+        }
+        inputs.push_back(random);
+
+        std::vector<std::byte> repetitive(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            repetitive[i] = std::byte(static_cast<std::uint8_t>("columnar "[i % 9]));
+        }
+        inputs.push_back(repetitive);
+    }
+    // Run lengths past the 15 + 255 length encodings, and far offsets
+    inputs.emplace_back(100000, std::byte{'a'});
+
+    for (const auto& in : inputs) {
+        std::vector<std::byte> packed(gateway::lz4_compress_bound(in.size()));
+        const std::size_t n = gateway::lz4_compress(in, packed);
+        if (n == 0) {
+            std::printf("Compression of %zu bytes failed\n", in.size());
+            return false;
+        }
+        if (!follows_lz4_block_rules(std::span(packed).first(n), in.size())) {
+            std::printf("Compression of %zu bytes broke the LZ4 block rules\n", in.size());
+            return false;
+        }
+        std::vector<std::byte> out(in.size());
+        if (!gateway::lz4_decompress(std::span(packed).first(n), out) || out != in) {
+            std::printf("Round trip of %zu bytes failed\n", in.size());
+            return false;
+        }
+        // Wrong expected size is an error
+        std::vector<std::byte> longer(in.size() + 1);
+        if (gateway::lz4_decompress(std::span(packed).first(n), longer)) {
+            std::printf("Decompression into a larger buffer accepted\n");
+            return false;
+        }
+    }
+    // Repetitive input shrinks; too small an output fails cleanly
+    std::vector<std::byte> packed(gateway::lz4_compress_bound(inputs.back().size()));
+    const std::size_t n = gateway::lz4_compress(inputs.back(), packed);
+    std::vector<std::byte> tiny(8);
+    if (n * 50 > inputs.back().size() || gateway::lz4_compress(inputs.back(), tiny) != 0) {
+        std::printf("Repetitive input packed to %zu bytes\n", n);
+        return false;
+    }
+
+    // Garbage never decodes out of bounds (run under sanitizers)
+    std::vector<std::byte> garbage(64);
+    std::vector<std::byte> out(256);
+    for (int i = 0; i < 20000; ++i) {
+        for (auto& b : garbage) {
+            b = std::byte(static_cast<std::uint8_t>(rng()));
+        }
+        (void)gateway::lz4_decompress(std::span(garbage).first(rng() % garbage.size()), out);
+    }
+    return true;
+}
+
+bool test_lz4_reference_vectors() {
+    // Interop with liblz4 through vectors that tests/gen_lz4_vectors.py
+    // produced and checked against it (no build dependency on the library)
+    for (const auto& v : lz4_vectors::kVectors) {
+        const std::vector<std::byte> input = lz4_vector_input(v.name);
+        if (input.size() != v.size) {
+            std::printf("%s: input is %zu bytes, vectors say %zu\n", v.name, input.size(), v.size);
+            return false;
+        }
+
+        // liblz4 -> gateway: both reference compressors' output decodes
+        for (const auto& reference : {v.fast, v.hc}) {
+            std::vector<std::byte> out(input.size());
+            if (!gateway::lz4_decompress(std::as_bytes(reference), out) || out != input) {
+                std::printf("%s: liblz4 output did not decode\n", v.name);
+                return false;
+            }
+            if (!follows_lz4_block_rules(std::as_bytes(reference), input.size())) {
+                std::printf("%s: rule check rejects liblz4 output\n", v.name);
+                return false;
+            }
+        }
+
+        // gateway -> liblz4: the encoder still emits the bytes that
+        // LZ4_decompress_safe restored; after a deliberate encoder change,
+        // rerun the generator, which re-verifies them
+        std::vector<std::byte> packed(gateway::lz4_compress_bound(input.size()));
+        const std::size_t n = gateway::lz4_compress(input, packed);
+        const auto pinned = std::as_bytes(v.gateway);
+        if (n != pinned.size() || !std::equal(pinned.begin(), pinned.end(), packed.begin())) {
+            std::printf("%s: encoder output changed; rerun tests/gen_lz4_vectors.py\n", v.name);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_compressed_block() {
+    gateway::ColumnarEncoder plain;
+    gateway::ColumnarEncoder packed(gateway::ColumnarConfig{.compress = true});
+    std::vector<std::string> events;
+    const gateway::LogField fields[] = {{"request", "GET /api/v1/items HTTP/1.1"}};
+    for (int i = 0; i < 200; ++i) {
+        events.push_back(log_json("agent-1", 1700000000000 + i, gateway::LogLevel::Info,
+                                  "request served in " + std::to_string(i % 10) + " ms", fields, 1));
+        (void)plain.add(bytes_of(events.back()));
+        (void)packed.add(bytes_of(events.back()));
+    }
+    const auto plain_block = plain.finish();
+    const std::size_t plain_size = plain_block.size();
+    const auto block = packed.finish();
+    if (packed.compressed_blocks() != 1 || block.size() * 2 > plain_size) {
+        std::printf("Compressed block %zu bytes vs %zu plain\n", block.size(), plain_size);
+        return false;
+    }
+    bool ok = false;
+    if (!expect_events(decode(block, ok), events) || !ok) {
+        return false;
+    }
+
+    // Incompressible bodies are stored as is (never larger than plain)
+    std::mt19937 rng(3);
+    std::string noise(2000, '\0');
+    for (auto& c : noise) {
+        c = static_cast<char>(rng());
+    }
+    gateway::ColumnarEncoder noisy(gateway::ColumnarConfig{.compress = true});
+    gateway::ColumnarEncoder noisy_plain;
+    (void)noisy.add(bytes_of(noise));
+    (void)noisy_plain.add(bytes_of(noise));
+    const std::size_t noisy_plain_size = noisy_plain.finish().size();
+    const auto noisy_block = noisy.finish();
+    if (noisy_block.size() > noisy_plain_size) {
+        std::printf("Compressed noise grew to %zu from %zu\n", noisy_block.size(), noisy_plain_size);
+        return false;
+    }
+    return expect_events(decode(noisy_block, ok), {noise}) && ok;
+}
+
+bool test_malformed_blocks() {
+    for (bool compress : {false, true}) {
+        gateway::ColumnarEncoder encoder(gateway::ColumnarConfig{.compress = compress});
+        const auto events = sample_events();
+        for (int copy = 0; copy < 4; ++copy) {
+            for (const auto& e : events) {
+                (void)encoder.add(bytes_of(e));
+            }
+        }
+        const auto view = encoder.finish();
+        const std::vector<std::byte> block(view.begin(), view.end());
+
+        // Every truncation fails
+        for (std::size_t len = 0; len < block.size(); ++len) {
+            bool ok = true;
+            (void)decode(std::span(block).first(len), ok);
+            if (ok) {
+                std::printf("Truncation to %zu of %zu bytes accepted\n", len, block.size());
+                return false;
+            }
+        }
+        // Byte flips never read out of bounds (run under sanitizers)
+        std::mt19937 rng(compress ? 2 : 1);
+        for (int i = 0; i < 5000; ++i) {
+            auto corrupt = block;
+            corrupt[rng() % corrupt.size()] ^= std::byte(static_cast<std::uint8_t>(1 + rng() % 255));
+            bool ok = false;
+            (void)decode(corrupt, ok);
+        }
+    }
+    return true;
+}
+
+// Copies every payload it is given
+class RecordingSink final : public gateway::Sink {
+public:
+    explicit RecordingSink(std::vector<std::vector<std::byte>>& out, bool fail = false)
+        : out_(out), fail_(fail) {}
+
+    [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override {
+        if (fail_) {
+            return false;
+        }
+        out_.emplace_back(payload.begin(), payload.end());
+        return true;
+    }
+
+private:
+    std::vector<std::vector<std::byte>>& out_;
+    bool fail_;
+};
+
+bool test_columnar_sink() {
+    std::vector<std::vector<std::byte>> blocks;
+    const auto events = sample_events();  // 9 events
+    {
+        gateway::ColumnarSink sink(std::make_unique<RecordingSink>(blocks),
+                                   gateway::ColumnarConfig{.max_block_events = 4,
+                                                           .max_delay = std::chrono::hours(1)});
+        std::vector<std::span<const std::byte>> batch;
+        for (const auto& e : events) {
+            batch.push_back(bytes_of(e));
+        }
+        if (sink.write_batch(batch) != events.size() || blocks.size() != 2) {
+            std::printf("Expected 2 full blocks shipped, got %zu\n", blocks.size());
+            return false;
+        }
+        sink.flush();
+        if (blocks.size() != 3 || sink.blocks_written() != 3 || sink.bytes_out() == 0 ||
+            sink.bytes_in() == 0) {
+            std::printf("flush() did not ship the open block\n");
+            return false;
+        }
+        // Destruction ships what is still open
+        if (!sink.write(bytes_of(events[0]))) {
+            return false;
+        }
+    }
+    std::vector<std::string> decoded;
+    for (const auto& block : blocks) {
+        bool ok = false;
+        for (auto& e : decode(block, ok)) {
+            decoded.push_back(std::move(e));
+        }
+        if (!ok) {
+            std::printf("Shipped block does not decode\n");
+            return false;
+        }
+    }
+    auto want = events;
+    want.push_back(events[0]);
+    if (!expect_events(decoded, want)) {
+        return false;
+    }
+
+    // A rejected block counts its events as dropped
+    std::vector<std::vector<std::byte>> none;
+    gateway::ColumnarSink failing(std::make_unique<RecordingSink>(none, true));
+    (void)failing.write(bytes_of(events[0]));
+    (void)failing.write(bytes_of(events[1]));
+    failing.flush();
+    return failing.dropped_events() == 2 && failing.blocks_written() == 0;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_round_trip()) {
+        std::printf("test_round_trip failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_non_canonical_is_raw()) {
+        std::printf("test_non_canonical_is_raw failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_dictionary_shrinks_egress()) {
+        std::printf("test_dictionary_shrinks_egress failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_block_bounds()) {
+        std::printf("test_block_bounds failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_lz4_round_trip()) {
+        std::printf("test_lz4_round_trip failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_lz4_reference_vectors()) {
+        std::printf("test_lz4_reference_vectors failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_compressed_block()) {
+        std::printf("test_compressed_block failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_malformed_blocks()) {
+        std::printf("test_malformed_blocks failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_columnar_sink()) {
+        std::printf("test_columnar_sink failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All columnar tests passed\n");
+    return EXIT_SUCCESS;
+}
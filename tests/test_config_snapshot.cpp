@@ -0,0 +1,209 @@
+#include "gateway/config_snapshot.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Counts live instances, to observe reclamation
+struct Tracked {
+    static inline std::atomic<int> live{0};
+
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;  // always a * 3: readers check for torn snapshots
+
+    Tracked() { ++live; }
+    Tracked(std::uint64_t v) : a(v), b(v * 3) { ++live; }
+    Tracked(const Tracked& o) : a(o.a), b(o.b) { ++live; }
+    Tracked(Tracked&& o) noexcept : a(o.a), b(o.b) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { --live; }
+};
+
+bool test_publish_and_read() {
+    gateway::ConfigSnapshot<gateway::RuntimeConfig> config;
+    auto reader = config.make_reader();
+    if (!reader || config.version() != 1 || reader->version() != 1) {
+        std::printf("Expected an attached reader at version 1\n");
+        return false;
+    }
+    if (reader->read().source_limiter.tokens_per_sec != gateway::SourceLimiterConfig{}.tokens_per_sec) {
+        std::printf("Expected default config in the first snapshot\n");
+        return false;
+    }
+
+    auto next = config.load();
+    next.source_limiter.tokens_per_sec = 5000;
+    next.metrics_validation.timestamp_window.max_age_ms = 1000;
+    if (config.publish(next) != 2) {
+        std::printf("Expected version 2 from publish\n");
+        return false;
+    }
+
+    const auto& current = reader->read();
+    if (reader->version() != 2 || current.source_limiter.tokens_per_sec != 5000 ||
+        current.metrics_validation.timestamp_window.max_age_ms != 1000) {
+        std::printf("Reader did not see the published snapshot\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_reclaim_waits_for_readers() {
+    Tracked::live = 0;
+    {
+        gateway::ConfigSnapshot<Tracked> config(Tracked(1));
+        auto fast = config.make_reader();
+        auto slow = config.make_reader();
+        if (!fast || !slow) {
+            std::printf("Failed to attach readers\n");
+            return false;
+        }
+        const Tracked& held = slow->read();  // slow keeps version 1
+
+        (void)config.publish(Tracked(2));
+        (void)fast->read();
+        (void)config.publish(Tracked(3));
+        (void)fast->read();
+
+        // Versions 1 and 2 are retired; slow still holds 1
+        if (config.reclaim() != 2 || held.a != 1 || held.b != 3) {
+            std::printf("Expected 2 retired snapshots while slow holds v1\n");
+            return false;
+        }
+
+        // slow moves on: both old snapshots can go
+        if (slow->read().a != 3 || config.reclaim() != 0) {
+            std::printf("Expected retired snapshots freed after slow reads\n");
+            return false;
+        }
+        if (Tracked::live != 1) {
+            std::printf("Expected one live snapshot, got %d\n", Tracked::live.load());
+            return false;
+        }
+
+        // A detached reader does not hold anything back
+        slow->reset();
+        (void)config.publish(Tracked(4));
+        (void)fast->read();
+        if (config.reclaim() != 0) {
+            std::printf("Detached reader delayed reclamation\n");
+            return false;
+        }
+    }
+    if (Tracked::live != 0) {
+        std::printf("Leaked %d snapshots\n", Tracked::live.load());
+        return false;
+    }
+    return true;
+}
+
+bool test_reader_limit() {
+    gateway::ConfigSnapshot<int> config(0);
+    std::vector<gateway::ConfigSnapshot<int>::Reader> readers;
+    for (std::size_t i = 0; i < gateway::ConfigSnapshot<int>::kMaxReaders; ++i) {
+        auto reader = config.make_reader();
+        if (!reader) {
+            std::printf("make_reader failed below the limit (%zu)\n", i);
+            return false;
+        }
+        readers.push_back(std::move(*reader));
+    }
+    if (config.make_reader()) {
+        std::printf("make_reader should fail at the limit\n");
+        return false;
+    }
+
+    // Detaching frees a slot; moved-from readers are detached
+    readers.pop_back();
+    auto again = config.make_reader();
+    if (!again || !again->attached()) {
+        std::printf("Expected a free slot after detaching\n");
+        return false;
+    }
+    auto moved = std::move(*again);
+    if (again->attached() || !moved.attached()) {
+        std::printf("Move did not transfer the slot\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_concurrent_readers() {
+    constexpr int kReaders = 4;
+    constexpr std::uint64_t kPublishes = 20000;
+    Tracked::live = 0;
+    bool ok = true;
+    {
+        gateway::ConfigSnapshot<Tracked> config(Tracked(0));
+        std::atomic<bool> done{false};
+        std::atomic<int> torn{0};
+        std::atomic<int> backwards{0};
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < kReaders; ++r) {
+            auto reader = config.make_reader();
+            threads.emplace_back([&, reader = std::move(*reader)]() mutable {
+                std::uint64_t last = 0;
+                while (!done.load(std::memory_order_acquire)) {
+                    const Tracked& t = reader.read();
+                    if (t.b != t.a * 3) ++torn;
+                    if (t.a < last) ++backwards;
+                    last = t.a;
+                }
+            });
+        }
+
+        for (std::uint64_t v = 1; v <= kPublishes; ++v) {
+            (void)config.publish(Tracked(v));
+        }
+        done.store(true, std::memory_order_release);
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        if (torn != 0 || backwards != 0) {
+            std::printf("Readers saw %d torn and %d out-of-order snapshots\n", torn.load(),
+                        backwards.load());
+            ok = false;
+        }
+        // All readers are gone: everything but the current snapshot frees
+        if (config.reclaim() != 0 || Tracked::live != 1) {
+            std::printf("Expected full reclamation, %d live\n", Tracked::live.load());
+            ok = false;
+        }
+    }
+    return ok && Tracked::live == 0;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_publish_and_read()) {
+        std::printf("test_publish_and_read failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_reclaim_waits_for_readers()) {
+        std::printf("test_reclaim_waits_for_readers failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_reader_limit()) {
+        std::printf("test_reader_limit failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_concurrent_readers()) {
+        std::printf("test_concurrent_readers failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All config_snapshot tests passed\n");
+    return EXIT_SUCCESS;
+}
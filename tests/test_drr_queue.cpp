@@ -0,0 +1,213 @@
+#include "gateway/drr_queue.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Item tagged with its flow and per-flow sequence number
+struct Item {
+    std::uint32_t flow = 0;
+    std::uint32_t seq = 0;
+};
+
+using Queue = gateway::DrrQueue<Item>;
+
+// Pop everything, returning the flow of each item in order
+std::vector<std::uint32_t> drain_flows(Queue& q) {
+    std::vector<std::uint32_t> order;
+    Item item;
+    while (q.try_pop(item)) {
+        order.push_back(item.flow);
+    }
+    return order;
+}
+
+bool expect_order(const std::vector<std::uint32_t>& got, const std::vector<std::uint32_t>& want) {
+    if (got == want) {
+        return true;
+    }
+    std::printf("Expected order:");
+    for (auto f : want) std::printf(" %u", f);
+    std::printf("\n     got order:");
+    for (auto f : got) std::printf(" %u", f);
+    std::printf("\n");
+    return false;
+}
+
+bool test_single_flow_is_fifo() {
+    Queue q(8, 4, 100);
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        if (q.try_push(Item{2, i}, 2, 10) != gateway::PushResult::Ok) return false;
+    }
+    if (q.size() != 5 || q.flow_size(2) != 5 || q.active_flows() != 1) return false;
+
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        auto item = q.try_pop();
+        if (!item || item->seq != i) return false;
+    }
+    return q.empty() && q.active_flows() == 0 && !q.try_pop();
+}
+
+bool test_round_robin_equal_cost() {
+    // One item per visit (cost == quantum): flows alternate
+    Queue q(32, 4, 10);
+    for (std::uint32_t i = 0; i < 5; ++i) (void)q.try_push(Item{0, i}, 0, 10);
+    for (std::uint32_t i = 0; i < 5; ++i) (void)q.try_push(Item{1, i}, 1, 10);
+    for (std::uint32_t i = 0; i < 2; ++i) (void)q.try_push(Item{2, i}, 2, 10);
+
+    return expect_order(drain_flows(q), {0, 1, 2, 0, 1, 2, 0, 1, 0, 1, 0, 1});
+}
+
+bool test_burst_does_not_delay_late_flow() {
+    Queue q(64, 4, 10);
+    for (std::uint32_t i = 0; i < 40; ++i) (void)q.try_push(Item{0, i}, 0, 10);
+
+    // Drain part of the burst, then a quiet flow arrives
+    Item item;
+    for (int i = 0; i < 3; ++i) (void)q.try_pop(item);
+    (void)q.try_push(Item{1, 0}, 1, 10);
+
+    // Served after at most one more item of the burst, not after 37
+    for (int i = 0; i < 2; ++i) {
+        if (!q.try_pop(item)) return false;
+        if (item.flow == 1) return true;
+    }
+    std::printf("Late flow was not served within one round\n");
+    return false;
+}
+
+bool test_weights_scale_share() {
+    Queue q(32, 4, 10);
+    for (std::uint32_t i = 0; i < 9; ++i) (void)q.try_push(Item{0, i}, 0, 10, 3);
+    for (std::uint32_t i = 0; i < 3; ++i) (void)q.try_push(Item{1, i}, 1, 10, 1);
+
+    return expect_order(drain_flows(q), {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1});
+}
+
+bool test_cost_is_bytes_not_items() {
+    // Same quantum: one 100-byte item per round vs four 25-byte items
+    Queue q(32, 4, 100);
+    for (std::uint32_t i = 0; i < 2; ++i) (void)q.try_push(Item{0, i}, 0, 100);
+    for (std::uint32_t i = 0; i < 8; ++i) (void)q.try_push(Item{1, i}, 1, 25);
+
+    return expect_order(drain_flows(q), {0, 1, 1, 1, 1, 0, 1, 1, 1, 1});
+}
+
+bool test_deficit_carries_over() {
+    // Cost above the quantum: flow 0 needs two visits per item
+    Queue q(8, 4, 100);
+    (void)q.try_push(Item{0, 0}, 0, 150);
+    (void)q.try_push(Item{0, 1}, 0, 50);
+    (void)q.try_push(Item{1, 0}, 1, 100);
+    (void)q.try_push(Item{1, 1}, 1, 100);
+
+    // visit 0: 100 < 150 -> skip; flow 1 serves one; visit 0: 200 -> serves
+    // 150, then 50 left covers the 50-byte item
+    return expect_order(drain_flows(q), {1, 0, 0, 1});
+}
+
+bool test_bounded_capacity() {
+    Queue q(3, 2, 10);
+    if (q.capacity() != 3) return false;
+    for (std::uint32_t i = 0; i < 3; ++i) {
+        if (q.try_push(Item{0, i}, i % 2, 10) != gateway::PushResult::Ok) return false;
+    }
+    if (!q.full()) return false;
+    if (q.try_push(Item{}, 0, 10) != gateway::PushResult::Dropped) return false;
+
+    Item item;
+    (void)q.try_pop(item);
+    // Out-of-range flow ids are dropped, never indexed
+    if (q.try_push(Item{}, 2, 10) != gateway::PushResult::Dropped) return false;
+    if (q.drop_count() != 2) return false;
+
+    // Freed nodes are reused
+    return q.try_push(Item{}, 1, 10) == gateway::PushResult::Ok && q.size() == 3;
+}
+
+bool test_random_ops_keep_flow_order() {
+    constexpr std::uint32_t kFlows = 16;
+    Queue q(64, kFlows, 64);
+    std::mt19937 rng(19);
+    std::vector<std::uint32_t> next_push(kFlows, 0);
+    std::vector<std::uint32_t> next_pop(kFlows, 0);
+    std::size_t expected_size = 0;
+
+    for (int step = 0; step < 200000; ++step) {
+        if (rng() % 2 == 0) {
+            const std::uint32_t flow = rng() % 4 == 0 ? 0 : rng() % kFlows;  // flow 0 is bursty
+            const std::uint32_t cost = 1 + rng() % 64;
+            const auto r = q.try_push(Item{flow, next_push[flow]}, flow, cost, 1 + flow % 3);
+            if (r == gateway::PushResult::Ok) {
+                ++next_push[flow];
+                ++expected_size;
+            } else if (!q.full()) {
+                return false;
+            }
+        } else {
+            Item item;
+            if (q.try_pop(item)) {
+                if (item.seq != next_pop[item.flow]++) {
+                    std::printf("Flow %u out of order\n", item.flow);
+                    return false;
+                }
+                --expected_size;
+            } else if (expected_size != 0) {
+                return false;
+            }
+        }
+        if (q.size() != expected_size) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_single_flow_is_fifo()) {
+        std::printf("test_single_flow_is_fifo failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_round_robin_equal_cost()) {
+        std::printf("test_round_robin_equal_cost failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_burst_does_not_delay_late_flow()) {
+        std::printf("test_burst_does_not_delay_late_flow failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_weights_scale_share()) {
+        std::printf("test_weights_scale_share failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_cost_is_bytes_not_items()) {
+        std::printf("test_cost_is_bytes_not_items failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_deficit_carries_over()) {
+        std::printf("test_deficit_carries_over failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_bounded_capacity()) {
+        std::printf("test_bounded_capacity failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_random_ops_keep_flow_order()) {
+        std::printf("test_random_ops_keep_flow_order failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All drr_queue tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,401 @@
+#include "gateway/event_loop.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// Fake clock for testing
+class FakeClock {
+public:
+    std::chrono::steady_clock::time_point now() const { return current_; }
+
+    void advance(std::chrono::steady_clock::duration d) { current_ += d; }
+
+    gateway::Clock as_clock() {
+        return [this]() { return this->now(); };
+    }
+
+private:
+    std::chrono::steady_clock::time_point current_ =
+        std::chrono::steady_clock::time_point{};
+};
+
+// Helper to create a UDP socket bound to a random port, returns fd and port
+std::pair<int, std::uint16_t> create_test_socket() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return {-1, 0};
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    socklen_t len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+        close(fd);
+        return {-1, 0};
+    }
+    return {fd, ntohs(addr.sin_port)};
+}
+
+bool send_to_port(std::uint16_t port, const char* msg) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return false;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    const std::size_t len = std::strlen(msg);
+    ssize_t sent = sendto(fd, msg, len, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    close(fd);
+    return sent == static_cast<ssize_t>(len);
+}
+
+gateway::EventLoopConfig small_config() {
+    gateway::EventLoopConfig config;
+    config.spin_window = microseconds(200);
+    config.max_block = milliseconds(2);  // keep real waits in tests short
+    return config;
+}
+
+bool test_idle_loop_blocks() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    FakeClock clock;
+    gateway::RecvLoop recv_loop(fd, gateway::RecvConfig{});
+    gateway::EventLoop loop(recv_loop, small_config(), clock.as_clock());
+
+    // No traffic yet: block for max_block rather than spin
+    if (loop.next_wait() != milliseconds(2)) {
+        std::printf("Expected idle wait of 2ms, got %lld us\n",
+                    static_cast<long long>(loop.next_wait().count()));
+        close(fd);
+        return false;
+    }
+
+    const std::size_t got = loop.run_once();
+    const auto& m = loop.metrics();
+    if (got != 0 || m.waits != 1 || m.idle_wakeups != 1 || m.polls != 0) {
+        std::printf("Expected one idle wait, got %zu results, waits=%llu polls=%llu\n", got,
+                    static_cast<unsigned long long>(m.waits), static_cast<unsigned long long>(m.polls));
+        close(fd);
+        return false;
+    }
+
+    // A blocking wait that returns data counts as a wait, not an idle wakeup
+    send_to_port(port, "one");
+    if (loop.run_once() != 1 || m.waits != 2 || m.idle_wakeups != 1 || m.batches != 1) {
+        std::printf("Expected a second wait with data, waits=%llu idle_wakeups=%llu\n",
+                    static_cast<unsigned long long>(m.waits),
+                    static_cast<unsigned long long>(m.idle_wakeups));
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_spins_after_data_then_blocks() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    FakeClock clock;
+    gateway::RecvLoop recv_loop(fd, gateway::RecvConfig{});
+    gateway::EventLoop loop(recv_loop, small_config(), clock.as_clock());
+
+    std::size_t handled = 0;
+    loop.on_batch([&](std::span<gateway::RecvResult> batch) { handled += batch.size(); });
+
+    send_to_port(port, "one");
+    send_to_port(port, "two");
+    for (int i = 0; i < 10 && handled < 2; ++i) {
+        (void)loop.run_once();
+    }
+    if (handled != 2 || loop.metrics().batches == 0) {
+        std::printf("Expected 2 datagrams handled, got %zu\n", handled);
+        close(fd);
+        return false;
+    }
+    // Only the first recv blocked (it returned data); the rest spun
+    if (loop.metrics().waits != 1 || loop.metrics().idle_wakeups != 0) {
+        std::printf("Expected 1 wait and no idle wakeup, got %llu / %llu\n",
+                    static_cast<unsigned long long>(loop.metrics().waits),
+                    static_cast<unsigned long long>(loop.metrics().idle_wakeups));
+        close(fd);
+        return false;
+    }
+
+    // Just after data: poll without blocking
+    if (loop.next_wait() != microseconds(0)) {
+        std::printf("Expected spin (0us) after data, got %lld us\n",
+                    static_cast<long long>(loop.next_wait().count()));
+        close(fd);
+        return false;
+    }
+    const auto polls_before = loop.metrics().polls;
+    (void)loop.run_once();
+    if (loop.metrics().polls != polls_before + 1) {
+        std::printf("Expected an empty poll inside the spin window\n");
+        close(fd);
+        return false;
+    }
+
+    // Spin window elapsed: back to blocking waits
+    clock.advance(microseconds(200));
+    if (loop.next_wait() != milliseconds(2)) {
+        std::printf("Expected block after spin window, got %lld us\n",
+                    static_cast<long long>(loop.next_wait().count()));
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_timers_fire_and_bound_wait() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+    (void)port;
+
+    FakeClock clock;
+    gateway::RecvLoop recv_loop(fd, gateway::RecvConfig{});
+    auto config = small_config();
+    config.max_block = milliseconds(100);
+    gateway::EventLoop loop(recv_loop, config, clock.as_clock());
+
+    int fast = 0;
+    int slow = 0;
+    if (!loop.add_timer(microseconds(500), [&] { ++fast; }) ||
+        !loop.add_timer(milliseconds(50), [&] { ++slow; })) {
+        std::printf("add_timer failed\n");
+        close(fd);
+        return false;
+    }
+
+    // The nearest timer bounds the wait, not max_block
+    if (loop.next_wait() != microseconds(500)) {
+        std::printf("Expected wait bounded to 500us, got %lld us\n",
+                    static_cast<long long>(loop.next_wait().count()));
+        close(fd);
+        return false;
+    }
+
+    // Not due yet: nothing fires
+    clock.advance(microseconds(300));
+    (void)loop.run_once();
+    if (fast != 0 || slow != 0) {
+        std::printf("Timer fired early (fast=%d slow=%d)\n", fast, slow);
+        close(fd);
+        return false;
+    }
+
+    clock.advance(microseconds(200));
+    (void)loop.run_once();
+    if (fast != 1 || slow != 0) {
+        std::printf("Expected fast timer once, got fast=%d slow=%d\n", fast, slow);
+        close(fd);
+        return false;
+    }
+
+    // Fell far behind: missed periods are skipped, not replayed
+    clock.advance(milliseconds(60));
+    (void)loop.run_once();
+    if (fast != 2 || slow != 1 || loop.metrics().timer_fires != 3) {
+        std::printf("Expected one catch-up fire each, got fast=%d slow=%d\n", fast, slow);
+        close(fd);
+        return false;
+    }
+    if (loop.next_wait() != microseconds(500)) {
+        std::printf("Expected fast timer rescheduled 500us out, got %lld us\n",
+                    static_cast<long long>(loop.next_wait().count()));
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_timer_limits() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+    (void)port;
+
+    gateway::RecvLoop recv_loop(fd, gateway::RecvConfig{});
+    gateway::EventLoop loop(recv_loop);
+
+    if (loop.add_timer(microseconds(0), [] {})) {
+        std::printf("Zero interval timer should be rejected\n");
+        close(fd);
+        return false;
+    }
+    for (std::size_t i = 0; i < gateway::EventLoop::kMaxTimers; ++i) {
+        if (!loop.add_timer(milliseconds(1), [] {})) {
+            std::printf("add_timer %zu failed below capacity\n", i);
+            close(fd);
+            return false;
+        }
+    }
+    if (loop.add_timer(milliseconds(1), [] {})) {
+        std::printf("add_timer should fail at capacity\n");
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_pending_idle_work_keeps_spinning() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+    (void)port;
+
+    FakeClock clock;
+    gateway::RecvLoop recv_loop(fd, gateway::RecvConfig{});
+    gateway::EventLoop loop(recv_loop, small_config(), clock.as_clock());
+
+    // Simulated backlog of 3 items drained one per idle call
+    int backlog = 3;
+    loop.on_idle([&] {
+        if (backlog > 0) --backlog;
+        return backlog > 0;
+    });
+
+    (void)loop.run_once();  // blocks once, then reports pending work
+    if (loop.next_wait() != microseconds(0)) {
+        std::printf("Expected spin while idle work is pending\n");
+        close(fd);
+        return false;
+    }
+    (void)loop.run_once();
+    (void)loop.run_once();
+    if (backlog != 0 || loop.next_wait() != milliseconds(2)) {
+        std::printf("Expected block once backlog drained (backlog=%d, wait=%lld us)\n", backlog,
+                    static_cast<long long>(loop.next_wait().count()));
+        close(fd);
+        return false;
+    }
+    if (loop.metrics().polls != 2 || loop.metrics().waits != 1 ||
+        loop.metrics().idle_wakeups != 1) {
+        std::printf("Expected 2 polls and 1 wait, got %llu / %llu\n",
+                    static_cast<unsigned long long>(loop.metrics().polls),
+                    static_cast<unsigned long long>(loop.metrics().waits));
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_run_until_stopped() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvLoop recv_loop(fd, gateway::RecvConfig{});
+    gateway::EventLoop loop(recv_loop, small_config());
+
+    std::atomic<bool> running{true};
+    std::size_t handled = 0;
+    int ticks = 0;
+    loop.on_batch([&](std::span<gateway::RecvResult> batch) { handled += batch.size(); });
+    (void)loop.add_timer(milliseconds(1), [&] { ++ticks; });
+
+    std::thread worker([&] { loop.run(running); });
+    for (int i = 0; i < 20; ++i) {
+        send_to_port(port, "payload");
+    }
+    std::this_thread::sleep_for(milliseconds(50));
+    running.store(false);
+    worker.join();
+
+    if (handled != 20) {
+        std::printf("Expected 20 datagrams handled, got %zu\n", handled);
+        close(fd);
+        return false;
+    }
+    if (ticks == 0) {
+        std::printf("Expected the 1ms timer to fire while running\n");
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_idle_loop_blocks()) {
+        std::printf("test_idle_loop_blocks failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_spins_after_data_then_blocks()) {
+        std::printf("test_spins_after_data_then_blocks failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_timers_fire_and_bound_wait()) {
+        std::printf("test_timers_fire_and_bound_wait failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_timer_limits()) {
+        std::printf("test_timer_limits failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_pending_idle_work_keeps_spinning()) {
+        std::printf("test_pending_idle_work_keeps_spinning failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_run_until_stopped()) {
+        std::printf("test_run_until_stopped failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All event_loop tests passed\n");
+    return EXIT_SUCCESS;
+}
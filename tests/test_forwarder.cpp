@@ -1,23 +1,105 @@
 #include "gateway/forwarder.hpp"
 #include "gateway/sink.hpp"
 
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
 
-// Helper to create a test event
-gateway::QueuedEvent make_event(const std::string& agent_id,
+// Helper to create a test event. agent_id is borrowed until try_forward(),
+// so callers pass literals or strings that outlive the call.
+gateway::QueuedEvent make_event(std::string_view agent_id,
                                  gateway::EventType type = gateway::EventType::Metrics) {
     gateway::QueuedEvent event;
     event.agent_id = agent_id;
     event.type = type;
-    event.payload = {std::byte{0x01}, std::byte{0x02}};  // Dummy payload
+    static const std::byte kPayload[] = {std::byte{0x01}, std::byte{0x02}};
+    event.payload = kPayload;  // Dummy payload, copied in try_forward()
     return event;
 }
 
+// Observations from a sink running on the forwarder's sink thread.
+// Lives outside the sink so tests can read it after the forwarder is gone.
+struct SinkProbe {
+    std::atomic<bool> open{true};          // write_batch blocks while false
+    std::atomic<std::uint64_t> writes{0};
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> max_batch{0};
+};
+
+// Records batch sizes; blocks while the probe is closed (simulated outage)
+class GatedSink final : public gateway::Sink {
+public:
+    explicit GatedSink(SinkProbe& probe) : probe_(probe) {}
+
+    [[nodiscard]] bool write(std::span<const std::byte> /*payload*/) noexcept override {
+        ++probe_.writes;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept override {
+        while (!probe_.open.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        probe_.writes += payloads.size();
+        ++probe_.batches;
+        if (payloads.size() > probe_.max_batch.load()) {
+            probe_.max_batch.store(payloads.size());
+        }
+        return payloads.size();
+    }
+
+private:
+    SinkProbe& probe_;
+};
+
+// Keeps a copy of every payload written and where it was. Read it only
+// once the forwarder has drained (drain_all() orders the sink's writes).
+struct SinkRecord {
+    std::atomic<bool> open{true};          // write blocks while false
+    std::vector<std::string> payloads;
+    std::vector<const std::byte*> addresses;
+};
+
+class RecordingSink final : public gateway::Sink {
+public:
+    explicit RecordingSink(SinkRecord& record) : record_(record) {}
+
+    [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override {
+        while (!record_.open.load()) {
+            std::this_thread::yield();
+        }
+        record_.payloads.emplace_back(reinterpret_cast<const char*>(payload.data()), payload.size());
+        record_.addresses.push_back(payload.data());
+        return true;
+    }
+
+private:
+    SinkRecord& record_;
+};
+
+gateway::ForwarderConfig async_config(std::size_t depth, std::size_t per_agent) {
+    gateway::ForwarderConfig config;
+    config.max_queue_depth = depth;
+    config.max_per_agent = per_agent;
+    config.async_sink = true;
+    config.sink_batch_size = 16;
+    return config;
+}
+
 // ============================================================================
 // AgentQuotaTracker Tests
 // ============================================================================
@@ -100,6 +182,130 @@ bool test_quota_release_unknown_agent() {
     return true;
 }
 
+bool test_quota_handles_stable() {
+    gateway::AgentQuotaTracker tracker(4);
+
+    gateway::AgentHandle a = gateway::kInvalidAgentHandle;
+    gateway::AgentHandle a2 = gateway::kInvalidAgentHandle;
+    gateway::AgentHandle b = gateway::kInvalidAgentHandle;
+    if (tracker.try_reserve("A", a) != gateway::ReserveResult::Ok) return false;
+    if (tracker.try_reserve("B", b) != gateway::ReserveResult::Ok) return false;
+    if (tracker.try_reserve("A", a2) != gateway::ReserveResult::Ok) return false;
+
+    // Same agent -> same handle; different agents -> different handles
+    if (a != a2 || a == b) return false;
+    if (tracker.in_flight_count(a) != 2) return false;
+
+    // Release by handle
+    tracker.release(a);
+    tracker.release(a);
+    if (tracker.in_flight_count("A") != 0) return false;
+    if (tracker.in_flight_count(b) != 1) return false;
+    if (tracker.tracked_agents() != 1) return false;
+
+    // Double release and out-of-range handles are ignored
+    tracker.release(a);
+    tracker.release(gateway::kInvalidAgentHandle);
+    if (tracker.total_in_flight() != 1) return false;
+
+    return true;
+}
+
+bool test_quota_table_full() {
+    gateway::AgentQuotaTracker tracker(8, 2);  // at most 2 distinct agents
+
+    gateway::AgentHandle h = gateway::kInvalidAgentHandle;
+    if (tracker.try_reserve("A", h) != gateway::ReserveResult::Ok) return false;
+    if (tracker.try_reserve("B", h) != gateway::ReserveResult::Ok) return false;
+    if (tracker.try_reserve("C", h) != gateway::ReserveResult::TableFull) return false;
+    if (tracker.table_full_rejections() != 1) return false;
+
+    // Known agents still fine; freeing an agent frees its slot
+    if (tracker.try_reserve("A", h) != gateway::ReserveResult::Ok) return false;
+    tracker.release("B");
+    if (tracker.try_reserve("C", h) != gateway::ReserveResult::Ok) return false;
+
+    // Ids longer than the validation limit are never interned
+    const std::string too_long(gateway::AgentIdRules::kMaxLength + 1, 'x');
+    if (tracker.try_reserve(too_long, h) != gateway::ReserveResult::TableFull) return false;
+    if (tracker.in_flight_count(too_long) != 0) return false;
+
+    return true;
+}
+
+bool test_quota_matches_reference_model() {
+    // Random reserve/release against a std::map model: exercises probe
+    // collisions and backward-shift deletion with handles held across them
+    gateway::AgentQuotaTracker tracker(3, 64);
+    std::map<std::string, std::size_t> model;
+    std::vector<std::pair<std::string, gateway::AgentHandle>> held;
+
+    std::uint32_t rng = 12345;
+    auto next = [&rng] {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 16;
+    };
+
+    for (int step = 0; step < 20000; ++step) {
+        if (held.empty() || next() % 2 == 0) {
+            const std::string id = "agent" + std::to_string(next() % 100);
+            gateway::AgentHandle h = gateway::kInvalidAgentHandle;
+            const auto result = tracker.try_reserve(id, h);
+            const std::size_t count = model.count(id) ? model[id] : 0;
+            if (count >= 3) {
+                if (result != gateway::ReserveResult::QuotaExceeded) return false;
+            } else if (count == 0 && model.size() >= 64) {
+                if (result != gateway::ReserveResult::TableFull) return false;
+            } else {
+                if (result != gateway::ReserveResult::Ok) return false;
+                ++model[id];
+                held.emplace_back(id, h);
+            }
+        } else {
+            const std::size_t i = next() % held.size();
+            auto [id, h] = held[i];
+            held[i] = held.back();
+            held.pop_back();
+            tracker.release(h);
+            if (--model[id] == 0) {
+                model.erase(id);
+            }
+        }
+
+        if (tracker.tracked_agents() != model.size()) {
+            std::printf("Step %d: tracked %zu, model %zu\n", step,
+                        tracker.tracked_agents(), model.size());
+            return false;
+        }
+    }
+
+    for (const auto& [id, count] : model) {
+        if (tracker.in_flight_count(id) != count) {
+            std::printf("Count mismatch for %s\n", id.c_str());
+            return false;
+        }
+    }
+    for (const auto& [id, h] : held) {
+        if (tracker.in_flight_count(h) != model[id]) return false;
+    }
+
+    return true;
+}
+
+bool test_forwarder_agent_table_full() {
+    gateway::ForwarderConfig config;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    const std::string too_long(gateway::AgentIdRules::kMaxLength + 1, 'a');
+    if (forwarder.try_forward(make_event(too_long)) != gateway::ForwardResult::DroppedAgentTableFull) {
+        return false;
+    }
+    if (forwarder.total_dropped_agent_table() != 1) return false;
+    if (!forwarder.queue_empty()) return false;
+
+    return true;
+}
+
 // ============================================================================
 // BoundedForwarder Tests - Invariant 1: Bounded Backlog
 // ============================================================================
@@ -243,6 +449,51 @@ bool test_forwarder_per_agent_quota() {
     return true;
 }
 
+bool test_forwarder_set_max_per_agent() {
+    gateway::ForwarderConfig config;
+    config.max_queue_depth = 100;
+    config.max_per_agent = 4;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    for (int i = 0; i < 4; ++i) {
+        if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+    }
+
+    // Lower the quota below A's in-flight count: nothing is drained or
+    // dropped, A is refused until it is back under the new quota
+    forwarder.set_max_per_agent(2);
+    if (forwarder.queue_depth() != 4 || forwarder.quota_tracker().in_flight_count("A") != 4) {
+        std::printf("Lowering the quota changed queued events\n");
+        return false;
+    }
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::DroppedAgentQuotaExceeded) {
+        std::printf("Expected A refused above the lowered quota\n");
+        return false;
+    }
+    (void)forwarder.drain_one();
+    (void)forwarder.drain_one();
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::DroppedAgentQuotaExceeded) {
+        std::printf("Expected A refused at the lowered quota\n");
+        return false;
+    }
+    (void)forwarder.drain_one();
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) {
+        std::printf("Expected A queued once under the lowered quota\n");
+        return false;
+    }
+
+    // Raise it again: takes effect on the next event
+    forwarder.set_max_per_agent(8);
+    for (int i = 0; i < 6; ++i) {
+        if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) {
+            std::printf("Expected A queued under the raised quota (i=%d)\n", i);
+            return false;
+        }
+    }
+    return forwarder.quota_tracker().max_per_agent() == 8 &&
+           forwarder.quota_tracker().in_flight_count("A") == 8;
+}
+
 bool test_forwarder_fairness_under_pressure() {
     gateway::ForwarderConfig config;
     config.max_queue_depth = 10;
@@ -370,6 +621,695 @@ bool test_forwarder_queue_full_releases_quota() {
     return true;
 }
 
+// ============================================================================
+// BoundedForwarder Tests - Invariant 4: Bounded Payload Storage
+// ============================================================================
+
+bool test_forwarder_payload_copied_into_slot() {
+    SinkRecord record;
+    gateway::BoundedForwarder forwarder(gateway::ForwarderConfig{},
+                                        std::make_unique<RecordingSink>(record));
+
+    // The caller's buffer may be reused as soon as try_forward() returns
+    std::string buffer = "first";
+    gateway::QueuedEvent event;
+    event.agent_id = "A";
+    event.type = gateway::EventType::Metrics;
+    event.payload = std::as_bytes(std::span(buffer.data(), buffer.size()));
+    if (forwarder.try_forward(event) != gateway::ForwardResult::Queued) return false;
+    buffer = "XXXXX";
+
+    if (forwarder.payload_slots_in_use() != 1) return false;
+    forwarder.drain_all();
+    if (record.payloads.size() != 1 || record.payloads[0] != "first") {
+        std::printf("Expected the payload as queued\n");
+        return false;
+    }
+    return forwarder.payload_slots_in_use() == 0;
+}
+
+bool test_forwarder_payload_in_place() {
+    SinkRecord record;
+    gateway::BoundedForwarder forwarder(gateway::ForwarderConfig{},
+                                        std::make_unique<RecordingSink>(record));
+
+    std::vector<const std::byte*> buffers;
+    for (const std::string_view text : {"one", "two", "three"}) {
+        auto buffer = forwarder.payload_buffer();
+        if (buffer.size() != gateway::ForwarderConfig{}.max_payload_bytes) return false;
+        std::memcpy(buffer.data(), text.data(), text.size());
+        buffers.push_back(buffer.data());
+
+        gateway::QueuedEvent event;
+        event.agent_id = "A";
+        event.type = gateway::EventType::Log;
+        event.payload = buffer.first(text.size());
+        if (forwarder.try_forward(event) != gateway::ForwardResult::Queued) return false;
+    }
+    if (forwarder.payload_slots_in_use() != 3) return false;
+
+    forwarder.drain_all();
+    if (record.payloads.size() != 3 || record.payloads[0] != "one" ||
+        record.payloads[2] != "three") {
+        return false;
+    }
+    // Written from the slots the payloads were serialized into (no copy)
+    if (record.addresses != buffers) {
+        std::printf("Expected payload_buffer() payloads to be queued in place\n");
+        return false;
+    }
+    return forwarder.payload_slots_in_use() == 0;
+}
+
+bool test_forwarder_payload_buffer_survives_drop() {
+    gateway::ForwarderConfig config;
+    config.max_queue_depth = 1;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+
+    // Dropped at the queue check: the reserved slot is kept, not leaked
+    auto buffer = forwarder.payload_buffer();
+    gateway::QueuedEvent event = make_event("B");
+    event.payload = buffer.first(4);
+    if (forwarder.try_forward(event) != gateway::ForwardResult::DroppedQueueFull) return false;
+    if (forwarder.payload_buffer().data() != buffer.data()) return false;
+    if (forwarder.payload_slots_in_use() != 1) {
+        std::printf("Expected a queue-full drop to take no payload slot\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_forwarder_payload_too_large() {
+    gateway::ForwarderConfig config;
+    config.max_payload_bytes = 1;  // make_event payloads are 2 bytes
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::DroppedPayloadTooLarge) {
+        return false;
+    }
+    if (forwarder.total_dropped_payload_too_large() != 1) return false;
+
+    // The drop holds neither quota nor a queue or payload slot
+    if (forwarder.quota_tracker().in_flight_count("A") != 0) return false;
+    if (!forwarder.queue_empty() || forwarder.payload_slots_in_use() != 0) return false;
+    return true;
+}
+
+bool test_forwarder_slab_sized_for_queue() {
+    gateway::ForwarderConfig config;
+    config.max_queue_depth = 8;
+    config.max_per_agent = 100;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    // Queue plus the payload_buffer() slot; fixed at construction
+    if (forwarder.payload_slot_capacity() != 9) return false;
+
+    // Overload: the queue fills and drops, the slab never runs out
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            auto buffer = forwarder.payload_buffer();
+            if (buffer.empty()) return false;
+            gateway::QueuedEvent event = make_event("A");
+            if (i % 2 == 0) {
+                event.payload = buffer.first(3);  // in place
+            }
+            (void)forwarder.try_forward(event);
+        }
+        if (forwarder.queue_depth() != 8 || forwarder.payload_slots_in_use() != 8) return false;
+        // Drain in part so later events reuse slots freed out of order
+        forwarder.drain_one();
+        forwarder.drain_one();
+    }
+    if (forwarder.total_dropped_payload_storage() != 0) return false;
+
+    forwarder.drain_all();
+    return forwarder.payload_slots_in_use() == 0;
+}
+
+// ============================================================================
+// BoundedForwarder Tests - DRR scheduler
+// ============================================================================
+
+// Payloads fill a whole slot (cost == quantum), so DRR serves one event
+// per agent per round; each payload starts with its agent id
+constexpr std::size_t kDrrPayloadBytes = 32;
+
+gateway::ForwarderConfig drr_config(bool async) {
+    gateway::ForwarderConfig config;
+    config.max_queue_depth = 64;
+    config.max_per_agent = 64;
+    config.max_payload_bytes = kDrrPayloadBytes;
+    config.scheduler = gateway::SchedulerMode::DeficitRoundRobin;
+    config.async_sink = async;
+    config.sink_batch_size = 8;
+    return config;
+}
+
+gateway::ForwardResult forward_sized(gateway::BoundedForwarder& forwarder, std::string_view agent_id) {
+    auto buffer = forwarder.payload_buffer();
+    std::memset(buffer.data(), '.', kDrrPayloadBytes);
+    std::memcpy(buffer.data(), agent_id.data(), agent_id.size());
+    gateway::QueuedEvent event = make_event(agent_id);
+    event.payload = buffer.first(kDrrPayloadBytes);
+    return forwarder.try_forward(event);
+}
+
+// Positions in the write order of events from one agent
+std::vector<std::size_t> positions_of(const SinkRecord& record, std::string_view agent_id) {
+    std::vector<std::size_t> at;
+    for (std::size_t i = 0; i < record.payloads.size(); ++i) {
+        const std::string& p = record.payloads[i];
+        if (p.compare(0, agent_id.size(), agent_id) == 0 && p[agent_id.size()] == '.') {
+            at.push_back(i);
+        }
+    }
+    return at;
+}
+
+bool test_drr_interleaves_agents() {
+    SinkRecord record;
+    gateway::BoundedForwarder forwarder(drr_config(false), std::make_unique<RecordingSink>(record));
+
+    // A bursts first; B's few events arrive behind the whole burst
+    for (int i = 0; i < 30; ++i) {
+        if (forward_sized(forwarder, "A") != gateway::ForwardResult::Queued) return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (forward_sized(forwarder, "B") != gateway::ForwardResult::Queued) return false;
+    }
+    if (forwarder.queue_depth() != 33) return false;
+
+    forwarder.drain_all();
+    const auto b = positions_of(record, "B");
+    if (b.size() != 3 || b[2] > 5) {
+        std::printf("Expected B within the first rounds, last at %zu\n", b.empty() ? 0 : b.back());
+        return false;
+    }
+    if (positions_of(record, "A").size() != 30) return false;
+    return forwarder.quota_tracker().total_in_flight() == 0 && forwarder.payload_slots_in_use() == 0;
+}
+
+bool test_drr_keeps_bounds() {
+    SinkRecord record;
+    auto config = drr_config(false);
+    config.max_per_agent = 10;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<RecordingSink>(record));
+
+    // Quota still applies per agent, depth across all of them
+    std::size_t quota_drops = 0;
+    std::size_t queue_drops = 0;
+    for (int i = 0; i < 200; ++i) {
+        const std::string agent_id = "agent" + std::to_string(i % 10);
+        switch (forward_sized(forwarder, agent_id)) {
+            case gateway::ForwardResult::DroppedAgentQuotaExceeded: ++quota_drops; break;
+            case gateway::ForwardResult::DroppedQueueFull: ++queue_drops; break;
+            default: break;
+        }
+    }
+    if (forwarder.queue_depth() != 64 || forwarder.queue_capacity() != 64) return false;
+    if (queue_drops == 0 || quota_drops != 0) return false;
+
+    forwarder.drain_all();
+    for (int i = 0; i < 15; ++i) {
+        (void)forward_sized(forwarder, "solo");
+    }
+    return forwarder.queue_depth() == 10 && forwarder.total_dropped_quota() == 5;
+}
+
+bool test_drr_weights() {
+    SinkRecord record;
+    auto config = drr_config(false);
+    config.agent_weights = {{"std", 1}, {"gold", 3}};
+    gateway::BoundedForwarder forwarder(config, std::make_unique<RecordingSink>(record));
+
+    for (int i = 0; i < 20; ++i) {
+        (void)forward_sized(forwarder, "std");
+        (void)forward_sized(forwarder, "gold");
+    }
+    forwarder.drain_all();
+
+    // 3:1 share while both are backlogged
+    std::size_t gold = 0;
+    for (std::size_t p : positions_of(record, "gold")) {
+        gold += p < 16 ? 1 : 0;
+    }
+    if (gold != 12) {
+        std::printf("Expected 12 of the first 16 writes from gold, got %zu\n", gold);
+        return false;
+    }
+    return record.payloads.size() == 40;
+}
+
+bool test_async_drr_interleaves_agents() {
+    SinkRecord record;
+    record.open = false;  // stalled sink: the backlog builds up
+    gateway::BoundedForwarder forwarder(drr_config(true), std::make_unique<RecordingSink>(record));
+
+    for (int i = 0; i < 40; ++i) {
+        if (forward_sized(forwarder, "A") != gateway::ForwardResult::Queued) return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (forward_sized(forwarder, "B") != gateway::ForwardResult::Queued) return false;
+    }
+    if (forwarder.queue_depth() != 44) return false;
+
+    // Depth counts every event not yet written, wherever it waits
+    std::size_t dropped = 0;
+    for (int i = 0; i < 40; ++i) {
+        dropped += forward_sized(forwarder, "C") == gateway::ForwardResult::DroppedQueueFull ? 1 : 0;
+    }
+    if (forwarder.queue_depth() != 64 || dropped != 20) return false;
+    record.open = true;
+
+    forwarder.drain_all();
+    // At most one batch of A was taken before B arrived; after that, B
+    // gets every third turn (A, B, C are all backlogged)
+    const auto b = positions_of(record, "B");
+    if (b.size() != 4 || b.back() > 8 + 3 * 4) {
+        std::printf("Expected B early in the write order, last at %zu\n", b.empty() ? 0 : b.back());
+        return false;
+    }
+    if (record.payloads.size() != 64) return false;
+    return forwarder.quota_tracker().total_in_flight() == 0 && forwarder.payload_slots_in_use() == 0;
+}
+
+// ============================================================================
+// Priority lanes
+// ============================================================================
+
+constexpr std::size_t kLanePayloadBytes = 32;
+
+gateway::ForwarderConfig lane_config(gateway::LanePolicy policy, bool async) {
+    gateway::ForwarderConfig config;
+    config.max_per_agent = 64;
+    config.max_payload_bytes = kLanePayloadBytes;
+    config.lanes = policy;
+    config.lane_capacity = {4, 8, 4, 2};
+    config.async_sink = async;
+    config.sink_batch_size = 8;
+    return config;
+}
+
+// Payload is `tag` padded with dots, so the write order can be read back
+gateway::ForwardResult forward_lane(gateway::BoundedForwarder& forwarder, std::string_view tag,
+                                    gateway::EventType type,
+                                    gateway::LogLevel level = gateway::LogLevel::Info) {
+    auto buffer = forwarder.payload_buffer();
+    std::memset(buffer.data(), '.', kLanePayloadBytes);
+    std::memcpy(buffer.data(), tag.data(), tag.size());
+    gateway::QueuedEvent event = make_event("agent", type);
+    event.level = level;
+    event.payload = buffer.first(kLanePayloadBytes);
+    return forwarder.try_forward(event);
+}
+
+bool test_lane_for_event() {
+    using gateway::EventType;
+    using gateway::Lane;
+    using gateway::LogLevel;
+    return gateway::lane_for(EventType::Metrics, LogLevel::Trace) == Lane::Metrics &&
+           gateway::lane_for(EventType::Log, LogLevel::Fatal) == Lane::Critical &&
+           gateway::lane_for(EventType::Log, LogLevel::Error) == Lane::Critical &&
+           gateway::lane_for(EventType::Log, LogLevel::Warn) == Lane::Logs &&
+           gateway::lane_for(EventType::Log, LogLevel::Info) == Lane::Logs &&
+           gateway::lane_for(EventType::Log, LogLevel::Debug) == Lane::Debug &&
+           gateway::lane_for(EventType::Log, LogLevel::Trace) == Lane::Debug;
+}
+
+bool test_lanes_debug_storm_spares_metrics() {
+    SinkRecord record;
+    gateway::BoundedForwarder forwarder(lane_config(gateway::LanePolicy::StrictPriority, false),
+                                        std::make_unique<RecordingSink>(record));
+    if (forwarder.queue_capacity() != 18 || forwarder.payload_slot_capacity() != 19) return false;
+
+    // The storm fills its own lane and drops there
+    for (int i = 0; i < 50; ++i) {
+        (void)forward_lane(forwarder, "D", gateway::EventType::Log, gateway::LogLevel::Debug);
+    }
+    if (forwarder.lane_depth(gateway::Lane::Debug) != 2) return false;
+    if (forwarder.total_dropped_queue_full(gateway::Lane::Debug) != 48) return false;
+
+    for (int i = 0; i < 8; ++i) {
+        if (forward_lane(forwarder, "M", gateway::EventType::Metrics) != gateway::ForwardResult::Queued) {
+            std::printf("Metrics dropped behind a debug storm\n");
+            return false;
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (forward_lane(forwarder, "E", gateway::EventType::Log, gateway::LogLevel::Error) !=
+            gateway::ForwardResult::Queued) {
+            return false;
+        }
+    }
+    if (forwarder.queue_depth() != 14 || forwarder.total_dropped_queue_full() != 48) return false;
+    if (forwarder.total_dropped_queue_full(gateway::Lane::Metrics) != 0) return false;
+
+    // Strict priority: error logs, then metrics, then debug
+    forwarder.drain_all();
+    std::string order;
+    for (const std::string& p : record.payloads) {
+        order += p[0];
+    }
+    if (order != "EEEEMMMMMMMMDD") {
+        std::printf("Unexpected drain order %s\n", order.c_str());
+        return false;
+    }
+    return forwarder.quota_tracker().total_in_flight() == 0 && forwarder.payload_slots_in_use() == 0;
+}
+
+bool test_lanes_weighted_drain() {
+    SinkRecord record;
+    auto config = lane_config(gateway::LanePolicy::Weighted, false);
+    config.lane_capacity = {16, 16, 16, 16};
+    gateway::BoundedForwarder forwarder(config, std::make_unique<RecordingSink>(record));
+
+    for (int i = 0; i < 16; ++i) {
+        (void)forward_lane(forwarder, "D", gateway::EventType::Log, gateway::LogLevel::Trace);
+        (void)forward_lane(forwarder, "L", gateway::EventType::Log, gateway::LogLevel::Warn);
+        (void)forward_lane(forwarder, "M", gateway::EventType::Metrics);
+        (void)forward_lane(forwarder, "E", gateway::EventType::Log, gateway::LogLevel::Fatal);
+    }
+    if (forwarder.queue_depth() != 64) return false;
+
+    // Turns of 8:4:2:1 while every lane is backlogged; low lanes still move
+    for (int i = 0; i < 15; ++i) {
+        if (!forwarder.drain_one()) return false;
+    }
+    std::string order;
+    for (const std::string& p : record.payloads) {
+        order += p[0];
+    }
+    if (order != "EEEEEEEEMMMMLLD") {
+        std::printf("Unexpected weighted order %s\n", order.c_str());
+        return false;
+    }
+
+    forwarder.drain_all();
+    return record.payloads.size() == 64 && forwarder.lane_depth(gateway::Lane::Debug) == 0;
+}
+
+bool test_single_lane_counts_drops_by_lane() {
+    SinkRecord record;
+    gateway::ForwarderConfig config;
+    config.max_queue_depth = 2;
+    gateway::BoundedForwarder forwarder(config, std::make_unique<RecordingSink>(record));
+
+    (void)forwarder.try_forward(make_event("a"));
+    (void)forwarder.try_forward(make_event("a"));
+    auto debug = make_event("a", gateway::EventType::Log);
+    debug.level = gateway::LogLevel::Debug;
+    auto error = make_event("a", gateway::EventType::Log);
+    error.level = gateway::LogLevel::Error;
+    if (forwarder.try_forward(debug) != gateway::ForwardResult::DroppedQueueFull) return false;
+    if (forwarder.try_forward(error) != gateway::ForwardResult::DroppedQueueFull) return false;
+
+    // One shared queue, but drops are still attributed to the event's lane
+    return forwarder.queue_capacity() == 2 &&
+           forwarder.lane_depth(gateway::Lane::Metrics) == 0 &&
+           forwarder.total_dropped_queue_full(gateway::Lane::Debug) == 1 &&
+           forwarder.total_dropped_queue_full(gateway::Lane::Critical) == 1 &&
+           forwarder.total_dropped_queue_full(gateway::Lane::Metrics) == 0;
+}
+
+bool test_async_lanes_strict_priority() {
+    SinkRecord record;
+    record.open = false;  // stalled sink: the backlog builds up
+    gateway::BoundedForwarder forwarder(lane_config(gateway::LanePolicy::StrictPriority, true),
+                                        std::make_unique<RecordingSink>(record));
+
+    for (int i = 0; i < 9; ++i) {
+        (void)forward_lane(forwarder, "M", gateway::EventType::Metrics);
+    }
+    // Lane depth counts events not yet written, wherever they wait
+    if (forwarder.lane_depth(gateway::Lane::Metrics) != 8) return false;
+    if (forwarder.total_dropped_queue_full(gateway::Lane::Metrics) != 1) return false;
+
+    for (int i = 0; i < 4; ++i) {
+        if (forward_lane(forwarder, "E", gateway::EventType::Log, gateway::LogLevel::Error) !=
+            gateway::ForwardResult::Queued) {
+            return false;
+        }
+    }
+    if (forwarder.queue_depth() != 12 || forwarder.lane_depth(gateway::Lane::Critical) != 4) return false;
+    record.open = true;
+
+    forwarder.drain_all();
+    // Only metrics the sink thread took before the error logs arrived may
+    // precede them
+    std::size_t last_error = 0;
+    std::size_t errors = 0;
+    for (std::size_t i = 0; i < record.payloads.size(); ++i) {
+        if (record.payloads[i][0] == 'E') {
+            last_error = i;
+            ++errors;
+        }
+    }
+    const std::size_t metrics_ahead = last_error + 1 - errors;
+    if (errors != 4 || record.payloads.size() != 12) return false;
+    if (forwarder.lane_depth(gateway::Lane::Critical) != 0 || forwarder.queue_depth() != 0) return false;
+    return metrics_ahead <= 8 && forwarder.quota_tracker().total_in_flight() == 0 &&
+           forwarder.payload_slots_in_use() == 0;
+}
+
+// ============================================================================
+// Sink::write_batch and async (sink thread) mode
+// ============================================================================
+
+bool test_sink_default_write_batch() {
+    gateway::NullSink sink;
+    const std::byte data[2] = {std::byte{1}, std::byte{2}};
+    const std::span<const std::byte> payloads[3] = {data, data, data};
+
+    if (sink.write_batch(payloads) != 3) return false;
+    if (sink.write_count() != 3) return false;
+
+    gateway::FailingSink failing;
+    if (failing.write_batch(payloads) != 0) return false;
+    if (failing.fail_count() != 3) return false;
+
+    return true;
+}
+
+bool test_async_forwards_in_batches() {
+    SinkProbe probe;
+    probe.open = false;  // let a backlog build so batches are non-trivial
+    gateway::BoundedForwarder forwarder(async_config(256, 256),
+                                        std::make_unique<GatedSink>(probe));
+    if (!forwarder.async()) return false;
+
+    for (int i = 0; i < 100; ++i) {
+        const std::string agent_id = "agent" + std::to_string(i % 5);
+        if (forwarder.try_forward(make_event(agent_id)) != gateway::ForwardResult::Queued) {
+            return false;
+        }
+    }
+    probe.open = true;
+
+    if (forwarder.drain_all() != 100) {
+        std::printf("Expected 100 quota releases after drain_all\n");
+        return false;
+    }
+    if (probe.writes != 100 || forwarder.total_forwarded() != 100) return false;
+    if (probe.max_batch < 2 || probe.max_batch > 16) {
+        std::printf("Unexpected max batch %lu\n", static_cast<unsigned long>(probe.max_batch.load()));
+        return false;
+    }
+    if (forwarder.total_sink_batches() != probe.batches) return false;
+    if (forwarder.quota_tracker().total_in_flight() != 0) return false;
+    if (!forwarder.queue_empty()) return false;
+
+    return true;
+}
+
+bool test_async_slow_sink_does_not_block_producer() {
+    SinkProbe probe;
+    probe.open = false;  // sink stalled: producer must keep going and drop
+    gateway::BoundedForwarder forwarder(async_config(10, 100),
+                                        std::make_unique<GatedSink>(probe));
+
+    std::size_t queued = 0;
+    std::size_t dropped = 0;
+    for (int i = 0; i < 1000; ++i) {
+        auto result = forwarder.try_forward(make_event("A"));
+        if (result == gateway::ForwardResult::Queued) ++queued;
+        if (result == gateway::ForwardResult::DroppedQueueFull) ++dropped;
+    }
+
+    // Bounded by depth (+ one batch the sink thread may hold while stalled)
+    if (queued > 10 + 16 || dropped == 0) {
+        std::printf("queued=%zu dropped=%zu\n", queued, dropped);
+        return false;
+    }
+    if (forwarder.queue_depth() > forwarder.queue_capacity()) return false;
+
+    probe.open = true;
+    forwarder.drain_all();
+    if (probe.writes != queued) return false;
+    if (forwarder.quota_tracker().in_flight_count("A") != 0) return false;
+
+    return true;
+}
+
+bool test_async_quota_release_after_sink() {
+    SinkProbe probe;
+    probe.open = false;
+    gateway::BoundedForwarder forwarder(async_config(16, 2),
+                                        std::make_unique<GatedSink>(probe));
+
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+
+    // Not released while the events are still queued / being written
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::DroppedAgentQuotaExceeded) {
+        return false;
+    }
+
+    probe.open = true;
+    forwarder.drain_all();
+    if (forwarder.quota_tracker().in_flight_count("A") != 0) return false;
+    if (forwarder.quota_tracker().tracked_agents() != 0) return false;
+
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+
+    return true;
+}
+
+// Sink that records the CPU affinity of the thread calling it
+class AffinitySink final : public gateway::Sink {
+public:
+    [[nodiscard]] bool write(std::span<const std::byte>) noexcept override {
+        CPU_ZERO(&set);
+        (void)pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+        return true;
+    }
+
+    cpu_set_t set{};
+};
+
+bool test_async_sink_cpus() {
+    const int cpu = sched_getcpu();
+    if (cpu < 0) {
+        return true;
+    }
+    auto config = async_config(16, 4);
+    config.sink_cpus = {cpu};
+    auto sink = std::make_unique<AffinitySink>();
+    AffinitySink* probe = sink.get();
+    gateway::BoundedForwarder forwarder(std::move(config), std::move(sink));
+
+    if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+    forwarder.drain_all();
+    if (CPU_COUNT(&probe->set) != 1 || !CPU_ISSET(cpu, &probe->set)) {
+        std::printf("Sink thread not pinned to CPU %d\n", cpu);
+        return false;
+    }
+    return true;
+}
+
+bool test_async_sink_failures_release_quota() {
+    gateway::BoundedForwarder forwarder(async_config(16, 4),
+                                        std::make_unique<gateway::FailingSink>());
+
+    for (int i = 0; i < 4; ++i) {
+        if (forwarder.try_forward(make_event("A")) != gateway::ForwardResult::Queued) return false;
+    }
+    forwarder.drain_all();
+
+    if (forwarder.total_sink_failures() != 4) return false;
+    if (forwarder.total_forwarded() != 0) return false;
+    if (forwarder.quota_tracker().in_flight_count("A") != 0) return false;
+
+    return true;
+}
+
+bool test_async_stop_drains_queue() {
+    SinkProbe probe;
+    {
+        gateway::BoundedForwarder forwarder(async_config(64, 64),
+                                            std::make_unique<GatedSink>(probe));
+        for (int i = 0; i < 50; ++i) {
+            (void)forwarder.try_forward(make_event("B"));
+        }
+        forwarder.stop();
+        forwarder.stop();  // idempotent
+        if (forwarder.quota_tracker().total_in_flight() != 0) return false;
+    }
+    if (probe.writes != 50) {
+        std::printf("Expected 50 writes after stop, got %lu\n",
+                    static_cast<unsigned long>(probe.writes.load()));
+        return false;
+    }
+
+    // Destructor alone also drains
+    SinkProbe probe2;
+    {
+        gateway::BoundedForwarder forwarder(async_config(64, 64),
+                                            std::make_unique<GatedSink>(probe2));
+        for (int i = 0; i < 20; ++i) {
+            (void)forwarder.try_forward(make_event("C"));
+        }
+    }
+    return probe2.writes == 20;
+}
+
+bool test_async_releases_payload_slots() {
+    SinkProbe probe;
+    probe.open = false;  // sink stalled: ring and one in-flight batch fill up
+    gateway::BoundedForwarder forwarder(async_config(32, 1000),
+                                        std::make_unique<GatedSink>(probe));
+    if (forwarder.payload_slot_capacity() != 32 + 16 + 1) return false;
+
+    // Every drop is a queue-full drop: the slab never runs out first
+    for (int i = 0; i < 500; ++i) {
+        auto buffer = forwarder.payload_buffer();
+        if (buffer.empty()) return false;
+        gateway::QueuedEvent event = make_event("A");
+        event.payload = buffer.first(8);
+        const auto result = forwarder.try_forward(event);
+        if (result != gateway::ForwardResult::Queued &&
+            result != gateway::ForwardResult::DroppedQueueFull) {
+            return false;
+        }
+    }
+    probe.open = true;
+
+    for (int i = 0; i < 2000; ++i) {
+        if (forwarder.try_forward(make_event("A")) == gateway::ForwardResult::DroppedPayloadStorageFull) {
+            return false;
+        }
+    }
+    forwarder.drain_all();
+
+    if (forwarder.total_dropped_payload_storage() != 0) return false;
+    if (forwarder.payload_slots_in_use() != 0) {
+        std::printf("Expected all payload slots back, %zu in use\n", forwarder.payload_slots_in_use());
+        return false;
+    }
+    return true;
+}
+
+bool test_async_idle_drain_one() {
+    gateway::BoundedForwarder forwarder(async_config(8, 8),
+                                        std::make_unique<gateway::NullSink>());
+
+    // Sink thread owns draining; drain_one never processes inline
+    if (forwarder.drain_one()) return false;
+    if (forwarder.drain_all() != 0) return false;
+
+    (void)forwarder.try_forward(make_event("A"));
+    while (forwarder.total_forwarded() == 0) {
+        std::this_thread::yield();
+    }
+    // Release arrives via apply_pending_releases (called by drain_one)
+    while (forwarder.quota_tracker().total_in_flight() != 0) {
+        forwarder.drain_one();
+    }
+
+    return true;
+}
+
 }  // namespace
 
 int main() {
@@ -394,6 +1334,26 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    if (!test_quota_handles_stable()) {
+        std::printf("test_quota_handles_stable failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_quota_table_full()) {
+        std::printf("test_quota_table_full failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_quota_matches_reference_model()) {
+        std::printf("test_quota_matches_reference_model failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_forwarder_agent_table_full()) {
+        std::printf("test_forwarder_agent_table_full failed\n");
+        return EXIT_FAILURE;
+    }
+
     // Invariant 1: Bounded backlog
     if (!test_forwarder_bounded_backlog()) {
         std::printf("test_forwarder_bounded_backlog failed\n");
@@ -422,6 +1382,11 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    if (!test_forwarder_set_max_per_agent()) {
+        std::printf("test_forwarder_set_max_per_agent failed\n");
+        return EXIT_FAILURE;
+    }
+
     if (!test_forwarder_fairness_under_pressure()) {
         std::printf("test_forwarder_fairness_under_pressure failed\n");
         return EXIT_FAILURE;
@@ -448,6 +1413,122 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    if (!test_forwarder_payload_copied_into_slot()) {
+        std::printf("test_forwarder_payload_copied_into_slot failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_forwarder_payload_in_place()) {
+        std::printf("test_forwarder_payload_in_place failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_forwarder_payload_buffer_survives_drop()) {
+        std::printf("test_forwarder_payload_buffer_survives_drop failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_forwarder_payload_too_large()) {
+        std::printf("test_forwarder_payload_too_large failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_forwarder_slab_sized_for_queue()) {
+        std::printf("test_forwarder_slab_sized_for_queue failed\n");
+        return EXIT_FAILURE;
+    }
+
+    // Async sink thread
+    if (!test_drr_interleaves_agents()) {
+        std::printf("test_drr_interleaves_agents failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_drr_keeps_bounds()) {
+        std::printf("test_drr_keeps_bounds failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_drr_weights()) {
+        std::printf("test_drr_weights failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_drr_interleaves_agents()) {
+        std::printf("test_async_drr_interleaves_agents failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_lane_for_event()) {
+        std::printf("test_lane_for_event failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_lanes_debug_storm_spares_metrics()) {
+        std::printf("test_lanes_debug_storm_spares_metrics failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_lanes_weighted_drain()) {
+        std::printf("test_lanes_weighted_drain failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_single_lane_counts_drops_by_lane()) {
+        std::printf("test_single_lane_counts_drops_by_lane failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_lanes_strict_priority()) {
+        std::printf("test_async_lanes_strict_priority failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_sink_default_write_batch()) {
+        std::printf("test_sink_default_write_batch failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_forwards_in_batches()) {
+        std::printf("test_async_forwards_in_batches failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_slow_sink_does_not_block_producer()) {
+        std::printf("test_async_slow_sink_does_not_block_producer failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_quota_release_after_sink()) {
+        std::printf("test_async_quota_release_after_sink failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_sink_cpus()) {
+        std::printf("test_async_sink_cpus failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_sink_failures_release_quota()) {
+        std::printf("test_async_sink_failures_release_quota failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_stop_drains_queue()) {
+        std::printf("test_async_stop_drains_queue failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_releases_payload_slots()) {
+        std::printf("test_async_releases_payload_slots failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_idle_drain_one()) {
+        std::printf("test_async_idle_drain_one failed\n");
+        return EXIT_FAILURE;
+    }
+
     std::printf("All forwarder tests passed\n");
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,151 @@
+#include "gateway/hash_index.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using gateway::HashIndex;
+
+bool test_hash_bytes() {
+    // Deterministic per seed, sensitive to seed, length and every byte
+    const std::uint64_t h = gateway::hash_bytes(1, "agent-0001");
+    if (h != gateway::hash_bytes(1, "agent-0001")) return false;
+    if (h == gateway::hash_bytes(2, "agent-0001")) return false;
+    if (h == gateway::hash_bytes(1, "agent-0002")) return false;
+    if (gateway::hash_bytes(1, "") == gateway::hash_bytes(1, std::string(1, '\0'))) return false;
+
+    // Chained: ("ab", "c") and ("a", "bc") differ
+    if (gateway::hash_bytes(gateway::hash_bytes(7, "ab"), "c") ==
+        gateway::hash_bytes(gateway::hash_bytes(7, "a"), "bc")) {
+        std::printf("Chained hashes collide on a shifted boundary\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_sizing() {
+    // Load factor <= 0.5, power of two
+    if (HashIndex(1).slot_count() != 2) return false;
+    if (HashIndex(5).slot_count() != 16) return false;
+    if (HashIndex(0).slot_count() != 2) return false;
+    return HashIndex(64).memory_bytes() == 128 * sizeof(std::uint32_t);
+}
+
+// Entries with forced homes, so probe runs and wraparound are exercised
+struct Table {
+    explicit Table(std::size_t max) : index(max) {}
+
+    HashIndex index;
+    std::vector<std::uint64_t> keys;   // entry number -> key
+    std::vector<std::size_t> homes;    // entry number -> home slot
+
+    std::size_t find(std::uint64_t key, std::size_t home) const {
+        return index.find(home, [&](std::uint32_t n) { return keys[n] == key; });
+    }
+
+    void insert(std::uint64_t key, std::size_t home) {
+        const auto n = static_cast<std::uint32_t>(keys.size());
+        keys.push_back(key);
+        homes.push_back(home);
+        index.set(find(key, home), n);
+    }
+
+    void erase(std::uint64_t key, std::size_t home) {
+        index.erase(find(key, home), [this](std::uint32_t n) { return homes[n]; });
+    }
+};
+
+bool test_backward_shift_erase() {
+    // 8 slots; three keys share home 6, so the run wraps to slot 0
+    Table t(4);
+    t.insert(10, 6);
+    t.insert(11, 6);
+    t.insert(12, 6);
+    t.insert(13, 0);  // displaced by the wrapped run to slot 1
+    if (t.index[6] != 0 || t.index[7] != 1 || t.index[0] != 2 || t.index[1] != 3) {
+        std::printf("Unexpected probe layout\n");
+        return false;
+    }
+
+    t.erase(11, 6);
+    // The run closes up: no tombstone, every key still found
+    if (t.index[6] != 0 || t.index[7] != 2 || t.index[0] != 3 || t.index[1] != HashIndex::kNil) {
+        std::printf("Erase did not shift the run back\n");
+        return false;
+    }
+    if (t.index[t.find(12, 6)] != 2 || t.index[t.find(13, 0)] != 3) return false;
+    if (t.index[t.find(11, 6)] != HashIndex::kNil) return false;
+    if (t.index.slot_of(6, 3) != 0) return false;
+
+    t.index.clear();
+    return t.index[t.find(10, 6)] == HashIndex::kNil;
+}
+
+bool test_matches_reference() {
+    // Random inserts/erases at full load against std::map
+    constexpr std::size_t kMax = 64;
+    HashIndex index(kMax);
+    std::vector<std::uint64_t> keys(kMax);
+    std::vector<std::uint32_t> free_entries;
+    for (std::uint32_t n = kMax; n-- > 0;) free_entries.push_back(n);
+    std::map<std::uint64_t, std::uint32_t> model;
+    std::mt19937 rng(5);
+
+    auto home_of_key = [&](std::uint64_t key) { return index.home(gateway::hash_mix(key)); };
+    auto find = [&](std::uint64_t key) {
+        return index.find(home_of_key(key), [&](std::uint32_t n) { return keys[n] == key; });
+    };
+
+    for (int i = 0; i < 100000; ++i) {
+        const std::uint64_t key = rng() % 200;
+        const std::size_t slot = find(key);
+        const auto it = model.find(key);
+        if ((index[slot] != HashIndex::kNil) != (it != model.end()) ||
+            (it != model.end() && index[slot] != it->second)) {
+            std::printf("Lookup mismatch at step %d\n", i);
+            return false;
+        }
+        if (it != model.end()) {
+            index.erase(slot, [&](std::uint32_t n) { return home_of_key(keys[n]); });
+            free_entries.push_back(it->second);
+            model.erase(it);
+        } else if (!free_entries.empty()) {
+            const std::uint32_t n = free_entries.back();
+            free_entries.pop_back();
+            keys[n] = key;
+            index.set(slot, n);
+            model.emplace(key, n);
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_hash_bytes()) {
+        std::printf("test_hash_bytes failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_sizing()) {
+        std::printf("test_sizing failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_backward_shift_erase()) {
+        std::printf("test_backward_shift_erase failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_matches_reference()) {
+        std::printf("test_matches_reference failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All hash_index tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+#include "gateway/histogram.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+namespace {
+
+using gateway::HistogramBuckets;
+
+bool test_bucket_bounds_cover_values() {
+    // Every value lies within its bucket, and buckets tile the range
+    std::mt19937_64 rng(21);
+    for (int i = 0; i < 100000; ++i) {
+        const std::uint64_t v = rng() >> (rng() % 64);
+        const std::size_t b = HistogramBuckets::index(v);
+        if (b >= HistogramBuckets::kCount) return false;
+        if (v < HistogramBuckets::lower_bound(b) || v > HistogramBuckets::upper_bound(b)) {
+            std::printf("Value %llu outside bucket %zu\n", static_cast<unsigned long long>(v), b);
+            return false;
+        }
+    }
+    for (std::size_t b = 0; b + 1 < HistogramBuckets::kCount; ++b) {
+        if (HistogramBuckets::upper_bound(b) + 1 != HistogramBuckets::lower_bound(b + 1)) return false;
+    }
+    return HistogramBuckets::index(0) == 0 && HistogramBuckets::index(7) == 7 &&
+           HistogramBuckets::index(8) == 8;
+}
+
+bool test_bucket_relative_error() {
+    // Width is at most 1/8 of the lower bound above the linear range
+    for (std::size_t b = HistogramBuckets::kSubBuckets; b + 1 < HistogramBuckets::kCount; ++b) {
+        const std::uint64_t lo = HistogramBuckets::lower_bound(b);
+        const std::uint64_t width = HistogramBuckets::upper_bound(b) - lo + 1;
+        if (width * HistogramBuckets::kSubBuckets > lo) {
+            std::printf("Bucket %zu too wide: [%llu, +%llu)\n", b,
+                        static_cast<unsigned long long>(lo), static_cast<unsigned long long>(width));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_percentiles() {
+    gateway::LatencyHistogram h;
+    for (std::uint64_t v = 1; v <= 1000; ++v) {
+        h.record(v);
+    }
+    const auto s = h.snapshot();
+    if (s.count() != 1000 || s.max != 1000 || s.mean() != 500) return false;
+
+    // Within one bucket (12.5%) of the exact rank, never below it
+    const std::uint64_t p50 = s.percentile(0.5);
+    const std::uint64_t p99 = s.percentile(0.99);
+    if (p50 < 500 || p50 > 500 + 500 / 8) {
+        std::printf("p50 = %llu\n", static_cast<unsigned long long>(p50));
+        return false;
+    }
+    if (p99 < 990 || p99 > 1000) {
+        std::printf("p99 = %llu\n", static_cast<unsigned long long>(p99));
+        return false;
+    }
+    return s.percentile(0.0) == 1 && s.percentile(1.0) == 1000;
+}
+
+bool test_empty_and_merge() {
+    gateway::LatencyHistogram a;
+    gateway::LatencyHistogram b;
+    if (a.snapshot().count() != 0 || a.snapshot().percentile(0.5) != 0) return false;
+
+    for (int i = 0; i < 90; ++i) a.record(100);
+    for (int i = 0; i < 10; ++i) b.record(100000);
+
+    auto merged = a.snapshot();
+    merged.merge(b.snapshot());
+    if (merged.count() != 100 || merged.max != 100000) return false;
+    if (merged.sum != 90 * 100 + 10 * 100000) return false;
+    return merged.percentile(0.5) <= 100 + 100 / 8 && merged.percentile(0.95) >= 100000 - 100000 / 8;
+}
+
+bool test_sampler() {
+    gateway::LatencySampler every(0);
+    gateway::LatencySampler sixteenth(4);
+    std::size_t a = 0;
+    std::size_t b = 0;
+    for (int i = 0; i < 1600; ++i) {
+        a += every.next() ? 1 : 0;
+        b += sixteenth.next() ? 1 : 0;
+    }
+    return a == 1600 && b == 100;
+}
+
+bool test_concurrent_snapshot() {
+    // A reader never sees counts go backwards while the writer records
+    gateway::LatencyHistogram h;
+    std::atomic<bool> done{false};
+    constexpr std::uint64_t kRecords = 200000;
+
+    std::thread writer([&] {
+        for (std::uint64_t i = 0; i < kRecords; ++i) {
+            h.record(i % 5000);
+        }
+        done = true;
+    });
+
+    bool ok = true;
+    std::uint64_t last = 0;
+    while (!done.load()) {
+        const std::uint64_t n = h.snapshot().count();
+        if (n < last || n > kRecords) ok = false;
+        last = n;
+    }
+    writer.join();
+    return ok && h.snapshot().count() == kRecords;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_bucket_bounds_cover_values()) {
+        std::printf("test_bucket_bounds_cover_values failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_bucket_relative_error()) {
+        std::printf("test_bucket_relative_error failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_percentiles()) {
+        std::printf("test_percentiles failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_empty_and_merge()) {
+        std::printf("test_empty_and_merge failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_sampler()) {
+        std::printf("test_sampler failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_concurrent_snapshot()) {
+        std::printf("test_concurrent_snapshot failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All histogram tests passed\n");
+    return EXIT_SUCCESS;
+}
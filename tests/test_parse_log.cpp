@@ -1,10 +1,15 @@
 #include "gateway/parse_log.hpp"
 
+#include <charconv>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
+#include <optional>
 
 // TB-3 logfmt log parsing tests.
 // Tests both invariants:
@@ -29,6 +34,82 @@ bool require_drop(std::string_view input, gateway::LogDropReason expected) {
     return is_drop_reason(r, expected);
 }
 
+// Byte-at-a-time reference parser (the pre-bitmap implementation), used
+// for differential testing of the tokenizer. Mirrors the parse_log
+// contract: same drop reasons, same fields.
+struct ReferenceLog {
+    std::optional<gateway::LogDropReason> drop;
+    std::vector<std::pair<std::string_view, std::string_view>> fields;
+};
+
+ReferenceLog reference_parse_log(std::string_view in) {
+    using R = gateway::LogDropReason;
+    auto key_start = [](char c) { return (c >= 'a' && c <= 'z') || c == '_'; };
+    auto key_char = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+    };
+    ReferenceLog out;
+    if (in.size() > gateway::LogLimits::kMaxLineBytes) return {R::InputTooLarge, {}};
+    while (!in.empty() && (in.back() == '\n' || in.back() == '\r' ||
+                           in.back() == ' ' || in.back() == '\t')) {
+        in.remove_suffix(1);
+    }
+    if (in.empty()) return {R::EmptyInput, {}};
+
+    bool ts = false, level = false, msg = false;
+    std::size_t pos = 0;
+    while (pos < in.size()) {
+        while (pos < in.size() && (in[pos] == ' ' || in[pos] == '\t')) ++pos;
+        if (pos >= in.size()) break;
+        if (out.fields.size() >= gateway::LogLimits::kMaxFields) return {R::TooManyFields, {}};
+
+        const std::size_t ks = pos;
+        if (!key_start(in[pos])) return {R::InvalidKeyChar, {}};
+        ++pos;
+        while (pos < in.size() && key_char(in[pos])) ++pos;
+        const auto key = in.substr(ks, pos - ks);
+        if (key.size() > gateway::LogLimits::kMaxKeyLen) return {R::KeyTooLong, {}};
+        if (pos >= in.size() || in[pos] != '=') return {R::MissingEquals, {}};
+        ++pos;
+
+        std::string_view value;
+        if (pos < in.size() && in[pos] == '"') {
+            const std::size_t close = in.find('"', pos + 1);
+            if (close == std::string_view::npos) return {R::UnterminatedQuote, {}};
+            value = in.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+        } else {
+            const std::size_t vs = pos;
+            while (pos < in.size() && in[pos] != ' ' && in[pos] != '\t' &&
+                   in[pos] != '"' && in[pos] != '=') {
+                ++pos;
+            }
+            value = in.substr(vs, pos - vs);
+        }
+        if (value.size() > gateway::LogLimits::kMaxValueLen) return {R::ValueTooLong, {}};
+        out.fields.emplace_back(key, value);
+
+        if (key == "ts") {
+            std::uint64_t v = 0;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), v);
+            if (ec != std::errc{} || ptr != value.data() + value.size()) {
+                return {R::InvalidTimestamp, {}};
+            }
+            ts = true;
+        } else if (key == "level") {
+            gateway::LogLevel l;
+            if (!gateway::parse_log_level(value, l)) return {R::InvalidLevel, {}};
+            level = true;
+        } else if (key == "msg") {
+            msg = true;
+        }
+    }
+    if (!ts) return {R::MissingTimestamp, {}};
+    if (!level) return {R::MissingLevel, {}};
+    if (!msg) return {R::MissingMessage, {}};
+    return out;
+}
+
 } // namespace
 
 int main() {
@@ -395,6 +476,105 @@ int main() {
         }
     }
 
+    // Test 26: Parse-into scratch reuse - no stale fields
+    {
+        gateway::ParsedLog scratch;
+        std::string_view first = "ts=1 level=warn agent=node1 msg=first extra=1 more=2";
+        if (gateway::parse_log(first, scratch).has_value() || scratch.field_count != 6) {
+            std::printf("Scratch reuse test failed: first message\n");
+            return EXIT_FAILURE;
+        }
+
+        std::string_view second = "ts=2 level=info msg=second";
+        if (gateway::parse_log(second, scratch).has_value()) {
+            std::printf("Scratch reuse test failed: second message dropped\n");
+            return EXIT_FAILURE;
+        }
+        if (scratch.field_count != 3 || scratch.ts != 2 || !scratch.agent_id.empty() ||
+            scratch.msg != "second" || scratch.level != gateway::LogLevel::Info) {
+            std::printf("Scratch reuse test failed: stale state from first message\n");
+            return EXIT_FAILURE;
+        }
+
+        auto drop = gateway::parse_log(std::string_view("ts=3 level=info"), scratch);
+        if (drop != gateway::LogDropReason::MissingMessage) {
+            std::printf("Parse-into drop reason test failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 27: Bitmap tokenizer matches the byte-at-a-time reference
+    {
+        // Random lines built from fragments that exercise every branch:
+        // valid fields, bad keys, stray '=' / '"', long keys and values,
+        // blanks across 64-byte bitmap words, line lengths near the limit
+        const std::string_view fragments[] = {
+            "ts=1705689600000", "level=info", "level=bogus", "msg=hi", "msg=\"a b c\"",
+            "agent=node-1", "k=v", "_x9=1", "Bad=1", "9k=1", "k-y=1", "k\"=1", "=v", "k=",
+            "k=\"open", "k=a=b", "k=a\"b", "ts=12x", " ", "\t", "  \t ",
+            "ab_cdefghijklmnopqrstuvwxyz_0123", "ab_cdefghijklmnopqrstuvwxyz_01234=1",
+        };
+        constexpr std::size_t kFragments = sizeof(fragments) / sizeof(fragments[0]);
+        std::uint32_t rng = 2024;
+        auto next = [&rng] {
+            rng = rng * 1103515245u + 12345u;
+            return rng >> 16;
+        };
+
+        for (int round = 0; round < 20000; ++round) {
+            // Half the lines start with the required fields so the success
+            // path (field slicing) is compared too, not just drop reasons
+            std::string line = (next() % 2) ? "ts=1 level=warn msg=\"m\" " : "";
+            const std::size_t parts = next() % 16;
+            for (std::size_t i = 0; i < parts; ++i) {
+                if (i > 0) line += (next() % 4 == 0) ? "\t" : " ";
+                if (next() % 16 == 0) {
+                    // Long bare or quoted value around kMaxValueLen
+                    const std::size_t len = gateway::LogLimits::kMaxValueLen - 2 + next() % 4;
+                    line += (next() % 2) ? "v=" + std::string(len, 'x')
+                                         : "v=\"" + std::string(len, ' ') + "\"";
+                } else {
+                    line += fragments[next() % kFragments];
+                }
+            }
+            if (next() % 8 == 0) line += "\r\n";
+
+            const ReferenceLog want = reference_parse_log(line);
+            gateway::ParsedLog got;
+            const auto drop = gateway::parse_log(line, got);
+            if (drop != want.drop) {
+                std::printf("Differential test failed: drop mismatch at round %d\n", round);
+                return EXIT_FAILURE;
+            }
+            if (drop) continue;
+            if (got.field_count != want.fields.size()) {
+                std::printf("Differential test failed: field count at round %d\n", round);
+                return EXIT_FAILURE;
+            }
+            for (std::size_t i = 0; i < got.field_count; ++i) {
+                if (got.fields[i].key != want.fields[i].first ||
+                    got.fields[i].value != want.fields[i].second) {
+                    std::printf("Differential test failed: field %zu at round %d\n", i, round);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    // Test 28: Key ending exactly at kMaxLineBytes -> MissingEquals
+    {
+        // Long blank run spans many bitmap words; the key's delimiter
+        // search runs off the end of the line
+        std::string line = "ts=1 level=info msg=x";
+        line += std::string(gateway::LogLimits::kMaxLineBytes - line.size() - 3, ' ');
+        line += "key";
+        if (line.size() != gateway::LogLimits::kMaxLineBytes ||
+            !require_drop(line, gateway::LogDropReason::MissingEquals)) {
+            std::printf("Max-length MissingEquals test failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+
     std::printf("All parse_log tests passed\n");
     return EXIT_SUCCESS;
 }
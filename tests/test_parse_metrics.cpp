@@ -2,6 +2,8 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <variant>
 
@@ -128,8 +130,8 @@ int main() {
             std::printf("Metric with tags test failed: wrong tag count\n");
             return EXIT_FAILURE;
         }
-        if (m->metrics[0].tags[0].key != "method" ||
-            m->metrics[0].tags[0].value != "GET") {
+        const auto tags = m->tags_of(m->metrics[0]);
+        if (tags[0].key != "method" || tags[0].value != "GET") {
             std::printf("Metric with tags test failed: wrong first tag\n");
             return EXIT_FAILURE;
         }
@@ -397,6 +399,176 @@ int main() {
         }
     }
 
+    // =========================================================================
+    // Parse-into API (reusable scratch, flat tag pool)
+    // =========================================================================
+
+    // Test 27: Scratch reuse - second message sees only its own metrics/tags
+    {
+        gateway::ParsedMetrics scratch;
+        std::string_view first = R"({"agent_id":"a","seq":1,"metrics":[
+            {"n":"x","v":1,"t":{"k1":"v1","k2":"v2"}},
+            {"n":"y","v":2},
+            {"n":"z","v":3,"t":{"k3":"v3"}}]})";
+        if (gateway::parse_metrics(first, scratch).has_value()) {
+            std::printf("Scratch reuse test failed: first message dropped\n");
+            return EXIT_FAILURE;
+        }
+        if (scratch.metric_count != 3 || scratch.tag_total != 3) {
+            std::printf("Scratch reuse test failed: wrong counts\n");
+            return EXIT_FAILURE;
+        }
+        if (!scratch.tags_of(scratch.metrics[1]).empty() ||
+            scratch.tags_of(scratch.metrics[2]).size() != 1 ||
+            scratch.tags_of(scratch.metrics[2])[0].key != "k3") {
+            std::printf("Scratch reuse test failed: wrong tag ranges\n");
+            return EXIT_FAILURE;
+        }
+
+        std::string_view second = R"({"agent_id":"b","seq":2,"metrics":[{"n":"w","v":4}]})";
+        if (gateway::parse_metrics(second, scratch).has_value()) {
+            std::printf("Scratch reuse test failed: second message dropped\n");
+            return EXIT_FAILURE;
+        }
+        if (scratch.agent_id != "b" || scratch.ts != 0 ||
+            scratch.metric_count != 1 || scratch.tag_total != 0 ||
+            !scratch.tags_of(scratch.metrics[0]).empty()) {
+            std::printf("Scratch reuse test failed: stale state from first message\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 28: Parse-into returns the same drop reasons
+    {
+        gateway::ParsedMetrics scratch;
+        auto drop = gateway::parse_metrics(std::string_view(R"({"agent_id":"a"})"), scratch);
+        if (drop != gateway::MetricsDropReason::MissingRequiredField) {
+            std::printf("Parse-into drop reason test failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 29: Tag pool bound across metrics -> TooManyTags
+    {
+        // Every metric is within kMaxTags, but the message total is not
+        auto build = [](std::size_t metrics) {
+            std::string input = R"({"agent_id":"a","seq":1,"metrics":[)";
+            for (std::size_t i = 0; i < metrics; ++i) {
+                if (i > 0) input += ",";
+                input += R"({"n":"m","v":1,"t":{)";
+                for (std::size_t t = 0; t < gateway::MetricsLimits::kMaxTags; ++t) {
+                    if (t > 0) input += ",";
+                    input += "\"k" + std::to_string(t) + "\":\"v\"";
+                }
+                input += "}}";
+            }
+            return input + "]}";
+        };
+        constexpr std::size_t kFull =
+            gateway::MetricsLimits::kMaxTotalTags / gateway::MetricsLimits::kMaxTags;
+
+        gateway::ParsedMetrics scratch;
+        if (gateway::parse_metrics(build(kFull), scratch).has_value() ||
+            scratch.tag_total != gateway::MetricsLimits::kMaxTotalTags) {
+            std::printf("Tag pool boundary test failed: full pool should parse\n");
+            return EXIT_FAILURE;
+        }
+        if (!require_drop(build(kFull + 1), gateway::MetricsDropReason::TooManyTags)) {
+            std::printf("Tag pool overflow test failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 30: Strings, escapes and numbers straddling vector block edges
+    {
+        for (std::size_t len = 0; len < 70; ++len) {
+            // Escaped quote lands at every offset within a block
+            std::string name(len, 'n');
+            name += "\\\"q";
+            std::string input = R"({"agent_id":"a","seq":1,"metrics":[{"n":")" + name +
+                                R"(","v":)" + std::string(len % 40 + 1, '7') + "}]}";
+            gateway::ParsedMetrics scratch;
+            if (gateway::parse_metrics(input, scratch).has_value()) {
+                std::printf("Block edge test failed at len %zu\n", len);
+                return EXIT_FAILURE;
+            }
+            if (scratch.metrics[0].name != std::string(len, 'n') + "\"q") {
+                std::printf("Block edge test failed: wrong name at len %zu\n", len);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Test 31: Escapes are decoded; limits count decoded bytes
+    {
+        const std::string input =
+            R"({"agent_id":"a\u0031","seq":1,"metrics":[{"n":"q\"\\\/\b\f\n\r\t",)"
+            R"("v":1,"u":"\u00b5s","t":{"p\u0061th":"C:\\tmp","e":"\ud83d\ude00"}}]})";
+        gateway::ParsedMetrics scratch;
+        if (gateway::parse_metrics(input, scratch).has_value()) {
+            std::printf("Escape test failed: did not parse\n");
+            return EXIT_FAILURE;
+        }
+        const auto& m = scratch.metrics[0];
+        const auto tags = scratch.tags_of(m);
+        if (scratch.agent_id != "a1" || m.name != "q\"\\/\b\f\n\r\t" || m.unit != "\xc2\xb5s" ||
+            tags[0].key != "path" || tags[0].value != "C:\\tmp" ||
+            tags[1].value != "\xf0\x9f\x98\x80") {
+            std::printf("Escape test failed: wrong decoded strings\n");
+            return EXIT_FAILURE;
+        }
+
+        // A copy views its own decoded text, not the source's
+        auto copy = std::make_unique<gateway::ParsedMetrics>(scratch);
+        scratch.text.fill('x');
+        if (copy->agent_id != "a1" || copy->metrics[0].unit != "\xc2\xb5s" ||
+            copy->tags_of(copy->metrics[0])[0].value != "C:\\tmp") {
+            std::printf("Escape test failed: copy views the source text\n");
+            return EXIT_FAILURE;
+        }
+
+        for (const char* bad : {R"(\x)", R"(\u12)", R"(\u12g4)", R"(\ud83d)", R"(\ude00)",
+                                R"(\ud83d\u0041)"}) {
+            const std::string body =
+                std::string(R"({"agent_id":"a","seq":1,"metrics":[{"n":"c)") + bad + R"(","v":1}]})";
+            if (!require_drop(body, gateway::MetricsDropReason::InvalidJson)) {
+                std::printf("Escape test failed: accepted %s\n", bad);
+                return EXIT_FAILURE;
+            }
+        }
+
+        // 16 escaped bytes decode to 16: at the unit limit, not over it
+        std::string unit;
+        for (int i = 0; i < 16; ++i) unit += "\\u0041";
+        const std::string at_limit =
+            R"({"agent_id":"a","seq":1,"metrics":[{"n":"c","v":1,"u":")" + unit + R"("}]})";
+        if (gateway::parse_metrics(at_limit, scratch).has_value() ||
+            scratch.metrics[0].unit != std::string(16, 'A')) {
+            std::printf("Escape test failed: limit not on decoded bytes\n");
+            return EXIT_FAILURE;
+        }
+        if (!require_drop(R"({"agent_id":"a","seq":1,"metrics":[{"n":"c","v":1,"u":")" + unit +
+                              R"(\n"}]})",
+                          gateway::MetricsDropReason::UnitTooLong)) {
+            std::printf("Escape test failed: 17 decoded bytes accepted\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 32: A repeated root key -> DuplicateField
+    {
+        for (std::string_view input : {
+                 R"({"agent_id":"a","agent_id":"b","seq":1,"metrics":[]})",
+                 R"({"agent_id":"a","seq":1,"ts":1,"ts":2,"metrics":[]})",
+                 R"({"agent_id":"a","seq":1,"metrics":[],"metrics":[]})"}) {
+            if (!require_drop(input, gateway::MetricsDropReason::DuplicateField)) {
+                std::printf("DuplicateField test failed: %.*s\n", static_cast<int>(input.size()),
+                            input.data());
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
     std::printf("All parse_metrics tests passed\n");
     return EXIT_SUCCESS;
 }
@@ -1,13 +1,16 @@
 #include "gateway/recv_loop.hpp"
 
 #include <arpa/inet.h>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 // Platform detection: MSG_TRUNC behavior differs between Linux and macOS
 // On Linux, recvfrom with MSG_TRUNC returns the actual packet size even if truncated
@@ -373,6 +376,633 @@ bool test_zero_byte_datagram() {
     return true;
 }
 
+bool test_batch_reception() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvConfig config{};
+    config.batch_size = 8;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    // Send 5 packets of distinct sizes
+    for (std::size_t len = 1; len <= 5; ++len) {
+        std::vector<char> packet(len, 'a');
+        if (!send_to_port(port, packet.data(), packet.size())) {
+            close(fd);
+            return false;
+        }
+    }
+
+    auto results = recv_loop.recv_batch();
+
+    if (results.size() != 5) {
+        std::printf("Expected 5 results in batch, got %zu\n", results.size());
+        close(fd);
+        return false;
+    }
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (results[i].status != gateway::RecvStatus::Ok) {
+            std::printf("Expected Ok at slot %zu\n", i);
+            close(fd);
+            return false;
+        }
+        if (results[i].datagram.data.size() != i + 1) {
+            std::printf("Expected %zu bytes at slot %zu, got %zu\n",
+                        i + 1, i, results[i].datagram.data.size());
+            close(fd);
+            return false;
+        }
+        if (results[i].datagram.source.ip != 0x7F000001) {
+            std::printf("Expected loopback source at slot %zu\n", i);
+            close(fd);
+            return false;
+        }
+    }
+
+    if (recv_loop.metrics().received != 5) {
+        std::printf("Expected received=5, got %llu\n", recv_loop.metrics().received);
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_batch_respects_batch_size() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvConfig config{};
+    config.batch_size = 4;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    // 10 packets, batch of 4 -> 4, 4, 2
+    for (int i = 0; i < 10; ++i) {
+        send_to_port(port, "ping", 4);
+    }
+
+    const std::size_t expected[] = {4, 4, 2};
+    for (std::size_t want : expected) {
+        auto results = recv_loop.recv_batch();
+        if (results.size() != want) {
+            std::printf("Expected batch of %zu, got %zu\n", want, results.size());
+            close(fd);
+            return false;
+        }
+    }
+
+    if (recv_loop.metrics().received != 10) {
+        std::printf("Expected received=10, got %llu\n", recv_loop.metrics().received);
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_batch_truncation_per_message() {
+#if !TRUNCATION_DETECTION_SUPPORTED
+    // Skip on platforms where MSG_TRUNC doesn't return actual packet size
+    std::printf("(skipped on this platform) ");
+    return true;
+#else
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvConfig config{};
+    config.max_datagram_bytes = 50;
+    config.batch_size = 8;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    // ok, truncated, ok (exact limit), truncated (one over)
+    std::vector<char> small(30, 'a');
+    std::vector<char> large(100, 'b');
+    std::vector<char> exact(50, 'c');
+    std::vector<char> over(51, 'd');
+
+    send_to_port(port, small.data(), small.size());
+    send_to_port(port, large.data(), large.size());
+    send_to_port(port, exact.data(), exact.size());
+    send_to_port(port, over.data(), over.size());
+
+    auto results = recv_loop.recv_batch();
+    if (results.size() != 4) {
+        std::printf("Expected 4 results, got %zu\n", results.size());
+        close(fd);
+        return false;
+    }
+
+    const gateway::RecvStatus expected[] = {
+        gateway::RecvStatus::Ok,
+        gateway::RecvStatus::Truncated,
+        gateway::RecvStatus::Ok,
+        gateway::RecvStatus::Truncated,
+    };
+    for (std::size_t i = 0; i < 4; ++i) {
+        if (results[i].status != expected[i]) {
+            std::printf("Slot %zu: expected status %d, got %d\n", i,
+                        static_cast<int>(expected[i]),
+                        static_cast<int>(results[i].status));
+            close(fd);
+            return false;
+        }
+    }
+
+    if (results[2].datagram.data.size() != 50) {
+        std::printf("Expected 50 bytes for exact-limit slot\n");
+        close(fd);
+        return false;
+    }
+
+    if (recv_loop.metrics().received != 2 || recv_loop.metrics().truncated != 2) {
+        std::printf("Expected received=2 truncated=2, got %llu/%llu\n",
+                    recv_loop.metrics().received, recv_loop.metrics().truncated);
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+#endif
+}
+
+bool test_batch_would_block() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+    (void)port;
+
+    // Non-blocking socket with no pending data
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    gateway::RecvConfig config{};
+    gateway::RecvLoop recv_loop(fd, config);
+
+    auto results = recv_loop.recv_batch();
+    if (!results.empty()) {
+        std::printf("Expected empty batch on WouldBlock, got %zu\n", results.size());
+        close(fd);
+        return false;
+    }
+
+    if (recv_loop.metrics().errors != 0) {
+        std::printf("WouldBlock must not count as error\n");
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_datagram_views_pooled_buffer() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvConfig config{};
+    config.batch_size = 4;
+    config.buffer_pool_size = 4;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    send_to_port(port, "abc", 3);
+
+    {
+        auto result = recv_loop.recv_one();
+        if (result.status != gateway::RecvStatus::Ok) {
+            close(fd);
+            return false;
+        }
+
+        // Bytes are a view into the pooled buffer held by the datagram
+        if (result.datagram.data.size() != 3 ||
+            result.datagram.data.data() != result.datagram.buffer.bytes().data() ||
+            std::memcmp(result.datagram.data.data(), "abc", 3) != 0) {
+            std::printf("Expected datagram to view its pooled buffer\n");
+            close(fd);
+            return false;
+        }
+
+        if (recv_loop.buffer_pool().available() != 3) {
+            std::printf("Expected one buffer in use, got %zu free\n",
+                        recv_loop.buffer_pool().available());
+            close(fd);
+            return false;
+        }
+    }
+
+    // Dropping the result returns the buffer
+    if (recv_loop.buffer_pool().available() != 4) {
+        std::printf("Expected buffer returned after datagram dropped\n");
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_pool_exhaustion_no_buffer() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvConfig config{};
+    config.batch_size = 2;
+    config.buffer_pool_size = 2;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    for (int i = 0; i < 3; ++i) {
+        send_to_port(port, "x", 1);
+    }
+
+    // Hold both pooled buffers
+    auto first = recv_loop.recv_one();
+    auto second = recv_loop.recv_one();
+    if (first.status != gateway::RecvStatus::Ok ||
+        second.status != gateway::RecvStatus::Ok) {
+        close(fd);
+        return false;
+    }
+
+    // Pool exhausted: recv is skipped, datagram stays in the kernel queue
+    auto third = recv_loop.recv_one();
+    if (third.status != gateway::RecvStatus::NoBuffer) {
+        std::printf("Expected NoBuffer, got %d\n", static_cast<int>(third.status));
+        close(fd);
+        return false;
+    }
+
+    auto batch = recv_loop.recv_batch();
+    if (batch.size() != 1 || batch[0].status != gateway::RecvStatus::NoBuffer) {
+        std::printf("Expected single NoBuffer result from batch\n");
+        close(fd);
+        return false;
+    }
+
+    if (recv_loop.metrics().no_buffer != 2) {
+        std::printf("Expected no_buffer=2, got %llu\n", recv_loop.metrics().no_buffer);
+        close(fd);
+        return false;
+    }
+
+    // Release one buffer; the queued datagram is now received
+    first = gateway::RecvResult{};
+    auto retry = recv_loop.recv_one();
+    if (retry.status != gateway::RecvStatus::Ok) {
+        std::printf("Expected Ok after buffer release\n");
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_batch_releases_previous_buffers() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvConfig config{};
+    config.batch_size = 4;
+    config.buffer_pool_size = 4;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    // Two full batches through a pool that holds exactly one batch
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            send_to_port(port, "data", 4);
+        }
+        auto batch = recv_loop.recv_batch();
+        if (batch.size() != 4) {
+            std::printf("Round %d: expected 4 results, got %zu\n", round, batch.size());
+            close(fd);
+            return false;
+        }
+        for (const auto& r : batch) {
+            if (r.status != gateway::RecvStatus::Ok ||
+                std::memcmp(r.datagram.data.data(), "data", 4) != 0) {
+                std::printf("Round %d: bad datagram in batch\n", round);
+                close(fd);
+                return false;
+            }
+        }
+    }
+
+    // Keeping a datagram beyond the batch keeps its buffer out of the pool
+    send_to_port(port, "keep", 4);
+    auto batch = recv_loop.recv_batch();
+    if (batch.size() != 1) {
+        close(fd);
+        return false;
+    }
+    gateway::Datagram kept = std::move(batch[0].datagram);
+    if (recv_loop.buffer_pool().available() != 3) {
+        std::printf("Expected 3 free buffers while datagram is kept\n");
+        close(fd);
+        return false;
+    }
+    if (std::memcmp(kept.data.data(), "keep", 4) != 0) {
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_create_reuseport_sockets() {
+    // Port 0: every socket in the group must share the first assigned port
+    auto fds = gateway::create_reuseport_sockets(0, 3);
+    if (fds.size() != 3) {
+        std::printf("Expected 3 reuseport sockets, got %zu\n", fds.size());
+        for (int fd : fds) close(fd);
+        return false;
+    }
+
+    std::uint16_t first_port = 0;
+    bool ok = true;
+    for (int fd : fds) {
+        sockaddr_in addr{};
+        socklen_t len = sizeof(addr);
+        if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+            ok = false;
+            break;
+        }
+        std::uint16_t p = ntohs(addr.sin_port);
+        if (first_port == 0) {
+            first_port = p;
+        } else if (p != first_port) {
+            std::printf("Expected shared port %u, got %u\n", first_port, p);
+            ok = false;
+            break;
+        }
+    }
+
+    // A datagram to the shared port lands on exactly one socket of the group
+    if (ok) {
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+        send_to_port(first_port, "hi", 2);
+
+        std::size_t received = 0;
+        for (int fd : fds) {
+            gateway::RecvLoop loop(fd);
+            received += loop.recv_batch().size();
+        }
+        if (received != 1) {
+            std::printf("Expected datagram on exactly one socket, got %zu\n", received);
+            ok = false;
+        }
+    }
+
+    for (int fd : fds) close(fd);
+    return ok;
+}
+
+bool test_pin_invalid_cpu() {
+    if (gateway::pin_current_thread_to_cpu(-1)) {
+        std::printf("Pinning to CPU -1 must fail\n");
+        return false;
+    }
+    return true;
+}
+
+// Collect `want` results via recv_batch(max_wait), moving datagrams out
+std::vector<gateway::RecvResult> collect(gateway::RecvLoop& recv_loop, std::size_t want) {
+    std::vector<gateway::RecvResult> out;
+    for (int tries = 0; tries < 50 && out.size() < want; ++tries) {
+        for (auto& r : recv_loop.recv_batch(std::chrono::milliseconds(20))) {
+            out.push_back(std::move(r));
+        }
+    }
+    return out;
+}
+
+gateway::RecvConfig uring_config() {
+    gateway::RecvConfig config{};
+    config.backend = gateway::RecvBackend::IoUring;
+    config.batch_size = 8;
+    config.buffer_pool_size = 16;
+    return config;
+}
+
+bool test_uring_reception() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    gateway::RecvLoop recv_loop(fd, uring_config());
+    std::printf("  io_uring backend %s\n",
+                recv_loop.backend() == gateway::RecvBackend::IoUring ? "active" : "unavailable, using recvmmsg");
+
+    for (int i = 0; i < 5; ++i) {
+        char msg[8];
+        std::snprintf(msg, sizeof(msg), "msg-%d", i);
+        send_to_port(port, msg, std::strlen(msg));
+    }
+
+    auto results = collect(recv_loop, 5);
+    if (results.size() != 5) {
+        std::printf("Expected 5 datagrams, got %zu\n", results.size());
+        close(fd);
+        return false;
+    }
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        char expected[8];
+        std::snprintf(expected, sizeof(expected), "msg-%zu", i);
+        const auto bytes = r.datagram.buffer.bytes();
+        if (r.status != gateway::RecvStatus::Ok || r.datagram.data.size() != std::strlen(expected) ||
+            std::memcmp(r.datagram.data.data(), expected, r.datagram.data.size()) != 0) {
+            std::printf("Datagram %zu mismatch\n", i);
+            close(fd);
+            return false;
+        }
+        // Bytes stay inside the pooled buffer the kernel wrote
+        if (r.datagram.data.data() < bytes.data() ||
+            r.datagram.data.data() + r.datagram.data.size() > bytes.data() + bytes.size()) {
+            std::printf("Datagram %zu does not view its pooled buffer\n", i);
+            close(fd);
+            return false;
+        }
+        if (r.datagram.source.ip != 0x7F000001 || r.datagram.source.port == 0) {
+            std::printf("Bad source for datagram %zu\n", i);
+            close(fd);
+            return false;
+        }
+    }
+
+    if (recv_loop.metrics().received != 5 || recv_loop.metrics().errors != 0) {
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_uring_tb1_limits() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    auto config = uring_config();
+    config.max_datagram_bytes = 100;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    std::vector<char> exact(100, 'a');
+    std::vector<char> over(101, 'b');
+    send_to_port(port, exact.data(), exact.size());
+    send_to_port(port, over.data(), over.size());
+
+    auto results = collect(recv_loop, 2);
+    if (results.size() != 2) {
+        std::printf("Expected 2 results, got %zu\n", results.size());
+        close(fd);
+        return false;
+    }
+    if (results[0].status != gateway::RecvStatus::Ok || results[0].datagram.data.size() != 100) {
+        std::printf("Expected exact-limit datagram accepted\n");
+        close(fd);
+        return false;
+    }
+#if TRUNCATION_DETECTION_SUPPORTED
+    if (results[1].status != gateway::RecvStatus::Truncated || recv_loop.metrics().truncated != 1) {
+        std::printf("Expected one-over-limit datagram truncated\n");
+        close(fd);
+        return false;
+    }
+#endif
+
+    close(fd);
+    return true;
+}
+
+bool test_uring_pool_exhaustion() {
+    auto [fd, port] = create_test_socket();
+    if (fd < 0) {
+        std::printf("Failed to create test socket\n");
+        return false;
+    }
+
+    auto config = uring_config();
+    config.batch_size = 2;
+    config.buffer_pool_size = 2;
+    gateway::RecvLoop recv_loop(fd, config);
+
+    for (int i = 0; i < 4; ++i) {
+        send_to_port(port, "x", 1);
+    }
+
+    // Hold both pooled buffers beyond their batch
+    auto held = collect(recv_loop, 2);
+    if (held.size() != 2 || held[0].status != gateway::RecvStatus::Ok ||
+        held[1].status != gateway::RecvStatus::Ok) {
+        std::printf("Expected 2 held datagrams\n");
+        close(fd);
+        return false;
+    }
+
+    auto batch = recv_loop.recv_batch(std::chrono::milliseconds(10));
+    if (batch.size() != 1 || batch[0].status != gateway::RecvStatus::NoBuffer) {
+        std::printf("Expected single NoBuffer result\n");
+        close(fd);
+        return false;
+    }
+
+    // Released buffers are lent again; the queued datagrams arrive
+    held.clear();
+    std::size_t ok = 0;
+    for (int tries = 0; tries < 50 && ok < 2; ++tries) {
+        for (const auto& r : recv_loop.recv_batch(std::chrono::milliseconds(20))) {
+            ok += r.status == gateway::RecvStatus::Ok ? 1 : 0;
+        }
+    }
+    if (ok != 2) {
+        std::printf("Expected 2 datagrams after release, got %zu\n", ok);
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+    return true;
+}
+
+bool test_batch_wait_timeout() {
+    for (auto backend : {gateway::RecvBackend::Recvmmsg, gateway::RecvBackend::IoUring}) {
+        auto [fd, port] = create_test_socket();
+        if (fd < 0) {
+            std::printf("Failed to create test socket\n");
+            return false;
+        }
+        gateway::RecvConfig config{};
+        config.backend = backend;
+        gateway::RecvLoop recv_loop(fd, config);
+
+        // Nothing queued: waits about max_wait, then returns empty
+        const auto start = std::chrono::steady_clock::now();
+        if (!recv_loop.recv_batch(std::chrono::milliseconds(20)).empty()) {
+            close(fd);
+            return false;
+        }
+        if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(15)) {
+            std::printf("Expected recv_batch to wait for data\n");
+            close(fd);
+            return false;
+        }
+        // Zero wait never blocks, even on a blocking socket
+        if (!recv_loop.recv_batch(std::chrono::microseconds(0)).empty()) {
+            close(fd);
+            return false;
+        }
+
+        // A datagram arriving mid-wait ends it early
+        std::thread sender([port = port] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            send_to_port(port, "wake", 4);
+        });
+        const auto wait_start = std::chrono::steady_clock::now();
+        auto batch = recv_loop.recv_batch(std::chrono::seconds(2));
+        const auto waited = std::chrono::steady_clock::now() - wait_start;
+        sender.join();
+        if (batch.size() != 1 || batch[0].status != gateway::RecvStatus::Ok ||
+            waited > std::chrono::milliseconds(1000)) {
+            std::printf("Expected wake-up on arrival\n");
+            close(fd);
+            return false;
+        }
+        close(fd);
+    }
+    return true;
+}
+
 }  // namespace
 
 int main() {
@@ -416,6 +1046,71 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    if (!test_batch_reception()) {
+        std::printf("test_batch_reception failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_batch_respects_batch_size()) {
+        std::printf("test_batch_respects_batch_size failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_batch_truncation_per_message()) {
+        std::printf("test_batch_truncation_per_message failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_batch_would_block()) {
+        std::printf("test_batch_would_block failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_datagram_views_pooled_buffer()) {
+        std::printf("test_datagram_views_pooled_buffer failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_pool_exhaustion_no_buffer()) {
+        std::printf("test_pool_exhaustion_no_buffer failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_batch_releases_previous_buffers()) {
+        std::printf("test_batch_releases_previous_buffers failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_create_reuseport_sockets()) {
+        std::printf("test_create_reuseport_sockets failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_pin_invalid_cpu()) {
+        std::printf("test_pin_invalid_cpu failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_uring_reception()) {
+        std::printf("test_uring_reception failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_uring_tb1_limits()) {
+        std::printf("test_uring_tb1_limits failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_uring_pool_exhaustion()) {
+        std::printf("test_uring_pool_exhaustion failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_batch_wait_timeout()) {
+        std::printf("test_batch_wait_timeout failed\n");
+        return EXIT_FAILURE;
+    }
+
     std::printf("All recv_loop tests passed\n");
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,284 @@
+#include "gateway/ring_queue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Shared single-threaded checks for both rings
+template <typename Ring>
+bool check_basic_fifo_and_drop() {
+    Ring ring(3);  // rounds up to 4
+
+    if (ring.capacity() != 4) {
+        std::printf("Expected capacity rounded to 4, got %zu\n", ring.capacity());
+        return false;
+    }
+    if (!ring.empty()) return false;
+
+    for (int i = 1; i <= 4; ++i) {
+        if (ring.try_push(i) != gateway::PushResult::Ok) return false;
+    }
+    if (!ring.full()) return false;
+
+    // Full: drops are counted, contents untouched
+    if (ring.try_push(5) != gateway::PushResult::Dropped) return false;
+    if (ring.drop_count() != 1) return false;
+
+    const int* p = ring.peek();
+    if (p == nullptr || *p != 1) return false;
+
+    for (int i = 1; i <= 4; ++i) {
+        auto v = ring.try_pop();
+        if (!v || *v != i) return false;
+    }
+    if (ring.try_pop().has_value()) return false;
+    if (ring.peek() != nullptr) return false;
+
+    ring.reset_drop_count();
+    if (ring.drop_count() != 0) return false;
+
+    return true;
+}
+
+template <typename Ring>
+bool check_wrap_around() {
+    Ring ring(4);
+
+    // Many laps over a small ring
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            if (ring.try_push(round * 10 + i) != gateway::PushResult::Ok) return false;
+        }
+        for (int i = 0; i < 3; ++i) {
+            int v = -1;
+            if (!ring.try_pop(v) || v != round * 10 + i) {
+                std::printf("Wrap-around mismatch at round %d\n", round);
+                return false;
+            }
+        }
+    }
+    return ring.empty() && ring.drop_count() == 0;
+}
+
+template <typename Ring>
+bool check_bulk() {
+    Ring ring(4);
+
+    // Push 6 into 4 slots: 4 pushed, 2 dropped
+    std::vector<int> in = {1, 2, 3, 4, 5, 6};
+    if (ring.try_push_n(in) != 4) return false;
+    if (ring.drop_count() != 2) return false;
+
+    // Pop in two bulk chunks
+    std::vector<int> out(3, 0);
+    if (ring.try_pop_n(out) != 3) return false;
+    if (out[0] != 1 || out[1] != 2 || out[2] != 3) return false;
+    if (ring.try_pop_n(out) != 1) return false;
+    if (out[0] != 4) return false;
+    if (ring.try_pop_n(out) != 0) return false;
+
+    // Empty span is a no-op
+    std::vector<int> none;
+    if (ring.try_push_n(none) != 0) return false;
+    if (ring.drop_count() != 2) return false;
+
+    return true;
+}
+
+template <typename Ring>
+bool check_move_only() {
+    Ring ring(2);
+
+    if (ring.try_push(std::make_unique<int>(7)) != gateway::PushResult::Ok) return false;
+    auto v = ring.try_pop();
+    if (!v || !*v || **v != 7) return false;
+
+    return true;
+}
+
+bool test_capacity_rounding() {
+    if (gateway::round_up_pow2(0) != 1) return false;
+    if (gateway::round_up_pow2(1) != 1) return false;
+    if (gateway::round_up_pow2(5) != 8) return false;
+    if (gateway::round_up_pow2(64) != 64) return false;
+
+    gateway::SpscRing<int> zero(0);
+    if (zero.capacity() != 1) return false;
+    if (zero.try_push(1) != gateway::PushResult::Ok) return false;
+    if (zero.try_push(2) != gateway::PushResult::Dropped) return false;
+
+    return true;
+}
+
+bool test_spsc_single_thread() {
+    return check_basic_fifo_and_drop<gateway::SpscRing<int>>() &&
+           check_wrap_around<gateway::SpscRing<int>>() &&
+           check_bulk<gateway::SpscRing<int>>() &&
+           check_move_only<gateway::SpscRing<std::unique_ptr<int>>>();
+}
+
+bool test_mpsc_single_thread() {
+    return check_basic_fifo_and_drop<gateway::MpscRing<int>>() &&
+           check_wrap_around<gateway::MpscRing<int>>() &&
+           check_bulk<gateway::MpscRing<int>>() &&
+           check_move_only<gateway::MpscRing<std::unique_ptr<int>>>();
+}
+
+bool test_spsc_concurrent_order() {
+    // Producer retries on full, so every item must arrive, in order
+    constexpr std::uint64_t kItems = 200000;
+    gateway::SpscRing<std::uint64_t> ring(64);
+
+    std::thread producer([&] {
+        for (std::uint64_t i = 0; i < kItems; ++i) {
+            while (ring.try_push(i) != gateway::PushResult::Ok) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint64_t expected = 0;
+    std::uint64_t buf[16];
+    while (expected < kItems) {
+        std::size_t n = ring.try_pop_n(buf);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (buf[i] != expected) {
+                std::printf("SPSC order broken: expected %lu, got %lu\n",
+                            static_cast<unsigned long>(expected),
+                            static_cast<unsigned long>(buf[i]));
+                producer.join();
+                return false;
+            }
+            ++expected;
+        }
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    // Every retry was a counted drop; nothing left over
+    return ring.empty();
+}
+
+bool test_mpsc_concurrent_accounting() {
+    // Producers never retry: pushed + dropped must equal attempted, the
+    // consumer must see exactly the pushed items, and each producer's
+    // items must arrive in the order it pushed them.
+    constexpr unsigned kProducers = 4;
+    constexpr std::uint64_t kPerProducer = 50000;
+    gateway::MpscRing<std::uint64_t> ring(256);
+
+    std::vector<std::uint64_t> pushed(kProducers, 0);
+    std::atomic<unsigned> done{0};
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            std::uint64_t seq = 0;
+            while (seq < kPerProducer) {
+                // Alternate single and bulk pushes
+                if (seq % 2 == 0) {
+                    const std::uint64_t item = (std::uint64_t{p} << 32) | seq++;
+                    if (ring.try_push(item) == gateway::PushResult::Ok) {
+                        ++pushed[p];
+                    }
+                } else {
+                    std::uint64_t items[4];
+                    std::size_t count = 0;
+                    while (count < 4 && seq < kPerProducer) {
+                        items[count++] = (std::uint64_t{p} << 32) | seq++;
+                    }
+                    pushed[p] += ring.try_push_n(std::span(items, count));
+                }
+            }
+            done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::vector<std::uint64_t> received(kProducers, 0);
+    std::vector<std::int64_t> last_seq(kProducers, -1);
+    bool ok = true;
+    std::uint64_t buf[32];
+    while (true) {
+        // Read done before popping: once all producers are done and a pop
+        // returns nothing, the ring is drained for good.
+        const bool all_done = done.load(std::memory_order_acquire) == kProducers;
+        const std::size_t n = ring.try_pop_n(buf);
+        for (std::size_t i = 0; i < n; ++i) {
+            const unsigned p = static_cast<unsigned>(buf[i] >> 32);
+            const auto seq = static_cast<std::int64_t>(buf[i] & 0xFFFFFFFFu);
+            if (p >= kProducers || seq <= last_seq[p]) {
+                ok = false;
+                continue;
+            }
+            last_seq[p] = seq;
+            ++received[p];
+        }
+        if (n == 0) {
+            if (all_done) break;
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) t.join();
+
+    if (!ok) {
+        std::printf("MPSC per-producer order broken\n");
+        return false;
+    }
+
+    std::uint64_t total_pushed = 0;
+    std::uint64_t total_received = 0;
+    for (unsigned p = 0; p < kProducers; ++p) {
+        if (received[p] != pushed[p]) {
+            std::printf("Producer %u: pushed %lu, received %lu\n", p,
+                        static_cast<unsigned long>(pushed[p]),
+                        static_cast<unsigned long>(received[p]));
+            return false;
+        }
+        total_pushed += pushed[p];
+        total_received += received[p];
+    }
+    if (total_pushed + ring.drop_count() != kProducers * kPerProducer) {
+        std::printf("Pushed + dropped != attempted\n");
+        return false;
+    }
+    return total_received == total_pushed && ring.empty();
+}
+
+}  // namespace
+
+int main() {
+    if (!test_capacity_rounding()) {
+        std::printf("test_capacity_rounding failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_spsc_single_thread()) {
+        std::printf("test_spsc_single_thread failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_mpsc_single_thread()) {
+        std::printf("test_mpsc_single_thread failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_spsc_concurrent_order()) {
+        std::printf("test_spsc_concurrent_order failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_mpsc_concurrent_accounting()) {
+        std::printf("test_mpsc_concurrent_accounting failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All ring_queue tests passed\n");
+    return EXIT_SUCCESS;
+}
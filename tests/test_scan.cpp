@@ -0,0 +1,234 @@
+#include "gateway/scan.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+// Differential tests: the compiled vector path against the scalar
+// reference, over every length/alignment around the block size.
+
+namespace {
+
+using ScanFn = std::size_t (*)(const char*, std::size_t) noexcept;
+
+struct ScanPair {
+    const char* name;
+    ScanFn fast;
+    ScanFn reference;
+};
+
+constexpr ScanPair kScans[] = {
+    {"find_quote_or_escape", gateway::scan::find_quote_or_escape,
+     gateway::scan::scalar::find_quote_or_escape},
+    {"skip_whitespace", gateway::scan::skip_whitespace, gateway::scan::scalar::skip_whitespace},
+    {"skip_digits", gateway::scan::skip_digits, gateway::scan::scalar::skip_digits},
+};
+
+// Byte source biased towards the classes the scanners care about
+char random_byte(std::uint32_t& rng, std::string_view alphabet) {
+    rng = rng * 1103515245u + 12345u;
+    const std::uint32_t r = rng >> 16;
+    if (r % 4 == 0) {
+        return static_cast<char>(r >> 8);  // any byte, including >= 0x80
+    }
+    return alphabet[(r >> 2) % alphabet.size()];
+}
+
+bool check_all(const char* buf, std::size_t n) {
+    for (const auto& scan : kScans) {
+        const std::size_t got = scan.fast(buf, n);
+        const std::size_t want = scan.reference(buf, n);
+        if (got != want) {
+            std::printf("%s mismatch: n=%zu got=%zu want=%zu\n", scan.name, n, got, want);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_empty_input() {
+    // n == 0 must not dereference p
+    for (const auto& scan : kScans) {
+        if (scan.fast(nullptr, 0) != 0) return false;
+    }
+    return true;
+}
+
+bool test_single_stop_every_position() {
+    // Runs of one class with one stop byte at every position, so each scan
+    // must find a hit in every lane of a block and in the scalar tail
+    constexpr std::size_t kLen = 3 * 32 + 7;
+    char buf[kLen];
+
+    for (std::size_t stop = 0; stop <= kLen; ++stop) {
+        std::memset(buf, 'a', kLen);
+        if (stop < kLen) buf[stop] = '"';
+        if (gateway::scan::find_quote_or_escape(buf, kLen) != stop) return false;
+        if (stop < kLen) buf[stop] = '\\';
+        if (gateway::scan::find_quote_or_escape(buf, kLen) != stop) return false;
+
+        std::memset(buf, ' ', kLen);
+        if (stop < kLen) buf[stop] = 'x';
+        if (gateway::scan::skip_whitespace(buf, kLen) != stop) return false;
+
+        std::memset(buf, '7', kLen);
+        if (stop < kLen) buf[stop] = '.';
+        if (gateway::scan::skip_digits(buf, kLen) != stop) return false;
+    }
+    return true;
+}
+
+bool test_digit_range_edges() {
+    // Bytes just outside '0'..'9' (and high bytes) must stop the digit scan
+    const char edges[] = {'/', ':', '\0', static_cast<char>(0x80), static_cast<char>(0xB0),
+                          static_cast<char>(0xFF)};
+    char buf[64];
+    for (char e : edges) {
+        std::memset(buf, '5', sizeof(buf));
+        buf[40] = e;
+        if (gateway::scan::skip_digits(buf, sizeof(buf)) != 40) {
+            std::printf("skip_digits did not stop at byte 0x%02x\n",
+                        static_cast<unsigned>(static_cast<unsigned char>(e)));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_never_reads_past_end() {
+    // Each buffer is an exact-size heap allocation with no stop byte, so
+    // every scan runs to the end; a vector over-read trips ASan
+    for (std::size_t n = 1; n <= 100; ++n) {
+        auto text = std::make_unique<char[]>(n);
+        std::memset(text.get(), 'a', n);
+        if (gateway::scan::find_quote_or_escape(text.get(), n) != n) return false;
+
+        std::memset(text.get(), ' ', n);
+        if (gateway::scan::skip_whitespace(text.get(), n) != n) return false;
+
+        std::memset(text.get(), '9', n);
+        if (gateway::scan::skip_digits(text.get(), n) != n) return false;
+    }
+    return true;
+}
+
+bool test_random_differential() {
+    // Random buffers at every offset/length around the block size
+    constexpr std::size_t kBuf = 160;
+    constexpr std::string_view kAlphabets[] = {
+        "abcdefgh_-.:,{}[]",  // JSON-ish text, few stop bytes
+        "\"\\abc",            // dense quotes and escapes
+        " \t\n\rx",           // whitespace runs
+        "0123456789.e-",      // numbers
+    };
+    std::uint32_t rng = 12345;
+    char buf[kBuf];
+
+    for (int round = 0; round < 400; ++round) {
+        const auto alphabet = kAlphabets[static_cast<std::size_t>(round) % 4];
+        for (auto& c : buf) c = random_byte(rng, alphabet);
+
+        for (std::size_t offset = 0; offset < 33; ++offset) {
+            for (std::size_t n = 0; offset + n <= kBuf; n += 1 + n / 16) {
+                if (!check_all(buf + offset, n)) {
+                    std::printf("  (round %d, offset %zu)\n", round, offset);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool test_delimiter_bitmaps_differential() {
+    // Every length up to a max log line's worth of words, random offsets,
+    // against the scalar bitmaps (including the zeroed bits past n)
+    constexpr std::size_t kBuf = 300;
+    constexpr std::size_t kWords = (kBuf + 63) / 64;
+    std::uint32_t rng = 99;
+    char buf[kBuf + 8];
+
+    for (int round = 0; round < 50; ++round) {
+        for (auto& c : buf) c = random_byte(rng, "ab= \t\"");
+        for (std::size_t n = 0; n <= kBuf; ++n) {
+            const std::size_t offset = static_cast<std::size_t>(round) % 8;
+            std::uint64_t fb[kWords], fe[kWords], fq[kWords];
+            std::uint64_t rb[kWords], re[kWords], rq[kWords];
+            gateway::scan::delimiter_bitmaps(buf + offset, n, fb, fe, fq);
+            gateway::scan::scalar::delimiter_bitmaps(buf + offset, n, rb, re, rq);
+            for (std::size_t w = 0; w < (n + 63) / 64; ++w) {
+                if (fb[w] != rb[w] || fe[w] != re[w] || fq[w] != rq[w]) {
+                    std::printf("delimiter_bitmaps mismatch: n=%zu word=%zu\n", n, w);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool test_delimiter_bitmaps_positions() {
+    // One delimiter of each class at known positions across word edges
+    char buf[130];
+    std::memset(buf, 'x', sizeof(buf));
+    buf[0] = ' ';
+    buf[63] = '\t';
+    buf[64] = '=';
+    buf[127] = '"';
+    buf[129] = '=';
+    std::uint64_t b[3], e[3], q[3];
+    gateway::scan::delimiter_bitmaps(buf, sizeof(buf), b, e, q);
+
+    if (b[0] != ((std::uint64_t{1} << 63) | 1) || b[1] != 0 || b[2] != 0) return false;
+    if (e[0] != 0 || e[1] != 1 || e[2] != 2) return false;
+    if (q[0] != 0 || q[1] != (std::uint64_t{1} << 63) || q[2] != 0) return false;
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    std::printf("scan path: %s (%zu-byte blocks)\n", gateway::scan::kPathName,
+                gateway::scan::kBlockBytes);
+
+    if (!test_empty_input()) {
+        std::printf("test_empty_input failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_single_stop_every_position()) {
+        std::printf("test_single_stop_every_position failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_digit_range_edges()) {
+        std::printf("test_digit_range_edges failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_never_reads_past_end()) {
+        std::printf("test_never_reads_past_end failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_random_differential()) {
+        std::printf("test_random_differential failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_delimiter_bitmaps_positions()) {
+        std::printf("test_delimiter_bitmaps_positions failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_delimiter_bitmaps_differential()) {
+        std::printf("test_delimiter_bitmaps_differential failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All scan tests passed\n");
+    return EXIT_SUCCESS;
+}
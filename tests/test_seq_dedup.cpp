@@ -0,0 +1,332 @@
+#include "gateway/seq_dedup.hpp"
+#include "gateway/agent_limiter.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using gateway::DedupResult;
+
+// check(), then commit() if New: an event that is always delivered
+DedupResult observe(gateway::SeqDeduplicator& dedup, std::string_view id, std::uint32_t seq) {
+    const DedupResult r = dedup.check(id, seq);
+    if (r == DedupResult::New) {
+        dedup.commit(id, seq);
+    }
+    return r;
+}
+
+bool test_replay_dropped() {
+    gateway::SeqDeduplicator dedup;
+
+    if (observe(dedup, "agent-a", 1) != DedupResult::New) {
+        std::printf("First seq not New\n");
+        return false;
+    }
+    for (int i = 0; i < 10; ++i) {
+        if (observe(dedup, "agent-a", 1) != DedupResult::Duplicate) {
+            std::printf("Replay %d not dropped\n", i);
+            return false;
+        }
+    }
+    // Same seq from another agent is unrelated
+    if (observe(dedup, "agent-b", 1) != DedupResult::New) {
+        std::printf("Other agent's seq treated as replay\n");
+        return false;
+    }
+    if (dedup.duplicates() != 10 || dedup.tracked_agents() != 2) {
+        std::printf("Expected 10 duplicates / 2 agents, got %llu / %zu\n",
+                    static_cast<unsigned long long>(dedup.duplicates()), dedup.tracked_agents());
+        return false;
+    }
+    return true;
+}
+
+bool test_reordered_within_window() {
+    gateway::SeqDeduplicator dedup(gateway::DedupConfig{.max_agents = 16, .window = 128});
+
+    for (std::uint32_t seq : {10u, 12u, 11u, 100u, 13u, 137u}) {
+        if (observe(dedup, "agent", seq) != DedupResult::New) {
+            std::printf("Reordered seq %u not New\n", seq);
+            return false;
+        }
+    }
+    for (std::uint32_t seq : {10u, 11u, 12u, 13u, 100u, 137u}) {
+        if (observe(dedup, "agent", seq) != DedupResult::Duplicate) {
+            std::printf("Reordered replay %u not dropped\n", seq);
+            return false;
+        }
+    }
+    // Unseen seqs inside the window are still New
+    if (observe(dedup, "agent", 50) != DedupResult::New || dedup.seen("agent", 51)) {
+        std::printf("Gap in the window mishandled\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_window_slides() {
+    gateway::SeqDeduplicator dedup(gateway::DedupConfig{.max_agents = 16, .window = 128});
+
+    (void)observe(dedup, "agent", 5);
+    // seq 133 maps to the same bit as 5: sliding must clear it first
+    if (observe(dedup, "agent", 133) != DedupResult::New) {
+        std::printf("Slid seq sharing a bit not New\n");
+        return false;
+    }
+    if (dedup.seen("agent", 5)) {
+        std::printf("seq 5 still marked after leaving the window\n");
+        return false;
+    }
+    // A jump of more than a window clears everything
+    (void)observe(dedup, "agent", 130);
+    (void)observe(dedup, "agent", 100000);
+    if (dedup.seen("agent", 130) || dedup.seen("agent", 133) || !dedup.seen("agent", 100000)) {
+        std::printf("Large jump did not clear the window\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_agent_restart() {
+    gateway::SeqDeduplicator dedup(gateway::DedupConfig{.max_agents = 16, .window = 128});
+
+    for (std::uint32_t seq = 5000; seq < 5100; ++seq) {
+        (void)observe(dedup, "agent", seq);
+    }
+    // Counter reset far behind the window: tracked again from scratch
+    for (std::uint32_t seq = 0; seq < 10; ++seq) {
+        if (observe(dedup, "agent", seq) != DedupResult::New) {
+            std::printf("Restarted seq %u not New\n", seq);
+            return false;
+        }
+    }
+    if (dedup.resets() != 1) {
+        std::printf("Expected 1 reset, got %llu\n", static_cast<unsigned long long>(dedup.resets()));
+        return false;
+    }
+    if (observe(dedup, "agent", 3) != DedupResult::Duplicate) {
+        std::printf("Replay after restart not dropped\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_seq_wraparound() {
+    gateway::SeqDeduplicator dedup;
+
+    (void)observe(dedup, "agent", UINT32_MAX - 1);
+    (void)observe(dedup, "agent", UINT32_MAX);
+    // 0 follows UINT32_MAX: a step forward, not a restart
+    if (observe(dedup, "agent", 0) != DedupResult::New || dedup.resets() != 0) {
+        std::printf("Wraparound treated as restart\n");
+        return false;
+    }
+    if (observe(dedup, "agent", UINT32_MAX) != DedupResult::Duplicate ||
+        observe(dedup, "agent", UINT32_MAX - 1) != DedupResult::Duplicate) {
+        std::printf("Replay across wraparound not dropped\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_lru_eviction() {
+    gateway::SeqDeduplicator dedup(gateway::DedupConfig{.max_agents = 4, .window = 64});
+
+    for (int a = 0; a < 4; ++a) {
+        (void)observe(dedup, "agent-" + std::to_string(a), 1);
+    }
+    // Touch agent-0 so agent-1 is least recently seen
+    (void)observe(dedup, "agent-0", 2);
+    (void)observe(dedup, "agent-new", 1);
+
+    if (dedup.tracked_agents() != 4 || dedup.evictions() != 1) {
+        std::printf("Expected 4 tracked / 1 eviction, got %zu / %llu\n", dedup.tracked_agents(),
+                    static_cast<unsigned long long>(dedup.evictions()));
+        return false;
+    }
+    if (dedup.seen("agent-1", 1) || !dedup.seen("agent-0", 1) || !dedup.seen("agent-2", 1) ||
+        !dedup.seen("agent-new", 1)) {
+        std::printf("Wrong agent evicted\n");
+        return false;
+    }
+    // Invented ids churn the table but never grow it
+    for (int i = 0; i < 10000; ++i) {
+        (void)observe(dedup, "spoof-" + std::to_string(i), 7);
+    }
+    if (dedup.tracked_agents() != 4) {
+        std::printf("Table grew to %zu\n", dedup.tracked_agents());
+        return false;
+    }
+    return true;
+}
+
+bool test_check_is_read_only() {
+    gateway::SeqDeduplicator dedup(gateway::DedupConfig{.max_agents = 16, .window = 128});
+
+    // Probing alone records nothing, however often
+    for (int i = 0; i < 3; ++i) {
+        if (dedup.check("agent", 7) != DedupResult::New) {
+            std::printf("Uncommitted seq reported as Duplicate\n");
+            return false;
+        }
+    }
+    if (dedup.seen("agent", 7) || dedup.tracked_agents() != 0 || dedup.duplicates() != 0) {
+        std::printf("check() changed state\n");
+        return false;
+    }
+    dedup.commit("agent", 7);
+    dedup.commit("agent", 7);
+    if (dedup.check("agent", 7) != DedupResult::Duplicate || dedup.duplicates() != 1) {
+        std::printf("Committed seq not Duplicate\n");
+        return false;
+    }
+    return true;
+}
+
+bool test_retry_after_limiter_drop() {
+    // Pipeline order: probe, agent limiter, commit only on Allow
+    gateway::SeqDeduplicator dedup;
+    gateway::AgentLimiter limiter(gateway::AgentLimiterConfig{
+        .tokens_per_sec = 10, .burst_tokens = 4, .sketch_width = 64, .sketch_depth = 2,
+        .heavy_hitters = 4, .decay_ms = 100});
+    const auto t0 = std::chrono::steady_clock::time_point{} + std::chrono::hours(1);
+
+    auto deliver = [&](std::uint32_t seq, std::chrono::steady_clock::time_point now) {
+        if (dedup.check("agent", seq) == DedupResult::Duplicate) {
+            return false;
+        }
+        if (limiter.admit("agent", now) == gateway::Admit::Drop) {
+            return false;
+        }
+        dedup.commit("agent", seq);
+        return true;
+    };
+
+    std::uint32_t seq = 0;
+    while (deliver(seq, t0)) {
+        if (++seq > 100) {
+            std::printf("Limiter never dropped\n");
+            return false;
+        }
+    }
+    // The rate-limited seq is not remembered: its retry gets through once
+    // the agent has budget again, and only then becomes a duplicate
+    if (dedup.seen("agent", seq) || dedup.check("agent", seq) != DedupResult::New) {
+        std::printf("Rate-limited seq %u was recorded\n", seq);
+        return false;
+    }
+    const auto later = t0 + std::chrono::seconds(10);
+    if (!deliver(seq, later)) {
+        std::printf("Retry of rate-limited seq %u suppressed\n", seq);
+        return false;
+    }
+    if (deliver(seq, later) || dedup.duplicates() != 1) {
+        std::printf("Replay of delivered seq %u not dropped\n", seq);
+        return false;
+    }
+    return true;
+}
+
+// Reference: per agent, highest seq and the set of seen seqs in the window
+bool test_matches_reference() {
+    constexpr std::uint32_t kWindow = 256;
+    gateway::SeqDeduplicator dedup(gateway::DedupConfig{.max_agents = 64, .window = kWindow});
+
+    struct Model {
+        std::uint32_t highest = 0;
+        std::set<std::uint32_t> seen;
+    };
+    std::map<std::string, Model> model;
+    std::mt19937 rng(42);
+
+    for (int i = 0; i < 200000; ++i) {
+        const std::string id = "agent-" + std::to_string(rng() % 8);
+        auto& m = model[id];
+        const bool fresh = m.seen.empty();
+        // Mostly small steps back and forth, some jumps and restarts
+        std::uint32_t seq;
+        const std::uint32_t r = rng() % 100;
+        if (fresh) {
+            seq = rng() % 1000;
+        } else if (r < 80) {
+            seq = m.highest + static_cast<std::uint32_t>(static_cast<int>(rng() % 64) - 40);
+        } else if (r < 95) {
+            seq = m.highest + static_cast<std::uint32_t>(static_cast<int>(rng() % 600) - 300);
+        } else {
+            seq = rng() % 4;
+        }
+
+        // Apply the documented rules to the model
+        DedupResult expected = DedupResult::New;
+        const auto ahead = static_cast<std::int32_t>(seq - m.highest);
+        if (fresh || -static_cast<std::int64_t>(ahead) >= kWindow) {
+            m.seen.clear();
+            m.highest = seq;
+        } else if (ahead > 0) {
+            m.highest = seq;
+        }
+        std::erase_if(m.seen, [&](std::uint32_t s) { return m.highest - s >= kWindow; });
+        if (!m.seen.insert(seq).second) {
+            expected = DedupResult::Duplicate;
+        }
+
+        if (observe(dedup, id, seq) != expected) {
+            std::printf("Mismatch at step %d: %s seq %u\n", i, id.c_str(), seq);
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_replay_dropped()) {
+        std::printf("test_replay_dropped failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_reordered_within_window()) {
+        std::printf("test_reordered_within_window failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_window_slides()) {
+        std::printf("test_window_slides failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_agent_restart()) {
+        std::printf("test_agent_restart failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_seq_wraparound()) {
+        std::printf("test_seq_wraparound failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_lru_eviction()) {
+        std::printf("test_lru_eviction failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_check_is_read_only()) {
+        std::printf("test_check_is_read_only failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_retry_after_limiter_drop()) {
+        std::printf("test_retry_after_limiter_drop failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_matches_reference()) {
+        std::printf("test_matches_reference failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All seq_dedup tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,326 @@
+#include "gateway/serialize.hpp"
+
+#include "gateway/aggregate.hpp"
+#include "gateway/parse_metrics.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::string_view as_text(const std::array<std::byte, 1024>& buf, std::size_t n) {
+    return std::string_view(reinterpret_cast<const char*>(buf.data()), n);
+}
+
+// Serialize into a roomy buffer; empty string if it returned 0
+template <typename Event>
+std::string serialize(const Event& event) {
+    std::array<std::byte, 1024> buf{};
+    const std::size_t n = gateway::serialize_event(event, buf);
+    return std::string(as_text(buf, n));
+}
+
+bool expect_json(const std::string& got, std::string_view want) {
+    if (got != want) {
+        std::printf("Expected: %.*s\n     got: %s\n",
+                    static_cast<int>(want.size()), want.data(), got.c_str());
+        return false;
+    }
+    return true;
+}
+
+gateway::ValidatedMetrics make_metrics(const gateway::Metric* metrics, std::size_t count,
+                                       const gateway::MetricTag* tags) {
+    gateway::ValidatedMetrics v{};
+    v.agent_id = "agent-1";
+    v.seq = 7;
+    v.ts = 1700000000000;
+    v.metrics = metrics;
+    v.metric_count = count;
+    v.tags = tags;
+    return v;
+}
+
+bool test_metrics_canonical_form() {
+    const gateway::MetricTag tags[] = {{"host", "h1"}, {"dc", "eu"}};
+    const gateway::Metric metrics[] = {
+        {"cpu", 0.5, "pct", 0, 2},
+        {"mem", 1024, "", 2, 0},
+    };
+    const auto v = make_metrics(metrics, 2, tags);
+
+    return expect_json(serialize(v),
+        "{\"type\":\"metrics\",\"agent_id\":\"agent-1\",\"seq\":7,\"ts\":1700000000000,"
+        "\"metrics\":[{\"n\":\"cpu\",\"v\":0.5,\"u\":\"pct\",\"t\":{\"host\":\"h1\",\"dc\":\"eu\"}},"
+        "{\"n\":\"mem\",\"v\":1024}]}");
+}
+
+bool test_metrics_empty_array() {
+    const auto v = make_metrics(nullptr, 0, nullptr);
+    return expect_json(serialize(v),
+        "{\"type\":\"metrics\",\"agent_id\":\"agent-1\",\"seq\":7,\"ts\":1700000000000,"
+        "\"metrics\":[]}");
+}
+
+bool test_string_escapes() {
+    const std::string name = std::string("q\"b\\n\nr\rt\tb\bf\f") + '\x01' + '\x1f' + '\x7f' +
+                             "\xc3\xa9";
+    const gateway::Metric metrics[] = {{name, 1, "", 0, 0}};
+    const auto v = make_metrics(metrics, 1, nullptr);
+
+    return expect_json(serialize(v),
+        "{\"type\":\"metrics\",\"agent_id\":\"agent-1\",\"seq\":7,\"ts\":1700000000000,"
+        "\"metrics\":[{\"n\":\"q\\\"b\\\\n\\nr\\rt\\tb\\bf\\f\\u0001\\u001f\x7f\xc3\xa9\",\"v\":1}]}");
+}
+
+// JSON input is decoded by the parser, so escaped strings leave with the
+// same escapes they arrived with (not escaped twice)
+bool test_json_escapes_round_trip() {
+    const std::string body =
+        R"({"agent_id":"agent-1","seq":7,"ts":1700000000000,"metrics":[{"n":"disk \"root\"",)"
+        R"("v":1,"u":"\u00b5s","t":{"path":"C:\\tmp","q":"say \"hi\"","nl":"a\nb\u0001"}}]})";
+    auto parsed = std::make_unique<gateway::ParsedMetrics>();
+    if (gateway::parse_metrics(body, *parsed).has_value()) {
+        std::printf("Parse failed\n");
+        return false;
+    }
+    gateway::ValidatedMetrics v{};
+    v.agent_id = parsed->agent_id;
+    v.seq = parsed->seq;
+    v.ts = parsed->ts;
+    v.metrics = parsed->metrics.data();
+    v.metric_count = parsed->metric_count;
+    v.tags = parsed->tags.data();
+
+    return expect_json(serialize(v),
+        R"({"type":"metrics","agent_id":"agent-1","seq":7,"ts":1700000000000,)"
+        R"("metrics":[{"n":"disk \"root\"","v":1,"u":")" "\xc2\xb5" R"(s",)"
+        R"("t":{"path":"C:\\tmp","q":"say \"hi\"","nl":"a\nb\u0001"}}]})");
+}
+
+bool test_numbers_round_trip() {
+    const double values[] = {
+        0.0, -0.0, 0.1, -2.5, 1e300, -1e-300, 123456789.125,
+        std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max(),
+    };
+
+    for (double value : values) {
+        const gateway::Metric metrics[] = {{"m", value, "", 0, 0}};
+        const std::string json = serialize(make_metrics(metrics, 1, nullptr));
+
+        const std::size_t at = json.find("\"v\":");
+        const std::size_t stop = json.find('}', at);
+        if (at == std::string::npos || stop == std::string::npos) return false;
+        const std::string_view text = std::string_view(json).substr(at + 4, stop - at - 4);
+
+        double parsed = 0;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (ec != std::errc{} || ptr != text.data() + text.size() ||
+            parsed != value || std::signbit(parsed) != std::signbit(value)) {
+            std::printf("Value %.17g serialized as '%.*s'\n", value,
+                        static_cast<int>(text.size()), text.data());
+            return false;
+        }
+    }
+
+    // Non-finite values are not valid JSON numbers
+    const gateway::Metric special[] = {
+        {"nan", std::nan(""), "", 0, 0},
+        {"inf", -std::numeric_limits<double>::infinity(), "", 0, 0},
+    };
+    const std::string json = serialize(make_metrics(special, 2, nullptr));
+    return json.find("{\"n\":\"nan\",\"v\":null}") != std::string::npos &&
+           json.find("{\"n\":\"inf\",\"v\":null}") != std::string::npos;
+}
+
+bool test_log_canonical_form() {
+    const gateway::LogField fields[] = {
+        {"ts", "1700000000000"}, {"level", "error"}, {"msg", "disk full"},
+        {"agent", "a1"}, {"disk", "sda"}, {"path", "/var/\"log\""},
+    };
+    gateway::ValidatedLog v{};
+    v.agent_id = "a1";
+    v.ts = 1700000000000;
+    v.level = gateway::LogLevel::Error;
+    v.msg = "disk full";
+    v.fields = fields;
+    v.field_count = 6;
+
+    if (!expect_json(serialize(v),
+            "{\"type\":\"log\",\"agent_id\":\"a1\",\"ts\":1700000000000,\"level\":\"error\","
+            "\"msg\":\"disk full\",\"fields\":{\"disk\":\"sda\",\"path\":\"/var/\\\"log\\\"\"}}")) {
+        return false;
+    }
+
+    // No agent and no extra fields: both keys are omitted
+    v.agent_id = {};
+    v.level = gateway::LogLevel::Trace;
+    v.field_count = 3;
+    return expect_json(serialize(v),
+        "{\"type\":\"log\",\"ts\":1700000000000,\"level\":\"trace\",\"msg\":\"disk full\"}");
+}
+
+bool test_too_small_buffer_returns_zero() {
+    const gateway::MetricTag tags[] = {{"host", "h\"1"}};
+    const gateway::Metric metrics[] = {{"cpu\n", 0.123456789, "pct", 0, 1}};
+    const auto v = make_metrics(metrics, 1, tags);
+
+    std::array<std::byte, 1024> buf{};
+    const std::size_t full = gateway::serialize_event(v, buf);
+    if (full == 0) return false;
+
+    // Every shorter buffer fails cleanly; the exact size succeeds
+    for (std::size_t size = 0; size < full; ++size) {
+        std::array<std::byte, 1024> small{};
+        if (gateway::serialize_event(v, std::span(small.data(), size)) != 0) {
+            std::printf("Expected 0 for a %zu-byte buffer (needs %zu)\n", size, full);
+            return false;
+        }
+    }
+    std::array<std::byte, 1024> exact{};
+    if (gateway::serialize_event(v, std::span(exact.data(), full)) != full) return false;
+    return as_text(exact, full) == as_text(buf, full);
+}
+
+bool test_rollup_canonical_form() {
+    const gateway::MetricTag tags[] = {{"dc", "eu"}, {"host", "h1"}};
+    const gateway::RollupSeries series[] = {
+        {.name = "cpu", .unit = "pct", .tags = tags, .count = 3, .sum = 1.5, .min = 0.25, .max = 0.75},
+        {.name = "mem", .count = 1, .sum = 1024, .min = 1024, .max = 1024},
+    };
+    const gateway::RollupEvent rollup{.agent_id = "agent-1", .ts = 1700000000000,
+                                      .interval_ms = 1000, .series = series};
+
+    std::array<std::byte, 1024> buf{};
+    std::size_t written = 0;
+    const std::size_t n = gateway::serialize_rollup(rollup, buf, written);
+    if (written != 2) {
+        std::printf("Expected 2 series written, got %zu\n", written);
+        return false;
+    }
+    return expect_json(std::string(as_text(buf, n)),
+        "{\"type\":\"rollup\",\"agent_id\":\"agent-1\",\"ts\":1700000000000,\"interval_ms\":1000,"
+        "\"metrics\":[{\"n\":\"cpu\",\"u\":\"pct\",\"t\":{\"dc\":\"eu\",\"host\":\"h1\"},"
+        "\"count\":3,\"sum\":1.5,\"min\":0.25,\"max\":0.75},"
+        "{\"n\":\"mem\",\"count\":1,\"sum\":1024,\"min\":1024,\"max\":1024}]}");
+}
+
+bool test_rollup_quantiles() {
+    const gateway::RollupSeries series[] = {
+        {.name = "lat", .count = 2, .sum = 3, .min = 1, .max = 2, .p50 = 1, .p90 = 2, .p99 = 2},
+    };
+    const gateway::RollupEvent rollup{.agent_id = "a", .ts = 5, .interval_ms = 10,
+                                      .quantiles = true, .series = series};
+    std::array<std::byte, 1024> buf{};
+    std::size_t written = 0;
+    const std::size_t n = gateway::serialize_rollup(rollup, buf, written);
+    return expect_json(std::string(as_text(buf, n)),
+        "{\"type\":\"rollup\",\"agent_id\":\"a\",\"ts\":5,\"interval_ms\":10,"
+        "\"metrics\":[{\"n\":\"lat\",\"count\":2,\"sum\":3,\"min\":1,\"max\":2,"
+        "\"p50\":1,\"p90\":2,\"p99\":2}]}");
+}
+
+bool test_rollup_writes_prefix() {
+    std::array<gateway::RollupSeries, 40> series{};
+    std::array<std::string, 40> names;
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        names[i] = "metric.name." + std::to_string(i);
+        series[i] = {.name = names[i], .count = i + 1, .sum = 0.5, .min = 0.5, .max = 0.5};
+    }
+    const gateway::RollupEvent rollup{.agent_id = "agent-1", .ts = 1, .interval_ms = 1,
+                                      .series = series};
+
+    // All series need more than 1024 bytes: the buffer takes a prefix,
+    // which is a complete event on its own
+    std::array<std::byte, 1024> buf{};
+    std::size_t written = 0;
+    const std::size_t n = gateway::serialize_rollup(rollup, buf, written);
+    if (n == 0 || written == 0 || written >= series.size()) {
+        std::printf("Expected a strict prefix, got %zu series in %zu bytes\n", written, n);
+        return false;
+    }
+    const std::string_view text = as_text(buf, n);
+    if (!text.ends_with("}]}")) {
+        std::printf("Prefix not closed: %.*s\n", static_cast<int>(text.size()), text.data());
+        return false;
+    }
+
+    // The rest resumes where the prefix stopped
+    const gateway::RollupEvent rest{.agent_id = "agent-1", .ts = 1, .interval_ms = 1,
+                                    .series = std::span(series).subspan(written)};
+    std::size_t written2 = 0;
+    if (gateway::serialize_rollup(rest, buf, written2) == 0 || written + written2 > series.size()) {
+        return false;
+    }
+
+    // Too small for even one series
+    if (gateway::serialize_rollup(rollup, std::span(buf.data(), 60), written) != 0 || written != 0) {
+        std::printf("Expected 0 for a 60-byte buffer\n");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_metrics_canonical_form()) {
+        std::printf("test_metrics_canonical_form failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_metrics_empty_array()) {
+        std::printf("test_metrics_empty_array failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_string_escapes()) {
+        std::printf("test_string_escapes failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_json_escapes_round_trip()) {
+        std::printf("test_json_escapes_round_trip failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_numbers_round_trip()) {
+        std::printf("test_numbers_round_trip failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_log_canonical_form()) {
+        std::printf("test_log_canonical_form failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_too_small_buffer_returns_zero()) {
+        std::printf("test_too_small_buffer_returns_zero failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_rollup_canonical_form()) {
+        std::printf("test_rollup_canonical_form failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_rollup_quantiles()) {
+        std::printf("test_rollup_quantiles failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_rollup_writes_prefix()) {
+        std::printf("test_rollup_writes_prefix failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All serialize tests passed\n");
+    return EXIT_SUCCESS;
+}
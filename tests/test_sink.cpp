@@ -0,0 +1,388 @@
+#include "gateway/sink.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+std::span<const std::byte> bytes_of(const std::string& s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+// Pipe whose read end is non-blocking, so tests can read "whatever arrived"
+struct Pipe {
+    int fds[2] = {-1, -1};
+
+    Pipe() {
+        if (::pipe(fds) == 0) {
+            ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+        }
+    }
+    ~Pipe() {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    int write_fd() const { return fds[1]; }
+
+    std::string read_all() const {
+        std::string out;
+        char buf[4096];
+        ssize_t n;
+        while ((n = ::read(fds[0], buf, sizeof(buf))) > 0) {
+            out.append(buf, static_cast<std::size_t>(n));
+        }
+        return out;
+    }
+};
+
+// What the inner sink saw; outlives the sink so tests can inspect it
+// after the decorator (and its inner sink) are destroyed
+struct Recording {
+    std::vector<std::string> events;
+    std::vector<std::size_t> batch_sizes;
+    int flushes = 0;
+    bool fail = false;
+};
+
+// Inner sink that records each batch it receives
+class RecordingSink final : public gateway::Sink {
+public:
+    explicit RecordingSink(Recording& rec) : rec_(rec) {}
+
+    [[nodiscard]] bool write(std::span<const std::byte> payload) noexcept override {
+        rec_.events.emplace_back(reinterpret_cast<const char*>(payload.data()), payload.size());
+        rec_.batch_sizes.push_back(1);
+        return !rec_.fail;
+    }
+
+    [[nodiscard]] std::size_t write_batch(
+        std::span<const std::span<const std::byte>> payloads) noexcept override {
+        for (const auto& p : payloads) {
+            rec_.events.emplace_back(reinterpret_cast<const char*>(p.data()), p.size());
+        }
+        rec_.batch_sizes.push_back(payloads.size());
+        return rec_.fail ? 0 : payloads.size();
+    }
+
+    void flush() noexcept override { ++rec_.flushes; }
+
+private:
+    Recording& rec_;
+};
+
+gateway::BufferedSinkConfig lazy_config() {
+    // Thresholds high enough that only explicit flush() writes
+    gateway::BufferedSinkConfig config;
+    config.max_buffered_bytes = 4096;
+    config.max_buffered_events = 1000;
+    config.max_delay = std::chrono::hours(1);
+    return config;
+}
+
+// ============================================================================
+// BufferedFdSink Tests
+// ============================================================================
+
+bool test_fd_sink_coalesces_until_flush() {
+    Pipe pipe;
+    gateway::BufferedFdSink sink(pipe.write_fd(), lazy_config());
+
+    if (!sink.write(bytes_of("a"))) return false;
+    if (!sink.write(bytes_of("bb"))) return false;
+    if (!sink.write(bytes_of("ccc"))) return false;
+
+    // Nothing written yet
+    if (sink.syscall_count() != 0) return false;
+    if (sink.buffered_bytes() != 9) return false;
+    if (!pipe.read_all().empty()) return false;
+
+    sink.flush();
+    if (sink.syscall_count() != 1) {
+        std::printf("Expected one writev, got %lu\n",
+                    static_cast<unsigned long>(sink.syscall_count()));
+        return false;
+    }
+    if (pipe.read_all() != "a\nbb\nccc\n") return false;
+    if (sink.write_count() != 3) return false;
+
+    // Flushing an empty buffer is a no-op
+    sink.flush();
+    if (sink.syscall_count() != 1) return false;
+
+    return true;
+}
+
+bool test_fd_sink_event_threshold() {
+    Pipe pipe;
+    auto config = lazy_config();
+    config.max_buffered_events = 4;
+    gateway::BufferedFdSink sink(pipe.write_fd(), config);
+
+    for (int i = 0; i < 3; ++i) {
+        (void)sink.write(bytes_of("x"));
+    }
+    if (sink.syscall_count() != 0) return false;
+
+    (void)sink.write(bytes_of("y"));
+    if (sink.syscall_count() != 1) return false;
+    if (pipe.read_all() != "x\nx\nx\ny\n") return false;
+
+    return true;
+}
+
+bool test_fd_sink_time_threshold() {
+    Pipe pipe;
+    auto config = lazy_config();
+    config.max_delay = std::chrono::milliseconds(0);
+    gateway::BufferedFdSink sink(pipe.write_fd(), config);
+
+    // Zero delay: every write is already due
+    (void)sink.write(bytes_of("now"));
+    if (sink.syscall_count() != 1) return false;
+    if (pipe.read_all() != "now\n") return false;
+
+    return true;
+}
+
+bool test_fd_sink_write_through_on_overflow() {
+    Pipe pipe;
+    auto config = lazy_config();
+    config.max_buffered_bytes = 8;
+    gateway::BufferedFdSink sink(pipe.write_fd(), config);
+
+    (void)sink.write(bytes_of("ab"));  // buffered (3 bytes)
+
+    // Batch does not fit: buffered bytes + batch go out in one writev
+    const std::string big = "0123456789";
+    const std::string small = "z";
+    const std::span<const std::byte> batch[2] = {bytes_of(big), bytes_of(small)};
+    if (sink.write_batch(batch) != 2) return false;
+
+    if (sink.syscall_count() != 1) return false;
+    if (sink.buffered_bytes() != 0) return false;
+    if (pipe.read_all() != "ab\n0123456789\nz\n") return false;
+
+    return true;
+}
+
+bool test_fd_sink_iov_chunking() {
+    Pipe pipe;
+    auto config = lazy_config();
+    config.max_buffered_bytes = 1;
+    gateway::BufferedFdSink sink(pipe.write_fd(), config);
+
+    // 1500 events = 3000 iovecs -> split across several writev calls
+    const std::string one = "k";
+    std::vector<std::span<const std::byte>> batch(1500, bytes_of(one));
+    if (sink.write_batch(batch) != 1500) return false;
+
+    if (sink.syscall_count() < 3) return false;
+    const std::string out = pipe.read_all();
+    if (out.size() != 3000) {
+        std::printf("Expected 3000 bytes, got %zu\n", out.size());
+        return false;
+    }
+    for (std::size_t i = 0; i < out.size(); i += 2) {
+        if (out[i] != 'k' || out[i + 1] != '\n') return false;
+    }
+
+    return true;
+}
+
+bool test_fd_sink_error_counts_dropped() {
+    // Invalid fd: flush fails and the buffered events are counted as lost
+    gateway::BufferedFdSink sink(-1, lazy_config());
+
+    (void)sink.write(bytes_of("a"));
+    (void)sink.write(bytes_of("b"));
+    sink.flush();
+
+    if (sink.dropped_events() != 2) return false;
+    if (sink.buffered_bytes() != 0) return false;
+
+    return true;
+}
+
+bool test_fd_sink_destructor_flushes() {
+    Pipe pipe;
+    {
+        gateway::BufferedFdSink sink(pipe.write_fd(), lazy_config());
+        (void)sink.write(bytes_of("last"));
+    }
+    return pipe.read_all() == "last\n";
+}
+
+// ============================================================================
+// BufferedSink Tests
+// ============================================================================
+
+bool test_buffered_sink_coalesces() {
+    Recording rec;
+    auto inner = std::make_unique<RecordingSink>(rec);
+    auto config = lazy_config();
+    config.max_buffered_events = 3;
+    gateway::BufferedSink sink(std::move(inner), config);
+
+    for (int i = 0; i < 7; ++i) {
+        if (!sink.write(bytes_of(std::to_string(i)))) return false;
+    }
+
+    // Two full batches of 3 handed over, one event pending
+    if (rec.batch_sizes.size() != 2) return false;
+    if (rec.batch_sizes[0] != 3 || rec.batch_sizes[1] != 3) return false;
+    if (sink.buffered_events() != 1) return false;
+
+    sink.flush();
+    if (rec.events.size() != 7) return false;
+    for (int i = 0; i < 7; ++i) {
+        if (rec.events[static_cast<std::size_t>(i)] != std::to_string(i)) return false;
+    }
+    if (rec.flushes != 1) return false;
+    if (sink.batches_flushed() != 3) return false;
+
+    return true;
+}
+
+bool test_buffered_sink_copies_payloads() {
+    // Caller's buffer may be reused right after write returns
+    Recording rec;
+    auto inner = std::make_unique<RecordingSink>(rec);
+    gateway::BufferedSink sink(std::move(inner), lazy_config());
+
+    std::string scratch = "first";
+    (void)sink.write(bytes_of(scratch));
+    scratch = "XXXXX";
+    (void)sink.write(bytes_of(scratch));
+    sink.flush();
+
+    if (rec.events.size() != 2) return false;
+    if (rec.events[0] != "first" || rec.events[1] != "XXXXX") return false;
+
+    return true;
+}
+
+bool test_buffered_sink_oversize_passthrough() {
+    Recording rec;
+    auto inner = std::make_unique<RecordingSink>(rec);
+    auto config = lazy_config();
+    config.max_buffered_bytes = 4;
+    gateway::BufferedSink sink(std::move(inner), config);
+
+    (void)sink.write(bytes_of("ab"));
+    (void)sink.write(bytes_of("too-large"));  // flushes "ab" first, then direct
+
+    if (rec.events.size() != 2) return false;
+    if (rec.events[0] != "ab" || rec.events[1] != "too-large") return false;
+    if (sink.buffered_events() != 0) return false;
+
+    return true;
+}
+
+bool test_buffered_sink_inner_failure_counted() {
+    Recording rec;
+    rec.fail = true;
+    auto inner = std::make_unique<RecordingSink>(rec);
+    gateway::BufferedSink sink(std::move(inner), lazy_config());
+
+    // Accepted into the buffer...
+    if (!sink.write(bytes_of("a"))) return false;
+    if (!sink.write(bytes_of("b"))) return false;
+
+    // ...and lost on flush
+    sink.flush();
+    if (sink.dropped_events() != 2) return false;
+
+    return true;
+}
+
+bool test_buffered_sink_destructor_flushes() {
+    Recording rec;
+    {
+        gateway::BufferedSink sink(std::make_unique<RecordingSink>(rec), lazy_config());
+        (void)sink.write(bytes_of("pending"));
+        if (!rec.events.empty()) return false;
+    }
+
+    // Pending event handed to the inner sink before it was destroyed
+    if (rec.events.size() != 1 || rec.events[0] != "pending") return false;
+    if (rec.flushes != 1) return false;
+
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    // BufferedFdSink
+    if (!test_fd_sink_coalesces_until_flush()) {
+        std::printf("test_fd_sink_coalesces_until_flush failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_fd_sink_event_threshold()) {
+        std::printf("test_fd_sink_event_threshold failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_fd_sink_time_threshold()) {
+        std::printf("test_fd_sink_time_threshold failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_fd_sink_write_through_on_overflow()) {
+        std::printf("test_fd_sink_write_through_on_overflow failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_fd_sink_iov_chunking()) {
+        std::printf("test_fd_sink_iov_chunking failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_fd_sink_error_counts_dropped()) {
+        std::printf("test_fd_sink_error_counts_dropped failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_fd_sink_destructor_flushes()) {
+        std::printf("test_fd_sink_destructor_flushes failed\n");
+        return EXIT_FAILURE;
+    }
+
+    // BufferedSink
+    if (!test_buffered_sink_coalesces()) {
+        std::printf("test_buffered_sink_coalesces failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_buffered_sink_copies_payloads()) {
+        std::printf("test_buffered_sink_copies_payloads failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_buffered_sink_oversize_passthrough()) {
+        std::printf("test_buffered_sink_oversize_passthrough failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_buffered_sink_inner_failure_counted()) {
+        std::printf("test_buffered_sink_inner_failure_counted failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_buffered_sink_destructor_flushes()) {
+        std::printf("test_buffered_sink_destructor_flushes failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All sink tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,13 @@
 #include "gateway/source_limiter.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <unistd.h>
 
 namespace {
 
@@ -22,6 +27,7 @@ private:
         std::chrono::steady_clock::time_point{};
 };
 
+template <typename Limiter>
 bool test_single_source_rate_limited() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -29,7 +35,7 @@ bool test_single_source_rate_limited() {
         .tokens_per_sec = 100,
         .burst_tokens = 100  // no burst allowance beyond rate
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
     gateway::SourceKey src{.ip = 0x0A000001, .port = 12345};
 
     // First 100 should be allowed (initial burst)
@@ -49,6 +55,7 @@ bool test_single_source_rate_limited() {
     return true;
 }
 
+template <typename Limiter>
 bool test_budget_replenishes() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -56,7 +63,7 @@ bool test_budget_replenishes() {
         .tokens_per_sec = 100,
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
     gateway::SourceKey src{.ip = 0x0A000001, .port = 1};
 
     // Exhaust tokens
@@ -78,6 +85,7 @@ bool test_budget_replenishes() {
     return true;
 }
 
+template <typename Limiter>
 bool test_fair_share_across_sources() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -85,7 +93,7 @@ bool test_fair_share_across_sources() {
         .tokens_per_sec = 100,
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
 
     gateway::SourceKey src_a{.ip = 0x0A000001, .port = 1};
     gateway::SourceKey src_b{.ip = 0x0A000002, .port = 1};
@@ -103,6 +111,7 @@ bool test_fair_share_across_sources() {
     return true;
 }
 
+template <typename Limiter>
 bool test_lru_eviction() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -110,7 +119,7 @@ bool test_lru_eviction() {
         .tokens_per_sec = 100,
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
 
     gateway::SourceKey a{.ip = 1, .port = 1};
     gateway::SourceKey b{.ip = 2, .port = 1};
@@ -136,6 +145,7 @@ bool test_lru_eviction() {
     return true;
 }
 
+template <typename Limiter>
 bool test_lru_access_updates_position() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -143,7 +153,7 @@ bool test_lru_access_updates_position() {
         .tokens_per_sec = 100,
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
 
     gateway::SourceKey a{.ip = 1, .port = 1};
     gateway::SourceKey b{.ip = 2, .port = 1};
@@ -165,6 +175,7 @@ bool test_lru_access_updates_position() {
     return true;
 }
 
+template <typename Limiter>
 bool test_bounded_state_growth() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -172,7 +183,7 @@ bool test_bounded_state_growth() {
         .tokens_per_sec = 100,
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
 
     // Add 1000 unique sources
     for (std::uint32_t i = 0; i < 1000; ++i) {
@@ -195,6 +206,7 @@ bool test_bounded_state_growth() {
     return true;
 }
 
+template <typename Limiter>
 bool test_metrics() {
     FakeClock clock;
     gateway::SourceLimiterConfig config{
@@ -202,7 +214,7 @@ bool test_metrics() {
         .tokens_per_sec = 100,
         .burst_tokens = 5  // small burst for easy testing
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
     gateway::SourceKey src{.ip = 1, .port = 1};
 
     // 5 admits, 3 drops
@@ -222,6 +234,7 @@ bool test_metrics() {
     return true;
 }
 
+template <typename Limiter>
 bool test_clock_regression() {
     // Test that clock going backward doesn't crash or cause negative tokens
     FakeClock clock;
@@ -230,7 +243,7 @@ bool test_clock_regression() {
         .tokens_per_sec = 100,
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
     gateway::SourceKey src{.ip = 0x0A000001, .port = 1};
 
     // Advance clock forward
@@ -261,6 +274,7 @@ bool test_clock_regression() {
     return true;
 }
 
+template <typename Limiter>
 bool test_hash_collision_handling() {
     // Test that sources with different keys but potentially colliding hashes
     // are handled correctly (each gets independent token bucket)
@@ -270,7 +284,7 @@ bool test_hash_collision_handling() {
         .tokens_per_sec = 100,
         .burst_tokens = 5  // Small burst for quick testing
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
 
     // Create sources that might have hash collisions
     // The hash function combines ip and port: (ip << 16) | port
@@ -325,6 +339,7 @@ bool test_hash_collision_handling() {
     return true;
 }
 
+template <typename Limiter>
 bool test_fractional_token_accumulation() {
     // Test that fractional time advancement correctly accumulates tokens
     FakeClock clock;
@@ -333,7 +348,7 @@ bool test_fractional_token_accumulation() {
         .tokens_per_sec = 100,  // 1 token per 10ms
         .burst_tokens = 100
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
     gateway::SourceKey src{.ip = 1, .port = 1};
 
     // Exhaust all tokens
@@ -361,6 +376,7 @@ bool test_fractional_token_accumulation() {
     return true;
 }
 
+template <typename Limiter>
 bool test_boundary_source_keys() {
     // Test SourceKey boundary values
     FakeClock clock;
@@ -369,7 +385,7 @@ bool test_boundary_source_keys() {
         .tokens_per_sec = 100,
         .burst_tokens = 10
     };
-    gateway::SourceLimiter limiter(config, clock.as_clock());
+    Limiter limiter(config, clock.as_clock());
 
     // Test boundary values for IP and port
     gateway::SourceKey zero{.ip = 0, .port = 0};
@@ -397,61 +413,685 @@ bool test_boundary_source_keys() {
     return true;
 }
 
-}  // namespace
+// ============================================================================
+// FlatSourceLimiter-specific tests
+// ============================================================================
 
-int main() {
-    if (!test_single_source_rate_limited()) {
-        std::printf("test_single_source_rate_limited failed\n");
-        return EXIT_FAILURE;
+bool test_flat_explicit_timestamp() {
+    // admit(source, now) uses the given time and never calls the clock
+    int clock_calls = 0;
+    gateway::Clock counting_clock = [&clock_calls] {
+        ++clock_calls;
+        return std::chrono::steady_clock::time_point{};
+    };
+    gateway::SourceLimiterConfig config{
+        .max_sources = 4,
+        .tokens_per_sec = 10,
+        .burst_tokens = 1
+    };
+    gateway::FlatSourceLimiter limiter(config, counting_clock);
+    gateway::SourceKey src{.ip = 1, .port = 1};
+
+    std::chrono::steady_clock::time_point t{};
+    if (limiter.admit(src, t) != gateway::Admit::Allow) return false;
+    if (limiter.admit(src, t) != gateway::Admit::Drop) return false;
+    if (limiter.admit(src, t + std::chrono::milliseconds(100)) != gateway::Admit::Allow) return false;
+    if (clock_calls != 0) return false;
+
+    // admit(source) reads the clock exactly once per call
+    (void)limiter.admit(src);
+    if (clock_calls != 1) {
+        std::printf("Expected 1 clock read per admit, got %d\n", clock_calls);
+        return false;
+    }
+
+    return true;
+}
+
+bool test_flat_large_burst_no_overflow() {
+    // Max burst and rate with a long idle gap: refill must saturate, not wrap
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{
+        .max_sources = 2,
+        .tokens_per_sec = UINT32_MAX,
+        .burst_tokens = UINT32_MAX
+    };
+    gateway::FlatSourceLimiter limiter(config, clock.as_clock());
+    gateway::SourceKey src{.ip = 9, .port = 9};
+
+    if (limiter.admit(src) != gateway::Admit::Allow) return false;
+    clock.advance(std::chrono::hours(24 * 365));
+    if (limiter.admit(src) != gateway::Admit::Allow) return false;
+    clock.advance(std::chrono::nanoseconds(1));
+    if (limiter.admit(src) != gateway::Admit::Allow) return false;
+
+    return true;
+}
+
+bool test_flat_matches_reference_limiter() {
+    // Differential test: random trace over more sources than capacity.
+    // Time advances in whole 10ms steps so both token representations are
+    // exact and every decision must match.
+    FakeClock clock_a;
+    FakeClock clock_b;
+    gateway::SourceLimiterConfig config{
+        .max_sources = 32,
+        .tokens_per_sec = 100,
+        .burst_tokens = 3
+    };
+    gateway::SourceLimiter reference(config, clock_a.as_clock());
+    gateway::FlatSourceLimiter flat(config, clock_b.as_clock());
+
+    std::uint32_t rng = 7;
+    auto next = [&rng] {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 16;
+    };
+
+    for (int step = 0; step < 50000; ++step) {
+        if (next() % 8 == 0) {
+            const auto d = std::chrono::milliseconds(10 * (next() % 4));
+            clock_a.advance(d);
+            clock_b.advance(d);
+        }
+        gateway::SourceKey src{.ip = next() % 48, .port = static_cast<std::uint16_t>(next() % 2)};
+        if (reference.admit(src) != flat.admit(src)) {
+            std::printf("Decision mismatch at step %d\n", step);
+            return false;
+        }
+        if (reference.tracked_count() != flat.tracked_count()) return false;
+    }
+
+    if (reference.total_admits() != flat.total_admits()) return false;
+    if (reference.total_drops() != flat.total_drops()) return false;
+    if (reference.eviction_count() != flat.eviction_count()) return false;
+
+    // Same LRU contents
+    for (std::uint32_t ip = 0; ip < 48; ++ip) {
+        for (std::uint16_t port = 0; port < 2; ++port) {
+            gateway::SourceKey k{.ip = ip, .port = port};
+            if (reference.is_tracked(k) != flat.is_tracked(k)) return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Limiter>
+bool test_admit_batch_one_clock_read() {
+    FakeClock clock;
+    int clock_calls = 0;
+    gateway::SourceLimiterConfig config{
+        .max_sources = 8,
+        .tokens_per_sec = 10,
+        .burst_tokens = 10
+    };
+    Limiter limiter(config, [&] {
+        ++clock_calls;
+        return clock.now();
+    });
+
+    gateway::SourceKey sources[16];
+    for (std::size_t i = 0; i < 16; ++i) {
+        sources[i] = {.ip = static_cast<std::uint32_t>(i % 4), .port = 1};
+    }
+    gateway::Admit out[16];
+    const std::size_t allowed = limiter.admit_batch(sources, out);
+
+    if (clock_calls != 1) {
+        std::printf("Expected 1 clock read per batch, got %d\n", clock_calls);
+        return false;
+    }
+    if (allowed != 16) return false;
+
+    // Empty batch still reads the clock once and decides nothing
+    if (limiter.admit_batch({}, {}) != 0) return false;
+    if (clock_calls != 2) return false;
+
+    return true;
+}
+
+template <typename Limiter>
+bool test_admit_batch_flood_run() {
+    // One source fills most of the batch: its budget is spent in order,
+    // the rest of the run dropped, and other sources are unaffected
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{
+        .max_sources = 8,
+        .tokens_per_sec = 5,
+        .burst_tokens = 5
+    };
+    Limiter limiter(config, clock.as_clock());
+    const gateway::SourceKey flood{.ip = 0xDEAD, .port = 1};
+    const gateway::SourceKey quiet{.ip = 0xBEEF, .port = 2};
+
+    gateway::SourceKey sources[12];
+    for (auto& s : sources) s = flood;
+    sources[11] = quiet;
+
+    gateway::Admit out[12];
+    const std::size_t allowed = limiter.admit_batch(sources, out);
+    if (allowed != 6) {
+        std::printf("Expected 6 allowed, got %zu\n", allowed);
+        return false;
+    }
+    for (std::size_t i = 0; i < 11; ++i) {
+        const auto expected = i < 5 ? gateway::Admit::Allow : gateway::Admit::Drop;
+        if (out[i] != expected) {
+            std::printf("Flood decision mismatch at %zu\n", i);
+            return false;
+        }
+    }
+    if (out[11] != gateway::Admit::Allow) return false;
+
+    if (limiter.total_admits() != 6 || limiter.total_drops() != 6) return false;
+    if (limiter.tracked_count() != 2) return false;
+
+    return true;
+}
+
+bool test_flat_batch_matches_sequential() {
+    // Differential test: random batches (with runs and more sources than
+    // capacity) through admit_batch must match per-packet admit() on a
+    // reference limiter at the same instant, decision for decision
+    FakeClock clock_a;
+    FakeClock clock_b;
+    gateway::SourceLimiterConfig config{
+        .max_sources = 16,
+        .tokens_per_sec = 100,
+        .burst_tokens = 4
+    };
+    gateway::SourceLimiter reference(config, clock_a.as_clock());
+    gateway::FlatSourceLimiter flat(config, clock_b.as_clock());
+
+    std::uint32_t rng = 11;
+    auto next = [&rng] {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 16;
+    };
+
+    constexpr std::size_t kMaxBatch = 80;  // spans several prefetch chunks
+    gateway::SourceKey sources[kMaxBatch];
+    gateway::Admit out[kMaxBatch];
+
+    for (int round = 0; round < 2000; ++round) {
+        const auto d = std::chrono::milliseconds(10 * (next() % 3));
+        clock_a.advance(d);
+        clock_b.advance(d);
+
+        const std::size_t n = next() % (kMaxBatch + 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            // Half the time repeat the previous source to form runs
+            if (i > 0 && next() % 2 == 0) {
+                sources[i] = sources[i - 1];
+            } else {
+                sources[i] = {.ip = next() % 24, .port = static_cast<std::uint16_t>(next() % 2)};
+            }
+        }
+
+        const std::size_t allowed = flat.admit_batch(std::span(sources, n), out);
+        std::size_t expected_allowed = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto expected = reference.admit(sources[i]);
+            expected_allowed += expected == gateway::Admit::Allow;
+            if (out[i] != expected) {
+                std::printf("Batch mismatch at round %d index %zu\n", round, i);
+                return false;
+            }
+        }
+        if (allowed != expected_allowed) return false;
+        if (reference.tracked_count() != flat.tracked_count()) return false;
+    }
+
+    if (reference.total_admits() != flat.total_admits()) return false;
+    if (reference.total_drops() != flat.total_drops()) return false;
+    if (reference.eviction_count() != flat.eviction_count()) return false;
+
+    return true;
+}
+
+// Rate and burst changes apply to tracked sources without resetting them
+template <typename Limiter>
+bool test_reconfigure_keeps_buckets() {
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{.max_sources = 10, .tokens_per_sec = 10, .burst_tokens = 20};
+    Limiter limiter(config, clock.as_clock());
+    gateway::SourceKey a{.ip = 0x0A000001, .port = 1};
+    gateway::SourceKey b{.ip = 0x0A000002, .port = 2};
+
+    // a spends 15 of 20 tokens, b none
+    for (int i = 0; i < 15; ++i) {
+        (void)limiter.admit(a);
+    }
+    (void)limiter.admit(b);
+
+    // Lower the burst to 8: a keeps its 5 left, b is clamped to 8
+    config.burst_tokens = 8;
+    limiter.reconfigure(config);
+    if (limiter.tracked_count() != 2 || limiter.config().burst_tokens != 8) {
+        std::printf("Expected both sources kept after reconfigure\n");
+        return false;
+    }
+
+    int allowed_a = 0;
+    int allowed_b = 0;
+    for (int i = 0; i < 20; ++i) {
+        allowed_a += limiter.admit(a) == gateway::Admit::Allow;
+        allowed_b += limiter.admit(b) == gateway::Admit::Allow;
+    }
+    if (allowed_a != 5 || allowed_b != 8) {
+        std::printf("Expected 5 / 8 allowed after reconfigure, got %d / %d\n", allowed_a, allowed_b);
+        return false;
+    }
+
+    // New rate applies from here on: 100/s refills 5 tokens in 50ms
+    config.tokens_per_sec = 100;
+    limiter.reconfigure(config);
+    clock.advance(std::chrono::milliseconds(50));
+    int refilled = 0;
+    for (int i = 0; i < 10; ++i) {
+        refilled += limiter.admit(a) == gateway::Admit::Allow;
+    }
+    if (refilled != 5) {
+        std::printf("Expected 5 tokens at the new rate, got %d\n", refilled);
+        return false;
+    }
+    return true;
+}
+
+// Shrinking max_sources evicts least recently used sources only
+template <typename Limiter>
+bool test_reconfigure_shrink_evicts_lru() {
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{.max_sources = 8, .tokens_per_sec = 10, .burst_tokens = 10};
+    Limiter limiter(config, clock.as_clock());
+
+    // Touch sources 0..7 in order: 0 is least recently used
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        (void)limiter.admit(gateway::SourceKey{.ip = 0x0A000000 + i, .port = 1});
+    }
+
+    config.max_sources = 3;
+    limiter.reconfigure(config);
+    if (limiter.tracked_count() != 3 || limiter.eviction_count() != 5) {
+        std::printf("Expected 3 tracked / 5 evicted, got %zu / %llu\n", limiter.tracked_count(),
+                    static_cast<unsigned long long>(limiter.eviction_count()));
+        return false;
+    }
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        const bool tracked = limiter.is_tracked(gateway::SourceKey{.ip = 0x0A000000 + i, .port = 1});
+        if (tracked != (i >= 5)) {
+            std::printf("Source %u: tracked=%d after shrink\n", i, tracked);
+            return false;
+        }
+    }
+
+    // LRU order survives: a new source evicts 5, the oldest survivor
+    (void)limiter.admit(gateway::SourceKey{.ip = 0x0B000000, .port = 1});
+    if (limiter.is_tracked(gateway::SourceKey{.ip = 0x0A000005, .port = 1}) ||
+        !limiter.is_tracked(gateway::SourceKey{.ip = 0x0A000006, .port = 1})) {
+        std::printf("LRU order not kept across shrink\n");
+        return false;
+    }
+    return true;
+}
+
+// Growing max_sources keeps every tracked bucket and raises the bound
+template <typename Limiter>
+bool test_reconfigure_grow() {
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{.max_sources = 4, .tokens_per_sec = 1, .burst_tokens = 3};
+    Limiter limiter(config, clock.as_clock());
+
+    // Exhaust sources 0..3
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            (void)limiter.admit(gateway::SourceKey{.ip = 0x0A000000 + i, .port = 1});
+        }
+    }
+
+    config.max_sources = 64;
+    limiter.reconfigure(config);
+    for (std::uint32_t i = 4; i < 64; ++i) {
+        (void)limiter.admit(gateway::SourceKey{.ip = 0x0A000000 + i, .port = 1});
+    }
+    if (limiter.tracked_count() != 64 || limiter.eviction_count() != 0) {
+        std::printf("Expected 64 tracked and no evictions, got %zu / %llu\n", limiter.tracked_count(),
+                    static_cast<unsigned long long>(limiter.eviction_count()));
+        return false;
+    }
+    // Exhausted buckets are still exhausted (state not reset)
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        if (limiter.admit(gateway::SourceKey{.ip = 0x0A000000 + i, .port = 1}) != gateway::Admit::Drop) {
+            std::printf("Source %u bucket was reset by grow\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Snapshot file path unique to this test process
+std::string snapshot_path(const char* name) {
+    return std::string("/tmp/gateway_test_") + name + "_" + std::to_string(::getpid()) + ".snap";
+}
+
+gateway::SourceKey snap_key(std::uint32_t i) {
+    return gateway::SourceKey{.ip = 0x0A000000 + i, .port = static_cast<std::uint16_t>(1000 + i)};
+}
+
+// Exhausted buckets and LRU order survive save + restore
+bool test_flat_snapshot_round_trip() {
+    const std::string path = snapshot_path("round_trip");
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{.max_sources = 16, .tokens_per_sec = 1, .burst_tokens = 4};
+
+    gateway::FlatSourceLimiter before(config, clock.as_clock());
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        // Source i spends i tokens (sources 4+ are exhausted)
+        for (std::uint32_t k = 0; k < i; ++k) {
+            (void)before.admit(snap_key(i));
+        }
+        if (i == 0) (void)before.admit(snap_key(0));  // tracked, 3 tokens left
+    }
+    if (before.save_snapshot(path.c_str()) != gateway::SnapshotStatus::Ok) {
+        std::printf("save_snapshot failed\n");
+        return false;
+    }
+
+    FakeClock later;  // unrelated clock: ages are rebased, not copied
+    later.advance(std::chrono::hours(5));
+    gateway::FlatSourceLimiter after(config, later.as_clock());
+    if (after.restore_snapshot(path.c_str()) != gateway::SnapshotStatus::Ok ||
+        after.tracked_count() != 8) {
+        std::printf("restore_snapshot failed (tracked %zu)\n", after.tracked_count());
+        ::unlink(path.c_str());
+        return false;
+    }
+    ::unlink(path.c_str());
+
+    // No free burst for exhausted sources; partial buckets keep their tokens
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        const std::uint32_t left = i == 0 ? 3 : (i < 4 ? 4 - i : 0);
+        std::uint32_t allowed = 0;
+        for (int k = 0; k < 8; ++k) {
+            allowed += after.admit(snap_key(i)) == gateway::Admit::Allow;
+        }
+        if (allowed != left) {
+            std::printf("Source %u: expected %u tokens after restore, got %u\n", i, left, allowed);
+            return false;
+        }
+    }
+
+    // LRU order is the saved one: filling the table evicts source 0 first
+    // (touched first above), not the sources restored last
+    gateway::FlatSourceLimiter order(config, later.as_clock());
+    (void)before.save_snapshot(path.c_str());
+    (void)order.restore_snapshot(path.c_str());
+    ::unlink(path.c_str());
+    for (std::uint32_t i = 100; i < 109; ++i) {
+        (void)order.admit(snap_key(i));
+    }
+    if (order.is_tracked(snap_key(0)) || !order.is_tracked(snap_key(1))) {
+        std::printf("Restored LRU order not kept\n");
+        return false;
+    }
+    return true;
+}
+
+// Downtime counts as idle time: buckets refill for it
+bool test_flat_snapshot_refills_for_downtime() {
+    const std::string path = snapshot_path("downtime");
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{.max_sources = 4, .tokens_per_sec = 10, .burst_tokens = 10};
+    gateway::FlatSourceLimiter before(config, clock.as_clock());
+    for (int k = 0; k < 10; ++k) {
+        (void)before.admit(snap_key(0));
     }
+    if (before.save_snapshot(path.c_str()) != gateway::SnapshotStatus::Ok) {
+        std::printf("save_snapshot failed\n");
+        return false;
+    }
+
+    // Pretend the file was written 300ms ago: 3 tokens of refill
+    std::FILE* f = std::fopen(path.c_str(), "r+b");
+    gateway::LimiterSnapshotHeader header;
+    if (f == nullptr || std::fread(&header, sizeof(header), 1, f) != 1) {
+        std::printf("Failed to read snapshot header\n");
+        return false;
+    }
+    header.saved_wall_ns -= 300'000'000;
+    std::fseek(f, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, f);
+    std::fclose(f);
+
+    gateway::FlatSourceLimiter after(config, clock.as_clock());
+    const auto status = after.restore_snapshot(path.c_str());
+    ::unlink(path.c_str());
+    if (status != gateway::SnapshotStatus::Ok) {
+        std::printf("restore_snapshot failed\n");
+        return false;
+    }
+    int allowed = 0;
+    for (int k = 0; k < 10; ++k) {
+        allowed += after.admit(snap_key(0)) == gateway::Admit::Allow;
+    }
+    // >= 3 from the downtime, plus at most a token for the test's own runtime
+    if (allowed < 3 || allowed > 4) {
+        std::printf("Expected ~3 tokens refilled for downtime, got %d\n", allowed);
+        return false;
+    }
+    return true;
+}
 
-    if (!test_budget_replenishes()) {
-        std::printf("test_budget_replenishes failed\n");
+// Too many saved sources: the most recently used are kept
+bool test_flat_snapshot_into_smaller_table() {
+    const std::string path = snapshot_path("smaller");
+    FakeClock clock;
+    gateway::SourceLimiterConfig big{.max_sources = 32, .tokens_per_sec = 1, .burst_tokens = 1};
+    gateway::FlatSourceLimiter before(big, clock.as_clock());
+    for (std::uint32_t i = 0; i < 32; ++i) {
+        (void)before.admit(snap_key(i));
+    }
+    (void)before.save_snapshot(path.c_str());
+
+    gateway::SourceLimiterConfig small = big;
+    small.max_sources = 8;
+    gateway::FlatSourceLimiter after(small, clock.as_clock());
+    const auto status = after.restore_snapshot(path.c_str());
+    ::unlink(path.c_str());
+    if (status != gateway::SnapshotStatus::Ok || after.tracked_count() != 8) {
+        std::printf("Expected 8 sources restored, got %zu\n", after.tracked_count());
+        return false;
+    }
+    for (std::uint32_t i = 0; i < 32; ++i) {
+        if (after.is_tracked(snap_key(i)) != (i >= 24)) {
+            std::printf("Source %u: wrong tracked state after restore\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Missing or damaged files are reported and leave the limiter unchanged
+bool test_flat_snapshot_rejects_bad_files() {
+    const std::string path = snapshot_path("bad");
+    FakeClock clock;
+    gateway::SourceLimiterConfig config{.max_sources = 8, .tokens_per_sec = 1, .burst_tokens = 1};
+    gateway::FlatSourceLimiter limiter(config, clock.as_clock());
+    (void)limiter.admit(snap_key(1));
+
+    ::unlink(path.c_str());
+    if (limiter.restore_snapshot(path.c_str()) != gateway::SnapshotStatus::NotFound) {
+        std::printf("Expected NotFound for a missing file\n");
+        return false;
+    }
+
+    // Flip one byte of a record: checksum mismatch
+    gateway::FlatSourceLimiter other(config, clock.as_clock());
+    (void)other.admit(snap_key(2));
+    (void)other.save_snapshot(path.c_str());
+    std::FILE* f = std::fopen(path.c_str(), "r+b");
+    std::fseek(f, sizeof(gateway::LimiterSnapshotHeader) + 1, SEEK_SET);
+    std::fputc(0x5A, f);
+    std::fclose(f);
+    if (limiter.restore_snapshot(path.c_str()) != gateway::SnapshotStatus::BadFormat) {
+        std::printf("Expected BadFormat for a corrupted record\n");
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    // Truncated file
+    f = std::fopen(path.c_str(), "wb");
+    std::fputs("GATW", f);
+    std::fclose(f);
+    const auto truncated = limiter.restore_snapshot(path.c_str());
+    ::unlink(path.c_str());
+    if (truncated != gateway::SnapshotStatus::BadFormat) {
+        std::printf("Expected BadFormat for a truncated file\n");
+        return false;
+    }
+
+    if (limiter.tracked_count() != 1 || !limiter.is_tracked(snap_key(1))) {
+        std::printf("Failed restore modified the limiter\n");
+        return false;
+    }
+    return true;
+}
+
+// Run the shared semantic tests against one limiter implementation
+template <typename Limiter>
+bool run_shared_tests(const char* impl) {
+    if (!test_single_source_rate_limited<Limiter>()) {
+        std::printf("%s: test_single_source_rate_limited failed\n", impl);
+        return false;
+    }
+
+    if (!test_budget_replenishes<Limiter>()) {
+        std::printf("%s: test_budget_replenishes failed\n", impl);
+        return false;
+    }
+
+    if (!test_fair_share_across_sources<Limiter>()) {
+        std::printf("%s: test_fair_share_across_sources failed\n", impl);
+        return false;
+    }
+
+    if (!test_lru_eviction<Limiter>()) {
+        std::printf("%s: test_lru_eviction failed\n", impl);
+        return false;
+    }
+
+    if (!test_lru_access_updates_position<Limiter>()) {
+        std::printf("%s: test_lru_access_updates_position failed\n", impl);
+        return false;
+    }
+
+    if (!test_bounded_state_growth<Limiter>()) {
+        std::printf("%s: test_bounded_state_growth failed\n", impl);
+        return false;
+    }
+
+    if (!test_metrics<Limiter>()) {
+        std::printf("%s: test_metrics failed\n", impl);
+        return false;
+    }
+
+    if (!test_clock_regression<Limiter>()) {
+        std::printf("%s: test_clock_regression failed\n", impl);
+        return false;
+    }
+
+    if (!test_hash_collision_handling<Limiter>()) {
+        std::printf("%s: test_hash_collision_handling failed\n", impl);
+        return false;
+    }
+
+    if (!test_fractional_token_accumulation<Limiter>()) {
+        std::printf("%s: test_fractional_token_accumulation failed\n", impl);
+        return false;
+    }
+
+    if (!test_boundary_source_keys<Limiter>()) {
+        std::printf("%s: test_boundary_source_keys failed\n", impl);
+        return false;
+    }
+
+    if (!test_admit_batch_one_clock_read<Limiter>()) {
+        std::printf("%s: test_admit_batch_one_clock_read failed\n", impl);
+        return false;
+    }
+
+    if (!test_admit_batch_flood_run<Limiter>()) {
+        std::printf("%s: test_admit_batch_flood_run failed\n", impl);
+        return false;
+    }
+
+    if (!test_reconfigure_keeps_buckets<Limiter>()) {
+        std::printf("%s: test_reconfigure_keeps_buckets failed\n", impl);
+        return false;
+    }
+
+    if (!test_reconfigure_shrink_evicts_lru<Limiter>()) {
+        std::printf("%s: test_reconfigure_shrink_evicts_lru failed\n", impl);
+        return false;
+    }
+
+    if (!test_reconfigure_grow<Limiter>()) {
+        std::printf("%s: test_reconfigure_grow failed\n", impl);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!run_shared_tests<gateway::SourceLimiter>("SourceLimiter")) {
         return EXIT_FAILURE;
     }
 
-    if (!test_fair_share_across_sources()) {
-        std::printf("test_fair_share_across_sources failed\n");
+    if (!run_shared_tests<gateway::FlatSourceLimiter>("FlatSourceLimiter")) {
         return EXIT_FAILURE;
     }
 
-    if (!test_lru_eviction()) {
-        std::printf("test_lru_eviction failed\n");
+    if (!test_flat_explicit_timestamp()) {
+        std::printf("test_flat_explicit_timestamp failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_lru_access_updates_position()) {
-        std::printf("test_lru_access_updates_position failed\n");
+    if (!test_flat_large_burst_no_overflow()) {
+        std::printf("test_flat_large_burst_no_overflow failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_bounded_state_growth()) {
-        std::printf("test_bounded_state_growth failed\n");
+    if (!test_flat_matches_reference_limiter()) {
+        std::printf("test_flat_matches_reference_limiter failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_metrics()) {
-        std::printf("test_metrics failed\n");
+    if (!test_flat_batch_matches_sequential()) {
+        std::printf("test_flat_batch_matches_sequential failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_clock_regression()) {
-        std::printf("test_clock_regression failed\n");
+    if (!test_flat_snapshot_round_trip()) {
+        std::printf("test_flat_snapshot_round_trip failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_hash_collision_handling()) {
-        std::printf("test_hash_collision_handling failed\n");
+    if (!test_flat_snapshot_refills_for_downtime()) {
+        std::printf("test_flat_snapshot_refills_for_downtime failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_fractional_token_accumulation()) {
-        std::printf("test_fractional_token_accumulation failed\n");
+    if (!test_flat_snapshot_into_smaller_table()) {
+        std::printf("test_flat_snapshot_into_smaller_table failed\n");
         return EXIT_FAILURE;
     }
 
-    if (!test_boundary_source_keys()) {
-        std::printf("test_boundary_source_keys failed\n");
+    if (!test_flat_snapshot_rejects_bad_files()) {
+        std::printf("test_flat_snapshot_rejects_bad_files failed\n");
         return EXIT_FAILURE;
     }
 
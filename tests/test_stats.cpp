@@ -0,0 +1,262 @@
+#include "gateway/stats.hpp"
+#include "gateway/sink.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool test_blocks_are_padded() {
+    gateway::StatsRegistry registry(2);
+    gateway::PipelineStats* a = registry.register_thread();
+    gateway::PipelineStats* b = registry.register_thread();
+    if (a == nullptr || b == nullptr || a == b) return false;
+
+    // Separate writers never share a cache line
+    const auto addr_a = reinterpret_cast<std::uintptr_t>(a);
+    const auto addr_b = reinterpret_cast<std::uintptr_t>(b);
+    if (addr_a % gateway::kCacheLineBytes != 0 || addr_b % gateway::kCacheLineBytes != 0) return false;
+    const auto sink_group = reinterpret_cast<std::uintptr_t>(&a->queue);
+    const auto ingest_end = reinterpret_cast<std::uintptr_t>(&a->validate + 1);
+    return sink_group % gateway::kCacheLineBytes == 0 && sink_group >= ingest_end;
+}
+
+bool test_registry_capacity() {
+    gateway::StatsRegistry registry(1);
+    if (registry.register_thread() == nullptr) return false;
+    if (registry.register_thread() != nullptr) {
+        std::printf("Expected a full registry to refuse\n");
+        return false;
+    }
+    return registry.registered() == 1 && registry.capacity() == 1;
+}
+
+bool test_registry_slots() {
+    gateway::StatsRegistry registry(3);
+
+    // A worker claims its own block from its own thread
+    gateway::PipelineStats* claimed = nullptr;
+    std::thread worker([&] {
+        claimed = registry.register_thread(1);
+        if (claimed != nullptr) {
+            claimed->received.add(5);
+        }
+    });
+    worker.join();
+    if (claimed == nullptr || registry.register_thread(1) != nullptr ||
+        registry.register_thread(3) != nullptr) {
+        std::printf("Slot claim not exclusive\n");
+        return false;
+    }
+    // Unnumbered registration takes the free slots around it
+    gateway::PipelineStats* first = registry.register_thread();
+    gateway::PipelineStats* second = registry.register_thread();
+    if (first == nullptr || second == nullptr || first == claimed || second == claimed ||
+        registry.register_thread() != nullptr || registry.registered() != 3) {
+        std::printf("Free slots not handed out\n");
+        return false;
+    }
+    first->received.add();
+    return registry.snapshot(1).received == 5 && registry.snapshot(0).received == 1 &&
+           registry.snapshot(7).received == 0 && registry.snapshot().received == 6;
+}
+
+bool test_enum_counters() {
+    gateway::StatsRegistry registry(1);
+    gateway::PipelineStats& stats = *registry.register_thread();
+
+    stats.envelope.add(gateway::DropReason::LengthMismatch);
+    stats.envelope.add(gateway::DropReason::LengthMismatch);
+    stats.metrics_parse.add(gateway::MetricsDropReason::BinaryMalformed);
+    stats.log_validation.add(gateway::LogValidationDrop::MessageEmpty);
+    stats.forward.add(gateway::ForwardResult::Queued);
+    stats.forward.add(gateway::ForwardResult::DroppedQueueFull);
+
+    if (stats.envelope.count(gateway::DropReason::LengthMismatch) != 2) return false;
+    if (stats.envelope.count(gateway::DropReason::TrailingJunk) != 0) return false;
+
+    const auto s = registry.snapshot();
+    return gateway::total(s.envelope) == 2 &&
+           s.metrics_parse[static_cast<std::size_t>(gateway::MetricsDropReason::BinaryMalformed)] == 1 &&
+           s.log_validation[static_cast<std::size_t>(gateway::LogValidationDrop::MessageEmpty)] == 1 &&
+           gateway::total(s.forward) == 2;
+}
+
+bool test_metrics_drop_reason_numbers() {
+    // Counters are indexed by enum value, so dashboards key on these
+    // numbers: new reasons are appended, existing ones never move
+    using R = gateway::MetricsDropReason;
+    constexpr std::pair<R, std::size_t> kPinned[] = {
+        {R::InputTooLarge, 0},         {R::InvalidJson, 1},
+        {R::NestingTooDeep, 2},        {R::MissingRequiredField, 3},
+        {R::AgentIdTooLong, 4},        {R::AgentIdInvalidChars, 5},
+        {R::TooManyMetrics, 6},        {R::MetricNameTooLong, 7},
+        {R::MetricMissingName, 8},     {R::MetricMissingValue, 9},
+        {R::MetricValueNotNumber, 10}, {R::UnitTooLong, 11},
+        {R::TooManyTags, 12},          {R::TagKeyTooLong, 13},
+        {R::TagValueTooLong, 14},      {R::UnexpectedField, 15},
+        {R::InvalidFieldType, 16},     {R::BinaryUnsupportedVersion, 17},
+        {R::BinaryTruncated, 18},      {R::BinaryMalformed, 19},
+        {R::DuplicateField, 20},
+    };
+    for (const auto& [reason, number] : kPinned) {
+        if (static_cast<std::size_t>(reason) != number) {
+            std::printf("MetricsDropReason %zu moved to %zu\n", number,
+                        static_cast<std::size_t>(reason));
+            return false;
+        }
+    }
+    return std::size(kPinned) == gateway::kEnumCount<R>;
+}
+
+bool test_snapshot_merges_threads() {
+    constexpr int kThreads = 4;
+    constexpr std::uint64_t kPackets = 100000;
+    gateway::StatsRegistry registry(kThreads);
+    std::atomic<int> running{kThreads};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&registry, &running, t] {
+            gateway::PipelineStats& stats = *registry.register_thread();
+            for (std::uint64_t i = 0; i < kPackets; ++i) {
+                stats.received.add();
+                if (i % 10 == 0) {
+                    stats.prefilter.add(gateway::PrefilterDrop::Malformed);
+                }
+                stats.parse.record(100 + static_cast<std::uint64_t>(t));
+            }
+            stats.queue_depth.set(static_cast<std::uint64_t>(t));
+            --running;
+        });
+    }
+
+    // Snapshots taken mid-run stay within bounds and never go backwards
+    bool ok = true;
+    std::uint64_t last = 0;
+    while (running.load() > 0) {
+        const auto s = registry.snapshot();
+        if (s.received < last || s.received > kThreads * kPackets) ok = false;
+        last = s.received;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const auto s = registry.snapshot();
+    if (!ok || s.received != kThreads * kPackets) return false;
+    if (gateway::total(s.prefilter) != kThreads * kPackets / 10) return false;
+    if (s.parse.count() != kThreads * kPackets || s.parse.max != 100 + kThreads - 1) return false;
+    // Gauges sum across workers
+    return s.queue_depth == 0 + 1 + 2 + 3 && registry.snapshot(3).received == kPackets;
+}
+
+bool test_forwarder_latency_histograms() {
+    gateway::StatsRegistry registry(1);
+    gateway::PipelineStats& stats = *registry.register_thread();
+
+    gateway::ForwarderConfig config;
+    config.queue_latency = &stats.queue;
+    config.sink_write_latency = &stats.sink_write;
+    config.latency_sample_shift = 2;  // one event in 4
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    static const std::byte kPayload[] = {std::byte{'x'}};
+    for (int i = 0; i < 64; ++i) {
+        gateway::QueuedEvent event;
+        event.agent_id = "agent";
+        event.type = gateway::EventType::Metrics;
+        event.payload = kPayload;
+        if (forwarder.try_forward(event) != gateway::ForwardResult::Queued) return false;
+        (void)forwarder.drain_one();
+    }
+
+    const auto s = registry.snapshot();
+    if (s.queue.count() != 16 || s.sink_write.count() != 16) {
+        std::printf("Expected 16 sampled events, got %llu / %llu\n",
+                    static_cast<unsigned long long>(s.queue.count()),
+                    static_cast<unsigned long long>(s.sink_write.count()));
+        return false;
+    }
+    return true;
+}
+
+bool test_async_forwarder_latency_histograms() {
+    gateway::StatsRegistry registry(1);
+    gateway::PipelineStats& stats = *registry.register_thread();
+
+    gateway::ForwarderConfig config;
+    config.async_sink = true;
+    config.max_per_agent = 256;
+    config.queue_latency = &stats.queue;
+    config.sink_write_latency = &stats.sink_write;
+    config.latency_sample_shift = 0;  // every event
+    gateway::BoundedForwarder forwarder(config, std::make_unique<gateway::NullSink>());
+
+    static const std::byte kPayload[] = {std::byte{'x'}};
+    for (int i = 0; i < 200; ++i) {
+        gateway::QueuedEvent event;
+        event.agent_id = "agent";
+        event.type = gateway::EventType::Metrics;
+        event.payload = kPayload;
+        if (forwarder.try_forward(event) != gateway::ForwardResult::Queued) return false;
+    }
+    forwarder.drain_all();
+
+    // Every event's queueing time; one sink duration per batch
+    const auto s = registry.snapshot();
+    return s.queue.count() == 200 && s.sink_write.count() == forwarder.total_sink_batches();
+}
+
+}  // namespace
+
+int main() {
+    if (!test_blocks_are_padded()) {
+        std::printf("test_blocks_are_padded failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_registry_capacity()) {
+        std::printf("test_registry_capacity failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_registry_slots()) {
+        std::printf("test_registry_slots failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_enum_counters()) {
+        std::printf("test_enum_counters failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_metrics_drop_reason_numbers()) {
+        std::printf("test_metrics_drop_reason_numbers failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_snapshot_merges_threads()) {
+        std::printf("test_snapshot_merges_threads failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_forwarder_latency_histograms()) {
+        std::printf("test_forwarder_latency_histograms failed\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!test_async_forwarder_latency_histograms()) {
+        std::printf("test_async_forwarder_latency_histograms failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All stats tests passed\n");
+    return EXIT_SUCCESS;
+}
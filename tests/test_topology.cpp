@@ -0,0 +1,319 @@
+#include "gateway/topology.hpp"
+
+#include "gateway/recv_loop.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Fake sysfs/procfs tree under /tmp, removed on destruction
+class FakeTree {
+public:
+    explicit FakeTree(const char* name)
+        : root_(std::string("/tmp/gateway_test_") + name + "_" + std::to_string(::getpid())) {
+        remove_all();
+        ::mkdir(root_.c_str(), 0700);
+    }
+    ~FakeTree() { remove_all(); }
+
+    const std::string& root() const noexcept { return root_; }
+
+    // Write `content` to root/path, creating directories on the way
+    void file(const std::string& path, const std::string& content) {
+        dir(path.substr(0, path.rfind('/')));
+        std::FILE* f = std::fopen((root_ + "/" + path).c_str(), "w");
+        if (f != nullptr) {
+            std::fputs(content.c_str(), f);
+            std::fclose(f);
+        }
+    }
+
+    void dir(const std::string& path) {
+        for (std::size_t at = path.find('/'); ; at = path.find('/', at + 1)) {
+            ::mkdir((root_ + "/" + path.substr(0, at)).c_str(), 0700);
+            if (at == std::string::npos) {
+                break;
+            }
+        }
+    }
+
+private:
+    void remove_all() {
+        const std::string cmd = "rm -rf '" + root_ + "'";
+        (void)std::system(cmd.c_str());
+    }
+
+    std::string root_;
+};
+
+bool expect_cpus(const std::vector<int>& got, const std::vector<int>& want, const char* what) {
+    if (got != want) {
+        std::printf("%s: got", what);
+        for (int c : got) std::printf(" %d", c);
+        std::printf(", want");
+        for (int c : want) std::printf(" %d", c);
+        std::printf("\n");
+        return false;
+    }
+    return true;
+}
+
+// node 0: CPUs 0-3, node 1: CPUs 4-7
+gateway::CpuTopology two_nodes() {
+    gateway::CpuTopology t;
+    t.node_of_cpu = {0, 0, 0, 0, 1, 1, 1, 1};
+    t.node_cpus = {{0, 1, 2, 3}, {4, 5, 6, 7}};
+    return t;
+}
+
+bool test_parse_cpu_list() {
+    const auto list = gateway::parse_cpu_list("0-3,8,10-11\n");
+    if (!list || !expect_cpus(*list, {0, 1, 2, 3, 8, 10, 11}, "ranges")) {
+        return false;
+    }
+    const auto dup = gateway::parse_cpu_list("2,1,2");
+    const auto empty = gateway::parse_cpu_list("\n");
+    if (!dup || !expect_cpus(*dup, {1, 2}, "duplicates") || !empty || !empty->empty()) {
+        return false;
+    }
+    for (const char* bad : {"3-1", "a", "1,", "1-", "-1", "0-70000", "1,,2", "1 2"}) {
+        if (gateway::parse_cpu_list(bad)) {
+            std::printf("Accepted malformed list '%s'\n", bad);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_load_cpu_topology() {
+    FakeTree tree("topology_nodes");
+    tree.file("devices/system/node/node0/cpulist", "0-3\n");
+    tree.file("devices/system/node/node1/cpulist", "4-7\n");
+    tree.file("devices/system/node/has_cpu", "0-1\n");
+    tree.file("devices/system/cpu/online", "0-7\n");
+
+    const auto t = gateway::load_cpu_topology(tree.root());
+    if (t.node_count() != 2 || t.node_of(2) != 0 || t.node_of(5) != 1 || t.node_of(8) != -1 ||
+        t.node_of(-1) != -1 || !expect_cpus(t.node_cpus[1], {4, 5, 6, 7}, "node 1")) {
+        std::printf("Wrong two-node topology (%zu nodes)\n", t.node_count());
+        return false;
+    }
+
+    // No NUMA: the online CPUs form node 0
+    FakeTree flat("topology_flat");
+    flat.file("devices/system/cpu/online", "0-1\n");
+    const auto f = gateway::load_cpu_topology(flat.root());
+    if (f.node_count() != 1 || !expect_cpus(f.node_cpus[0], {0, 1}, "flat")) {
+        return false;
+    }
+    // Nothing readable: empty, not an error
+    return gateway::load_cpu_topology("/nonexistent").node_count() == 0;
+}
+
+bool test_load_nic_topology() {
+    FakeTree tree("topology_nic");
+    tree.file("sys/class/net/eth9/device/numa_node", "1\n");
+    tree.file("sys/class/net/eth9/device/msi_irqs/50", "msix\n");
+    tree.file("sys/class/net/eth9/device/msi_irqs/51", "msix\n");
+    tree.file("sys/class/net/eth9/device/msi_irqs/52", "msix\n");
+    tree.file("proc/interrupts",
+              "            CPU0       CPU1\n"
+              "  50:         10         20  PCI-MSIX-0000:3b:00.0   1-edge      mlx5_comp1@pci:0000:3b:00.0\n"
+              "  51:         10         20  PCI-MSIX-0000:3b:00.0   0-edge      mlx5_comp0@pci:0000:3b:00.0\n"
+              "  52:          1          0  PCI-MSIX-0000:3b:00.0   2-edge      mlx5_async0@pci:0000:3b:00.0\n"
+              "  60:          5          5  PCI-MSIX-0000:5e:00.0   0-edge      eth9-TxRx-2\n"
+              "  61:          5          5  PCI-MSIX-0000:5e:00.0   1-edge      eth9-tx-3\n"
+              "  62:          5          5  PCI-MSIX-0000:5e:00.0   2-edge      eth90-TxRx-0\n"
+              " NMI:          0          0   Non-maskable interrupts\n");
+    tree.file("proc/irq/50/effective_affinity_list", "5\n");
+    tree.file("proc/irq/50/smp_affinity_list", "0-7\n");
+    tree.file("proc/irq/51/smp_affinity_list", "4\n");
+    tree.file("proc/irq/60/effective_affinity_list", "2\n");
+
+    const auto cpus = two_nodes();
+    const auto nic = gateway::load_nic_topology("eth9", cpus, tree.root() + "/sys", tree.root() + "/proc");
+    if (nic.node != 1 || nic.rx_queues.size() != 3) {
+        std::printf("Expected node 1 / 3 RX queues, got %d / %zu\n", nic.node, nic.rx_queues.size());
+        return false;
+    }
+    const struct {
+        int queue;
+        int irq;
+        int cpu;
+        int node;
+    } want[] = {{0, 51, 4, 1}, {1, 50, 5, 1}, {2, 60, 2, 0}};
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto& q = nic.rx_queues[i];
+        if (q.queue != want[i].queue || q.irq != want[i].irq || q.cpus != std::vector<int>{want[i].cpu} ||
+            q.node != want[i].node) {
+            std::printf("RX queue %zu: queue %d irq %d node %d\n", i, q.queue, q.irq, q.node);
+            return false;
+        }
+    }
+
+    // Unknown interface: no node, no queues
+    const auto none = gateway::load_nic_topology("eth7", cpus, tree.root() + "/sys", tree.root() + "/proc");
+    return none.node == -1 && none.rx_queues.empty();
+}
+
+bool test_plan_worker_cpus() {
+    const auto t = two_nodes();
+
+    // RX queue CPUs first, then the NIC's node, then the other node;
+    // offline and repeated CPUs are skipped
+    const std::vector<int> rx_cpus = {5, 99, 4, 5};
+    if (!expect_cpus(gateway::plan_worker_cpus(t, 4, rx_cpus, 1), {5, 4, 6, 7}, "rx first") ||
+        !expect_cpus(gateway::plan_worker_cpus(t, 6, rx_cpus, 1), {5, 4, 6, 7, 0, 1}, "spill") ||
+        !expect_cpus(gateway::plan_worker_cpus(t, 3), {0, 1, 2}, "no preference")) {
+        return false;
+    }
+    // More workers than CPUs: wraps
+    const auto wide = gateway::plan_worker_cpus(t, 10);
+    if (wide.size() != 10 || wide[8] != 0 || wide[9] != 1) {
+        std::printf("Plan did not wrap\n");
+        return false;
+    }
+    if (!gateway::plan_worker_cpus(gateway::CpuTopology{}, 4).empty()) {
+        return false;
+    }
+
+    // Sink thread CPUs: the worker's node without the worker's CPU
+    gateway::CpuTopology lonely = t;
+    lonely.node_cpus.push_back({8});
+    lonely.node_of_cpu.push_back(2);
+    return expect_cpus(gateway::node_cpus_for(t, 5), {4, 6, 7}, "sink cpus") &&
+           expect_cpus(gateway::node_cpus_for(lonely, 8), {8}, "lone cpu") &&
+           gateway::node_cpus_for(t, 42).empty();
+}
+
+bool test_map_rx_queues() {
+    const auto t = two_nodes();
+    gateway::NicTopology nic;
+    nic.rx_queues = {
+        {0, 40, {4}, 1},     // worker 1 on CPU 4
+        {1, 41, {2, 3}, 0},  // no worker on 2 or 3, but worker 2 is on node 0
+        {2, 42, {6}, 1},     // no worker on 6: first node-1 worker
+        {3, 43, {}, -1},     // unknown affinity
+    };
+    const std::vector<int> workers = {5, 4, 0};
+    const auto map = gateway::map_rx_queues(nic, t, workers);
+    if (map.size() != 4 || map[0].worker != 1 || !map[0].same_cpu || map[1].worker != 2 ||
+        map[1].same_cpu || map[2].worker != 0 || map[2].same_cpu || map[3].worker != -1) {
+        std::printf("Wrong RX queue placement\n");
+        return false;
+    }
+    // Workers all on node 0: node-1 queues have no local worker
+    const std::vector<int> node0 = {0, 1};
+    const auto cross = gateway::map_rx_queues(nic, t, node0);
+    return cross[0].worker == -1 && cross[2].worker == -1 && cross[1].worker == 0;
+}
+
+bool test_pin_to_cpus() {
+    if (gateway::pin_current_thread_to_cpus({})) {
+        std::printf("Pinned to an empty set\n");
+        return false;
+    }
+    const int cpu = sched_getcpu();
+    const std::vector<int> self = {cpu};
+    if (cpu >= 0 && !gateway::pin_current_thread_to_cpus(self)) {
+        std::printf("Could not pin to current CPU %d\n", cpu);
+        return false;
+    }
+    // Best effort by contract (the kernel may lack NUMA support)
+    (void)gateway::set_local_memory_policy();
+    return true;
+}
+
+// Loopback datagrams are received on the sending CPU, so a thread pinned
+// to one CPU sees all its datagrams steered to that CPU's socket
+bool test_reuseport_cpu_steering() {
+    const int cpu = sched_getcpu();
+    const std::vector<int> self = {cpu};
+    if (cpu < 0 || !gateway::pin_current_thread_to_cpus(self)) {
+        std::printf("  (skipped: cannot pin)\n");
+        return true;
+    }
+    auto fds = gateway::create_reuseport_sockets(0, 2);
+    if (fds.size() != 2) {
+        return false;
+    }
+    // Socket 0 for a CPU we are not on, socket 1 for ours
+    const std::vector<int> worker_cpus = {cpu + 1, cpu};
+    if (!gateway::attach_reuseport_cpu_steering(fds[0], worker_cpus)) {
+        std::printf("  (skipped: SO_ATTACH_REUSEPORT_CBPF unsupported)\n");
+        for (int fd : fds) ::close(fd);
+        return true;
+    }
+
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fds[0], reinterpret_cast<sockaddr*>(&addr), &len);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const int tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+    constexpr int kDatagrams = 20;
+    for (int i = 0; i < kDatagrams; ++i) {
+        const char byte = static_cast<char>(i);
+        (void)::sendto(tx, &byte, 1, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    }
+    ::close(tx);
+
+    int counts[2] = {0, 0};
+    for (int s = 0; s < 2; ++s) {
+        char byte;
+        while (::recv(fds[s], &byte, 1, MSG_DONTWAIT) == 1) {
+            ++counts[s];
+        }
+        ::close(fds[s]);
+    }
+    if (counts[0] != 0 || counts[1] != kDatagrams) {
+        std::printf("Steering: socket 0 got %d, socket 1 got %d\n", counts[0], counts[1]);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    if (!test_parse_cpu_list()) {
+        std::printf("test_parse_cpu_list failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_load_cpu_topology()) {
+        std::printf("test_load_cpu_topology failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_load_nic_topology()) {
+        std::printf("test_load_nic_topology failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_plan_worker_cpus()) {
+        std::printf("test_plan_worker_cpus failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_map_rx_queues()) {
+        std::printf("test_map_rx_queues failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_pin_to_cpus()) {
+        std::printf("test_pin_to_cpus failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!test_reuseport_cpu_steering()) {
+        std::printf("test_reuseport_cpu_steering failed\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("All topology tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -43,6 +43,145 @@ gateway::MetricsValidationResult parse_and_validate(
     std::exit(EXIT_FAILURE);
 }
 
+
+// Two-stage outcome in the fused result's shape, for differential checks
+gateway::FusedMetricsResult two_stage(std::string_view json, gateway::ParsedMetrics& scratch,
+                                      const gateway::MetricsValidationConfig& config) {
+    if (auto drop = gateway::parse_metrics(json, scratch)) {
+        return *drop;
+    }
+    auto r = gateway::validate_metrics(scratch, config, kCurrentTime);
+    if (const auto* dr = std::get_if<gateway::MetricsValidationDrop>(&r)) {
+        return *dr;
+    }
+    return std::get<gateway::ValidatedMetrics>(r);
+}
+
+// Same drop stage and reason (both results must be drops)
+bool same_drop(const gateway::FusedMetricsResult& a, const gateway::FusedMetricsResult& b) {
+    if (a.index() != b.index()) return false;
+    if (const auto* p = std::get_if<gateway::MetricsDropReason>(&a)) {
+        return *p == std::get<gateway::MetricsDropReason>(b);
+    }
+    if (const auto* v = std::get_if<gateway::MetricsValidationDrop>(&a)) {
+        return *v == std::get<gateway::MetricsValidationDrop>(b);
+    }
+    return false;
+}
+
+bool same_validated(const gateway::ValidatedMetrics& a, const gateway::ValidatedMetrics& b) {
+    if (a.agent_id != b.agent_id || a.seq != b.seq || a.ts != b.ts ||
+        a.metric_count != b.metric_count) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.metric_count; ++i) {
+        const auto& x = a.metrics[i];
+        const auto& y = b.metrics[i];
+        if (x.name != y.name || x.value != y.value || x.unit != y.unit) return false;
+        const auto xt = a.tags_of(x);
+        const auto yt = b.tags_of(y);
+        if (xt.size() != yt.size()) return false;
+        for (std::size_t t = 0; t < xt.size(); ++t) {
+            if (xt[t].key != yt[t].key || xt[t].value != yt[t].value) return false;
+        }
+    }
+    return true;
+}
+
+// Message with at most one violation, chosen by `fault` (0 = none)
+std::string single_fault_message(std::uint32_t& rng, int fault) {
+    auto next = [&rng] {
+        rng = rng * 1103515245u + 12345u;
+        return rng >> 16;
+    };
+    std::string agent = fault == 1 ? "9node" : fault == 2 ? "no@de" : "node-" + std::to_string(next() % 100);
+    std::uint64_t ts = kCurrentTime - next() % 1000;
+    if (fault == 3) ts = kCurrentTime - 600'000;
+    if (fault == 4) ts = kCurrentTime + 600'000;
+
+    std::string json = R"({"agent_id": ")" + agent + R"(", )";
+    if (fault != 5) json += R"("seq": )" + std::to_string(next() % 1000) + ", ";
+    if (fault != 6) json += R"("ts": )" + std::to_string(ts) + ", ";
+    json += R"("metrics": [)";
+
+    const std::uint32_t count = 1 + next() % 5;
+    const std::uint32_t bad = next() % count;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::string name = "m" + std::to_string(i);
+        std::string value = std::to_string(next() % 10'000) + ".5";
+        if (i == bad && fault == 7) name.clear();
+        if (i == bad && fault == 8) value = "2e15";
+        if (i == bad && fault == 9) value = "-2e15";
+        if (i > 0) json += ", ";
+        json += R"({"n": ")" + name + R"(", "v": )" + value;
+        if (next() % 2 == 0) json += R"(, "u": "ms", "t": {"k": "v)" + std::to_string(i) + R"("})";
+        json += "}";
+    }
+    json += "]}";
+    if (fault == 10) json.pop_back();  // truncated: InvalidJson
+    return json;
+}
+
+bool test_fused_matches_two_stage() {
+    gateway::ParsedMetrics fused_scratch;
+    gateway::ParsedMetrics staged_scratch;
+    std::uint32_t rng = 2024;
+    int accepted = 0;
+
+    for (int i = 0; i < 5000; ++i) {
+        const int fault = i % 11;
+        const std::string json = single_fault_message(rng, fault);
+        const auto fused = gateway::parse_and_validate_metrics(
+            json, gateway::kDefaultMetricsValidation, kCurrentTime, fused_scratch);
+        const auto staged = two_stage(json, staged_scratch, gateway::kDefaultMetricsValidation);
+
+        if (fused.index() != staged.index()) {
+            std::printf("Fused/two-stage outcome kind differs (fault %d): %s\n", fault, json.c_str());
+            return false;
+        }
+        if (fault != 0 && fused.index() == 0) {
+            std::printf("Fault %d was accepted: %s\n", fault, json.c_str());
+            return false;
+        }
+        if (const auto* v = std::get_if<gateway::ValidatedMetrics>(&fused)) {
+            ++accepted;
+            if (!same_validated(*v, std::get<gateway::ValidatedMetrics>(staged))) {
+                std::printf("Fused/two-stage contents differ: %s\n", json.c_str());
+                return false;
+            }
+        } else if (!same_drop(fused, staged)) {
+            std::printf("Fused/two-stage reason differs (fault %d): %s\n", fault, json.c_str());
+            return false;
+        }
+    }
+    // Every fault-free message is accepted by both paths
+    if (accepted != (5000 + 10) / 11) {
+        return false;
+    }
+
+    // A repeated root key: the fused path checks each occurrence as it is
+    // decoded, so both paths must drop it rather than keep the last one
+    // (the fused reason may be the earlier violation)
+    const std::string now = std::to_string(kCurrentTime);
+    const std::string repeats[] = {
+        R"({"agent_id":"a1","seq":1,"ts":1,"ts":)" + now + R"(,"metrics":[{"n":"m","v":1}]})",
+        R"({"agent_id":"9a","agent_id":"a1","seq":1,"ts":)" + now +
+            R"(,"metrics":[{"n":"m","v":1}]})",
+        R"({"agent_id":"a1","seq":1,"ts":)" + now +
+            R"(,"metrics":[{"n":"","v":1}],"metrics":[{"n":"m","v":1}]})",
+    };
+    for (const auto& json : repeats) {
+        const auto fused = gateway::parse_and_validate_metrics(
+            json, gateway::kDefaultMetricsValidation, kCurrentTime, fused_scratch);
+        const auto staged = two_stage(json, staged_scratch, gateway::kDefaultMetricsValidation);
+        if (fused.index() == 0 || staged.index() == 0) {
+            std::printf("Fused/two-stage differ on a repeated key: %s\n", json.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
 int main() {
@@ -400,6 +539,100 @@ int main() {
         }
     }
 
+    // Test 19: Validated view exposes the flat tag pool of a scratch parse
+    {
+        std::string json = R"({
+            "agent_id": "Node1",
+            "seq": 1,
+            "ts": )" + std::to_string(kCurrentTime) + R"(,
+            "metrics": [{"n": "a", "v": 1}, {"n": "b", "v": 2, "t": {"env": "prod"}}]
+        })";
+
+        gateway::ParsedMetrics scratch;
+        if (gateway::parse_metrics(json, scratch).has_value()) {
+            std::printf("Test 19 failed: parse dropped\n");
+            return EXIT_FAILURE;
+        }
+        auto r = gateway::validate_metrics(scratch, gateway::kDefaultMetricsValidation, kCurrentTime);
+        const auto* v = get_validated(r);
+        if (v == nullptr || v->metric_count != 2) {
+            std::printf("Test 19 failed: expected valid\n");
+            return EXIT_FAILURE;
+        }
+        const auto tags = v->tags_of(v->metrics[1]);
+        if (!v->tags_of(v->metrics[0]).empty() || tags.size() != 1 ||
+            tags[0].key != "env" || tags[0].value != "prod") {
+            std::printf("Test 19 failed: wrong tags through validated view\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // =========================================================================
+    // Fused parse + validate
+    // =========================================================================
+
+    // Test 20: Fused path stops at the first violation; the rest of the
+    // input is never looked at (two-stage reports the later bad value)
+    {
+        std::string json = R"({"agent_id": "Node1", "seq": 1, "ts": )" +
+                           std::to_string(kCurrentTime) +
+                           R"(, "metrics": [{"n": "a", "v": 5e15}, {"n": "b", "v": oops)";
+
+        gateway::ParsedMetrics scratch;
+        auto r = gateway::parse_and_validate_metrics(json, gateway::kDefaultMetricsValidation,
+                                                     kCurrentTime, scratch);
+        const auto* drop = std::get_if<gateway::MetricsValidationDrop>(&r);
+        if (drop == nullptr || *drop != gateway::MetricsValidationDrop::MetricValueTooHigh) {
+            std::printf("Test 20 failed: expected MetricValueTooHigh before the bad value\n");
+            return EXIT_FAILURE;
+        }
+        if (gateway::parse_metrics(json, scratch) != gateway::MetricsDropReason::MetricValueNotNumber) {
+            std::printf("Test 20 failed: two-stage should see the bad value\n");
+            return EXIT_FAILURE;
+        }
+
+        // Timestamp checked as soon as it is decoded
+        std::string old = R"({"agent_id": "Node1", "ts": )" +
+                          std::to_string(kCurrentTime - 600'000) + R"(, "metrics": [{"n)";
+        auto r2 = gateway::parse_and_validate_metrics(old, gateway::kDefaultMetricsValidation,
+                                                      kCurrentTime, scratch);
+        const auto* drop2 = std::get_if<gateway::MetricsValidationDrop>(&r2);
+        if (drop2 == nullptr || *drop2 != gateway::MetricsValidationDrop::TimestampTooOld) {
+            std::printf("Test 20 failed: expected TimestampTooOld\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 21: Fused path keeps the TB-3 / TB-4 drop taxonomy
+    {
+        gateway::ParsedMetrics scratch;
+        auto fused = [&scratch](const std::string& json) {
+            return gateway::parse_and_validate_metrics(json, gateway::kDefaultMetricsValidation,
+                                                       kCurrentTime, scratch);
+        };
+        const std::string tail = R"(", "seq": 1, "ts": )" + std::to_string(kCurrentTime) +
+                                 R"(, "metrics": []})";
+
+        auto format = fused(R"({"agent_id": "1node)" + tail);
+        auto chars = fused(R"({"agent_id": "no@de)" + tail);
+        auto missing_ts = fused(R"({"agent_id": "Node1", "seq": 1, "metrics": []})");
+        auto missing_seq = fused(R"({"agent_id": "Node1", "metrics": []})");
+
+        if (!same_drop(format, gateway::MetricsValidationDrop::AgentIdInvalidFormat) ||
+            !same_drop(chars, gateway::MetricsDropReason::AgentIdInvalidChars) ||
+            !same_drop(missing_ts, gateway::MetricsValidationDrop::TimestampMissing) ||
+            !same_drop(missing_seq, gateway::MetricsDropReason::MissingRequiredField)) {
+            std::printf("Test 21 failed: wrong drop reason or stage\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Test 22: Fused and two-stage agree on single-violation messages
+    if (!test_fused_matches_two_stage()) {
+        std::printf("Test 22 failed: fused path diverged from parse + validate\n");
+        return EXIT_FAILURE;
+    }
+
     std::printf("All validate_metrics tests passed\n");
     return EXIT_SUCCESS;
 }